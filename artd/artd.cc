@@ -22,6 +22,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <chrono>
 #include <climits>
 #include <csignal>
 #include <cstddef>
@@ -939,12 +940,81 @@ ndk::ScopedAStatus Artd::mergeProfiles(const std::vector<ProfilePath>& in_profil
   return ScopedAStatus::ok();
 }
 
+Result<std::vector<std::string>> Artd::GetDexoptNeededFileStates(
+    const std::string& dex_file,
+    const std::string& instruction_set,
+    const std::optional<std::string>& class_loader_context) {
+  // A file that doesn't exist is represented by an empty string.
+  auto get_file_state = [](const std::string& path) -> std::string {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+      return "";
+    }
+    return ART_FORMAT("{}:{}:{}:{}.{}:{}.{}",
+                      st.st_dev,
+                      st.st_ino,
+                      st.st_size,
+                      st.st_mtim.tv_sec,
+                      st.st_mtim.tv_nsec,
+                      st.st_ctim.tv_sec,
+                      st.st_ctim.tv_nsec);
+  };
+
+  std::vector<std::string> paths{dex_file, GetDmFilename(dex_file)};
+  for (bool is_in_dalvik_cache : {false, true}) {
+    RawArtifactsPath artifacts_path = OR_RETURN(BuildArtifactsPath(
+        ArtifactsPath{.dexPath = dex_file,
+                      .isa = instruction_set,
+                      .isInDalvikCache = is_in_dalvik_cache}));
+    paths.push_back(std::move(artifacts_path.oat_path));
+    paths.push_back(std::move(artifacts_path.vdex_path));
+    paths.push_back(std::move(artifacts_path.art_path));
+  }
+  if (class_loader_context.has_value()) {
+    std::unique_ptr<ClassLoaderContext> context =
+        ClassLoaderContext::Create(class_loader_context.value());
+    if (context == nullptr) {
+      return Errorf("Class loader context '{}' is invalid", class_loader_context.value());
+    }
+    std::string dex_dir = Dirname(dex_file);
+    for (const std::string& context_element : context->FlattenDexPaths()) {
+      paths.push_back(std::filesystem::path(dex_dir).append(context_element));
+    }
+  }
+
+  std::vector<std::string> file_states;
+  file_states.reserve(paths.size());
+  for (const std::string& path : paths) {
+    file_states.push_back(get_file_state(path));
+  }
+  return file_states;
+}
+
 ndk::ScopedAStatus Artd::getDexoptNeeded(const std::string& in_dexFile,
                                          const std::string& in_instructionSet,
                                          const std::optional<std::string>& in_classLoaderContext,
                                          const std::string& in_compilerFilter,
                                          int32_t in_dexoptTrigger,
                                          GetDexoptNeededResult* _aidl_return) {
+  // Most queries, e.g., the ones issued for every package at boot, are repeated with nothing
+  // changed since the last one. Answer them from the cache without opening any dex or oat file.
+  std::string cache_key = ART_FORMAT("{}\n{}\n{}\n{}\n{}",
+                                     in_dexFile,
+                                     in_instructionSet,
+                                     in_classLoaderContext.value_or("<null>"),
+                                     in_compilerFilter,
+                                     in_dexoptTrigger);
+  Result<std::vector<std::string>> file_states =
+      GetDexoptNeededFileStates(in_dexFile, in_instructionSet, in_classLoaderContext);
+  if (file_states.ok()) {
+    std::lock_guard<std::mutex> lock(dexopt_needed_cache_mu_);
+    auto it = dexopt_needed_cache_.find(cache_key);
+    if (it != dexopt_needed_cache_.end() && it->second.file_states == file_states.value()) {
+      *_aidl_return = it->second.result;
+      return ScopedAStatus::ok();
+    }
+  }
+
   Result<OatFileAssistantContext*> ofa_context = GetOatFileAssistantContext();
   if (!ofa_context.ok()) {
     return NonFatal("Failed to get runtime options: " + ofa_context.error().message());
@@ -978,6 +1048,19 @@ ndk::ScopedAStatus Artd::getDexoptNeeded(const std::string& in_dexFile,
   }
   _aidl_return->hasDexCode = *has_dex_files;
 
+  if (file_states.ok()) {
+    std::lock_guard<std::mutex> lock(dexopt_needed_cache_mu_);
+    // Bound the memory usage. Entries for packages that are gone are never looked up again.
+    constexpr size_t kMaxDexoptNeededCacheSize = 4096;
+    if (dexopt_needed_cache_.size() >= kMaxDexoptNeededCacheSize) {
+      dexopt_needed_cache_.clear();
+    }
+    dexopt_needed_cache_.insert_or_assign(
+        std::move(cache_key),
+        CachedDexoptNeeded{.file_states = std::move(file_states).value(),
+                           .result = *_aidl_return});
+  }
+
   return ScopedAStatus::ok();
 }
 
@@ -1170,9 +1253,23 @@ ndk::ScopedAStatus Artd::dexopt(
   LOG(INFO) << "Running dex2oat: " << Join(art_exec_args.Get(), /*separator=*/" ")
             << "\nOpened FDs: " << fd_logger;
 
+  bool compile_slot_acquired = false;
+  if (!AcquireCompileSlot(
+          in_compilerFilter, in_priorityClass, cancellation_signal, &compile_slot_acquired)) {
+    _aidl_return->cancelled = true;
+    return ScopedAStatus::ok();
+  }
+
   ProcessStat stat;
-  Result<int> result = ExecAndReturnCode(
-      art_exec_args.Get(), kLongTimeoutSec, cancellation_signal->CreateExecCallbacks(), &stat);
+  Result<int> result = [&]() -> Result<int> {
+    auto release_compile_slot = make_scope_guard([&] {
+      if (compile_slot_acquired) {
+        ReleaseCompileSlot();
+      }
+    });
+    return ExecAndReturnCode(
+        art_exec_args.Get(), kLongTimeoutSec, cancellation_signal->CreateExecCallbacks(), &stat);
+  }();
   _aidl_return->wallTimeMs = stat.wall_time_ms;
   _aidl_return->cpuTimeMs = stat.cpu_time_ms;
   if (!result.ok()) {
@@ -1714,6 +1811,46 @@ void Artd::AddPerfConfigFlags(PriorityClass priority_class,
   }
 }
 
+bool Artd::AcquireCompileSlot(const std::string& compiler_filter,
+                              PriorityClass priority_class,
+                              ArtdCancellationSignal* cancellation_signal,
+                              /*out*/ bool* acquired) {
+  *acquired = false;
+  if (priority_class > PriorityClass::BACKGROUND) {
+    return true;
+  }
+  int max_compiles = 0;
+  if (!ParseInt(props_->GetOrEmpty("dalvik.vm.background-dex2oat-max-compiles"), &max_compiles) ||
+      max_compiles <= 0) {
+    return true;
+  }
+  Result<CompilerFilter::Filter> filter = ParseCompilerFilter(compiler_filter);
+  if (filter.ok() && !CompilerFilter::IsAotCompilationEnabled(filter.value())) {
+    return true;
+  }
+
+  std::unique_lock<std::mutex> lock(compile_slots_mu_);
+  // Poll the cancellation signal because it has no way to wake us up.
+  while (running_compiles_ >= max_compiles) {
+    if (cancellation_signal->IsCancelled()) {
+      return false;
+    }
+    compile_slots_cv_.wait_for(lock, std::chrono::milliseconds(100));
+  }
+  ++running_compiles_;
+  *acquired = true;
+  return true;
+}
+
+void Artd::ReleaseCompileSlot() {
+  {
+    std::lock_guard<std::mutex> lock(compile_slots_mu_);
+    DCHECK_GT(running_compiles_, 0);
+    --running_compiles_;
+  }
+  compile_slots_cv_.notify_one();
+}
+
 Result<int> Artd::ExecAndReturnCode(const std::vector<std::string>& args,
                                     int timeout_sec,
                                     const ExecCallbacks& callbacks,
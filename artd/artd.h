@@ -21,6 +21,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <condition_variable>
 #include <csignal>
 #include <cstdint>
 #include <functional>
@@ -252,9 +253,24 @@ class Artd : public aidl::com::android::server::art::BnArtd {
   android::base::Result<void> Start();
 
  private:
+  // A `getDexoptNeeded` result, together with the state of the files it was computed from.
+  struct CachedDexoptNeeded {
+    std::vector<std::string> file_states;
+    aidl::com::android::server::art::GetDexoptNeededResult result;
+  };
+
   android::base::Result<OatFileAssistantContext*> GetOatFileAssistantContext()
       EXCLUDES(ofa_context_mu_);
 
+  // Returns the state of every file that the result of `getDexoptNeeded` depends on: the dex file,
+  // its dex metadata file, the class loader context dex files, and the artifacts in both the oat
+  // directory and dalvik-cache. Returns an error if the files cannot be determined, in which case
+  // the result should not be cached.
+  android::base::Result<std::vector<std::string>> GetDexoptNeededFileStates(
+      const std::string& dex_file,
+      const std::string& instruction_set,
+      const std::optional<std::string>& class_loader_context);
+
   android::base::Result<const std::vector<std::string>*> GetBootImageLocations()
       EXCLUDES(cache_mu_);
 
@@ -296,6 +312,17 @@ class Artd : public aidl::com::android::server::art::BnArtd {
                           /*out*/ art::tools::CmdlineBuilder& art_exec_args,
                           /*out*/ art::tools::CmdlineBuilder& args);
 
+  // Waits until fewer than `dalvik.vm.background-dex2oat-max-compiles` compiling dex2oat processes
+  // are running in the background. Returns false if `cancellation_signal` is signaled while
+  // waiting. Dexopt requests that don't compile code are mostly I/O-bound and are never throttled,
+  // so they interleave with the compiling ones.
+  bool AcquireCompileSlot(const std::string& compiler_filter,
+                          aidl::com::android::server::art::PriorityClass priority_class,
+                          ArtdCancellationSignal* cancellation_signal,
+                          /*out*/ bool* acquired);
+
+  void ReleaseCompileSlot();
+
   android::base::Result<struct stat> Fstat(const art::File& file) const;
 
   // Creates a new dir at `source` and bind-mounts it at `target`.
@@ -325,6 +352,18 @@ class Artd : public aidl::com::android::server::art::BnArtd {
   std::mutex ofa_context_mu_;
   std::unique_ptr<OatFileAssistantContext> ofa_context_ GUARDED_BY(ofa_context_mu_);
 
+  // Results of `getDexoptNeeded`, keyed by the arguments. The boot classpath and the runtime
+  // options don't change during the lifetime of artd, so an entry is valid as long as none of its
+  // files has changed.
+  std::mutex dexopt_needed_cache_mu_;
+  std::unordered_map<std::string, CachedDexoptNeeded> dexopt_needed_cache_
+      GUARDED_BY(dexopt_needed_cache_mu_);
+
+  std::mutex compile_slots_mu_;
+  std::condition_variable compile_slots_cv_;
+  // The number of background dex2oat processes that compile code and are currently running.
+  int running_compiles_ GUARDED_BY(compile_slots_mu_) = 0;
+
   const Options options_;
   const std::unique_ptr<art::tools::SystemProperties> props_;
   const std::unique_ptr<ExecUtils> exec_utils_;
@@ -1215,6 +1215,57 @@ TEST_F(ArtdTest, dexoptCancelledDuringDex2oat) {
   CheckContent(scratch_path_ + "/a/oat/arm64/b.art", "old_art");
 }
 
+
+TEST_F(ArtdTest, dexoptBackgroundMaxCompilesReleasesSlot) {
+  EXPECT_CALL(*mock_props_, GetProperty("dalvik.vm.background-dex2oat-max-compiles"))
+      .WillRepeatedly(Return("1"));
+  priority_class_ = PriorityClass::BACKGROUND;
+
+  // The second dexopt would wait forever if the first one didn't release its slot.
+  EXPECT_CALL(*mock_exec_utils_, DoExecAndReturnCode(_, _, _)).Times(2).WillRepeatedly(Return(0));
+  RunDexopt();
+  RunDexopt();
+}
+
+TEST_F(ArtdTest, dexoptBackgroundMaxCompilesCancelledWhileWaiting) {
+  EXPECT_CALL(*mock_props_, GetProperty("dalvik.vm.background-dex2oat-max-compiles"))
+      .WillRepeatedly(Return("1"));
+  priority_class_ = PriorityClass::BACKGROUND;
+
+  std::shared_ptr<IArtdCancellationSignal> cancellation_signal;
+  ASSERT_TRUE(artd_->createCancellationSignal(&cancellation_signal).isOk());
+
+  std::mutex mu;
+  std::condition_variable process_started_cv, second_dexopt_done_cv;
+  bool second_dexopt_done = false;
+  constexpr std::chrono::duration<int> kTimeout = std::chrono::seconds(10);
+
+  // The first dexopt holds the only slot until the second one is cancelled while waiting for it.
+  EXPECT_CALL(*mock_exec_utils_, DoExecAndReturnCode(_, _, _)).WillOnce([&](auto, auto, auto) {
+    std::unique_lock<std::mutex> lock(mu);
+    process_started_cv.notify_one();
+    EXPECT_TRUE(
+        second_dexopt_done_cv.wait_for(lock, kTimeout, [&] { return second_dexopt_done; }));
+    return 0;
+  });
+
+  std::thread t;
+  {
+    std::unique_lock<std::mutex> lock(mu);
+    t = std::thread([&] { RunDexopt(); });
+    EXPECT_EQ(process_started_cv.wait_for(lock, kTimeout), std::cv_status::no_timeout);
+  }
+
+  cancellation_signal->cancel();
+  RunDexopt(EX_NONE, Field(&ArtdDexoptResult::cancelled, true), cancellation_signal);
+  {
+    std::lock_guard<std::mutex> lock(mu);
+    second_dexopt_done = true;
+  }
+  second_dexopt_done_cv.notify_one();
+
+  t.join();
+}
 TEST_F(ArtdTest, dexoptCancelledAfterDex2oat) {
   std::shared_ptr<IArtdCancellationSignal> cancellation_signal;
   ASSERT_TRUE(artd_->createCancellationSignal(&cancellation_signal).isOk());
@@ -21,6 +21,8 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
 #include <memory>
 #include <string>
@@ -31,6 +33,7 @@
 
 #include "aidl/com/android/server/art/FsPermission.h"
 #include "android-base/errors.h"
+#include "android-base/file.h"
 #include "android-base/logging.h"
 #include "android-base/result.h"
 #include "android-base/scopeguard.h"
@@ -45,7 +48,9 @@ namespace {
 
 using ::aidl::com::android::server::art::FsPermission;
 using ::android::base::make_scope_guard;
+using ::android::base::ReadFully;
 using ::android::base::Result;
+using ::android::base::unique_fd;
 
 void UnlinkIfExists(std::string_view path) {
   std::error_code ec;
@@ -55,6 +60,38 @@ void UnlinkIfExists(std::string_view path) {
   }
 }
 
+// Returns true if the files at `path_1` and `path_2` have the same content, mode, and owner.
+// Returns false on any error, in which case the caller should treat the files as different.
+bool IsIdenticalFile(const std::string& path_1, const std::string& path_2) {
+  unique_fd fd_1(open(path_1.c_str(), O_RDONLY | O_CLOEXEC));
+  unique_fd fd_2(open(path_2.c_str(), O_RDONLY | O_CLOEXEC));
+  if (fd_1.get() < 0 || fd_2.get() < 0) {
+    return false;
+  }
+  struct stat st_1, st_2;
+  if (fstat(fd_1.get(), &st_1) != 0 || fstat(fd_2.get(), &st_2) != 0) {
+    return false;
+  }
+  if (st_1.st_size != st_2.st_size || (st_1.st_mode & 07777) != (st_2.st_mode & 07777) ||
+      st_1.st_uid != st_2.st_uid || st_1.st_gid != st_2.st_gid) {
+    return false;
+  }
+
+  constexpr size_t kChunkSize = 64 * 1024;
+  std::unique_ptr<char[]> buffer_1(new char[kChunkSize]);
+  std::unique_ptr<char[]> buffer_2(new char[kChunkSize]);
+  for (off_t remaining = st_1.st_size; remaining > 0;) {
+    size_t chunk = std::min(static_cast<size_t>(remaining), kChunkSize);
+    if (!ReadFully(fd_1.get(), buffer_1.get(), chunk) ||
+        !ReadFully(fd_2.get(), buffer_2.get(), chunk) ||
+        memcmp(buffer_1.get(), buffer_2.get(), chunk) != 0) {
+      return false;
+    }
+    remaining -= chunk;
+  }
+  return true;
+}
+
 }  // namespace
 
 Result<std::unique_ptr<NewFile>> NewFile::Create(const std::string& path,
@@ -129,12 +166,24 @@ Result<void> NewFile::CommitAllOrAbandon(const std::vector<NewFile*>& files_to_c
       file->Unlink();
     }
   });
+  std::vector<NewFile*> identical_files;
   for (NewFile* file : files_to_commit) {
     OR_RETURN(file->Keep());
-    files_to_move.emplace_back(file->TempPath(), file->FinalPath());
+    // Keep the existing file if the new one is bit-identical to it. Dropping the new file before
+    // its dirty pages are written back saves the flash writes, and apps that have the existing
+    // file mapped keep sharing the same pages.
+    if (IsIdenticalFile(file->TempPath(), file->FinalPath())) {
+      identical_files.push_back(file);
+    } else {
+      files_to_move.emplace_back(file->TempPath(), file->FinalPath());
+    }
   }
   cleanup.Disable();
 
+  for (NewFile* file : identical_files) {
+    file->Unlink();
+  }
+
   return MoveAllOrAbandon(files_to_move, files_to_remove);
 }
 
@@ -85,6 +85,9 @@ class NewFile {
   // new files and restores old files at best effort if any error occurs. The fds will be invalid
   // after this function is called.
   //
+  // An old file that has the same content, mode, and owner as the new file that replaces it is kept
+  // as is, and the new file is discarded.
+  //
   // Note: This function is NOT thread-safe. It is intended to be used in single-threaded code or in
   // cases where some race condition is acceptable.
   //
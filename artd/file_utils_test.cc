@@ -196,6 +196,42 @@ TEST_F(FileUtilsTest, NewFileCommitAllReplacesOldFiles) {
   EXPECT_FALSE(std::filesystem::exists(new_file_2->TempPath()));
 }
 
+TEST_F(FileUtilsTest, NewFileCommitAllKeepsIdenticalOldFiles) {
+  std::string file_1_path = scratch_dir_->GetPath() + "/file_1";
+  std::string file_2_path = scratch_dir_->GetPath() + "/file_2";
+
+  std::unique_ptr<NewFile> old_file_1 = OR_FATAL(NewFile::Create(file_1_path, fs_permission_));
+  std::unique_ptr<NewFile> old_file_2 = OR_FATAL(NewFile::Create(file_2_path, fs_permission_));
+  ASSERT_TRUE(WriteStringToFd("file_1", old_file_1->Fd()));
+  ASSERT_TRUE(WriteStringToFd("old_file_2", old_file_2->Fd()));
+  ASSERT_THAT(NewFile::CommitAllOrAbandon({old_file_1.get(), old_file_2.get()}), Ok());
+
+  struct stat old_st_1, old_st_2;
+  ASSERT_EQ(stat(file_1_path.c_str(), &old_st_1), 0);
+  ASSERT_EQ(stat(file_2_path.c_str(), &old_st_2), 0);
+
+  std::unique_ptr<NewFile> new_file_1 = OR_FATAL(NewFile::Create(file_1_path, fs_permission_));
+  std::unique_ptr<NewFile> new_file_2 = OR_FATAL(NewFile::Create(file_2_path, fs_permission_));
+  ASSERT_TRUE(WriteStringToFd("file_1", new_file_1->Fd()));
+  ASSERT_TRUE(WriteStringToFd("new_file_2", new_file_2->Fd()));
+
+  EXPECT_THAT(NewFile::CommitAllOrAbandon({new_file_1.get(), new_file_2.get()}), Ok());
+
+  CheckContent(file_1_path, "file_1");
+  CheckContent(file_2_path, "new_file_2");
+
+  // The identical old file is kept, while the different one is replaced.
+  struct stat st_1, st_2;
+  ASSERT_EQ(stat(file_1_path.c_str(), &st_1), 0);
+  ASSERT_EQ(stat(file_2_path.c_str(), &st_2), 0);
+  EXPECT_EQ(st_1.st_ino, old_st_1.st_ino);
+  EXPECT_NE(st_2.st_ino, old_st_2.st_ino);
+
+  // New files are no longer at the temporary paths.
+  EXPECT_FALSE(std::filesystem::exists(new_file_1->TempPath()));
+  EXPECT_FALSE(std::filesystem::exists(new_file_2->TempPath()));
+}
+
 TEST_F(FileUtilsTest, NewFileCommitAllReplacesLessOldFiles) {
   std::string file_1_path = scratch_dir_->GetPath() + "/file_1";
   std::string file_2_path = scratch_dir_->GetPath() + "/file_2";
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.util.Arrays;
+
+public class ArrayCopyBenchmark {
+    private static final int kShort = 13;
+    private static final int kMedium = 150;
+    private static final int kBulk = 4 * 1024 * 1024;
+
+    private static final byte[] byteSrc = new byte[kBulk];
+    private static final byte[] byteDst = new byte[kBulk];
+    private static final char[] charSrc = new char[kBulk];
+    private static final char[] charDst = new char[kBulk];
+    private static final int[] intSrc = new int[kBulk];
+    private static final int[] intDst = new int[kBulk];
+    private static final Object[] objectSrc = new Object[kBulk / 16];
+    private static final Object[] objectDst = new Object[kBulk / 16];
+
+    private static volatile Object sink;
+
+    static {
+        for (int i = 0; i < objectSrc.length; ++i) {
+            objectSrc[i] = (i % 7 == 0) ? null : Integer.valueOf(i);
+        }
+    }
+
+    public void timeCharShort(int count) {
+        for (int i = 0; i < count; ++i) {
+            System.arraycopy(charSrc, i & 7, charDst, 0, kShort);
+        }
+    }
+
+    public void timeCharMedium(int count) {
+        for (int i = 0; i < count; ++i) {
+            System.arraycopy(charSrc, i & 7, charDst, 0, kMedium);
+        }
+    }
+
+    public void timeCharBulk(int count) {
+        for (int i = 0; i < count; ++i) {
+            System.arraycopy(charSrc, 0, charDst, 0, kBulk);
+        }
+    }
+
+    public void timeByteShort(int count) {
+        for (int i = 0; i < count; ++i) {
+            System.arraycopy(byteSrc, i & 7, byteDst, 0, kShort);
+        }
+    }
+
+    public void timeByteMedium(int count) {
+        for (int i = 0; i < count; ++i) {
+            System.arraycopy(byteSrc, i & 7, byteDst, 0, kMedium);
+        }
+    }
+
+    public void timeByteBulk(int count) {
+        for (int i = 0; i < count; ++i) {
+            System.arraycopy(byteSrc, 0, byteDst, 0, kBulk);
+        }
+    }
+
+    public void timeIntShort(int count) {
+        for (int i = 0; i < count; ++i) {
+            System.arraycopy(intSrc, i & 7, intDst, 0, kShort);
+        }
+    }
+
+    public void timeIntMedium(int count) {
+        for (int i = 0; i < count; ++i) {
+            System.arraycopy(intSrc, i & 7, intDst, 0, kMedium);
+        }
+    }
+
+    public void timeIntBulk(int count) {
+        for (int i = 0; i < count; ++i) {
+            System.arraycopy(intSrc, 0, intDst, 0, kBulk);
+        }
+    }
+
+    public void timeObjectMedium(int count) {
+        for (int i = 0; i < count; ++i) {
+            System.arraycopy(objectSrc, i & 7, objectDst, 0, kMedium);
+        }
+    }
+
+    public void timeObjectBulk(int count) {
+        for (int i = 0; i < count; ++i) {
+            System.arraycopy(objectSrc, 0, objectDst, 0, objectSrc.length);
+        }
+    }
+
+    public void timeCopyOfBytesMedium(int count) {
+        for (int i = 0; i < count; ++i) {
+            sink = Arrays.copyOf(byteSrc, kMedium);
+        }
+    }
+
+    public void timeCopyOfCharsMedium(int count) {
+        for (int i = 0; i < count; ++i) {
+            sink = Arrays.copyOf(charSrc, kMedium);
+        }
+    }
+
+    public void timeCopyOfBytesBulk(int count) {
+        for (int i = 0; i < count; ++i) {
+            sink = Arrays.copyOf(byteSrc, kBulk);
+        }
+    }
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.invoke.MethodHandles;
+import java.lang.invoke.VarHandle;
+import java.util.concurrent.CyclicBarrier;
+import java.util.concurrent.atomic.AtomicInteger;
+import java.util.concurrent.atomic.AtomicLong;
+
+public class AtomicContentionBenchmark {
+    private static final int[] kThreadCounts = { 1, 2, 4, 8 };
+
+    private static final AtomicLong counter = new AtomicLong();
+    private static final AtomicInteger slot = new AtomicInteger();
+
+    private static volatile int field;
+    private static final VarHandle FIELD;
+
+    static {
+        try {
+            FIELD = MethodHandles.lookup().findStaticVarHandle(
+                    AtomicContentionBenchmark.class, "field", int.class);
+        } catch (ReflectiveOperationException e) {
+            throw new Error(e);
+        }
+    }
+
+    private interface Operation {
+        void run(int count);
+    }
+
+    public void timeGetAndAdd(int count) {
+        getAndAdd(count);
+    }
+
+    public void timeCasLoop(int count) {
+        casLoop(count);
+    }
+
+    public void timeGetAndSet(int count) {
+        getAndSet(count);
+    }
+
+    public void timeVarHandleCas(int count) {
+        varHandleCas(count);
+    }
+
+    private static void getAndAdd(int count) {
+        for (int i = 0; i < count; ++i) {
+            counter.getAndAdd(1);
+        }
+    }
+
+    private static void casLoop(int count) {
+        for (int i = 0; i < count; ++i) {
+            long value;
+            do {
+                value = counter.get();
+            } while (!counter.compareAndSet(value, value + 1));
+        }
+    }
+
+    private static void getAndSet(int count) {
+        for (int i = 0; i < count; ++i) {
+            slot.getAndSet(i);
+        }
+    }
+
+    private static void varHandleCas(int count) {
+        for (int i = 0; i < count; ++i) {
+            int value;
+            do {
+                value = (int) FIELD.getVolatile();
+            } while (!FIELD.compareAndSet(value, value + 1));
+        }
+    }
+
+    // Runs `operation` on `threads` threads at once and returns the wall time in nanoseconds.
+    private static long runContended(int threads, int count, Operation operation)
+            throws Exception {
+        CyclicBarrier barrier = new CyclicBarrier(threads + 1);
+        Thread[] workers = new Thread[threads];
+        for (int t = 0; t < threads; ++t) {
+            workers[t] = new Thread(() -> {
+                try {
+                    barrier.await();
+                    operation.run(count);
+                    barrier.await();
+                } catch (Exception e) {
+                    throw new Error(e);
+                }
+            });
+            workers[t].start();
+        }
+        barrier.await();
+        long start = System.nanoTime();
+        barrier.await();
+        long time = System.nanoTime() - start;
+        for (Thread worker : workers) {
+            worker.join();
+        }
+        return time;
+    }
+
+    private static void report(String name, int count, Operation operation) throws Exception {
+        // Warm up so that the measured loops run compiled code.
+        runContended(1, count, operation);
+        StringBuilder line = new StringBuilder(name).append(":");
+        for (int threads : kThreadCounts) {
+            long time = runContended(threads, count, operation);
+            line.append(" ").append(threads).append("t=")
+                .append(time / ((long) count * threads)).append("ns/op");
+        }
+        System.out.println(line);
+    }
+
+    public static void main(String[] args) throws Exception {
+        int count = (args.length > 0) ? Integer.parseInt(args[0]) : 1000000;
+        report("getAndAdd", count, AtomicContentionBenchmark::getAndAdd);
+        report("casLoop", count, AtomicContentionBenchmark::casLoop);
+        report("getAndSet", count, AtomicContentionBenchmark::getAndSet);
+        report("varHandleCas", count, AtomicContentionBenchmark::varHandleCas);
+    }
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.nio.ByteBuffer;
+import java.util.zip.CRC32;
+import java.util.zip.CRC32C;
+
+public class CRC32CBenchmark {
+    private static final byte[] bytes64 = new byte[64];
+    private static final byte[] bytes4096 = new byte[4096];
+    private static final ByteBuffer direct4096 = ByteBuffer.allocateDirect(4096);
+    static {
+        for (int i = 0; i < bytes4096.length; ++i) {
+            bytes4096[i] = (byte) (i * 31);
+        }
+        System.arraycopy(bytes4096, 0, bytes64, 0, bytes64.length);
+        direct4096.put(bytes4096);
+    }
+
+    public void timeCRC32CUpdateBytes64(int count) {
+        CRC32C crc32c = new CRC32C();
+        for (int i = 0; i < count; ++i) {
+            crc32c.update(bytes64, 0, bytes64.length);
+        }
+    }
+
+    public void timeCRC32CUpdateBytes4096(int count) {
+        CRC32C crc32c = new CRC32C();
+        for (int i = 0; i < count; ++i) {
+            crc32c.update(bytes4096, 0, bytes4096.length);
+        }
+    }
+
+    public void timeCRC32CUpdateDirectBuffer4096(int count) {
+        CRC32C crc32c = new CRC32C();
+        for (int i = 0; i < count; ++i) {
+            direct4096.clear();
+            crc32c.update(direct4096);
+        }
+    }
+
+    // For comparison with the CRC32 intrinsic.
+    public void timeCRC32UpdateBytes4096(int count) {
+        CRC32 crc32 = new CRC32();
+        for (int i = 0; i < count; ++i) {
+            crc32.update(bytes4096, 0, bytes4096.length);
+        }
+    }
+}
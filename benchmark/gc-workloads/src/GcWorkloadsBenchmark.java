@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.io.BufferedReader;
+import java.io.FileReader;
+import java.io.IOException;
+import java.lang.ref.ReferenceQueue;
+import java.lang.ref.SoftReference;
+import java.lang.ref.WeakReference;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.HashMap;
+import java.util.Map;
+import java.util.Random;
+
+public class GcWorkloadsBenchmark {
+    private static final int kSmallAllocationsPerIteration = 100000;
+    private static final int kTreeDepth = 14;
+    private static final int kListLength = 1 << 14;
+    private static final int kReferencesPerIteration = 10000;
+    private static final int kLargeObjectBytes = 256 * 1024;
+    private static final int kLargeObjectsPerIteration = 64;
+    private static final int kLargeObjectsLive = 8;
+    private static final int kCacheEntries = 1 << 16;
+    private static final int kCacheEntryBytes = 64;
+    private static final int kCacheUpdatesPerIteration = kCacheEntries / 100;
+
+    // Keeps allocations observable so that the compiler cannot remove them.
+    private static volatile Object sink;
+
+    private static final Object[] largeObjects = new Object[kLargeObjectsLive];
+    private static Map<Integer, byte[]> cache;
+    private static final Random random = new Random(42);
+
+    private static class Node {
+        Node left;
+        Node right;
+        int value;
+
+        Node(Node left, Node right, int value) {
+            this.left = left;
+            this.right = right;
+            this.value = value;
+        }
+    }
+
+    // Short-lived small objects of mixed sizes.
+    public void timeAllocationRate(int count) {
+        for (int i = 0; i < count; ++i) {
+            allocationRate();
+        }
+    }
+
+    // Deep trees and long lists that die together, stressing marking of pointer-chasing shapes.
+    public void timeObjectGraph(int count) {
+        for (int i = 0; i < count; ++i) {
+            objectGraph();
+        }
+    }
+
+    // Weak and soft references with a queue, stressing reference processing.
+    public void timeReferenceHeavy(int count) {
+        for (int i = 0; i < count; ++i) {
+            referenceHeavy();
+        }
+    }
+
+    // Large arrays in the large object space, a few of them kept alive at a time.
+    public void timeLargeObjectChurn(int count) {
+        for (int i = 0; i < count; ++i) {
+            largeObjectChurn();
+        }
+    }
+
+    // A large long-lived map that is slowly mutated, with short-lived garbage on the side.
+    public void timeLongLivedCache(int count) {
+        for (int i = 0; i < count; ++i) {
+            longLivedCache();
+        }
+    }
+
+    private static void allocationRate() {
+        for (int i = 0; i < kSmallAllocationsPerIteration; ++i) {
+            switch (i & 3) {
+                case 0: sink = new Object(); break;
+                case 1: sink = new byte[32]; break;
+                case 2: sink = new Object[4]; break;
+                default: sink = new Node(null, null, i); break;
+            }
+        }
+    }
+
+    private static Node makeTree(int depth) {
+        return (depth == 0) ? new Node(null, null, 0)
+                            : new Node(makeTree(depth - 1), makeTree(depth - 1), depth);
+    }
+
+    private static void objectGraph() {
+        Node tree = makeTree(kTreeDepth);
+        Node list = null;
+        for (int i = 0; i < kListLength; ++i) {
+            list = new Node(list, null, i);
+        }
+        Object[][] wide = new Object[256][];
+        for (int i = 0; i < wide.length; ++i) {
+            wide[i] = new Object[64];
+            Arrays.fill(wide[i], tree);
+        }
+        sink = wide;
+        sink = list;
+    }
+
+    private static void referenceHeavy() {
+        ReferenceQueue<Object> queue = new ReferenceQueue<>();
+        ArrayList<Object> refs = new ArrayList<>(kReferencesPerIteration);
+        for (int i = 0; i < kReferencesPerIteration; ++i) {
+            Object referent = new byte[16];
+            refs.add(((i & 1) == 0) ? new WeakReference<>(referent, queue)
+                                    : new SoftReference<>(referent, queue));
+        }
+        while (queue.poll() != null) {
+        }
+        sink = refs;
+    }
+
+    private static void largeObjectChurn() {
+        for (int i = 0; i < kLargeObjectsPerIteration; ++i) {
+            largeObjects[i % kLargeObjectsLive] =
+                ((i & 1) == 0) ? new byte[kLargeObjectBytes] : new int[kLargeObjectBytes / 4];
+        }
+    }
+
+    private static void longLivedCache() {
+        if (cache == null) {
+            cache = new HashMap<>(kCacheEntries * 2);
+            for (int i = 0; i < kCacheEntries; ++i) {
+                cache.put(i, new byte[kCacheEntryBytes]);
+            }
+        }
+        for (int i = 0; i < kCacheUpdatesPerIteration; ++i) {
+            cache.put(random.nextInt(kCacheEntries), new byte[kCacheEntryBytes]);
+            sink = new Object[8];
+        }
+        allocationRate();
+    }
+
+    private interface Workload {
+        void run();
+    }
+
+    // Runs each workload on its own and prints one JSON object per line with the throughput,
+    // percentiles of the iteration time as observed by the mutator (which includes GC pauses
+    // and allocation stalls) and the RSS at the end. Run once per collector, for example with
+    // `-Xgc:CMC`, `-Xgc:CC` or `-Xgc:CMS`; `-XX:DumpGCPerformanceOnShutdown` adds the runtime's
+    // own pause histograms to the log.
+    public static void main(String[] args) throws IOException {
+        int iterations = (args.length > 0) ? Integer.parseInt(args[0]) : 200;
+        report("allocation-rate", iterations, GcWorkloadsBenchmark::allocationRate);
+        report("object-graph", iterations, GcWorkloadsBenchmark::objectGraph);
+        report("reference-heavy", iterations, GcWorkloadsBenchmark::referenceHeavy);
+        report("large-object-churn", iterations, GcWorkloadsBenchmark::largeObjectChurn);
+        report("long-lived-cache", iterations, GcWorkloadsBenchmark::longLivedCache);
+    }
+
+    private static void report(String name, int iterations, Workload workload)
+            throws IOException {
+        long[] times = new long[iterations];
+        long start = System.nanoTime();
+        for (int i = 0; i < iterations; ++i) {
+            long iterationStart = System.nanoTime();
+            workload.run();
+            times[i] = System.nanoTime() - iterationStart;
+        }
+        long total = System.nanoTime() - start;
+        Arrays.sort(times);
+        System.out.println("{\"workload\": \"" + name + "\""
+                + ", \"iterations\": " + iterations
+                + ", \"iterations_per_second\": " + (iterations * 1e9 / total)
+                + ", \"iteration_us\": {"
+                + "\"p50\": " + percentileUs(times, 50)
+                + ", \"p90\": " + percentileUs(times, 90)
+                + ", \"p99\": " + percentileUs(times, 99)
+                + ", \"max\": " + times[iterations - 1] / 1000
+                + "}, \"rss_kb\": " + rssKb() + "}");
+    }
+
+    private static long percentileUs(long[] sortedTimes, int percentile) {
+        int index = Math.min(sortedTimes.length - 1, sortedTimes.length * percentile / 100);
+        return sortedTimes[index] / 1000;
+    }
+
+    private static long rssKb() throws IOException {
+        try (BufferedReader reader = new BufferedReader(new FileReader("/proc/self/status"))) {
+            for (String line = reader.readLine(); line != null; line = reader.readLine()) {
+                if (line.startsWith("VmRSS:")) {
+                    return Long.parseLong(line.substring(6).trim().split("\\s+")[0]);
+                }
+            }
+        }
+        return -1;
+    }
+}
@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class InterfaceDispatchBenchmark {
+    // 64 interface methods do not fit in the 43-entry IMT of `Base`, so many of them share
+    // a slot and are dispatched through an IMT conflict table.
+    interface Dispatch0 {
+        int a0();
+        int a1();
+        int a2();
+        int a3();
+        int a4();
+        int a5();
+        int a6();
+        int a7();
+        int a8();
+        int a9();
+        int a10();
+        int a11();
+        int a12();
+        int a13();
+        int a14();
+        int a15();
+    }
+
+    interface Dispatch1 {
+        int b0();
+        int b1();
+        int b2();
+        int b3();
+        int b4();
+        int b5();
+        int b6();
+        int b7();
+        int b8();
+        int b9();
+        int b10();
+        int b11();
+        int b12();
+        int b13();
+        int b14();
+        int b15();
+    }
+
+    interface Dispatch2 {
+        int c0();
+        int c1();
+        int c2();
+        int c3();
+        int c4();
+        int c5();
+        int c6();
+        int c7();
+        int c8();
+        int c9();
+        int c10();
+        int c11();
+        int c12();
+        int c13();
+        int c14();
+        int c15();
+    }
+
+    interface Dispatch3 {
+        int d0();
+        int d1();
+        int d2();
+        int d3();
+        int d4();
+        int d5();
+        int d6();
+        int d7();
+        int d8();
+        int d9();
+        int d10();
+        int d11();
+        int d12();
+        int d13();
+        int d14();
+        int d15();
+    }
+
+    interface Single {
+        int s();
+    }
+
+    static class Base implements Dispatch0, Dispatch1, Dispatch2, Dispatch3, Single {
+        public int a0() { return 0; }
+        public int a1() { return 1; }
+        public int a2() { return 2; }
+        public int a3() { return 3; }
+        public int a4() { return 4; }
+        public int a5() { return 5; }
+        public int a6() { return 6; }
+        public int a7() { return 7; }
+        public int a8() { return 8; }
+        public int a9() { return 9; }
+        public int a10() { return 10; }
+        public int a11() { return 11; }
+        public int a12() { return 12; }
+        public int a13() { return 13; }
+        public int a14() { return 14; }
+        public int a15() { return 15; }
+        public int b0() { return 16; }
+        public int b1() { return 17; }
+        public int b2() { return 18; }
+        public int b3() { return 19; }
+        public int b4() { return 20; }
+        public int b5() { return 21; }
+        public int b6() { return 22; }
+        public int b7() { return 23; }
+        public int b8() { return 24; }
+        public int b9() { return 25; }
+        public int b10() { return 26; }
+        public int b11() { return 27; }
+        public int b12() { return 28; }
+        public int b13() { return 29; }
+        public int b14() { return 30; }
+        public int b15() { return 31; }
+        public int c0() { return 32; }
+        public int c1() { return 33; }
+        public int c2() { return 34; }
+        public int c3() { return 35; }
+        public int c4() { return 36; }
+        public int c5() { return 37; }
+        public int c6() { return 38; }
+        public int c7() { return 39; }
+        public int c8() { return 40; }
+        public int c9() { return 41; }
+        public int c10() { return 42; }
+        public int c11() { return 43; }
+        public int c12() { return 44; }
+        public int c13() { return 45; }
+        public int c14() { return 46; }
+        public int c15() { return 47; }
+        public int d0() { return 48; }
+        public int d1() { return 49; }
+        public int d2() { return 50; }
+        public int d3() { return 51; }
+        public int d4() { return 52; }
+        public int d5() { return 53; }
+        public int d6() { return 54; }
+        public int d7() { return 55; }
+        public int d8() { return 56; }
+        public int d9() { return 57; }
+        public int d10() { return 58; }
+        public int d11() { return 59; }
+        public int d12() { return 60; }
+        public int d13() { return 61; }
+        public int d14() { return 62; }
+        public int d15() { return 63; }
+        public int s() { return 64; }
+    }
+
+    // Five receiver classes make the call sites megamorphic, so the JIT's inline caches do
+    // not bypass the IMT. The overrides in `Impl4` keep CHA from devirtualizing the calls.
+    static class Impl0 extends Base {}
+    static class Impl1 extends Base {}
+    static class Impl2 extends Base {}
+    static class Impl3 extends Base {}
+    static class Impl4 extends Base {
+        public int a0() { return -1; }
+        public int a15() { return -1; }
+        public int d0() { return -1; }
+        public int d15() { return -1; }
+        public int s() { return -1; }
+    }
+
+    public static Base[] receivers = {
+        new Impl0(), new Impl1(), new Impl2(), new Impl3(), new Impl4(),
+    };
+    public static int result;
+
+    public void timeSingleInterfaceCall(int count) {
+        Base[] arr = receivers;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            Single s = arr[i % arr.length];
+            sum += s.s();
+        }
+        result = sum;
+    }
+
+    public void timeConflictingInterfaceCalls(int count) {
+        Base[] arr = receivers;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            Base b = arr[i % arr.length];
+            Dispatch0 d0 = b;
+            Dispatch3 d3 = b;
+            sum += d0.a0() + d0.a15() + d3.d0() + d3.d15();
+        }
+        result = sum;
+    }
+
+    public void timeVirtualCalls(int count) {
+        Base[] arr = receivers;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            Base b = arr[i % arr.length];
+            sum += b.a0() + b.a15() + b.d0() + b.d15();
+        }
+        result = sum;
+    }
+}
@@ -0,0 +1,71 @@
+#!/usr/bin/python3
+#
+# Copyright (C) 2026 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Combines the JSON lines printed by JitWarmupBenchmark with the jit-warmup-PID.csv log written
+   by `-Xcompiler-option --jit-warmup-log`, and prints per workload how many methods reached
+   baseline and optimized code, when the last one did, and the JIT CPU cost of getting there."""
+
+import argparse
+import csv
+import json
+import sys
+
+
+def read_compilations(path):
+  with open(path, newline='') as f:
+    return [{'time_ns': int(row['time_ns']),
+             'kind': row['kind'],
+             'success': row['success'] == '1',
+             'wall_ns': int(row['wall_ns']),
+             'thread_cpu_ns': int(row['thread_cpu_ns']),
+             'method': row['method']} for row in csv.DictReader(f)]
+
+
+def summarize(workload, compilations):
+  start, end = workload['start_ns'], workload['end_ns']
+  inside = [c for c in compilations if start <= c['time_ns'] <= end]
+  summary = {'workload': workload['workload'],
+             'steady_state_us': workload['steady_state_us'],
+             'time_to_steady_state_us': workload['time_to_steady_state_us'],
+             'compilations': len(inside),
+             'failed_compilations': sum(1 for c in inside if not c['success']),
+             'jit_thread_cpu_us': sum(c['thread_cpu_ns'] for c in inside) // 1000}
+  for kind in ('kBaseline', 'kOptimized', 'kOsr'):
+    done = [c for c in inside if c['kind'] == kind and c['success']]
+    name = kind[1:].lower()
+    summary[name + '_methods'] = len({c['method'] for c in done})
+    summary['last_' + name + '_us'] = (max(c['time_ns'] for c in done) - start) // 1000 \
+        if done else None
+    summary[name + '_cpu_us'] = sum(c['thread_cpu_ns'] for c in done) // 1000
+  return summary
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__)
+  parser.add_argument('benchmark_output', help='JSON lines printed by JitWarmupBenchmark')
+  parser.add_argument('warmup_log', help='jit-warmup-PID.csv written by the runtime')
+  args = parser.parse_args()
+  compilations = read_compilations(args.warmup_log)
+  with open(args.benchmark_output) as f:
+    for line in f:
+      line = line.strip()
+      if line.startswith('{'):
+        json.dump(summarize(json.loads(line), compilations), sys.stdout)
+        sys.stdout.write('\n')
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.io.File;
+import java.io.IOException;
+import java.nio.file.Files;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+
+public class JitWarmupBenchmark {
+    // USER_HZ, the unit of the CPU times in /proc/<pid>/task/<tid>/stat.
+    private static final long kClockTicksPerSecond = 100;
+    // An iteration is considered warm once it is within this factor of the steady state.
+    private static final double kSteadyStateTolerance = 1.10;
+
+    private static volatile Object sink;
+
+    private interface Shape {
+        double area();
+    }
+
+    private static final class Square implements Shape {
+        private final double side;
+        Square(double side) { this.side = side; }
+        public double area() { return side * side; }
+    }
+
+    private static final class Circle implements Shape {
+        private final double radius;
+        Circle(double radius) { this.radius = radius; }
+        public double area() { return Math.PI * radius * radius; }
+    }
+
+    private static final class Triangle implements Shape {
+        private final double base;
+        private final double height;
+        Triangle(double base, double height) { this.base = base; this.height = height; }
+        public double area() { return 0.5 * base * height; }
+    }
+
+    // Tight arithmetic loops; reaches steady state as soon as the loop is compiled.
+    public void timeArithmetic(int count) {
+        for (int i = 0; i < count; ++i) {
+            arithmetic();
+        }
+    }
+
+    // Polymorphic interface calls, exercising inline caches and the baseline-to-optimized switch.
+    public void timeDispatch(int count) {
+        for (int i = 0; i < count; ++i) {
+            dispatch();
+        }
+    }
+
+    // String building and parsing through many small library methods.
+    public void timeStrings(int count) {
+        for (int i = 0; i < count; ++i) {
+            strings();
+        }
+    }
+
+    // Collections with boxing, hashing and sorting; many methods get hot at the same time.
+    public void timeCollections(int count) {
+        for (int i = 0; i < count; ++i) {
+            collections();
+        }
+    }
+
+    private static void arithmetic() {
+        long hash = 17;
+        for (int i = 0; i < 200000; ++i) {
+            hash = hash * 31 + (i ^ (hash >>> 7));
+            if ((i & 15) == 0) {
+                hash += Long.numberOfLeadingZeros(hash);
+            }
+        }
+        sink = hash;
+    }
+
+    private static final Shape[] shapes = makeShapes();
+
+    private static Shape[] makeShapes() {
+        Shape[] result = new Shape[3000];
+        for (int i = 0; i < result.length; ++i) {
+            switch (i % 3) {
+                case 0: result[i] = new Square(i); break;
+                case 1: result[i] = new Circle(i); break;
+                default: result[i] = new Triangle(i, i + 1); break;
+            }
+        }
+        return result;
+    }
+
+    private static void dispatch() {
+        double total = 0;
+        for (int repeat = 0; repeat < 20; ++repeat) {
+            for (Shape shape : shapes) {
+                total += shape.area();
+            }
+        }
+        sink = total;
+    }
+
+    private static void strings() {
+        StringBuilder builder = new StringBuilder();
+        for (int i = 0; i < 2000; ++i) {
+            builder.append("key").append(i).append('=').append(i * 7).append(';');
+        }
+        int sum = 0;
+        for (String entry : builder.toString().split(";")) {
+            int equals = entry.indexOf('=');
+            sum += Integer.parseInt(entry.substring(equals + 1));
+            sum += entry.substring(0, equals).length();
+        }
+        sink = sum;
+    }
+
+    private static void collections() {
+        Map<Integer, List<Integer>> buckets = new HashMap<>();
+        for (int i = 0; i < 5000; ++i) {
+            buckets.computeIfAbsent(i % 97, k -> new ArrayList<>()).add(i * 31 % 1009);
+        }
+        long sum = 0;
+        for (List<Integer> bucket : buckets.values()) {
+            Collections.sort(bucket);
+            sum += bucket.get(bucket.size() / 2);
+        }
+        sink = sum;
+    }
+
+    private interface Workload {
+        void run();
+    }
+
+    // Runs each workload (or only the one named by the second argument) from a cold start and
+    // prints one JSON object per line with the time of the first iteration, the steady state
+    // (median of the last quarter of the iterations), the number of iterations needed to get
+    // within 10% of the steady state, the CPU time spent by the JIT thread pool during the
+    // workload and the per-iteration warmup curve. The `start_ns` and `end_ns` fields use the
+    // same clock as the runtime's `-Xcompiler-option --jit-warmup-log`, so compilations can be
+    // attributed to workloads; see jit_warmup_report.py. Run one workload per process for
+    // uncontaminated curves.
+    public static void main(String[] args) throws IOException {
+        int iterations = (args.length > 0) ? Integer.parseInt(args[0]) : 200;
+        String only = (args.length > 1) ? args[1] : null;
+        report("arithmetic", only, iterations, JitWarmupBenchmark::arithmetic);
+        report("dispatch", only, iterations, JitWarmupBenchmark::dispatch);
+        report("strings", only, iterations, JitWarmupBenchmark::strings);
+        report("collections", only, iterations, JitWarmupBenchmark::collections);
+    }
+
+    private static void report(String name, String only, int iterations, Workload workload)
+            throws IOException {
+        if (only != null && !only.equals(name)) {
+            return;
+        }
+        long[] times = new long[iterations];
+        long jitTicksBefore = jitThreadPoolTicks();
+        long start = System.nanoTime();
+        for (int i = 0; i < iterations; ++i) {
+            long iterationStart = System.nanoTime();
+            workload.run();
+            times[i] = System.nanoTime() - iterationStart;
+        }
+        long end = System.nanoTime();
+        long jitTicks = jitThreadPoolTicks() - jitTicksBefore;
+
+        int tailLength = Math.max(1, iterations / 4);
+        long[] tail = Arrays.copyOfRange(times, iterations - tailLength, iterations);
+        Arrays.sort(tail);
+        long steadyState = tail[tail.length / 2];
+        // The first iteration after which all iterations stay close to the steady state.
+        int warmIteration = iterations;
+        while (warmIteration > 0
+                && times[warmIteration - 1] <= steadyState * kSteadyStateTolerance) {
+            --warmIteration;
+        }
+        StringBuilder curve = new StringBuilder();
+        for (int i = 0; i < iterations; ++i) {
+            curve.append(i == 0 ? "" : ", ").append(times[i] / 1000);
+        }
+        System.out.println("{\"workload\": \"" + name + "\""
+                + ", \"iterations\": " + iterations
+                + ", \"first_iteration_us\": " + times[0] / 1000
+                + ", \"steady_state_us\": " + steadyState / 1000
+                + ", \"iterations_to_steady_state\": " + warmIteration
+                + ", \"time_to_steady_state_us\": " + sumUs(times, warmIteration)
+                + ", \"jit_cpu_ms\": " + (jitTicks * 1000 / kClockTicksPerSecond)
+                + ", \"start_ns\": " + start
+                + ", \"end_ns\": " + end
+                + ", \"iteration_us\": [" + curve + "]}");
+    }
+
+    private static long sumUs(long[] times, int count) {
+        long sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += times[i];
+        }
+        return sum / 1000;
+    }
+
+    // Sums the user and system CPU ticks of the JIT thread pool workers, read from /proc so
+    // that this works the same on host and device.
+    private static long jitThreadPoolTicks() throws IOException {
+        File[] tasks = new File("/proc/self/task").listFiles();
+        if (tasks == null) {
+            return 0;
+        }
+        long ticks = 0;
+        for (File task : tasks) {
+            String stat;
+            try {
+                stat = new String(Files.readAllBytes(new File(task, "stat").toPath()));
+            } catch (IOException e) {
+                continue;  // The thread exited.
+            }
+            // Format: "tid (comm) state ppid ...", where comm may contain spaces.
+            int open = stat.indexOf('(');
+            int close = stat.lastIndexOf(')');
+            if (open < 0 || close < open
+                    || !stat.substring(open + 1, close).startsWith("Jit thread pool")) {
+                continue;
+            }
+            String[] fields = stat.substring(close + 2).split(" ");
+            // utime and stime are fields 14 and 15 of the full line, 12 and 13 after comm.
+            ticks += Long.parseLong(fields[11]) + Long.parseLong(fields[12]);
+        }
+        return ticks;
+    }
+}
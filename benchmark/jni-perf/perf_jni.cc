@@ -34,6 +34,27 @@ extern "C" JNIEXPORT void JNICALL Java_JniPerfBenchmark_perfSOAUncheckedCall(JNI
   ScopedObjectAccessUnchecked soa(Thread::Current());
 }
 
+// A leaf native that does not touch the JNIEnv, like typical math or hashing helpers.
+static jlong MixHash(jlong value) {
+  uint64_t x = static_cast<uint64_t>(value);
+  x ^= x >> 33;
+  x *= UINT64_C(0xff51afd7ed558ccd);
+  x ^= x >> 33;
+  return static_cast<jlong>(x);
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_JniPerfBenchmark_perfJniLeafCall(JNIEnv*,
+                                                                          jobject,
+                                                                          jlong value) {
+  return MixHash(value);
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_JniPerfBenchmark_perfJniLeafCallPromoted(JNIEnv*,
+                                                                                  jobject,
+                                                                                  jlong value) {
+  return MixHash(value);
+}
+
 }  // namespace
 
 }  // namespace art
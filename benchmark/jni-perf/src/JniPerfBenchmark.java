@@ -20,6 +20,10 @@ public class JniPerfBenchmark {
   native void perfJniEmptyCall();
   native void perfSOACall();
   native void perfSOAUncheckedCall();
+  native long perfJniLeafCall(long value);
+  // Listed in fast_native_methods.txt; only uses @FastNative transitions when the runtime
+  // (and dex2oat) are given that file with -Xfast-native-methods-file.
+  native long perfJniLeafCallPromoted(long value);
 
   public void timeFastJNI(int N) {
     // TODO: This might be an intrinsic.
@@ -46,6 +50,22 @@ public class JniPerfBenchmark {
     }
   }
 
+  public long timeLeafCall(int N) {
+    long result = 0;
+    for (long i = 0; i < N; i++) {
+      result += perfJniLeafCall(i);
+    }
+    return result;
+  }
+
+  public long timeLeafCallPromoted(int N) {
+    long result = 0;
+    for (long i = 0; i < N; i++) {
+      result += perfJniLeafCallPromoted(i);
+    }
+    return result;
+  }
+
   {
     System.loadLibrary("artbenchmark");
   }
@@ -34,6 +34,23 @@ extern "C" JNIEXPORT void JNICALL Java_JObjectBenchmark_timeAddRemoveLocal(
   }
 }
 
+// Creates many local references in a fresh local frame per iteration, like native code that
+// processes a large batch of objects per call. This exercises local reference table growth.
+extern "C" JNIEXPORT void JNICALL Java_JObjectBenchmark_timeAddManyLocalsInFrame(
+    JNIEnv* env, jobject jobj, jint reps) {
+  static constexpr jint kLocalsPerFrame = 4096;
+  ScopedObjectAccess soa(env);
+  ObjPtr<mirror::Object> obj = soa.Decode<mirror::Object>(jobj);
+  CHECK(obj != nullptr);
+  for (jint i = 0; i < reps; ++i) {
+    soa.Env()->PushFrame(kLocalsPerFrame);
+    for (jint j = 0; j < kLocalsPerFrame; ++j) {
+      soa.Env()->AddLocalReference<jobject>(obj);
+    }
+    soa.Env()->PopFrame();
+  }
+}
+
 extern "C" JNIEXPORT void JNICALL Java_JObjectBenchmark_timeDecodeLocal(
     JNIEnv* env, jobject jobj, jint reps) {
   ScopedObjectAccess soa(env);
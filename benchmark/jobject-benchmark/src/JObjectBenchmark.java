@@ -19,6 +19,7 @@ public class JObjectBenchmark {
     // Make sure to link methods before benchmark starts.
     System.loadLibrary("artbenchmark");
     timeAddRemoveLocal(1);
+    timeAddManyLocalsInFrame(1);
     timeDecodeLocal(1);
     timeAddRemoveGlobal(1);
     timeDecodeGlobal(1);
@@ -28,6 +29,7 @@ public class JObjectBenchmark {
   }
 
   public native void timeAddRemoveLocal(int reps);
+  public native void timeAddManyLocalsInFrame(int reps);
   public native void timeDecodeLocal(int reps);
   public native void timeAddRemoveGlobal(int reps);
   public native void timeDecodeGlobal(int reps);
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Native microbenchmarks for runtime data structures that do not need a started runtime.
+// Use `--benchmark_format=json` for output suitable for regression tracking.
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "base/arena_allocator.h"
+#include "base/bit_memory_region.h"
+#include "base/bit_table.h"
+#include "base/fast_modulo.h"
+#include "base/hash_set.h"
+#include "base/leb128.h"
+#include "base/malloc_arena_pool.h"
+#include "base/mem_map.h"
+#include "base/scoped_arena_allocator.h"
+#include "gc/accounting/space_bitmap-inl.h"
+
+namespace art {
+
+static void BM_HashSetFind(benchmark::State& state) {
+  const size_t count = static_cast<size_t>(state.range(0));
+  HashSet<uint32_t> set;
+  // Avoid 0, which is the empty value of `HashSet<uint32_t>`.
+  for (size_t i = 0; i != count; ++i) {
+    set.insert(static_cast<uint32_t>(i * 7u + 1u));
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(set.find(static_cast<uint32_t>((i % count) * 7u + 1u)));
+    ++i;
+  }
+}
+BENCHMARK(BM_HashSetFind)->Range(64, 64 << 10);
+
+static void BM_HashSetInsert(benchmark::State& state) {
+  const size_t count = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    HashSet<uint32_t> set;
+    for (size_t i = 0; i != count; ++i) {
+      set.insert(static_cast<uint32_t>(i * 7u + 1u));
+    }
+    benchmark::DoNotOptimize(set.size());
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_HashSetInsert)->Range(64, 64 << 10);
+
+static constexpr size_t kAllocationsPerIteration = 1024u;
+
+static void BM_ArenaAllocatorAlloc(benchmark::State& state) {
+  const size_t size = static_cast<size_t>(state.range(0));
+  MallocArenaPool pool;
+  for (auto _ : state) {
+    ArenaAllocator allocator(&pool);
+    for (size_t i = 0; i != kAllocationsPerIteration; ++i) {
+      benchmark::DoNotOptimize(allocator.Alloc(size));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kAllocationsPerIteration);
+}
+BENCHMARK(BM_ArenaAllocatorAlloc)->RangeMultiplier(4)->Range(8, 512);
+
+static void BM_ScopedArenaAllocatorAlloc(benchmark::State& state) {
+  const size_t size = static_cast<size_t>(state.range(0));
+  MallocArenaPool pool;
+  ArenaStack arena_stack(&pool);
+  for (auto _ : state) {
+    ScopedArenaAllocator allocator(&arena_stack);
+    for (size_t i = 0; i != kAllocationsPerIteration; ++i) {
+      benchmark::DoNotOptimize(allocator.Alloc(size));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kAllocationsPerIteration);
+}
+BENCHMARK(BM_ScopedArenaAllocatorAlloc)->RangeMultiplier(4)->Range(8, 512);
+
+// Visits a bitmap for a 16 MiB space with every `state.range(0)`-th object slot marked.
+// The bitmap only computes addresses, so the covered range does not need to be mapped.
+static void BM_SpaceBitmapVisitMarkedRange(benchmark::State& state) {
+  constexpr size_t kHeapSize = 16 * MB;
+  uint8_t* heap_begin = reinterpret_cast<uint8_t*>(static_cast<uintptr_t>(256 * MB));
+  uintptr_t begin = reinterpret_cast<uintptr_t>(heap_begin);
+  uintptr_t end = begin + kHeapSize;
+  gc::accounting::ContinuousSpaceBitmap bitmap =
+      gc::accounting::ContinuousSpaceBitmap::Create("microbenchmark bitmap", heap_begin, kHeapSize);
+  CHECK(bitmap.IsValid());
+  const size_t stride = static_cast<size_t>(state.range(0)) * kObjectAlignment;
+  for (uintptr_t addr = begin; addr < end; addr += stride) {
+    bitmap.Set(reinterpret_cast<mirror::Object*>(addr));
+  }
+  for (auto _ : state) {
+    size_t visited = 0u;
+    bitmap.VisitMarkedRange(begin, end, [&visited](mirror::Object*) { ++visited; });
+    benchmark::DoNotOptimize(visited);
+  }
+  state.SetBytesProcessed(state.iterations() * kHeapSize);
+}
+BENCHMARK(BM_SpaceBitmapVisitMarkedRange)->RangeMultiplier(4)->Range(1, 256);
+
+// Decodes two adjacent columns of a `BitTable`, as stack map lookups do for each probe.
+template <bool kUsePair>
+static void BM_BitTableTwoColumns(benchmark::State& state) {
+  constexpr size_t kNumRows = 1024u;
+  MallocArenaPool pool;
+  ArenaStack arena_stack(&pool);
+  ScopedArenaAllocator allocator(&arena_stack);
+  std::vector<uint8_t> buffer;
+  BitMemoryWriter<std::vector<uint8_t>> writer(&buffer);
+  BitTableBuilderBase<3> builder(&allocator);
+  for (uint32_t row = 0; row != kNumRows; ++row) {
+    builder.Add({row % 3u, row * 12u, row});
+  }
+  builder.Encode(writer);
+  BitMemoryReader reader(buffer.data());
+  BitTableBase<3> table(reader);
+  for (auto _ : state) {
+    uint32_t sum = 0u;
+    for (uint32_t row = 0; row != kNumRows; ++row) {
+      if (kUsePair) {
+        auto [first, second] = table.GetPair(row, 0u);
+        sum += first + second;
+      } else {
+        sum += table.Get(row, 0u) + table.Get(row, 1u);
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kNumRows);
+}
+BENCHMARK_TEMPLATE(BM_BitTableTwoColumns, false);
+BENCHMARK_TEMPLATE(BM_BitTableTwoColumns, true);
+
+// Decodes a stream dominated by one-byte values, like dex class data and debug info.
+static void BM_DecodeUnsignedLeb128(benchmark::State& state) {
+  constexpr size_t kNumValues = 4096u;
+  Leb128EncodingVector<> encoder;
+  for (size_t i = 0; i != kNumValues; ++i) {
+    encoder.PushBackUnsigned((i % 4u == 3u) ? (i & 0x3fffu) : (i & 0x7fu));
+  }
+  for (auto _ : state) {
+    const uint8_t* ptr = encoder.GetData().data();
+    uint32_t sum = 0u;
+    for (size_t i = 0; i != kNumValues; ++i) {
+      sum += DecodeUnsignedLeb128(&ptr);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kNumValues);
+}
+BENCHMARK(BM_DecodeUnsignedLeb128);
+
+template <bool kUseFastModulo>
+static void BM_Modulo(benchmark::State& state) {
+  // A non-power-of-two bucket count, as used by `HashSet`.
+  const size_t divisor = static_cast<size_t>(state.range(0));
+  FastModulo modulo(divisor);
+  size_t n = static_cast<size_t>(UINT64_C(0x9e3779b97f4a7c15));
+  for (auto _ : state) {
+    size_t result = kUseFastModulo ? modulo.Modulo(n) : n % divisor;
+    benchmark::DoNotOptimize(result);
+    n += result + 1u;
+  }
+}
+BENCHMARK_TEMPLATE(BM_Modulo, false)->Arg(1031);
+BENCHMARK_TEMPLATE(BM_Modulo, true)->Arg(1031);
+
+}  // namespace art
+
+int main(int argc, char** argv) {
+  art::MemMap::Init();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -56,3 +56,15 @@ extern "C" JNIEXPORT jlong JNICALL Java_ScopedPrimitiveArrayBenchmark_measureLon
   }
   return ret;
 }
+
+extern "C" JNIEXPORT jlong JNICALL Java_ScopedPrimitiveArrayBenchmark_measureCriticalByteArray(
+    JNIEnv* env, jclass, int reps, jbyteArray arr) {
+  jlong ret = 0;
+  jsize length = env->GetArrayLength(arr);
+  for (jint i = 0; i < reps; ++i) {
+    jbyte* data = reinterpret_cast<jbyte*>(env->GetPrimitiveArrayCritical(arr, nullptr));
+    ret += data[0] + data[length - 1];
+    env->ReleasePrimitiveArrayCritical(arr, data, JNI_ABORT);
+  }
+  return ret;
+}
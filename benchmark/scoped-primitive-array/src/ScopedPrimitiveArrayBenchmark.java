@@ -20,6 +20,8 @@ public class ScopedPrimitiveArrayBenchmark {
   static native long measureShortArray(int reps, short[] arr);
   static native long measureIntArray(int reps, int[] arr);
   static native long measureLongArray(int reps, long[] arr);
+  // Same as measureByteArray, but with Get/ReleasePrimitiveArrayCritical.
+  static native long measureCriticalByteArray(int reps, byte[] arr);
 
   static final int smallLength = 16;
   static final int mediumLength = 256;
@@ -36,6 +38,7 @@ public class ScopedPrimitiveArrayBenchmark {
   static long[] smallLongs = new long[smallLength];
   static long[] mediumLongs = new long[mediumLength];
   static long[] largeLongs = new long[largeLength];
+  static volatile boolean gcLoopDone;
 
   public void timeSmallBytes(int reps) {
     measureByteArray(reps, smallBytes);
@@ -85,6 +88,26 @@ public class ScopedPrimitiveArrayBenchmark {
     measureLongArray(reps, largeLongs);
   }
 
+  public void timeCriticalMediumBytes(int reps) {
+    measureCriticalByteArray(reps, mediumBytes);
+  }
+
+  // Critical sections on arrays that survived a GC can pin the array instead of blocking the
+  // collector, so a concurrent GC loop should not slow these down.
+  public void timeCriticalMediumBytesWithConcurrentGc(int reps) throws Exception {
+    Runtime.getRuntime().gc();
+    gcLoopDone = false;
+    Thread gcThread = new Thread(() -> {
+      while (!gcLoopDone) {
+        Runtime.getRuntime().gc();
+      }
+    });
+    gcThread.start();
+    measureCriticalByteArray(reps, mediumBytes);
+    gcLoopDone = true;
+    gcThread.join();
+  }
+
   {
     System.loadLibrary("artbenchmark");
   }
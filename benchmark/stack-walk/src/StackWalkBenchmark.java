@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class StackWalkBenchmark {
+    private static final int kDepth = 20;
+    private static final int kDeepDepth = 200;
+    private static final int kNumThreads = 4;
+
+    public void timeThrowAndCatch(int count) {
+        for (int i = 0; i < count; ++i) {
+            $noinline$throwAndCatch();
+        }
+    }
+
+    public void timeGetStackTrace(int count) {
+        for (int i = 0; i < count; ++i) {
+            $noinline$getStackTrace(kDepth);
+        }
+    }
+
+    public void timeGetDeepStackTrace(int count) {
+        for (int i = 0; i < count; ++i) {
+            $noinline$getStackTrace(kDeepDepth);
+        }
+    }
+
+    public void timeGetDeepStackTraceMutualRecursion(int count) {
+        for (int i = 0; i < count; ++i) {
+            $noinline$getStackTraceEven(kDeepDepth);
+        }
+    }
+
+    public void timeThrowAndCatchOnThreads(int count) throws Exception {
+        runOnThreads(count, () -> $noinline$throwAndCatch());
+    }
+
+    public void timeGetStackTraceOnThreads(int count) throws Exception {
+        runOnThreads(count, () -> $noinline$getStackTrace(kDepth));
+    }
+
+    private static void runOnThreads(int count, Runnable runnable) throws Exception {
+        Thread[] threads = new Thread[kNumThreads];
+        for (int t = 0; t < kNumThreads; ++t) {
+            threads[t] = new Thread(() -> {
+                for (int i = 0; i < count; ++i) {
+                    runnable.run();
+                }
+            });
+            threads[t].start();
+        }
+        for (Thread thread : threads) {
+            thread.join();
+        }
+    }
+
+    private static void $noinline$throwAndCatch() {
+        try {
+            $noinline$throwAt(kDepth);
+        } catch (IllegalStateException expected) {
+        }
+    }
+
+    private static int $noinline$throwAt(int depth) {
+        if (depth == 0) {
+            throw new IllegalStateException();
+        }
+        return $noinline$throwAt(depth - 1) + 1;
+    }
+
+    private static int $noinline$getStackTrace(int depth) {
+        if (depth == 0) {
+            return new Throwable().getStackTrace().length;
+        }
+        return $noinline$getStackTrace(depth - 1) + 1;
+    }
+
+    // Alternate between two methods, so that consecutive frames have different code.
+    private static int $noinline$getStackTraceEven(int depth) {
+        if (depth == 0) {
+            return new Throwable().getStackTrace().length;
+        }
+        return $noinline$getStackTraceOdd(depth - 1) + 1;
+    }
+
+    private static int $noinline$getStackTraceOdd(int depth) {
+        if (depth == 0) {
+            return new Throwable().getStackTrace().length;
+        }
+        return $noinline$getStackTraceEven(depth - 1) + 1;
+    }
+}
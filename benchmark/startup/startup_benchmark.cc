@@ -0,0 +1,329 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures the startup of `dalvikvm` by forking and executing it repeatedly. For every run it
+// reports the time from fork() to the end of Runtime::Start() (i.e. just before main() is
+// invoked), the total wall and CPU time, the page faults and the peak RSS of the child, and
+// the duration of each runtime initialization phase, taken from the timeline that the runtime
+// writes with -Xstartup-timeline-file. Each run is printed as one JSON line, followed by a line
+// with the median of every metric.
+//
+// Example:
+//   art_startup_benchmark --runs=20 --boot-class-path=$BCP --boot-image=$IMAGE -- -cp A.jar A
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace art {
+namespace {
+
+constexpr const char kRuntimeStartPhase[] = "Runtime::Start";
+
+struct Options {
+  std::string dalvikvm = "dalvikvm";
+  std::string boot_class_path;
+  std::string boot_image;
+  std::vector<std::string> runtime_args;
+  std::vector<std::string> program_args;
+  size_t runs = 10u;
+  size_t warmup_runs = 1u;
+  bool drop_caches = false;
+  bool keep_output = false;
+};
+
+struct RunResult {
+  std::map<std::string, uint64_t> metrics;
+  std::map<std::string, uint64_t> phases_us;
+};
+
+uint64_t MonotonicMicros() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000u + static_cast<uint64_t>(now.tv_nsec) / 1000u;
+}
+
+uint64_t TimevalMicros(const timeval& tv) {
+  return static_cast<uint64_t>(tv.tv_sec) * 1000000u + static_cast<uint64_t>(tv.tv_usec);
+}
+
+[[noreturn]] void Usage(const char* error) {
+  if (error != nullptr) {
+    fprintf(stderr, "%s\n\n", error);
+  }
+  fprintf(stderr,
+          "Usage: art_startup_benchmark [options] -- <dalvikvm arguments, e.g. -cp X.jar Main>\n"
+          "  --dalvikvm=<path>           dalvikvm binary to run (default: dalvikvm)\n"
+          "  --boot-class-path=<paths>   passed as -Xbootclasspath:<paths>\n"
+          "  --boot-image=<path>         passed as -Ximage:<path>\n"
+          "  --runtime-arg=<arg>         extra runtime argument, may be repeated\n"
+          "  --runs=<n>                  measured runs (default: 10)\n"
+          "  --warmup-runs=<n>           unmeasured runs before the first one (default: 1)\n"
+          "  --drop-caches               drop the page cache before each run (needs root)\n"
+          "  --keep-output               do not discard the output of dalvikvm\n");
+  exit(1);
+}
+
+size_t ParseCount(const std::string& value) {
+  char* end;
+  unsigned long result = strtoul(value.c_str(), &end, 10);
+  if (value.empty() || *end != '\0') {
+    Usage(("Invalid count: " + value).c_str());
+  }
+  return static_cast<size_t>(result);
+}
+
+Options ParseOptions(int argc, char** argv) {
+  Options options;
+  int i = 1;
+  for (; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto value = [&](const char* prefix) { return arg.substr(strlen(prefix)); };
+    if (arg == "--") {
+      ++i;
+      break;
+    } else if (arg.starts_with("--dalvikvm=")) {
+      options.dalvikvm = value("--dalvikvm=");
+    } else if (arg.starts_with("--boot-class-path=")) {
+      options.boot_class_path = value("--boot-class-path=");
+    } else if (arg.starts_with("--boot-image=")) {
+      options.boot_image = value("--boot-image=");
+    } else if (arg.starts_with("--runtime-arg=")) {
+      options.runtime_args.push_back(value("--runtime-arg="));
+    } else if (arg.starts_with("--runs=")) {
+      options.runs = ParseCount(value("--runs="));
+    } else if (arg.starts_with("--warmup-runs=")) {
+      options.warmup_runs = ParseCount(value("--warmup-runs="));
+    } else if (arg == "--drop-caches") {
+      options.drop_caches = true;
+    } else if (arg == "--keep-output") {
+      options.keep_output = true;
+    } else {
+      Usage(("Unknown option: " + arg).c_str());
+    }
+  }
+  options.program_args.assign(argv + i, argv + argc);
+  if (options.program_args.empty()) {
+    Usage("Missing dalvikvm arguments after --");
+  }
+  if (options.runs == 0u) {
+    Usage("--runs must be positive");
+  }
+  return options;
+}
+
+void DropCaches() {
+  sync();
+  int fd = open("/proc/sys/vm/drop_caches", O_WRONLY | O_CLOEXEC);
+  if (fd < 0 || write(fd, "3", 1) != 1) {
+    fprintf(stderr, "Could not drop caches: %s\n", strerror(errno));
+  }
+  if (fd >= 0) {
+    close(fd);
+  }
+}
+
+// Extracts the phases from the timeline, which the runtime writes with one event per line:
+//   {"name":"<phase>","ph":"X","pid":<pid>,"tid":<tid>,"ts":<us>,"dur":<us>}
+// A phase recorded more than once (e.g. on several threads) is summed.
+bool ReadTimeline(const std::string& filename,
+                  std::map<std::string, uint64_t>* phases_us,
+                  uint64_t* runtime_start_end_us) {
+  std::ifstream timeline(filename);
+  if (!timeline) {
+    return false;
+  }
+  auto field = [](const std::string& line, const char* key) -> std::string {
+    size_t pos = line.find(key);
+    if (pos == std::string::npos) {
+      return "";
+    }
+    pos += strlen(key);
+    return line.substr(pos, line.find_first_of(",\"}", pos) - pos);
+  };
+  bool found_runtime_start = false;
+  for (std::string line; std::getline(timeline, line);) {
+    std::string name = field(line, "\"name\":\"");
+    if (name.empty()) {
+      continue;
+    }
+    uint64_t ts = strtoull(field(line, "\"ts\":").c_str(), nullptr, 10);
+    uint64_t dur = strtoull(field(line, "\"dur\":").c_str(), nullptr, 10);
+    (*phases_us)[name] += dur;
+    if (name == kRuntimeStartPhase) {
+      *runtime_start_end_us = ts + dur;
+      found_runtime_start = true;
+    }
+  }
+  return found_runtime_start;
+}
+
+bool Run(const Options& options, const std::string& timeline_file, RunResult* result) {
+  std::vector<std::string> args = {options.dalvikvm};
+  if (!options.boot_class_path.empty()) {
+    args.push_back("-Xbootclasspath:" + options.boot_class_path);
+  }
+  if (!options.boot_image.empty()) {
+    args.push_back("-Ximage:" + options.boot_image);
+  }
+  args.push_back("-Xstartup-timeline-file:" + timeline_file);
+  args.insert(args.end(), options.runtime_args.begin(), options.runtime_args.end());
+  args.insert(args.end(), options.program_args.begin(), options.program_args.end());
+  std::vector<char*> argv;
+  for (std::string& arg : args) {
+    argv.push_back(arg.data());
+  }
+  argv.push_back(nullptr);
+
+  unlink(timeline_file.c_str());
+  if (options.drop_caches) {
+    DropCaches();
+  }
+  uint64_t start_us = MonotonicMicros();
+  pid_t pid = fork();
+  if (pid < 0) {
+    fprintf(stderr, "fork failed: %s\n", strerror(errno));
+    return false;
+  }
+  if (pid == 0) {
+    if (!options.keep_output) {
+      int null_fd = open("/dev/null", O_WRONLY);
+      dup2(null_fd, STDOUT_FILENO);
+      dup2(null_fd, STDERR_FILENO);
+    }
+    execvp(argv[0], argv.data());
+    _exit(127);
+  }
+  int status;
+  rusage usage;
+  if (wait4(pid, &status, 0, &usage) != pid) {
+    fprintf(stderr, "wait4 failed: %s\n", strerror(errno));
+    return false;
+  }
+  uint64_t end_us = MonotonicMicros();
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    fprintf(stderr, "%s did not exit successfully (status %d)\n", argv[0], status);
+    return false;
+  }
+  uint64_t runtime_start_end_us = 0u;
+  if (!ReadTimeline(timeline_file, &result->phases_us, &runtime_start_end_us)) {
+    fprintf(stderr, "No %s phase in %s; does the runtime support -Xstartup-timeline-file?\n",
+            kRuntimeStartPhase, timeline_file.c_str());
+    return false;
+  }
+  result->metrics["time_to_main_us"] = runtime_start_end_us - start_us;
+  result->metrics["wall_us"] = end_us - start_us;
+  result->metrics["cpu_us"] = TimevalMicros(usage.ru_utime) + TimevalMicros(usage.ru_stime);
+  result->metrics["minor_faults"] = static_cast<uint64_t>(usage.ru_minflt);
+  result->metrics["major_faults"] = static_cast<uint64_t>(usage.ru_majflt);
+  result->metrics["max_rss_kb"] = static_cast<uint64_t>(usage.ru_maxrss);
+  return true;
+}
+
+std::string ToJson(const std::string& label, const RunResult& result) {
+  std::ostringstream json;
+  json << "{" << label;
+  for (const auto& [name, value] : result.metrics) {
+    json << ", \"" << name << "\": " << value;
+  }
+  json << ", \"phases_us\": {";
+  const char* separator = "";
+  for (const auto& [name, value] : result.phases_us) {
+    json << separator << "\"" << name << "\": " << value;
+    separator = ", ";
+  }
+  json << "}}";
+  return json.str();
+}
+
+uint64_t Median(std::vector<uint64_t> values) {
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+RunResult Medians(const std::vector<RunResult>& results) {
+  std::map<std::string, std::vector<uint64_t>> metrics;
+  std::map<std::string, std::vector<uint64_t>> phases;
+  for (const RunResult& result : results) {
+    for (const auto& [name, value] : result.metrics) {
+      metrics[name].push_back(value);
+    }
+    for (const auto& [name, value] : result.phases_us) {
+      phases[name].push_back(value);
+    }
+  }
+  RunResult medians;
+  for (const auto& [name, values] : metrics) {
+    medians.metrics[name] = Median(values);
+  }
+  for (const auto& [name, values] : phases) {
+    medians.phases_us[name] = Median(values);
+  }
+  return medians;
+}
+
+int StartupBenchmarkMain(int argc, char** argv) {
+  Options options = ParseOptions(argc, argv);
+  const char* tmp_dir = getenv("TMPDIR");
+  std::string dir_template = std::string(tmp_dir != nullptr ? tmp_dir : "/tmp") +
+                             "/art_startup_benchmark.XXXXXX";
+  if (mkdtemp(dir_template.data()) == nullptr) {
+    fprintf(stderr, "mkdtemp failed: %s\n", strerror(errno));
+    return 1;
+  }
+  std::string timeline_file = dir_template + "/timeline.json";
+
+  std::vector<RunResult> results;
+  bool success = true;
+  for (size_t i = 0; success && i != options.warmup_runs + options.runs; ++i) {
+    RunResult result;
+    success = Run(options, timeline_file, &result);
+    if (success && i >= options.warmup_runs) {
+      size_t run = i - options.warmup_runs;
+      printf("%s\n", ToJson("\"run\": " + std::to_string(run), result).c_str());
+      results.push_back(std::move(result));
+    }
+  }
+  unlink(timeline_file.c_str());
+  rmdir(dir_template.c_str());
+  if (!success) {
+    return 1;
+  }
+  printf("%s\n", ToJson("\"median_of_runs\": " + std::to_string(results.size()),
+                        Medians(results)).c_str());
+  return 0;
+}
+
+}  // namespace
+}  // namespace art
+
+int main(int argc, char** argv) {
+  return art::StartupBenchmarkMain(argc, argv);
+}
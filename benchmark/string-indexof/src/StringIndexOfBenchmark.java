@@ -16,6 +16,16 @@
 
 public class StringIndexOfBenchmark {
     public static final String string36 = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";  // length = 36
+    // Same as `string36` but with a char that cannot be compressed at the end.
+    public static final String string36u = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXY\u0100";
+    public static final String string1024;
+    static {
+        StringBuilder sb = new StringBuilder();
+        while (sb.length() < 1023) {
+            sb.append((char) ('a' + sb.length() % 26));
+        }
+        string1024 = sb.append('Z').toString();
+    }
 
     public void timeIndexOf0(int count) {
         final char c = '0';
@@ -113,6 +123,30 @@ public class StringIndexOfBenchmark {
         }
     }
 
+    public void timeIndexOfUncompressedW(int count) {
+        final char c = 'W';
+        String s = string36u;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, c);
+        }
+    }
+
+    public void timeIndexOfUncompressed_(int count) {
+        final char c = '_';
+        String s = string36u;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, c);
+        }
+    }
+
+    public void timeIndexOfLongZ(int count) {
+        final char c = 'Z';
+        String s = string1024;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, c);
+        }
+    }
+
     static int $noinline$indexOf(String s, char c) {
         if (doThrow) { throw new Error(); }
         return s.indexOf(c);
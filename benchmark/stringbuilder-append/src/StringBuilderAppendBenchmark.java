@@ -116,6 +116,19 @@ public class StringBuilderAppendBenchmark {
         }
     }
 
+    public void timeAppendStringAndCharArray(int count) {
+        String s1 = string1;
+        char[] chars = { 'c', 'h', 'a', 'r', 's' };
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            String result = new StringBuilder().append(s1).append(chars).toString();
+            sum += result.length();  // Make sure the append is not optimized away.
+        }
+        if (sum != count * (s1.length() + chars.length)) {
+            throw new AssertionError();
+        }
+    }
+
     public void timeAppendStringDoubleStringAndFloat(int count) {
         String s1 = string1;
         String s2 = string2;
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.util.Arrays;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+
+public class ThreadCreateBenchmark {
+    private static final long kSmallStackSize = 64 * 1024;
+
+    private static volatile long runNanos;
+
+    private static final Runnable kRecordStart = () -> runNanos = System.nanoTime();
+
+    // Create, start and join one thread with the default stack size per iteration.
+    public void timeCreateJoin(int count) throws InterruptedException {
+        for (int i = 0; i < count; ++i) {
+            Thread thread = new Thread(kRecordStart);
+            thread.start();
+            thread.join();
+        }
+    }
+
+    // Same as above with a small stack, which makes the stack mapping cheaper.
+    public void timeCreateJoinSmallStack(int count) throws InterruptedException {
+        for (int i = 0; i < count; ++i) {
+            Thread thread = new Thread(null, kRecordStart, "small", kSmallStackSize);
+            thread.start();
+            thread.join();
+        }
+    }
+
+    // Daemon threads take a different path through runtime shutdown accounting.
+    public void timeCreateJoinDaemon(int count) throws InterruptedException {
+        for (int i = 0; i < count; ++i) {
+            Thread thread = new Thread(kRecordStart);
+            thread.setDaemon(true);
+            thread.start();
+            thread.join();
+        }
+    }
+
+    // The same task submitted to a pre-started single thread executor, as a lower bound.
+    public void timePooledSubmit(int count) throws Exception {
+        ExecutorService executor = Executors.newSingleThreadExecutor();
+        try {
+            for (int i = 0; i < count; ++i) {
+                executor.submit(kRecordStart).get();
+            }
+        } finally {
+            executor.shutdown();
+        }
+    }
+
+    private interface Spawner {
+        Thread spawn();
+    }
+
+    private static void report(String name, int iterations, Spawner spawner)
+            throws InterruptedException {
+        long[] toRun = new long[iterations];
+        long[] toJoin = new long[iterations];
+        for (int i = 0; i < iterations; ++i) {
+            long start = System.nanoTime();
+            Thread thread = spawner.spawn();
+            thread.start();
+            thread.join();
+            toJoin[i] = System.nanoTime() - start;
+            toRun[i] = runNanos - start;
+        }
+        Arrays.sort(toRun);
+        Arrays.sort(toJoin);
+        System.out.println(name
+                + ": run p50=" + toRun[iterations / 2] / 1000 + "us"
+                + " p90=" + toRun[iterations * 9 / 10] / 1000 + "us"
+                + ", join p50=" + toJoin[iterations / 2] / 1000 + "us"
+                + " p90=" + toJoin[iterations * 9 / 10] / 1000 + "us");
+    }
+
+    private static void reportPooled(int iterations) throws Exception {
+        long[] toJoin = new long[iterations];
+        ExecutorService executor = Executors.newSingleThreadExecutor();
+        try {
+            for (int i = 0; i < iterations; ++i) {
+                long start = System.nanoTime();
+                Future<?> result = executor.submit(kRecordStart);
+                result.get();
+                toJoin[i] = System.nanoTime() - start;
+            }
+        } finally {
+            executor.shutdown();
+        }
+        Arrays.sort(toJoin);
+        System.out.println("pooled: done p50=" + toJoin[iterations / 2] / 1000 + "us"
+                + " p90=" + toJoin[iterations * 9 / 10] / 1000 + "us");
+    }
+
+    public static void main(String[] args) throws Exception {
+        int iterations = (args.length > 0) ? Integer.parseInt(args[0]) : 1000;
+        // Warm up the thread creation paths so the first measurements are not dominated by
+        // class initialization and JIT compilation.
+        new ThreadCreateBenchmark().timeCreateJoin(100);
+        report("default", iterations, () -> new Thread(kRecordStart));
+        report("small-stack", iterations,
+                () -> new Thread(null, kRecordStart, "small", kSmallStackSize));
+        report("daemon", iterations, () -> {
+            Thread thread = new Thread(kRecordStart);
+            thread.setDaemon(true);
+            return thread;
+        });
+        reportPooled(iterations);
+    }
+}
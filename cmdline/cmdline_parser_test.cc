@@ -490,6 +490,7 @@ TEST_F(CmdlineParserTest, TestJitOptions) {
 */
 TEST_F(CmdlineParserTest, ProfileSaverOptions) {
   ProfileSaverOptions opt = ProfileSaverOptions(true, 1, 2, 3, 4, 5, 6, 7, 8, "abc", true);
+  opt.SetSamplingIntervalMs(9);
 
   EXPECT_SINGLE_PARSE_VALUE(opt,
                             "-Xjitsaveprofilinginfo "
@@ -501,6 +502,7 @@ TEST_F(CmdlineParserTest, ProfileSaverOptions) {
                             "-Xps-min-notification-before-wake:6 "
                             "-Xps-max-notification-before-wake:7 "
                             "-Xps-inline-cache-threshold:8 "
+                            "-Xps-sampling-interval-ms:9 "
                             "-Xps-profile-path:abc "
                             "-Xps-profile-boot-class-path",
                             M::ProfileSaverOpts);
@@ -61,6 +61,7 @@ CompilerOptions::CompilerOptions()
       compile_pic_(false),
       dump_timings_(false),
       dump_pass_timings_(false),
+      dump_pass_timings_json_file_name_(""),
       dump_stats_(false),
       profile_branches_(false),
       profile_compilation_info_(nullptr),
@@ -79,6 +80,7 @@ CompilerOptions::CompilerOptions()
       initialize_app_image_classes_(false),
       check_profiled_methods_(ProfileMethodsCheck::kNone),
       max_image_block_size_(std::numeric_limits<uint32_t>::max()),
+      compile_rss_limit_mb_(0u),
       passes_to_run_(nullptr) {
 }
 
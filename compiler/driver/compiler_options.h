@@ -338,6 +338,10 @@ class CompilerOptions final {
     return dump_pass_timings_;
   }
 
+  const std::string& GetDumpPassTimingsJsonFileName() const {
+    return dump_pass_timings_json_file_name_;
+  }
+
   bool GetDumpStats() const {
     return dump_stats_;
   }
@@ -362,6 +366,11 @@ class CompilerOptions final {
     max_image_block_size_ = size;
   }
 
+  // Resident set size in MiB above which parallel compilation is throttled, 0 for no limit.
+  uint32_t GetCompileRssLimitMb() const {
+    return compile_rss_limit_mb_;
+  }
+
   bool InitializeAppImageClasses() const {
     return initialize_app_image_classes_;
   }
@@ -419,6 +428,7 @@ class CompilerOptions final {
   bool compile_pic_;
   bool dump_timings_;
   bool dump_pass_timings_;
+  std::string dump_pass_timings_json_file_name_;
   bool dump_stats_;
   bool profile_branches_;
 
@@ -472,6 +482,9 @@ class CompilerOptions final {
   // Maximum solid block size in the generated image.
   uint32_t max_image_block_size_;
 
+  // Resident set size limit for throttling parallel compilation, see `GetCompileRssLimitMb()`.
+  uint32_t compile_rss_limit_mb_;
+
   // If not null, specifies optimization passes which will be run instead of defaults.
   // Note that passes_to_run_ is not checked for correctness and providing an incorrect
   // list of passes can lead to unexpected compiler behaviour. This is caused by dependencies
@@ -92,6 +92,7 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
     options->check_profiled_methods_ = *map.Get(Base::CheckProfiledMethods);
   }
   map.AssignIfExists(Base::MaxImageBlockSize, &options->max_image_block_size_);
+  map.AssignIfExists(Base::CompileRssLimitMb, &options->compile_rss_limit_mb_);
 
   if (map.Exists(Base::DumpTimings)) {
     options->dump_timings_ = true;
@@ -100,6 +101,7 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
   if (map.Exists(Base::DumpPassTimings)) {
     options->dump_pass_timings_ = true;
   }
+  map.AssignIfExists(Base::DumpPassTimingsJson, &options->dump_pass_timings_json_file_name_);
 
   if (map.Exists(Base::DumpStats)) {
     options->dump_stats_ = true;
@@ -175,10 +177,17 @@ NO_INLINE void AddCompilerOptionsArgumentParserOptions(Builder& b) {
           .IntoKey(Map::DumpTimings)
 
       .Define({"--dump-pass-timings"})
-          .WithHelp("Display a breakdown time spent in optimization passes for each compiled"
-                    " method.")
+          .WithHelp("Display a breakdown of time and arena memory spent in optimization passes"
+                    " for each compiled method.")
           .IntoKey(Map::DumpPassTimings)
 
+      .Define("--dump-pass-timings-json=_")
+          .template WithType<std::string>()
+          .WithHelp("Write one JSON object per compiled method to the specified file, with the\n"
+                    "time spent in each optimization pass and in code generation, the arena\n"
+                    "memory used and the generated code size. See tools/pass_timings_report.py.")
+          .IntoKey(Map::DumpPassTimingsJson)
+
       .Define({"--dump-stats"})
           .WithHelp("Display overall compilation statistics.")
           .IntoKey(Map::DumpStats)
@@ -238,6 +247,13 @@ NO_INLINE void AddCompilerOptionsArgumentParserOptions(Builder& b) {
           .template WithType<unsigned int>()
           .WithHelp("Maximum solid block size for compressed images.")
           .IntoKey(Map::MaxImageBlockSize)
+
+      .Define("--compile-rss-limit-mb=_")
+          .template WithType<unsigned int>()
+          .WithHelp("Resident set size in MiB above which compilation worker threads stop\n"
+                    "picking up new work, leaving the remaining work to fewer threads.\n"
+                    "The default 0 means no limit.")
+          .IntoKey(Map::CompileRssLimitMb)
       // Obsolete flags
       .Ignore({
         "--num-dex-methods=_",
@@ -85,6 +85,7 @@ void JitCompiler::ParseCompilerOptions() {
     DCHECK_EQ(instruction_set, kRuntimeISA);
   }
   std::unique_ptr<const InstructionSetFeatures> instruction_set_features;
+  bool warmup_log = false;
   for (const std::string& option : runtime->GetCompilerOptions()) {
     VLOG(compiler) << "JIT compiler option " << option;
     std::string error_msg;
@@ -111,6 +112,8 @@ void JitCompiler::ParseCompilerOptions() {
       if (instruction_set_features == nullptr) {
         LOG(WARNING) << "Error parsing " << option << " message=" << error_msg;
       }
+    } else if (option == "--jit-warmup-log") {
+      warmup_log = true;
     }
   }
 
@@ -121,9 +124,19 @@ void JitCompiler::ParseCompilerOptions() {
   }
   compiler_options_->instruction_set_features_ = std::move(instruction_set_features);
 
-  if (compiler_options_->GetGenerateDebugInfo()) {
+  if (jit_logger_ != nullptr) {
+    // Re-parsing after a fork; the new logs are named after the new pid.
+    jit_logger_->CloseLog();
+    jit_logger_.reset();
+  }
+  if (compiler_options_->GetGenerateDebugInfo() || warmup_log) {
     jit_logger_.reset(new JitLogger());
-    jit_logger_->OpenLog();
+    if (compiler_options_->GetGenerateDebugInfo()) {
+      jit_logger_->OpenLog();
+    }
+    if (warmup_log) {
+      jit_logger_->OpenWarmupLog();
+    }
   }
 }
 
@@ -168,7 +181,7 @@ JitCompiler::JitCompiler() {
 }
 
 JitCompiler::~JitCompiler() {
-  if (compiler_options_->GetGenerateDebugInfo()) {
+  if (jit_logger_ != nullptr) {
     jit_logger_->CloseLog();
   }
 }
@@ -199,10 +212,23 @@ bool JitCompiler::CompileMethod(
                                           : "Compiling baseline",
                                   &logger);
     JitCodeCache* const code_cache = jit->GetCodeCache();
+    // The perf logs are only written when generating debug info; the logger may also exist
+    // just for the warmup log.
+    JitLogger* perf_logger =
+        compiler_options_->GetGenerateDebugInfo() ? jit_logger_.get() : nullptr;
+    uint64_t start_ns = NanoTime();
+    uint64_t start_cpu_ns = ThreadCpuNanoTime();
     metrics::AutoTimer timer{runtime->GetMetrics()->JitMethodCompileTotalTime()};
     success = compiler_->JitCompile(
-        self, code_cache, region, method, compilation_kind, jit_logger_.get());
+        self, code_cache, region, method, compilation_kind, perf_logger);
     uint64_t duration_us = timer.Stop();
+    if (jit_logger_ != nullptr) {
+      jit_logger_->WriteWarmupLog(method,
+                                  compilation_kind,
+                                  success,
+                                  NanoTime() - start_ns,
+                                  ThreadCpuNanoTime() - start_cpu_ns);
+    }
     VLOG(jit) << "Compilation of " << method->PrettyMethod() << " took "
               << PrettyDuration(UsToNs(duration_us));
     runtime->GetMetrics()->JitMethodCompileCount()->AddOne();
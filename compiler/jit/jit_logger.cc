@@ -23,10 +23,18 @@
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
 #include "oat/oat_file-inl.h"
+#include "thread-current-inl.h"
 
 namespace art HIDDEN {
 namespace jit {
 
+void JitLogger::WriteLog(const void* ptr, size_t code_size, ArtMethod* method) {
+  // JIT workers may finish compilations at the same time.
+  MutexLock mu(Thread::Current(), lock_);
+  WritePerfMapLog(ptr, code_size, method);
+  WriteJitDumpLog(ptr, code_size, method);
+}
+
 #ifdef ART_TARGET_ANDROID
 static const char* kLogPrefix = "/data/misc/trace";
 #else
@@ -304,5 +312,57 @@ void JitLogger::CloseJitDumpLog() {
   }
 }
 
+// File format of jit-warmup-PID.csv:
+// +-------------------------------------------------+
+// |time_ns,kind,success,wall_ns,thread_cpu_ns,method|
+// |TIME,KIND,SUCCESS,WALL,CPU,"symbolname1"         |
+// |...                                              |
+// +-------------------------------------------------+
+// `time_ns` is the CLOCK_MONOTONIC time at the end of the compilation, the same clock as
+// `System.nanoTime()`, so that entries can be lined up with timestamps taken by the workload.
+void JitLogger::OpenWarmupLog() {
+  std::string pid_str = std::to_string(getpid());
+  std::string warmup_filename = std::string(kLogPrefix) + "/jit-warmup-" + pid_str + ".csv";
+  warmup_file_.reset(OS::CreateEmptyFileWriteOnly(warmup_filename.c_str()));
+  if (warmup_file_ == nullptr) {
+    LOG(ERROR) << "Could not create JIT warmup log at " << warmup_filename;
+    return;
+  }
+  static constexpr const char kHeader[] = "time_ns,kind,success,wall_ns,thread_cpu_ns,method\n";
+  if (!warmup_file_->WriteFully(kHeader, sizeof(kHeader) - 1u)) {
+    LOG(WARNING) << "Failed to write JIT warmup log header: write failure.";
+  }
+}
+
+void JitLogger::WriteWarmupLog(ArtMethod* method,
+                               CompilationKind compilation_kind,
+                               bool success,
+                               uint64_t wall_time_ns,
+                               uint64_t thread_cpu_time_ns) {
+  if (warmup_file_ == nullptr) {
+    return;
+  }
+  std::ostringstream stream;
+  stream << art::NanoTime()
+         << "," << compilation_kind
+         << "," << (success ? 1 : 0)
+         << "," << wall_time_ns
+         << "," << thread_cpu_time_ns
+         << ",\"" << method->PrettyMethod() << "\"\n";
+  std::string str = stream.str();
+  // JIT workers may finish compilations at the same time.
+  MutexLock mu(Thread::Current(), lock_);
+  if (!warmup_file_->WriteFully(str.c_str(), str.size())) {
+    LOG(WARNING) << "Failed to write JIT warmup log: write failure.";
+  }
+}
+
+void JitLogger::CloseWarmupLog() {
+  if (warmup_file_ != nullptr) {
+    UNUSED(warmup_file_->Flush());
+    UNUSED(warmup_file_->Close());
+  }
+}
+
 }  // namespace jit
 }  // namespace art
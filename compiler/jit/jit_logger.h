@@ -22,6 +22,7 @@
 #include "base/macros.h"
 #include "base/mutex.h"
 #include "base/os.h"
+#include "compilation_kind.h"
 
 namespace art HIDDEN {
 
@@ -86,9 +87,21 @@ namespace jit {
 //       - Make sure above small ELF files are available for 'perf annotate' tool to access,
 //         so that jitted code can be displayed in assembly view.
 //
+// JitLogger can also write a warmup log, independently of the perf logs above:
+//     The jit-warmup-PID.csv file records one line per JIT compilation with the CLOCK_MONOTONIC
+//     time at which it finished, the compilation kind, whether it succeeded, and its wall and
+//     thread CPU time. This is what benchmark/jit-warmup uses to plot how quickly methods reach
+//     baseline and optimized code and how much CPU the JIT spends getting there.
+//
+//     Command line Example:
+//       $ dalvikvm -Xcompiler-option --jit-warmup-log -cp <classpath> Test
+//
 class JitLogger {
  public:
-    JitLogger() : code_index_(0), marker_address_(nullptr) {}
+    JitLogger()
+        : lock_("jit logger lock", kGenericBottomLock),
+          code_index_(0),
+          marker_address_(nullptr) {}
 
     void OpenLog() {
       OpenPerfMapLog();
@@ -96,14 +109,21 @@ class JitLogger {
     }
 
     void WriteLog(const void* ptr, size_t code_size, ArtMethod* method)
-        REQUIRES_SHARED(Locks::mutator_lock_) {
-      WritePerfMapLog(ptr, code_size, method);
-      WriteJitDumpLog(ptr, code_size, method);
-    }
+        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!lock_);
+
+    void OpenWarmupLog();
+
+    void WriteWarmupLog(ArtMethod* method,
+                        CompilationKind compilation_kind,
+                        bool success,
+                        uint64_t wall_time_ns,
+                        uint64_t thread_cpu_time_ns)
+        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!lock_);
 
     void CloseLog() {
       ClosePerfMapLog();
       CloseJitDumpLog();
+      CloseWarmupLog();
     }
 
  private:
@@ -124,8 +144,12 @@ class JitLogger {
     void WriteJitDumpHeader();
     void WriteJitDumpDebugInfo();
 
+    void CloseWarmupLog();
+
+    Mutex lock_ BOTTOM_MUTEX_ACQUIRED_AFTER;
     std::unique_ptr<File> perf_file_;
     std::unique_ptr<File> jit_dump_file_;
+    std::unique_ptr<File> warmup_file_;
     uint64_t code_index_;
     void* marker_address_;
 
@@ -925,10 +925,11 @@ class BCEVisitor final : public HGraphVisitor {
       if (DynamicBCESeemsProfitable(loop, bounds_check->GetBlock()) &&
           induction_range_.CanGenerateRange(
               bounds_check->GetBlock(), index, &needs_finite_test, &needs_taken_test) &&
-          CanHandleInfiniteLoop(loop, index, needs_finite_test) &&
+          CanHandleInfiniteLoop(loop, bounds_check, needs_finite_test) &&
           // Do this test last, since it may generate code.
           CanHandleLength(loop, array_length, needs_taken_test)) {
         TransformLoopForDeoptimizationIfNeeded(loop, needs_taken_test);
+        TransformLoopForFiniteTestIfNeeded(loop, bounds_check, needs_finite_test);
         TransformLoopForDynamicBCE(loop, bounds_check);
         return;
       }
@@ -1604,7 +1605,8 @@ class BCEVisitor final : public HGraphVisitor {
           int32_t other_c = ValueBound::AsValueBound(other_index).GetConstant();
           // Generate code for either the maximum or minimum. Range analysis already was queried
           // whether code generation on the original and, thus, related bounds check was possible.
-          // It handles either loop invariants (lower is not set) or unit strides.
+          // It handles either loop invariants (lower is not set), unit strides or the stride
+          // of a finite loop control.
           if (other_c == max_c) {
             induction_range_.GenerateRange(other_bounds_check->GetBlock(),
                                            other_index,
@@ -1629,7 +1631,8 @@ class BCEVisitor final : public HGraphVisitor {
       // (2) two symbolic invariants
       //       if (min_upper >  max_upper) deoptimize;   unless min_c == max_c
       //       if (max_upper >= a.length ) deoptimize;
-      // (3) general case, unit strides (where lower would exceed upper for arithmetic wrap-around)
+      // (3) general case, unit strides or the stride of a finite loop control
+      //     (where lower would exceed upper for arithmetic wrap-around)
       //       if (min_lower >  max_lower) deoptimize;   unless min_c == max_c
       //       if (max_lower >  max_upper) deoptimize;
       //       if (max_upper >= a.length ) deoptimize;
@@ -1650,7 +1653,7 @@ class BCEVisitor final : public HGraphVisitor {
                  max_lower == nullptr && max_upper != nullptr);
         }
       } else {
-        // General case, unit strides.
+        // General case, unit strides or the stride of a finite loop control.
         if (min_c != max_c) {
           DCHECK(min_lower != nullptr && min_upper != nullptr &&
                  max_lower != nullptr && max_upper != nullptr);
@@ -1773,15 +1776,22 @@ class BCEVisitor final : public HGraphVisitor {
    * the range analysis evaluation code by "overshooting" the computed range.
    * Since deoptimization would be a bad choice, and there is no other version
    * of the loop to use, dynamic bce in such cases is only allowed if other tests
-   * ensure the loop is finite.
+   * ensure the loop is finite. For a loop with a non-unit stride (e.g. i += 4),
+   * this is an explicit finite-test, see TransformLoopForFiniteTestIfNeeded().
    */
-  bool CanHandleInfiniteLoop(HLoopInformation* loop, HInstruction* index, bool needs_infinite_test) {
+  bool CanHandleInfiniteLoop(HLoopInformation* loop,
+                             HBoundsCheck* bounds_check,
+                             bool needs_infinite_test) {
     if (needs_infinite_test) {
       // If we already forced the loop to be finite, allow directly.
       const uint32_t loop_id = loop->GetHeader()->GetBlockId();
       if (finite_loop_.find(loop_id) != finite_loop_.end()) {
         return true;
       }
+      HInstruction* index = bounds_check->InputAt(0);
+      if (induction_range_.CanGenerateFiniteTest(bounds_check->GetBlock(), index)) {
+        return true;
+      }
       // Otherwise, allow dynamic bce if the index (which is necessarily an induction at
       // this point) is the direct loop index (viz. a[i]), since then the runtime tests
       // ensure upper bound cannot cause an infinite loop.
@@ -1931,6 +1941,32 @@ class BCEVisitor final : public HGraphVisitor {
     taken_test_loop_.Put(loop_id, true_block);
   }
 
+  /**
+   * Adds a deoptimization test to a loop with a non-unit stride that may be infinite if
+   * needed and not already done. For example, this loop:
+   *
+   *   for (int i = 0; i < upper; i += 4) {
+   *     array[i] = 0;
+   *   }
+   *
+   * is finite unless i wraps around, so the range of i is only valid after:
+   *
+   *   if (upper > MAX_INT - 3) deoptimize;
+   */
+  void TransformLoopForFiniteTestIfNeeded(HLoopInformation* loop,
+                                          HBoundsCheck* bounds_check,
+                                          bool needs_finite_test) {
+    const uint32_t loop_id = loop->GetHeader()->GetBlockId();
+    if (!needs_finite_test || finite_loop_.find(loop_id) != finite_loop_.end()) {
+      return;
+    }
+    HBasicBlock* block = GetPreHeader(loop, bounds_check);
+    HInstruction* condition = induction_range_.GenerateFiniteTest(
+        bounds_check->GetBlock(), bounds_check->InputAt(0), GetGraph(), block);
+    InsertDeoptInLoop(loop, block, condition);
+    finite_loop_.insert(loop_id);
+  }
+
   /**
    * Inserts phi nodes that preserve SSA structure in generated top test structures.
    * All uses of instructions in the deoptimization block that reach the loop need
@@ -325,7 +325,14 @@ void CodeGenerator::Compile() {
     disasm_info_->SetFrameEntryInterval(frame_start, GetAssembler()->CodeSize());
   }
 
+  // The cold tail of the linear order is emitted right before the slow paths.
+  size_t cold_start = (block_order_ == &graph_->GetLinearOrder())
+      ? graph_->GetLinearOrderColdStart()
+      : block_order_->size();
   for (size_t e = block_order_->size(); current_block_index_ < e; ++current_block_index_) {
+    if (current_block_index_ == cold_start) {
+      cold_code_offset_ = GetAssembler()->CodeSize();
+    }
     HBasicBlock* block = (*block_order_)[current_block_index_];
     // Don't generate code for an empty block. Its predecessors will branch to its successor
     // directly. Also, the label of that block will not be emitted, so this helps catch
@@ -356,7 +363,13 @@ void CodeGenerator::Compile() {
     }
   }
 
+  if (cold_start == block_order_->size()) {
+    cold_code_offset_ = GetAssembler()->CodeSize();
+  }
   GenerateSlowPaths();
+  MaybeRecordStat(stats_,
+                  MethodCompilationStat::kColdCodeBytes,
+                  GetAssembler()->CodeSize() - cold_code_offset_);
 
   // Emit catch stack maps at the end of the stack map stream as expected by the
   // runtime exception handler.
@@ -1001,6 +1014,7 @@ CodeGenerator::CodeGenerator(HGraph* graph,
       compiler_options_(compiler_options),
       current_slow_path_(nullptr),
       current_block_index_(0),
+      cold_code_offset_(0),
       is_leaf_(true),
       needs_suspend_check_entry_(false),
       requires_current_method_(false),
@@ -1020,7 +1034,7 @@ CodeGenerator::CodeGenerator(HGraph* graph,
       }
     }
   }
-  if (GetGraph()->IsCompilingBaseline()) {
+  if (GetGraph()->IsCompilingBaseline() || GetGraph()->IsCompilingMidTier()) {
     // We need the current method in case we reach the hotness threshold. As a
     // side effect this makes the frame non-empty.
     SetRequiresCurrentMethod();
@@ -379,6 +379,7 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
   void RecordCatchBlockInfo();
 
   const CompilerOptions& GetCompilerOptions() const { return compiler_options_; }
+  OptimizingCompilerStats* GetCompilerStats() const { return stats_; }
   bool EmitReadBarrier() const;
   bool EmitBakerReadBarrier() const;
   bool EmitNonBakerReadBarrier() const;
@@ -897,6 +898,10 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
   // we are generating code for.
   size_t current_block_index_;
 
+  // The offset of the cold code, i.e. the blocks which can only lead to a throw
+  // and the slow paths, which are emitted contiguously at the end of the method.
+  size_t cold_code_offset_;
+
   // Whether the method is a leaf method.
   bool is_leaf_;
 
@@ -365,6 +365,43 @@ class LoadStringSlowPathARM64 : public SlowPathCodeARM64 {
   DISALLOW_COPY_AND_ASSIGN(LoadStringSlowPathARM64);
 };
 
+class MonitorOperationSlowPathARM64 : public SlowPathCodeARM64 {
+ public:
+  explicit MonitorOperationSlowPathARM64(HMonitorOperation* instruction)
+      : SlowPathCodeARM64(instruction) {}
+
+  void EmitNativeCode(CodeGenerator* codegen) override {
+    LocationSummary* locations = instruction_->GetLocations();
+    CodeGeneratorARM64* arm64_codegen = down_cast<CodeGeneratorARM64*>(codegen);
+    bool is_enter = instruction_->AsMonitorOperation()->IsEnter();
+
+    __ Bind(GetEntryLabel());
+    SaveLiveRegisters(codegen, locations);
+
+    InvokeRuntimeCallingConvention calling_convention;
+    arm64_codegen->MoveLocation(LocationFrom(calling_convention.GetRegisterAt(0)),
+                                locations->InAt(0),
+                                DataType::Type::kReference);
+    arm64_codegen->InvokeRuntime(is_enter ? kQuickLockObject : kQuickUnlockObject,
+                                 instruction_,
+                                 instruction_->GetDexPc(),
+                                 this);
+    if (is_enter) {
+      CheckEntrypointTypes<kQuickLockObject, void, mirror::Object*>();
+    } else {
+      CheckEntrypointTypes<kQuickUnlockObject, void, mirror::Object*>();
+    }
+
+    RestoreLiveRegisters(codegen, locations);
+    __ B(GetExitLabel());
+  }
+
+  const char* GetDescription() const override { return "MonitorOperationSlowPathARM64"; }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(MonitorOperationSlowPathARM64);
+};
+
 class NullCheckSlowPathARM64 : public SlowPathCodeARM64 {
  public:
   explicit NullCheckSlowPathARM64(HNullCheck* instr) : SlowPathCodeARM64(instr) {}
@@ -1308,9 +1345,7 @@ void CodeGeneratorARM64::MaybeIncrementHotness(HSuspendCheck* suspend_check, boo
     __ Bind(&done);
   }
 
-  if (GetGraph()->IsCompilingBaseline() &&
-      GetGraph()->IsUsefulOptimizing() &&
-      !Runtime::Current()->IsAotCompiler()) {
+  if (GetGraph()->CountsBaselineHotness() && !Runtime::Current()->IsAotCompiler()) {
     ProfilingInfo* info = GetGraph()->GetProfilingInfo();
     DCHECK(info != nullptr);
     DCHECK(!HasEmptyFrame());
@@ -4720,11 +4755,17 @@ void CodeGeneratorARM64::MaybeGenerateInlineCacheCheck(HInstruction* instruction
     if (cache != nullptr) {
       uint64_t address = reinterpret_cast64<uint64_t>(cache);
       vixl::aarch64::Label done;
+      vixl::aarch64::Label update;
       __ Mov(x8, address);
       __ Ldr(w9, MemOperand(x8, InlineCache::ClassesOffset().Int32Value()));
-      // Fast path for a monomorphic cache.
+      // Fast path for a monomorphic cache, which only counts the call.
       __ Cmp(klass.W(), w9);
-      __ B(eq, &done);
+      __ B(ne, &update);
+      __ Ldr(w9, MemOperand(x8, InlineCache::CountsOffset().Int32Value()));
+      __ Add(w9, w9, 1);
+      __ Str(w9, MemOperand(x8, InlineCache::CountsOffset().Int32Value()));
+      __ B(&done);
+      __ Bind(&update);
       InvokeRuntime(kQuickUpdateInlineCache, instruction, instruction->GetDexPc());
       __ Bind(&done);
     } else {
@@ -5875,21 +5916,93 @@ void InstructionCodeGeneratorARM64::VisitLongConstant([[maybe_unused]] HLongCons
 }
 
 void LocationsBuilderARM64::VisitMonitorOperation(HMonitorOperation* instruction) {
+  // Thin locks owned by this thread, or not owned at all, are handled inline, like
+  // LOCK_OBJECT_FAST_PATH and UNLOCK_OBJECT_FAST_PATH do. Everything else goes to the runtime.
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(
-      instruction, LocationSummary::kCallOnMainOnly);
-  InvokeRuntimeCallingConvention calling_convention;
-  locations->SetInAt(0, LocationFrom(calling_convention.GetRegisterAt(0)));
+      instruction, LocationSummary::kCallOnSlowPath);
+  locations->SetInAt(0, Location::RequiresRegister());
+  // Lock word address and lock word.
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
 }
 
 void InstructionCodeGeneratorARM64::VisitMonitorOperation(HMonitorOperation* instruction) {
-  codegen_->InvokeRuntime(instruction->IsEnter() ? kQuickLockObject : kQuickUnlockObject,
-                          instruction,
-                          instruction->GetDexPc());
+  LocationSummary* locations = instruction->GetLocations();
+  Register obj = XRegisterFrom(locations->InAt(0));
+  Register addr = XRegisterFrom(locations->GetTemp(0));
+  Register lock_word = WRegisterFrom(locations->GetTemp(1));
+  UseScratchRegisterScope temps(GetVIXLAssembler());
+  Register new_lock_word = temps.AcquireW();
+  Register status = temps.AcquireW();
+  const bool emit_read_barrier = codegen_->EmitReadBarrier();
+  const uint32_t kNonGcBits = LockWord::kGCStateMaskShiftedToggled;
+  const uint32_t kStateAndOwner =
+      LockWord::kStateMaskShifted | LockWord::kThinLockOwnerMaskShifted;
+
+  SlowPathCodeARM64* slow_path =
+      new (codegen_->GetScopedAllocator()) MonitorOperationSlowPathARM64(instruction);
+  codegen_->AddSlowPath(slow_path);
+  if (instruction->InputAt(0)->CanBeNull()) {
+    __ Cbz(obj, slow_path->GetEntryLabel());
+  }
+  __ Add(addr, obj, mirror::Object::MonitorOffset().Int32Value());
+
+  vixl::aarch64::Label retry;
+  vixl::aarch64::Label not_simple;
+  __ Bind(&retry);
+  __ Ldr(new_lock_word,
+         MemOperand(tr, Thread::ThinLockIdOffset<kArm64PointerSize>().Int32Value()));
   if (instruction->IsEnter()) {
-    CheckEntrypointTypes<kQuickLockObject, void, mirror::Object*>();
+    __ Ldaxr(lock_word, MemOperand(addr));
+    // Thread id with count 0 and the original gc bits, or the thread id comparison.
+    __ Eor(new_lock_word, lock_word, new_lock_word);
+    __ Tst(lock_word, kNonGcBits);
+    __ B(ne, &not_simple);
+    // Unlocked, take the thin lock.
+    __ Stxr(status, new_lock_word, MemOperand(addr));
+    __ Cbnz(status, &retry);
+    __ B(slow_path->GetExitLabel());
+    __ Bind(&not_simple);
+    // Thin locked by this thread, increment the recursion count unless it overflows.
+    __ Tst(new_lock_word, kStateAndOwner);
+    __ B(ne, slow_path->GetEntryLabel());
+    __ Add(new_lock_word, lock_word, LockWord::kThinLockCountOne);
+    __ Tst(new_lock_word, LockWord::kThinLockCountMaskShifted);
+    __ B(eq, slow_path->GetEntryLabel());
+    __ Stxr(status, new_lock_word, MemOperand(addr));
+    __ Cbnz(status, &retry);
   } else {
-    CheckEntrypointTypes<kQuickUnlockObject, void, mirror::Object*>();
+    // The GC may concurrently update the read barrier state, so stores must be exclusive then.
+    if (emit_read_barrier) {
+      __ Ldxr(lock_word, MemOperand(addr));
+    } else {
+      __ Ldr(lock_word, MemOperand(addr));
+    }
+    // The original gc bits if held once by this thread, or the thread id comparison.
+    __ Eor(new_lock_word, lock_word, new_lock_word);
+    __ Tst(new_lock_word, kNonGcBits);
+    __ B(ne, &not_simple);
+    // Held once, release the thin lock.
+    if (emit_read_barrier) {
+      __ Stlxr(status, new_lock_word, MemOperand(addr));
+      __ Cbnz(status, &retry);
+    } else {
+      __ Stlr(new_lock_word, MemOperand(addr));
+    }
+    __ B(slow_path->GetExitLabel());
+    __ Bind(&not_simple);
+    // Thin locked recursively by this thread, decrement the recursion count.
+    __ Tst(new_lock_word, kStateAndOwner);
+    __ B(ne, slow_path->GetEntryLabel());
+    __ Sub(new_lock_word, lock_word, LockWord::kThinLockCountOne);
+    if (emit_read_barrier) {
+      __ Stxr(status, new_lock_word, MemOperand(addr));
+      __ Cbnz(status, &retry);
+    } else {
+      __ Str(new_lock_word, MemOperand(addr));
+    }
   }
+  __ Bind(slow_path->GetExitLabel());
   codegen_->MaybeGenerateMarkingRegisterCheck(/* code= */ __LINE__);
 }
 
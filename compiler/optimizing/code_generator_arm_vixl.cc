@@ -2304,9 +2304,7 @@ void CodeGeneratorARMVIXL::MaybeIncrementHotness(HSuspendCheck* suspend_check,
     }
   }
 
-  if (GetGraph()->IsCompilingBaseline() &&
-      GetGraph()->IsUsefulOptimizing() &&
-      !Runtime::Current()->IsAotCompiler()) {
+  if (GetGraph()->CountsBaselineHotness() && !Runtime::Current()->IsAotCompiler()) {
     ProfilingInfo* info = GetGraph()->GetProfilingInfo();
     DCHECK(info != nullptr);
     DCHECK(!HasEmptyFrame());
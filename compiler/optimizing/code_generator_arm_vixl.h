@@ -129,6 +129,8 @@ using VIXLUInt32Literal = vixl::aarch32::Literal<uint32_t>;
   V(CRC32Update)                                                           \
   V(CRC32UpdateBytes)                                                      \
   V(CRC32UpdateByteBuffer)                                                 \
+  V(CRC32CUpdateBytes)                                                     \
+  V(CRC32CUpdateDirectByteBuffer)                                          \
   V(FP16ToFloat)                                                           \
   V(FP16ToHalf)                                                            \
   V(FP16Floor)                                                             \
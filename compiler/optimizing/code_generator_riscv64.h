@@ -91,6 +91,8 @@ static constexpr int32_t kFClassNaNMinValue = 0x100;
   V(CRC32Update)                                \
   V(CRC32UpdateBytes)                           \
   V(CRC32UpdateByteBuffer)                      \
+  V(CRC32CUpdateBytes)                          \
+  V(CRC32CUpdateDirectByteBuffer)               \
   V(MethodHandleInvokeExact)                    \
   V(MethodHandleInvoke)
 
@@ -253,6 +253,12 @@ void InstructionCodeGeneratorARM64Sve::VisitVecReduce(HVecReduce* instruction) {
         case HVecReduce::kSum:
           __ Saddv(dst.S(), p_reg, src.VnS());
           break;
+        case HVecReduce::kMin:
+          __ Sminv(dst.S(), p_reg, src.VnS());
+          break;
+        case HVecReduce::kMax:
+          __ Smaxv(dst.S(), p_reg, src.VnS());
+          break;
         default:
           LOG(FATAL) << "Unsupported SIMD instruction";
           UNREACHABLE();
@@ -263,6 +269,12 @@ void InstructionCodeGeneratorARM64Sve::VisitVecReduce(HVecReduce* instruction) {
         case HVecReduce::kSum:
           __ Uaddv(dst.D(), p_reg, src.VnD());
           break;
+        case HVecReduce::kMin:
+          __ Sminv(dst.D(), p_reg, src.VnD());
+          break;
+        case HVecReduce::kMax:
+          __ Smaxv(dst.D(), p_reg, src.VnD());
+          break;
         default:
           LOG(FATAL) << "Unsupported SIMD instruction";
           UNREACHABLE();
@@ -602,23 +614,53 @@ void InstructionCodeGeneratorARM64Sve::VisitVecDiv(HVecDiv* instruction) {
 }
 
 void LocationsBuilderARM64Sve::VisitVecMin(HVecMin* instruction) {
-  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
-  UNREACHABLE();
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecMin(HVecMin* instruction) {
-  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
-  UNREACHABLE();
+  DCHECK(instruction->IsPredicated());
+  LocationSummary* locations = instruction->GetLocations();
+  const ZRegister lhs = ZRegisterFrom(locations->InAt(0));
+  const ZRegister rhs = ZRegisterFrom(locations->InAt(1));
+  const ZRegister dst = ZRegisterFrom(locations->Out());
+  const PRegisterM p_reg = GetVecGoverningPReg(instruction).Merging();
+  ValidateVectorLength(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kInt32:
+      __ Smin(dst.VnS(), p_reg, lhs.VnS(), rhs.VnS());
+      break;
+    case DataType::Type::kInt64:
+      __ Smin(dst.VnD(), p_reg, lhs.VnD(), rhs.VnD());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
 }
 
 void LocationsBuilderARM64Sve::VisitVecMax(HVecMax* instruction) {
-  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
-  UNREACHABLE();
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
 }
 
 void InstructionCodeGeneratorARM64Sve::VisitVecMax(HVecMax* instruction) {
-  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
-  UNREACHABLE();
+  DCHECK(instruction->IsPredicated());
+  LocationSummary* locations = instruction->GetLocations();
+  const ZRegister lhs = ZRegisterFrom(locations->InAt(0));
+  const ZRegister rhs = ZRegisterFrom(locations->InAt(1));
+  const ZRegister dst = ZRegisterFrom(locations->Out());
+  const PRegisterM p_reg = GetVecGoverningPReg(instruction).Merging();
+  ValidateVectorLength(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kInt32:
+      __ Smax(dst.VnS(), p_reg, lhs.VnS(), rhs.VnS());
+      break;
+    case DataType::Type::kInt64:
+      __ Smax(dst.VnD(), p_reg, lhs.VnD(), rhs.VnD());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
 }
 
 void LocationsBuilderARM64Sve::VisitVecAnd(HVecAnd* instruction) {
@@ -78,6 +78,42 @@ static RegisterSet OneRegInReferenceOutSaveEverythingCallerSaves() {
 #define __ down_cast<X86_64Assembler*>(codegen->GetAssembler())->  // NOLINT
 #define QUICK_ENTRY_POINT(x) QUICK_ENTRYPOINT_OFFSET(kX86_64PointerSize, x).Int32Value()
 
+class MonitorOperationSlowPathX86_64 : public SlowPathCode {
+ public:
+  explicit MonitorOperationSlowPathX86_64(HMonitorOperation* instruction)
+      : SlowPathCode(instruction) {}
+
+  void EmitNativeCode(CodeGenerator* codegen) override {
+    LocationSummary* locations = instruction_->GetLocations();
+    CodeGeneratorX86_64* x86_64_codegen = down_cast<CodeGeneratorX86_64*>(codegen);
+    bool is_enter = instruction_->AsMonitorOperation()->IsEnter();
+
+    __ Bind(GetEntryLabel());
+    SaveLiveRegisters(codegen, locations);
+
+    InvokeRuntimeCallingConvention calling_convention;
+    x86_64_codegen->Move(Location::RegisterLocation(calling_convention.GetRegisterAt(0)),
+                         locations->InAt(0));
+    x86_64_codegen->InvokeRuntime(is_enter ? kQuickLockObject : kQuickUnlockObject,
+                                  instruction_,
+                                  instruction_->GetDexPc(),
+                                  this);
+    if (is_enter) {
+      CheckEntrypointTypes<kQuickLockObject, void, mirror::Object*>();
+    } else {
+      CheckEntrypointTypes<kQuickUnlockObject, void, mirror::Object*>();
+    }
+
+    RestoreLiveRegisters(codegen, locations);
+    __ jmp(GetExitLabel());
+  }
+
+  const char* GetDescription() const override { return "MonitorOperationSlowPathX86_64"; }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(MonitorOperationSlowPathX86_64);
+};
+
 class NullCheckSlowPathX86_64 : public SlowPathCode {
  public:
   explicit NullCheckSlowPathX86_64(HNullCheck* instruction) : SlowPathCode(instruction) {}
@@ -1799,9 +1835,7 @@ void CodeGeneratorX86_64::MaybeIncrementHotness(HSuspendCheck* suspend_check, bo
     __ Bind(&overflow);
   }
 
-  if (GetGraph()->IsCompilingBaseline() &&
-      GetGraph()->IsUsefulOptimizing() &&
-      !Runtime::Current()->IsAotCompiler()) {
+  if (GetGraph()->CountsBaselineHotness() && !Runtime::Current()->IsAotCompiler()) {
     ProfilingInfo* info = GetGraph()->GetProfilingInfo();
     DCHECK(info != nullptr);
     CHECK(!HasEmptyFrame());
@@ -3170,10 +3204,14 @@ void CodeGeneratorX86_64::MaybeGenerateInlineCacheCheck(HInstruction* instructio
     if (cache != nullptr) {
       uint64_t address = reinterpret_cast64<uint64_t>(cache);
       NearLabel done;
+      NearLabel update;
       __ movq(CpuRegister(TMP), Immediate(address));
-      // Fast path for a monomorphic cache.
+      // Fast path for a monomorphic cache, which only counts the call.
       __ cmpl(Address(CpuRegister(TMP), InlineCache::ClassesOffset().Int32Value()), klass);
-      __ j(kEqual, &done);
+      __ j(kNotEqual, &update);
+      __ addl(Address(CpuRegister(TMP), InlineCache::CountsOffset().Int32Value()), Immediate(1));
+      __ jmp(&done);
+      __ Bind(&update);
       GenerateInvokeRuntime(
           GetThreadOffset<kX86_64PointerSize>(kQuickUpdateInlineCache).Int32Value());
       __ Bind(&done);
@@ -7664,21 +7702,89 @@ void InstructionCodeGeneratorX86_64::VisitCheckCast(HCheckCast* instruction) {
 }
 
 void LocationsBuilderX86_64::VisitMonitorOperation(HMonitorOperation* instruction) {
+  // Thin locks owned by this thread, or not owned at all, are handled inline, like
+  // LOCK_OBJECT_FAST_PATH and UNLOCK_OBJECT_FAST_PATH do. Everything else goes to the runtime.
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(
-      instruction, LocationSummary::kCallOnMainOnly);
-  InvokeRuntimeCallingConvention calling_convention;
-  locations->SetInAt(0, Location::RegisterLocation(calling_convention.GetRegisterAt(0)));
+      instruction, LocationSummary::kCallOnSlowPath);
+  locations->SetInAt(0, Location::RequiresRegister());
+  // The original lock word, in RAX for cmpxchg, and the new lock word.
+  locations->AddTemp(Location::RegisterLocation(RAX));
+  locations->AddTemp(Location::RequiresRegister());
 }
 
 void InstructionCodeGeneratorX86_64::VisitMonitorOperation(HMonitorOperation* instruction) {
-  codegen_->InvokeRuntime(instruction->IsEnter() ? kQuickLockObject : kQuickUnlockObject,
-                          instruction,
-                          instruction->GetDexPc());
+  LocationSummary* locations = instruction->GetLocations();
+  CpuRegister obj = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister lock_word = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister new_lock_word = locations->GetTemp(1).AsRegister<CpuRegister>();
+  DCHECK_EQ(lock_word.AsRegister(), RAX);
+  Address lock_word_address(obj, mirror::Object::MonitorOffset().Int32Value());
+  const Immediate non_gc_bits(static_cast<int32_t>(LockWord::kGCStateMaskShiftedToggled));
+  const Immediate state_and_owner(
+      static_cast<int32_t>(LockWord::kStateMaskShifted | LockWord::kThinLockOwnerMaskShifted));
+
+  SlowPathCode* slow_path =
+      new (codegen_->GetScopedAllocator()) MonitorOperationSlowPathX86_64(instruction);
+  codegen_->AddSlowPath(slow_path);
+  if (instruction->InputAt(0)->CanBeNull()) {
+    __ testl(obj, obj);
+    __ j(kEqual, slow_path->GetEntryLabel());
+  }
+
+  NearLabel retry;
+  NearLabel not_simple;
+  __ Bind(&retry);
+  __ movl(lock_word, lock_word_address);
+  __ gs()->movl(new_lock_word,
+                Address::Absolute(Thread::ThinLockIdOffset<kX86_64PointerSize>().Int32Value(),
+                                  /* no_rip= */ true));
+  // Thread id with count 0 and the original gc bits if unlocked, the original gc bits if held
+  // once by this thread, or the thread id comparison otherwise.
+  __ xorl(new_lock_word, lock_word);
   if (instruction->IsEnter()) {
-    CheckEntrypointTypes<kQuickLockObject, void, mirror::Object*>();
+    __ testl(lock_word, non_gc_bits);
+    __ j(kNotZero, &not_simple);
+    // Unlocked, take the thin lock.
+    __ LockCmpxchgl(lock_word_address, new_lock_word);
+    __ j(kNotZero, &retry);
+    __ jmp(slow_path->GetExitLabel());
+    __ Bind(&not_simple);
+    // Thin locked by this thread, increment the recursion count unless it overflows.
+    __ testl(new_lock_word, state_and_owner);
+    __ j(kNotZero, slow_path->GetEntryLabel());
+    __ leal(new_lock_word, Address(lock_word, LockWord::kThinLockCountOne));
+    __ testl(new_lock_word, Immediate(LockWord::kThinLockCountMaskShifted));
+    __ j(kZero, slow_path->GetEntryLabel());
+    // The cmpxchg preserves concurrent updates of the gc bits.
+    __ LockCmpxchgl(lock_word_address, new_lock_word);
+    __ j(kNotZero, &retry);
   } else {
-    CheckEntrypointTypes<kQuickUnlockObject, void, mirror::Object*>();
+    const bool emit_read_barrier = codegen_->EmitReadBarrier();
+    __ testl(new_lock_word, non_gc_bits);
+    __ j(kNotZero, &not_simple);
+    // Held once, release the thin lock. The GC may concurrently update the read barrier
+    // state, so stores must be atomic then.
+    if (emit_read_barrier) {
+      __ LockCmpxchgl(lock_word_address, new_lock_word);
+      __ j(kNotZero, &retry);
+    } else {
+      __ movl(lock_word_address, new_lock_word);
+    }
+    __ jmp(slow_path->GetExitLabel());
+    __ Bind(&not_simple);
+    // Thin locked recursively by this thread, decrement the recursion count.
+    __ testl(new_lock_word, state_and_owner);
+    __ j(kNotZero, slow_path->GetEntryLabel());
+    __ leal(new_lock_word,
+            Address(lock_word, -static_cast<int32_t>(LockWord::kThinLockCountOne)));
+    if (emit_read_barrier) {
+      __ LockCmpxchgl(lock_word_address, new_lock_word);
+      __ j(kNotZero, &retry);
+    } else {
+      __ movl(lock_word_address, new_lock_word);
+    }
   }
+  __ Bind(slow_path->GetExitLabel());
 }
 
 void LocationsBuilderX86_64::VisitX86AndNot(HX86AndNot* instruction) {
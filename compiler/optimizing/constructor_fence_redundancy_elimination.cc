@@ -34,11 +34,27 @@ class CFREVisitor final : public HGraphVisitor {
         scoped_allocator_(graph->GetArenaStack()),
         candidate_fences_(scoped_allocator_.Adapter(kArenaAllocCFRE)),
         candidate_fence_targets_(std::nullopt),
+        visited_blocks_(&scoped_allocator_,
+                        graph->GetBlocks().size(),
+                        /*expandable=*/ false,
+                        kArenaAllocCFRE),
         stats_(stats) {}
 
   void VisitBasicBlock(HBasicBlock* block) override {
-    // Visit all non-Phi instructions in the block.
-    VisitNonPhiInstructions(block);
+    if (visited_blocks_.IsBitSet(block->GetBlockId())) {
+      // Already visited as the join of a diamond, see `FindJoinToCarryFencesTo()`.
+      return;
+    }
+    while (block != nullptr) {
+      visited_blocks_.SetBit(block->GetBlockId());
+
+      // Visit all non-Phi instructions in the block.
+      VisitNonPhiInstructions(block);
+
+      // Keep the unmerged fences across a diamond that does not publish their targets, so that
+      // they can be merged with the fences of the join block.
+      block = FindJoinToCarryFencesTo(block);
+    }
 
     // If there were any unmerged fences left, merge them together,
     // the objects are considered 'published' at the end of the block.
@@ -225,6 +241,83 @@ class CFREVisitor final : public HGraphVisitor {
     candidate_fence_targets_->ClearAllBits();
   }
 
+  // Returns the block joining the branches of an `If` ending `block`, if every path from
+  // `block` to it reaches it and none of them publishes the targets of the candidate fences.
+  // The candidate fences can then be merged into a later fence of the join, which is executed
+  // on all the paths.
+  //
+  //           block
+  //           /   \
+  //         arm   arm (or none)
+  //           \   /
+  //           join
+  HBasicBlock* FindJoinToCarryFencesTo(HBasicBlock* block) {
+    if (candidate_fences_.empty() || !block->GetLastInstruction()->IsIf()) {
+      return nullptr;
+    }
+    HBasicBlock* join = nullptr;
+    for (HBasicBlock* successor : block->GetSuccessors()) {
+      HBasicBlock* arm_join =
+          (successor->GetPredecessors().size() == 1u && successor->GetSuccessors().size() == 1u)
+              ? successor->GetSingleSuccessor()
+              : successor;
+      if (join == nullptr) {
+        join = arm_join;
+      } else if (join != arm_join) {
+        return nullptr;
+      }
+    }
+    DCHECK(join != nullptr);
+    if (join->GetPredecessors().size() != 2u ||
+        join->IsLoopHeader() ||
+        join->IsCatchBlock() ||
+        visited_blocks_.IsBitSet(join->GetBlockId())) {
+      return nullptr;
+    }
+    for (HBasicBlock* predecessor : join->GetPredecessors()) {
+      if (predecessor != block &&
+          (predecessor->GetPredecessors().size() != 1u ||
+           predecessor->GetSinglePredecessor() != block ||
+           !CanCarryFencesThrough(predecessor))) {
+        return nullptr;
+      }
+    }
+    // A Phi creates an alias, see `VisitAlias()`.
+    for (HInstructionIterator it(join->GetPhis()); !it.Done(); it.Advance()) {
+      if (HasInterestingPublishTargetAsInput(it.Current())) {
+        return nullptr;
+      }
+    }
+    return join;
+  }
+
+  // Whether the instructions of the diamond `arm` leave the candidate fences mergeable. This is
+  // more conservative than the visitor: any use of a target other than as the stored-to object
+  // is treated as a publish.
+  bool CanCarryFencesThrough(HBasicBlock* arm) {
+    if (!arm->GetLastInstruction()->IsGoto() || !arm->GetPhis().IsEmpty()) {
+      return false;
+    }
+    for (HInstructionIterator it(arm->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (instruction->IsConstructorFence() || instruction->IsDeoptimize()) {
+        return false;
+      }
+      bool publishes;
+      if (instruction->IsInstanceFieldSet() || instruction->IsStaticFieldSet()) {
+        publishes = IsInterestingPublishTarget(instruction->InputAt(1));
+      } else if (instruction->IsArraySet()) {
+        publishes = IsInterestingPublishTarget(instruction->InputAt(2));
+      } else {
+        publishes = HasInterestingPublishTargetAsInput(instruction);
+      }
+      if (publishes) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   // A publishing 'store' is only interesting if the value being stored
   // is one of the fence `targets` in `candidate_fences`.
   bool IsInterestingPublishTarget(HInstruction* store_input) const {
@@ -247,6 +340,10 @@ class CFREVisitor final : public HGraphVisitor {
   // a detected publish is a target of one of the candidate fences.
   std::optional<ArenaBitVector> candidate_fence_targets_;
 
+  // Blocks already visited, possibly out of reverse post order when the candidate fences are
+  // carried to the join of a diamond.
+  ArenaBitVector visited_blocks_;
+
   // Used to record stats about the optimization.
   OptimizingCompilerStats* const stats_;
 
@@ -257,8 +354,8 @@ bool ConstructorFenceRedundancyElimination::Run() {
   CFREVisitor cfre_visitor(graph_, stats_);
 
   // Arbitrarily visit in reverse-post order.
-  // The exact block visit order does not matter, as the algorithm
-  // only operates on a single block at a time.
+  // The exact block visit order does not matter, as the algorithm only operates
+  // on a single block at a time, or on a diamond from its entry block.
   cfre_visitor.VisitReversePostOrder();
   return true;
 }
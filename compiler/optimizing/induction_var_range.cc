@@ -258,7 +258,9 @@ bool InductionVarRange::CanGenerateRange(const HBasicBlock* context,
                                   needs_taken_test) &&
          (stride_value == -1 ||
           stride_value == 0 ||
-          stride_value == 1);  // avoid arithmetic wrap-around anomalies.
+          stride_value == 1 ||  // avoid arithmetic wrap-around anomalies.
+          ((!*needs_finite_test || CanGenerateFiniteTest(context, instruction)) &&
+           IsLoopControlStride(context, instruction)));
 }
 
 void InductionVarRange::GenerateRange(const HBasicBlock* context,
@@ -283,7 +285,8 @@ void InductionVarRange::GenerateRange(const HBasicBlock* context,
                                 &b2) ||
       (stride_value != -1 &&
        stride_value != 0 &&
-       stride_value != 1)) {
+       stride_value != 1 &&
+       !IsLoopControlStride(context, instruction))) {
     LOG(FATAL) << "Failed precondition: CanGenerateRange()";
   }
 }
@@ -315,6 +318,23 @@ HInstruction* InductionVarRange::GenerateTakenTest(HInstruction* loop_control,
   return taken_test;
 }
 
+bool InductionVarRange::CanGenerateFiniteTest(const HBasicBlock* context,
+                                              HInstruction* instruction) const {
+  return GenerateFiniteTestCode(
+      context, instruction, /*graph=*/ nullptr, /*block=*/ nullptr, /*result=*/ nullptr);
+}
+
+HInstruction* InductionVarRange::GenerateFiniteTest(const HBasicBlock* context,
+                                                    HInstruction* instruction,
+                                                    HGraph* graph,
+                                                    HBasicBlock* block) const {
+  HInstruction* finite_test = nullptr;
+  if (!GenerateFiniteTestCode(context, instruction, graph, block, &finite_test)) {
+    LOG(FATAL) << "Failed precondition: CanGenerateFiniteTest()";
+  }
+  return finite_test;
+}
+
 bool InductionVarRange::CanGenerateLastValue(HInstruction* instruction) {
   const HBasicBlock* context = instruction->GetBlock();
   bool is_last_value = true;
@@ -1673,6 +1693,73 @@ bool InductionVarRange::GenerateCode(const HBasicBlock* context,
   return false;
 }
 
+bool InductionVarRange::IsLoopControlStride(const HBasicBlock* context,
+                                            HInstruction* instruction) const {
+  const HLoopInformation* loop = nullptr;
+  HInductionVarAnalysis::InductionInfo* info = nullptr;
+  HInductionVarAnalysis::InductionInfo* trip = nullptr;
+  if (!HasInductionInfo(context, instruction, &loop, &info, &trip) ||
+      trip == nullptr ||
+      info->induction_class != HInductionVarAnalysis::kLinear ||
+      info->type != DataType::Type::kInt32 ||
+      trip->type != DataType::Type::kInt32) {
+    return false;
+  }
+  // The trip-count of for (i = L; i < U; i += S) is (U - 1 + S - L) / S, see
+  // HInductionVarAnalysis::VisitTripCount(), and the taken-test is L < U.
+  HInductionVarAnalysis::InductionInfo* trip_expr = trip->op_a;
+  HInductionVarAnalysis::InductionInfo* taken_expr = trip->op_b;
+  int64_t stride_value = 0;
+  int64_t lower_value = 0;
+  return IsConstant(context, loop, info->op_a, kExact, &stride_value) &&
+         stride_value > 1 &&
+         trip_expr->operation == HInductionVarAnalysis::kDiv &&
+         HInductionVarAnalysis::InductionEqual(trip_expr->op_b, info->op_a) &&
+         (taken_expr->operation == HInductionVarAnalysis::kLT ||
+          taken_expr->operation == HInductionVarAnalysis::kLE) &&
+         IsConstant(context, loop, taken_expr->op_a, kAtLeast, &lower_value) &&
+         lower_value >= 0;
+}
+
+bool InductionVarRange::GenerateFiniteTestCode(const HBasicBlock* context,
+                                               HInstruction* instruction,
+                                               HGraph* graph,
+                                               HBasicBlock* block,
+                                               /*out*/ HInstruction** result) const {
+  const HLoopInformation* loop = nullptr;
+  HInductionVarAnalysis::InductionInfo* info = nullptr;
+  HInductionVarAnalysis::InductionInfo* trip = nullptr;
+  if (!IsLoopControlStride(context, instruction) ||
+      !HasInductionInfo(context, instruction, &loop, &info, &trip)) {
+    return false;
+  }
+  // The loop is finite if the last increment of the loop control, from at most U - 1 for
+  // i < U and U for i <= U, does not exceed MAX_INT. This also bounds the trip-count
+  // numerator, since the loop control starts from a non-negative value.
+  HInductionVarAnalysis::InductionInfo* taken_expr = trip->op_b;
+  int64_t stride_value = 0;
+  bool is_constant = IsConstant(context, loop, info->op_a, kExact, &stride_value);
+  DCHECK(is_constant);
+  const int64_t max_upper = std::numeric_limits<int32_t>::max() - stride_value +
+      (taken_expr->operation == HInductionVarAnalysis::kLT ? 1 : 0);
+  HInstruction* upper = nullptr;
+  if (!GenerateCode(context,
+                    loop,
+                    taken_expr->op_b,
+                    /*trip=*/ nullptr,
+                    graph,
+                    block,
+                    /*is_min=*/ false,
+                    graph != nullptr ? &upper : nullptr)) {
+    return false;
+  }
+  if (graph != nullptr) {
+    *result = new (graph->GetAllocator()) HGreaterThan(
+        upper, graph->GetIntConstant(static_cast<int32_t>(max_upper)));
+  }
+  return true;
+}
+
 bool InductionVarRange::TryGenerateAddWithoutOverflow(const HBasicBlock* context,
                                                       const HLoopInformation* loop,
                                                       HInductionVarAnalysis::InductionInfo* info,
@@ -76,7 +76,8 @@ class InductionVarRange {
    * Returns true if range analysis is able to generate code for the lower and upper
    * bound expressions on the instruction in the given context. The need_finite_test
    * and need_taken test flags denote if an additional finite-test and/or taken-test
-   * are needed to protect the range evaluation inside its loop.
+   * are needed to protect the range evaluation inside its loop. For a non-unit stride,
+   * the finite-test must be the one generated by GenerateFiniteTest().
    */
   bool CanGenerateRange(const HBasicBlock* context,
                         HInstruction* instruction,
@@ -113,6 +114,25 @@ class InductionVarRange {
    */
   HInstruction* GenerateTakenTest(HInstruction* loop_control, HGraph* graph, HBasicBlock* block);
 
+  /**
+   * Returns true if the loop enveloping the instruction in the given context has a non-unit
+   * stride and code can be generated for its finite-test.
+   */
+  bool CanGenerateFiniteTest(const HBasicBlock* context, HInstruction* instruction) const;
+
+  /**
+   * Generates the finite-test of the loop enveloping the instruction in the given context,
+   * for example, for (int i = 0; i < U; i += 4) generates the test U > MAX_INT - 3 under
+   * which the induction wraps around. Code for the operands is generated in given block and
+   * graph. Returns the generated test, which is not inserted yet.
+   *
+   * Precondition: CanGenerateFiniteTest() returns true.
+   */
+  HInstruction* GenerateFiniteTest(const HBasicBlock* context,
+                                   HInstruction* instruction,
+                                   HGraph* graph,
+                                   HBasicBlock* block) const;
+
   /**
    * Returns true if induction analysis is able to generate code for last value of
    * the given instruction inside the closest enveloping loop.
@@ -387,6 +407,18 @@ class InductionVarRange {
                                      /*in*/ HInstruction* opa,
                                      /*out*/ HInstruction** result) const;
 
+  // Returns true if `info` is a linear induction with a stride other than -1, 0 or 1 whose range
+  // can be generated: the stride is the one of the loop control, which counts up from a
+  // non-negative value. With the finite-test, neither the trip-count nor the induction then
+  // wrap around.
+  bool IsLoopControlStride(const HBasicBlock* context, HInstruction* instruction) const;
+
+  bool GenerateFiniteTestCode(const HBasicBlock* context,
+                              HInstruction* instruction,
+                              HGraph* graph,
+                              HBasicBlock* block,
+                              /*out*/ HInstruction** result) const;
+
   // Try to guard the taken test with an HSelect instruction. Returns true if it can generate the
   // code, or false otherwise. The caller is responsible of updating `needs_taken_test`.
   bool TryGenerateTakenTest(const HBasicBlock* context,
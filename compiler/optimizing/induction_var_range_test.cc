@@ -1169,6 +1169,46 @@ TEST_F(InductionVarRangeTest, SymbolicTripCountUp) {
   EXPECT_TRUE(tce->InputAt(2)->IsLessThan());
 }
 
+TEST_F(InductionVarRangeTest, SymbolicTripCountUpNonUnitStride) {
+  BuildLoop(0, x_, 4);
+  PerformInductionVarAnalysis();
+
+  bool needs_finite_test = false;
+  bool needs_taken_test = false;
+
+  HInstruction* phi = condition_->InputAt(0);
+
+  // Can generate code in context of loop-body, protected by a finite-test.
+  ASSERT_TRUE(
+      range_.CanGenerateRange(increment_->GetBlock(), phi, &needs_finite_test, &needs_taken_test));
+  EXPECT_TRUE(needs_finite_test);
+  EXPECT_TRUE(needs_taken_test);
+  ASSERT_TRUE(range_.CanGenerateFiniteTest(increment_->GetBlock(), phi));
+
+  // Verify finite-test is V>MAX_INT-3.
+  HInstruction* finite =
+      range_.GenerateFiniteTest(increment_->GetBlock(), phi, graph_, loop_preheader_);
+  ASSERT_TRUE(finite != nullptr);
+  ASSERT_TRUE(finite->IsGreaterThan());
+  EXPECT_TRUE(finite->InputAt(0)->IsParameterValue());
+  ExpectInt(std::numeric_limits<int32_t>::max() - 3, finite->InputAt(1));
+}
+
+TEST_F(InductionVarRangeTest, SymbolicTripCountUpNonUnitStrideNegativeStart) {
+  BuildLoop(-1, x_, 4);
+  PerformInductionVarAnalysis();
+
+  bool needs_finite_test = false;
+  bool needs_taken_test = false;
+
+  HInstruction* phi = condition_->InputAt(0);
+
+  // The trip-count may wrap around.
+  EXPECT_FALSE(
+      range_.CanGenerateRange(increment_->GetBlock(), phi, &needs_finite_test, &needs_taken_test));
+  EXPECT_FALSE(range_.CanGenerateFiniteTest(increment_->GetBlock(), phi));
+}
+
 TEST_F(InductionVarRangeTest, SymbolicTripCountDown) {
   BuildLoop(1000, x_, -1);
   PerformInductionVarAnalysis();
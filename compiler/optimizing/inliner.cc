@@ -16,6 +16,8 @@
 
 #include "inliner.h"
 
+#include <algorithm>
+
 #include "art_method-inl.h"
 #include "base/logging.h"
 #include "base/pointer_size.h"
@@ -73,6 +75,13 @@ static constexpr size_t kMaximumNumberOfPolymorphicRecursiveCalls = 0;
 // Controls the use of inline caches in AOT mode.
 static constexpr bool kUseAOTInlineCaches = true;
 
+// Minimum share of the hits of a megamorphic inline cache, in percent, for a receiver to be
+// considered dominant and inlined behind a type guard.
+static constexpr uint32_t kMinDominantReceiverPercent = 30;
+
+// Maximum number of dominant receivers inlined at a megamorphic call.
+static constexpr size_t kMaximumNumberOfDominantReceivers = 2;
+
 // Controls the use of inlining try catches.
 static constexpr bool kInlineTryCatches = true;
 
@@ -134,6 +143,17 @@ void HInliner::UpdateInliningBudget() {
   }
 }
 
+// Returns the number of loops enclosing `block`.
+static size_t GetLoopDepth(const HBasicBlock* block) {
+  size_t depth = 0u;
+  for (HLoopInformation* info = block->GetLoopInformation();
+       info != nullptr;
+       info = info->GetPreHeader()->GetLoopInformation()) {
+    ++depth;
+  }
+  return depth;
+}
+
 bool HInliner::Run() {
   if (codegen_->GetCompilerOptions().GetInlineMaxCodeUnits() == 0) {
     // Inlining effectively disabled.
@@ -169,40 +189,55 @@ bool HInliner::Run() {
       Runtime::Current()->IsAotCompiler() &&
       !graph_->IsCompilingBaseline();
 
-  // Keep a copy of all blocks when starting the visit.
-  ArenaVector<HBasicBlock*> blocks = graph_->GetReversePostOrder();
-  DCHECK(!blocks.empty());
-  // Because we are changing the graph when inlining,
-  // we just iterate over the blocks of the outer method.
-  // This avoids doing the inlining work again on the inlined blocks.
-  for (HBasicBlock* block : blocks) {
-    for (HInstruction* instruction = block->GetFirstInstruction(); instruction != nullptr;) {
-      HInstruction* next = instruction->GetNext();
-      HInvoke* call = instruction->AsInvokeOrNull();
+  // Because we are changing the graph when inlining, we collect the calls of the outer
+  // method before inlining anything. This avoids doing the inlining work again on the
+  // inlined blocks.
+  ArenaAllocator* allocator = graph_->GetAllocator();
+  ArenaVector<std::pair<HInvoke*, size_t>> calls(allocator->Adapter(kArenaAllocOptimization));
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    size_t loop_depth = GetLoopDepth(block);
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInvoke* call = it.Current()->AsInvokeOrNull();
       // As long as the call is not intrinsified, it is worth trying to inline.
       if (call != nullptr && !codegen_->IsImplementedIntrinsic(call)) {
-        if (honor_noinline_directives) {
-          // Debugging case: directives in method names control or assert on inlining.
-          std::string callee_name =
-              call->GetMethodReference().PrettyMethod(/* with_signature= */ false);
-          // Tests prevent inlining by having $noinline$ in their method names.
-          if (callee_name.find("$noinline$") == std::string::npos) {
-            if (TryInline(call)) {
-              did_inline = true;
-            } else if (honor_inline_directives) {
-              bool should_have_inlined = (callee_name.find("$inline$") != std::string::npos);
-              CHECK(!should_have_inlined) << "Could not inline " << callee_name;
-            }
-          }
-        } else {
-          DCHECK(!honor_inline_directives);
-          // Normal case: try to inline.
-          if (TryInline(call)) {
-            did_inline = true;
-          }
+        calls.emplace_back(call, loop_depth);
+      }
+    }
+  }
+  DCHECK(!graph_->GetReversePostOrder().empty());
+
+  // The inlining budget is shared by all call sites, so spend it on the hottest ones first.
+  // We estimate the hotness of a call site with its loop depth and keep the reverse post
+  // order for call sites of the same depth.
+  std::stable_sort(calls.begin(), calls.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.second > rhs.second;
+  });
+
+  for (const auto& [call, loop_depth] : calls) {
+    bool inlined = false;
+    if (honor_noinline_directives) {
+      // Debugging case: directives in method names control or assert on inlining.
+      std::string callee_name =
+          call->GetMethodReference().PrettyMethod(/* with_signature= */ false);
+      // Tests prevent inlining by having $noinline$ in their method names.
+      if (callee_name.find("$noinline$") == std::string::npos) {
+        if (TryInline(call)) {
+          inlined = true;
+        } else if (honor_inline_directives) {
+          bool should_have_inlined = (callee_name.find("$inline$") != std::string::npos);
+          CHECK(!should_have_inlined) << "Could not inline " << callee_name;
         }
       }
-      instruction = next;
+    } else {
+      DCHECK(!honor_inline_directives);
+      // Normal case: try to inline.
+      inlined = TryInline(call);
+    }
+    if (inlined) {
+      did_inline = true;
+      MaybeRecordStat(stats_,
+                      loop_depth != 0u ? MethodCompilationStat::kInlinedHotCallSite
+                                       : MethodCompilationStat::kInlinedColdCallSite);
     }
   }
 
@@ -351,6 +386,41 @@ HInliner::InlineCacheType HInliner::GetInlineCacheType(
   }
 }
 
+// Select the receivers of a megamorphic inline cache that get at least
+// kMinDominantReceiverPercent of its hits, most hit first. The last entry of the cache is
+// shared by all the classes that did not fit, so it is never selected. Returns false if
+// there is no such receiver, which includes caches without counts.
+static bool GetDominantReceivers(
+    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+    const std::array<uint32_t, InlineCache::kIndividualCacheSize>& counts,
+    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* dominant_classes)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  DCHECK_EQ(classes.Size(), InlineCache::kIndividualCacheSize);
+  DCHECK_EQ(dominant_classes->Size(), 0u);
+  uint64_t total = 0u;
+  for (uint32_t count : counts) {
+    total += count;
+  }
+  if (total == 0u) {
+    return false;
+  }
+  std::array<size_t, InlineCache::kIndividualCacheSize - 1u> candidates;
+  size_t number_of_candidates = 0u;
+  for (size_t i = 0; i + 1u < InlineCache::kIndividualCacheSize; ++i) {
+    if (counts[i] * UINT64_C(100) >= total * kMinDominantReceiverPercent) {
+      candidates[number_of_candidates++] = i;
+    }
+  }
+  std::sort(candidates.begin(),
+            candidates.begin() + number_of_candidates,
+            [&counts](size_t lhs, size_t rhs) { return counts[lhs] > counts[rhs]; });
+  number_of_candidates = std::min(number_of_candidates, kMaximumNumberOfDominantReceivers);
+  for (size_t i = 0; i != number_of_candidates; ++i) {
+    dominant_classes->NewHandle(classes.GetReference(candidates[i])->AsClass());
+  }
+  return number_of_candidates != 0u;
+}
+
 static inline ObjPtr<mirror::Class> GetMonomorphicType(
     const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
     REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -630,12 +700,14 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
   }
 
   StackHandleScope<InlineCache::kIndividualCacheSize> classes(Thread::Current());
+  // Profiles do not record receiver counts, they stay zero for AOT inline caches.
+  std::array<uint32_t, InlineCache::kIndividualCacheSize> counts = {};
   // The Zygote JIT compiles based on a profile, so we shouldn't use runtime inline caches
   // for it.
   InlineCacheType inline_cache_type =
       (Runtime::Current()->IsAotCompiler() || Runtime::Current()->IsZygote())
           ? GetInlineCacheAOT(invoke_instruction, &classes)
-          : GetInlineCacheJIT(invoke_instruction, &classes);
+          : GetInlineCacheJIT(invoke_instruction, &classes, &counts);
 
   switch (inline_cache_type) {
     case kInlineCacheNoData: {
@@ -668,6 +740,14 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
     }
 
     case kInlineCacheMegamorphic: {
+      StackHandleScope<InlineCache::kIndividualCacheSize> dominant_classes(Thread::Current());
+      if (GetDominantReceivers(classes, counts, &dominant_classes) &&
+          TryInlinePolymorphicCall(invoke_instruction,
+                                   dominant_classes,
+                                   /*is_megamorphic=*/ true)) {
+        MaybeRecordStat(stats_, MethodCompilationStat::kInlinedMegamorphicCall);
+        return true;
+      }
       LOG_FAIL_NO_STAT()
           << "Interface or virtual call to "
           << invoke_instruction->GetMethodReference().PrettyMethod()
@@ -688,7 +768,8 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
 
 HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
     HInvoke* invoke_instruction,
-    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
+    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+    /*out*/std::array<uint32_t, InlineCache::kIndividualCacheSize>* counts) {
   DCHECK(codegen_->GetCompilerOptions().IsJitCompiler());
 
   ArtMethod* caller = graph_->GetArtMethod();
@@ -726,7 +807,7 @@ HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
     // Bail for now.
     return kInlineCacheNoData;
   }
-  Runtime::Current()->GetJit()->GetCodeCache()->CopyInlineCacheInto(*cache, classes);
+  Runtime::Current()->GetJit()->GetCodeCache()->CopyInlineCacheInto(*cache, classes, counts);
   return GetInlineCacheType(*classes);
 }
 
@@ -1021,11 +1102,14 @@ static void MaybeReplaceAndRemove(HInstruction* new_instruction, HInstruction* o
 
 bool HInliner::TryInlinePolymorphicCall(
     HInvoke* invoke_instruction,
-    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes) {
+    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+    bool is_megamorphic) {
   DCHECK(invoke_instruction->IsInvokeVirtual() || invoke_instruction->IsInvokeInterface())
       << invoke_instruction->DebugName();
 
-  if (TryInlinePolymorphicCallToSameTarget(invoke_instruction, classes)) {
+  // The same target check deoptimizes for other targets, which the other receivers of a
+  // megamorphic call are likely to have.
+  if (!is_megamorphic && TryInlinePolymorphicCallToSameTarget(invoke_instruction, classes)) {
     return true;
   }
 
@@ -1058,7 +1142,7 @@ bool HInliner::TryInlinePolymorphicCall(
 
     // In monomorphic cases when UseOnlyPolymorphicInliningWithNoDeopt() is true, we call
     // `TryInlinePolymorphicCall` even though we are monomorphic.
-    const bool actually_monomorphic = number_of_types == 1;
+    const bool actually_monomorphic = number_of_types == 1 && !is_megamorphic;
     DCHECK_IMPLIES(actually_monomorphic, UseOnlyPolymorphicInliningWithNoDeopt());
 
     // We only want to limit recursive polymorphic cases, not monomorphic ones.
@@ -1089,8 +1173,10 @@ bool HInliner::TryInlinePolymorphicCall(
                     << " has inlined " << ArtMethod::PrettyMethod(method);
 
       // If we have inlined all targets before, and this receiver is the last seen,
-      // we deoptimize instead of keeping the original invoke instruction.
-      bool deoptimize = !UseOnlyPolymorphicInliningWithNoDeopt() &&
+      // we deoptimize instead of keeping the original invoke instruction. Megamorphic
+      // calls keep it for the receivers that were not selected.
+      bool deoptimize = !is_megamorphic &&
+          !UseOnlyPolymorphicInliningWithNoDeopt() &&
           all_targets_inlined &&
           (i + 1 == number_of_types);
 
@@ -1571,6 +1657,13 @@ bool HInliner::IsInliningEncouraged(const HInvoke* invoke_instruction,
     return false;
   }
 
+  if (outermost_graph_->IsCompilingMidTier() &&
+      accessor.InsnsSizeInCodeUnits() > CompilerOptions::kBaselineInlineMaxCodeUnits) {
+    LOG_FAIL_NO_STAT() << "Reached mid tier maximum code unit for inlining "
+                       << method->PrettyMethod();
+    return false;
+  }
+
   if (invoke_instruction->GetBlock()->GetLastInstruction()->IsThrow()) {
     LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedEndsWithThrow)
         << "Method " << method->PrettyMethod()
@@ -1973,6 +2066,32 @@ void HInliner::SubstituteArguments(HGraph* callee_graph,
 //
 // If this function returns true, it will also set out_number_of_instructions to
 // the number of instructions in the inlined body.
+// Returns whether `callee_graph` returns at least once and never returns null.
+static bool ReturnsNonNull(const HGraph* callee_graph) {
+  HBasicBlock* exit_block = callee_graph->GetExitBlock();
+  if (exit_block == nullptr) {
+    return false;
+  }
+  bool has_return = false;
+  for (HBasicBlock* predecessor : exit_block->GetPredecessors()) {
+    const HInstruction* last_instruction = predecessor->GetLastInstruction();
+    // Skip the TryBoundary of Return/ReturnVoid/Throw -> TryBoundary -> Exit.
+    if (last_instruction->IsTryBoundary()) {
+      last_instruction = predecessor->GetSinglePredecessor()->GetLastInstruction();
+    }
+    if (last_instruction->IsReturn()) {
+      HInstruction* value = last_instruction->InputAt(0);
+      if (value->GetType() != DataType::Type::kReference || value->CanBeNull()) {
+        return false;
+      }
+      has_return = true;
+    } else if (!last_instruction->IsThrow()) {
+      return false;
+    }
+  }
+  return has_return;
+}
+
 bool HInliner::CanInlineBody(const HGraph* callee_graph,
                              HInvoke* invoke,
                              size_t* out_number_of_instructions,
@@ -2268,6 +2387,13 @@ bool HInliner::TryBuildAndInlineHelper(HInvoke* invoke_instruction,
 
   size_t number_of_instructions = 0;
   if (!CanInlineBody(callee_graph, invoke_instruction, &number_of_instructions, is_speculative)) {
+    // We went through the work of building and optimizing the callee graph, so keep what it
+    // tells us about the result of this call. As for `SetAlwaysThrows`, we do not do this for
+    // speculative inlines since the actual callee may be another method.
+    if (!is_speculative && ReturnsNonNull(callee_graph)) {
+      invoke_instruction->SetReturnsNonNull(/* returns_non_null= */ true);
+      MaybeRecordStat(stats_, MethodCompilationStat::kInvokeReturnsNonNull);
+    }
     return false;
   }
 
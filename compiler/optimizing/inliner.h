@@ -17,6 +17,8 @@
 #ifndef ART_COMPILER_OPTIMIZING_INLINER_H_
 #define ART_COMPILER_OPTIMIZING_INLINER_H_
 
+#include <array>
+
 #include "base/macros.h"
 #include "dex/dex_file_types.h"
 #include "dex/invoke_type.h"
@@ -193,10 +195,12 @@ class HInliner : public HOptimization {
 
   // Try getting the inline cache from JIT code cache.
   // Return true if the inline cache was successfully allocated and the
-  // invoke info was found in the profile info.
+  // invoke info was found in the profile info. `counts` receives the hit
+  // counts of the receivers, aligned with `classes`.
   InlineCacheType GetInlineCacheJIT(
       HInvoke* invoke_instruction,
-      /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes)
+      /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+      /*out*/std::array<uint32_t, InlineCache::kIndividualCacheSize>* counts)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Try getting the inline cache from AOT offline profile.
@@ -220,9 +224,11 @@ class HInliner : public HOptimization {
                                 const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Try to inline targets of a polymorphic call.
+  // Try to inline targets of a polymorphic call. If `is_megamorphic`, `classes` only holds
+  // some of the receivers and the original invoke is always kept as the fallback.
   bool TryInlinePolymorphicCall(HInvoke* invoke_instruction,
-                                const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
+                                const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+                                bool is_megamorphic = false)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   bool TryInlinePolymorphicCallToSameTarget(
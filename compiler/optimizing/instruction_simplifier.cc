@@ -2855,9 +2855,13 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
           arg = StringBuilderAppend::Argument::kString;
           break;
         case Intrinsics::kStringBuilderAppendCharArray:
-          // TODO: Unimplemented, StringBuilder.append(char[]) can throw NPE and we would
-          // not have the correct stack trace for it.
-          return false;
+          // StringBuilder.append(char[]) can throw NPE and we would not have the correct
+          // stack trace for it, so only fuse arguments that cannot be null.
+          if (as_invoke_virtual->InputAt(1u)->CanBeNull()) {
+            return false;
+          }
+          arg = StringBuilderAppend::Argument::kCharArray;
+          break;
         case Intrinsics::kStringBuilderAppendBoolean:
           arg = StringBuilderAppend::Argument::kBoolean;
           break;
@@ -1236,6 +1236,81 @@ static void EmitStoreExclusive(CodeGeneratorARM64* codegen,
   }
 }
 
+// ARMv8.1 LSE atomic instructions taking a source register, a destination register and an
+// address, such as `casal w0, w1, [x2]` or `ldaddal w0, w1, [x2]`.
+using LseInstruction =
+    void (MacroAssembler::*)(const Register& rs, const Register& rt, const MemOperand& src);
+
+// Variants of an LSE instruction indexed by the access size (byte, halfword, word or double
+// word depending on the register size) and the ordering (none, acquire, release, both).
+struct LseInstructionVariants {
+  LseInstruction variants[3][4];
+};
+
+#define LSE_INSTRUCTION_VARIANTS(name) {{                                                       \
+    { &MacroAssembler::name##b, &MacroAssembler::name##ab,                                    \
+      &MacroAssembler::name##lb, &MacroAssembler::name##alb },                                \
+    { &MacroAssembler::name##h, &MacroAssembler::name##ah,                                    \
+      &MacroAssembler::name##lh, &MacroAssembler::name##alh },                                \
+    { &MacroAssembler::name, &MacroAssembler::name##a,                                        \
+      &MacroAssembler::name##l, &MacroAssembler::name##al }                                   \
+  }}
+
+static constexpr LseInstructionVariants kLseCas = LSE_INSTRUCTION_VARIANTS(Cas);
+static constexpr LseInstructionVariants kLseSwp = LSE_INSTRUCTION_VARIANTS(Swp);
+static constexpr LseInstructionVariants kLseLdadd = LSE_INSTRUCTION_VARIANTS(Ldadd);
+static constexpr LseInstructionVariants kLseLdclr = LSE_INSTRUCTION_VARIANTS(Ldclr);
+static constexpr LseInstructionVariants kLseLdeor = LSE_INSTRUCTION_VARIANTS(Ldeor);
+static constexpr LseInstructionVariants kLseLdset = LSE_INSTRUCTION_VARIANTS(Ldset);
+
+#undef LSE_INSTRUCTION_VARIANTS
+
+static bool CanUseLseAtomics(CodeGeneratorARM64* codegen, DataType::Type type) {
+  // The instructions store the register value as is, so avoid them with heap poisoning
+  // rather than poisoning and unpoisoning around them.
+  return codegen->GetInstructionSetFeatures().HasLSE() &&
+         !(kPoisonHeapReferences && type == DataType::Type::kReference);
+}
+
+static void EmitLseInstruction(CodeGeneratorARM64* codegen,
+                               const LseInstructionVariants& instruction,
+                               DataType::Type type,
+                               std::memory_order order,
+                               Register rs,
+                               Register rt,
+                               Register ptr) {
+  MacroAssembler* masm = codegen->GetVIXLAssembler();
+  size_t size_index = (DataType::Size(type) == 1u) ? 0u : (DataType::Size(type) == 2u) ? 1u : 2u;
+  size_t order_index;
+  switch (order) {
+    case std::memory_order_relaxed:
+      order_index = 0u;
+      break;
+    case std::memory_order_acquire:
+      order_index = 1u;
+      break;
+    case std::memory_order_release:
+      order_index = 2u;
+      break;
+    default:
+      DCHECK(order == std::memory_order_seq_cst || order == std::memory_order_acq_rel);
+      order_index = 3u;
+      break;
+  }
+  (masm->*instruction.variants[size_index][order_index])(rs, rt, MemOperand(ptr));
+  // The loaded value is zero-extended; match what EmitLoadExclusive() produces.
+  switch (type) {
+    case DataType::Type::kInt8:
+      __ Sxtb(rt, rt);
+      break;
+    case DataType::Type::kInt16:
+      __ Sxth(rt, rt);
+      break;
+    default:
+      break;
+  }
+}
+
 static void GenerateCompareAndSet(CodeGeneratorARM64* codegen,
                                   DataType::Type type,
                                   std::memory_order order,
@@ -1281,6 +1356,27 @@ static void GenerateCompareAndSet(CodeGeneratorARM64* codegen,
   // Flag Z indicates whether `old_value == expected || old_value == expected2`.
   // (If `expected2` is not valid, the `old_value == expected2` part is not emitted.)
 
+  if (CanUseLseAtomics(codegen, type) &&
+      !expected2.IsValid() &&
+      !old_value.Is(expected) &&
+      !old_value.Is(new_value) &&
+      !old_value.Is(ptr)) {
+    // With LSE, a single CAS replaces the loop and never fails spuriously:
+    //   old_value = expected;
+    //   CAS(old_value, new_value, [ptr]);  // Loads the old value into `old_value`.
+    //   if (old_value != expected) goto cmp_failure;
+    //   if (!strong) store_result = 1;
+    __ Mov(old_value, expected);
+    EmitLseInstruction(codegen, kLseCas, type, order, old_value, new_value, ptr);
+    __ Cmp(old_value, expected);
+    __ B(cmp_failure, ne);
+    if (!strong) {
+      // MOV does not change the Z flag.
+      __ Mov(store_result, 1);
+    }
+    return;
+  }
+
   vixl::aarch64::Label loop_head;
   if (strong) {
     __ Bind(&loop_head);
@@ -1622,6 +1718,44 @@ static void GenerateGetAndUpdate(CodeGeneratorARM64* codegen,
                                  CPURegister old_value) {
   MacroAssembler* masm = codegen->GetVIXLAssembler();
   UseScratchRegisterScope temps(masm);
+
+  if (CanUseLseAtomics(codegen, load_store_type) &&
+      get_and_update_op != GetAndUpdateOp::kAddWithByteSwap &&
+      !arg.IsVRegister()) {
+    // A single LSE read-modify-write instruction replaces the exclusive load/store loop.
+    Register arg_reg = arg.IsX() ? arg.X() : arg.W();
+    Register old_value_reg = old_value.IsX() ? old_value.X() : old_value.W();
+    const LseInstructionVariants* instruction = nullptr;
+    switch (get_and_update_op) {
+      case GetAndUpdateOp::kSet:
+        instruction = &kLseSwp;
+        break;
+      case GetAndUpdateOp::kAdd:
+        instruction = &kLseLdadd;
+        break;
+      case GetAndUpdateOp::kAnd: {
+        // LDCLR clears the bits set in the operand.
+        Register inverted_arg = temps.AcquireSameSizeAs(arg_reg);
+        __ Mvn(inverted_arg, arg_reg);
+        arg_reg = inverted_arg;
+        instruction = &kLseLdclr;
+        break;
+      }
+      case GetAndUpdateOp::kOr:
+        instruction = &kLseLdset;
+        break;
+      case GetAndUpdateOp::kXor:
+        instruction = &kLseLdeor;
+        break;
+      case GetAndUpdateOp::kAddWithByteSwap:
+        LOG(FATAL) << "Unreachable";
+        UNREACHABLE();
+    }
+    EmitLseInstruction(
+        codegen, *instruction, load_store_type, order, arg_reg, old_value_reg, ptr);
+    return;
+  }
+
   Register store_result = temps.AcquireW();
 
   DCHECK_EQ(old_value.GetSizeInBits(), arg.GetSizeInBits());
@@ -2956,9 +3090,10 @@ void IntrinsicCodeGeneratorARM64::VisitSystemArrayCopyChar(HInvoke* invoke) {
 
   // We split processing of the array in two parts: head and tail.
   // A first loop handles the head by copying a block of characters per
-  // iteration (see: chars_per_block).
+  // iteration (see: chars_per_block) with a load/store pair.
   // A second loop handles the tail by copying the remaining characters.
-  // If the copy length is not constant, we copy them one-by-one.
+  // If the copy length is not constant, we copy a half block if possible and
+  // then the rest one-by-one.
   // If the copy length is constant, we optimize by always unrolling the tail
   // loop, and also unrolling the head loop when the copy length is small (see:
   // unroll_threshold).
@@ -2977,18 +3112,21 @@ void IntrinsicCodeGeneratorARM64::VisitSystemArrayCopyChar(HInvoke* invoke) {
   // loop, respectively. This ensures that any remaining length after each
   // head loop iteration means there is a full block remaining, reducing the
   // number of conditional checks required on every iteration.
-  constexpr int32_t chars_per_block = 4;
+  constexpr int32_t chars_per_block = 8;
+  constexpr int32_t chars_per_half_block = chars_per_block / 2;
   constexpr int32_t unroll_threshold = 2 * chars_per_block;
   vixl::aarch64::Label loop1, loop2, pre_loop2, done;
 
   Register length_tmp = src_stop_addr.W();
-  Register tmp = temps.AcquireRegisterOfSize(char_size * chars_per_block * kBitsPerByte);
+  Register tmp = temps.AcquireX();
+  Register tmp2 = temps.AcquireX();
+  static_assert(char_size * chars_per_half_block == kXRegSizeInBytes);
 
   auto emitHeadLoop = [&]() {
     __ Bind(&loop1);
-    __ Ldr(tmp, MemOperand(src_curr_addr, char_size * chars_per_block, PostIndex));
+    __ Ldp(tmp, tmp2, MemOperand(src_curr_addr, char_size * chars_per_block, PostIndex));
     __ Subs(length_tmp, length_tmp, chars_per_block);
-    __ Str(tmp, MemOperand(dst_curr_addr, char_size * chars_per_block, PostIndex));
+    __ Stp(tmp, tmp2, MemOperand(dst_curr_addr, char_size * chars_per_block, PostIndex));
     __ B(&loop1, ge);
   };
 
@@ -3001,17 +3139,22 @@ void IntrinsicCodeGeneratorARM64::VisitSystemArrayCopyChar(HInvoke* invoke) {
   };
 
   auto emitUnrolledTailLoop = [&](const int32_t tail_length) {
-    DCHECK_LT(tail_length, 4);
+    DCHECK_LT(tail_length, chars_per_block);
 
     // Don't use post-index addressing, and instead add a constant offset later.
+    if ((tail_length & 4) != 0) {
+      __ Ldr(tmp, MemOperand(src_curr_addr));
+      __ Str(tmp, MemOperand(dst_curr_addr));
+    }
     if ((tail_length & 2) != 0) {
-      __ Ldr(tmp.W(), MemOperand(src_curr_addr));
-      __ Str(tmp.W(), MemOperand(dst_curr_addr));
+      const int32_t offset = (tail_length & 4) * char_size;
+      __ Ldr(tmp.W(), MemOperand(src_curr_addr, offset));
+      __ Str(tmp.W(), MemOperand(dst_curr_addr, offset));
     }
     if ((tail_length & 1) != 0) {
       const int32_t offset = (tail_length & ~1) * char_size;
-      __ Ldrh(tmp, MemOperand(src_curr_addr, offset));
-      __ Strh(tmp, MemOperand(dst_curr_addr, offset));
+      __ Ldrh(tmp.W(), MemOperand(src_curr_addr, offset));
+      __ Strh(tmp.W(), MemOperand(dst_curr_addr, offset));
     }
   };
 
@@ -3021,11 +3164,11 @@ void IntrinsicCodeGeneratorARM64::VisitSystemArrayCopyChar(HInvoke* invoke) {
       __ Mov(length_tmp, constant_length - chars_per_block);
       emitHeadLoop();
     } else {
-      static_assert(unroll_threshold == 8, "The unroll_threshold must be 8.");
+      static_assert(unroll_threshold == 16, "The unroll_threshold must be 16.");
       // Fully unroll both the head and tail loops.
-      if ((constant_length & 4) != 0) {
-        __ Ldr(tmp, MemOperand(src_curr_addr, 4 * char_size, PostIndex));
-        __ Str(tmp, MemOperand(dst_curr_addr, 4 * char_size, PostIndex));
+      if ((constant_length & chars_per_block) != 0) {
+        __ Ldp(tmp, tmp2, MemOperand(src_curr_addr, char_size * chars_per_block, PostIndex));
+        __ Stp(tmp, tmp2, MemOperand(dst_curr_addr, char_size * chars_per_block, PostIndex));
       }
     }
     emitUnrolledTailLoop(constant_length % chars_per_block);
@@ -3040,6 +3183,13 @@ void IntrinsicCodeGeneratorARM64::VisitSystemArrayCopyChar(HInvoke* invoke) {
     __ Adds(length_tmp, length_tmp, chars_per_block);
     __ B(&done, eq);
 
+    // At most `chars_per_block - 1` chars remain; copy a half block if possible.
+    __ Tbz(length_tmp, WhichPowerOf2(chars_per_half_block), &loop2);
+    __ Ldr(tmp, MemOperand(src_curr_addr, char_size * chars_per_half_block, PostIndex));
+    __ Subs(length_tmp, length_tmp, chars_per_half_block);
+    __ Str(tmp, MemOperand(dst_curr_addr, char_size * chars_per_half_block, PostIndex));
+    __ B(&done, eq);
+
     emitTailLoop();
   }
 
@@ -3711,22 +3861,29 @@ void IntrinsicCodeGeneratorARM64::VisitCRC32Update(HInvoke* invoke) {
   __ Mvn(out, tmp);
 }
 
-// Generate code using CRC32 instructions which calculates
+enum class CRC32Polynomial {
+  kCRC32,   // java.util.zip.CRC32, which inverts the value before and after the update.
+  kCRC32C,  // java.util.zip.CRC32C, which keeps the value inverted between updates.
+};
+
+// Generate code using CRC32 or CRC32C instructions which calculates
 // a CRC32 value of a byte.
 //
 // Parameters:
-//   masm   - VIXL macro assembler
-//   crc    - a register holding an initial CRC value
-//   ptr    - a register holding a memory address of bytes
-//   length - a register holding a number of bytes to process
-//   out    - a register to put a result of calculation
+//   masm       - VIXL macro assembler
+//   polynomial - CRC32 or CRC32C
+//   crc        - a register holding an initial CRC value
+//   ptr        - a register holding a memory address of bytes
+//   length     - a register holding a number of bytes to process
+//   out        - a register to put a result of calculation
 static void GenerateCodeForCalculationCRC32ValueOfBytes(MacroAssembler* masm,
+                                                        CRC32Polynomial polynomial,
                                                         const Register& crc,
                                                         const Register& ptr,
                                                         const Register& length,
                                                         const Register& out) {
   // The algorithm of CRC32 of bytes is:
-  //   crc = ~crc
+  //   crc = ~crc (CRC32 only)
   //   process a few first bytes to make the array 8-byte aligned
   //   while array has 8 bytes do:
   //     crc = crc32_of_8bytes(crc, 8_bytes(array))
@@ -3736,7 +3893,7 @@ static void GenerateCodeForCalculationCRC32ValueOfBytes(MacroAssembler* masm,
   //     crc = crc32_of_2bytes(crc, 2_bytes(array))
   //   if array has a byte:
   //     crc = crc32_of_byte(crc, 1_byte(array))
-  //   crc = ~crc
+  //   crc = ~crc (CRC32 only)
 
   vixl::aarch64::Label loop, done;
   vixl::aarch64::Label process_4bytes, process_2bytes, process_1byte;
@@ -3747,29 +3904,62 @@ static void GenerateCodeForCalculationCRC32ValueOfBytes(MacroAssembler* masm,
   UseScratchRegisterScope temps(masm);
   Register len = temps.AcquireW();
   Register array_elem = temps.AcquireW();
+  const bool is_crc32c = polynomial == CRC32Polynomial::kCRC32C;
+  auto crc32b = [&](const Register& value) {
+    if (is_crc32c) {
+      __ Crc32cb(out, out, value);
+    } else {
+      __ Crc32b(out, out, value);
+    }
+  };
+  auto crc32h = [&](const Register& value) {
+    if (is_crc32c) {
+      __ Crc32ch(out, out, value);
+    } else {
+      __ Crc32h(out, out, value);
+    }
+  };
+  auto crc32w = [&](const Register& value) {
+    if (is_crc32c) {
+      __ Crc32cw(out, out, value);
+    } else {
+      __ Crc32w(out, out, value);
+    }
+  };
+  auto crc32x = [&](const Register& value) {
+    if (is_crc32c) {
+      __ Crc32cx(out, out, value);
+    } else {
+      __ Crc32x(out, out, value);
+    }
+  };
 
-  __ Mvn(out, crc);
+  if (is_crc32c) {
+    __ Mov(out, crc);
+  } else {
+    __ Mvn(out, crc);
+  }
   __ Mov(len, length);
 
   __ Tbz(ptr, 0, &aligned2);
   __ Subs(len, len, 1);
   __ B(&done, lo);
   __ Ldrb(array_elem, MemOperand(ptr, 1, PostIndex));
-  __ Crc32b(out, out, array_elem);
+  crc32b(array_elem);
 
   __ Bind(&aligned2);
   __ Tbz(ptr, 1, &aligned4);
   __ Subs(len, len, 2);
   __ B(&process_1byte, lo);
   __ Ldrh(array_elem, MemOperand(ptr, 2, PostIndex));
-  __ Crc32h(out, out, array_elem);
+  crc32h(array_elem);
 
   __ Bind(&aligned4);
   __ Tbz(ptr, 2, &aligned8);
   __ Subs(len, len, 4);
   __ B(&process_2bytes, lo);
   __ Ldr(array_elem, MemOperand(ptr, 4, PostIndex));
-  __ Crc32w(out, out, array_elem);
+  crc32w(array_elem);
 
   __ Bind(&aligned8);
   __ Subs(len, len, 8);
@@ -3780,7 +3970,7 @@ static void GenerateCodeForCalculationCRC32ValueOfBytes(MacroAssembler* masm,
   __ Bind(&loop);
   __ Ldr(array_elem.X(), MemOperand(ptr, 8, PostIndex));
   __ Subs(len, len, 8);
-  __ Crc32x(out, out, array_elem.X());
+  crc32x(array_elem.X());
   // if len >= 8, process the next 8 bytes.
   __ B(&loop, hs);
 
@@ -3797,22 +3987,24 @@ static void GenerateCodeForCalculationCRC32ValueOfBytes(MacroAssembler* masm,
   // Goto process_2bytes if less than four bytes available
   __ Tbz(len, 2, &process_2bytes);
   __ Ldr(array_elem, MemOperand(ptr, 4, PostIndex));
-  __ Crc32w(out, out, array_elem);
+  crc32w(array_elem);
 
   __ Bind(&process_2bytes);
   // Goto process_1bytes if less than two bytes available
   __ Tbz(len, 1, &process_1byte);
   __ Ldrh(array_elem, MemOperand(ptr, 2, PostIndex));
-  __ Crc32h(out, out, array_elem);
+  crc32h(array_elem);
 
   __ Bind(&process_1byte);
   // Goto done if no bytes available
   __ Tbz(len, 0, &done);
   __ Ldrb(array_elem, MemOperand(ptr));
-  __ Crc32b(out, out, array_elem);
+  crc32b(array_elem);
 
   __ Bind(&done);
-  __ Mvn(out, out);
+  if (!is_crc32c) {
+    __ Mvn(out, out);
+  }
 }
 
 // The threshold for sizes of arrays to use the library provided implementation
@@ -3870,7 +4062,8 @@ void IntrinsicCodeGeneratorARM64::VisitCRC32UpdateBytes(HInvoke* invoke) {
   Register crc = WRegisterFrom(locations->InAt(0));
   Register out = WRegisterFrom(locations->Out());
 
-  GenerateCodeForCalculationCRC32ValueOfBytes(masm, crc, ptr, length, out);
+  GenerateCodeForCalculationCRC32ValueOfBytes(
+      masm, CRC32Polynomial::kCRC32, crc, ptr, length, out);
 
   __ Bind(slow_path->GetExitLabel());
 }
@@ -3915,7 +4108,116 @@ void IntrinsicCodeGeneratorARM64::VisitCRC32UpdateByteBuffer(HInvoke* invoke) {
   Register crc = WRegisterFrom(locations->InAt(0));
   Register length = WRegisterFrom(locations->InAt(3));
   Register out = WRegisterFrom(locations->Out());
-  GenerateCodeForCalculationCRC32ValueOfBytes(masm, crc, ptr, length, out);
+  GenerateCodeForCalculationCRC32ValueOfBytes(
+      masm, CRC32Polynomial::kCRC32, crc, ptr, length, out);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitCRC32CUpdateBytes(HInvoke* invoke) {
+  if (!codegen_->GetInstructionSetFeatures().HasCRC()) {
+    return;
+  }
+
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke,
+                                       LocationSummary::kCallOnSlowPath,
+                                       kIntrinsified);
+
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RegisterOrConstant(invoke->InputAt(2)));
+  locations->SetInAt(3, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister());
+}
+
+// Lower the invoke of CRC32C.updateBytes(int crc, byte[] b, int off, int end)
+//
+// Note: The intrinsic is not used if end - off exceeds a threshold or is negative.
+void IntrinsicCodeGeneratorARM64::VisitCRC32CUpdateBytes(HInvoke* invoke) {
+  DCHECK(codegen_->GetInstructionSetFeatures().HasCRC());
+
+  MacroAssembler* masm = GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  SlowPathCodeARM64* slow_path =
+      new (codegen_->GetScopedAllocator()) IntrinsicSlowPathARM64(invoke);
+  codegen_->AddSlowPath(slow_path);
+
+  Register length = WRegisterFrom(locations->GetTemp(1));
+  Register end = WRegisterFrom(locations->InAt(3));
+  Location offset = locations->InAt(2);
+  if (offset.IsConstant()) {
+    __ Sub(length, end, offset.GetConstant()->AsIntConstant()->GetValue());
+  } else {
+    __ Sub(length, end, WRegisterFrom(offset));
+  }
+  // An unsigned comparison also sends negative lengths to the slow path.
+  __ Cmp(length, kCRC32UpdateBytesThreshold);
+  __ B(slow_path->GetEntryLabel(), hi);
+
+  const uint32_t array_data_offset =
+      mirror::Array::DataOffset(Primitive::kPrimByte).Uint32Value();
+  Register ptr = XRegisterFrom(locations->GetTemp(0));
+  Register array = XRegisterFrom(locations->InAt(1));
+  if (offset.IsConstant()) {
+    int32_t offset_value = offset.GetConstant()->AsIntConstant()->GetValue();
+    __ Add(ptr, array, array_data_offset + offset_value);
+  } else {
+    __ Add(ptr, array, array_data_offset);
+    __ Add(ptr, ptr, XRegisterFrom(offset));
+  }
+
+  Register crc = WRegisterFrom(locations->InAt(0));
+  Register out = WRegisterFrom(locations->Out());
+
+  GenerateCodeForCalculationCRC32ValueOfBytes(
+      masm, CRC32Polynomial::kCRC32C, crc, ptr, length, out);
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderARM64::VisitCRC32CUpdateDirectByteBuffer(HInvoke* invoke) {
+  if (!codegen_->GetInstructionSetFeatures().HasCRC()) {
+    return;
+  }
+
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke,
+                                       LocationSummary::kNoCall,
+                                       kIntrinsified);
+
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetInAt(3, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister());
+}
+
+// Lower the invoke of CRC32C.updateDirectByteBuffer(int crc, long addr, int off, int end)
+//
+// As for CRC32.updateByteBuffer, the method is private and CRC32C only passes it the address
+// and the checked bounds of a direct buffer.
+void IntrinsicCodeGeneratorARM64::VisitCRC32CUpdateDirectByteBuffer(HInvoke* invoke) {
+  DCHECK(codegen_->GetInstructionSetFeatures().HasCRC());
+
+  MacroAssembler* masm = GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register addr = XRegisterFrom(locations->InAt(1));
+  Register offset = WRegisterFrom(locations->InAt(2));
+  Register ptr = XRegisterFrom(locations->GetTemp(0));
+  __ Add(ptr, addr, Operand(offset, SXTW));
+
+  Register length = WRegisterFrom(locations->GetTemp(1));
+  __ Sub(length, WRegisterFrom(locations->InAt(3)), offset);
+
+  Register crc = WRegisterFrom(locations->InAt(0));
+  Register out = WRegisterFrom(locations->Out());
+  GenerateCodeForCalculationCRC32ValueOfBytes(
+      masm, CRC32Polynomial::kCRC32C, crc, ptr, length, out);
 }
 
 void IntrinsicLocationsBuilderARM64::VisitFP16ToFloat(HInvoke* invoke) {
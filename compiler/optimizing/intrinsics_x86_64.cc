@@ -748,7 +748,7 @@ static void SystemArrayCopyPrimitive(HInvoke* invoke,
   Location dest_pos = locations->InAt(3);
   Location length = locations->InAt(4);
 
-  // Temporaries that we need for MOVSB/W/L.
+  // Temporaries that we need for MOVSB.
   CpuRegister src_base = locations->GetTemp(0).AsRegister<CpuRegister>();
   DCHECK_EQ(src_base.AsRegister(), RSI);
   CpuRegister dest_base = locations->GetTemp(1).AsRegister<CpuRegister>();
@@ -813,20 +813,17 @@ static void SystemArrayCopyPrimitive(HInvoke* invoke,
   GenArrayAddress(assembler, src_base, src, src_pos, type, data_offset);
   GenArrayAddress(assembler, dest_base, dest, dest_pos, type, data_offset);
 
-  // Do the move.
-  switch (type) {
-    case DataType::Type::kInt8:
-       __ rep_movsb();
-       break;
-    case DataType::Type::kUint16:
-       __ rep_movsw();
-       break;
-    case DataType::Type::kInt32:
-       __ rep_movsl();
-       break;
-    default:
-       LOG(FATAL) << "Unexpected data type for intrinsic";
-  }
+  // Do the move. Copy bytes rather than elements: with ERMSB and FSRM, which all current cores
+  // implement, REP MOVSB is the fastest variant for both short and bulk copies, and it uses
+  // wide (and for large counts non-temporal) stores internally. The arrays cannot overlap.
+  DCHECK(type == DataType::Type::kInt8 ||
+         type == DataType::Type::kUint16 ||
+         type == DataType::Type::kInt32) << type;
+  if (data_size != 1u) {
+    // The element count is a non-negative `int32_t`, so the byte count fits in RCX.
+    __ shlq(count, Immediate(WhichPowerOf2(data_size)));
+  }
+  __ rep_movsb();
   __ Bind(slow_path->GetExitLabel());
 }
 
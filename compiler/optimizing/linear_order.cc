@@ -16,6 +16,8 @@
 
 #include "linear_order.h"
 
+#include "base/arena_bit_vector.h"
+#include "base/bit_vector-inl.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
 
@@ -36,9 +38,50 @@ static bool IsInnerLoop(HLoopInformation* outer, HLoopInformation* inner) {
       && inner->IsIn(*outer);
 }
 
+// Marks the blocks which can only leave the method by throwing, like the paths constructing and
+// throwing an exception. These blocks are not part of any loop, as they cannot reach a back edge.
+//
+// TODO: use branch profiles to also find other cold blocks.
+static void FindColdBlocks(const HGraph* graph, /*out*/ ArenaBitVector* cold_blocks) {
+  HBasicBlock* exit = graph->GetExitBlock();
+  if (exit == nullptr) {
+    return;
+  }
+  // The post order visits the successors of a block before the block itself, except for back
+  // edges, whose blocks are in a loop and not cold.
+  for (HBasicBlock* block : ReverseRange(graph->GetReversePostOrder())) {
+    if (block == exit || block->IsLoopHeader() || block->GetSuccessors().empty()) {
+      continue;
+    }
+    bool is_cold = true;
+    for (HBasicBlock* successor : block->GetSuccessors()) {
+      if (successor == exit) {
+        // Any predecessor of the exit that does not return throws an exception.
+        HInstruction* last = block->GetLastInstruction();
+        is_cold = !last->IsReturn() && !last->IsReturnVoid() && !last->IsTryBoundary();
+      } else {
+        is_cold = cold_blocks->IsBitSet(successor->GetBlockId());
+      }
+      if (!is_cold) {
+        break;
+      }
+    }
+    if (is_cold) {
+      cold_blocks->SetBit(block->GetBlockId());
+    }
+  }
+}
+
 // Helper method to update work list for linear order.
 static void AddToListForLinearization(ScopedArenaVector<HBasicBlock*>* worklist,
+                                      const ArenaBitVector& cold_blocks,
                                       HBasicBlock* block) {
+  if (cold_blocks.IsBitSet(block->GetBlockId())) {
+    // Process the cold blocks last, to move them to the end of the method.
+    DCHECK(block->GetLoopInformation() == nullptr);
+    worklist->insert(worklist->begin(), block);
+    return;
+  }
   HLoopInformation* block_loop = block->GetLoopInformation();
   auto insert_pos = worklist->rbegin();  // insert_pos.base() will be the actual position.
   for (auto end = worklist->rend(); insert_pos != end; ++insert_pos) {
@@ -83,11 +126,12 @@ static bool IsLinearOrderWellFormed(const HGraph* graph, ArrayRef<HBasicBlock*>
   return true;
 }
 
-void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_order) {
+size_t LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_order) {
   DCHECK_EQ(linear_order.size(), graph->GetReversePostOrder().size());
   // Create a reverse post ordering with the following properties:
   // - Blocks in a loop are consecutive,
-  // - Back-edge is the last block before loop exits.
+  // - Back-edge is the last block before loop exits,
+  // - Blocks which can only throw are at the end, to keep the hot code dense.
   //
   // (1): Record the number of forward predecessors for each block. This is to
   //      ensure the resulting order is reverse post order. We could use the
@@ -104,6 +148,11 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
     }
     forward_predecessors[block->GetBlockId()] = number_of_forward_predecessors;
   }
+  ArenaBitVector cold_blocks(
+      &allocator, graph->GetBlocks().size(), /*expandable=*/ false, kArenaAllocLinearOrder);
+  if (!graph->HasIrreducibleLoops()) {
+    FindColdBlocks(graph, &cold_blocks);
+  }
   // (2): Following a worklist approach, first start with the entry block, and
   //      iterate over the successors. When all non-back edge predecessors of a
   //      successor block are visited, the successor block is added in the worklist
@@ -111,16 +160,20 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
   ScopedArenaVector<HBasicBlock*> worklist(allocator.Adapter(kArenaAllocLinearOrder));
   worklist.push_back(graph->GetEntryBlock());
   size_t num_added = 0u;
+  size_t cold_start = linear_order.size();
   do {
     HBasicBlock* current = worklist.back();
     worklist.pop_back();
+    if (cold_start == linear_order.size() && cold_blocks.IsBitSet(current->GetBlockId())) {
+      cold_start = num_added;
+    }
     linear_order[num_added] = current;
     ++num_added;
     for (HBasicBlock* successor : current->GetSuccessors()) {
       int block_id = successor->GetBlockId();
       size_t number_of_remaining_predecessors = forward_predecessors[block_id];
       if (number_of_remaining_predecessors == 1) {
-        AddToListForLinearization(&worklist, successor);
+        AddToListForLinearization(&worklist, cold_blocks, successor);
       }
       forward_predecessors[block_id] = number_of_remaining_predecessors - 1;
     }
@@ -128,6 +181,7 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
   DCHECK_EQ(num_added, linear_order.size());
 
   DCHECK(graph->HasIrreducibleLoops() || IsLinearOrderWellFormed(graph, linear_order));
+  return cold_start;
 }
 
 }  // namespace art
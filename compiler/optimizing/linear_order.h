@@ -24,27 +24,30 @@
 
 namespace art HIDDEN {
 
-void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_order);
+size_t LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_order);
 
 // Linearizes the 'graph' such that:
 // (1): a block is always after its dominator,
-// (2): blocks of loops are contiguous.
+// (2): blocks of loops are contiguous,
+// (3): blocks which can only lead to throwing an exception are at the end.
 //
 // Storage is obtained through 'allocator' and the linear order it computed
-// into 'linear_order'. Once computed, iteration can be expressed as:
+// into 'linear_order'. Returns the index in 'linear_order' of the first block of (3),
+// or the size of 'linear_order' if there is none. Once computed, iteration can be
+// expressed as:
 //
 // for (HBasicBlock* block : linear_order)                   // linear order
 //
 // for (HBasicBlock* block : ReverseRange(linear_order))     // linear post order
 //
 template <typename Vector>
-void LinearizeGraph(const HGraph* graph, Vector* linear_order) {
+size_t LinearizeGraph(const HGraph* graph, Vector* linear_order) {
   static_assert(std::is_same<HBasicBlock*, typename Vector::value_type>::value,
                 "Vector::value_type must be HBasicBlock*.");
   // Resize the vector and pass an ArrayRef<> to internal implementation which is shared
   // for all kinds of vectors, i.e. ArenaVector<> or ScopedArenaVector<>.
   linear_order->resize(graph->GetReversePostOrder().size());
-  LinearizeGraphInternal(graph, ArrayRef<HBasicBlock*>(*linear_order));
+  return LinearizeGraphInternal(graph, ArrayRef<HBasicBlock*>(*linear_order));
 }
 
 }  // namespace art
@@ -245,4 +245,38 @@ TEST_F(LinearizeTest, CFG7) {
   TestCode(data, blocks);
 }
 
+TEST_F(LinearizeTest, ThrowingBlockIsLast) {
+  // The branch target only throws, so it is placed after the fall-through path even though it
+  // would be visited first otherwise.
+  const std::vector<uint16_t> data = ONE_REGISTER_CODE_ITEM(
+    Instruction::CONST_4 | 0 | 0,
+    Instruction::IF_EQ, 3,
+    Instruction::RETURN_VOID,
+    Instruction::THROW | 0);
+
+  HGraph* graph = CreateCFG(data);
+  std::unique_ptr<CompilerOptions> compiler_options =
+      CommonCompilerTest::CreateCompilerOptions(kRuntimeISA, "default");
+  std::unique_ptr<CodeGenerator> codegen = CodeGenerator::Create(graph, *compiler_options);
+  SsaLivenessAnalysis liveness(graph, codegen.get(), GetScopedAllocator());
+  liveness.Analyze();
+
+  size_t return_position = graph->GetLinearOrder().size();
+  size_t throw_position = graph->GetLinearOrder().size();
+  for (size_t i = 0; i < graph->GetLinearOrder().size(); ++i) {
+    HInstruction* last = graph->GetLinearOrder()[i]->GetLastInstruction();
+    if (last->IsReturnVoid()) {
+      return_position = i;
+    } else if (last->IsThrow()) {
+      throw_position = i;
+    }
+  }
+  ASSERT_LT(return_position, graph->GetLinearOrder().size());
+  ASSERT_LT(throw_position, graph->GetLinearOrder().size());
+  ASSERT_LT(return_position, throw_position);
+  // Only the exit block follows the throwing block.
+  ASSERT_EQ(throw_position + 2u, graph->GetLinearOrder().size());
+  ASSERT_EQ(throw_position, graph->GetLinearOrderColdStart());
+}
+
 }  // namespace art
@@ -32,6 +32,7 @@
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
 #include "base/transform_iterator.h"
+#include "common_dominator.h"
 #include "escape.h"
 #include "handle.h"
 #include "load_store_analysis.h"
@@ -2901,12 +2902,176 @@ class LSEVisitorWrapper : public DeletableArenaObject<kArenaAllocLSE> {
   LSEVisitor lse_visitor_;
 };
 
+// The maximum number of fields copied to an allocation materialized on an escaping path.
+static constexpr size_t kMaxPartialEscapeMaterializedFields = 8;
+
+// Try to move the escape of `new_instance` to a copy of it allocated on the escaping paths.
+//
+// This applies to allocations whose escapes are all dominated by a block from which the control
+// flow only leaves the method, for example on a path ending with a throw. The copy is allocated
+// at the start of that block and gets the values the fields of the original object have there,
+// read with new loads. All the uses dominated by the copy then use the copy, so that the original
+// object no longer escapes. LSE removes it with its loads and stores, leaving the allocation only
+// on the escaping paths.
+static bool TryMaterializePartialEscape(HGraph* graph,
+                                        HNewInstance* new_instance,
+                                        ScopedArenaAllocator* allocator) {
+  CommonDominator escape_dominator(nullptr);
+  bool has_escapes = false;
+  LambdaEscapeVisitor visitor([&](HInstruction* escape) -> bool {
+    DCHECK_NE(escape, new_instance);
+    escape_dominator.Update(escape->GetBlock());
+    has_escapes = true;
+    return true;
+  });
+  VisitEscapes(new_instance, visitor);
+  HBasicBlock* block = escape_dominator.Get();
+  if (!has_escapes ||
+      block == new_instance->GetBlock() ||
+      block->IsLoopHeader()) {
+    return false;
+  }
+  DCHECK(new_instance->GetBlock()->Dominates(block));
+
+  // Collect the blocks dominated by `block`, and check that the control flow leaving them
+  // only goes to the exit block, so that the original object is never used again once the
+  // copy is allocated.
+  ArenaBitVector dominated_blocks(
+      allocator, graph->GetBlocks().size(), /*expandable=*/ false, kArenaAllocLSE);
+  ScopedArenaVector<HBasicBlock*> worklist(allocator->Adapter(kArenaAllocLSE));
+  dominated_blocks.SetBit(block->GetBlockId());
+  worklist.push_back(block);
+  while (!worklist.empty()) {
+    HBasicBlock* current = worklist.back();
+    worklist.pop_back();
+    for (HBasicBlock* dominated : current->GetDominatedBlocks()) {
+      dominated_blocks.SetBit(dominated->GetBlockId());
+      worklist.push_back(dominated);
+    }
+  }
+  for (HBasicBlock* current : graph->GetBlocks()) {
+    if (current == nullptr || !dominated_blocks.IsBitSet(current->GetBlockId())) {
+      continue;
+    }
+    for (HBasicBlock* successor : current->GetSuccessors()) {
+      if (!successor->IsExitBlock() && !dominated_blocks.IsBitSet(successor->GetBlockId())) {
+        return false;
+      }
+    }
+  }
+
+  // The remaining uses of the original object must be plain field accesses, and the fields
+  // stored outside of the escaping paths are copied.
+  ScopedArenaVector<HInstanceFieldSet*> field_stores(allocator->Adapter(kArenaAllocLSE));
+  for (const HUseListNode<HInstruction*>& use : new_instance->GetUses()) {
+    HInstruction* user = use.GetUser();
+    if (dominated_blocks.IsBitSet(user->GetBlock()->GetBlockId())) {
+      if (user->IsPhi() && user->GetBlock() == block) {
+        return false;  // Not dominated by the copy.
+      }
+      continue;
+    }
+    if (user->IsInstanceFieldSet() && use.GetIndex() == 0u) {
+      HInstanceFieldSet* store = user->AsInstanceFieldSet();
+      if (store->IsVolatile()) {
+        return false;
+      }
+      auto same_field = [store](HInstanceFieldSet* other) {
+        return other->GetFieldOffset().Uint32Value() == store->GetFieldOffset().Uint32Value();
+      };
+      if (std::none_of(field_stores.begin(), field_stores.end(), same_field)) {
+        field_stores.push_back(store);
+      }
+    } else if (!(user->IsInstanceFieldGet() && !user->AsInstanceFieldGet()->IsVolatile()) &&
+               !user->IsConstructorFence()) {
+      return false;
+    }
+  }
+  if (field_stores.size() > kMaxPartialEscapeMaterializedFields) {
+    return false;
+  }
+
+  // Materialize the copy at the start of `block`.
+  ArenaAllocator* graph_allocator = graph->GetAllocator();
+  HInstruction* cursor = block->GetFirstInstruction();
+  ScopedArenaVector<HInstruction*> field_values(allocator->Adapter(kArenaAllocLSE));
+  for (HInstanceFieldSet* store : field_stores) {
+    const FieldInfo& info = store->GetFieldInfo();
+    HInstanceFieldGet* load =
+        new (graph_allocator) HInstanceFieldGet(new_instance,
+                                                info.GetField(),
+                                                info.GetFieldType(),
+                                                info.GetFieldOffset(),
+                                                /*is_volatile=*/ false,
+                                                info.GetFieldIndex(),
+                                                info.GetDeclaringClassDefIndex(),
+                                                info.GetDexFile(),
+                                                new_instance->GetDexPc());
+    if (load->GetType() == DataType::Type::kReference) {
+      load->SetReferenceTypeInfo(graph->GetInexactObjectRti());
+    }
+    block->InsertInstructionBefore(load, cursor);
+    field_values.push_back(load);
+  }
+  HInstruction* copy = new_instance->Clone(graph_allocator);
+  copy->CopyEnvironmentFrom(new_instance->GetEnvironment());
+  block->InsertInstructionBefore(copy, cursor);
+  for (size_t i = 0; i != field_stores.size(); ++i) {
+    const FieldInfo& info = field_stores[i]->GetFieldInfo();
+    HInstanceFieldSet* store =
+        new (graph_allocator) HInstanceFieldSet(copy,
+                                                field_values[i],
+                                                info.GetField(),
+                                                info.GetFieldType(),
+                                                info.GetFieldOffset(),
+                                                /*is_volatile=*/ false,
+                                                info.GetFieldIndex(),
+                                                info.GetDeclaringClassDefIndex(),
+                                                info.GetDexFile(),
+                                                new_instance->GetDexPc());
+    block->InsertInstructionBefore(store, cursor);
+  }
+  // Publish the copied fields before any use of the copy, like a constructor would.
+  HConstructorFence* fence =
+      new (graph_allocator) HConstructorFence(copy, new_instance->GetDexPc(), graph_allocator);
+  block->InsertInstructionBefore(fence, cursor);
+  new_instance->ReplaceUsesDominatedBy(fence, copy);
+  new_instance->ReplaceEnvUsesDominatedBy(fence, copy);
+  return true;
+}
+
+// Partial escape analysis: materialize the allocations that escape only on the paths that leave
+// the method, such as paths that throw, on these paths.
+static void MaterializePartialEscapes(HGraph* graph, OptimizingCompilerStats* stats) {
+  if (graph->HasTryCatch() || graph->HasIrreducibleLoops()) {
+    return;
+  }
+  ScopedArenaAllocator allocator(graph->GetArenaStack());
+  ScopedArenaVector<HNewInstance*> candidates(allocator.Adapter(kArenaAllocLSE));
+  for (HBasicBlock* block : graph->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (instruction->IsNewInstance() &&
+          !instruction->AsNewInstance()->IsFinalizable() &&
+          !instruction->AsNewInstance()->NeedsChecks()) {
+        candidates.push_back(instruction->AsNewInstance());
+      }
+    }
+  }
+  for (HNewInstance* new_instance : candidates) {
+    if (TryMaterializePartialEscape(graph, new_instance, &allocator)) {
+      MaybeRecordStat(stats, MethodCompilationStat::kPartialAllocationMoved);
+    }
+  }
+}
+
 bool LoadStoreElimination::Run() {
   if (graph_->IsDebuggable()) {
     // Debugger may set heap values or trigger deoptimization of callers.
     // Skip this optimization.
     return false;
   }
+  MaterializePartialEscapes(graph_, stats_);
   ScopedArenaAllocator allocator(graph_->GetArenaStack());
   LoadStoreAnalysis lsa(graph_, stats_, &allocator);
   lsa.Run();
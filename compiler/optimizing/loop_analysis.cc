@@ -49,6 +49,16 @@ void LoopAnalysis::CalculateLoopBasicProperties(HLoopInformation* loop_info,
       }
     }
 
+    HIf* hif = block->GetLastInstruction()->AsIfOrNull();
+    if (hif != nullptr &&
+        analysis_results->invariant_branch_ == nullptr &&
+        !hif->InputAt(0)->IsConstant() &&
+        !loop_info->Contains(*hif->InputAt(0)->GetBlock()) &&
+        loop_info->Contains(*hif->IfTrueSuccessor()) &&
+        loop_info->Contains(*hif->IfFalseSuccessor())) {
+      analysis_results->invariant_branch_ = hif;
+    }
+
     for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
       HInstruction* instruction = it.Current();
       if (it.Current()->GetType() == DataType::Type::kInt64) {
@@ -88,6 +98,8 @@ class ArchDefaultLoopHelper : public ArchNoOptsLoopHelper {
   static constexpr uint32_t kScalarHeuristicMaxBodySizeBlocks = 6;
   // Maximum number of instructions to be created as a result of full unrolling.
   static constexpr uint32_t kScalarHeuristicFullyUnrolledMaxInstrThreshold = 35;
+  // Loop's maximum instruction count for unswitching, which duplicates the loop.
+  static constexpr uint32_t kScalarHeuristicMaxUnswitchedBodySizeInstr = 30;
 
   bool IsLoopNonBeneficialForScalarOpts(LoopAnalysisInfo* analysis_info) const override {
     return analysis_info->HasLongTypeInstructions() ||
@@ -120,6 +132,11 @@ class ArchDefaultLoopHelper : public ArchNoOptsLoopHelper {
     return (trip_count * instr_num < kScalarHeuristicFullyUnrolledMaxInstrThreshold);
   }
 
+  bool IsLoopUnswitchingBeneficial(LoopAnalysisInfo* analysis_info) const override {
+    return analysis_info->GetInvariantBranch() != nullptr &&
+           analysis_info->GetNumberOfInstructions() < kScalarHeuristicMaxUnswitchedBodySizeInstr;
+  }
+
  protected:
   bool IsLoopTooBig(LoopAnalysisInfo* loop_analysis_info,
                     size_t instr_threshold,
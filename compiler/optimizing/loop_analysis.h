@@ -40,6 +40,7 @@ class LoopAnalysisInfo : public ValueObject {
         instr_num_(0),
         exits_num_(0),
         invariant_exits_num_(0),
+        invariant_branch_(nullptr),
         has_instructions_preventing_scalar_peeling_(false),
         has_instructions_preventing_scalar_unrolling_(false),
         has_long_type_instructions_(false),
@@ -50,6 +51,7 @@ class LoopAnalysisInfo : public ValueObject {
   size_t GetNumberOfInstructions() const { return instr_num_; }
   size_t GetNumberOfExits() const { return exits_num_; }
   size_t GetNumberOfInvariantExits() const { return invariant_exits_num_; }
+  HIf* GetInvariantBranch() const { return invariant_branch_; }
 
   bool HasInstructionsPreventingScalarPeeling() const {
     return has_instructions_preventing_scalar_peeling_;
@@ -80,6 +82,9 @@ class LoopAnalysisInfo : public ValueObject {
   size_t exits_num_;
   // Number of "if" loop exits (with HIf instruction) whose condition is loop-invariant.
   size_t invariant_exits_num_;
+  // An "if" inside the loop (both successors are in the loop) whose condition is loop-invariant,
+  // or null if there is none.
+  HIf* invariant_branch_;
   // Whether the loop has instructions which make scalar loop peeling non-beneficial.
   bool has_instructions_preventing_scalar_peeling_;
   // Whether the loop has instructions which make scalar loop unrolling non-beneficial.
@@ -165,6 +170,15 @@ class ArchNoOptsLoopHelper : public ArenaObject<kArenaAllocOptimization> {
   // Returns 'false' by default, should be overridden by particular target loop helper.
   virtual bool IsLoopPeelingEnabled() const { return false; }
 
+  // Returns whether it is beneficial to unswitch the loop, i.e. to duplicate it for a loop
+  // invariant branch.
+  //
+  // Returns 'false' by default, should be overridden by particular target loop helper.
+  virtual bool IsLoopUnswitchingBeneficial(
+      [[maybe_unused]] LoopAnalysisInfo* analysis_info) const {
+    return false;
+  }
+
   // Returns whether it is beneficial to fully unroll the loop.
   //
   // Returns 'false' by default, should be overridden by particular target loop helper.
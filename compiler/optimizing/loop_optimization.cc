@@ -339,8 +339,10 @@ static bool IsSubConst2(HGraph* graph,
 // Detect reductions of the following forms,
 //   x = x_phi + ..
 //   x = x_phi - ..
+//   x = min(x_phi, ..)
+//   x = max(x_phi, ..)
 static bool HasReductionFormat(HInstruction* reduction, HInstruction* phi) {
-  if (reduction->IsAdd()) {
+  if (reduction->IsAdd() || reduction->IsMin() || reduction->IsMax()) {
     return (reduction->InputAt(0) == phi && reduction->InputAt(1) != phi) ||
            (reduction->InputAt(0) != phi && reduction->InputAt(1) == phi);
   } else if (reduction->IsSub()) {
@@ -356,6 +358,10 @@ static HVecReduce::ReductionKind GetReductionKind(HVecOperation* reduction) {
       reduction->IsVecSADAccumulate() ||
       reduction->IsVecDotProd()) {
     return HVecReduce::kSum;
+  } else if (reduction->IsVecMin()) {
+    return HVecReduce::kMin;
+  } else if (reduction->IsVecMax()) {
+    return HVecReduce::kMax;
   }
   LOG(FATAL) << "Unsupported SIMD reduction " << reduction->GetId();
   UNREACHABLE();
@@ -1052,6 +1058,40 @@ bool HLoopOptimization::TryPeelingForLoopInvariantExitsElimination(LoopAnalysisI
   return true;
 }
 
+bool HLoopOptimization::TryUnswitchingForLoopInvariantBranchElimination(
+    LoopAnalysisInfo* analysis_info, bool generate_code) {
+  if (!arch_loop_helper_->IsLoopUnswitchingBeneficial(analysis_info)) {
+    return false;
+  }
+
+  if (generate_code) {
+    // Perform versioning, the original loop and its copy get separate preheaders.
+    //
+    //     loop {                     if (cond) {
+    //       ..                         loop { .. if (1) { A } else { B } .. }
+    //       if (cond) { A }   ===>   } else {
+    //       else { B }                 loop { .. if (0) { A } else { B } .. }
+    //       ..                       }
+    //     }
+    HLoopInformation* loop_info = analysis_info->GetLoopInfo();
+    HBasicBlock* preheader = loop_info->GetPreHeader();
+    HIf* hif = analysis_info->GetInvariantBranch();
+    HInstruction* cond = hif->InputAt(0);
+    LoopClonerSimpleHelper helper(loop_info, &induction_range_);
+    helper.DoVersioning();
+    DCHECK_EQ(preheader->GetSuccessors().size(), 2u);
+    DCHECK(preheader->GetLastInstruction()->IsGoto());
+    DCHECK(cond->GetBlock()->Dominates(preheader));
+
+    // Select the version on the condition, and statically evaluate it in both versions.
+    HIf* version_hif = new (graph_->GetAllocator()) HIf(cond, hif->GetDexPc());
+    preheader->ReplaceAndRemoveInstructionWith(preheader->GetLastInstruction(), version_hif);
+    TryToEvaluateIfCondition(version_hif, graph_);
+  }
+
+  return true;
+}
+
 bool HLoopOptimization::TryFullUnrolling(LoopAnalysisInfo* analysis_info, bool generate_code) {
   // Fully unroll loops with a known and small trip count.
   int64_t trip_count = analysis_info->GetTripCount();
@@ -1104,6 +1144,7 @@ bool HLoopOptimization::TryLoopScalarOpts(LoopNode* node) {
 
   if (!TryFullUnrolling(&analysis_info, /*generate_code*/ false) &&
       !TryPeelingForLoopInvariantExitsElimination(&analysis_info, /*generate_code*/ false) &&
+      !TryUnswitchingForLoopInvariantBranchElimination(&analysis_info, /*generate_code*/ false) &&
       !TryUnrollingForBranchPenaltyReduction(&analysis_info, /*generate_code*/ false) &&
       !TryToRemoveSuspendCheckFromLoopHeader(&analysis_info, /*generate_code*/ false)) {
     return false;
@@ -1121,6 +1162,7 @@ bool HLoopOptimization::TryLoopScalarOpts(LoopNode* node) {
 
   return TryFullUnrolling(&analysis_info) ||
          TryPeelingForLoopInvariantExitsElimination(&analysis_info) ||
+         TryUnswitchingForLoopInvariantBranchElimination(&analysis_info) ||
          TryUnrollingForBranchPenaltyReduction(&analysis_info) || removed_suspend_check;
 }
 
@@ -1939,6 +1981,31 @@ bool HLoopOptimization::VectorizeUse(LoopNode* node,
       }
       return true;
     }
+  } else if (instruction->IsMin() || instruction->IsMax()) {
+    // Deal with vector restrictions.
+    // TODO: narrower operands, and floating-point operands with Java semantics for NaN and -0.0.
+    auto redit = reductions_->find(instruction);
+    bool is_reduction = redit != reductions_->end();
+    if ((type != DataType::Type::kInt32 && type != DataType::Type::kInt64) ||
+        HasVectorRestrictions(restrictions, kNoMinMax) ||
+        (is_reduction && HasVectorRestrictions(restrictions, kNoMinMaxReduce))) {
+      return false;
+    }
+    // Accept binary operator for vectorizable operands. The operands of a reduction are ordered
+    // with the phi first, so that the inactive lanes of a predicated min/max keep the partial
+    // results.
+    HInstruction* opa = instruction->InputAt(0);
+    HInstruction* opb = instruction->InputAt(1);
+    if (is_reduction && redit->second == opb) {
+      std::swap(opa, opb);
+    }
+    if (VectorizeUse(node, opa, generate_code, type, restrictions) &&
+        VectorizeUse(node, opb, generate_code, type, restrictions)) {
+      if (generate_code) {
+        GenerateVecOp(instruction, vector_map_->Get(opa), vector_map_->Get(opb), type);
+      }
+      return true;
+    }
   } else if (instruction->IsShl() || instruction->IsShr() || instruction->IsUShr()) {
     // Recognize halving add idiom.
     if (VectorizeHalvingAddIdiom(node, instruction, generate_code, type, restrictions)) {
@@ -2106,7 +2173,7 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
             *restrictions |= kNoDiv;
             return TrySetVectorLength(type, 4);
           case DataType::Type::kInt64:
-            *restrictions |= kNoDiv | kNoMul;
+            *restrictions |= kNoDiv | kNoMul | kNoMinMax;
             return TrySetVectorLength(type, 2);
           case DataType::Type::kFloat32:
             *restrictions |= kNoReduction;
@@ -2153,10 +2220,10 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
                              kNoSAD;
             return TrySetVectorLength(type, 8);
           case DataType::Type::kInt32:
-            *restrictions |= kNoDiv | kNoSAD;
+            *restrictions |= kNoDiv | kNoSAD | kNoMinMaxReduce;
             return TrySetVectorLength(type, 4);
           case DataType::Type::kInt64:
-            *restrictions |= kNoMul | kNoDiv | kNoShr | kNoAbs | kNoSAD;
+            *restrictions |= kNoMul | kNoDiv | kNoShr | kNoAbs | kNoSAD | kNoMinMax;
             return TrySetVectorLength(type, 2);
           case DataType::Type::kFloat32:
             *restrictions |= kNoReduction;
@@ -2433,6 +2500,14 @@ HInstruction* HLoopOptimization::GenerateVecOp(HInstruction* org,
       GENERATE_VEC(
         new (global_allocator_) HVecDiv(global_allocator_, opa, opb, type, vector_length_, dex_pc),
         new (global_allocator_) HDiv(org_type, opa, opb, dex_pc));
+    case HInstruction::kMin:
+      GENERATE_VEC(
+        new (global_allocator_) HVecMin(global_allocator_, opa, opb, type, vector_length_, dex_pc),
+        new (global_allocator_) HMin(org_type, opa, opb, dex_pc));
+    case HInstruction::kMax:
+      GENERATE_VEC(
+        new (global_allocator_) HVecMax(global_allocator_, opa, opb, type, vector_length_, dex_pc),
+        new (global_allocator_) HMax(org_type, opa, opb, dex_pc));
     case HInstruction::kAnd:
       GENERATE_VEC(
         new (global_allocator_) HVecAnd(global_allocator_, opa, opb, type, vector_length_, dex_pc),
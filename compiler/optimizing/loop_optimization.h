@@ -102,6 +102,8 @@ class HLoopOptimization : public HOptimization {
     kNoWideSAD       = 1 << 12,  // no sum of absolute differences (SAD) with operand widening
     kNoDotProd       = 1 << 13,  // no dot product
     kNoIfCond        = 1 << 14,  // no if condition conversion
+    kNoMinMax        = 1 << 15,  // no min/max
+    kNoMinMaxReduce  = 1 << 16,  // no min/max reduction
   };
 
   /*
@@ -270,6 +272,13 @@ class HLoopOptimization : public HOptimization {
   bool TryPeelingForLoopInvariantExitsElimination(LoopAnalysisInfo* analysis_info,
                                                   bool generate_code = true);
 
+  // Tries to apply loop unswitching for a loop invariant branch inside the loop: the loop is
+  // versioned on the branch condition, which is then statically known in each version. Returns
+  // whether transformation happened. 'generate_code' determines whether the optimization should
+  // be actually applied.
+  bool TryUnswitchingForLoopInvariantBranchElimination(LoopAnalysisInfo* analysis_info,
+                                                       bool generate_code = true);
+
   // Tries to perform whole loop unrolling for a small loop with a small trip count to eliminate
   // the loop check overhead and to have more opportunities for inter-iteration optimizations.
   // Returns whether transformation happened. 'generate_code' determines whether the optimization
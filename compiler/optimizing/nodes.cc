@@ -3250,7 +3250,7 @@ bool HInvokeStaticOrDirect::CanBeNull() const {
     BOXED_TYPES(DEFINE_BOXED_CASE)
 #undef DEFINE_BOXED_CASE
     default:
-      return true;
+      return HInvoke::CanBeNull();
   }
 }
 
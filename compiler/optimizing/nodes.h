@@ -395,6 +395,7 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
         blocks_(allocator->Adapter(kArenaAllocBlockList)),
         reverse_post_order_(allocator->Adapter(kArenaAllocReversePostOrder)),
         linear_order_(allocator->Adapter(kArenaAllocLinearOrder)),
+        linear_order_cold_start_(0u),
         entry_block_(nullptr),
         exit_block_(nullptr),
         maximum_number_of_out_vregs_(0),
@@ -428,6 +429,7 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
         art_method_(nullptr),
         compilation_kind_(compilation_kind),
         useful_optimizing_(false),
+        mid_tier_(false),
         cha_single_implementation_list_(allocator->Adapter(kArenaAllocCHA)) {
     blocks_.reserve(kDefaultNumberOfBlocks);
   }
@@ -608,6 +610,13 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
     return linear_order_;
   }
 
+  // Index in the linear order of the first block of the cold tail, which only
+  // contains blocks leading to a throw and the exit block. This is the size of
+  // the linear order if there is no such tail.
+  size_t GetLinearOrderColdStart() const {
+    return linear_order_cold_start_;
+  }
+
   IterationRange<ArenaVector<HBasicBlock*>::const_reverse_iterator> GetLinearPostOrder() const {
     return ReverseRange(GetLinearOrder());
   }
@@ -679,6 +688,20 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
 
   bool IsCompilingBaseline() const { return compilation_kind_ == CompilationKind::kBaseline; }
 
+  // A mid tier compile is an optimized compile of a big method with fewer optimizations, whose
+  // code counts hotness like baseline code to request the full optimized compile.
+  bool IsCompilingMidTier() const { return mid_tier_; }
+  void SetCompilingMidTier() {
+    DCHECK_EQ(compilation_kind_, CompilationKind::kOptimized);
+    DCHECK(profiling_info_ != nullptr);
+    mid_tier_ = true;
+  }
+
+  // Whether the compiled code decrements the baseline hotness count of the profiling info.
+  bool CountsBaselineHotness() const {
+    return (IsCompilingBaseline() && IsUsefulOptimizing()) || IsCompilingMidTier();
+  }
+
   CompilationKind GetCompilationKind() const { return compilation_kind_; }
 
   ArenaSet<ArtMethod*>& GetCHASingleImplementationList() {
@@ -796,6 +819,7 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   // List of blocks to perform a linear order tree traversal. Unlike the reverse
   // post order, this order is not incrementally kept up-to-date.
   ArenaVector<HBasicBlock*> linear_order_;
+  size_t linear_order_cold_start_;
 
   HBasicBlock* entry_block_;
   HBasicBlock* exit_block_;
@@ -907,6 +931,9 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   // method.
   bool useful_optimizing_;
 
+  // Whether this is a mid tier compile, see IsCompilingMidTier().
+  bool mid_tier_;
+
   // List of methods that are assumed to have single implementation.
   ArenaSet<ArtMethod*> cha_single_implementation_list_;
 
@@ -4783,6 +4810,16 @@ class HInvoke : public HVariableInputSizeInstruction {
 
   bool AlwaysThrows() const override final { return GetPackedFlag<kFlagAlwaysThrows>(); }
 
+  // Set when the callee is known to never return null for this particular call, e.g. because
+  // the inliner built the callee graph but could not inline it.
+  void SetReturnsNonNull(bool returns_non_null) {
+    SetPackedFlag<kFlagReturnsNonNull>(returns_non_null);
+  }
+
+  bool CanBeNull() const override {
+    return !GetPackedFlag<kFlagReturnsNonNull>() && HVariableInputSizeInstruction::CanBeNull();
+  }
+
   bool CanBeMoved() const override { return IsIntrinsic() && !DoesAnyWrite(); }
 
   bool InstructionDataEquals(const HInstruction* other) const override {
@@ -4816,7 +4853,8 @@ class HInvoke : public HVariableInputSizeInstruction {
       MinimumBitsToStore(static_cast<size_t>(kMaxInvokeType));
   static constexpr size_t kFlagCanThrow = kFieldInvokeType + kFieldInvokeTypeSize;
   static constexpr size_t kFlagAlwaysThrows = kFlagCanThrow + 1;
-  static constexpr size_t kNumberOfInvokePackedBits = kFlagAlwaysThrows + 1;
+  static constexpr size_t kFlagReturnsNonNull = kFlagAlwaysThrows + 1;
+  static constexpr size_t kNumberOfInvokePackedBits = kFlagReturnsNonNull + 1;
   static_assert(kNumberOfInvokePackedBits <= kMaxNumberOfPackedBits, "Too many packed fields.");
   using InvokeTypeField = BitField<InvokeType, kFieldInvokeType, kFieldInvokeTypeSize>;
 
@@ -31,6 +31,7 @@
 #include "base/mutex.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/systrace.h"
+#include "base/time_utils.h"
 #include "base/timing_logger.h"
 #include "builder.h"
 #include "code_generator.h"
@@ -78,17 +79,48 @@ static constexpr const char kStringFilter[] = "";
 
 class PassScope;
 
+// Destination of `--dump-pass-timings-json`, shared by all compiler threads. Each compiled
+// method is written as one JSON object on its own line so that the file can be aggregated with
+// tools/pass_timings_report.py.
+class PassTimingsOutput {
+ public:
+  explicit PassTimingsOutput(const std::string& file_name)
+      : lock_("pass timings output lock", kGenericBottomLock),
+        output_(file_name) {}
+
+  void WriteLine(const std::string& line) REQUIRES(!lock_) {
+    MutexLock mu(Thread::Current(), lock_);
+    output_ << line << '\n';
+  }
+
+ private:
+  Mutex lock_ BOTTOM_MUTEX_ACQUIRED_AFTER;
+  std::ofstream output_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(PassTimingsOutput);
+};
+
 class PassObserver : public ValueObject {
  public:
   PassObserver(HGraph* graph,
                CodeGenerator* codegen,
                std::ostream* visualizer_output,
+               PassTimingsOutput* pass_timings_output,
                const CompilerOptions& compiler_options)
       : graph_(graph),
         last_seen_graph_size_(0),
         cached_method_name_(),
         timing_logger_enabled_(compiler_options.GetDumpPassTimings()),
         timing_logger_(timing_logger_enabled_ ? GetMethodName() : "", true, true),
+        memory_oss_(),
+        pass_start_arena_bytes_(0u),
+        pass_start_stack_peak_bytes_(0u),
+        pass_timings_output_(pass_timings_output),
+        pass_timings_json_(),
+        method_start_ns_(pass_timings_output != nullptr ? NanoTime() : 0u),
+        pass_start_ns_(0u),
+        code_generation_ns_(0u),
+        code_generated_(false),
         disasm_info_(graph->GetAllocator()),
         visualizer_oss_(),
         visualizer_output_(visualizer_output),
@@ -111,6 +143,13 @@ class PassObserver : public ValueObject {
     if (timing_logger_enabled_) {
       LOG(INFO) << "TIMINGS " << GetMethodName();
       LOG(INFO) << Dumpable<TimingLogger>(timing_logger_);
+      LOG(INFO) << "MEMORY " << GetMethodName() << " (arena bytes used, scoped arena peak)";
+      LOG(INFO) << memory_oss_.str()
+                << "Total: " << graph_->GetAllocator()->BytesUsed() << ", "
+                << graph_->GetArenaStack()->ApproximatePeakBytes();
+    }
+    if (pass_timings_output_ != nullptr) {
+      WritePassTimingsJson();
     }
     if (visualizer_enabled_) {
       FlushVisualizer();
@@ -127,6 +166,20 @@ class PassObserver : public ValueObject {
 
   void SetGraphInBadState() { graph_in_bad_state_ = true; }
 
+  // Bracket `CodeGenerator::Compile()`, which does not run as a pass.
+  void StartCodeGeneration() {
+    if (pass_timings_output_ != nullptr) {
+      pass_start_ns_ = NanoTime();
+    }
+  }
+
+  void EndCodeGeneration() {
+    if (pass_timings_output_ != nullptr) {
+      code_generation_ns_ = NanoTime() - pass_start_ns_;
+    }
+    code_generated_ = true;
+  }
+
   const char* GetMethodName() {
     // PrettyMethod() is expensive, so we delay calling it until we actually have to.
     if (cached_method_name_.empty()) {
@@ -144,8 +197,13 @@ class PassObserver : public ValueObject {
       FlushVisualizer();
     }
     if (timing_logger_enabled_) {
+      pass_start_arena_bytes_ = graph_->GetAllocator()->BytesUsed();
+      pass_start_stack_peak_bytes_ = graph_->GetArenaStack()->ApproximatePeakBytes();
       timing_logger_.StartTiming(pass_name);
     }
+    if (pass_timings_output_ != nullptr) {
+      pass_start_ns_ = NanoTime();
+    }
   }
 
   void FlushVisualizer() {
@@ -157,8 +215,21 @@ class PassObserver : public ValueObject {
 
   void EndPass(const char* pass_name, bool pass_change) {
     // Pause timer first, then dump graph.
+    if (pass_timings_output_ != nullptr) {
+      pass_timings_json_ << (pass_timings_json_.tellp() == 0 ? "" : ", ")
+                         << "[\"" << pass_name << "\", " << (NanoTime() - pass_start_ns_) << "]";
+    }
     if (timing_logger_enabled_) {
       timing_logger_.EndTiming();
+      // The scoped arena peak only grows in the pass that pushed the arena stack higher than all
+      // passes before it, which attributes the method's peak memory to that pass.
+      size_t arena_bytes = graph_->GetAllocator()->BytesUsed();
+      size_t stack_peak_bytes = graph_->GetArenaStack()->ApproximatePeakBytes();
+      if (arena_bytes != pass_start_arena_bytes_ ||
+          stack_peak_bytes != pass_start_stack_peak_bytes_) {
+        memory_oss_ << pass_name << ": +" << (arena_bytes - pass_start_arena_bytes_) << ", +"
+                    << (stack_peak_bytes - pass_start_stack_peak_bytes_) << "\n";
+      }
     }
     if (visualizer_enabled_) {
       visualizer_.DumpGraph(pass_name, /* is_after_pass= */ true, graph_in_bad_state_);
@@ -181,6 +252,20 @@ class PassObserver : public ValueObject {
     }
   }
 
+  void WritePassTimingsJson() {
+    std::ostringstream line;
+    line << "{\"method\": \"" << GetMethodName() << "\""
+         << ", \"compiled\": " << (code_generated_ && !graph_in_bad_state_ ? "true" : "false")
+         << ", \"total_ns\": " << (NanoTime() - method_start_ns_)
+         << ", \"passes\": [" << pass_timings_json_.str() << "]"
+         << ", \"code_generation_ns\": " << code_generation_ns_
+         << ", \"arena_bytes\": " << graph_->GetAllocator()->BytesUsed()
+         << ", \"arena_stack_peak_bytes\": " << graph_->GetArenaStack()->ApproximatePeakBytes()
+         << ", \"code_size\": "
+         << (code_generated_ ? codegen_->GetAssembler()->CodeSize() : 0u) << "}";
+    pass_timings_output_->WriteLine(line.str());
+  }
+
   static bool IsVerboseMethod(const CompilerOptions& compiler_options, const char* method_name) {
     // Test an exact match to --verbose-methods. If verbose-methods is set, this overrides an
     // empty kStringFilter matching all methods.
@@ -206,6 +291,20 @@ class PassObserver : public ValueObject {
   bool timing_logger_enabled_;
   TimingLogger timing_logger_;
 
+  // Per-pass growth of the graph's arena usage and of the arena stack's high-water mark,
+  // collected along with the pass timings.
+  std::ostringstream memory_oss_;
+  size_t pass_start_arena_bytes_;
+  size_t pass_start_stack_peak_bytes_;
+
+  // Per-method record for `--dump-pass-timings-json`, written out when the observer dies.
+  PassTimingsOutput* const pass_timings_output_;
+  std::ostringstream pass_timings_json_;
+  uint64_t method_start_ns_;
+  uint64_t pass_start_ns_;
+  uint64_t code_generation_ns_;
+  bool code_generated_;
+
   DisassemblyInformation disasm_info_;
 
   std::ostringstream visualizer_oss_;
@@ -339,6 +438,12 @@ class OptimizingCompiler final : public Compiler {
                         const DexCompilationUnit& dex_compilation_unit,
                         PassObserver* pass_observer) const;
 
+  // Run the cheaper subset of the optimizations used for mid tier compiles.
+  void RunMidTierOptimizations(HGraph* graph,
+                               CodeGenerator* codegen,
+                               const DexCompilationUnit& dex_compilation_unit,
+                               PassObserver* pass_observer) const;
+
   // Create a 'CompiledMethod' for an optimized graph.
   CompiledMethod* Emit(ArenaAllocator* allocator,
                        CodeGenerator* codegen,
@@ -383,6 +488,8 @@ class OptimizingCompiler final : public Compiler {
 
   std::unique_ptr<std::ostream> visualizer_output_;
 
+  std::unique_ptr<PassTimingsOutput> pass_timings_output_;
+
   DISALLOW_COPY_AND_ASSIGN(OptimizingCompiler);
 };
 
@@ -399,6 +506,10 @@ OptimizingCompiler::OptimizingCompiler(const CompilerOptions& compiler_options,
     visualizer_output_.reset(new std::ofstream(cfg_file_name, cfg_file_mode));
     DumpInstructionSetFeaturesToCfg();
   }
+  const std::string& pass_timings_file_name = compiler_options.GetDumpPassTimingsJsonFileName();
+  if (!pass_timings_file_name.empty()) {
+    pass_timings_output_.reset(new PassTimingsOutput(pass_timings_file_name));
+  }
   if (compiler_options.GetDumpStats()) {
     compilation_stats_.reset(new OptimizingCompilerStats());
   }
@@ -539,7 +650,8 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
           OptDef(OptimizationPass::kInstructionSimplifierRiscv64),
           OptDef(OptimizationPass::kSideEffectsAnalysis),
           OptDef(OptimizationPass::kGlobalValueNumbering, "GVN$after_arch"),
-          OptDef(OptimizationPass::kCriticalNativeAbiFixupRiscv64)
+          OptDef(OptimizationPass::kCriticalNativeAbiFixupRiscv64),
+          OptDef(OptimizationPass::kScheduling)
       };
       return RunOptimizations(graph,
                               codegen,
@@ -716,6 +828,49 @@ void OptimizingCompiler::RunOptimizations(HGraph* graph,
   RunArchOptimizations(graph, codegen, dex_compilation_unit, pass_observer);
 }
 
+void OptimizingCompiler::RunMidTierOptimizations(HGraph* graph,
+                                                 CodeGenerator* codegen,
+                                                 const DexCompilationUnit& dex_compilation_unit,
+                                                 PassObserver* pass_observer) const {
+  // Inlining is limited to small methods by the inliner, and the loop optimizations, load store
+  // elimination and code sinking are left to the optimized compile.
+  OptimizationDef optimizations[] = {
+      OptDef(OptimizationPass::kConstantFolding),
+      OptDef(OptimizationPass::kInstructionSimplifier),
+      OptDef(OptimizationPass::kDeadCodeElimination,
+             "dead_code_elimination$initial"),
+      OptDef(OptimizationPass::kInliner),
+      OptDef(OptimizationPass::kConstantFolding,
+             "constant_folding$after_inlining",
+             OptimizationPass::kInliner),
+      OptDef(OptimizationPass::kInstructionSimplifier,
+             "instruction_simplifier$after_inlining",
+             OptimizationPass::kInliner),
+      OptDef(OptimizationPass::kDeadCodeElimination,
+             "dead_code_elimination$after_inlining",
+             OptimizationPass::kInliner),
+      OptDef(OptimizationPass::kSideEffectsAnalysis,
+             "side_effects$before_gvn"),
+      OptDef(OptimizationPass::kGlobalValueNumbering),
+      OptDef(OptimizationPass::kInductionVarAnalysis),
+      OptDef(OptimizationPass::kBoundsCheckElimination),
+      OptDef(OptimizationPass::kConstantFolding,
+             "constant_folding$before_codegen"),
+      // The codegen has a few assumptions that only the instruction simplifier
+      // can satisfy.
+      OptDef(OptimizationPass::kAggressiveInstructionSimplifier,
+             "instruction_simplifier$before_codegen"),
+      OptDef(OptimizationPass::kDeadCodeElimination,
+             "dead_code_elimination$before_codegen"),
+      OptDef(OptimizationPass::kConstructorFenceRedundancyElimination)
+  };
+  RunOptimizations(graph,
+                   codegen,
+                   dex_compilation_unit,
+                   pass_observer,
+                   optimizations);
+}
+
 static ArenaVector<linker::LinkerPatch> EmitAndSortLinkerPatches(CodeGenerator* codegen) {
   ArenaVector<linker::LinkerPatch> linker_patches(codegen->GetGraph()->GetAllocator()->Adapter());
   codegen->EmitLinkerPatches(&linker_patches);
@@ -840,6 +995,17 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
   if (jit != nullptr) {
     ProfilingInfo* info = jit->GetCodeCache()->GetProfilingInfo(method, Thread::Current());
     graph->SetProfilingInfo(info);
+    // The first optimized compile of a big baseline compiled method is a mid tier compile.
+    uint32_t mid_tier_min_code_units =
+        Runtime::Current()->GetJITOptions()->GetMidTierMinCodeUnits();
+    if (compilation_kind == CompilationKind::kOptimized &&
+        info != nullptr &&
+        !info->IsMidTierCompiled() &&
+        mid_tier_min_code_units != 0u &&
+        CodeItemInstructionAccessor(dex_file, code_item).InsnsSizeInCodeUnits() >=
+            mid_tier_min_code_units) {
+      graph->SetCompilingMidTier();
+    }
   }
 
   std::unique_ptr<CodeGenerator> codegen(
@@ -855,6 +1021,7 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
   PassObserver pass_observer(graph,
                              codegen.get(),
                              visualizer_output_.get(),
+                             pass_timings_output_.get(),
                              compiler_options);
 
   {
@@ -913,6 +1080,9 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
     graph->SetUsefulOptimizing();
     // Branch profiling currently doesn't support running optimizations.
     RunRequiredPasses(graph, codegen.get(), dex_compilation_unit, &pass_observer);
+  } else if (graph->IsCompilingMidTier()) {
+    MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kCompiledMidTier);
+    RunMidTierOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer);
   } else {
     RunOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer);
     PassScope scope(WriteBarrierElimination::kWBEPassName, &pass_observer);
@@ -951,7 +1121,9 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
     return nullptr;
   }
 
+  pass_observer.StartCodeGeneration();
   codegen->Compile();
+  pass_observer.EndCodeGeneration();
   pass_observer.DumpDisassembly();
 
   MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kCompiledBytecode);
@@ -1007,6 +1179,7 @@ CodeGenerator* OptimizingCompiler::TryCompileIntrinsic(
   PassObserver pass_observer(graph,
                              codegen.get(),
                              visualizer_output_.get(),
+                             pass_timings_output_.get(),
                              compiler_options);
 
   {
@@ -1049,7 +1222,9 @@ CodeGenerator* OptimizingCompiler::TryCompileIntrinsic(
   }
 
   CHECK_LE(codegen->GetFrameSize(), codegen->GetMaximumFrameSize());
+  pass_observer.StartCodeGeneration();
   codegen->Compile();
+  pass_observer.EndCodeGeneration();
   pass_observer.DumpDisassembly();
 
   VLOG(compiler) << "Compiled intrinsic: " << method->GetIntrinsic()
@@ -1131,6 +1306,11 @@ CompiledMethod* OptimizingCompiler::Compile(const dex::CodeItem* code_item,
                            compiled_intrinsic,
                            compiled_intrinsic ? nullptr : code_item);
 
+    if (compilation_stats_ != nullptr) {
+      compilation_stats_->RecordArenaPeakBytes(
+          allocator.BytesUsed() + arena_stack.ApproximatePeakBytes());
+    }
+
     if (kArenaAllocatorCountAllocations) {
       codegen.reset();  // Release codegen's ScopedArenaAllocator for memory accounting.
       size_t total_allocated = allocator.BytesAllocated() + arena_stack.PeakBytesAllocated();
@@ -1476,6 +1656,11 @@ bool OptimizingCompiler::JitCompile(Thread* self,
     return false;
   }
 
+  if (codegen->GetGraph()->IsCompilingMidTier()) {
+    codegen->GetGraph()->GetProfilingInfo()->SetMidTierCompiled(
+        runtime->GetJITOptions()->GetMidTierOptimizeThreshold());
+  }
+
   Runtime::Current()->GetJit()->AddMemoryUsage(method, allocator.BytesUsed());
   if (jit_logger != nullptr) {
     jit_logger->WriteLog(code, codegen->GetAssembler()->CodeSize(), method);
@@ -36,6 +36,7 @@ enum class MethodCompilationStat {
   kCompiledNativeStub,
   kCompiledIntrinsic,
   kCompiledBytecode,
+  kCompiledMidTier,
   kCHAInline,
   kInlinedInvoke,
   kInlinedLastInvoke,
@@ -71,6 +72,7 @@ enum class MethodCompilationStat {
   kNotCompiledFrameTooBig,
   kInlinedMonomorphicCall,
   kInlinedPolymorphicCall,
+  kInlinedMegamorphicCall,
   kMonomorphicCall,
   kPolymorphicCall,
   kMegamorphicCall,
@@ -135,6 +137,13 @@ enum class MethodCompilationStat {
   kPartialLSEPossible,
   kPartialStoreRemoved,
   kPartialAllocationMoved,
+  kColdCodeBytes,
+  kRegisterAllocatorSpill,
+  kRegisterAllocatorFill,
+  kRegisterAllocatorFillInLoop,
+  kInlinedHotCallSite,
+  kInlinedColdCallSite,
+  kInvokeReturnsNonNull,
   kDevirtualized,
   kLastStat
 };
@@ -153,6 +162,14 @@ class OptimizingCompilerStats {
     compile_stats_[stat_index] += count;
   }
 
+  // Records the arena memory used for compiling one method; the largest value is kept.
+  void RecordArenaPeakBytes(size_t bytes) {
+    size_t peak = arena_peak_bytes_.load(std::memory_order_relaxed);
+    while (peak < bytes &&
+           !arena_peak_bytes_.compare_exchange_weak(peak, bytes, std::memory_order_relaxed)) {
+    }
+  }
+
   uint32_t GetStat(MethodCompilationStat stat) const {
     size_t stat_index = static_cast<size_t>(stat);
     DCHECK_LT(stat_index, arraysize(compile_stats_));
@@ -186,6 +203,10 @@ class OptimizingCompilerStats {
               << compile_stats_[i];
         }
       }
+      size_t arena_peak_bytes = arena_peak_bytes_.load(std::memory_order_relaxed);
+      if (arena_peak_bytes != 0u) {
+        LOG(INFO) << "Peak arena memory for compiling a method: " << arena_peak_bytes << " bytes";
+      }
     }
   }
 
@@ -196,16 +217,19 @@ class OptimizingCompilerStats {
         other_stats->RecordStat(static_cast<MethodCompilationStat>(i), count);
       }
     }
+    other_stats->RecordArenaPeakBytes(arena_peak_bytes_.load(std::memory_order_relaxed));
   }
 
   void Reset() {
     for (std::atomic<uint32_t>& stat : compile_stats_) {
       stat = 0u;
     }
+    arena_peak_bytes_ = 0u;
   }
 
  private:
   std::atomic<uint32_t> compile_stats_[static_cast<size_t>(MethodCompilationStat::kLastStat)];
+  std::atomic<size_t> arena_peak_bytes_;
 
   DISALLOW_COPY_AND_ASSIGN(OptimizingCompilerStats);
 };
@@ -19,6 +19,7 @@
 #include "base/bit_vector-inl.h"
 #include "code_generator.h"
 #include "linear_order.h"
+#include "optimizing_compiler_stats.h"
 #include "ssa_liveness_analysis.h"
 
 namespace art HIDDEN {
@@ -495,6 +496,10 @@ void RegisterAllocationResolver::ConnectSplitSiblings(LiveInterval* interval,
   }
 }
 
+static bool IsStackSlotKind(Location location) {
+  return location.IsStackSlot() || location.IsDoubleStackSlot() || location.IsSIMDStackSlot();
+}
+
 static bool IsValidDestination(Location destination) {
   return destination.IsRegister()
       || destination.IsRegisterPair()
@@ -510,6 +515,16 @@ void RegisterAllocationResolver::AddMove(HParallelMove* move,
                                          Location destination,
                                          HInstruction* instruction,
                                          DataType::Type type) const {
+  // Record the memory traffic caused by register pressure, i.e. spills and fills.
+  OptimizingCompilerStats* stats = codegen_->GetCompilerStats();
+  if (source.IsRegisterKind() && IsStackSlotKind(destination)) {
+    MaybeRecordStat(stats, MethodCompilationStat::kRegisterAllocatorSpill);
+  } else if (IsStackSlotKind(source) && destination.IsRegisterKind()) {
+    MaybeRecordStat(stats, MethodCompilationStat::kRegisterAllocatorFill);
+    if (move->GetBlock()->IsInLoop()) {
+      MaybeRecordStat(stats, MethodCompilationStat::kRegisterAllocatorFillInLoop);
+    }
+  }
   if (type == DataType::Type::kInt64
       && codegen_->ShouldSplitLongMoves()
       // The parallel move resolver knows how to deal with long constants.
@@ -512,21 +512,38 @@ static bool HasPhiEquivalentAtLoopEntry(HGraph* graph) {
   return false;
 }
 
+static bool HasPhis(HGraph* graph) {
+  for (HBasicBlock* block : graph->GetReversePostOrder()) {
+    if (!block->GetPhis().IsEmpty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 GraphAnalysisResult SsaBuilder::BuildSsa() {
   DCHECK(!graph_->IsInSsaForm());
 
-  // Propagate types of phis. At this point, phis are typed void in the general
-  // case, or float/double/reference if we created an equivalent phi. So we need
-  // to propagate the types across phis to give them a correct type. If a type
-  // conflict is detected in this stage, the phi is marked dead.
-  RunPrimitiveTypePropagation();
-
-  // Now that the correct primitive types have been assigned, we can get rid
-  // of redundant phis. Note that we cannot do this phase before type propagation,
-  // otherwise we could get rid of phi equivalents, whose presence is a requirement
-  // for the type propagation phase. Note that this is to satisfy statement (a)
-  // of the SsaBuilder (see ssa_builder.h).
-  SsaRedundantPhiElimination(graph_).Run();
+  // HInstructionBuilder already built the SSA form while populating the blocks, so
+  // the remaining phases only type the graph and clean up the phis it created.
+  // Methods without any phi, e.g. straight-line code, can skip the phi phases.
+  // Note that no phi is created below if the graph does not already contain one.
+  const bool has_phis = HasPhis(graph_);
+
+  if (has_phis) {
+    // Propagate types of phis. At this point, phis are typed void in the general
+    // case, or float/double/reference if we created an equivalent phi. So we need
+    // to propagate the types across phis to give them a correct type. If a type
+    // conflict is detected in this stage, the phi is marked dead.
+    RunPrimitiveTypePropagation();
+
+    // Now that the correct primitive types have been assigned, we can get rid
+    // of redundant phis. Note that we cannot do this phase before type propagation,
+    // otherwise we could get rid of phi equivalents, whose presence is a requirement
+    // for the type propagation phase. Note that this is to satisfy statement (a)
+    // of the SsaBuilder (see ssa_builder.h).
+    SsaRedundantPhiElimination(graph_).Run();
+  }
 
   // Fix the type for null constants which are part of an equality comparison.
   // We need to do this after redundant phi elimination, to ensure the only cases
@@ -549,27 +566,29 @@ GraphAnalysisResult SsaBuilder::BuildSsa() {
     return kAnalysisFailAmbiguousArrayOp;
   }
 
-  // Mark dead phis. This will mark phis which are not used by instructions
-  // or other live phis. If compiling as debuggable code, phis will also be kept
-  // live if they have an environment use.
-  SsaDeadPhiElimination dead_phi_elimimation(graph_);
-  dead_phi_elimimation.MarkDeadPhis();
-
-  // Make sure environments use the right phi equivalent: a phi marked dead
-  // can have a phi equivalent that is not dead. In that case we have to replace
-  // it with the live equivalent because deoptimization and try/catch rely on
-  // environments containing values of all live vregs at that point. Note that
-  // there can be multiple phis for the same Dex register that are live
-  // (for example when merging constants), in which case it is okay for the
-  // environments to just reference one.
-  FixEnvironmentPhis();
-
-  // Now that the right phis are used for the environments, we can eliminate
-  // phis we do not need. Regardless of the debuggable status, this phase is
-  /// necessary for statement (b) of the SsaBuilder (see ssa_builder.h), as well
-  // as for the code generation, which does not deal with phis of conflicting
-  // input types.
-  dead_phi_elimimation.EliminateDeadPhis();
+  if (has_phis) {
+    // Mark dead phis. This will mark phis which are not used by instructions
+    // or other live phis. If compiling as debuggable code, phis will also be kept
+    // live if they have an environment use.
+    SsaDeadPhiElimination dead_phi_elimimation(graph_);
+    dead_phi_elimimation.MarkDeadPhis();
+
+    // Make sure environments use the right phi equivalent: a phi marked dead
+    // can have a phi equivalent that is not dead. In that case we have to replace
+    // it with the live equivalent because deoptimization and try/catch rely on
+    // environments containing values of all live vregs at that point. Note that
+    // there can be multiple phis for the same Dex register that are live
+    // (for example when merging constants), in which case it is okay for the
+    // environments to just reference one.
+    FixEnvironmentPhis();
+
+    // Now that the right phis are used for the environments, we can eliminate
+    // phis we do not need. Regardless of the debuggable status, this phase is
+    /// necessary for statement (b) of the SsaBuilder (see ssa_builder.h), as well
+    // as for the code generation, which does not deal with phis of conflicting
+    // input types.
+    dead_phi_elimimation.EliminateDeadPhis();
+  }
 
   // Replace Phis that feed in a String.<init> during instruction building. We
   // run this after redundant and dead phi elimination to make sure the phi will have
@@ -588,7 +607,7 @@ GraphAnalysisResult SsaBuilder::BuildSsa() {
   // other optimizations.
   RemoveRedundantUninitializedStrings();
 
-  if (graph_->IsCompilingOsr() && HasPhiEquivalentAtLoopEntry(graph_)) {
+  if (has_phis && graph_->IsCompilingOsr() && HasPhiEquivalentAtLoopEntry(graph_)) {
     return kAnalysisFailPhiEquivalentInOsr;
   }
 
@@ -26,7 +26,7 @@ namespace art HIDDEN {
 void SsaLivenessAnalysis::Analyze() {
   // Compute the linear order directly in the graph's data structure
   // (there are no more following graph mutations).
-  LinearizeGraph(graph_, &graph_->linear_order_);
+  graph_->linear_order_cold_start_ = LinearizeGraph(graph_, &graph_->linear_order_);
 
   // Liveness analysis.
   NumberInstructions();
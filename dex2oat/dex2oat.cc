@@ -522,6 +522,8 @@ class Dex2Oat final {
         input_vdex_fd_(-1),
         output_vdex_fd_(-1),
         input_vdex_file_(nullptr),
+        previous_vdex_fd_(-1),
+        previous_vdex_file_(nullptr),
         dm_fd_(-1),
         zip_fd_(-1),
         image_fd_(-1),
@@ -683,6 +685,10 @@ class Dex2Oat final {
       Usage("Can't have both --input-vdex-fd and --input-vdex");
     }
 
+    if (previous_vdex_fd_ != -1 && !previous_vdex_.empty()) {
+      Usage("Can't have both --previous-vdex-fd and --previous-vdex");
+    }
+
     if (output_vdex_fd_ != -1 && !output_vdex_.empty()) {
       Usage("Can't have both --output-vdex-fd and --output-vdex");
     }
@@ -1078,6 +1084,8 @@ class Dex2Oat final {
     AssignIfExists(args, M::InputVdexFd, &input_vdex_fd_);
     AssignIfExists(args, M::OutputVdexFd, &output_vdex_fd_);
     AssignIfExists(args, M::InputVdex, &input_vdex_);
+    AssignIfExists(args, M::PreviousVdexFd, &previous_vdex_fd_);
+    AssignIfExists(args, M::PreviousVdex, &previous_vdex_);
     AssignIfExists(args, M::OutputVdex, &output_vdex_);
     AssignIfExists(args, M::DmFd, &dm_fd_);
     AssignIfExists(args, M::DmFile, &dm_file_location_);
@@ -1511,6 +1519,7 @@ class Dex2Oat final {
     if (!ValidateInputVdexChecksums()) {
        return dex2oat::ReturnCode::kOther;
     }
+    OpenPreviousVdex();
 
     // Check if we need to downgrade the compiler-filter for size reasons.
     // Note: This does not affect the compiler filter already stored in the key-value
@@ -1741,6 +1750,19 @@ class Dex2Oat final {
       }
       // We can do fast verification.
       callbacks_->SetVerifierDeps(verifier_deps.release());
+    } else if (previous_vdex_file_ != nullptr) {
+      TimingLogger::ScopedTiming t_dex("Parse Previous Verifier Deps", timings_);
+      std::unique_ptr<verifier::VerifierDeps> verifier_deps(
+          new verifier::VerifierDeps(dex_files, /*output_only=*/ false));
+      if (!verifier_deps->ParseStoredData(dex_files,
+                                          previous_vdex_file_->GetVerifierDepsData(),
+                                          &unchanged_in_previous_vdex_)) {
+        // The previous vdex is only an optimization, verify all dex files instead.
+        LOG(WARNING) << "Could not parse the verifier deps of the previous vdex";
+        verifier_deps.reset(new verifier::VerifierDeps(dex_files));
+      }
+      // We can do fast verification of the unchanged dex files.
+      callbacks_->SetVerifierDeps(verifier_deps.release());
     } else {
       // Create the main VerifierDeps, here instead of in the compiler since we want to aggregate
       // the results for all the dex files, not just the results for the current dex file.
@@ -1784,6 +1806,62 @@ class Dex2Oat final {
     return true;
   }
 
+  // Opens the vdex given by --previous-vdex(-fd), and finds the dex files to compile that are
+  // unchanged since it. Any problem with the previous vdex just leads to not using it.
+  void OpenPreviousVdex() {
+    if (previous_vdex_fd_ == -1 && previous_vdex_.empty()) {
+      return;
+    }
+    if (input_vdex_file_ != nullptr) {
+      LOG(WARNING) << "Ignoring the previous vdex, as there is an input vdex";
+      return;
+    }
+    if (IsBootImage() || IsBootImageExtension()) {
+      LOG(WARNING) << "Ignoring the previous vdex, as it is not supported for the boot image";
+      return;
+    }
+    std::string error_msg;
+    if (previous_vdex_fd_ != -1) {
+      struct stat s;
+      if (TEMP_FAILURE_RETRY(fstat(previous_vdex_fd_, &s)) == -1) {
+        PLOG(WARNING) << "Failed getting length of the previous vdex file";
+        return;
+      }
+      previous_vdex_file_ = VdexFile::Open(previous_vdex_fd_,
+                                           s.st_size,
+                                           "previous-vdex",
+                                           /* writable */ false,
+                                           /* low_4gb */ false,
+                                           &error_msg);
+    } else {
+      previous_vdex_file_ = VdexFile::Open(previous_vdex_,
+                                           /* writable */ false,
+                                           /* low_4gb */ false,
+                                           &error_msg);
+    }
+    if (previous_vdex_file_ == nullptr) {
+      LOG(WARNING) << "Failed opening the previous vdex file: " << error_msg;
+      return;
+    }
+
+    // Dex files are matched by position, as multidex keeps the order of the dex files.
+    const std::vector<const DexFile*>& dex_files = compiler_options_->dex_files_for_oat_file_;
+    size_t num_previous_dex_files = previous_vdex_file_->GetNumberOfDexFiles();
+    size_t num_unchanged = 0u;
+    unchanged_in_previous_vdex_.assign(dex_files.size(), false);
+    for (size_t i = 0; i < dex_files.size() && i < num_previous_dex_files; i++) {
+      if (dex_files[i]->GetLocationChecksum() == previous_vdex_file_->GetLocationChecksum(i)) {
+        unchanged_in_previous_vdex_[i] = true;
+        ++num_unchanged;
+      }
+    }
+    LOG(INFO) << "Reusing the verification of " << num_unchanged << " out of "
+              << dex_files.size() << " dex files from the previous vdex";
+    if (num_unchanged == 0u) {
+      previous_vdex_file_.reset();
+    }
+  }
+
   // If we need to keep the oat file open for the image writer.
   bool ShouldKeepOatFileOpen() const {
     return IsImage() && oat_fd_ != File::kInvalidFd;
@@ -2925,6 +3003,11 @@ class Dex2Oat final {
   std::string input_vdex_;
   std::string output_vdex_;
   std::unique_ptr<VdexFile> input_vdex_file_;
+  int previous_vdex_fd_;
+  std::string previous_vdex_;
+  std::unique_ptr<VdexFile> previous_vdex_file_;
+  // For each dex file to compile, whether it is unchanged in `previous_vdex_file_`.
+  std::vector<bool> unchanged_in_previous_vdex_;
   int dm_fd_;
   std::string dm_file_location_;
   std::unique_ptr<ZipArchive> dm_file_;
@@ -117,6 +117,16 @@ static void AddGeneratedArtifactMappings(Builder& builder) {
           .WithType<std::string>()
           .WithHelp("specifies the vdex input source via a filename.")
           .IntoKey(M::InputVdex)
+      .Define("--previous-vdex-fd=_")
+          .WithType<int>()
+          .WithHelp("specifies, via a file descriptor, the vdex of a previous version of the\n"
+                    "dex files. The verification results of the dex files that are unchanged\n"
+                    "are reused, the other dex files are verified again.")
+          .IntoKey(M::PreviousVdexFd)
+      .Define("--previous-vdex=_")
+          .WithType<std::string>()
+          .WithHelp("same as --previous-vdex-fd, but via a filename.")
+          .IntoKey(M::PreviousVdex)
       .Define("--output-vdex-fd=_")
           .WithHelp("specifies the vdex output destination via a file descriptor.")
           .WithType<int>()
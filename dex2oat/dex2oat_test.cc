@@ -1503,6 +1503,39 @@ TEST_F(Dex2oatTest, DontExtract) {
   generate_and_check(CompilerFilter::Filter::kVerify);
 }
 
+TEST_F(Dex2oatTest, PreviousVdex) {
+  std::unique_ptr<const DexFile> dex(OpenTestDexFile("ManyMethods"));
+  const std::string out_dir = GetScratchDir();
+  const std::string dex_location = dex->GetLocation();
+  const std::string previous_odex_location = out_dir + "/previous.odex";
+  const std::string previous_vdex_location = out_dir + "/previous.vdex";
+  ASSERT_TRUE(GenerateOdexForTest(dex_location,
+                                  previous_odex_location,
+                                  CompilerFilter::Filter::kVerify,
+                                  {},
+                                  /*expect_success=*/true,
+                                  /*use_fd=*/false,
+                                  /*use_zip_fd=*/false,
+                                  [](const OatFile&) {}));
+
+  // Compile again with the previous vdex, the unchanged dex file is fast verified.
+  output_.clear();
+  ASSERT_TRUE(GenerateOdexForTest(dex_location,
+                                  out_dir + "/base.odex",
+                                  CompilerFilter::Filter::kVerify,
+                                  {"--dump-timings",
+                                   "--previous-vdex=" + previous_vdex_location,
+                                   // Pass -Xuse-stderr-logger have dex2oat output in output_ on
+                                   // target.
+                                   "--runtime-arg",
+                                   "-Xuse-stderr-logger"},
+                                  /*expect_success=*/true,
+                                  /*use_fd=*/false,
+                                  /*use_zip_fd=*/false,
+                                  [](const OatFile&) {}));
+  EXPECT_NE(output_.find("Fast Verify"), std::string::npos) << output_;
+}
+
 // Test that compact dex generation with invalid dex files doesn't crash dex2oat. b/75970654
 TEST_F(Dex2oatTest, CompactDexInvalidSource) {
   ScratchFile invalid_dex;
@@ -22,10 +22,14 @@
 #include <malloc.h>  // For mallinfo
 #endif
 
+#include <algorithm>
+#include <sstream>
 #include <string_view>
 #include <vector>
 
+#include "android-base/file.h"
 #include "android-base/logging.h"
+#include "android-base/parseint.h"
 #include "android-base/strings.h"
 
 #include "art_field-inl.h"
@@ -35,6 +39,7 @@
 #include "base/bit_vector.h"
 #include "base/hash_set.h"
 #include "base/logging.h"  // For VLOG
+#include "base/mem_map.h"
 #include "base/pointer_size.h"
 #include "base/stl_util.h"
 #include "base/systrace.h"
@@ -61,6 +66,7 @@
 #include "gc/space/image_space.h"
 #include "gc/space/space.h"
 #include "handle_scope-inl.h"
+#include "imt_conflict_table.h"
 #include "intrinsics_enum.h"
 #include "intrinsics_list.h"
 #include "jni/jni_internal.h"
@@ -124,6 +130,9 @@ class CompilerDriver::AOTCompilationStats {
     DumpStat(resolved_local_static_fields_, resolved_static_fields_ + unresolved_static_fields_,
              "static fields local to a class");
     DumpStat(safe_casts_, not_safe_casts_, "check-casts removed based on type information");
+    DumpStat(reused_boot_jni_stubs_,
+             compiled_jni_stubs_,
+             "native methods using a boot image JNI stub instead of a compiled one");
     // Note, the code below subtracts the stat value so that when added to the stat value we have
     // 100% of samples. TODO: clean this up.
     DumpStat(type_based_devirtualization_,
@@ -220,6 +229,18 @@ class CompilerDriver::AOTCompilationStats {
     not_safe_casts_++;
   }
 
+  // A native method uses a JNI stub from the boot image.
+  void ReusedBootJniStub() REQUIRES(!stats_lock_) {
+    STATS_LOCK();
+    reused_boot_jni_stubs_++;
+  }
+
+  // A native method needs its own compiled JNI stub.
+  void CompiledJniStub() REQUIRES(!stats_lock_) {
+    STATS_LOCK();
+    compiled_jni_stubs_++;
+  }
+
   // Register a class status.
   void AddClassStatus(ClassStatus status) REQUIRES(!stats_lock_) {
     STATS_LOCK();
@@ -247,6 +268,9 @@ class CompilerDriver::AOTCompilationStats {
   size_t safe_casts_ = 0u;
   size_t not_safe_casts_ = 0u;
 
+  size_t reused_boot_jni_stubs_ = 0u;
+  size_t compiled_jni_stubs_ = 0u;
+
   size_t class_status_count_[static_cast<size_t>(ClassStatus::kLast) + 1] = {};
 
   DISALLOW_COPY_AND_ASSIGN(AOTCompilationStats);
@@ -489,9 +513,15 @@ static void CompileMethodQuick(
           InstructionSetHasGenericJniStub(compiler_options.GetInstructionSet())) {
         // Leaving this empty will trigger the generic JNI version
       } else {
-        // Query any JNI optimization annotations such as @FastNative or @CriticalNative.
-        access_flags |= annotations::GetNativeMethodAnnotationAccessFlags(
+        // Query any JNI optimization annotations such as @FastNative or @CriticalNative,
+        // or a promotion to @FastNative, the same way the class linker does.
+        uint32_t native_access_flags = annotations::GetNativeMethodAnnotationAccessFlags(
             dex_file, dex_file.GetClassDef(class_def_idx), method_idx);
+        if (native_access_flags == 0u) {
+          native_access_flags = Runtime::Current()->GetFastNativeMethodAccessFlags(
+              dex_file, method_idx, access_flags);
+        }
+        access_flags |= native_access_flags;
         const void* boot_jni_stub = nullptr;
         if (!Runtime::Current()->GetHeap()->GetBootImageSpaces().empty()) {
           // Skip the compilation for native method if found an usable boot JNI stub.
@@ -504,6 +534,7 @@ static void CompileMethodQuick(
               driver->GetCompiler()->JniCompile(access_flags, method_idx, dex_file, dex_cache);
           CHECK(compiled_method != nullptr);
         }
+        driver->ProcessedNativeMethod(/*reused_boot_jni_stub=*/ boot_jni_stub != nullptr);
       }
     } else if ((access_flags & kAccAbstract) != 0) {
       // Abstract methods don't have code.
@@ -777,8 +808,8 @@ void CompilerDriver::PrepareDexFilesForOatFile([[maybe_unused]] TimingLogger* ti
 
 class CreateConflictTablesVisitor : public ClassVisitor {
  public:
-  explicit CreateConflictTablesVisitor(VariableSizedHandleScope& hs)
-      : hs_(hs) {}
+  CreateConflictTablesVisitor(VariableSizedHandleScope& hs, bool create_conflict_tables)
+      : hs_(hs), create_conflict_tables_(create_conflict_tables), num_deferred_tables_(0u) {}
 
   bool operator()(ObjPtr<mirror::Class> klass) override
       REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -798,6 +829,10 @@ class CreateConflictTablesVisitor : public ClassVisitor {
     }
   }
 
+  size_t GetNumDeferredTables() const {
+    return num_deferred_tables_;
+  }
+
  private:
   void FillIMTAndConflictTables(ObjPtr<mirror::Class> klass)
       REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -811,12 +846,15 @@ class CreateConflictTablesVisitor : public ClassVisitor {
       FillIMTAndConflictTables(klass->GetSuperClass());
     }
     if (!klass->IsTemp()) {
-      Runtime::Current()->GetClassLinker()->FillIMTAndConflictTables(klass);
+      num_deferred_tables_ += Runtime::Current()->GetClassLinker()->FillIMTAndConflictTables(
+          klass, create_conflict_tables_);
     }
     visited_classes_.insert(klass.Ptr());
   }
 
   VariableSizedHandleScope& hs_;
+  const bool create_conflict_tables_;
+  size_t num_deferred_tables_;
   std::vector<Handle<mirror::Class>> to_visit_;
   HashSet<mirror::Class*> visited_classes_;
 };
@@ -913,12 +951,27 @@ void CompilerDriver::PreCompile(jobject class_loader,
     }
     {
       // Create conflict tables, as the runtime expects boot image classes to
-      // always have their conflict tables filled.
+      // always have their conflict tables filled. App image classes can have their
+      // conflict tables created on first use at runtime, so we do not write tables
+      // for interface methods that are never called to the image.
+      TimingLogger::ScopedTiming t("CreateConflictTables", timings);
       ScopedObjectAccess soa(Thread::Current());
       VariableSizedHandleScope hs(soa.Self());
-      CreateConflictTablesVisitor visitor(hs);
+      const bool create_conflict_tables =
+          GetCompilerOptions().IsBootImage() || GetCompilerOptions().IsBootImageExtension();
+      CreateConflictTablesVisitor visitor(hs, create_conflict_tables);
       Runtime::Current()->GetClassLinker()->VisitClassesWithoutClassesLock(&visitor);
       visitor.FillAllIMTAndConflictTables();
+      if (!create_conflict_tables) {
+        // Each deferred table would hold at least two entries and needs its own conflict method.
+        const PointerSize pointer_size =
+            GetInstructionSetPointerSize(GetCompilerOptions().GetInstructionSet());
+        const size_t min_bytes_per_table = ArtMethod::Size(pointer_size) +
+                                           ImtConflictTable::ComputeSize(2u, pointer_size);
+        VLOG(compiler) << "Deferred " << visitor.GetNumDeferredTables()
+                       << " IMT conflict tables to runtime, saving at least "
+                       << visitor.GetNumDeferredTables() * min_bytes_per_table << " bytes";
+      }
     }
 
     if (GetCompilerOptions().IsBootImage() || GetCompilerOptions().IsBootImageExtension()) {
@@ -1484,6 +1537,14 @@ void CompilerDriver::ProcessedInstanceField(bool resolved) {
   }
 }
 
+void CompilerDriver::ProcessedNativeMethod(bool reused_boot_jni_stub) {
+  if (reused_boot_jni_stub) {
+    stats_->ReusedBootJniStub();
+  } else {
+    stats_->CompiledJniStub();
+  }
+}
+
 void CompilerDriver::ProcessedStaticField(bool resolved, bool local) {
   if (!resolved) {
     stats_->UnresolvedStaticField();
@@ -1536,6 +1597,21 @@ bool CompilerDriver::ComputeInstanceFieldInfo(uint32_t field_idx, const DexCompi
   }
 }
 
+// Returns the current resident set size of the process in bytes, or 0 if it cannot be read.
+static size_t GetResidentSetSize() {
+  std::string statm;
+  if (!android::base::ReadFileToString("/proc/self/statm", &statm)) {
+    return 0u;
+  }
+  // The second field is the number of resident pages.
+  std::vector<std::string> fields = android::base::Split(statm, " ");
+  size_t resident_pages;
+  if (fields.size() < 2u || !android::base::ParseUint(fields[1], &resident_pages)) {
+    return 0u;
+  }
+  return resident_pages * MemMap::GetPageSize();
+}
+
 class CompilationVisitor {
  public:
   virtual ~CompilationVisitor() {}
@@ -1588,9 +1664,12 @@ class ParallelCompilationManager {
     CHECK_GT(work_units, 0U);
 
     index_.store(begin, std::memory_order_relaxed);
+    throttled_work_units_.store(0u, std::memory_order_relaxed);
+    worker_busy_ns_.assign(work_units, 0u);
     for (size_t i = 0; i < work_units; ++i) {
-      thread_pool_->AddTask(self, new ForAllClosureLambda<Fn>(this, end, fn));
+      thread_pool_->AddTask(self, new ForAllClosureLambda<Fn>(this, end, fn, i));
     }
+    uint64_t start_ns = NanoTime();
     thread_pool_->StartWorkers(self);
 
     // Ensure we're suspended while we're blocked waiting for the other threads to finish (worker
@@ -1599,6 +1678,7 @@ class ParallelCompilationManager {
 
     // Wait for all the worker threads to finish.
     thread_pool_->Wait(self, true, false);
+    wall_ns_ = NanoTime() - start_ns;
 
     // And stop the workers accepting jobs.
     thread_pool_->StopWorkers(self);
@@ -1608,17 +1688,56 @@ class ParallelCompilationManager {
     return index_.fetch_add(1, std::memory_order_seq_cst);
   }
 
+  // Set the resident set size above which work units other than the first one stop taking new
+  // work items in subsequent `ForAllLambda()` calls, 0 for no limit. The first work unit always
+  // continues, so all work is eventually done, just with less memory held by in-flight items.
+  void SetRssLimit(size_t rss_limit_bytes) {
+    rss_limit_bytes_ = rss_limit_bytes;
+  }
+
+  size_t GetThrottledWorkUnits() const {
+    return throttled_work_units_.load(std::memory_order_relaxed);
+  }
+
+  // Log how long each work unit of the last `ForAllLambda()` spent running the visitor against
+  // the wall time of the whole phase. The gap between the busiest and the least busy unit is the
+  // time lost to the tail of the work list.
+  void DumpWorkerTimings(const char* name) const {
+    DCHECK(!worker_busy_ns_.empty());
+    uint64_t min_busy_ns = *std::min_element(worker_busy_ns_.begin(), worker_busy_ns_.end());
+    uint64_t max_busy_ns = *std::max_element(worker_busy_ns_.begin(), worker_busy_ns_.end());
+    std::ostringstream oss;
+    oss << name << " " << dex_file_->GetLocation() << ": wall " << PrettyDuration(wall_ns_)
+        << ", tail " << PrettyDuration(max_busy_ns - min_busy_ns) << ", busy/idle per worker:";
+    for (uint64_t busy_ns : worker_busy_ns_) {
+      oss << " " << PrettyDuration(busy_ns) << "/"
+          << PrettyDuration(wall_ns_ > busy_ns ? wall_ns_ - busy_ns : 0u);
+    }
+    LOG(INFO) << oss.str();
+  }
+
  private:
   template <typename Fn>
   class ForAllClosureLambda : public Task {
    public:
-    ForAllClosureLambda(ParallelCompilationManager* manager, size_t end, Fn fn)
+    ForAllClosureLambda(ParallelCompilationManager* manager, size_t end, Fn fn, size_t unit)
         : manager_(manager),
           end_(end),
-          fn_(fn) {}
+          fn_(fn),
+          unit_(unit) {}
 
     void Run(Thread* self) override {
-      while (true) {
+      // Reading the RSS needs a syscall, so check it only every few work items.
+      static constexpr size_t kRssCheckInterval = 16u;
+      uint64_t start_ns = NanoTime();
+      for (size_t count = 1u; ; ++count) {
+        if (manager_->rss_limit_bytes_ != 0u &&
+            unit_ != 0u &&
+            count % kRssCheckInterval == 0u &&
+            GetResidentSetSize() > manager_->rss_limit_bytes_) {
+          manager_->throttled_work_units_.fetch_add(1u, std::memory_order_relaxed);
+          break;
+        }
         const size_t index = manager_->NextIndex();
         if (UNLIKELY(index >= end_)) {
           break;
@@ -1626,6 +1745,7 @@ class ParallelCompilationManager {
         fn_(index);
         self->AssertNoPendingException();
       }
+      manager_->worker_busy_ns_[unit_] = NanoTime() - start_ns;
     }
 
     void Finalize() override {
@@ -1636,9 +1756,16 @@ class ParallelCompilationManager {
     ParallelCompilationManager* const manager_;
     const size_t end_;
     Fn fn_;
+    const size_t unit_;
   };
 
   AtomicInteger index_;
+  size_t rss_limit_bytes_ = 0u;
+  std::atomic<size_t> throttled_work_units_ = 0u;
+  // Time each work unit of the last `ForAllLambda()` spent taking and running work items. Each
+  // unit writes only its own slot and the values are read after `ThreadPool::Wait()`.
+  std::vector<uint64_t> worker_busy_ns_;
+  uint64_t wall_ns_ = 0u;
   ClassLinker* const class_linker_;
   const jobject class_loader_;
   CompilerDriver* const compiler_;
@@ -1832,14 +1959,28 @@ static void LoadAndUpdateStatus(const ClassAccessor& accessor,
 }
 
 bool CompilerDriver::FastVerify(jobject jclass_loader,
-                                const std::vector<const DexFile*>& dex_files,
-                                TimingLogger* timings) {
+                                const std::vector<const DexFile*>& all_dex_files,
+                                TimingLogger* timings,
+                                /*out*/ std::vector<const DexFile*>* dex_files_to_verify) {
   CompilerCallbacks* callbacks = Runtime::Current()->GetCompilerCallbacks();
   verifier::VerifierDeps* verifier_deps = callbacks->GetVerifierDeps();
   // If there exist VerifierDeps that aren't the ones we just created to output, use them to verify.
   if (verifier_deps == nullptr || verifier_deps->OutputOnly()) {
     return false;
   }
+  // Only the dex files unchanged since the vdex the VerifierDeps were read from have stored
+  // dependencies, see `--previous-vdex`.
+  std::vector<const DexFile*> dex_files;
+  for (const DexFile* dex_file : all_dex_files) {
+    if (verifier_deps->HasStoredData(*dex_file)) {
+      dex_files.push_back(dex_file);
+    } else {
+      dex_files_to_verify->push_back(dex_file);
+    }
+  }
+  if (dex_files.empty()) {
+    return false;
+  }
   TimingLogger::ScopedTiming t("Fast Verify", timings);
 
   ScopedObjectAccess soa(Thread::Current());
@@ -1916,7 +2057,10 @@ bool CompilerDriver::FastVerify(jobject jclass_loader,
 void CompilerDriver::Verify(jobject jclass_loader,
                             const std::vector<const DexFile*>& dex_files,
                             TimingLogger* timings) {
-  if (FastVerify(jclass_loader, dex_files, timings)) {
+  std::vector<const DexFile*> dex_files_to_verify;
+  if (!FastVerify(jclass_loader, dex_files, timings, &dex_files_to_verify)) {
+    dex_files_to_verify = dex_files;
+  } else if (dex_files_to_verify.empty()) {
     return;
   }
 
@@ -1944,7 +2088,7 @@ void CompilerDriver::Verify(jobject jclass_loader,
   ThreadPool* verify_thread_pool =
       force_determinism ? single_thread_pool_.get() : parallel_thread_pool_.get();
   size_t verify_thread_count = force_determinism ? 1U : parallel_thread_count_;
-  for (const DexFile* dex_file : dex_files) {
+  for (const DexFile* dex_file : dex_files_to_verify) {
     CHECK(dex_file != nullptr);
     VerifyDexFile(jclass_loader,
                   *dex_file,
@@ -2196,7 +2340,11 @@ void CompilerDriver::SetVerifiedDexFile(jobject class_loader,
 
 class InitializeClassVisitor : public CompilationVisitor {
  public:
-  explicit InitializeClassVisitor(const ParallelCompilationManager* manager) : manager_(manager) {}
+  // With `trivial_only`, only initialize the classes that do not need to run any code, i.e.
+  // without a class initializer or static field values, and whose superclasses are already
+  // initialized. This does not need a transaction and can run on multiple threads.
+  InitializeClassVisitor(const ParallelCompilationManager* manager, bool trivial_only)
+      : manager_(manager), trivial_only_(trivial_only) {}
 
   void Visit(size_t class_def_index) override {
     ScopedTrace trace(__FUNCTION__);
@@ -2217,7 +2365,9 @@ class InitializeClassVisitor : public CompilationVisitor {
       if (!SkipClass(manager_->GetClassLoader(), dex_file, klass.Get())) {
         TryInitializeClass(soa.Self(), klass, class_loader);
       }
-      manager_->GetCompiler()->stats_->AddClassStatus(klass->GetStatus());
+      if (!trivial_only_) {
+        manager_->GetCompiler()->stats_->AddClassStatus(klass->GetStatus());
+      }
     }
     // Clear any class not found or verification exceptions.
     soa.Self()->ClearException();
@@ -2260,6 +2410,10 @@ class InitializeClassVisitor : public CompilationVisitor {
       // or static fields.
       class_linker->EnsureInitialized(self, klass, false, false);
       DCHECK(!self->IsExceptionPending());
+      if (trivial_only_) {
+        // The class status is recorded by the full initialization pass.
+        return;
+      }
       old_status = klass->GetStatus();
       if (!klass->IsInitialized()) {
         // We don't want non-trivial class initialization occurring on multiple threads due to
@@ -2614,6 +2768,7 @@ class InitializeClassVisitor : public CompilationVisitor {
   }
 
   const ParallelCompilationManager* const manager_;
+  const bool trivial_only_;
 };
 
 void CompilerDriver::InitializeClasses(jobject jni_class_loader,
@@ -2635,12 +2790,18 @@ void CompilerDriver::InitializeClasses(jobject jni_class_loader,
   if (GetCompilerOptions().IsBootImage() ||
       GetCompilerOptions().IsBootImageExtension() ||
       GetCompilerOptions().IsAppImage()) {
+    if (init_thread_count > 1U) {
+      // Classes that do not run any code when initialized do not need a transaction, so
+      // initialize them in parallel first. This leaves less work for the serial pass below.
+      InitializeClassVisitor trivial_visitor(&context, /* trivial_only= */ true);
+      context.ForAll(0, dex_file.NumClassDefs(), &trivial_visitor, init_thread_count);
+    }
     // Set the concurrency thread to 1 to support initialization for images since transaction
     // doesn't support multithreading now.
     // TODO: remove this when transactional mode supports multithreading.
     init_thread_count = 1U;
   }
-  InitializeClassVisitor visitor(&context);
+  InitializeClassVisitor visitor(&context, /* trivial_only= */ false);
   context.ForAll(0, dex_file.NumClassDefs(), &visitor, init_thread_count);
 
   // Make initialized classes visibly initialized.
@@ -2660,6 +2821,39 @@ void CompilerDriver::InitializeClasses(jobject class_loader,
   }
 }
 
+// Returns the class def indexes of `dex_file`, with the classes containing the most code to
+// compile first. Compiling a huge method takes much longer than compiling a typical class, so
+// starting with the biggest classes keeps one of them from being the last work item that all
+// the other threads wait for.
+static std::vector<uint32_t> GetClassDefsByDecreasingCodeSize(
+    const DexFile& dex_file, const CompilerOptions& compiler_options) {
+  std::vector<std::pair<size_t, uint32_t>> code_sizes;
+  code_sizes.reserve(dex_file.NumClassDefs());
+  for (uint32_t class_def_index = 0, num_class_defs = dex_file.NumClassDefs();
+       class_def_index != num_class_defs;
+       ++class_def_index) {
+    size_t code_size = 0u;
+    ClassAccessor accessor(dex_file, class_def_index);
+    for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+      size_t method_code_size = method.GetInstructions().InsnsSizeInCodeUnits();
+      // Huge methods are not compiled.
+      if (!compiler_options.IsHugeMethod(method_code_size)) {
+        code_size += method_code_size;
+      }
+    }
+    code_sizes.emplace_back(code_size, class_def_index);
+  }
+  std::stable_sort(code_sizes.begin(), code_sizes.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.first > rhs.first;
+  });
+  std::vector<uint32_t> class_defs;
+  class_defs.reserve(code_sizes.size());
+  for (const auto& [code_size, class_def_index] : code_sizes) {
+    class_defs.push_back(class_def_index);
+  }
+  return class_defs;
+}
+
 template <typename CompileFn>
 static void CompileDexFile(CompilerDriver* driver,
                            jobject class_loader,
@@ -2746,7 +2940,25 @@ static void CompileDexFile(CompilerDriver* driver,
                  profile_index);
     }
   };
-  context.ForAllLambda(0, dex_file.NumClassDefs(), compile, thread_count);
+  if (thread_count > 1u) {
+    std::vector<uint32_t> class_defs = GetClassDefsByDecreasingCodeSize(dex_file, compiler_options);
+    context.SetRssLimit(static_cast<size_t>(compiler_options.GetCompileRssLimitMb()) * MB);
+    context.ForAllLambda(0,
+                         class_defs.size(),
+                         [&class_defs, &compile](size_t index) { compile(class_defs[index]); },
+                         thread_count);
+    if (context.GetThrottledWorkUnits() != 0u) {
+      LOG(INFO) << "Compilation of " << dex_file.GetLocation() << " stopped "
+                << context.GetThrottledWorkUnits() << " of " << thread_count
+                << " work units after exceeding the RSS limit of "
+                << compiler_options.GetCompileRssLimitMb() << "MiB";
+    }
+    if (compiler_options.GetDumpTimings()) {
+      context.DumpWorkerTimings(timing_name);
+    }
+  } else {
+    context.ForAllLambda(0, dex_file.NumClassDefs(), compile, thread_count);
+  }
 }
 
 void CompilerDriver::Compile(jobject class_loader,
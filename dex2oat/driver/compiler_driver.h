@@ -172,6 +172,7 @@ class CompilerDriver {
 
   void ProcessedInstanceField(bool resolved);
   void ProcessedStaticField(bool resolved, bool local);
+  void ProcessedNativeMethod(bool reused_boot_jni_stub);
 
   // Can we fast path instance field access? Computes field's offset and volatility.
   bool ComputeInstanceFieldInfo(uint32_t field_idx, const DexCompilationUnit* mUnit, bool is_put,
@@ -241,11 +242,13 @@ class CompilerDriver {
                       TimingLogger* timings)
       REQUIRES(!Locks::mutator_lock_);
 
-  // Do fast verification through VerifierDeps if possible. Return whether
-  // verification was successful.
+  // Do fast verification through VerifierDeps if possible, for the dex files that have
+  // stored dependencies. Return whether verification was successful; `dex_files_to_verify`
+  // then receives the dex files without stored dependencies, which need a full verification.
   bool FastVerify(jobject class_loader,
                   const std::vector<const DexFile*>& dex_files,
-                  TimingLogger* timings);
+                  TimingLogger* timings,
+                  /*out*/ std::vector<const DexFile*>* dex_files_to_verify);
 
   void Verify(jobject class_loader,
               const std::vector<const DexFile*>& dex_files,
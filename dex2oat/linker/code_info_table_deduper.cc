@@ -86,7 +86,7 @@ size_t CodeInfoTableDeduper::Dedupe(const uint8_t* code_info_data) {
         uint32_t table_bit_start = start_bit_offset + bit_table_bit_starts[i];
         BitMemoryRegion region(
             const_cast<uint8_t*>(writer_.data()), table_bit_start, table_bit_size);
-        DedupeSetEntry entry{table_bit_start, table_bit_size};
+        DedupeSetEntry entry{table_bit_start, table_bit_size, DataHash()(region)};
         auto [it, inserted] = dedupe_set_.insert(entry);
         dedupe_entries[i] = &*it;
         if (!inserted) {
@@ -31,7 +31,7 @@ class CodeInfoTableDeduper {
       : writer_(output),
         dedupe_set_(kMinLoadFactor,
                     kMaxLoadFactor,
-                    DedupeSetEntryHash(output),
+                    DedupeSetEntryHash(),
                     DedupeSetEntryEquals(output)) {
     DCHECK_EQ(output->size(), 0u);
   }
@@ -43,15 +43,19 @@ class CodeInfoTableDeduper {
   size_t Dedupe(const uint8_t* code_info);
 
  private:
+  // The hash of the table data is computed once on insertion and kept in the entry, so that
+  // resizing the `dedupe_set_` does not rehash the data and most mismatches are rejected
+  // without comparing the tables bit by bit.
   struct DedupeSetEntry {
     uint32_t bit_start;
     uint32_t bit_size;
+    uint32_t hash;
   };
 
   class DedupeSetEntryEmpty {
    public:
     void MakeEmpty(DedupeSetEntry& item) const {
-      item = {0u, 0u};
+      item = {0u, 0u, 0u};
     }
     bool IsEmpty(const DedupeSetEntry& item) const {
       return item.bit_size == 0u;
@@ -60,14 +64,9 @@ class CodeInfoTableDeduper {
 
   class DedupeSetEntryHash {
    public:
-    explicit DedupeSetEntryHash(std::vector<uint8_t>* output) : output_(output) {}
-
     uint32_t operator()(const DedupeSetEntry& item) const {
-      return DataHash()(BitMemoryRegion(output_->data(), item.bit_start, item.bit_size));
+      return item.hash;
     }
-
-   private:
-    std::vector<uint8_t>* const output_;
   };
 
   class DedupeSetEntryEquals {
@@ -77,7 +76,8 @@ class CodeInfoTableDeduper {
     bool operator()(const DedupeSetEntry& lhs, const DedupeSetEntry& rhs) const {
       DCHECK_NE(lhs.bit_size, 0u);
       DCHECK_NE(rhs.bit_size, 0u);
-      return lhs.bit_size == rhs.bit_size &&
+      return lhs.hash == rhs.hash &&
+             lhs.bit_size == rhs.bit_size &&
              BitMemoryRegion::Equals(
                  BitMemoryRegion(output_->data(), lhs.bit_start, lhs.bit_size),
                  BitMemoryRegion(output_->data(), rhs.bit_start, rhs.bit_size));
@@ -1142,7 +1142,7 @@ class ImageWriter::PruneClassesVisitor : public ClassVisitor {
     // table also contains class sets from boot images we're compiling against but we are not
     // pruning these boot image classes, so all classes to remove are in the last set.
     DCHECK(!class_table->classes_.empty());
-    ClassTable::ClassSet& last_class_set = class_table->classes_.back();
+    ClassTable::ClassSet& last_class_set = *class_table->classes_.back();
     for (mirror::Class* klass : classes_to_prune_) {
       uint32_t hash = klass->DescriptorHash();
       auto it = last_class_set.FindWithHash(ClassTable::TableSlot(klass, hash), hash);
@@ -1150,10 +1150,10 @@ class ImageWriter::PruneClassesVisitor : public ClassVisitor {
       last_class_set.erase(it);
       DCHECK(std::none_of(class_table->classes_.begin(),
                           class_table->classes_.end(),
-                          [klass, hash](ClassTable::ClassSet& class_set)
+                          [klass, hash](const std::unique_ptr<ClassTable::ClassSet>& class_set)
                               REQUIRES_SHARED(Locks::mutator_lock_) {
                             ClassTable::TableSlot slot(klass, hash);
-                            return class_set.FindWithHash(slot, hash) != class_set.end();
+                            return class_set->FindWithHash(slot, hash) != class_set->end();
                           }));
     }
     return defined_class_count_;
@@ -1716,7 +1716,7 @@ class ImageWriter::LayoutHelper::CollectClassesVisitor {
       ClassTable* app_class_table = app_class_loader->GetClassTable();
       ReaderMutexLock lock(self, app_class_table->lock_);
       DCHECK_EQ(app_class_table->classes_.size(), 1u);
-      const ClassTable::ClassSet& app_class_set = app_class_table->classes_[0];
+      const ClassTable::ClassSet& app_class_set = *app_class_table->classes_[0];
       DCHECK_GE(app_class_set.size(), image_info.class_table_size_);
       boot_image_classes.reserve(app_class_set.size() - image_info.class_table_size_);
       for (const ClassTable::TableSlot& slot : app_class_set) {
@@ -3084,7 +3084,7 @@ void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
       ReaderMutexLock lock(Thread::Current(), temp_class_table.lock_);
       CHECK(!temp_class_table.classes_.empty());
       // The ClassSet was inserted at the beginning.
-      CHECK_EQ(temp_class_table.classes_[0].size(), table.size());
+      CHECK_EQ(temp_class_table.classes_[0]->size(), table.size());
     }
   }
 }
@@ -43,6 +43,7 @@
 #include "debug/method_debug_info.h"
 #include "dex/art_dex_file_loader.h"
 #include "dex/class_accessor-inl.h"
+#include "dex/code_item_accessors-inl.h"
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_loader.h"
 #include "dex/dex_file_types.h"
@@ -1064,9 +1065,6 @@ class OatWriter::LayoutCodeMethodVisitor final : public OatDexMethodVisitor {
         // Note: Bin-to-bin order does not matter. If the kernel does or does not read-ahead
         // any memory, it only goes into the buffer cache and does not grow the PSS until the
         // first time that memory is referenced in the process.
-        constexpr uint32_t kHotBit = 1u;
-        constexpr uint32_t kStartupBit = 2u;
-        constexpr uint32_t kPostStartupBit = 4u;
         hotness_bits =
             (pci->IsHotMethod(profile_index_, method_index) ? kHotBit : 0u) |
             (pci->IsStartupMethod(profile_index_, method_index) ? kStartupBit : 0u) |
@@ -1107,6 +1105,9 @@ class OatWriter::LayoutCodeMethodVisitor final : public OatDexMethodVisitor {
       // Since most methods will have the same ordering criteria,
       // we preserve the original insertion order within the same sort order.
       std::stable_sort(ordered_methods_.begin(), ordered_methods_.end());
+      if (!kOatWriterForceOatCodeLayout) {
+        OrderHotMethodsByCallGraph();
+      }
     } else {
       // The profile-less behavior is as if every method had 0 hotness
       // associated with it.
@@ -1120,6 +1121,104 @@ class OatWriter::LayoutCodeMethodVisitor final : public OatDexMethodVisitor {
   }
 
  private:
+  static constexpr uint32_t kHotBit = 1u;
+  static constexpr uint32_t kStartupBit = 2u;
+  static constexpr uint32_t kPostStartupBit = 4u;
+
+  // Within each bin of hot methods, place a method's callees right after it, in
+  // depth-first order, so that methods calling each other share code pages.
+  void OrderHotMethodsByCallGraph() {
+    TimingLogger::ScopedTiming split("OrderHotMethodsByCallGraph", writer_->timings_);
+    size_t num_startup = 0u;
+    size_t num_hot = 0u;
+    size_t num_moved = 0u;
+    for (auto bin_begin = ordered_methods_.begin(); bin_begin != ordered_methods_.end(); ) {
+      const uint32_t hotness_bits = bin_begin->hotness_bits;
+      auto bin_end = std::find_if(bin_begin, ordered_methods_.end(), [&](const auto& data) {
+        return data.hotness_bits != hotness_bits;
+      });
+      size_t bin_size = static_cast<size_t>(std::distance(bin_begin, bin_end));
+      if ((hotness_bits & kStartupBit) != 0u) {
+        num_startup += bin_size;
+      }
+      if ((hotness_bits & kHotBit) != 0u) {
+        num_hot += bin_size;
+        num_moved += OrderByCallGraph(bin_begin, bin_end);
+      }
+      bin_begin = bin_end;
+    }
+    VLOG(compiler) << "Oat code layout: " << ordered_methods_.size() << " methods, "
+                   << num_startup << " startup, " << num_hot << " hot, "
+                   << num_moved << " hot methods reordered by call graph";
+  }
+
+  // Reorders [begin, end) by a depth-first walk of the static call graph restricted
+  // to the methods in the range. Returns the number of methods whose position changed.
+  static size_t OrderByCallGraph(OrderedMethodList::iterator begin,
+                                 OrderedMethodList::iterator end) {
+    const size_t size = static_cast<size_t>(std::distance(begin, end));
+    if (size < 2u) {
+      return 0u;
+    }
+    SafeMap<MethodReference, size_t> indexes;
+    for (size_t i = 0; i != size; ++i) {
+      const MethodReference& ref = begin[i].method_reference;
+      if (indexes.find(ref) == indexes.end()) {
+        indexes.Put(ref, i);
+      }
+    }
+
+    std::vector<bool> visited(size, false);
+    std::vector<size_t> order;
+    order.reserve(size);
+    std::vector<size_t> worklist;
+    std::vector<size_t> callees;
+    for (size_t root = 0; root != size; ++root) {
+      worklist.push_back(root);
+      while (!worklist.empty()) {
+        size_t current = worklist.back();
+        worklist.pop_back();
+        if (visited[current]) {
+          continue;
+        }
+        visited[current] = true;
+        order.push_back(current);
+
+        const OrderedMethodData& data = begin[current];
+        if (data.code_item == nullptr) {
+          continue;
+        }
+        const DexFile* dex_file = data.method_reference.dex_file;
+        callees.clear();
+        for (const DexInstructionPcPair& inst :
+                 CodeItemInstructionAccessor(*dex_file, data.code_item)) {
+          if (!inst->IsInvoke() ||
+              inst->Opcode() == Instruction::INVOKE_CUSTOM ||
+              inst->Opcode() == Instruction::INVOKE_CUSTOM_RANGE) {
+            continue;
+          }
+          auto it = indexes.find(MethodReference(dex_file, inst->VRegB()));
+          if (it != indexes.end() && !visited[it->second]) {
+            callees.push_back(it->second);
+          }
+        }
+        // Push in reverse so that the first callee in the code is placed first.
+        worklist.insert(worklist.end(), callees.rbegin(), callees.rend());
+      }
+    }
+    DCHECK_EQ(order.size(), size);
+
+    size_t num_moved = 0u;
+    OrderedMethodList reordered;
+    reordered.reserve(size);
+    for (size_t i = 0; i != size; ++i) {
+      num_moved += (order[i] != i) ? 1u : 0u;
+      reordered.push_back(begin[order[i]]);
+    }
+    std::copy(reordered.begin(), reordered.end(), begin);
+    return num_moved;
+  }
+
   // Cached profile index for the current dex file.
   ProfileCompilationInfo::ProfileIndexType profile_index_;
   const DexFile* profile_index_dex_file_;
@@ -1360,6 +1459,7 @@ class OatWriter::InitMapMethodVisitor : public OatDexMethodVisitor {
 
       ArrayRef<const uint8_t> map = compiled_method->GetVmapTable();
       if (map.size() != 0u) {
+        input_size_ += map.size();
         size_t offset = offset_ + writer_->code_info_data_.size();
         if (kDeduplicate) {
           auto [it, inserted] = dedupe_code_info_.insert(std::make_pair(map.data(), offset));
@@ -1383,7 +1483,14 @@ class OatWriter::InitMapMethodVisitor : public OatDexMethodVisitor {
     return true;
   }
 
+  // Total size of the `CodeInfo`s of all visited methods before deduplication.
+  size_t GetInputSize() const {
+    return input_size_;
+  }
+
  private:
+  size_t input_size_ = 0u;
+
   // Deduplicate at CodeInfo level. The value is byte offset within code_info_data_.
   // This deduplicates the whole CodeInfo object without going into the inner tables.
   // The compiler already deduplicated the pointers but it did not dedupe the tables.
@@ -2006,6 +2113,9 @@ size_t OatWriter::InitOatMaps(size_t offset) {
     InitMapMethodVisitor</*kDeduplicate=*/ true> visitor(this, offset);
     bool success = VisitDexMethods(&visitor);
     DCHECK(success);
+    VLOG(compiler) << "CodeInfo deduplication saved "
+                   << PrettySize(visitor.GetInputSize() - code_info_data_.size())
+                   << " of " << PrettySize(visitor.GetInputSize());
   } else {
     InitMapMethodVisitor</*kDeduplicate=*/ false> visitor(this, offset);
     bool success = VisitDexMethods(&visitor);
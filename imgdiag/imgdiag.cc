@@ -80,6 +80,10 @@ std::ostream& operator<<(std::ostream& os, RemoteProcesses remotes) {
 }
 
 struct MappingData {
+  // The count of pages that are backed by memory, i.e. touched at least once.
+  size_t resident_pages = 0;
+  // The count of pages in the mapping.
+  size_t total_pages = 0;
   // The count of pages that are considered dirty by the OS.
   size_t dirty_pages = 0;
   // The count of pages that differ by at least one byte.
@@ -1463,6 +1467,17 @@ class ImgDiagDumper {
       // Virtual page number (for an absolute memory address)
       size_t virtual_page_idx = begin / MemMap::GetPageSize();
 
+      mapping_data->total_pages++;
+      bool is_present = false;
+      if (!IsPagePresent(image_pagemap_file_, virtual_page_idx, is_present, *error_msg)) {
+        return false;
+      }
+      if (!is_present) {
+        // Never touched, so it can be neither dirty nor shared.
+        continue;
+      }
+      mapping_data->resident_pages++;
+
       uint64_t page_count = 0xC0FFEE;
       // TODO: virtual_page_idx needs to be from the same process
       int dirtiness = (IsPageDirty(image_pagemap_file_,   // Image-diff-pid procmap
@@ -1505,7 +1520,13 @@ class ImgDiagDumper {
   void PrintMappingData(const MappingData& mapping_data, const ImageHeader& image_header) {
     std::ostream& os = *os_;
     // Print low-level (bytes, int32s, pages) statistics.
-    os << mapping_data.different_bytes << " differing bytes,\n  "
+    os << mapping_data.resident_pages << " of " << mapping_data.total_pages
+       << " pages are resident ("
+       << (mapping_data.total_pages != 0u
+               ? mapping_data.resident_pages * 100u / mapping_data.total_pages
+               : 0u)
+       << "% touched),\n  "
+       << mapping_data.different_bytes << " differing bytes,\n  "
        << mapping_data.different_int32s << " differing int32s,\n  "
        << mapping_data.different_pages << " differing pages,\n  "
        << mapping_data.dirty_pages << " pages are dirty;\n  "
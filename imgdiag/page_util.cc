@@ -72,6 +72,22 @@ bool GetPageFrameNumber(File& page_map_file,
       page_map_file, virtual_page_index, ArrayRef<uint64_t>(&page_frame_number, 1u), error_msg);
 }
 
+bool IsPagePresent(File& page_map_file,
+                   size_t virtual_page_index,
+                   /*out*/ bool& is_present,
+                   /*out*/ std::string& error_msg) {
+  uint64_t entry = 0;
+  if (!page_map_file.PreadFully(
+          &entry, kPageMapEntrySize, virtual_page_index * kPageMapEntrySize)) {
+    error_msg = StringPrintf("Failed to read virtual page index entry from %s, error: %s",
+                             page_map_file.GetPath().c_str(),
+                             strerror(errno));
+    return false;
+  }
+  is_present = (entry & kPagePresentMask) != 0u;
+  return true;
+}
+
 bool GetPageFrameNumbers(File& page_map_file,
                          size_t virtual_page_index,
                          /*out*/ ArrayRef<uint64_t> page_frame_numbers,
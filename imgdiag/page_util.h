@@ -27,6 +27,8 @@ namespace art {
 static constexpr size_t kPageMapEntrySize = sizeof(uint64_t);
 // bits 0-54 [in /proc/$pid/pagemap]
 static constexpr uint64_t kPageFrameNumberMask = (1ULL << 55) - 1;
+// bit 63 [in /proc/$pid/pagemap]
+static constexpr uint64_t kPagePresentMask = (1ULL << 63);
 
 static constexpr size_t kPageFlagsEntrySize = sizeof(uint64_t);
 static constexpr size_t kPageCountEntrySize = sizeof(uint64_t);
@@ -51,6 +53,12 @@ bool GetPageFrameNumber(art::File& page_map_file,
                         /*out*/ uint64_t& page_frame_number,
                         /*out*/ std::string& error_msg);
 
+// Note: On failure, `*is_present` shall be clobbered.
+bool IsPagePresent(art::File& page_map_file,
+                   size_t virtual_page_index,
+                   /*out*/ bool& is_present,
+                   /*out*/ std::string& error_msg);
+
 bool GetPageFrameNumbers(art::File& page_map_file,
                          size_t virtual_page_index,
                          /*out*/ ArrayRef<uint64_t> page_frame_numbers,
@@ -188,6 +188,20 @@ size_t ArenaAllocator::BytesAllocated() const {
   return ArenaAllocatorStats::BytesAllocated();
 }
 
+Arena* ArenaPool::TakeFreeArena(Arena** free_arenas, size_t size) {
+  // Most arenas have the default size, but large allocations get large arenas. Look past
+  // the smaller ones so that compiling a huge method reuses the large arenas of the
+  // previous one instead of allocating new ones while the old ones stay in the pool.
+  for (Arena** link = free_arenas; *link != nullptr; link = &(*link)->next_) {
+    Arena* arena = *link;
+    if (arena->Size() >= size) {
+      *link = arena->next_;
+      return arena;
+    }
+  }
+  return nullptr;
+}
+
 size_t ArenaAllocator::BytesUsed() const {
   size_t total = ptr_ - begin_;
   if (arena_head_ != nullptr) {
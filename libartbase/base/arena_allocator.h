@@ -214,6 +214,7 @@ class Arena {
   uint8_t* memory_;
   size_t size_;
   Arena* next_;
+  friend class ArenaPool;
   friend class MallocArenaPool;
   friend class MemMapArenaPool;
   friend class ArenaAllocator;
@@ -242,6 +243,10 @@ class ArenaPool {
  protected:
   ArenaPool() = default;
 
+  // Removes and returns the first arena of at least `size` bytes from the `free_arenas` list,
+  // or returns null if there is none. Callers must hold the lock protecting the list.
+  static Arena* TakeFreeArena(Arena** free_arenas, size_t size);
+
  private:
   DISALLOW_COPY_AND_ASSIGN(ArenaPool);
 };
@@ -134,6 +134,28 @@ TEST_F(ArenaAllocatorTest, LargeAllocations) {
   }
 }
 
+TEST_F(ArenaAllocatorTest, ReuseLargeArena) {
+  if (arena_allocator::kArenaAllocatorPreciseTracking) {
+    printf("WARNING: TEST DISABLED FOR precise arena tracking\n");
+    return;
+  }
+
+  MallocArenaPool pool;
+  void* large_alloc;
+  {
+    ArenaAllocator allocator(&pool);
+    allocator.Alloc(arena_allocator::kArenaDefaultSize * 1 / 16);
+    large_alloc = allocator.Alloc(arena_allocator::kArenaDefaultSize * 2);
+    ASSERT_EQ(2u, NumberOfArenas(&allocator));
+  }
+  {
+    // The large arena is reused even though it is not the first free arena.
+    ArenaAllocator allocator(&pool);
+    void* alloc = allocator.Alloc(arena_allocator::kArenaDefaultSize * 2);
+    ASSERT_EQ(large_alloc, alloc);
+  }
+}
+
 TEST_F(ArenaAllocatorTest, AllocAlignment) {
   MallocArenaPool pool;
   ArenaAllocator allocator(&pool);
@@ -119,6 +119,38 @@ TEST(BitTableTest, TestBigTable) {
   EXPECT_EQ(32u, table.NumColumnBits(3));
 }
 
+TEST(BitTableTest, TestGetPair) {
+  MallocArenaPool pool;
+  ArenaStack arena_stack(&pool);
+  ScopedArenaAllocator allocator(&arena_stack);
+
+  constexpr uint32_t kNoValue = -1;
+  for (size_t start_bit_offset = 0; start_bit_offset <= 64; start_bit_offset++) {
+    std::vector<uint8_t> buffer;
+    BitMemoryWriter<std::vector<uint8_t>> writer(&buffer, start_bit_offset);
+    BitTableBuilderBase<4> builder(&allocator);
+    builder.Add({42u, kNoValue, 0xffffffu, static_cast<uint32_t>(-2)});
+    builder.Add({62u, kNoValue, 63u, static_cast<uint32_t>(-3)});
+    builder.Add({1u, 7u, 0u, 0x12345678u});
+    builder.Encode(writer);
+
+    BitMemoryReader reader(buffer.data(), start_bit_offset);
+    BitTableBase<4> table(reader);
+    EXPECT_EQ(writer.NumberOfWrittenBits(), reader.NumberOfReadBits());
+    ASSERT_EQ(3u, table.NumRows());
+    for (uint32_t row = 0; row < table.NumRows(); row++) {
+      for (uint32_t column = 0; column + 1 < table.NumColumns(); column++) {
+        auto [first, second] = table.GetPair(row, column);
+        EXPECT_EQ(table.Get(row, column), first);
+        EXPECT_EQ(table.Get(row, column + 1), second);
+      }
+    }
+    EXPECT_EQ(std::make_pair(0xffffffu, static_cast<uint32_t>(-2)), table.GetPair(0, 2));
+    EXPECT_EQ(std::make_pair(0u, 0x12345678u), table.GetPair(2, 2));
+    EXPECT_EQ(std::make_pair(1u, 7u), table.GetPair(2, 0));
+  }
+}
+
 TEST(BitTableTest, TestDedup) {
   MallocArenaPool pool;
   ArenaStack arena_stack(&pool);
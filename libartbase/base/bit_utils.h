@@ -513,6 +513,31 @@ inline static constexpr size_t BitsToBytesRoundUp(size_t num_bits) {
   return RoundUp(num_bits, kBitsPerByte) / kBitsPerByte;
 }
 
+// The size and alignment of the blocks checked by IsZeroBlock() and IsZeroBlockAndNot(), which
+// find long runs of zero bytes, e.g. in bitmaps or card tables, with 16-byte vector loads. These
+// compile to NEON or SSE2 instructions, which all 64-bit ART targets have, and to pairs of word
+// loads elsewhere.
+static constexpr size_t kZeroBlockSize = 32;
+using ZeroBlockVector = uint64_t __attribute__((vector_size(kZeroBlockSize / 2)));
+
+// Returns whether the `kZeroBlockSize` bytes at `block` are all zero.
+inline bool IsZeroBlock(const void* block) {
+  DCHECK_ALIGNED(block, kZeroBlockSize);
+  const ZeroBlockVector* vectors = reinterpret_cast<const ZeroBlockVector*>(block);
+  const ZeroBlockVector ored = vectors[0] | vectors[1];
+  return (ored[0] | ored[1]) == 0;
+}
+
+// Returns whether (`block` & ~`mask_block`) is all zero, for blocks of `kZeroBlockSize` bytes.
+inline bool IsZeroBlockAndNot(const void* block, const void* mask_block) {
+  DCHECK_ALIGNED(block, kZeroBlockSize);
+  DCHECK_ALIGNED(mask_block, kZeroBlockSize);
+  const ZeroBlockVector* vectors = reinterpret_cast<const ZeroBlockVector*>(block);
+  const ZeroBlockVector* masks = reinterpret_cast<const ZeroBlockVector*>(mask_block);
+  const ZeroBlockVector ored = (vectors[0] & ~masks[0]) | (vectors[1] & ~masks[1]);
+  return (ored[0] | ored[1]) == 0;
+}
+
 }  // namespace art
 
 #endif  // ART_LIBARTBASE_BASE_BIT_UTILS_H_
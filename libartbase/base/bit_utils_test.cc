@@ -520,4 +520,20 @@ TEST(BitUtilsTest, TestHighToLowBits64) {
                 HighToLowBits<uint64_t>(UINT64_C(0xffffffffffffffff)));
 }
 
+TEST(BitUtilsTest, TestIsZeroBlock) {
+  alignas(kZeroBlockSize) uint8_t block[kZeroBlockSize] = {};
+  alignas(kZeroBlockSize) uint8_t mask[kZeroBlockSize] = {};
+  EXPECT_TRUE(IsZeroBlock(block));
+  EXPECT_TRUE(IsZeroBlockAndNot(block, mask));
+  for (size_t i = 0; i < kZeroBlockSize; ++i) {
+    block[i] = 0x10;
+    EXPECT_FALSE(IsZeroBlock(block)) << i;
+    EXPECT_FALSE(IsZeroBlockAndNot(block, mask)) << i;
+    mask[i] = 0x30;
+    EXPECT_TRUE(IsZeroBlockAndNot(block, mask)) << i;
+    block[i] = 0;
+    mask[i] = 0;
+  }
+}
+
 }  // namespace art
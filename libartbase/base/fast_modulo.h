@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_LIBARTBASE_BASE_FAST_MODULO_H_
+#define ART_LIBARTBASE_BASE_FAST_MODULO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <type_traits>
+
+#include <android-base/logging.h>
+
+#include "base/bit_utils.h"
+#include "base/macros.h"
+
+namespace art {
+
+// Computes `n % divisor` for a divisor fixed at construction time with a multiply and shifts
+// instead of a hardware division, which is an order of magnitude slower on most cores. The
+// result is exactly the same as `n % divisor` for every `n`.
+//
+// This is the round-up "branchfree" reciprocal from libdivide: with `l = floor(log2(divisor))`
+// and `q = mulhi(magic, n)`, the quotient is `(((n - q) >> 1) + q) >> l`. The 65-bit magic
+// number's implicit top bit is accounted for by the `n - q` step. Divisors 0 and 1 are not
+// supported by `Modulo()`; callers handle them before dividing.
+class FastModulo {
+ public:
+  constexpr FastModulo() : divisor_(0u), magic_(0u), shift_(0u) {}
+
+  explicit FastModulo(size_t divisor) : divisor_(divisor), magic_(0u), shift_(0u) {
+    if (divisor <= 1u) {
+      return;
+    }
+    const uint32_t floor_log2 = static_cast<uint32_t>(MostSignificantBit(divisor));
+    if (IsPowerOfTwo(divisor)) {
+      // The quotient is `(n >> 1) >> (floor_log2 - 1)`.
+      shift_ = floor_log2 - 1u;
+      return;
+    }
+    Wide dividend = static_cast<Wide>(1u) << (kBits + floor_log2);
+    size_t proposed_magic = static_cast<size_t>(dividend / divisor);
+    size_t remainder = static_cast<size_t>(dividend % divisor);
+    proposed_magic += proposed_magic;
+    size_t twice_remainder = remainder + remainder;
+    if (twice_remainder >= divisor || twice_remainder < remainder) {
+      proposed_magic += 1u;
+    }
+    magic_ = proposed_magic + 1u;
+    shift_ = floor_log2;
+  }
+
+  size_t Divisor() const {
+    return divisor_;
+  }
+
+  ALWAYS_INLINE size_t Modulo(size_t n) const {
+    DCHECK_GT(divisor_, 1u);
+    size_t q = MulHigh(magic_, n);
+    size_t t = ((n - q) >> 1) + q;
+    return n - (t >> shift_) * divisor_;
+  }
+
+ private:
+  static constexpr uint32_t kBits = BitSizeOf<size_t>();
+
+#if defined(__SIZEOF_INT128__)
+  using Wide = std::conditional_t<sizeof(size_t) == sizeof(uint64_t), unsigned __int128, uint64_t>;
+#else
+  static_assert(sizeof(size_t) == sizeof(uint32_t));
+  using Wide = uint64_t;
+#endif
+
+  ALWAYS_INLINE static size_t MulHigh(size_t lhs, size_t rhs) {
+    return static_cast<size_t>((static_cast<Wide>(lhs) * static_cast<Wide>(rhs)) >> kBits);
+  }
+
+  size_t divisor_;
+  size_t magic_;
+  uint32_t shift_;
+};
+
+}  // namespace art
+
+#endif  // ART_LIBARTBASE_BASE_FAST_MODULO_H_
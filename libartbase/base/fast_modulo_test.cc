@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fast_modulo.h"
+
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+static void CheckDivisor(size_t divisor, const std::vector<size_t>& values) {
+  FastModulo modulo(divisor);
+  EXPECT_EQ(divisor, modulo.Divisor());
+  for (size_t value : values) {
+    ASSERT_EQ(value % divisor, modulo.Modulo(value)) << value << " % " << divisor;
+  }
+}
+
+TEST(FastModulo, MatchesHardwareModulo) {
+  std::mt19937_64 rng(42);
+  std::vector<size_t> values = {
+      0u,
+      1u,
+      2u,
+      std::numeric_limits<size_t>::max(),
+      std::numeric_limits<size_t>::max() - 1u,
+      std::numeric_limits<size_t>::max() / 2u,
+  };
+  for (size_t i = 0; i < 256; ++i) {
+    values.push_back(static_cast<size_t>(rng() >> (rng() % 64u)));
+  }
+
+  // Small divisors, including every power of two and the typical HashSet bucket counts.
+  for (size_t divisor = 2u; divisor != 5000u; ++divisor) {
+    CheckDivisor(divisor, values);
+  }
+  for (size_t shift = 2u; shift != BitSizeOf<size_t>(); ++shift) {
+    size_t power_of_two = static_cast<size_t>(1u) << shift;
+    CheckDivisor(power_of_two - 1u, values);
+    CheckDivisor(power_of_two, values);
+    CheckDivisor(power_of_two + 1u, values);
+  }
+  CheckDivisor(std::numeric_limits<size_t>::max(), values);
+
+  // Random large divisors.
+  for (size_t i = 0; i < 1000; ++i) {
+    size_t divisor = static_cast<size_t>(rng() >> (rng() % 62u));
+    if (divisor > 1u) {
+      CheckDivisor(divisor, values);
+    }
+  }
+}
+
+}  // namespace art
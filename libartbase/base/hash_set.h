@@ -30,6 +30,7 @@
 
 #include "base/data_hash.h"
 #include "bit_utils.h"
+#include "fast_modulo.h"
 #include "macros.h"
 
 namespace art {
@@ -269,6 +270,7 @@ class HashSet {
         pred_(std::move(other.pred_)),
         num_elements_(other.num_elements_),
         num_buckets_(other.num_buckets_),
+        bucket_modulo_(other.bucket_modulo_),
         elements_until_expand_(other.elements_until_expand_),
         owns_data_(other.owns_data_),
         data_(other.data_),
@@ -276,6 +278,7 @@ class HashSet {
         max_load_factor_(other.max_load_factor_) {
     other.num_elements_ = 0u;
     other.num_buckets_ = 0u;
+    other.bucket_modulo_ = FastModulo();
     other.elements_until_expand_ = 0u;
     other.owns_data_ = false;
     other.data_ = nullptr;
@@ -307,6 +310,7 @@ class HashSet {
         pred_(pred),
         num_elements_(0u),
         num_buckets_(buffer_size),
+        bucket_modulo_(buffer_size),
         elements_until_expand_(buffer_size * max_load_factor),
         owns_data_(false),
         data_(buffer),
@@ -329,6 +333,7 @@ class HashSet {
     num_elements_ = static_cast<uint64_t>(temp);
     offset = ReadFromBytes(ptr, offset, &temp);
     num_buckets_ = static_cast<uint64_t>(temp);
+    bucket_modulo_ = FastModulo(num_buckets_);
     CHECK_LE(num_elements_, num_buckets_);
     offset = ReadFromBytes(ptr, offset, &temp);
     elements_until_expand_ = static_cast<uint64_t>(temp);
@@ -567,6 +572,7 @@ class HashSet {
     swap(pred_, other.pred_);
     std::swap(data_, other.data_);
     std::swap(num_buckets_, other.num_buckets_);
+    std::swap(bucket_modulo_, other.bucket_modulo_);
     std::swap(num_elements_, other.num_elements_);
     std::swap(elements_until_expand_, other.elements_until_expand_);
     std::swap(min_load_factor_, other.min_load_factor_);
@@ -686,11 +692,13 @@ class HashSet {
   }
 
   size_t IndexForHash(size_t hash) const {
-    // Protect against undefined behavior (division by zero).
-    if (UNLIKELY(num_buckets_ == 0)) {
+    // Protect against undefined behavior (division by zero). A single bucket is also
+    // special-cased, as `FastModulo` does not support a divisor of 1.
+    if (UNLIKELY(num_buckets_ <= 1u)) {
       return 0;
     }
-    return hash % num_buckets_;
+    DCHECK_EQ(bucket_modulo_.Divisor(), num_buckets_);
+    return bucket_modulo_.Modulo(hash);
   }
 
   size_t NextIndex(size_t index) const {
@@ -742,6 +750,7 @@ class HashSet {
   // Allocate a number of buckets.
   void AllocateStorage(size_t num_buckets) {
     num_buckets_ = num_buckets;
+    bucket_modulo_ = FastModulo(num_buckets);
     data_ = allocfn_.allocate(num_buckets_);
     owns_data_ = true;
     for (size_t i = 0; i < num_buckets_; ++i) {
@@ -762,6 +771,7 @@ class HashSet {
     }
     data_ = nullptr;
     num_buckets_ = 0;
+    bucket_modulo_ = FastModulo();
   }
 
   // Expand the set based on the load factors.
@@ -843,6 +853,7 @@ class HashSet {
   Pred pred_;  // Equals function.
   size_t num_elements_;  // Number of inserted elements.
   size_t num_buckets_;  // Number of hash table buckets.
+  FastModulo bucket_modulo_;  // Computes `hash % num_buckets_` without a division.
   size_t elements_until_expand_;  // Maximum number of elements until we expand the table.
   bool owns_data_;  // If we own data_ and are responsible for freeing it.
   T* data_;  // Backing storage.
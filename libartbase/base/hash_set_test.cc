@@ -394,6 +394,44 @@ TEST_F(HashSetTest, Preallocated) {
   ASSERT_TRUE(hash_set.owns_data_);
 }
 
+TEST_F(HashSetTest, SmallBucketCounts) {
+  // Bucket counts of one and powers of two take special paths when computing the bucket index.
+  // Note that 0 is the empty value of `HashSet<uint32_t>`, so it is never inserted.
+  static const size_t kMaxBufferSize = 9;
+  uint32_t buffer[kMaxBufferSize];
+  for (size_t buffer_size = 1; buffer_size <= kMaxBufferSize; ++buffer_size) {
+    HashSet<uint32_t> hash_set(buffer, buffer_size);
+    for (uint32_t i = 0; i != 20u; ++i) {
+      hash_set.insert(i * 7u + 1u);
+    }
+    for (uint32_t i = 0; i != 20u; ++i) {
+      ASSERT_TRUE(hash_set.find(i * 7u + 1u) != hash_set.end());
+      ASSERT_TRUE(hash_set.find(i * 7u + 2u) == hash_set.end());
+    }
+    ASSERT_EQ(0u, hash_set.Verify());
+  }
+}
+
+TEST_F(HashSetTest, ReadFromMemory) {
+  HashSet<uint32_t> hash_set;
+  for (uint32_t i = 0; i != 1000u; ++i) {
+    hash_set.insert(i * 3u + 1u);
+  }
+  std::vector<uint8_t> data(hash_set.WriteToMemory(nullptr));
+  hash_set.WriteToMemory(data.data());
+  for (bool make_copy : {false, true}) {
+    size_t read_count;
+    HashSet<uint32_t> read_set(data.data(), make_copy, &read_count);
+    EXPECT_EQ(data.size(), read_count);
+    EXPECT_EQ(hash_set.size(), read_set.size());
+    EXPECT_EQ(hash_set.NumBuckets(), read_set.NumBuckets());
+    for (uint32_t i = 0; i != 1000u; ++i) {
+      ASSERT_TRUE(read_set.find(i * 3u + 1u) != read_set.end());
+      ASSERT_TRUE(read_set.find(i * 3u + 2u) == read_set.end());
+    }
+  }
+}
+
 class SmallIndexEmptyFn {
  public:
   void MakeEmpty(uint16_t& item) const {
@@ -64,12 +64,43 @@ static inline bool DecodeLeb128Helper(const uint8_t** data,
   return true;
 }
 
+// Unrolled decoder for the unchecked 32-bit case, which is what class data, debug info and
+// other dex streams use. Almost all values there fit in one or two bytes, so the common path
+// is a single load and compare without the loop bookkeeping of `DecodeLeb128Helper()`.
+// Like the helper, this tolerates non-zero high-order bits in the fifth encoded byte.
+static inline uint32_t DecodeUnsignedLeb128Unrolled(const uint8_t** data) {
+  const uint8_t* ptr = *data;
+  uint32_t result = *(ptr++);
+  if (UNLIKELY(result > 0x7f)) {
+    uint32_t cur = *(ptr++);
+    result = (result & 0x7f) | ((cur & 0x7f) << 7);
+    if (cur > 0x7f) {
+      cur = *(ptr++);
+      result |= (cur & 0x7f) << 14;
+      if (cur > 0x7f) {
+        cur = *(ptr++);
+        result |= (cur & 0x7f) << 21;
+        if (cur > 0x7f) {
+          cur = *(ptr++);
+          result |= cur << 28;
+        }
+      }
+    }
+  }
+  *data = ptr;
+  return result;
+}
+
 template <typename T = uint32_t>
 static inline T DecodeUnsignedLeb128(const uint8_t** data) {
   static_assert(!std::is_signed_v<T>);
-  T value = 0;
-  DecodeLeb128Helper(data, std::nullopt, &value);
-  return value;
+  if constexpr (std::is_same_v<T, uint32_t>) {
+    return DecodeUnsignedLeb128Unrolled(data);
+  } else {
+    T value = 0;
+    DecodeLeb128Helper(data, std::nullopt, &value);
+    return value;
+  }
 }
 
 template <typename T = uint32_t>
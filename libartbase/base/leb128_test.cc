@@ -451,4 +451,42 @@ TEST(Leb128Test, Speed) {
   dec_hist->PrintConfidenceIntervals(std::cout, 0.99, dec_data);
 }
 
+TEST(Leb128Test, SpeedSmallValues) {
+  // Dex class data and debug info are dominated by one and two byte values (member index
+  // deltas, access flags, address and line deltas). Measure decoding of such a stream.
+  std::unique_ptr<Histogram<uint64_t>> dec_hist(
+      new Histogram<uint64_t>("Leb128SmallDecodeSpeedTest", 5));
+  Leb128EncodingVector<> builder;
+  for (size_t i = 0; i < 1024 * 1024; i++) {
+    builder.PushBackUnsigned((i % 4 == 3) ? (i & 0x3fffu) : (i & 0x7fu));
+  }
+  const uint8_t* encoded_data_ptr = &builder.GetData()[0];
+  uint64_t last_time = NanoTime();
+  for (size_t i = 0; i < 1024; i++) {
+    for (size_t j = 0; j < 1024; j++) {
+      size_t k = (i * 1024) + j;
+      uint32_t expected = (k % 4 == 3) ? (k & 0x3fffu) : (k & 0x7fu);
+      EXPECT_EQ(DecodeUnsignedLeb128(&encoded_data_ptr), expected);
+    }
+    uint64_t cur_time = NanoTime();
+    dec_hist->AddValue(cur_time - last_time);
+    last_time = cur_time;
+  }
+  EXPECT_EQ(builder.GetData().size(),
+            static_cast<size_t>(encoded_data_ptr - &builder.GetData()[0]));
+
+  Histogram<uint64_t>::CumulativeData dec_data;
+  dec_hist->CreateHistogram(&dec_data);
+  dec_hist->PrintConfidenceIntervals(std::cout, 0.99, dec_data);
+}
+
+TEST(Leb128Test, UnsignedTolerateHighBitsInLastByte) {
+  // The fifth byte of a 32-bit value may carry bits beyond bit 31; they are ignored.
+  static const uint8_t kData[] = {0xff, 0xff, 0xff, 0xff, 0x7f, 0x05};
+  const uint8_t* ptr = kData;
+  EXPECT_EQ(0xffffffffu, DecodeUnsignedLeb128(&ptr));
+  EXPECT_EQ(kData + 5, ptr);
+  EXPECT_EQ(5u, DecodeUnsignedLeb128(&ptr));
+}
+
 }  // namespace art
@@ -106,10 +106,7 @@ Arena* MallocArenaPool::AllocArena(size_t size) {
   Arena* ret = nullptr;
   {
     std::lock_guard<std::mutex> lock(lock_);
-    if (free_arenas_ != nullptr && LIKELY(free_arenas_->Size() >= size)) {
-      ret = free_arenas_;
-      free_arenas_ = free_arenas_->next_;
-    }
+    ret = TakeFreeArena(&free_arenas_, size);
   }
   if (ret == nullptr) {
     ret = new MallocArena(size);
@@ -864,6 +864,15 @@ int MemMap::MadviseDontFork() {
   return -1;
 }
 
+int MemMap::MadviseHugePage() {
+#if defined(__linux__)
+  if (base_begin_ != nullptr || base_size_ != 0) {
+    return madvise(base_begin_, base_size_, MADV_HUGEPAGE);
+  }
+#endif
+  return -1;
+}
+
 bool MemMap::Sync() {
 #ifdef _WIN32
   // TODO: add FlushViewOfFile support.
@@ -251,6 +251,15 @@ class MemMap {
     FillWithZero(/* release_eagerly= */ true);
   }
   int MadviseDontFork();
+  // Ask the kernel to back this map with transparent huge pages where the map covers whole,
+  // aligned huge pages. Fails with EINVAL if the kernel was built without THP support.
+  int MadviseHugePage();
+
+  // Size of a transparent huge page, i.e. the range mapped by a single page middle directory
+  // entry: 2MB with 4KB pages, 32MB with 16KB pages.
+  static size_t GetHugePageSize() {
+    return GetPageSize() * (GetPageSize() / sizeof(uint64_t));
+  }
 
   int GetProtect() const {
     return prot_;
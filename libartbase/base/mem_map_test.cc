@@ -684,6 +684,28 @@ TEST_F(MemMapTest, CheckNoGaps) {
   ASSERT_FALSE(MemMap::CheckNoGaps(map0, map2));
 }
 
+TEST_F(MemMapTest, MadviseHugePage) {
+  CommonInit();
+  const size_t huge_page_size = MemMap::GetHugePageSize();
+  ASSERT_TRUE(IsPowerOfTwo(huge_page_size));
+  ASSERT_GT(huge_page_size, MemMap::GetPageSize());
+  std::string error_msg;
+  MemMap map = MemMap::MapAnonymous("MemMapTest_MadviseHugePageTest_map",
+                                    2 * huge_page_size,
+                                    PROT_READ | PROT_WRITE,
+                                    /*low_4gb=*/ false,
+                                    &error_msg);
+  ASSERT_TRUE(map.IsValid()) << error_msg;
+  map.AlignBy(huge_page_size);
+  ASSERT_TRUE(IsAlignedParam(map.Begin(), huge_page_size));
+  int ret = map.MadviseHugePage();
+  // Kernels without transparent huge pages reject the advice.
+  ASSERT_TRUE(ret == 0 || errno == EINVAL) << strerror(errno);
+  // The map remains usable either way.
+  memset(map.Begin(), 0xab, map.Size());
+  EXPECT_EQ(map.Begin()[map.Size() - 1], 0xab);
+}
+
 TEST_F(MemMapTest, AlignBy) {
   CommonInit();
   const size_t page_size = MemMap::GetPageSize();
@@ -67,7 +67,36 @@
   METRIC(YoungGcDuration, MetricsCounter)                           \
   METRIC(FullGcScannedBytes, MetricsCounter)                        \
   METRIC(FullGcFreedBytes, MetricsCounter)                          \
-  METRIC(FullGcDuration, MetricsCounter)
+  METRIC(FullGcDuration, MetricsCounter)                            \
+  METRIC(TlabRefillCount, MetricsShardedCounter)                    \
+  METRIC(TlabWastedBytes, MetricsCounter)                           \
+  METRIC(GcPauseTargetMissCount, MetricsCounter)                    \
+  METRIC(GcNewObjectSurvivalRate, MetricsHistogram, 20, 0, 100)     \
+  METRIC(GcOldObjectSurvivalRate, MetricsHistogram, 20, 0, 100)     \
+  METRIC(GcEvacuatedBytes, MetricsCounter)                          \
+  METRIC(GcEvacuationFreedBytes, MetricsCounter)                    \
+  METRIC(GcForAllocBlockingCount, MetricsCounter)                   \
+  METRIC(GcForAllocBlockingTime, MetricsHistogram, 15, 0, 10'000)  \
+  METRIC(MonitorInflationCount, MetricsCounter)                     \
+  METRIC(MonitorContentionCount, MetricsShardedCounter)             \
+  METRIC(MonitorContentionTimeNs, MetricsHistogram, 20, 0, 1'000'000) \
+  METRIC(JitOsrQueueLatency, MetricsHistogram, 15, 0, 10'000)       \
+  METRIC(JitBaselineQueueLatency, MetricsHistogram, 15, 0, 10'000)  \
+  METRIC(JitOptimizedQueueLatency, MetricsHistogram, 15, 0, 10'000) \
+  METRIC(JitStaleQueuedMethodCount, MetricsCounter)                 \
+  METRIC(JitMethodCompileQueueDepth, MetricsHistogram, 16, 0, 512) \
+  METRIC(JitCodeCacheCollectionTimeUs, MetricsHistogram, 15, 0, 100'000) \
+  METRIC(JitOsrRecompileCount, MetricsCounter)                      \
+  METRIC(ChaInvalidatedMethodCount, MetricsCounter)                 \
+  METRIC(ChaInvalidationCheckpointCount, MetricsCounter)            \
+  METRIC(NterpCacheRefillCount, MetricsShardedCounter)              \
+  METRIC(DexCacheMissCount, MetricsShardedCounter)                  \
+  METRIC(ReadBarrierSlowPathCount, MetricsCounter)                  \
+  METRIC(DexFileOpenTimeUs, MetricsHistogram, 15, 0, 1'000'000) \
+  METRIC(SuspendAllTimeUs, MetricsHistogram, 15, 0, 100'000)    \
+  METRIC(JitBootJniStubReuseCount, MetricsCounter)                  \
+  METRIC(StartupReleasedBytes, MetricsCounter)                      \
+  METRIC(ColdMemoryReleasedBytes, MetricsCounter)
 
 // Increasing counter metrics, reported as Value Metrics in delta increments.
 #define ART_VALUE_METRICS(METRIC)                              \
@@ -434,6 +463,69 @@ class MetricsDeltaCounter : public MetricsBase<T> {
   friend class ArtMetrics;
 };
 
+// A counter for events that are recorded concurrently by many threads on hot paths (TLAB refills,
+// monitor contention, ...). Updates are spread over several cache-line-sized shards so that
+// concurrent `Add()`s from different threads do not bounce a single cache line; reads sum all
+// shards and are therefore slightly more expensive, which is fine for the reporting path.
+template <DatumId counter_type, typename T = uint64_t>
+class MetricsShardedCounter final : public MetricsBase<T> {
+ public:
+  using value_t = T;
+
+  constexpr MetricsShardedCounter() : shards_{} {}
+
+  void AddOne() { Add(1u); }
+  void Add(value_t value) override {
+    shards_[CurrentShard()].value.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  void Report(const std::vector<MetricsBackend*>& backends) const {
+    value_t value = Value();
+    for (MetricsBackend* backend : backends) {
+      backend->ReportCounter(counter_type, value);
+    }
+  }
+
+ protected:
+  void Reset() {
+    for (Shard& shard : shards_) {
+      shard.value.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  value_t Value() const {
+    value_t value = 0;
+    for (const Shard& shard : shards_) {
+      value += shard.value.load(std::memory_order_relaxed);
+    }
+    return value;
+  }
+
+ private:
+  static constexpr size_t kNumShards = 8;
+  static constexpr size_t kShardSize = 64;
+  static_assert(IsPowerOfTwo(kNumShards));
+
+  struct alignas(kShardSize) Shard {
+    std::atomic<value_t> value;
+  };
+  static_assert(sizeof(Shard) == kShardSize);
+
+  // Pick a shard from the current stack address. Thread stacks are at least tens of KiB apart,
+  // so this spreads threads over the shards without any per-thread state or system call.
+  ALWAYS_INLINE static size_t CurrentShard() {
+    uintptr_t sp = reinterpret_cast<uintptr_t>(__builtin_frame_address(0));
+    return static_cast<size_t>((sp >> 16) ^ (sp >> 20)) & (kNumShards - 1u);
+  }
+
+  bool IsNull() const override { return Value() == 0; }
+
+  std::array<Shard, kNumShards> shards_;
+  static_assert(std::atomic<value_t>::is_always_lock_free);
+
+  friend class ArtMetrics;
+};
+
 template <DatumId histogram_type_,
           size_t num_buckets_,
           int64_t minimum_value_,
@@ -128,6 +128,29 @@ TEST_F(MetricsTest, AverageMetric) {
   EXPECT_EQ(CounterValue(avg), (kMaxValue + 1) / 2);
 }
 
+TEST_F(MetricsTest, ShardedCounter) {
+  MetricsShardedCounter<DatumId::kTlabRefillCount> counter;
+
+  std::vector<std::thread> threads;
+
+  constexpr uint64_t kNumThreads = 16;
+  constexpr uint64_t kAddsPerThread = 1000;
+
+  for (uint64_t i = 0; i < kNumThreads; i++) {
+    threads.emplace_back(std::thread{[&counter]() {
+      for (uint64_t j = 0; j < kAddsPerThread; j++) {
+        counter.AddOne();
+      }
+    }});
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(CounterValue(counter), kNumThreads * kAddsPerThread);
+}
+
 TEST_F(MetricsTest, DatumName) {
   EXPECT_EQ("ClassVerificationTotalTime", DatumName(DatumId::kClassVerificationTotalTime));
 }
@@ -21,6 +21,9 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+
+#include <algorithm>
+#include <memory>
 #include <vector>
 
 #include "android-base/stringprintf.h"
@@ -92,6 +95,71 @@ MemMap ZipEntry::ExtractToMemMap(const char* zip_filename,
   return map;
 }
 
+MemMap ZipEntry::ExtractToCacheFile(const char* zip_filename,
+                                    const char* entry_filename,
+                                    const std::string& cache_dir,
+                                    std::string* error_msg) {
+#ifdef _WIN32
+  UNUSED(zip_filename, entry_filename, cache_dir);
+  *error_msg = "Extracting to a cache file is not supported on Windows";
+  return MemMap::Invalid();
+#else
+  // Flatten the zip location into a file name, as done for dalvik-cache files.
+  std::string key = std::string(zip_filename) + "!" + entry_filename;
+  std::replace(key.begin(), key.end(), '/', '@');
+  if (key[0] == '@') {
+    key.erase(0, 1);
+  }
+  const std::string cache_path =
+      StringPrintf("%s/%s@%08x.dex", cache_dir.c_str(), key.c_str(), GetCrc32());
+
+  std::unique_ptr<File> file(new File(cache_path, O_RDONLY | O_CLOEXEC, /*check_usage=*/ false));
+  if (!file->IsOpened() || file->GetLength() != static_cast<int64_t>(GetUncompressedLength())) {
+    // Stream the entry into a temporary file, then publish it with an atomic
+    // rename so that concurrent readers never observe a partial file.
+    const std::string temp_path = StringPrintf("%s.%d.tmp", cache_path.c_str(), getpid());
+    File temp_file(temp_path,
+                   O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC,
+                   S_IRUSR | S_IWUSR,
+                   /*check_usage=*/ true);
+    if (!temp_file.IsOpened()) {
+      *error_msg = StringPrintf("Failed to create %s: %s", temp_path.c_str(), strerror(errno));
+      return MemMap::Invalid();
+    }
+    if (!ExtractToFile(temp_file, error_msg)) {
+      temp_file.Erase(/*unlink=*/ true);
+      return MemMap::Invalid();
+    }
+    if (temp_file.Flush() != 0 || !temp_file.Rename(cache_path)) {
+      *error_msg = StringPrintf("Failed to publish %s: %s", cache_path.c_str(), strerror(errno));
+      temp_file.Erase(/*unlink=*/ true);
+      return MemMap::Invalid();
+    }
+    if (temp_file.Close() != 0) {
+      *error_msg = StringPrintf("Failed to close %s: %s", cache_path.c_str(), strerror(errno));
+      return MemMap::Invalid();
+    }
+    file.reset(new File(cache_path, O_RDONLY | O_CLOEXEC, /*check_usage=*/ false));
+    if (!file->IsOpened()) {
+      *error_msg = StringPrintf("Failed to open %s: %s", cache_path.c_str(), strerror(errno));
+      return MemMap::Invalid();
+    }
+  }
+
+  std::string name(entry_filename);
+  name += " extracted to ";
+  name += cache_path;
+  return MemMap::MapFile(GetUncompressedLength(),
+                         PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE,
+                         file->Fd(),
+                         /*start=*/ 0,
+                         /*low_4gb=*/ false,
+                         name.c_str(),
+                         error_msg);
+#endif
+}
+
 bool ZipEntry::ExtractToMemory(/*out*/uint8_t* buffer, /*out*/std::string* error_msg) {
   const int32_t error = ::ExtractToMemory(handle_, zip_entry_, buffer, GetUncompressedLength());
   if (error != 0) {
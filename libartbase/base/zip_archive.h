@@ -49,6 +49,16 @@ class ZipEntry {
   MemMap ExtractToMemMap(const char* zip_filename,
                          const char* entry_filename,
                          /*out*/std::string* error_msg);
+  // Extract this entry to a file in `cache_dir` and create a file-backed private
+  // (clean, R/W) memory mapping to it. Unlike anonymous memory, the kernel can
+  // page out the extracted data. The cached file is keyed by the zip location,
+  // entry name and CRC, and is reused if it already exists, e.g. by another
+  // process of the same user.
+  // Returns invalid MemMap on failure and sets error_msg.
+  MemMap ExtractToCacheFile(const char* zip_filename,
+                            const char* entry_filename,
+                            const std::string& cache_dir,
+                            /*out*/std::string* error_msg);
   // Extracts this entry to memory. Stores `GetUncompressedSize()` bytes on success.
   // Returns true on success, false on failure.
   bool ExtractToMemory(/*out*/uint8_t* buffer, /*out*/std::string* error_msg);
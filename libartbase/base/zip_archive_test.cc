@@ -20,9 +20,12 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <zlib.h>
+
+#include <filesystem>
 #include <memory>
 
 #include "base/common_art_test.h"
+#include "base/mem_map.h"
 #include "file_utils.h"
 #include "os.h"
 #include "unix_file/fd_file.h"
@@ -64,4 +67,29 @@ TEST_F(ZipArchiveTest, FindAndExtract) {
   EXPECT_EQ(zip_entry->GetCrc32(), computed_crc);
 }
 
+TEST_F(ZipArchiveTest, ExtractToCacheFile) {
+  std::string error_msg;
+  const std::string zip_filename = GetLibCoreDexFileNames()[0];
+  std::unique_ptr<ZipArchive> zip_archive(ZipArchive::Open(zip_filename.c_str(), &error_msg));
+  ASSERT_TRUE(zip_archive != nullptr) << error_msg;
+  std::unique_ptr<ZipEntry> zip_entry(zip_archive->Find("classes.dex", &error_msg));
+  ASSERT_TRUE(zip_entry != nullptr) << error_msg;
+
+  MemMap expected = zip_entry->ExtractToMemMap(zip_filename.c_str(), "classes.dex", &error_msg);
+  ASSERT_TRUE(expected.IsValid()) << error_msg;
+
+  ScratchDir cache_dir;
+  for (size_t i = 0; i != 2; ++i) {
+    // The second extraction reuses the cached file.
+    MemMap map = zip_entry->ExtractToCacheFile(
+        zip_filename.c_str(), "classes.dex", cache_dir.GetPath(), &error_msg);
+    ASSERT_TRUE(map.IsValid()) << error_msg;
+    ASSERT_EQ(expected.Size(), map.Size());
+    EXPECT_EQ(0, memcmp(expected.Begin(), map.Begin(), map.Size()));
+    size_t num_files = std::distance(std::filesystem::directory_iterator(cache_dir.GetPath()),
+                                     std::filesystem::directory_iterator());
+    EXPECT_EQ(1u, num_files);
+  }
+}
+
 }  // namespace art
@@ -30,6 +30,7 @@ import com.android.server.art.model.DexoptResult;
 import dalvik.system.DexFile;
 
 import java.util.List;
+import java.util.Locale;
 import java.util.Optional;
 import java.util.stream.Collectors;
 
@@ -77,6 +78,38 @@ public class BackgroundDexoptJobStatsReporter {
                 0L /* deprecated */, getDexoptedPackagesCount(packageDexoptResults),
                 getPackagesDependingOnBootClasspathCount(packageDexoptResults),
                 packageDexoptResults.size(), toStatsdPassEnum(pass));
+
+        logThroughput(pass, packageDexoptResults, durationMs);
+    }
+
+    private static void logThroughput(@BatchDexoptPass int pass,
+            @NonNull List<DexoptResult.PackageDexoptResult> packageResults, long durationMs) {
+        List<DexoptResult.DexContainerFileDexoptResult> performedResults =
+                packageResults.stream()
+                        .flatMap(packageResult
+                                -> packageResult.getDexContainerFileDexoptResults().stream())
+                        .filter(fileResult
+                                -> fileResult.getStatus() == DexoptResult.DEXOPT_PERFORMED)
+                        .collect(Collectors.toList());
+        long wallTimeMs = performedResults.stream()
+                                  .mapToLong(DexoptResult.DexContainerFileDexoptResult
+                                                  ::getDex2oatWallTimeMillis)
+                                  .sum();
+        long cpuTimeMs = performedResults.stream()
+                                 .mapToLong(DexoptResult.DexContainerFileDexoptResult
+                                                 ::getDex2oatCpuTimeMillis)
+                                 .sum();
+        long sizeBytes = performedResults.stream()
+                                 .mapToLong(DexoptResult.DexContainerFileDexoptResult::getSizeBytes)
+                                 .sum();
+        // The sum of dex2oat wall times over the job duration is the effective parallelism.
+        AsLog.i(String.format(Locale.ROOT,
+                "Background dexopt pass %d: %d files in %dms (%.2f files/s), "
+                        + "dex2oat wall time %dms, cpu time %dms, parallelism %.2f, "
+                        + "output %d bytes",
+                pass, performedResults.size(), durationMs,
+                durationMs > 0 ? performedResults.size() * 1000.0 / durationMs : 0.0, wallTimeMs,
+                cpuTimeMs, durationMs > 0 ? (double) wallTimeMs / durationMs : 0.0, sizeBytes));
     }
 
     @NonNull
@@ -18,8 +18,12 @@
 
 #include <sys/stat.h>
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <thread>
 
 #include "android-base/stringprintf.h"
 #include "base/bit_utils.h"
@@ -51,8 +55,14 @@ namespace {
 // seems an excessive number.
 static constexpr size_t kWarnOnManyDexFilesThreshold = 100;
 
+// Maximum number of threads used to verify the dex files of a multidex APK.
+static constexpr size_t kMaxVerificationThreads = 4;
+
 using android::base::StringPrintf;
 
+std::mutex extraction_cache_dir_lock;
+std::string extraction_cache_dir;
+
 class VectorContainer : public DexFileContainer {
  public:
   explicit VectorContainer(std::vector<uint8_t>&& vector) : vector_(std::move(vector)) { }
@@ -126,6 +136,16 @@ class MemMapContainer : public DexFileContainer {
 
 const File DexFileLoader::kInvalidFile;
 
+void DexFileLoader::SetExtractionCacheDirectory(const std::string& cache_dir) {
+  std::lock_guard<std::mutex> lock(extraction_cache_dir_lock);
+  extraction_cache_dir = cache_dir;
+}
+
+std::string DexFileLoader::GetExtractionCacheDirectory() {
+  std::lock_guard<std::mutex> lock(extraction_cache_dir_lock);
+  return extraction_cache_dir;
+}
+
 bool DexFileLoader::IsMagicValid(uint32_t magic) {
   return IsMagicValid(reinterpret_cast<uint8_t*>(&magic));
 }
@@ -371,13 +391,16 @@ bool DexFileLoader::Open(bool verify,
       DCHECK(!error_msg->empty());
       return false;
     }
+    // Dex files are verified once all entries are open, so that the dex files
+    // of a multidex APK can be verified in parallel.
+    const size_t first_dex_file = dex_files->size();
     size_t multidex_count = 0;
     for (size_t i = 0;; ++i) {
       std::string name = GetMultiDexClassesDexName(i);
       bool ok = OpenFromZipEntry(*zip_archive,
                                  name.c_str(),
                                  location_,
-                                 verify,
+                                 /*verify=*/ false,
                                  verify_checksum,
                                  &multidex_count,
                                  error_code,
@@ -387,7 +410,15 @@ bool DexFileLoader::Open(bool verify,
         // We keep opening consecutive dex entries as long as we can (until entry is not found).
         if (*error_code == DexFileLoaderErrorCode::kEntryNotFound) {
           // Success if we loaded at least one entry, or if empty zip is explicitly allowed.
-          return i > 0 || allow_no_dex_files;
+          if (i == 0) {
+            return allow_no_dex_files;
+          }
+          if (verify && !VerifyDexFiles(first_dex_file, verify_checksum, error_msg, dex_files)) {
+            *error_code = DexFileLoaderErrorCode::kVerifyError;
+            return false;
+          }
+          *error_code = DexFileLoaderErrorCode::kNoError;
+          return true;
         }
         return false;
       }
@@ -434,6 +465,53 @@ bool DexFileLoader::Open(bool verify,
   return false;
 }
 
+bool DexFileLoader::VerifyDexFiles(size_t first_dex_file,
+                                   bool verify_checksum,
+                                   std::string* error_msg,
+                                   std::vector<std::unique_ptr<const DexFile>>* dex_files) {
+  DCHECK_LE(first_dex_file, dex_files->size());
+  const size_t num_dex_files = dex_files->size() - first_dex_file;
+  std::vector<std::string> error_msgs(num_dex_files);
+  // Not `std::vector<bool>`, as threads write to adjacent elements.
+  std::unique_ptr<bool[]> verified(new bool[num_dex_files]);
+  std::atomic<size_t> next_index(0u);
+  auto verify_dex_files = [&]() {
+    for (size_t i = next_index.fetch_add(1u, std::memory_order_relaxed);
+         i < num_dex_files;
+         i = next_index.fetch_add(1u, std::memory_order_relaxed)) {
+      const DexFile* dex_file = (*dex_files)[first_dex_file + i].get();
+      // NB: Dex verifier does not understand the compact dex format.
+      DCHECK(!dex_file->IsCompactDexFile());
+      DEXFILE_SCOPED_TRACE(std::string("Verify dex file ") + dex_file->GetLocation());
+      verified[i] = dex::Verify(
+          dex_file, dex_file->GetLocation().c_str(), verify_checksum, &error_msgs[i]);
+    }
+  };
+
+  const size_t num_threads = std::min<size_t>(
+      {num_dex_files, kMaxVerificationThreads, std::max(1u, std::thread::hardware_concurrency())});
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads > 0u ? num_threads - 1u : 0u);
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back(verify_dex_files);
+  }
+  verify_dex_files();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  // Report the first failure in dex file order, and only keep the dex files
+  // that precede it, as if they had been verified one after the other.
+  for (size_t i = 0; i != num_dex_files; ++i) {
+    if (!verified[i]) {
+      *error_msg = std::move(error_msgs[i]);
+      dex_files->resize(first_dex_file + i);
+      return false;
+    }
+  }
+  return true;
+}
+
 std::unique_ptr<DexFile> DexFileLoader::OpenCommon(std::shared_ptr<DexFileContainer> container,
                                                    const uint8_t* base,
                                                    size_t app_compat_size,
@@ -535,8 +613,26 @@ bool DexFileLoader::OpenFromZipEntry(const ZipArchive& zip_archive,
   if (!map.IsValid()) {
     DEXFILE_SCOPED_TRACE(std::string("Extract dex file ") + location);
 
+    // Prefer extracting to a file-backed cache, whose pages the kernel can
+    // reclaim, over anonymous memory.
+    std::string cache_dir = GetExtractionCacheDirectory();
+    if (!cache_dir.empty()) {
+      std::string cache_error_msg;
+      map = zip_entry->ExtractToCacheFile(
+          location.c_str(), entry_name, cache_dir, &cache_error_msg);
+      if (map.IsValid()) {
+        is_file_map = true;
+      } else {
+        LOG(WARNING) << "Can't extract dex file " << location << "!" << entry_name << " to "
+                     << cache_dir << ": " << cache_error_msg
+                     << ". Falling back to extracting to memory.";
+      }
+    }
+  }
+  if (!map.IsValid()) {
     // Default path for compressed ZIP entries,
     // and fallback for stored ZIP entries.
+    is_file_map = false;
     map = zip_entry->ExtractToMemMap(location.c_str(), entry_name, error_msg);
   }
   if (!map.IsValid()) {
@@ -160,6 +160,12 @@ class DexFileLoader {
     return (pos == std::string::npos) ? std::string() : location.substr(pos);
   }
 
+  // Set the directory used to cache dex files extracted from compressed zip
+  // entries. If empty (the default), compressed entries are extracted to
+  // anonymous memory.
+  static void SetExtractionCacheDirectory(const std::string& cache_dir);
+  static std::string GetExtractionCacheDirectory();
+
   DexFileLoader(const char* filename, const File* file, const std::string& location)
       : filename_(filename), file_(file), location_(location) {
     CHECK(file != nullptr);  // Must be non-null, but may be invalid.
@@ -310,6 +316,14 @@ class DexFileLoader {
                                              std::unique_ptr<DexFileContainer> container,
                                              VerifyResult* verify_result);
 
+  // Verify the dex files starting at `first_dex_file` in `dex_files`, using
+  // several threads if there is more than one. On failure, removes the dex
+  // file that failed verification and the ones after it.
+  static bool VerifyDexFiles(size_t first_dex_file,
+                             bool verify_checksum,
+                             /*out*/ std::string* error_msg,
+                             /*inout*/ std::vector<std::unique_ptr<const DexFile>>* dex_files);
+
   // Open .dex files from the entry_name in a zip archive.
   bool OpenFromZipEntry(const ZipArchive& zip_archive,
                         const char* entry_name,
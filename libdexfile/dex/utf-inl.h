@@ -19,8 +19,27 @@
 
 #include "utf.h"
 
+#include <string.h>
+
 namespace art {
 
+inline bool IsAsciiUtf8(const char* utf8, size_t byte_count) {
+  // OR all bytes together and check the high bits once at the end. The main loop has no
+  // data-dependent branches, so compilers turn it into SIMD code on all supported ISAs.
+  static constexpr uint64_t kHighBits = UINT64_C(0x8080808080808080);
+  uint64_t bits = 0u;
+  size_t i = 0u;
+  for (; byte_count - i >= sizeof(uint64_t); i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, utf8 + i, sizeof(word));
+    bits |= word;
+  }
+  for (; i != byte_count; ++i) {
+    bits |= static_cast<uint8_t>(utf8[i]);
+  }
+  return (bits & kHighBits) == 0u;
+}
+
 inline uint16_t GetTrailingUtf16Char(uint32_t maybe_pair) {
   return static_cast<uint16_t>(maybe_pair >> 16);
 }
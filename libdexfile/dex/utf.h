@@ -40,6 +40,12 @@ namespace art {
 size_t CountModifiedUtf8Chars(const char* utf8);
 size_t CountModifiedUtf8Chars(const char* utf8, size_t byte_count);
 
+/*
+ * Returns true if none of the `byte_count` bytes has the high bit set, i.e. the input
+ * consists of one-byte sequences only. Checks a word at a time.
+ */
+ALWAYS_INLINE bool IsAsciiUtf8(const char* utf8, size_t byte_count);
+
 /*
  * Convert from Modified UTF-8 to UTF-16.
  */
@@ -380,6 +380,21 @@ TEST_F(UtfTest, ExhaustiveBidirectionalCodePointCheck) {
   }
 }
 
+TEST_F(UtfTest, IsAsciiUtf8) {
+  EXPECT_TRUE(IsAsciiUtf8("", 0u));
+  const std::string ascii = "The quick brown fox jumps over the lazy dog";
+  for (size_t length = 0; length <= ascii.size(); ++length) {
+    EXPECT_TRUE(IsAsciiUtf8(ascii.data(), length)) << length;
+  }
+  // Put a non-ASCII byte at every position, covering both the word loop and the tail.
+  for (size_t pos = 0; pos != ascii.size(); ++pos) {
+    std::string input = ascii;
+    input[pos] = '\xc4';
+    EXPECT_FALSE(IsAsciiUtf8(input.data(), input.size())) << pos;
+    EXPECT_TRUE(IsAsciiUtf8(input.data(), pos)) << pos;
+  }
+}
+
 TEST_F(UtfTest, NonAscii) {
   const char kNonAsciiCharacter = '\x80';
   const char input[] = { kNonAsciiCharacter, '\0' };
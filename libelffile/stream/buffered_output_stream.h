@@ -38,7 +38,9 @@ class BufferedOutputStream final : public OutputStream {
   bool Flush() override;
 
  private:
-  static const size_t kBufferSize = 8 * KB;
+  // Oat files are written through many small `WriteFully()` calls (method headers, code,
+  // padding), so use a buffer large enough to keep the number of write syscalls low.
+  static const size_t kBufferSize = 64 * KB;
 
   bool FlushBuffer();
 
@@ -389,11 +389,20 @@ void* OpenNativeLibrary(JNIEnv* env,
     }
   }
 
-  std::lock_guard<std::mutex> guard(g_namespaces_mutex);
-
   {
-    NativeLoaderNamespace* ns = g_namespaces->FindNamespaceByClassLoader(env, class_loader);
-    if (ns != nullptr) {
+    // Look up the namespace under the lock but load the library without it, so that threads
+    // loading libraries from different (or the same) class loaders do not serialize on
+    // `g_namespaces_mutex` for the whole `android_dlopen_ext()`. Namespaces are never removed
+    // outside of tests, and the copy only holds the name and the linker namespace pointer.
+    std::optional<NativeLoaderNamespace> ns;
+    {
+      std::lock_guard<std::mutex> guard(g_namespaces_mutex);
+      NativeLoaderNamespace* found = g_namespaces->FindNamespaceByClassLoader(env, class_loader);
+      if (found != nullptr) {
+        ns = *found;
+      }
+    }
+    if (ns.has_value()) {
       *needs_native_bridge = ns->IsBridged();
       Result<void*> handle = ns->Load(path);
       ALOGD("Load %s using ns %s from class loader (caller=%s): %s",
@@ -409,6 +418,20 @@ void* OpenNativeLibrary(JNIEnv* env,
     }
   }
 
+  std::lock_guard<std::mutex> guard(g_namespaces_mutex);
+
+  // Another thread may have created the namespace for this class loader in the meantime.
+  if (NativeLoaderNamespace* ns = g_namespaces->FindNamespaceByClassLoader(env, class_loader);
+      ns != nullptr) {
+    *needs_native_bridge = ns->IsBridged();
+    Result<void*> handle = ns->Load(path);
+    if (!handle.ok()) {
+      *error_msg = strdup(handle.error().message().c_str());
+      return nullptr;
+    }
+    return handle.value();
+  }
+
   // This is the case where the classloader was not created by ApplicationLoaders
   // In this case we create an isolated not-shared namespace for it.
   const std::string empty_dex_path;
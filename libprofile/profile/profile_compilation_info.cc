@@ -2376,9 +2376,11 @@ ProfileCompilationInfo::DexFileData::FindOrAddHotMethod(uint16_t method_index) {
     LOG(ERROR) << "Invalid method index " << method_index << ". num_method_ids=" << num_method_ids;
     return nullptr;
   }
-  return &(method_map.FindOrAdd(
-      method_index,
-      InlineCacheMap(std::less<uint16_t>(), allocator_->Adapter(kArenaAllocProfile)))->second);
+  // Use a single lookup and construct the empty `InlineCacheMap` only if the method is new.
+  // This is on the hot path of `MergeWith()` and `Load()` for profiles with many hot methods.
+  return &method_map.GetOrCreate(method_index, [this]() {
+    return InlineCacheMap(std::less<uint16_t>(), allocator_->Adapter(kArenaAllocProfile));
+  });
 }
 
 // Mark a method as executed at least once.
@@ -2461,7 +2463,8 @@ uint16_t ProfileCompilationInfo::DexFileData::GetUsedBitmapFlags() const {
 
 ProfileCompilationInfo::DexPcData*
 ProfileCompilationInfo::FindOrAddDexPc(InlineCacheMap* inline_cache, uint32_t dex_pc) {
-  return &(inline_cache->FindOrAdd(dex_pc, DexPcData(inline_cache->get_allocator()))->second);
+  return &inline_cache->GetOrCreate(
+      dex_pc, [inline_cache]() { return DexPcData(inline_cache->get_allocator()); });
 }
 
 HashSet<std::string> ProfileCompilationInfo::GetClassDescriptors(
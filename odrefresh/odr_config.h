@@ -56,7 +56,8 @@ const std::unordered_set<std::string> kIgnoredSystemProperties{
     "dalvik.vm.restore-dex2oat-cpu-set",
     "dalvik.vm.restore-dex2oat-threads",
     "dalvik.vm.background-dex2oat-cpu-set",
-    "dalvik.vm.background-dex2oat-threads"};
+    "dalvik.vm.background-dex2oat-threads",
+    "dalvik.vm.odrefresh-system-server-jobs"};
 
 struct SystemPropertyConfig {
   const char* name;
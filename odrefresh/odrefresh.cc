@@ -28,6 +28,7 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cstdarg>
 #include <cstdint>
@@ -42,6 +43,7 @@
 #include <iostream>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <ostream>
 #include <set>
@@ -49,6 +51,7 @@
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
@@ -1320,6 +1323,11 @@ WARN_UNUSED PreconditionCheckResult OnDeviceRefresh::CheckPreconditionForData(
   // Note that apex_info_list may omit APEXes that are included in cached_module_info - e.g. if an
   // apex used to be compilable, but now isn't. That won't be detected by this loop, but will be
   // detected below in CheckComponents.
+  //
+  // A version change of a module other than the ART module does not invalidate the artifacts on
+  // its own. The artifacts only depend on the contents of the jars, which are compared below by
+  // size and checksums, so an update that leaves the classpath jars untouched keeps the artifacts.
+  bool modules_changed = false;
   for (const apex::ApexInfo& current_apex_info : apex_info_list) {
     auto& apex_name = current_apex_info.getModuleName();
 
@@ -1332,8 +1340,7 @@ WARN_UNUSED PreconditionCheckResult OnDeviceRefresh::CheckPreconditionForData(
 
     const art_apex::ModuleInfo* cached_module_info = it->second;
     if (!CheckModuleInfo(*cached_module_info, current_apex_info)) {
-      return PreconditionCheckResult::BootImageMainlineExtensionNotOk(
-          OdrMetrics::Trigger::kApexVersionMismatch);
+      modules_changed = true;
     }
   }
 
@@ -1381,6 +1388,10 @@ WARN_UNUSED PreconditionCheckResult OnDeviceRefresh::CheckPreconditionForData(
     return PreconditionCheckResult::SystemServerNotOk(OdrMetrics::Trigger::kDexFilesChanged);
   }
 
+  if (modules_changed) {
+    LOG(INFO) << "APEX versions changed but classpath contents did not, keeping artifacts";
+  }
+
   return PreconditionCheckResult::AllOk();
 }
 
@@ -2098,21 +2109,60 @@ OnDeviceRefresh::CompileSystemServer(const std::string& staging_dir,
     return CompilationResult::Error(OdrMetrics::Status::kNoSpace, "Insufficient space");
   }
 
+  // The class loader context of a jar only refers to the dex files of the jars before it, not to
+  // their compilation artifacts, so all the jars can be compiled independently.
+  std::vector<std::pair<std::string, std::vector<std::string>>> jobs;
   for (const std::string& jar : all_systemserver_jars_) {
     if (ContainsElement(system_server_jars_to_compile, jar)) {
-      CompilationResult current_result =
-          RunDex2oatForSystemServer(staging_dir, jar, classloader_context);
-      result.Merge(current_result);
+      jobs.emplace_back(jar, classloader_context);
+    }
 
-      if (current_result.IsOk()) {
+    if (ContainsElement(systemserver_classpath_jars_, jar)) {
+      classloader_context.emplace_back(jar);
+    }
+  }
+
+  std::vector<CompilationResult> job_results(jobs.size());
+  std::atomic<size_t> next_job = 0u;
+  std::mutex on_dex2oat_success_lock;
+  auto run_jobs = [&]() {
+    for (size_t i = next_job++; i < jobs.size(); i = next_job++) {
+      const auto& [jar, context] = jobs[i];
+      job_results[i] = RunDex2oatForSystemServer(staging_dir, jar, context);
+      LOG(INFO) << ART_FORMAT(
+          "Compilation of {} took {}ms", Basename(jar), job_results[i].elapsed_time_ms);
+      if (job_results[i].IsOk()) {
+        std::lock_guard<std::mutex> lock(on_dex2oat_success_lock);
         on_dex2oat_success();
-      } else {
-        LOG(ERROR) << ART_FORMAT("Compilation of {} failed: {}", Basename(jar), result.error_msg);
       }
     }
+  };
 
-    if (ContainsElement(systemserver_classpath_jars_, jar)) {
-      classloader_context.emplace_back(jar);
+  // Each dex2oat invocation still uses the threads given by `dalvik.vm.boot-dex2oat-threads`, so
+  // the two properties should be set together to stay within the CPU and memory budget.
+  uint64_t num_parallel_jobs = 1u;
+  std::string jobs_property =
+      config_.GetSystemProperties().GetOrEmpty("dalvik.vm.odrefresh-system-server-jobs");
+  if (!jobs_property.empty() && !android::base::ParseUint(jobs_property, &num_parallel_jobs)) {
+    LOG(WARNING) << "Invalid dalvik.vm.odrefresh-system-server-jobs: " << jobs_property;
+    num_parallel_jobs = 1u;
+  }
+  num_parallel_jobs =
+      std::clamp<uint64_t>(num_parallel_jobs, 1u, std::max<uint64_t>(jobs.size(), 1u));
+  std::vector<std::thread> threads;
+  for (uint64_t i = 1; i < num_parallel_jobs; ++i) {
+    threads.emplace_back(run_jobs);
+  }
+  run_jobs();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (size_t i = 0; i != jobs.size(); ++i) {
+    result.Merge(job_results[i]);
+    if (!job_results[i].IsOk()) {
+      LOG(ERROR) << ART_FORMAT(
+          "Compilation of {} failed: {}", Basename(jobs[i].first), result.error_msg);
     }
   }
 
@@ -85,7 +85,10 @@ DeoptManager::DeoptManager()
     breakpoint_status_lock_("JVMTI_BreakpointStatusLock",
                             static_cast<art::LockLevel>(art::LockLevel::kAbortLock + 1)),
     inspection_callback_(this),
-    set_local_variable_called_(false) { }
+    set_local_variable_called_(false),
+    debuggable_transition_lock_("JVMTI_DebuggableTransitionLock",
+                                art::LockLevel::kPostUserCodeSuspensionTopLevelLock),
+    debuggable_transition_pending_(false) { }
 
 void DeoptManager::Setup() {
   art::ScopedThreadStateChange stsc(art::Thread::Current(),
@@ -172,6 +175,31 @@ void DeoptManager::FinishSetup() {
                << "kArtTiVersion (0x" << std::hex << kArtTiVersion << ") environments are "
                << "available. Some functionality might not work properly.";
 
+  if (runtime->IsJvmtiLightAttach()) {
+    // Keep the compiled code until something needs to deoptimize. Inspecting threads, stacks
+    // and the heap works without it.
+    LOG(INFO) << "Light attach: deferring the switch to debuggable until it is needed.";
+    debuggable_transition_pending_.store(true, std::memory_order_release);
+    return;
+  }
+  TransitionToDebuggable();
+}
+
+void DeoptManager::MaybeTransitionToDebuggable(art::Thread* self) {
+  if (!debuggable_transition_pending_.load(std::memory_order_acquire)) {
+    return;
+  }
+  art::ScopedThreadStateChange sts(self, art::ThreadState::kSuspended);
+  art::MutexLock mu(self, debuggable_transition_lock_);
+  // Another thread may have done the switch while we were waiting for the lock.
+  if (debuggable_transition_pending_.load(std::memory_order_relaxed)) {
+    TransitionToDebuggable();
+    debuggable_transition_pending_.store(false, std::memory_order_release);
+  }
+}
+
+void DeoptManager::TransitionToDebuggable() {
+  art::Runtime* runtime = art::Runtime::Current();
   // Transition the runtime to debuggable:
   // 1. Wait for any background verification tasks to finish. We don't support
   // background verification after moving to debuggable state.
@@ -229,6 +257,7 @@ void DeoptManager::AddMethodBreakpoint(art::ArtMethod* method) {
   DCHECK(!method->IsNative()) << method->PrettyMethod();
 
   art::Thread* self = art::Thread::Current();
+  MaybeTransitionToDebuggable(self);
   method = method->GetCanonicalMethod();
   bool is_default = method->IsDefault();
 
@@ -490,6 +519,7 @@ void DeoptManager::RemoveDeoptimizationRequester() {
 
 void DeoptManager::AddDeoptimizationRequester() {
   art::Thread* self = art::Thread::Current();
+  MaybeTransitionToDebuggable(self);
   art::ScopedThreadStateChange stsc(self, art::ThreadState::kSuspended);
   deoptimization_status_lock_.ExclusiveLock(self);
   deopter_count_++;
@@ -506,13 +536,10 @@ void DeoptManager::AddDeoptimizationRequester() {
 }
 
 void DeoptManager::DeoptimizeThread(art::Thread* target) {
-  // We might or might not be running on the target thread (self) so get Thread::Current
-  // directly.
-  art::ScopedThreadSuspension sts(art::Thread::Current(), art::ThreadState::kSuspended);
-  art::gc::ScopedGCCriticalSection sgccs(art::Thread::Current(),
-                                         art::gc::GcCause::kGcCauseDebugger,
-                                         art::gc::CollectorType::kCollectorTypeDebugger);
-  art::ScopedSuspendAll ssa("Instrument thread stack");
+  // All callers run this in a checkpoint of `target`, i.e., either on the target itself or on a
+  // thread that found it suspended, so its stack cannot change under us and there is no need to
+  // stop every other thread.
+  DCHECK(target == art::Thread::Current() || target->IsSuspended());
   // Prepare the stack so methods can be deoptimized as and when required.
   // This by itself doesn't cause any methods to deoptimize but enables
   // deoptimization on demand.
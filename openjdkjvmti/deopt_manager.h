@@ -112,6 +112,13 @@ class DeoptManager {
 
   void FinishSetup() REQUIRES(!deoptimization_status_lock_, !art::Roles::uninterruptible_);
 
+  // With -Xjvmti-light-attach, a late attach leaves the runtime non-debuggable. Callers that
+  // need debuggable code, such as deoptimization requesters, call this to do the switch first.
+  void MaybeTransitionToDebuggable(art::Thread* self)
+      REQUIRES(!deoptimization_status_lock_,
+               !debuggable_transition_lock_,
+               !art::Roles::uninterruptible_);
+
   static DeoptManager* Get();
 
   bool HaveLocalsChanged() const {
@@ -159,6 +166,9 @@ class DeoptManager {
       RELEASE(deoptimization_status_lock_)
       REQUIRES(!art::Roles::uninterruptible_, !art::Locks::mutator_lock_);
 
+  // Switch a running non-debuggable runtime to debuggable. Suspends all threads.
+  void TransitionToDebuggable() REQUIRES(!art::Roles::uninterruptible_);
+
   static constexpr const char* kDeoptManagerInstrumentationKey = "JVMTI_DeoptManager";
 
   art::Mutex deoptimization_status_lock_ ACQUIRED_BEFORE(art::Locks::classlinker_classes_lock_);
@@ -185,6 +195,11 @@ class DeoptManager {
   // OSR after this.
   std::atomic<bool> set_local_variable_called_;
 
+  // Serializes the deferred switch to debuggable.
+  art::Mutex debuggable_transition_lock_;
+  // Set when a light attach deferred the switch to debuggable.
+  std::atomic<bool> debuggable_transition_pending_;
+
   // Helper for setting up/tearing-down for deoptimization.
   friend class ScopedDeoptimizationContext;
 };
@@ -758,6 +758,11 @@ static jvmtiError DoIterateThroughHeap(T fn,
   const HeapFilter heap_filter(heap_filter_int);
   art::StackHandleScope<1> hs(self);
   art::Handle<art::mirror::Class> filter_klass(hs.NewHandle(soa.Decode<art::mirror::Class>(klass)));
+  // Heap objects are mostly laid out in runs of the same class, so remember the tag of the last
+  // class we looked up. This halves the number of tag table lookups (each taking the table lock)
+  // for a typical walk. Objects do not move during the walk, so the raw pointer is a stable key.
+  art::mirror::Class* cached_klass = nullptr;
+  jlong cached_class_tag = 0;
   auto visitor = [&](art::mirror::Object* obj) REQUIRES_SHARED(art::Locks::mutator_lock_) {
     // Early return, as we can't really stop visiting.
     if (stop_reports) {
@@ -766,24 +771,29 @@ static jvmtiError DoIterateThroughHeap(T fn,
 
     art::ScopedAssertNoThreadSuspension no_suspension("IterateThroughHeapCallback");
 
+    art::ObjPtr<art::mirror::Class> klass = obj->GetClass();
+    // Check the class filter first, it does not need any tag lookups.
+    if (filter_klass != nullptr) {
+      if (filter_klass.Get() != klass) {
+        return;
+      }
+    }
+
     jlong tag = 0;
     tag_table->GetTag(obj, &tag);
 
-    jlong class_tag = 0;
-    art::ObjPtr<art::mirror::Class> klass = obj->GetClass();
-    tag_table->GetTag(klass.Ptr(), &class_tag);
+    if (klass.Ptr() != cached_klass) {
+      cached_class_tag = 0;
+      tag_table->GetTag(klass.Ptr(), &cached_class_tag);
+      cached_klass = klass.Ptr();
+    }
+    jlong class_tag = cached_class_tag;
     // For simplicity, even if we find a tag = 0, assume 0 = not tagged.
 
     if (!heap_filter.ShouldReportByHeapFilter(tag, class_tag)) {
       return;
     }
 
-    if (filter_klass != nullptr) {
-      if (filter_klass.Get() != klass) {
-        return;
-      }
-    }
-
     jlong size = obj->SizeOf();
 
     jint length = -1;
@@ -813,6 +823,12 @@ static jvmtiError DoIterateThroughHeap(T fn,
     if (!stop_reports) {
       stop_reports = ReportPrimitiveField::Report(obj, tag_table, callbacks, user_data);
     }
+
+    // The callbacks above may have retagged this object. If it is the cached class, look its tag
+    // up again for the next instance.
+    if (obj == cached_klass) {
+      cached_klass = nullptr;
+    }
   };
   art::Runtime::Current()->GetHeap()->VisitObjects(visitor);
 
@@ -1130,6 +1130,7 @@ jvmtiError MethodUtil::SetLocalVariableGeneric(jvmtiEnv* env,
   // TODO We should really keep track of this at the Frame granularity.
   DeoptManager::Get()->SetLocalsUpdated();
   art::Thread* self = art::Thread::Current();
+  DeoptManager::Get()->MaybeTransitionToDebuggable(self);
   art::ScopedObjectAccess soa(self);
   art::Locks::thread_list_lock_->ExclusiveLock(self);
   art::Thread* target = nullptr;
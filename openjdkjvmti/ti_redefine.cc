@@ -64,6 +64,7 @@
 #include "class_root-inl.h"
 #include "class_status.h"
 #include "debugger.h"
+#include "deopt_manager.h"
 #include "dex/art_dex_file_loader.h"
 #include "dex/class_accessor-inl.h"
 #include "dex/class_accessor.h"
@@ -600,6 +601,7 @@ jvmtiError Redefiner::RedefineClassesGeneric(jvmtiEnv* jenv,
     JVMTI_LOG(WARNING, env) << "FAILURE TO REDEFINE null definitions!";
     return ERR(NULL_POINTER);
   }
+  DeoptManager::Get()->MaybeTransitionToDebuggable(self);
   std::string error_msg;
   std::vector<ArtClassDefinition> def_vector;
   def_vector.reserve(class_count);
@@ -1727,24 +1729,19 @@ bool CompareClasses(art::ObjPtr<art::mirror::Class> l, art::ObjPtr<art::mirror::
   return parents(l.Ptr()) < parents(r.Ptr());
 }
 
-bool Redefiner::ClassRedefinition::CollectAndCreateNewInstances(
-    /*out*/ RedefinitionDataIter* cur_data) {
-  if (!cur_data->IsInitialStructural()) {
+art::ObjPtr<art::mirror::Class> Redefiner::ClassRedefinition::GetInstanceCollectionClass(
+    const RedefinitionDataIter& cur_data) {
+  if (!cur_data.IsInitialStructural()) {
     // An earlier structural redefinition already remade all the instances.
-    return true;
+    return nullptr;
   }
-  art::gc::Heap* heap = driver_->runtime_->GetHeap();
+  return cur_data.GetMirrorClass();
+}
+
+bool Redefiner::ClassRedefinition::CreateNewInstances(
+    art::ArrayRef<const art::Handle<art::mirror::Object>> old_instances,
+    /*out*/ RedefinitionDataIter* cur_data) {
   art::VariableSizedHandleScope hs(driver_->self_);
-  art::Handle<art::mirror::Class> old_klass(hs.NewHandle(cur_data->GetMirrorClass()));
-  std::vector<art::Handle<art::mirror::Object>> old_instances;
-  auto is_instance = [&](art::mirror::Object* obj) REQUIRES_SHARED(art::Locks::mutator_lock_) {
-    return obj->InstanceOf(old_klass.Get());
-  };
-  heap->VisitObjects([&](art::mirror::Object* obj) REQUIRES_SHARED(art::Locks::mutator_lock_) {
-    if (is_instance(obj)) {
-      old_instances.push_back(hs.NewHandle(obj));
-    }
-  });
   VLOG(plugin) << "Collected " << old_instances.size() << " instances to recreate!";
   art::Handle<art::mirror::ObjectArray<art::mirror::Class>> old_classes_arr(
       hs.NewHandle(cur_data->GetOldClasses()));
@@ -2208,11 +2205,43 @@ bool Redefiner::EnsureAllClassAllocationsFinished(RedefinitionDataHolder& holder
 }
 
 bool Redefiner::CollectAndCreateNewInstances(RedefinitionDataHolder& holder) {
+  art::VariableSizedHandleScope hs(self_);
+  std::vector<art::Handle<art::mirror::Class>> old_klasses;
+  for (RedefinitionDataIter data = holder.begin(); data != holder.end(); ++data) {
+    art::ObjPtr<art::mirror::Class> klass = data.GetRedefinition().GetInstanceCollectionClass(data);
+    if (!klass.IsNull()) {
+      old_klasses.push_back(hs.NewHandle(klass));
+    }
+  }
+  if (old_klasses.empty()) {
+    // Nothing changes object layouts so there is no need to walk the heap.
+    return true;
+  }
+  // Collect the instances of all the redefined classes in a single heap walk. No class here is a
+  // subtype of another one (those are handled by the supertype's redefinition) so each object is
+  // an instance of at most one of them.
+  std::vector<std::vector<art::Handle<art::mirror::Object>>> old_instances(old_klasses.size());
+  runtime_->GetHeap()->VisitObjects(
+      [&](art::mirror::Object* obj) REQUIRES_SHARED(art::Locks::mutator_lock_) {
+        for (size_t i = 0; i < old_klasses.size(); ++i) {
+          if (obj->InstanceOf(old_klasses[i].Get())) {
+            old_instances[i].push_back(hs.NewHandle(obj));
+            break;
+          }
+        }
+      });
+  size_t i = 0;
   for (RedefinitionDataIter data = holder.begin(); data != holder.end(); ++data) {
+    if (data.GetRedefinition().GetInstanceCollectionClass(data).IsNull()) {
+      continue;
+    }
+    DCHECK_EQ(data.GetMirrorClass(), old_klasses[i].Get());
     // Allocate the data this redefinition requires.
-    if (!data.GetRedefinition().CollectAndCreateNewInstances(&data)) {
+    art::ArrayRef<const art::Handle<art::mirror::Object>> instances(old_instances[i]);
+    if (!data.GetRedefinition().CreateNewInstances(instances, &data)) {
       return false;
     }
+    ++i;
   }
   return true;
 }
@@ -44,6 +44,7 @@
 #include "dex/class_accessor.h"
 #include "dex/dex_file.h"
 #include "dex/dex_file_structs.h"
+#include "handle.h"
 #include "jni/jni_env_ext-inl.h"
 #include "jvmti.h"
 #include "mirror/array.h"
@@ -175,7 +176,12 @@ class Redefiner {
     bool FinishNewClassAllocations(RedefinitionDataHolder& holder,
                                    /*out*/RedefinitionDataIter* cur_data)
         REQUIRES_SHARED(art::Locks::mutator_lock_);
-    bool CollectAndCreateNewInstances(/*out*/RedefinitionDataIter* cur_data)
+    // Returns the class whose instances need to be collected for this redefinition or null if
+    // there are none to collect.
+    art::ObjPtr<art::mirror::Class> GetInstanceCollectionClass(const RedefinitionDataIter& cur_data)
+        REQUIRES_SHARED(art::Locks::mutator_lock_);
+    bool CreateNewInstances(art::ArrayRef<const art::Handle<art::mirror::Object>> old_instances,
+                            /*out*/RedefinitionDataIter* cur_data)
         REQUIRES_SHARED(art::Locks::mutator_lock_);
 
     bool AllocateAndRememberNewDexFileCookie(
@@ -1357,6 +1357,7 @@ bool ValidReturnType<jobject>(art::Thread* self,
 
 jvmtiError StackUtil::PopFrame(jvmtiEnv* env, jthread thread) {
   art::Thread* self = art::Thread::Current();
+  DeoptManager::Get()->MaybeTransitionToDebuggable(self);
   NonStandardExitFrames<NonStandardExitType::kPopFrame> frames(self, env, thread);
   if (frames.result_ != OK) {
     art::Locks::thread_list_lock_->ExclusiveUnlock(self);
@@ -1381,6 +1382,7 @@ template <typename T>
 jvmtiError
 StackUtil::ForceEarlyReturn(jvmtiEnv* env, EventHandler* event_handler, jthread thread, T value) {
   art::Thread* self = art::Thread::Current();
+  DeoptManager::Get()->MaybeTransitionToDebuggable(self);
   // We don't want to use the null == current-thread idiom since for events (that we use internally
   // to implement force-early-return) we instead have null == all threads. Instead just get the
   // current jthread if needed.
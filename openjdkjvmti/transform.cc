@@ -43,6 +43,7 @@
 #include "base/logging.h"
 #include "base/mem_map.h"
 #include "class_linker.h"
+#include "deopt_manager.h"
 #include "dex/dex_file.h"
 #include "dex/dex_file_types.h"
 #include "dex/utf.h"
@@ -168,6 +169,7 @@ jvmtiError Transformer::RetransformClasses(jvmtiEnv* env,
     return ERR(NULL_POINTER);
   }
   art::Thread* self = art::Thread::Current();
+  DeoptManager::Get()->MaybeTransitionToDebuggable(self);
   art::Runtime* runtime = art::Runtime::Current();
   // A holder that will Deallocate all the class bytes buffers on destruction.
   std::string error_msg;
@@ -34,12 +34,14 @@
 #include <limits>
 #include <optional>
 #include <type_traits>
+#include <unordered_map>
 
 #include "android-base/file.h"
 #include "android-base/logging.h"
 #include "android-base/properties.h"
 #include "base/fast_exit.h"
 #include "base/systrace.h"
+#include "base/time_utils.h"
 #include "gc/heap-visit-objects-inl.h"
 #include "gc/heap.h"
 #include "gc/scoped_gc_critical_section.h"
@@ -412,7 +414,7 @@ class Writer {
 class ReferredObjectsFinder {
  public:
   explicit ReferredObjectsFinder(
-      std::vector<std::pair<std::string, art::mirror::Object*>>* referred_objects,
+      std::vector<std::pair<art::ArtField*, art::mirror::Object*>>* referred_objects,
       bool emit_field_ids)
       : referred_objects_(referred_objects), emit_field_ids_(emit_field_ids) {}
 
@@ -425,17 +427,15 @@ class ReferredObjectsFinder {
       return;
     }
     art::mirror::Object* ref = obj->GetFieldObject<art::mirror::Object>(offset);
-    art::ArtField* field;
-    if (is_static) {
-      field = art::ArtField::FindStaticFieldWithOffset(obj->AsClass(), offset.Uint32Value());
-    } else {
-      field = art::ArtField::FindInstanceFieldWithOffset(obj->GetClass(), offset.Uint32Value());
-    }
-    std::string field_name = "";
-    if (field != nullptr && emit_field_ids_) {
-      field_name = field->PrettyField(/*with_type=*/true);
+    art::ArtField* field = nullptr;
+    if (emit_field_ids_) {
+      if (is_static) {
+        field = art::ArtField::FindStaticFieldWithOffset(obj->AsClass(), offset.Uint32Value());
+      } else {
+        field = art::ArtField::FindInstanceFieldWithOffset(obj->GetClass(), offset.Uint32Value());
+      }
     }
-    referred_objects_->emplace_back(std::move(field_name), ref);
+    referred_objects_->emplace_back(field, ref);
   }
 
   void VisitRootIfNonNull(
@@ -446,8 +446,8 @@ class ReferredObjectsFinder {
  private:
   // We can use a raw Object* pointer here, because there are no concurrent GC threads after the
   // fork.
-  std::vector<std::pair<std::string, art::mirror::Object*>>* referred_objects_;
-  // Prettifying field names is expensive; avoid if field name will not be used.
+  std::vector<std::pair<art::ArtField*, art::mirror::Object*>>* referred_objects_;
+  // Looking up fields by offset is expensive; avoid if field name will not be used.
   bool emit_field_ids_;
 };
 
@@ -587,11 +587,11 @@ size_t EncodedSize(uint64_t n) {
 }
 
 // Returns all the references that `*obj` (an object of type `*klass`) is holding.
-std::vector<std::pair<std::string, art::mirror::Object*>> GetReferences(art::mirror::Object* obj,
+std::vector<std::pair<art::ArtField*, art::mirror::Object*>> GetReferences(art::mirror::Object* obj,
                                                                         art::mirror::Class* klass,
                                                                         bool emit_field_ids)
     REQUIRES_SHARED(art::Locks::mutator_lock_) {
-  std::vector<std::pair<std::string, art::mirror::Object*>> referred_objects;
+  std::vector<std::pair<art::ArtField*, art::mirror::Object*>> referred_objects;
   ReferredObjectsFinder objf(&referred_objects, emit_field_ids);
 
   uint32_t klass_flags = klass->GetClassFlags();
@@ -617,7 +617,7 @@ std::vector<std::pair<std::string, art::mirror::Object*>> GetReferences(art::mir
 // Returns the base for delta encoding all the `referred_objects`. If delta
 // encoding would waste space, returns 0.
 uint64_t EncodeBaseObjId(
-    const std::vector<std::pair<std::string, art::mirror::Object*>>& referred_objects,
+    const std::vector<std::pair<art::ArtField*, art::mirror::Object*>>& referred_objects,
     const art::mirror::Object* min_nonnull_ptr) REQUIRES_SHARED(art::Locks::mutator_lock_) {
   uint64_t base_obj_id = GetObjectId(min_nonnull_ptr);
   if (base_obj_id <= 1) {
@@ -721,6 +721,20 @@ class HeapGraphDumper {
     }
   }
 
+  // Returns the interned id of the pretty name of `*field`, or 0 for a null `field`. Prettifying
+  // the name is expensive, so ids are cached per field.
+  uint64_t InternField(art::ArtField* field) REQUIRES_SHARED(art::Locks::mutator_lock_) {
+    if (field == nullptr) {
+      return 0u;
+    }
+    auto it = field_ids_.find(field);
+    if (it == field_ids_.end()) {
+      uint64_t id = FindOrAppend(&interned_fields_, field->PrettyField(/*with_type=*/true));
+      it = field_ids_.emplace(field, id).first;
+    }
+    return it->second;
+  }
+
   // Writes `*obj` into `writer`.
   void WriteOneObject(art::mirror::Object* obj, Writer& writer)
       REQUIRES_SHARED(art::Locks::mutator_lock_) {
@@ -780,8 +794,7 @@ class HeapGraphDumper {
     ForInstanceReferenceField(
         klass, [klass, this](art::MemberOffset offset) NO_THREAD_SAFETY_ANALYSIS {
           auto art_field = art::ArtField::FindInstanceFieldWithOffset(klass, offset.Uint32Value());
-          reference_field_ids_->Append(
-              FindOrAppend(&interned_fields_, art_field->PrettyField(true)));
+          reference_field_ids_->Append(InternField(art_field));
         });
     type_proto->set_reference_field_id(*reference_field_ids_);
     reference_field_ids_->Reset();
@@ -814,7 +827,7 @@ class HeapGraphDumper {
                                 klass_flags != art::mirror::kClassFlagWeakReference &&
                                 klass_flags != art::mirror::kClassFlagFinalizerReference &&
                                 klass_flags != art::mirror::kClassFlagPhantomReference;
-    std::vector<std::pair<std::string, art::mirror::Object*>> referred_objects =
+    std::vector<std::pair<art::ArtField*, art::mirror::Object*>> referred_objects =
         GetReferences(obj, klass, emit_field_ids);
 
     art::mirror::Object* min_nonnull_ptr = FilterIgnoredReferencesAndFindMin(referred_objects);
@@ -822,10 +835,10 @@ class HeapGraphDumper {
     uint64_t base_obj_id = EncodeBaseObjId(referred_objects, min_nonnull_ptr);
 
     for (const auto& p : referred_objects) {
-      const std::string& field_name = p.first;
+      art::ArtField* field = p.first;
       art::mirror::Object* referred_obj = p.second;
       if (emit_field_ids) {
-        reference_field_ids_->Append(FindOrAppend(&interned_fields_, field_name));
+        reference_field_ids_->Append(InternField(field));
       }
       uint64_t referred_obj_id = GetObjectId(referred_obj);
       if (referred_obj_id) {
@@ -849,7 +862,7 @@ class HeapGraphDumper {
   // Iterates all the `referred_objects` and sets all the objects that are supposed to be ignored
   // to nullptr. Returns the object with the smallest address (ignoring nullptr).
   art::mirror::Object* FilterIgnoredReferencesAndFindMin(
-      std::vector<std::pair<std::string, art::mirror::Object*>>& referred_objects) const
+      std::vector<std::pair<art::ArtField*, art::mirror::Object*>>& referred_objects) const
       REQUIRES_SHARED(art::Locks::mutator_lock_) {
     art::mirror::Object* min_nonnull_ptr = nullptr;
     for (auto& p : referred_objects) {
@@ -894,13 +907,19 @@ class HeapGraphDumper {
 
   // Returns true if `*obj` has a type that's supposed to be ignored.
   bool IsIgnored(art::mirror::Object* obj) const REQUIRES_SHARED(art::Locks::mutator_lock_) {
-    if (obj->IsClass()) {
+    if (ignored_types_.empty() || obj->IsClass()) {
       return false;
     }
     art::mirror::Class* klass = obj->GetClass();
-    std::string temp;
-    std::string_view name(klass->GetDescriptor(&temp));
-    return std::find(ignored_types_.begin(), ignored_types_.end(), name) != ignored_types_.end();
+    auto it = ignored_classes_.find(klass);
+    if (it == ignored_classes_.end()) {
+      std::string temp;
+      std::string_view name(klass->GetDescriptor(&temp));
+      bool ignored =
+          std::find(ignored_types_.begin(), ignored_types_.end(), name) != ignored_types_.end();
+      it = ignored_classes_.emplace(klass, ignored).first;
+    }
+    return it->second;
   }
 
   // Name of classes whose instances should be ignored.
@@ -916,6 +935,12 @@ class HeapGraphDumper {
   // Map from addr (the class pointer) to its id in perfetto.protos.HeapGraph.types
   std::map<uintptr_t, uint64_t> interned_classes_{{0, 0}};
 
+  // Caches of per-field and per-class results that are expensive to compute for every object.
+  // Map from field to its id in `interned_fields_`.
+  std::unordered_map<art::ArtField*, uint64_t> field_ids_;
+  // Map from class to whether its instances are ignored.
+  mutable std::unordered_map<art::mirror::Class*, bool> ignored_classes_;
+
   // Temporary buffers: used locally in some methods and then cleared.
   std::unique_ptr<protozero::PackedVarInt> reference_field_ids_;
   std::unique_ptr<protozero::PackedVarInt> reference_object_ids_;
@@ -974,11 +999,14 @@ void ForkAndRun(art::Thread* self,
   // are unaffected by ScopedSuspendAll and in a non-fork-friendly situation
   // (e.g. inside a malloc holding a lock). This situation is quite rare, and in that case we will
   // hit the watchdog in the grand-child process if it gets stuck.
+  uint64_t start_ns = art::NanoTime();
   std::optional<art::gc::ScopedGCCriticalSection> gcs(std::in_place, self, art::gc::kGcCauseHprof,
                                                       art::gc::kCollectorTypeHprof);
 
+  uint64_t suspend_start_ns = art::NanoTime();
   std::optional<art::ScopedSuspendAll> ssa(std::in_place, __FUNCTION__, /* long_suspend=*/ true);
 
+  uint64_t fork_start_ns = art::NanoTime();
   pid_t pid = fork();
   if (pid == -1) {
     // Fork error.
@@ -987,16 +1015,28 @@ void ForkAndRun(art::Thread* self,
   }
   if (pid != 0) {
     // Parent
+    uint64_t fork_end_ns = art::NanoTime();
+    auto resume = [&]() {
+      ssa.reset();
+      gcs.reset();
+      // The app is paused from the start of the suspension until here. Also report the wait for
+      // the GC before it (which only blocks this thread) and the fork itself, which grows with
+      // the size of the page tables.
+      uint64_t end_ns = art::NanoTime();
+      LOG(INFO) << "perfetto_hprof paused " << parent_pid << " for "
+                << art::PrettyDuration(end_ns - suspend_start_ns) << " (gc wait "
+                << art::PrettyDuration(suspend_start_ns - start_ns) << ", suspend "
+                << art::PrettyDuration(fork_start_ns - suspend_start_ns) << ", fork "
+                << art::PrettyDuration(fork_end_ns - fork_start_ns) << ")";
+    };
     if (resume_parent_policy == ResumeParentPolicy::IMMEDIATELY) {
       // Stop the thread suspension as soon as possible to allow the rest of the application to
       // continue while we waitpid here.
-      ssa.reset();
-      gcs.reset();
+      resume();
     }
     parent_runnable(pid);
     if (resume_parent_policy != ResumeParentPolicy::IMMEDIATELY) {
-      ssa.reset();
-      gcs.reset();
+      resume();
     }
     return;
   }
@@ -16,8 +16,10 @@
 
 #include "boot_image_profile.h"
 
+#include <algorithm>
 #include <memory>
 #include <set>
+#include <vector>
 
 #include "android-base/file.h"
 #include "base/unix_file/fd_file.h"
@@ -238,6 +240,26 @@ bool GenerateBootImageProfile(
     }
   }
 
+  if (options.max_methods != 0u && profile_methods.size() > options.max_methods) {
+    // Keep the methods used by the most profiles. Ties are resolved by the method name
+    // thanks to the stable sort over the sorted map, so the output is deterministic.
+    using MethodIterator = decltype(profile_methods)::iterator;
+    std::vector<MethodIterator> methods_by_use;
+    methods_by_use.reserve(profile_methods.size());
+    for (auto it = profile_methods.begin(); it != profile_methods.end(); ++it) {
+      methods_by_use.push_back(it);
+    }
+    std::stable_sort(methods_by_use.begin(),
+                     methods_by_use.end(),
+                     [](MethodIterator lhs, MethodIterator rhs) {
+                       return lhs->second.GetAnnotations().size() >
+                              rhs->second.GetAnnotations().size();
+                     });
+    for (size_t i = options.max_methods; i != methods_by_use.size(); ++i) {
+      profile_methods.erase(methods_by_use[i]);
+    }
+  }
+
   for (const auto& it : flattend_data->GetClassData()) {
     const TypeReference& type_ref = it.first;
     const FlattenProfileData::ItemMetadata& metadata = it.second;
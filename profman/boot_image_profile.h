@@ -51,6 +51,10 @@ struct BootImageOptions {
   // before it gets added to the boot profile.
   uint32_t method_threshold = 10;
 
+  // The maximum number of methods in the profile, 0 for no limit. If more methods pass the
+  // `method_threshold`, only the ones present in the largest number of profiles are kept.
+  uint32_t max_methods = 0;
+
   // Whether or not we should upgrade the startup methods to hot.
   bool upgrade_startup_to_hot = true;
 
@@ -1076,6 +1076,61 @@ TEST_F(ProfileAssistantTest, TestBootImageProfileWith2RawProfiles) {
   ASSERT_EQ(output_profile_contents, expected_profile_content);
 }
 
+TEST_F(ProfileAssistantTest, TestBootImageProfileWithMaxMethods) {
+  const std::string core_dex = GetLibCoreDexFileNames()[0];
+
+  const std::string kMethodUsedByTwoProfiles = "Ljava/lang/Object;->hashCode()I";
+  const std::string kMethodUsedByProfile1 =
+      "Ljava/lang/Comparable;->compareTo(Ljava/lang/Object;)I";
+  const std::string kMethodUsedByProfile2 = "Ljava/util/HashMap;-><init>()V";
+
+  std::vector<std::string> input_data1 = {
+      "{dex1}H" + kMethodUsedByTwoProfiles,
+      "{dex1}H" + kMethodUsedByProfile1,
+  };
+  std::vector<std::string> input_data2 = {
+      "{dex1}H" + kMethodUsedByTwoProfiles,
+      "{dex1}H" + kMethodUsedByProfile2,
+  };
+
+  // All methods pass the threshold but only the most used one fits the budget.
+  std::vector<std::string> expected_data = {
+      "H" + kMethodUsedByTwoProfiles
+  };
+  std::string expected_profile_content = JoinProfileLines(expected_data);
+
+  ScratchFile profile1;
+  ScratchFile profile2;
+  EXPECT_TRUE(CreateProfile(JoinProfileLines(input_data1),
+                            profile1.GetFilename(),
+                            core_dex,
+                            /*for_boot_image=*/ true));
+  EXPECT_TRUE(CreateProfile(JoinProfileLines(input_data2),
+                            profile2.GetFilename(),
+                            core_dex,
+                            /*for_boot_image=*/ true));
+
+  ScratchFile out_profile;
+  std::vector<std::string> args;
+  args.push_back(GetProfmanCmd());
+  args.push_back("--generate-boot-image-profile");
+  args.push_back("--method-threshold=0");
+  args.push_back("--max-methods=1");
+  args.push_back("--profile-file=" + profile1.GetFilename());
+  args.push_back("--profile-file=" + profile2.GetFilename());
+  args.push_back("--out-profile-path=" + out_profile.GetFilename());
+  args.push_back("--apk=" + core_dex);
+  args.push_back("--dex-location=" + core_dex);
+
+  std::string error;
+  ASSERT_EQ(ExecAndReturnCode(args, &error), 0) << error;
+
+  std::string output_profile_contents;
+  ASSERT_TRUE(android::base::ReadFileToString(
+      out_profile.GetFilename(), &output_profile_contents));
+  ASSERT_EQ(output_profile_contents, expected_profile_content);
+}
+
 TEST_F(ProfileAssistantTest, TestProfileCreationOneNotMatched) {
   // Class names put here need to be in sorted order.
   std::vector<std::string> class_names = {
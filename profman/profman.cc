@@ -163,6 +163,8 @@ NO_RETURN static void Usage(const char *fmt, ...) {
   UsageError("  --method-threshold=percentage between 0 and 100");
   UsageError("      what threshold to apply to the methods when deciding whether or not to");
   UsageError("      include it in the final profile.");
+  UsageError("  --max-methods=<number>: the maximum number of methods to include in the final");
+  UsageError("      profile. Methods present in the most input profiles are kept.");
   UsageError("  --class-threshold=percentage between 0 and 100");
   UsageError("      what threshold to apply to the classes when deciding whether or not to");
   UsageError("      include it in the final profile.");
@@ -370,6 +372,8 @@ class ProfMan final {
                         &boot_image_options_.method_threshold,
                         0u,
                         100u);
+      } else if (option.starts_with("--max-methods=")) {
+        ParseUintOption(raw_option, "--max-methods=", &boot_image_options_.max_methods);
       } else if (option.starts_with("--class-threshold=")) {
         ParseUintOption(raw_option,
                         "--class-threshold=",
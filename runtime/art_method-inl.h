@@ -772,6 +772,20 @@ inline void ArtMethod::UpdateCounter(int32_t new_samples) {
   }
 }
 
+inline void ArtMethod::DecayCounter(uint16_t threshold) {
+  DCHECK(!IsAbstract());
+  DCHECK_EQ(threshold, Runtime::Current()->GetJITOptions()->GetWarmupThreshold());
+  if (IsMemorySharedMethod()) {
+    return;
+  }
+  uint16_t old_hotness_count = hotness_count_;
+  // A zero counter is hot and the method is already being compiled. A counter at the
+  // threshold has nothing to forget, so do not dirty it.
+  if (old_hotness_count != 0u && old_hotness_count < threshold) {
+    hotness_count_ = old_hotness_count + (threshold - old_hotness_count + 1u) / 2u;
+  }
+}
+
 inline bool ArtMethod::CounterIsHot() {
   DCHECK(!IsAbstract());
   return hotness_count_ == 0;
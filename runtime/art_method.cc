@@ -317,15 +317,30 @@ uint32_t ArtMethod::FindDexMethodIndexInOtherDexFile(const DexFile& other_dexfil
 
 uint32_t ArtMethod::FindCatchBlock(Handle<mirror::Class> exception_type,
                                    uint32_t dex_pc, bool* has_no_move_exception) {
-  // Set aside the exception while we resolve its type.
   Thread* self = Thread::Current();
+  CodeItemDataAccessor accessor(DexInstructionData());
+  // Repeated throws at the same place usually look for the same handler.
+  const void* dex_instruction = &accessor.InstructionAt(dex_pc);
+  uint32_t cached_dex_pc;
+  bool cached_has_no_move_exception;
+  if (self->GetCatchHandlerCache()->Get(dex_instruction,
+                                        exception_type.Get(),
+                                        &cached_dex_pc,
+                                        &cached_has_no_move_exception)) {
+    if (cached_dex_pc != dex::kDexNoIndex) {
+      *has_no_move_exception = cached_has_no_move_exception;
+    }
+    return cached_dex_pc;
+  }
+  // Set aside the exception while we resolve its type.
   StackHandleScope<1> hs(self);
   Handle<mirror::Throwable> exception(hs.NewHandle(self->GetException()));
   self->ClearException();
   // Default to handler not found.
   uint32_t found_dex_pc = dex::kDexNoIndex;
+  // The lookup can only be cached if all the catch types could be resolved.
+  bool can_cache = true;
   // Iterate over the catch handlers associated with dex_pc.
-  CodeItemDataAccessor accessor(DexInstructionData());
   for (CatchHandlerIterator it(accessor, dex_pc); it.HasNext(); it.Next()) {
     dex::TypeIndex iter_type_idx = it.GetHandlerTypeIndex();
     // Catch all case
@@ -340,6 +355,7 @@ uint32_t ArtMethod::FindCatchBlock(Handle<mirror::Class> exception_type,
       // removed by a pro-guard like tool.
       // Note: this is not RI behavior. RI would have failed when loading the class.
       self->ClearException();
+      can_cache = false;
       // Delete any long jump context as this routine is called during a stack walk which will
       // release its in use context at the end.
       delete self->GetLongJumpContext();
@@ -354,6 +370,12 @@ uint32_t ArtMethod::FindCatchBlock(Handle<mirror::Class> exception_type,
     const Instruction& first_catch_instr = accessor.InstructionAt(found_dex_pc);
     *has_no_move_exception = (first_catch_instr.Opcode() != Instruction::MOVE_EXCEPTION);
   }
+  if (can_cache) {
+    self->GetCatchHandlerCache()->Set(dex_instruction,
+                                      exception_type.Get(),
+                                      found_dex_pc,
+                                      found_dex_pc != dex::kDexNoIndex && *has_no_move_exception);
+  }
   // Put the exception back.
   if (exception != nullptr) {
     self->SetException(exception.Get());
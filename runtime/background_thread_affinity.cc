@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "background_thread_affinity.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "android-base/file.h"
+#include "android-base/parseint.h"
+#include "android-base/stringprintf.h"
+#include "android-base/strings.h"
+#include "base/logging.h"
+#include "gc/heap.h"
+#include "gc/task_processor.h"
+#include "jit/jit.h"
+#include "jit/profile_saver.h"
+#include "runtime.h"
+#include "thread-current-inl.h"
+#include "thread_pool.h"
+
+namespace art HIDDEN {
+
+using android::base::StringPrintf;
+
+bool BackgroundThreadAffinity::ParseThreadKinds(const std::string& spec,
+                                                uint32_t* kinds,
+                                                std::string* error_msg) {
+  *kinds = 0u;
+  if (spec.empty()) {
+    return true;
+  }
+  for (const std::string& name : android::base::Split(spec, ",")) {
+    if (name == "jit") {
+      *kinds |= kJit;
+    } else if (name == "gc") {
+      *kinds |= kGc;
+    } else if (name == "heaptask") {
+      *kinds |= kHeapTask;
+    } else if (name == "profilesaver") {
+      *kinds |= kProfileSaver;
+    } else {
+      *error_msg = StringPrintf("Unknown background thread kind '%s'", name.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<uint32_t> BackgroundThreadAffinity::FindEfficiencyCores(
+    const std::string& sysfs_cpu_dir) {
+  std::vector<uint32_t> capacities;
+  for (uint32_t cpu = 0u; cpu != CPU_SETSIZE; ++cpu) {
+    std::string content;
+    if (!android::base::ReadFileToString(
+            StringPrintf("%s/cpu%u/cpu_capacity", sysfs_cpu_dir.c_str(), cpu), &content)) {
+      break;
+    }
+    uint32_t capacity;
+    if (!android::base::ParseUint(android::base::Trim(content), &capacity)) {
+      return {};
+    }
+    capacities.push_back(capacity);
+  }
+  if (capacities.empty()) {
+    return {};
+  }
+  uint32_t max_capacity = *std::max_element(capacities.begin(), capacities.end());
+  std::vector<uint32_t> efficiency_cores;
+  for (uint32_t cpu = 0u; cpu != capacities.size(); ++cpu) {
+    if (capacities[cpu] < max_capacity) {
+      efficiency_cores.push_back(cpu);
+    }
+  }
+  return efficiency_cores;
+}
+
+BackgroundThreadAffinity* BackgroundThreadAffinity::Create(uint32_t kinds) {
+  if (kinds == 0u) {
+    return nullptr;
+  }
+  cpu_set_t all_cpus;
+  if (sched_getaffinity(/*pid=*/ 0, sizeof(all_cpus), &all_cpus) != 0) {
+    PLOG(WARNING) << "Failed to get the CPU affinity";
+    return nullptr;
+  }
+  cpu_set_t efficiency_cpus;
+  CPU_ZERO(&efficiency_cpus);
+  for (uint32_t cpu : FindEfficiencyCores()) {
+    if (CPU_ISSET(cpu, &all_cpus)) {
+      CPU_SET(cpu, &efficiency_cpus);
+    }
+  }
+  if (CPU_COUNT(&efficiency_cpus) == 0) {
+    VLOG(threads) << "No efficiency cores, not restricting background threads";
+    return nullptr;
+  }
+  return new BackgroundThreadAffinity(kinds, all_cpus, efficiency_cpus);
+}
+
+static void SetAffinityForTid(pid_t tid, const cpu_set_t& cpus) {
+  // The thread may have exited since we looked it up.
+  if (sched_setaffinity(tid, sizeof(cpus), &cpus) != 0 && errno != ESRCH) {
+    PLOG(WARNING) << "Failed to set the CPU affinity of thread " << tid;
+  }
+}
+
+static void SetAffinityForThreadPool(AbstractThreadPool* thread_pool, const cpu_set_t& cpus) {
+  if (thread_pool == nullptr) {
+    return;
+  }
+  for (ThreadPoolWorker* worker : thread_pool->GetWorkers()) {
+    if (worker->GetThread() != nullptr) {
+      SetAffinityForTid(worker->GetThread()->GetTid(), cpus);
+    }
+  }
+}
+
+void BackgroundThreadAffinity::Apply(bool restrict_to_efficiency_cores) {
+  if (restricted_.exchange(restrict_to_efficiency_cores) == restrict_to_efficiency_cores) {
+    return;
+  }
+  const cpu_set_t& cpus = restrict_to_efficiency_cores ? efficiency_cpus_ : all_cpus_;
+  VLOG(threads) << (restrict_to_efficiency_cores ? "Restricting" : "Unrestricting")
+                << " background threads to " << CPU_COUNT(&cpus) << " CPUs";
+  Runtime* runtime = Runtime::Current();
+  if ((kinds_ & kJit) != 0u && runtime->GetJit() != nullptr) {
+    SetAffinityForThreadPool(runtime->GetJit()->GetThreadPool(), cpus);
+  }
+  gc::Heap* heap = runtime->GetHeap();
+  if ((kinds_ & kGc) != 0u) {
+    SetAffinityForThreadPool(heap->GetThreadPool(), cpus);
+  }
+  if ((kinds_ & kHeapTask) != 0u) {
+    pid_t tid = heap->GetTaskProcessor()->GetRunningThreadTid(Thread::Current());
+    if (tid != 0) {
+      SetAffinityForTid(tid, cpus);
+    }
+  }
+  if ((kinds_ & kProfileSaver) != 0u) {
+    ProfileSaver::SetCpuAffinity(cpus);
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_BACKGROUND_THREAD_AFFINITY_H_
+#define ART_RUNTIME_BACKGROUND_THREAD_AFFINITY_H_
+
+#include <sched.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+
+namespace art HIDDEN {
+
+// Keeps the runtime's background threads off the big cores of a heterogeneous CPU while the
+// process is not jank-perceptible, so that JIT compilation and concurrent GC do not compete
+// with UI threads of foreground apps. During startup and in the foreground the threads may run
+// on every core the process may use. Enabled per thread kind with
+// -Xbackground-thread-affinity:jit,gc,heaptask,profilesaver.
+class BackgroundThreadAffinity {
+ public:
+  enum ThreadKind : uint32_t {
+    kJit = 1u << 0,           // JIT thread pool workers.
+    kGc = 1u << 1,            // GC thread pool workers.
+    kHeapTask = 1u << 2,      // HeapTaskDaemon, which runs concurrent GCs and heap tasks.
+    kProfileSaver = 1u << 3,  // The profile saver thread.
+  };
+
+  // Parses a comma separated list of thread kinds into a mask of `ThreadKind`s.
+  static bool ParseThreadKinds(const std::string& spec, uint32_t* kinds, std::string* error_msg);
+
+  // Returns the CPUs whose `cpu_capacity` in `sysfs_cpu_dir` is below the highest one, or an
+  // empty vector if the CPU is homogeneous or does not report capacities.
+  static std::vector<uint32_t> FindEfficiencyCores(
+      const std::string& sysfs_cpu_dir = "/sys/devices/system/cpu");
+
+  // Returns null if `kinds` is empty or there are no efficiency cores.
+  static BackgroundThreadAffinity* Create(uint32_t kinds);
+
+  // Restricts the selected threads to the efficiency cores, or lets them use every core the
+  // process could use when the policy was created.
+  void Apply(bool restrict_to_efficiency_cores);
+
+ private:
+  BackgroundThreadAffinity(uint32_t kinds,
+                           const cpu_set_t& all_cpus,
+                           const cpu_set_t& efficiency_cpus)
+      : kinds_(kinds), all_cpus_(all_cpus), efficiency_cpus_(efficiency_cpus), restricted_(false) {}
+
+  const uint32_t kinds_;
+  const cpu_set_t all_cpus_;
+  const cpu_set_t efficiency_cpus_;
+  // Avoids setting the same affinity again on every process state update. Concurrent updates
+  // may briefly apply a stale state; the next update corrects it.
+  std::atomic<bool> restricted_;
+
+  DISALLOW_COPY_AND_ASSIGN(BackgroundThreadAffinity);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_BACKGROUND_THREAD_AFFINITY_H_
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "background_thread_affinity.h"
+
+#include <sys/stat.h>
+
+#include <string>
+#include <vector>
+
+#include "android-base/file.h"
+#include "base/common_art_test.h"
+
+namespace art HIDDEN {
+
+class BackgroundThreadAffinityTest : public CommonArtTest {
+ protected:
+  static void WriteCapacities(const std::string& dir, const std::vector<const char*>& capacities) {
+    for (size_t cpu = 0; cpu != capacities.size(); ++cpu) {
+      std::string cpu_dir = dir + "cpu" + std::to_string(cpu);
+      ASSERT_EQ(mkdir(cpu_dir.c_str(), 0700), 0);
+      ASSERT_TRUE(android::base::WriteStringToFile(capacities[cpu], cpu_dir + "/cpu_capacity"));
+    }
+  }
+};
+
+TEST_F(BackgroundThreadAffinityTest, ParseThreadKinds) {
+  uint32_t kinds;
+  std::string error_msg;
+  ASSERT_TRUE(BackgroundThreadAffinity::ParseThreadKinds("", &kinds, &error_msg));
+  EXPECT_EQ(kinds, 0u);
+  ASSERT_TRUE(BackgroundThreadAffinity::ParseThreadKinds("jit,heaptask", &kinds, &error_msg));
+  EXPECT_EQ(kinds, BackgroundThreadAffinity::kJit | BackgroundThreadAffinity::kHeapTask);
+  ASSERT_TRUE(
+      BackgroundThreadAffinity::ParseThreadKinds("gc,profilesaver", &kinds, &error_msg));
+  EXPECT_EQ(kinds, BackgroundThreadAffinity::kGc | BackgroundThreadAffinity::kProfileSaver);
+  EXPECT_FALSE(BackgroundThreadAffinity::ParseThreadKinds("jit,ui", &kinds, &error_msg));
+  EXPECT_NE(error_msg.find("'ui'"), std::string::npos) << error_msg;
+}
+
+TEST_F(BackgroundThreadAffinityTest, FindEfficiencyCores) {
+  ScratchDir dir;
+  WriteCapacities(dir.GetPath(), {"160\n", "160\n", "512\n", "1024\n"});
+  EXPECT_EQ(BackgroundThreadAffinity::FindEfficiencyCores(dir.GetPath()),
+            std::vector<uint32_t>({0u, 1u, 2u}));
+}
+
+TEST_F(BackgroundThreadAffinityTest, FindEfficiencyCoresHomogeneous) {
+  ScratchDir dir;
+  WriteCapacities(dir.GetPath(), {"1024\n", "1024\n"});
+  EXPECT_TRUE(BackgroundThreadAffinity::FindEfficiencyCores(dir.GetPath()).empty());
+  ScratchDir empty_dir;
+  EXPECT_TRUE(BackgroundThreadAffinity::FindEfficiencyCores(empty_dir.GetPath()).empty());
+}
+
+}  // namespace art
@@ -35,6 +35,7 @@ namespace art HIDDEN {
 class MemMapArena final : public Arena {
  public:
   MemMapArena(size_t size, bool low_4gb, const char* name);
+  explicit MemMapArena(MemMap&& map);
   virtual ~MemMapArena();
   void Release() override;
 
@@ -45,7 +46,11 @@ class MemMapArena final : public Arena {
 };
 
 MemMapArena::MemMapArena(size_t size, bool low_4gb, const char* name)
-    : map_(Allocate(size, low_4gb, name)) {
+    : MemMapArena(Allocate(size, low_4gb, name)) {}
+
+MemMapArena::MemMapArena(MemMap&& map)
+    : map_(std::move(map)) {
+  DCHECK(map_.IsValid());
   memory_ = map_.Begin();
   static_assert(ArenaAllocator::kArenaAlignment <= kMinPageSize,
                 "Arena should not need stronger alignment than kMinPageSize.");
@@ -106,6 +111,26 @@ void MemMapArenaPool::ReclaimMemory() {
     free_arenas_ = free_arenas_->next_;
     delete arena;
   }
+  reservation_.Reset();
+}
+
+MemMap MemMapArenaPool::TakeFromReservation(size_t size) {
+  // Requests that would use up a large part of a reservation get their own mapping.
+  if (size > kReservationSize / 4u) {
+    return MemMap::Invalid();
+  }
+  if (!reservation_.IsValid() || reservation_.Size() < size) {
+    // The tail of a previous reservation, if any, is unmapped here. It was never touched.
+    std::string error_msg;
+    reservation_ = MemMap::MapAnonymous(
+        name_, kReservationSize, PROT_READ | PROT_WRITE, low_4gb_, &error_msg);
+    if (!reservation_.IsValid()) {
+      // Let the caller retry with a mapping of just the requested size.
+      VLOG(heap) << "Failed to reserve memory for " << name_ << " arenas: " << error_msg;
+      return MemMap::Invalid();
+    }
+  }
+  return reservation_.TakeReservedMemory(size);
 }
 
 void MemMapArenaPool::LockReclaimMemory() {
@@ -115,15 +140,19 @@ void MemMapArenaPool::LockReclaimMemory() {
 
 Arena* MemMapArenaPool::AllocArena(size_t size) {
   Arena* ret = nullptr;
+  MemMap map;
   {
     std::lock_guard<std::mutex> lock(lock_);
-    if (free_arenas_ != nullptr && LIKELY(free_arenas_->Size() >= size)) {
-      ret = free_arenas_;
-      free_arenas_ = free_arenas_->next_;
+    ret = TakeFreeArena(&free_arenas_, size);
+    if (ret == nullptr) {
+      // Carve the new arena out of a larger reservation, so that creating arenas one by one
+      // does not cost an mmap() each. The arena still gets its own MemMap and can be unmapped
+      // independently of the rest of the reservation.
+      map = TakeFromReservation(RoundUp(size, gPageSize));
     }
   }
   if (ret == nullptr) {
-    ret = new MemMapArena(size, low_4gb_, name_);
+    ret = map.IsValid() ? new MemMapArena(std::move(map)) : new MemMapArena(size, low_4gb_, name_);
   }
   ret->Reset();
   return ret;
@@ -18,6 +18,7 @@
 #define ART_RUNTIME_BASE_MEM_MAP_ARENA_POOL_H_
 
 #include "base/arena_allocator.h"
+#include "base/mem_map.h"
 
 namespace art HIDDEN {
 
@@ -33,10 +34,19 @@ class MemMapArenaPool final : public ArenaPool {
   // Trim the maps in arenas by madvising, used by JIT to reduce memory usage.
   void TrimMaps() override;
 
+  // Size of the address range reserved at once for carving out new arenas.
+  static constexpr size_t kReservationSize = 2 * MB;
+
  private:
+  // Take `size` bytes from the front of `reservation_`, reserving a new range if needed.
+  // Returns an invalid map if `size` is too large or if the reservation failed.
+  MemMap TakeFromReservation(size_t size);
+
   const bool low_4gb_;
   const char* name_;
   Arena* free_arenas_;
+  // Not yet used part of the last reserved range. Guarded by `lock_`.
+  MemMap reservation_;
   // Use a std::mutex here as Arenas are second-from-the-bottom when using MemMaps, and MemMap
   // itself uses std::mutex scoped to within an allocate/free only.
   mutable std::mutex lock_;
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mem_map_arena_pool.h"
+
+#include <string.h>
+
+#include "base/arena_allocator-inl.h"
+#include "base/common_art_test.h"
+#include "runtime_globals.h"
+
+namespace art HIDDEN {
+
+class MemMapArenaPoolTest : public CommonArtTest {};
+
+TEST_F(MemMapArenaPoolTest, ArenasAreCarvedFromReservation) {
+  MemMapArenaPool pool;
+  const size_t arena_size = RoundUp(arena_allocator::kArenaDefaultSize, gPageSize);
+  ASSERT_LE(2u * arena_size, MemMapArenaPool::kReservationSize / 4u);
+  Arena* first = pool.AllocArena(arena_size);
+  Arena* second = pool.AllocArena(arena_size);
+  ASSERT_EQ(arena_size, first->Size());
+  ASSERT_EQ(arena_size, second->Size());
+  // Consecutive arenas come from the front of the same reservation.
+  EXPECT_EQ(first->Begin() + arena_size, second->Begin());
+  memset(first->Begin(), 0xab, first->Size());
+  memset(second->Begin(), 0xcd, second->Size());
+
+  // Unmapping one arena leaves its neighbour intact.
+  pool.FreeArenaChain(first);
+  pool.LockReclaimMemory();
+  EXPECT_EQ(0xcd, second->Begin()[0]);
+  EXPECT_EQ(0xcd, second->Begin()[arena_size - 1u]);
+  pool.FreeArenaChain(second);
+}
+
+TEST_F(MemMapArenaPoolTest, LargeArenasAreMappedSeparately) {
+  MemMapArenaPool pool;
+  const size_t large_size = MemMapArenaPool::kReservationSize;
+  Arena* large = pool.AllocArena(large_size);
+  ASSERT_EQ(large_size, large->Size());
+  memset(large->Begin(), 0, large->Size());
+  pool.FreeArenaChain(large);
+  if (!arena_allocator::kArenaAllocatorPreciseTracking) {
+    // The freed arena is reused for a request that fits.
+    Arena* reused = pool.AllocArena(gPageSize);
+    EXPECT_EQ(large, reused);
+    pool.FreeArenaChain(reused);
+  }
+}
+
+}  // namespace art
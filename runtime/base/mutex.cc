@@ -633,12 +633,11 @@ bool Mutex::ExclusiveTryLock(Thread* self) {
 template bool Mutex::ExclusiveTryLock<false>(Thread* self);
 template bool Mutex::ExclusiveTryLock<true>(Thread* self);
 
-bool Mutex::ExclusiveTryLockWithSpinning(Thread* self) {
+bool Mutex::ExclusiveTryLockWithSpinning(Thread* self, int max_spins) {
   // Spin a small number of times, since this affects our ability to respond to suspension
   // requests. We spin repeatedly only if the mutex repeatedly becomes available and unavailable
   // in rapid succession, and then we will typically not spin for the maximal period.
-  const int kMaxSpins = 5;
-  for (int i = 0; i < kMaxSpins; ++i) {
+  for (int i = 0; i < max_spins; ++i) {
     if (ExclusiveTryLock(self)) {
       return true;
     }
@@ -190,8 +190,11 @@ class EXPORT LOCKABLE Mutex : public BaseMutex {
   template <bool kCheck = kDebugLocking>
   bool ExclusiveTryLock(Thread* self) TRY_ACQUIRE(true);
   bool TryLock(Thread* self) TRY_ACQUIRE(true) { return ExclusiveTryLock(self); }
-  // Equivalent to ExclusiveTryLock, but retry for a short period before giving up.
-  bool ExclusiveTryLockWithSpinning(Thread* self) TRY_ACQUIRE(true);
+  // Equivalent to ExclusiveTryLock, but retry for a short period before giving up. Each spin
+  // waits briefly for the mutex to be released.
+  static constexpr int kDefaultMaxSpins = 5;
+  bool ExclusiveTryLockWithSpinning(Thread* self, int max_spins = kDefaultMaxSpins)
+      TRY_ACQUIRE(true);
 
   // Release exclusive access.
   void ExclusiveUnlock(Thread* self) RELEASE();
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_CATCH_HANDLER_CACHE_H_
+#define ART_RUNTIME_CATCH_HANDLER_CACHE_H_
+
+#include <array>
+#include <atomic>
+
+#include "base/bit_utils.h"
+#include "base/macros.h"
+#include "obj_ptr.h"
+
+namespace art HIDDEN {
+
+namespace mirror {
+class Class;
+}  // namespace mirror
+
+// Small thread-local cache of the catch handler lookups done by `ArtMethod::FindCatchBlock()`,
+// for code that throws and catches the same exception type at the same place repeatedly.
+//
+// Entries are keyed by the throwing dex instruction and the exception class. Like the
+// interpreter cache, it is cleared whenever any dex file is unloaded, and the exception
+// classes are swept by the GC together with the interpreter cache.
+// All operations must be done from the owning thread, or at a point when the owning thread
+// is suspended.
+class CatchHandlerCache {
+ public:
+  struct Entry {
+    const void* dex_instruction;
+    mirror::Class* exception_class;
+    uint32_t handler_dex_pc;
+    bool has_no_move_exception;
+  };
+
+  static constexpr size_t kSize = 16;
+
+  CatchHandlerCache() {
+    data_.fill(Entry{nullptr, nullptr, 0u, false});
+  }
+
+  // Clear the whole cache.
+  void Clear() {
+    // Like `InterpreterCache::Clear()`, only clear the keys atomically as there could be a
+    // concurrent sweep.
+    for (Entry& entry : data_) {
+      reinterpret_cast<std::atomic<const void*>*>(&entry.dex_instruction)->store(
+          nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  ALWAYS_INLINE bool Get(const void* dex_instruction,
+                         ObjPtr<mirror::Class> exception_class,
+                         /*out*/ uint32_t* handler_dex_pc,
+                         /*out*/ bool* has_no_move_exception) {
+    const Entry& entry = data_[IndexOf(dex_instruction, exception_class.Ptr())];
+    if (entry.dex_instruction == dex_instruction &&
+        entry.exception_class == exception_class.Ptr()) {
+      *handler_dex_pc = entry.handler_dex_pc;
+      *has_no_move_exception = entry.has_no_move_exception;
+      return true;
+    }
+    return false;
+  }
+
+  ALWAYS_INLINE void Set(const void* dex_instruction,
+                         ObjPtr<mirror::Class> exception_class,
+                         uint32_t handler_dex_pc,
+                         bool has_no_move_exception) {
+    data_[IndexOf(dex_instruction, exception_class.Ptr())] =
+        Entry{dex_instruction, exception_class.Ptr(), handler_dex_pc, has_no_move_exception};
+  }
+
+  std::array<Entry, kSize>& GetArray() {
+    return data_;
+  }
+
+ private:
+  static ALWAYS_INLINE size_t IndexOf(const void* dex_instruction,
+                                      const mirror::Class* exception_class) {
+    static_assert(IsPowerOfTwo(kSize), "Size must be power of two");
+    uintptr_t hash = (reinterpret_cast<uintptr_t>(dex_instruction) >> 1) ^
+                     (reinterpret_cast<uintptr_t>(exception_class) >> 3);
+    return hash & (kSize - 1);
+  }
+
+  std::array<Entry, kSize> data_;
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_CATCH_HANDLER_CACHE_H_
@@ -17,6 +17,7 @@
 #include "cha.h"
 
 #include "art_method-inl.h"
+#include "base/array_ref.h"
 #include "base/logging.h"  // For VLOG
 #include "base/mutex.h"
 #include "jit/jit.h"
@@ -671,18 +672,19 @@ void ClassHierarchyAnalysis::InvalidateSingleImplementationMethods(
       // new one isn't loaded yet) which still works fine. We will deoptimize just after this to
       // ensure everything gets the new state.
       jit::Jit* jit = Runtime::Current()->GetJit();
-      if (jit != nullptr) {
-        jit::JitCodeCache* code_cache = jit->GetCodeCache();
-        for (const auto& pair : headers) {
-          code_cache->InvalidateCompiledCodeFor(pair.first, pair.second);
-        }
+      if (jit != nullptr && !headers.empty()) {
+        jit->GetCodeCache()->InvalidateCompiledCodeFor(
+            ArrayRef<const std::pair<ArtMethod*, OatQuickMethodHeader*>>(headers));
       }
     }
 
     if (dependent_method_headers.empty()) {
       return;
     }
-    // Deoptimze compiled code on stack that should have been invalidated.
+    runtime->GetMetrics()->ChaInvalidatedMethodCount()->Add(dependent_method_headers.size());
+    runtime->GetMetrics()->ChaInvalidationCheckpointCount()->AddOne();
+    // Deoptimze compiled code on stack that should have been invalidated. A single checkpoint
+    // covers all the code invalidated by loading the class.
     CHACheckpoint checkpoint(dependent_method_headers);
     size_t threads_running_checkpoint = runtime->GetThreadList()->RunCheckpoint(&checkpoint);
     if (threads_running_checkpoint != 0) {
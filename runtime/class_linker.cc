@@ -88,6 +88,7 @@
 #include "gc/scoped_gc_critical_section.h"
 #include "gc/space/image_space.h"
 #include "gc/space/space-inl.h"
+#include "gc/task_processor.h"
 #include "gc_root-inl.h"
 #include "handle_scope-inl.h"
 #include "hidden_api.h"
@@ -626,6 +627,8 @@ ClassLinker::ClassLinker(InternTable* intern_table, bool fast_class_not_found_ex
       visibly_initialize_classes_with_membarier_(RegisterMemBarrierForClassInitialization()),
       critical_native_code_with_clinit_check_lock_("critical native code with clinit check lock"),
       critical_native_code_with_clinit_check_(),
+      pending_deletion_lock_("class loaders pending deletion lock"),
+      pending_deletion_class_loaders_(),
       boot_image_jni_stubs_(JniStubKeyHash(Runtime::Current()->GetInstructionSet()),
                             JniStubKeyEquals(Runtime::Current()->GetInstructionSet())),
       cha_(Runtime::Current()->IsAotCompiler() ? nullptr : new ClassHierarchyAnalysis()) {
@@ -2672,16 +2675,24 @@ void ClassLinker::VisitClassesWithoutClassesLock(ClassVisitor* visitor) {
 
 ClassLinker::~ClassLinker() {
   Thread* const self = Thread::Current();
-  for (const ClassLoaderData& data : class_loaders_) {
-    // CHA unloading analysis is not needed. No negative consequences are expected because
-    // all the classloaders are deleted at the same time.
-    PrepareToDeleteClassLoader(self, data, /*cleanup_cha=*/false);
-  }
+  // CHA unloading analysis is not needed. No negative consequences are expected because
+  // all the classloaders are deleted at the same time.
+  PrepareToDeleteClassLoaders(self, class_loaders_, /*cleanup_cha=*/false);
   for (const ClassLoaderData& data : class_loaders_) {
     delete data.allocator;
     delete data.class_table;
   }
   class_loaders_.clear();
+  // Class loaders unloaded by the last GC may not be deleted yet if the heap task processor
+  // was stopped before getting to them.
+  {
+    MutexLock mu(self, pending_deletion_lock_);
+    for (const ClassLoaderData& data : pending_deletion_class_loaders_) {
+      delete data.allocator;
+      delete data.class_table;
+    }
+    pending_deletion_class_loaders_.clear();
+  }
   while (!running_visibly_initialized_callbacks_.empty()) {
     std::unique_ptr<VisiblyInitializedCallback> callback(
         std::addressof(running_visibly_initialized_callbacks_.front()));
@@ -2689,33 +2700,51 @@ ClassLinker::~ClassLinker() {
   }
 }
 
-void ClassLinker::PrepareToDeleteClassLoader(Thread* self,
-                                             const ClassLoaderData& data,
-                                             bool cleanup_cha) {
+void ClassLinker::PrepareToDeleteClassLoaders(Thread* self,
+                                              const std::list<ClassLoaderData>& loaders,
+                                              bool cleanup_cha) {
+  if (loaders.empty()) {
+    return;
+  }
   Runtime* const runtime = Runtime::Current();
   JavaVMExt* const vm = runtime->GetJavaVM();
-  vm->DeleteWeakGlobalRef(self, data.weak_root);
-  // Notify the JIT that we need to remove the methods and/or profiling info.
+  std::vector<const LinearAlloc*> allocators;
+  allocators.reserve(loaders.size());
+  for (const ClassLoaderData& data : loaders) {
+    vm->DeleteWeakGlobalRef(self, data.weak_root);
+    allocators.push_back(data.allocator);
+  }
+  auto contained_in_any = [&allocators](void* ptr) {
+    return std::any_of(allocators.begin(), allocators.end(), [ptr](const LinearAlloc* alloc) {
+      return alloc->ContainsUnsafe(ptr);
+    });
+  };
+  // Notify the JIT that we need to remove the methods and/or profiling info. This is done for
+  // all the class loaders at once so that the code cache maps are walked only once.
   if (runtime->GetJit() != nullptr) {
     jit::JitCodeCache* code_cache = runtime->GetJit()->GetCodeCache();
     if (code_cache != nullptr) {
       // For the JIT case, RemoveMethodsIn removes the CHA dependencies.
-      code_cache->RemoveMethodsIn(self, *data.allocator);
+      code_cache->RemoveMethodsIn(self, ArrayRef<const LinearAlloc* const>(allocators));
     }
   } else if (cha_ != nullptr) {
     // If we don't have a JIT, we need to manually remove the CHA dependencies manually.
-    cha_->RemoveDependenciesForLinearAlloc(self, data.allocator);
+    for (const LinearAlloc* allocator : allocators) {
+      cha_->RemoveDependenciesForLinearAlloc(self, allocator);
+    }
   }
   // Cleanup references to single implementation ArtMethods that will be deleted.
   if (cleanup_cha) {
-    CHAOnDeleteUpdateClassVisitor visitor(data.allocator);
-    data.class_table->Visit<kWithoutReadBarrier>(visitor);
+    for (const ClassLoaderData& data : loaders) {
+      CHAOnDeleteUpdateClassVisitor visitor(data.allocator);
+      data.class_table->Visit<kWithoutReadBarrier>(visitor);
+    }
   }
   {
     MutexLock lock(self, critical_native_code_with_clinit_check_lock_);
     auto end = critical_native_code_with_clinit_check_.end();
     for (auto it = critical_native_code_with_clinit_check_.begin(); it != end; ) {
-      if (data.allocator->ContainsUnsafe(it->first)) {
+      if (contained_in_any(it->first)) {
         it = critical_native_code_with_clinit_check_.erase(it);
       } else {
         ++it;
@@ -3179,7 +3208,19 @@ bool ClassLinker::FindClassInBaseDexClassLoaderClassPath(
   const DexFile* dex_file = nullptr;
   const dex::ClassDef* class_def = nullptr;
   ObjPtr<mirror::Class> ret;
+  // Dex files covered by the class loader's filter can be skipped if the filter rules out the
+  // descriptor. The filter records the dex files it was built for, so new or replaced dex files
+  // in the path list are still searched.
+  ClassTable* const class_table = class_loader->GetClassTable();
+  const ClassTable::DexFilesFilter* filter =
+      (class_table != nullptr) ? class_table->GetDexFilesFilter() : nullptr;
+  const bool filtered_out = (filter != nullptr) && !filter->MayContain(hash);
+  size_t dex_file_index = 0u;
   auto find_class_def = [&](const DexFile* cp_dex_file) REQUIRES_SHARED(Locks::mutator_lock_) {
+    const size_t index = dex_file_index++;
+    if (filtered_out && filter->Covers(index, cp_dex_file)) {
+      return true;  // The class is not defined in this DexFile.
+    }
     const dex::ClassDef* cp_class_def = OatDexFile::FindClassDef(*cp_dex_file, descriptor, hash);
     if (cp_class_def != nullptr) {
       dex_file = cp_dex_file;
@@ -3190,6 +3231,23 @@ bool ClassLinker::FindClassInBaseDexClassLoaderClassPath(
   };
   VisitClassLoaderDexFiles(self, class_loader, find_class_def);
 
+  if (class_def == nullptr &&
+      filter == nullptr &&
+      class_table != nullptr &&
+      dex_file_index >= ClassTable::DexFilesFilter::kMinDexFiles) {
+    // Failed lookup in a class loader with many dex files, build the filter for the next ones.
+    std::vector<const DexFile*> dex_files;
+    VisitClassLoaderDexFiles(self,
+                             class_loader,
+                             [&](const DexFile* cp_dex_file)
+                                 REQUIRES_SHARED(Locks::mutator_lock_) {
+                               dex_files.push_back(cp_dex_file);
+                               return true;  // Continue with the next DexFile.
+                             });
+    class_table->SetDexFilesFilter(
+        std::make_unique<ClassTable::DexFilesFilter>(std::move(dex_files)));
+  }
+
   if (class_def != nullptr) {
     *result = DefineClass(self, descriptor, hash, class_loader, *dex_file, *class_def);
     if (UNLIKELY(*result == nullptr)) {
@@ -4125,10 +4183,17 @@ void ClassLinker::LoadMethod(const DexFile& dex_file,
   if (UNLIKELY((access_flags & kAccNative) != 0u)) {
     // Check if the native method is annotated with @FastNative or @CriticalNative.
     const dex::MethodAnnotationsItem* method_annotations = mai->AdvanceTo(dex_method_idx);
+    uint32_t native_access_flags = 0u;
     if (method_annotations != nullptr) {
-      access_flags |=
+      native_access_flags =
           annotations::GetNativeMethodAnnotationAccessFlags(dex_file, *method_annotations);
     }
+    if (native_access_flags == 0u) {
+      // Otherwise, check if it was promoted to @FastNative by the runtime configuration.
+      native_access_flags = Runtime::Current()->GetFastNativeMethodAccessFlags(
+          dex_file, dex_method_idx, access_flags);
+    }
+    access_flags |= native_access_flags;
     dst->SetAccessFlags(access_flags);
     DCHECK(!dst->IsAbstract());
     DCHECK(!dst->HasCodeItem());
@@ -6727,9 +6792,16 @@ void ClassLinker::SetIMTRef(ArtMethod* unimplemented_method,
   }
 }
 
-void ClassLinker::FillIMTAndConflictTables(ObjPtr<mirror::Class> klass) {
+size_t ClassLinker::FillIMTAndConflictTables(ObjPtr<mirror::Class> klass,
+                                             bool create_conflict_tables) {
   DCHECK(klass->ShouldHaveImt()) << klass->PrettyClass();
   DCHECK(!klass->IsTemp()) << klass->PrettyClass();
+  ImTable* super_imt = klass->FindSuperImt(image_pointer_size_);
+  if (!create_conflict_tables && klass->GetImt(image_pointer_size_) == super_imt) {
+    // `LinkClass()` shares the IMT only if there are no new conflicts compared to the super
+    // class, so the conflict methods of the super class are valid for this class as well.
+    return 0u;
+  }
   ArtMethod* imt_data[ImTable::kSize];
   Runtime* const runtime = Runtime::Current();
   ArtMethod* const unimplemented_method = runtime->GetImtUnimplementedMethod();
@@ -6741,16 +6813,21 @@ void ClassLinker::FillIMTAndConflictTables(ObjPtr<mirror::Class> klass) {
                        unimplemented_method,
                        conflict_method,
                        klass,
-                       /*create_conflict_tables=*/true,
+                       create_conflict_tables,
                        /*ignore_copied_methods=*/false,
                        &new_conflict,
                        &imt_data[0]);
   }
+  size_t num_deferred_tables = 0u;
+  if (!create_conflict_tables) {
+    num_deferred_tables =
+        static_cast<size_t>(std::count(imt_data, imt_data + ImTable::kSize, conflict_method));
+  }
   // Compare the IMT with the super class including the conflict methods. If they are equivalent,
-  // we can just use the same pointer.
+  // we can just use the same pointer. Without conflict tables we cannot tell whether both classes
+  // have the same set of conflicts in a slot, so we do not share the IMT in that case.
   ImTable* imt = nullptr;
-  ImTable* super_imt = klass->FindSuperImt(image_pointer_size_);
-  if (super_imt != nullptr) {
+  if (super_imt != nullptr && num_deferred_tables == 0u) {
     bool same = true;
     for (size_t i = 0; same && i < ImTable::kSize; ++i) {
       ArtMethod* method = imt_data[i];
@@ -6784,6 +6861,7 @@ void ClassLinker::FillIMTAndConflictTables(ObjPtr<mirror::Class> klass) {
   } else {
     klass->SetImt(imt, image_pointer_size_);
   }
+  return num_deferred_tables;
 }
 
 ImtConflictTable* ClassLinker::CreateImtConflictTable(size_t count,
@@ -7471,26 +7549,33 @@ class ClassLinker::LinkMethodsHelper {
                        ArtMethod** out_imt)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  void ClobberOldMethods(LengthPrefixedArray<ArtMethod>* old_methods,
-                         LengthPrefixedArray<ArtMethod>* methods) {
-    if (kIsDebugBuild && old_methods != nullptr) {
+  // Return the method array replaced by `ReallocMethods()` to the class loader's LinearAlloc.
+  void ReleaseOldMethods(ObjPtr<mirror::Class> klass,
+                         LengthPrefixedArray<ArtMethod>* old_methods,
+                         LengthPrefixedArray<ArtMethod>* methods)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (old_methods != nullptr) {
       CHECK(methods != nullptr);
-      // Put some random garbage in old methods to help find stale pointers.
       if (methods != old_methods) {
+        LinearAlloc* allocator = class_linker_->GetAllocatorForClassLoader(klass->GetClassLoader());
+        const size_t old_size = LengthPrefixedArray<ArtMethod>::ComputeSize(old_methods->size(),
+                                                                            kMethodSize,
+                                                                            kMethodAlignment);
         // Need to make sure the GC is not running since it could be scanning the methods we are
         // about to overwrite.
         ScopedThreadStateChange tsc(self_, ThreadState::kSuspended);
         gc::ScopedGCCriticalSection gcs(self_,
                                         gc::kGcCauseClassLinker,
                                         gc::kCollectorTypeClassLinker);
-        const size_t old_size = LengthPrefixedArray<ArtMethod>::ComputeSize(old_methods->size(),
-                                                                            kMethodSize,
-                                                                            kMethodAlignment);
-        memset(old_methods, 0xFEu, old_size);
-        // Set size to 0 to avoid visiting declaring classes.
-        if (gUseUserfaultfd) {
-          old_methods->SetSize(0);
+        if (kIsDebugBuild) {
+          // Put some random garbage in old methods to help find stale pointers.
+          memset(old_methods, 0xFEu, old_size);
+          // Set size to 0 to avoid visiting declaring classes.
+          if (gUseUserfaultfd) {
+            old_methods->SetSize(0);
+          }
         }
+        allocator->Free(self_, old_methods, old_size, LinearAllocKind::kArtMethodArray);
       }
     }
   }
@@ -8847,7 +8932,7 @@ bool ClassLinker::LinkMethodsHelper<kPointerSize>::LinkMethods(
         break;
       }
     }
-    LengthPrefixedArray<ArtMethod>* old_methods = kIsDebugBuild ? klass->GetMethodsPtr() : nullptr;
+    LengthPrefixedArray<ArtMethod>* old_methods = klass->GetMethodsPtr();
     if (have_super_with_defaults) {
       if (!FindCopiedMethodsForInterface(klass.Get(), num_virtual_methods, iftable)) {
         self->AssertPendingException();
@@ -8865,10 +8950,8 @@ bool ClassLinker::LinkMethodsHelper<kPointerSize>::LinkMethods(
       }
     }
     klass->SetIfTable(iftable);
-    if (kIsDebugBuild) {
-      // May cause thread suspension, so do this after we're done with `ObjPtr<> iftable`.
-      ClobberOldMethods(old_methods, klass->GetMethodsPtr());
-    }
+    // May cause thread suspension, so do this after we're done with `ObjPtr<> iftable`.
+    ReleaseOldMethods(klass.Get(), old_methods, klass->GetMethodsPtr());
     return true;
   } else if (LIKELY(klass->HasSuperClass())) {
     // We set up the interface lookup table now because we need it to determine if we need
@@ -8959,7 +9042,7 @@ bool ClassLinker::LinkMethodsHelper<kPointerSize>::LinkMethods(
       return false;
     }
 
-    LengthPrefixedArray<ArtMethod>* old_methods = kIsDebugBuild ? klass->GetMethodsPtr() : nullptr;
+    LengthPrefixedArray<ArtMethod>* old_methods = klass->GetMethodsPtr();
     if (num_new_copied_methods_ != 0u) {
       ReallocMethods(klass.Get());
     }
@@ -9009,8 +9092,8 @@ bool ClassLinker::LinkMethodsHelper<kPointerSize>::LinkMethods(
     klass->SetIfTable(iftable.Get());
     if (kIsDebugBuild) {
       CheckVTable(self, klass, kPointerSize);
-      ClobberOldMethods(old_methods, klass->GetMethodsPtr());
     }
+    ReleaseOldMethods(klass.Get(), old_methods, klass->GetMethodsPtr());
     return true;
   } else {
     return LinkJavaLangObjectMethods(self, klass);
@@ -9908,6 +9991,7 @@ ObjPtr<mirror::String> ClassLinker::DoResolveString(dex::StringIndex string_idx,
 
 ObjPtr<mirror::String> ClassLinker::DoResolveString(dex::StringIndex string_idx,
                                                     Handle<mirror::DexCache> dex_cache) {
+  GetMetrics()->DexCacheMissCount()->AddOne();
   const DexFile& dex_file = *dex_cache->GetDexFile();
   uint32_t utf16_length;
   const char* utf8_data = dex_file.GetStringDataAndUtf16Length(string_idx, &utf16_length);
@@ -9989,6 +10073,7 @@ ObjPtr<mirror::Class> ClassLinker::DoResolveType(dex::TypeIndex type_idx,
                                                  Handle<mirror::DexCache> dex_cache,
                                                  Handle<mirror::ClassLoader> class_loader) {
   DCHECK(dex_cache->GetClassLoader() == class_loader.Get());
+  GetMetrics()->DexCacheMissCount()->AddOne();
   Thread* self = Thread::Current();
   const char* descriptor = dex_cache->GetDexFile()->GetTypeDescriptor(type_idx);
   ObjPtr<mirror::Class> resolved = FindClass(self, descriptor, class_loader);
@@ -10710,15 +10795,38 @@ void ClassLinker::DumpForSigQuit(std::ostream& os) {
       } else {
         os << ", no parent";
       }
-      os << "\n";
+      os << "\n  LinearAlloc ";
+      class_loader.allocator->DumpStats(os);
     }
   }
   os << "Done dumping class loaders\n";
   Runtime* runtime = Runtime::Current();
+  if (runtime->GetLinearAlloc() != nullptr) {
+    os << "Runtime LinearAlloc ";
+    runtime->GetLinearAlloc()->DumpStats(os);
+  }
+  mirror::DexCache::DumpConflicts(os);
   os << "Classes initialized: " << runtime->GetStat(KIND_GLOBAL_CLASS_INIT_COUNT) << " in "
      << PrettyDuration(runtime->GetStat(KIND_GLOBAL_CLASS_INIT_TIME)) << "\n";
 }
 
+size_t ClassLinker::ReleaseColdLinearAllocPages(Thread* self) {
+  // The GC must not be compacting the arenas while their pages are released.
+  gc::ScopedGCCriticalSection gcs(self, gc::kGcCauseClassLinker, gc::kCollectorTypeClassLinker);
+  size_t released_bytes = 0u;
+  {
+    ReaderMutexLock mu(self, *Locks::classlinker_classes_lock_);
+    for (const ClassLoaderData& class_loader : class_loaders_) {
+      released_bytes += class_loader.allocator->ReleaseColdFreePages(self);
+    }
+  }
+  LinearAlloc* linear_alloc = Runtime::Current()->GetLinearAlloc();
+  if (linear_alloc != nullptr) {
+    released_bytes += linear_alloc->ReleaseColdFreePages(self);
+  }
+  return released_bytes;
+}
+
 class CountClassesVisitor : public ClassLoaderVisitor {
  public:
   CountClassesVisitor() : num_zygote_classes(0), num_non_zygote_classes(0) {}
@@ -10972,8 +11080,40 @@ void ClassLinker::InsertDexFileInToClassLoader(ObjPtr<mirror::Object> dex_file,
   }
 }
 
+class ClassLinker::DeleteClassLoadersTask : public gc::HeapTask {
+ public:
+  DeleteClassLoadersTask() : gc::HeapTask(NanoTime()) {}
+
+  void Run(Thread* self) override {
+    // Make sure every thread went through a suspend point since the class loaders were
+    // unloaded, so that none of them is still looking at data in their allocators.
+    Runtime::Current()->GetThreadList()->RunEmptyCheckpoint();
+    ScopedObjectAccess soa(self);
+    Runtime::Current()->GetClassLinker()->DeletePendingClassLoaders(self);
+  }
+};
+
+void ClassLinker::DeletePendingClassLoaders(Thread* self) {
+  std::list<ClassLoaderData> to_delete;
+  {
+    MutexLock mu(self, pending_deletion_lock_);
+    to_delete.swap(pending_deletion_class_loaders_);
+  }
+  if (to_delete.empty()) {
+    return;
+  }
+  ScopedTrace trace(__FUNCTION__);
+  for (const ClassLoaderData& data : to_delete) {
+    delete data.allocator;
+    delete data.class_table;
+  }
+}
+
 void ClassLinker::CleanupClassLoaders() {
   Thread* const self = Thread::Current();
+  // Class loaders unloaded by the previous GC must be gone before this GC can visit the
+  // linear-alloc arenas, in case the heap task didn't get to them yet.
+  DeletePendingClassLoaders(self);
   std::list<ClassLoaderData> to_delete;
   // Do the delete outside the lock to avoid lock violation in jit code cache.
   {
@@ -11020,16 +11160,22 @@ void ClassLinker::CleanupClassLoaders() {
   }
   {
     ScopedDebugDisallowReadBarriers sddrb(self);
-    for (ClassLoaderData& data : to_delete) {
-      // CHA unloading analysis and SingleImplementaion cleanups are required.
-      PrepareToDeleteClassLoader(self, data, /*cleanup_cha=*/true);
-    }
-  }
-  for (const ClassLoaderData& data : to_delete) {
-    delete data.allocator;
-    delete data.class_table;
+    // CHA unloading analysis and SingleImplementaion cleanups are required.
+    PrepareToDeleteClassLoaders(self, to_delete, /*cleanup_cha=*/true);
   }
   Runtime* runtime = Runtime::Current();
+  // Nothing refers to the allocators and class tables anymore. Free them on the heap task
+  // thread so that the GC doesn't spend time releasing the memory of many dead class loaders.
+  {
+    MutexLock mu(self, pending_deletion_lock_);
+    pending_deletion_class_loaders_.splice(pending_deletion_class_loaders_.end(), to_delete);
+  }
+  gc::TaskProcessor* task_processor = runtime->GetHeap()->GetTaskProcessor();
+  if (task_processor != nullptr && task_processor->IsRunning()) {
+    task_processor->AddTask(self, new DeleteClassLoadersTask());
+  } else {
+    DeletePendingClassLoaders(self);
+  }
   if (!unregistered_oat_files.empty()) {
     for (const OatFile* oat_file : unregistered_oat_files) {
       // Notify the fault handler about removal of the executable code range if needed.
@@ -257,6 +257,12 @@ class EXPORT ClassLinker {
 
   void DumpForSigQuit(std::ostream& os) REQUIRES(!Locks::classlinker_classes_lock_);
 
+  // Release the pages of free-listed LinearAlloc blocks that stayed unused since the previous
+  // call, and return the number of bytes released.
+  size_t ReleaseColdLinearAllocPages(Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!Locks::classlinker_classes_lock_);
+
   size_t NumLoadedClasses()
       REQUIRES(!Locks::classlinker_classes_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -716,9 +722,16 @@ class EXPORT ClassLinker {
   // entries are roots, but potentially not image classes.
   void DropFindArrayClassCache() REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Clean up class loaders, this needs to happen after JNI weak globals are cleared.
+  // Clean up class loaders, this needs to happen after JNI weak globals are cleared. The
+  // allocators and class tables of the unloaded class loaders are freed later by a heap task
+  // (see DeletePendingClassLoaders()).
   void CleanupClassLoaders()
-      REQUIRES(!Locks::classlinker_classes_lock_)
+      REQUIRES(!Locks::classlinker_classes_lock_, !pending_deletion_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Free the allocators and class tables of class loaders unloaded by CleanupClassLoaders().
+  void DeletePendingClassLoaders(Thread* self)
+      REQUIRES(!pending_deletion_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Unlike GetOrCreateAllocatorForClassLoader, GetAllocatorForClassLoader asserts that the
@@ -756,8 +769,11 @@ class EXPORT ClassLinker {
                                                   PointerSize pointer_size);
 
 
-  // Create the IMT and conflict tables for a class.
-  void FillIMTAndConflictTables(ObjPtr<mirror::Class> klass) REQUIRES_SHARED(Locks::mutator_lock_);
+  // Create the IMT and conflict tables for a class. If `create_conflict_tables` is false, conflict
+  // slots keep the shared runtime conflict method and their tables are created on first use by
+  // the conflict trampoline. Returns the number of conflict tables that were not created.
+  size_t FillIMTAndConflictTables(ObjPtr<mirror::Class> klass, bool create_conflict_tables = true)
+      REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Visit all of the class tables. This is used by dex2oat to allow pruning dex caches.
   template <class Visitor>
@@ -1021,11 +1037,13 @@ class EXPORT ClassLinker {
       REQUIRES(!Locks::dex_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Prepare by removing dependencies on things allocated in data.allocator.
-  // Please note that the allocator and class_table are not deleted in this
+  // Prepare by removing dependencies on things allocated in the allocators of `loaders`.
+  // Please note that the allocators and class tables are not deleted in this
   // function. They are to be deleted after preparing all the class-loaders that
   // are to be deleted (see b/298575095).
-  void PrepareToDeleteClassLoader(Thread* self, const ClassLoaderData& data, bool cleanup_cha)
+  void PrepareToDeleteClassLoaders(Thread* self,
+                                   const std::list<ClassLoaderData>& loaders,
+                                   bool cleanup_cha)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   void VisitClassesInternal(ClassVisitor* visitor)
@@ -1502,6 +1520,12 @@ class EXPORT ClassLinker {
   std::map<ArtMethod*, void*> critical_native_code_with_clinit_check_
       GUARDED_BY(critical_native_code_with_clinit_check_lock_);
 
+  // Class loaders unloaded by CleanupClassLoaders() whose allocators and class tables are yet to
+  // be deleted. Deletion is done by a heap task, or at the latest by the next
+  // CleanupClassLoaders(), so that the GC never visits arenas of dead class loaders.
+  Mutex pending_deletion_lock_;
+  std::list<ClassLoaderData> pending_deletion_class_loaders_ GUARDED_BY(pending_deletion_lock_);
+
   // Load unique JNI stubs from boot images. If the subsequently loaded native methods could find a
   // matching stub, then reuse it without JIT/AOT compilation.
   JniStubHashMap<const void*> boot_image_jni_stubs_;
@@ -1509,6 +1533,7 @@ class EXPORT ClassLinker {
   std::unique_ptr<ClassHierarchyAnalysis> cha_;
 
   class FindVirtualMethodHolderVisitor;
+  class DeleteClassLoadersTask;
 
   friend class AppImageLoadingHelper;
   friend class ImageDumper;  // for DexLock
@@ -16,8 +16,12 @@
 
 #include "class_loader_context.h"
 
+#include <sys/stat.h>
+
 #include <algorithm>
+#include <map>
 #include <optional>
+#include <tuple>
 
 #include "android-base/file.h"
 #include "android-base/parseint.h"
@@ -63,6 +67,48 @@ static constexpr char kClasspathSeparator = ':';
 static constexpr char kDexFileChecksumSeparator = '*';
 static constexpr char kInMemoryDexClassLoaderDexLocationMagic[] = "<unknown>";
 
+// The same contexts are checked over and over: for every oat file opened, and by dexoptanalyzer
+// and artd for every artifact of an app. Reading the multidex checksum of a class path element
+// means opening its zip, so memoize the checksums keyed by the file identity (device, inode, size
+// and modification time), which changes whenever the file is replaced or rewritten.
+using DexFileIdentity = std::tuple<dev_t, ino_t, off_t, int64_t>;
+static constexpr size_t kMaxCachedDexChecksums = 1024u;
+static Mutex g_dex_checksum_cache_lock("class loader context checksums", kGenericBottomLock);
+static std::map<DexFileIdentity, std::optional<uint32_t>> g_dex_checksum_cache
+    GUARDED_BY(g_dex_checksum_cache_lock);
+
+static std::optional<DexFileIdentity> GetDexFileIdentity(const File& file,
+                                                         const std::string& location) {
+  struct stat st;
+  int result = file.IsValid() ? fstat(file.Fd(), &st) : stat(location.c_str(), &st);
+  if (result != 0) {
+    return std::nullopt;
+  }
+  return DexFileIdentity(st.st_dev,
+                         st.st_ino,
+                         st.st_size,
+                         static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 +
+                             st.st_mtim.tv_nsec);
+}
+
+static bool LookupDexChecksum(const DexFileIdentity& identity, std::optional<uint32_t>* checksum) {
+  MutexLock mu(Thread::Current(), g_dex_checksum_cache_lock);
+  auto it = g_dex_checksum_cache.find(identity);
+  if (it == g_dex_checksum_cache.end()) {
+    return false;
+  }
+  *checksum = it->second;
+  return true;
+}
+
+static void StoreDexChecksum(const DexFileIdentity& identity, std::optional<uint32_t> checksum) {
+  MutexLock mu(Thread::Current(), g_dex_checksum_cache_lock);
+  if (g_dex_checksum_cache.size() >= kMaxCachedDexChecksums) {
+    g_dex_checksum_cache.clear();
+  }
+  g_dex_checksum_cache.insert_or_assign(identity, checksum);
+}
+
 ClassLoaderContext::ClassLoaderContext()
     : dex_files_state_(ContextDexFilesState::kDexFilesNotOpened), owns_the_dex_files_(true) {}
 
@@ -477,13 +523,18 @@ bool ClassLoaderContext::OpenDexFiles(const std::string& classpath_dir,
       std::string error_msg;
       std::optional<uint32_t> dex_checksum;
       if (only_read_checksums) {
-        bool zip_file_only_contains_uncompress_dex;
-        ArtDexFileLoader dex_file_loader(&file, location);
-        if (!dex_file_loader.GetMultiDexChecksum(
-                &dex_checksum, &error_msg, &zip_file_only_contains_uncompress_dex)) {
-          LOG(WARNING) << "Could not get dex checksums for location " << location
-                       << ", fd=" << file.Fd();
-          dex_files_state_ = kDexFilesOpenFailed;
+        std::optional<DexFileIdentity> identity = GetDexFileIdentity(file, location);
+        if (!identity.has_value() || !LookupDexChecksum(identity.value(), &dex_checksum)) {
+          bool zip_file_only_contains_uncompress_dex;
+          ArtDexFileLoader dex_file_loader(&file, location);
+          if (!dex_file_loader.GetMultiDexChecksum(
+                  &dex_checksum, &error_msg, &zip_file_only_contains_uncompress_dex)) {
+            LOG(WARNING) << "Could not get dex checksums for location " << location
+                         << ", fd=" << file.Fd();
+            dex_files_state_ = kDexFilesOpenFailed;
+          } else if (identity.has_value()) {
+            StoreDexChecksum(identity.value(), dex_checksum);
+          }
         }
         file.Release();  // Don't close the file yet (we have only read the checksum).
       } else {
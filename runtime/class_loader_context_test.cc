@@ -606,6 +606,12 @@ TEST_F(ClassLoaderContextTest, ReadDexFileChecksums) {
   TestOpenDexFiles(/*only_read_checksums=*/ true);
 }
 
+TEST_F(ClassLoaderContextTest, ReadDexFileChecksumsTwice) {
+  // The second context gets the checksums from the cache filled by the first one.
+  TestOpenDexFiles(/*only_read_checksums=*/ true);
+  TestOpenDexFiles(/*only_read_checksums=*/ true);
+}
+
 TEST_F(ClassLoaderContextTest, OpenValidDexFilesRelative) {
   TestOpenValidDexFilesRelative(/*use_classpath_dir=*/ false, /*only_read_checksums=*/ false);
 }
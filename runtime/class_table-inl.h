@@ -70,8 +70,8 @@ template <class Visitor>
 void ClassTable::VisitRoots(Visitor& visitor, bool skip_classes) {
   ReaderMutexLock mu(Thread::Current(), lock_);
   if (!skip_classes) {
-    for (ClassSet& class_set : classes_) {
-      for (TableSlot& table_slot : class_set) {
+    for (std::unique_ptr<ClassSet>& class_set : classes_) {
+      for (TableSlot& table_slot : *class_set) {
         table_slot.VisitRoot(visitor);
       }
     }
@@ -90,8 +90,8 @@ template <class Visitor>
 void ClassTable::VisitRoots(const Visitor& visitor, bool skip_classes) {
   ReaderMutexLock mu(Thread::Current(), lock_);
   if (!skip_classes) {
-    for (ClassSet& class_set : classes_) {
-      for (TableSlot& table_slot : class_set) {
+    for (std::unique_ptr<ClassSet>& class_set : classes_) {
+      for (TableSlot& table_slot : *class_set) {
         table_slot.VisitRoot(visitor);
       }
     }
@@ -109,9 +109,9 @@ void ClassTable::VisitRoots(const Visitor& visitor, bool skip_classes) {
 template <class Condition, class Visitor>
 void ClassTable::VisitClassesIfConditionMet(Condition& cond, Visitor& visitor) {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  for (ClassSet& class_set : classes_) {
-    if (cond(class_set)) {
-      for (TableSlot& table_slot : class_set) {
+  for (std::unique_ptr<ClassSet>& class_set : classes_) {
+    if (cond(*class_set)) {
+      for (TableSlot& table_slot : *class_set) {
         table_slot.VisitRoot(visitor);
       }
     }
@@ -140,8 +140,8 @@ template <typename Visitor>
 void ClassTable::VisitClassesAndRoots(Visitor& visitor) {
   TableSlot::ClassAndRootVisitor class_visitor(visitor);
   ReaderMutexLock mu(Thread::Current(), lock_);
-  for (ClassSet& class_set : classes_) {
-    for (TableSlot& table_slot : class_set) {
+  for (std::unique_ptr<ClassSet>& class_set : classes_) {
+    for (TableSlot& table_slot : *class_set) {
       table_slot.VisitRoot(class_visitor);
     }
   }
@@ -158,8 +158,8 @@ void ClassTable::VisitClassesAndRoots(Visitor& visitor) {
 template <ReadBarrierOption kReadBarrierOption, typename Visitor>
 bool ClassTable::Visit(Visitor& visitor) {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  for (ClassSet& class_set : classes_) {
-    for (TableSlot& table_slot : class_set) {
+  for (std::unique_ptr<ClassSet>& class_set : classes_) {
+    for (TableSlot& table_slot : *class_set) {
       if (!visitor(table_slot.Read<kReadBarrierOption>())) {
         return false;
       }
@@ -171,8 +171,8 @@ bool ClassTable::Visit(Visitor& visitor) {
 template <ReadBarrierOption kReadBarrierOption, typename Visitor>
 bool ClassTable::Visit(const Visitor& visitor) {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  for (ClassSet& class_set : classes_) {
-    for (TableSlot& table_slot : class_set) {
+  for (std::unique_ptr<ClassSet>& class_set : classes_) {
+    for (TableSlot& table_slot : *class_set) {
       if (!visitor(table_slot.Read<kReadBarrierOption>())) {
         return false;
       }
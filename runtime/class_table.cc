@@ -16,36 +16,56 @@
 
 #include "class_table-inl.h"
 
+#include "base/bit_utils.h"
 #include "base/stl_util.h"
+#include "dex/dex_file-inl.h"
+#include "dex/utf.h"
 #include "mirror/class-inl.h"
 #include "mirror/string-inl.h"
 #include "oat/oat_file.h"
 
 namespace art HIDDEN {
 
-ClassTable::ClassTable() : lock_("Class loader classes", kClassLoaderClassesLock) {
+ClassTable::ClassTable()
+    : lock_("Class loader classes", kClassLoaderClassesLock),
+      frozen_sets_(nullptr),
+      dex_files_filter_(nullptr) {
   Runtime* const runtime = Runtime::Current();
-  classes_.push_back(ClassSet(runtime->GetHashTableMinLoadFactor(),
-                              runtime->GetHashTableMaxLoadFactor()));
+  classes_.push_back(std::make_unique<ClassSet>(runtime->GetHashTableMinLoadFactor(),
+                                                runtime->GetHashTableMaxLoadFactor()));
+}
+
+void ClassTable::PublishFrozenSets() {
+  DCHECK(!classes_.empty());
+  auto frozen_sets = std::make_unique<FrozenSets>();
+  frozen_sets->reserve(classes_.size() - 1u);
+  for (size_t i = 0; i < classes_.size() - 1u; ++i) {
+    frozen_sets->push_back(classes_[i].get());
+  }
+  // Release ordering makes the contents of the new list visible to lock-free readers.
+  frozen_sets_.store(frozen_sets.get(), std::memory_order_release);
+  frozen_sets_history_.push_back(std::move(frozen_sets));
 }
 
 void ClassTable::FreezeSnapshot() {
   WriterMutexLock mu(Thread::Current(), lock_);
   // Propagate the min/max load factor from the old active set.
   DCHECK(!classes_.empty());
-  const ClassSet& last_set = classes_.back();
-  ClassSet new_set(last_set.GetMinLoadFactor(), last_set.GetMaxLoadFactor());
-  classes_.push_back(std::move(new_set));
+  const ClassSet& last_set = *classes_.back();
+  classes_.push_back(
+      std::make_unique<ClassSet>(last_set.GetMinLoadFactor(), last_set.GetMaxLoadFactor()));
+  PublishFrozenSets();
 }
 
 ObjPtr<mirror::Class> ClassTable::UpdateClass(ObjPtr<mirror::Class> klass, size_t hash) {
   WriterMutexLock mu(Thread::Current(), lock_);
   // Should only be updating latest table.
   TableSlot slot(klass, hash);
-  auto existing_it = classes_.back().FindWithHash(slot, hash);
-  if (UNLIKELY(existing_it == classes_.back().end())) {
-    for (const ClassSet& class_set : classes_) {
-      if (class_set.FindWithHash(slot, hash) != class_set.end()) {
+  ClassSet& last_set = *classes_.back();
+  auto existing_it = last_set.FindWithHash(slot, hash);
+  if (UNLIKELY(existing_it == last_set.end())) {
+    for (const std::unique_ptr<ClassSet>& class_set : classes_) {
+      if (class_set->FindWithHash(slot, hash) != class_set->end()) {
         LOG(FATAL) << "Updating class found in frozen table " << klass->PrettyDescriptor();
         UNREACHABLE();
       }
@@ -80,41 +100,57 @@ size_t ClassTable::NumZygoteClasses(ObjPtr<mirror::ClassLoader> defining_loader)
   ReaderMutexLock mu(Thread::Current(), lock_);
   size_t sum = 0;
   for (size_t i = 0; i < classes_.size() - 1; ++i) {
-    sum += CountDefiningLoaderClasses(defining_loader, classes_[i]);
+    sum += CountDefiningLoaderClasses(defining_loader, *classes_[i]);
   }
   return sum;
 }
 
 size_t ClassTable::NumNonZygoteClasses(ObjPtr<mirror::ClassLoader> defining_loader) const {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  return CountDefiningLoaderClasses(defining_loader, classes_.back());
+  return CountDefiningLoaderClasses(defining_loader, *classes_.back());
 }
 
 size_t ClassTable::NumReferencedZygoteClasses() const {
   ReaderMutexLock mu(Thread::Current(), lock_);
   size_t sum = 0;
   for (size_t i = 0; i < classes_.size() - 1; ++i) {
-    sum += classes_[i].size();
+    sum += classes_[i]->size();
   }
   return sum;
 }
 
 size_t ClassTable::NumReferencedNonZygoteClasses() const {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  return classes_.back().size();
+  return classes_.back()->size();
 }
 
 ObjPtr<mirror::Class> ClassTable::Lookup(const char* descriptor, size_t hash) {
   DescriptorHashPair pair(descriptor, hash);
+  // Search the frozen tables first without taking the lock. These hold the boot image and
+  // zygote classes that all threads look up concurrently, so avoiding the reader lock avoids
+  // bouncing its cache line between cores. For prebuilt boot images, searching from the last
+  // table helps by searching the large table from the framework boot image extension compiled
+  // as single-image before the individual small tables from the primary boot image compiled
+  // as multi-image.
+  const FrozenSets* frozen_sets = frozen_sets_.load(std::memory_order_acquire);
+  size_t num_searched_sets = 0u;
+  if (frozen_sets != nullptr) {
+    for (const ClassSet* class_set : ReverseRange(*frozen_sets)) {
+      auto it = class_set->FindWithHash(pair, hash);
+      if (it != class_set->end()) {
+        return it->Read();
+      }
+    }
+    num_searched_sets = frozen_sets->size();
+  }
   ReaderMutexLock mu(Thread::Current(), lock_);
-  // Search from the last table, assuming that apps shall search for their own classes
-  // more often than for boot image classes. For prebuilt boot images, this also helps
-  // by searching the large table from the framework boot image extension compiled as
-  // single-image before the individual small tables from the primary boot image
-  // compiled as multi-image.
-  for (ClassSet& class_set : ReverseRange(classes_)) {
-    auto it = class_set.FindWithHash(pair, hash);
-    if (it != class_set.end()) {
+  // Search the mutable table and any tables frozen since we loaded `frozen_sets`. Frozen
+  // tables keep their positions when new tables are added, so we can skip the searched ones.
+  DCHECK_LT(num_searched_sets, classes_.size());
+  for (size_t i = classes_.size(); i != num_searched_sets; ) {
+    --i;
+    auto it = classes_[i]->FindWithHash(pair, hash);
+    if (it != classes_[i]->end()) {
       return it->Read();
     }
   }
@@ -127,7 +163,7 @@ void ClassTable::Insert(ObjPtr<mirror::Class> klass) {
 
 void ClassTable::InsertWithHash(ObjPtr<mirror::Class> klass, size_t hash) {
   WriterMutexLock mu(Thread::Current(), lock_);
-  classes_.back().InsertWithHash(TableSlot(klass, hash), hash);
+  classes_.back()->InsertWithHash(TableSlot(klass, hash), hash);
 }
 
 bool ClassTable::InsertStrongRoot(ObjPtr<mirror::Object> obj) {
@@ -176,9 +212,56 @@ void ClassTable::AddClassSet(ClassSet&& set) {
   // Insert before the last (unfrozen) table since we add new classes into the back.
   // Keep the order of previous frozen tables unchanged, so that we can can remember
   // the number of searched frozen tables and not search them again.
+  // This also lets `Lookup()` skip the frozen tables it already searched without the lock.
   // TODO: Make use of this in `ClassLinker::FindClass()`.
   DCHECK(!classes_.empty());
-  classes_.insert(classes_.end() - 1, std::move(set));
+  classes_.insert(classes_.end() - 1, std::make_unique<ClassSet>(std::move(set)));
+  PublishFrozenSets();
+}
+
+ClassTable::DexFilesFilter::DexFilesFilter(std::vector<const DexFile*>&& dex_files)
+    : dex_files_(std::move(dex_files)) {
+  size_t num_classes = 0u;
+  for (const DexFile* dex_file : dex_files_) {
+    num_classes += dex_file->NumClassDefs();
+  }
+  size_t num_bits = RoundUpToPowerOfTwo(std::max<size_t>(num_classes * kBitsPerClass, 64u));
+  bits_.resize(num_bits / 64u, 0u);
+  mask_ = num_bits - 1u;
+  for (const DexFile* dex_file : dex_files_) {
+    for (uint32_t i = 0, num_defs = dex_file->NumClassDefs(); i != num_defs; ++i) {
+      const char* descriptor = dex_file->GetClassDescriptor(dex_file->GetClassDef(i));
+      Add(ComputeModifiedUtf8Hash(descriptor));
+    }
+  }
+}
+
+// Use two probes, the second derived from the descriptor hash by a multiplicative mix.
+static inline size_t SecondFilterProbe(size_t hash) {
+  return static_cast<uint32_t>(hash * 0x9e3779b9u) >> 7;
+}
+
+void ClassTable::DexFilesFilter::Add(size_t hash) {
+  for (size_t bit : {hash & mask_, SecondFilterProbe(hash) & mask_}) {
+    bits_[bit / 64u] |= UINT64_C(1) << (bit % 64u);
+  }
+}
+
+bool ClassTable::DexFilesFilter::MayContain(size_t hash) const {
+  for (size_t bit : {hash & mask_, SecondFilterProbe(hash) & mask_}) {
+    if ((bits_[bit / 64u] & (UINT64_C(1) << (bit % 64u))) == 0u) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ClassTable::SetDexFilesFilter(std::unique_ptr<DexFilesFilter>&& filter) {
+  WriterMutexLock mu(Thread::Current(), lock_);
+  if (owned_dex_files_filter_ == nullptr) {
+    dex_files_filter_.store(filter.get(), std::memory_order_release);
+    owned_dex_files_filter_ = std::move(filter);
+  }
 }
 
 void ClassTable::ClearStrongRoots() {
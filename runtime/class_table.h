@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_CLASS_TABLE_H_
 #define ART_RUNTIME_CLASS_TABLE_H_
 
+#include <atomic>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -30,6 +32,7 @@
 
 namespace art HIDDEN {
 
+class DexFile;
 class OatFile;
 
 namespace linker {
@@ -221,6 +224,7 @@ class ClassTable {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Return the first class that matches the descriptor. Returns null if there are none.
+  // Frozen class sets are searched without taking `lock_`, see `frozen_sets_`.
   ObjPtr<mirror::Class> Lookup(const char* descriptor, size_t hash)
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -274,12 +278,50 @@ class ClassTable {
     return lock_;
   }
 
+  // Bloom filter over the descriptors of the classes defined in the class loader's own dex
+  // files. Failed lookups in class loaders with many dex files probe every dex file's
+  // `TypeLookupTable`; a single filter query lets us skip all the covered dex files instead.
+  class DexFilesFilter {
+   public:
+    // Only worth building for class loaders with at least this many dex files.
+    static constexpr size_t kMinDexFiles = 4u;
+
+    explicit DexFilesFilter(std::vector<const DexFile*>&& dex_files);
+
+    // Returns whether `dex_file` is the `index`-th dex file the filter was built for.
+    bool Covers(size_t index, const DexFile* dex_file) const {
+      return index < dex_files_.size() && dex_files_[index] == dex_file;
+    }
+
+    // Returns false if no covered dex file defines a class with the descriptor `hash`.
+    bool MayContain(size_t hash) const;
+
+   private:
+    static constexpr size_t kBitsPerClass = 16u;
+
+    void Add(size_t hash);
+
+    const std::vector<const DexFile*> dex_files_;
+    std::vector<uint64_t> bits_;
+    size_t mask_;
+  };
+
+  const DexFilesFilter* GetDexFilesFilter() const {
+    return dex_files_filter_.load(std::memory_order_acquire);
+  }
+
+  // Install the filter unless another thread already did. The filter is never replaced.
+  void SetDexFilesFilter(std::unique_ptr<DexFilesFilter>&& filter) REQUIRES(!lock_);
+
  private:
   size_t CountDefiningLoaderClasses(ObjPtr<mirror::ClassLoader> defining_loader,
                                     const ClassSet& set) const
       REQUIRES(lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Publish the current list of frozen class sets for lock-free lookups.
+  void PublishFrozenSets() REQUIRES(lock_);
+
   // Return true if we inserted the oat file, false if it already exists.
   bool InsertOatFileLocked(const OatFile* oat_file)
       REQUIRES(lock_)
@@ -288,7 +330,18 @@ class ClassTable {
   // Lock to guard inserting and removing.
   mutable ReaderWriterMutex lock_;
   // We have a vector to help prevent dirty pages after the zygote forks by calling FreezeSnapshot.
-  std::vector<ClassSet> classes_ GUARDED_BY(lock_);
+  // The sets are allocated separately so that frozen sets do not move when the vector grows.
+  std::vector<std::unique_ptr<ClassSet>> classes_ GUARDED_BY(lock_);
+  // Immutable list of all class sets except the last (mutable) one, in the order of `classes_`.
+  // Frozen sets are never modified (other than GC root updates which are atomic) nor freed, so
+  // `Lookup()` can search them without `lock_`. Superseded lists are kept alive in
+  // `frozen_sets_history_` until the table is destroyed since a reader may still be using them.
+  using FrozenSets = std::vector<const ClassSet*>;
+  std::atomic<const FrozenSets*> frozen_sets_;
+  std::vector<std::unique_ptr<const FrozenSets>> frozen_sets_history_ GUARDED_BY(lock_);
+  // Filter for failed lookups in the class loader's dex files, built on the first failed lookup.
+  std::atomic<const DexFilesFilter*> dex_files_filter_;
+  std::unique_ptr<const DexFilesFilter> owned_dex_files_filter_ GUARDED_BY(lock_);
   // Extra strong roots that can be either dex files or dex caches. Dex files used by the class
   // loader which may not be owned by the class loader must be held strongly live. Also dex caches
   // are held live to prevent them being unloading once they have classes in them.
@@ -158,8 +158,41 @@ TEST_F(ClassTableTest, ClassTable) {
   EXPECT_OBJ_PTR_EQ(table2.LookupByDescriptor(h_X.Get()), h_X.Get());
   EXPECT_OBJ_PTR_EQ(table2.LookupByDescriptor(h_Y.Get()), h_Y.Get());
 
+  // Test that lookups find classes across multiple frozen sets and the mutable set.
+  ClassTable table3;
+  table3.Insert(h_X.Get());
+  table3.FreezeSnapshot();
+  table3.FreezeSnapshot();
+  EXPECT_OBJ_PTR_EQ(table3.LookupByDescriptor(h_X.Get()), h_X.Get());
+  EXPECT_TRUE(table3.LookupByDescriptor(h_Y.Get()) == nullptr);
+  table3.Insert(h_Y.Get());
+  EXPECT_OBJ_PTR_EQ(table3.LookupByDescriptor(h_X.Get()), h_X.Get());
+  EXPECT_OBJ_PTR_EQ(table3.LookupByDescriptor(h_Y.Get()), h_Y.Get());
+  EXPECT_EQ(table3.NumZygoteClasses(class_loader.Get()), 1u);
+  EXPECT_EQ(table3.NumNonZygoteClasses(class_loader.Get()), 1u);
+
   // TODO: Add tests for UpdateClass, InsertOatFile.
 }
 
+TEST_F(ClassTableTest, DexFilesFilter) {
+  ScopedObjectAccess soa(Thread::Current());
+  jobject jclass_loader = LoadDex("XandY");
+  VariableSizedHandleScope hs(soa.Self());
+  Handle<ClassLoader> class_loader(hs.NewHandle(soa.Decode<ClassLoader>(jclass_loader)));
+  ObjPtr<mirror::Class> klass = class_linker_->FindClass(soa.Self(), "LX;", class_loader);
+  ASSERT_TRUE(klass != nullptr);
+  const DexFile* dex_file = &klass->GetDexFile();
+
+  ClassTable::DexFilesFilter filter({dex_file});
+  EXPECT_TRUE(filter.Covers(0u, dex_file));
+  EXPECT_FALSE(filter.Covers(1u, dex_file));
+  EXPECT_FALSE(filter.Covers(0u, nullptr));
+  // Every class defined in the dex file must pass the filter.
+  for (uint32_t i = 0; i != dex_file->NumClassDefs(); ++i) {
+    const char* descriptor = dex_file->GetClassDescriptor(dex_file->GetClassDef(i));
+    EXPECT_TRUE(filter.MayContain(ComputeModifiedUtf8Hash(descriptor))) << descriptor;
+  }
+}
+
 }  // namespace mirror
 }  // namespace art
@@ -139,10 +139,15 @@ class EntrypointsOrderTest : public CommonArtTest {
         Thread, tlsPtr_, method_trace_buffer, method_trace_buffer_index, sizeof(void*));
     EXPECT_OFFSET_DIFFP(
         Thread, tlsPtr_, method_trace_buffer_index, thread_exit_flags, sizeof(void*));
+    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, thread_exit_flags, rosalloc_magazines, sizeof(void*));
+    EXPECT_OFFSET_DIFFP(
+        Thread, tlsPtr_, rosalloc_magazines, allocation_site_table, sizeof(void*));
+    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, allocation_site_table, monitor_cache, sizeof(void*));
     // The first field after tlsPtr_ is forced to a 16 byte alignment so it might have some space.
     auto offset_tlsptr_end = OFFSETOF_MEMBER(Thread, tlsPtr_) +
         sizeof(decltype(reinterpret_cast<Thread*>(16)->tlsPtr_));
-    CHECKED(offset_tlsptr_end - OFFSETOF_MEMBER(Thread, tlsPtr_.thread_exit_flags) == sizeof(void*),
+    CHECKED(offset_tlsptr_end - OFFSETOF_MEMBER(Thread, tlsPtr_.monitor_cache) ==
+                sizeof(void*),
             "async_exception last field");
   }
 
@@ -66,7 +66,9 @@ static bool art_sigbus_handler(int sig, siginfo_t* info, void* context) {
 FaultManager::FaultManager()
     : generated_code_ranges_lock_("FaultHandler generated code ranges lock",
                                   LockLevel::kGenericBottomLock),
-      initialized_(false) {}
+      initialized_(false),
+      last_fault_range_(0u),
+      generated_code_ranges_generation_(0u) {}
 
 FaultManager::~FaultManager() {
 }
@@ -193,6 +195,8 @@ void FaultManager::Shutdown() {
     MutexLock lock(Thread::Current(), generated_code_ranges_lock_);
     GeneratedCodeRange* range = generated_code_ranges_.load(std::memory_order_acquire);
     generated_code_ranges_.store(nullptr, std::memory_order_release);
+    last_fault_range_.store(0u, std::memory_order_relaxed);
+    generated_code_ranges_generation_.fetch_add(1u, std::memory_order_relaxed);
     while (range != nullptr) {
       GeneratedCodeRange* next_range = range->next.load(std::memory_order_relaxed);
       std::less<GeneratedCodeRange*> less;
@@ -475,6 +479,10 @@ void FaultManager::RemoveGeneratedCodeRange(const void* start, size_t size) {
       }
     }
   }
+  // No walk that starts from now on can find the removed range, so invalidate any cached
+  // reference to it before the storage is reset. See `IsInGeneratedCode()`.
+  generated_code_ranges_generation_.fetch_add(1u, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
   FreeGeneratedCodeRange(range);
 }
 
@@ -510,10 +518,36 @@ bool FaultManager::IsInGeneratedCode(siginfo_t* siginfo, void* context) {
     return false;
   }
 
+  // Check the range of the last fault first. The cached entry is valid only for the generation
+  // it was found in. If the generation changes while we read the entry, its storage may have
+  // been reset concurrently, so we do not trust what we read and walk the list instead.
+  static_assert(kNumLocalGeneratedCodeRanges < 0xffu);
+  uint32_t generation = generated_code_ranges_generation_.load(std::memory_order_acquire);
+  uint64_t cached = last_fault_range_.load(std::memory_order_acquire);
+  if (cached != 0u && (cached >> 8) == generation) {
+    const GeneratedCodeRange& cached_range = generated_code_ranges_storage_[(cached & 0xffu) - 1u];
+    uintptr_t start = reinterpret_cast<uintptr_t>(cached_range.start);
+    size_t size = cached_range.size;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (generation == generated_code_ranges_generation_.load(std::memory_order_relaxed) &&
+        fault_pc - start < size) {
+      return true;
+    }
+  }
+
   // Walk over the list of registered code ranges.
   GeneratedCodeRange* range = generated_code_ranges_.load(std::memory_order_acquire);
   while (range != nullptr) {
     if (fault_pc - reinterpret_cast<uintptr_t>(range->start) < range->size) {
+      std::less<GeneratedCodeRange*> less;
+      if (!less(range, generated_code_ranges_storage_) &&
+          less(range, generated_code_ranges_storage_ + kNumLocalGeneratedCodeRanges)) {
+        // The release store republishes `start` and `size` that we saw through the acquire
+        // load of `generated_code_ranges_` to threads that read the cache.
+        uint64_t index = static_cast<uint64_t>(range - generated_code_ranges_storage_);
+        last_fault_range_.store((static_cast<uint64_t>(generation) << 8) | (index + 1u),
+                                std::memory_order_release);
+      }
       return true;
     }
     // We may or may not see ranges that were concurrently removed, depending
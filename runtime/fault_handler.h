@@ -116,6 +116,16 @@ class FaultManager {
   GeneratedCodeRange* free_generated_code_ranges_
        GUARDED_BY(generated_code_ranges_lock_);
 
+  // Cache of the entry of `generated_code_ranges_storage_` that contained the last fault PC
+  // found by `IsInGeneratedCode()`, encoded as `(generation << 8) | (index + 1)`, or 0.
+  // Implicit checks that fire repeatedly fault from the same range, so this usually avoids
+  // the list walk. Written without the lock from signal handlers.
+  std::atomic<uint64_t> last_fault_range_;
+  // Incremented after a removed range can no longer be found by walking the list and before
+  // its storage is reset. This invalidates `last_fault_range_` and lets readers detect a
+  // concurrent reset of the cached entry, like a sequence lock.
+  std::atomic<uint32_t> generated_code_ranges_generation_;
+
   DISALLOW_COPY_AND_ASSIGN(FaultManager);
 };
 
@@ -20,6 +20,7 @@
 #include <sys/mman.h>  // For the PROT_* and MAP_* constants.
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -41,6 +42,9 @@ namespace art HIDDEN {
 namespace gc {
 namespace accounting {
 
+template <typename T>
+class AtomicStackChunkList;
+
 // Internal representation is StackReference<T>, so this only works with mirror::Object or its
 // subclasses.
 template <typename T>
@@ -318,10 +322,103 @@ class AtomicStack {
   size_t capacity_;
   // Whether or not the stack is sorted, only updated in debug mode to avoid performance overhead.
   bool debug_is_sorted_;
+  // The next stack in the AtomicStackChunkList holding this stack.
+  AtomicStack* next_chunk_ = nullptr;
 
+  friend class AtomicStackChunkList<T>;
   DISALLOW_COPY_AND_ASSIGN(AtomicStack);
 };
 
+// A lock-free list of atomic stacks used as the chunks of a segmented stack, such as the pools
+// of thread-local mark stacks: a thread whose chunk is full swaps it for an empty one without
+// taking a lock, and the collector takes all the full ones at once. Any thread may push and pop
+// chunks. Pops detach the whole list with an exchange, so that a chunk popped and pushed again
+// by other threads in the meantime cannot corrupt the list (the ABA problem of lock-free stacks).
+template <typename T>
+class AtomicStackChunkList {
+ public:
+  AtomicStackChunkList() : head_(nullptr), size_(0) {}
+
+  // The number of chunks in the list. Only exact when no other thread uses the list.
+  size_t Size() const {
+    return size_.load(std::memory_order_relaxed);
+  }
+
+  bool IsEmpty() const {
+    return head_.load(std::memory_order_relaxed) == nullptr;
+  }
+
+  // Push `chunk`, which must not be in a list. Its contents are visible to the thread that pops
+  // it.
+  void Push(AtomicStack<T>* chunk) {
+    PushList(chunk, chunk, 1u);
+  }
+
+  // Pop a chunk, or return null if the list is empty.
+  AtomicStack<T>* Pop() {
+    AtomicStack<T>* chunk = head_.exchange(nullptr, std::memory_order_acquire);
+    if (chunk == nullptr) {
+      return nullptr;
+    }
+    size_.fetch_sub(1u, std::memory_order_relaxed);
+    AtomicStack<T>* rest = chunk->next_chunk_;
+    chunk->next_chunk_ = nullptr;
+    if (rest != nullptr) {
+      // Put the other chunks back. Usually nobody pushed in the meantime and the list is still
+      // empty, otherwise find the end of our chunks to link them in front of the new ones.
+      AtomicStack<T>* expected = nullptr;
+      if (!head_.compare_exchange_strong(expected,
+                                         rest,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+        AtomicStack<T>* last = rest;
+        while (last->next_chunk_ != nullptr) {
+          last = last->next_chunk_;
+        }
+        PushList(rest, last, 0u);
+      }
+    }
+    return chunk;
+  }
+
+  // Pop all the chunks and pass them to `visitor`, in no particular order. The visitor may push
+  // the chunks to any list. Returns the number of chunks visited.
+  template <typename Visitor>
+  size_t PopAll(Visitor&& visitor) {
+    AtomicStack<T>* chunk = head_.exchange(nullptr, std::memory_order_acquire);
+    size_t count = 0;
+    while (chunk != nullptr) {
+      AtomicStack<T>* next = chunk->next_chunk_;
+      chunk->next_chunk_ = nullptr;
+      ++count;
+      visitor(chunk);
+      chunk = next;
+    }
+    size_.fetch_sub(count, std::memory_order_relaxed);
+    return count;
+  }
+
+ private:
+  // Push the chunks from `first` to `last`, linked through `next_chunk_`, and account for
+  // `count` new chunks.
+  void PushList(AtomicStack<T>* first, AtomicStack<T>* last, size_t count) {
+    size_.fetch_add(count, std::memory_order_relaxed);
+    AtomicStack<T>* head = head_.load(std::memory_order_relaxed);
+    do {
+      last->next_chunk_ = head;
+    } while (!head_.compare_exchange_weak(head,
+                                          first,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed));
+  }
+
+  std::atomic<AtomicStack<T>*> head_;
+  // Approximate while the list is in use, as chunks are counted apart from linking them.
+  std::atomic<size_t> size_;
+
+  DISALLOW_COPY_AND_ASSIGN(AtomicStackChunkList);
+};
+
 using ObjectStack = AtomicStack<mirror::Object>;
 
 }  // namespace accounting
@@ -19,6 +19,8 @@
 
 #include "card_table.h"
 
+#include <limits>
+
 #include <android-base/logging.h>
 
 #include "base/atomic.h"
@@ -51,6 +53,30 @@ static inline bool byte_cas(uint8_t old_value, uint8_t new_value, uint8_t* addre
 #endif
 }
 
+// The number of cards that Scan() and ModifyCardsAtomic() check at once for being all clean.
+static constexpr size_t kCardBlockSize = kZeroBlockSize;
+
+// Returns whether the `kCardBlockSize` cards at `cards`, which must be aligned to
+// `kCardBlockSize`, are all clean.
+static ALWAYS_INLINE bool AllCardsClean(const uint8_t* cards) {
+  static_assert(CardTable::kCardClean == 0);
+  return IsZeroBlock(cards);
+}
+
+// Returns a mask with the most significant bit of each byte of `cards` set if that card is at
+// least `minimum_age`, provided that no card is above 0x7f (see Scan()).
+static ALWAYS_INLINE uintptr_t CardsAtLeast(uintptr_t cards, uint8_t minimum_age) {
+  constexpr uintptr_t kLowBits = std::numeric_limits<uintptr_t>::max() / 0xff;
+  constexpr uintptr_t kHighBits = kLowBits << 7;
+  DCHECK_EQ(cards & kHighBits, 0u);
+  if (UNLIKELY(minimum_age > 0x80u)) {
+    return 0u;
+  }
+  // Adding 0x80 - minimum_age to each card sets its most significant bit iff it is at least
+  // `minimum_age`, and cannot carry into the next card.
+  return (cards + kLowBits * (0x80u - minimum_age)) & kHighBits;
+}
+
 template <bool kClearCard, typename Visitor>
 inline size_t CardTable::Scan(ContinuousSpaceBitmap* bitmap,
                               uint8_t* const scan_begin,
@@ -67,12 +93,41 @@ inline size_t CardTable::Scan(ContinuousSpaceBitmap* bitmap,
   CheckCardValid(card_end);
   size_t cards_scanned = 0;
 
+  auto scan_card = [&](uint8_t* card) {
+    uintptr_t start = reinterpret_cast<uintptr_t>(AddrFromCard(card));
+    bitmap->VisitMarkedRange(start, start + kCardSize, visitor);
+    ++cards_scanned;
+  };
+  // Visit the cards of the word at `word_cur` that are at least `minimum_age`.
+  auto scan_word = [&](uintptr_t* word_cur) {
+    uintptr_t word = *word_cur;
+    if (word == 0) {
+      return;
+    }
+    uint8_t* cards = reinterpret_cast<uint8_t*>(word_cur);
+    constexpr uintptr_t kHighBits = (std::numeric_limits<uintptr_t>::max() / 0xff) << 7;
+    if (UNLIKELY((word & kHighBits) != 0)) {
+      // ART only uses cards up to kCardDirty, but be correct for any value.
+      for (size_t i = 0; i < sizeof(uintptr_t); ++i) {
+        if (static_cast<uint8_t>(word >> (i * kBitsPerByte)) >= minimum_age) {
+          scan_card(cards + i);
+        }
+      }
+      return;
+    }
+    // Find the cards to visit without going through the clean ones. This relies on
+    // the byte order, like ModifyCardsAtomic().
+    for (uintptr_t mask = CardsAtLeast(word, minimum_age); mask != 0; mask &= mask - 1) {
+      uint8_t* card = cards + CTZ(mask) / kBitsPerByte;
+      DCHECK(*card >= minimum_age || *card == kCardDirty) << static_cast<size_t>(*card);
+      scan_card(card);
+    }
+  };
+
   // Handle any unaligned cards at the start.
   while (!IsAligned<sizeof(intptr_t)>(card_cur) && card_cur < card_end) {
     if (*card_cur >= minimum_age) {
-      uintptr_t start = reinterpret_cast<uintptr_t>(AddrFromCard(card_cur));
-      bitmap->VisitMarkedRange(start, start + kCardSize, visitor);
-      ++cards_scanned;
+      scan_card(card_cur);
     }
     ++card_cur;
   }
@@ -83,43 +138,33 @@ inline size_t CardTable::Scan(ContinuousSpaceBitmap* bitmap,
         (reinterpret_cast<uintptr_t>(card_end) & (sizeof(uintptr_t) - 1));
     DCHECK_LE(card_cur, aligned_end);
 
-    uintptr_t* word_end = reinterpret_cast<uintptr_t*>(aligned_end);
-    for (uintptr_t* word_cur = reinterpret_cast<uintptr_t*>(card_cur); word_cur < word_end;
-        ++word_cur) {
-      while (LIKELY(*word_cur == 0)) {
-        ++word_cur;
-        if (UNLIKELY(word_cur >= word_end)) {
-          goto exit_for;
-        }
-      }
-
-      // Find the first dirty card.
-      uintptr_t start_word = *word_cur;
-      uintptr_t start =
-          reinterpret_cast<uintptr_t>(AddrFromCard(reinterpret_cast<uint8_t*>(word_cur)));
-      // TODO: Investigate if processing continuous runs of dirty cards with
-      // a single bitmap visit is more efficient.
-      for (size_t i = 0; i < sizeof(uintptr_t); ++i) {
-        if (static_cast<uint8_t>(start_word) >= minimum_age) {
-          auto* card = reinterpret_cast<uint8_t*>(word_cur) + i;
-          DCHECK(*card == static_cast<uint8_t>(start_word) || *card == kCardDirty)
-              << "card " << static_cast<size_t>(*card) << " intptr_t " << (start_word & 0xFF);
-          bitmap->VisitMarkedRange(start, start + kCardSize, visitor);
-          ++cards_scanned;
+    uintptr_t* word_cur = reinterpret_cast<uintptr_t*>(card_cur);
+    uintptr_t* const word_end = reinterpret_cast<uintptr_t*>(aligned_end);
+    // Go word by word up to a block boundary, then skip the clean blocks, which are the vast
+    // majority in most spaces, a block at a time.
+    while (word_cur < word_end && !IsAligned<kCardBlockSize>(word_cur)) {
+      scan_word(word_cur);
+      ++word_cur;
+    }
+    constexpr size_t kWordsPerBlock = kCardBlockSize / sizeof(uintptr_t);
+    while (word_end - word_cur >= static_cast<ptrdiff_t>(kWordsPerBlock)) {
+      if (!AllCardsClean(reinterpret_cast<uint8_t*>(word_cur))) {
+        for (size_t i = 0; i < kWordsPerBlock; ++i) {
+          scan_word(word_cur + i);
         }
-        start_word >>= 8;
-        start += kCardSize;
       }
+      word_cur += kWordsPerBlock;
+    }
+    while (word_cur < word_end) {
+      scan_word(word_cur);
+      ++word_cur;
     }
-    exit_for:
 
     // Handle any unaligned cards at the end.
     card_cur = reinterpret_cast<uint8_t*>(word_end);
     while (card_cur < card_end) {
       if (*card_cur >= minimum_age) {
-        uintptr_t start = reinterpret_cast<uintptr_t>(AddrFromCard(card_cur));
-        bitmap->VisitMarkedRange(start, start + kCardSize, visitor);
-        ++cards_scanned;
+        scan_card(card_cur);
       }
       ++card_cur;
     }
@@ -184,6 +229,13 @@ inline void CardTable::ModifyCardsAtomic(uint8_t* scan_begin,
 
   // TODO: Parallelize.
   while (word_cur < word_end) {
+    if (IsAligned<kCardBlockSize>(word_cur) &&
+        word_end - word_cur >= static_cast<ptrdiff_t>(kCardBlockSize / sizeof(uintptr_t)) &&
+        AllCardsClean(reinterpret_cast<uint8_t*>(word_cur))) {
+      // The visitor leaves clean cards alone.
+      word_cur += kCardBlockSize / sizeof(uintptr_t);
+      continue;
+    }
     while (true) {
       expected_word = *word_cur;
       static_assert(kCardClean == 0);
@@ -53,7 +53,9 @@ namespace accounting {
  * byte is equal to `kCardDirty`. See CardTable::Create for details.
  */
 
-CardTable* CardTable::Create(const uint8_t* heap_begin, size_t heap_capacity) {
+CardTable* CardTable::Create(const uint8_t* heap_begin,
+                             size_t heap_capacity,
+                             bool use_huge_pages) {
   ScopedTrace trace(__PRETTY_FUNCTION__);
   /* Set up the card table */
   size_t capacity = heap_capacity / kCardSize;
@@ -65,6 +67,9 @@ CardTable* CardTable::Create(const uint8_t* heap_begin, size_t heap_capacity) {
                                         /*low_4gb=*/ false,
                                         &error_msg);
   CHECK(mem_map.IsValid()) << "couldn't allocate card table: " << error_msg;
+  if (use_huge_pages && mem_map.MadviseHugePage() != 0) {
+    PLOG(WARNING) << "Failed to back the card table with huge pages";
+  }
   // All zeros is the correct initial value; all clean. Anonymous mmaps are initialized to zero, we
   // don't clear the card table to avoid unnecessary pages being allocated
   static_assert(kCardClean == 0, "kCardClean must be 0");
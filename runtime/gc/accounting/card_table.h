@@ -52,7 +52,11 @@ class CardTable {
   static constexpr uint8_t kCardDirty = 0x70;
   static constexpr uint8_t kCardAged = kCardDirty - 1;
 
-  static CardTable* Create(const uint8_t* heap_begin, size_t heap_capacity);
+  // If use_huge_pages is true, the table is backed by transparent huge pages where possible,
+  // which reduces TLB misses when scanning the cards of multi-GB heaps.
+  static CardTable* Create(const uint8_t* heap_begin,
+                           size_t heap_capacity,
+                           bool use_huge_pages = false);
   ~CardTable();
 
   // Set the card associated with the given address to `kCardDirty`.
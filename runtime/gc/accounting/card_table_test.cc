@@ -21,6 +21,7 @@
 #include "base/atomic.h"
 #include "base/common_art_test.h"
 #include "base/utils.h"
+#include "space_bitmap-inl.h"
 #include "handle_scope-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/string-inl.h"  // Strings are easiest to allocate
@@ -145,7 +146,49 @@ TEST_F(CardTableTest, TestModifyCardsAtomic) {
   }
 }
 
-// TODO: Add test for CardTable::Scan.
+TEST_F(CardTableTest, TestScan) {
+  CommonSetup();
+  ContinuousSpaceBitmap bitmap(ContinuousSpaceBitmap::Create(
+      "card table test bitmap", HeapBegin(), HeapLimit() - HeapBegin()));
+  ASSERT_TRUE(bitmap.IsValid());
+  // Mark one object per card, at varying offsets.
+  for (uint8_t* addr = HeapBegin(); addr < HeapLimit(); addr += CardTable::kCardSize) {
+    size_t offset = ((addr - HeapBegin()) / CardTable::kCardSize * kObjectAlignment) %
+                    CardTable::kCardSize;
+    bitmap.Set(reinterpret_cast<mirror::Object*>(addr + offset));
+  }
+  // Leave long runs of clean cards, as well as cards of any value, including above kCardDirty.
+  for (uint8_t* addr = HeapBegin(); addr < HeapLimit(); addr += CardTable::kCardSize) {
+    size_t card_index = (addr - HeapBegin()) / CardTable::kCardSize;
+    if (card_index % 97 < 40) {
+      *card_table_->CardFromAddr(addr) = PseudoRandomCard(addr);
+    }
+  }
+  for (uint8_t minimum_age : {CardTable::kCardAged, CardTable::kCardDirty, uint8_t{0x90}}) {
+    for (size_t start_cards : {0u, 1u, 7u, 33u}) {
+      for (size_t end_cards : {0u, 3u, 31u}) {
+        uint8_t* start = HeapBegin() + start_cards * CardTable::kCardSize;
+        uint8_t* end = HeapLimit() - end_cards * CardTable::kCardSize;
+        size_t expected_cards = 0;
+        for (uint8_t* addr = start; addr < end; addr += CardTable::kCardSize) {
+          if (*card_table_->CardFromAddr(addr) >= minimum_age) {
+            ++expected_cards;
+          }
+        }
+        size_t visited_objects = 0;
+        auto visitor = [&](mirror::Object* obj) {
+          EXPECT_GE(*card_table_->CardFromAddr(obj), minimum_age);
+          ++visited_objects;
+        };
+        size_t scanned_cards =
+            card_table_->Scan</*kClearCard=*/ false>(&bitmap, start, end, visitor, minimum_age);
+        EXPECT_EQ(expected_cards, scanned_cards);
+        EXPECT_EQ(expected_cards, visited_objects);
+      }
+    }
+  }
+}
+
 }  // namespace accounting
 }  // namespace gc
 }  // namespace art
@@ -158,22 +158,37 @@ inline void SpaceBitmap<kAlignment>::VisitMarkedRange(uintptr_t visit_begin,
       } while (left_edge != 0);
     }
 
-    // Traverse the middle, full part.
-    for (size_t i = index_start + 1; i < index_end; ++i) {
+    // Traverse the middle, full part. Sparse bitmaps have long runs of empty words, which are
+    // skipped a block at a time. The block loads are as racy as the relaxed word loads.
+    constexpr size_t kWordsPerBlock = kZeroBlockSize / sizeof(uintptr_t);
+    size_t i = index_start + 1;
+    while (i < index_end) {
+      if (IsAligned<kWordsPerBlock>(i) &&
+          i + kWordsPerBlock <= index_end &&
+          IsZeroBlock(&bitmap_begin_[i])) {
+        i += kWordsPerBlock;
+        continue;
+      }
       uintptr_t w = bitmap_begin_[i].load(std::memory_order_relaxed);
       if (w != 0) {
         const uintptr_t ptr_base = IndexToOffset(i) + heap_begin_;
         // Iterate on the bits set in word `w`, from the least to the most significant bit.
+        // The header of the next object is prefetched while the visitor runs, as visitors
+        // usually read it.
         do {
           const size_t shift = CTZ(w);
           mirror::Object* obj = reinterpret_cast<mirror::Object*>(ptr_base + shift * kAlignment);
+          w ^= (static_cast<uintptr_t>(1)) << shift;
+          if (w != 0) {
+            __builtin_prefetch(reinterpret_cast<void*>(ptr_base + CTZ(w) * kAlignment));
+          }
           visitor(obj);
           if (kVisitOnce) {
             return;
           }
-          w ^= (static_cast<uintptr_t>(1)) << shift;
         } while (w != 0);
       }
+      ++i;
     }
 
     // Right edge is unique.
@@ -226,7 +226,15 @@ void SpaceBitmap<kAlignment>::SweepWalk(const SpaceBitmap<kAlignment>& live_bitm
   mirror::Object** cur_pointer = &pointer_buf[0];
   mirror::Object** pointer_end = cur_pointer + (buffer_size - kBitsPerIntPtrT);
 
+  // Runs of words without garbage are skipped a block at a time.
+  constexpr size_t kWordsPerBlock = kZeroBlockSize / sizeof(uintptr_t);
   for (size_t i = start; i <= end; i++) {
+    if (IsAligned<kWordsPerBlock>(i) &&
+        i + kWordsPerBlock <= end + 1 &&
+        IsZeroBlockAndNot(&live[i], &mark[i])) {
+      i += kWordsPerBlock - 1;
+      continue;
+    }
     uintptr_t garbage =
         live[i].load(std::memory_order_relaxed) & ~mark[i].load(std::memory_order_relaxed);
     if (UNLIKELY(garbage != 0)) {
@@ -44,6 +44,30 @@ static constexpr bool kUsePrefetchDuringAllocRun = false;
 static constexpr bool kPrefetchNewRunDataByZeroing = false;
 static constexpr size_t kPrefetchStride = 64;
 
+// Source of the RosAlloc ids that identify the owner of a thread's magazines.
+static std::atomic<uint32_t> gNextRosAllocId(1);
+
+// Locks a size bracket lock, counting the acquisitions that had to wait for another thread.
+class SCOPED_CAPABILITY BracketMutexLock {
+ public:
+  BracketMutexLock(Thread* self, Mutex& mu, std::atomic<uint64_t>* contentions) ACQUIRE(mu)
+      NO_THREAD_SAFETY_ANALYSIS : self_(self), mu_(mu) {
+    if (!mu_.ExclusiveTryLock(self_)) {
+      contentions->fetch_add(1, std::memory_order_relaxed);
+      mu_.ExclusiveLock(self_);
+    }
+  }
+
+  ~BracketMutexLock() RELEASE() NO_THREAD_SAFETY_ANALYSIS {
+    mu_.ExclusiveUnlock(self_);
+  }
+
+ private:
+  Thread* const self_;
+  Mutex& mu_;
+  DISALLOW_COPY_AND_ASSIGN(BracketMutexLock);
+};
+
 size_t RosAlloc::bracketSizes[kNumOfSizeBrackets];
 size_t RosAlloc::numOfPages[kNumOfSizeBrackets];
 size_t RosAlloc::numOfSlots[kNumOfSizeBrackets];
@@ -62,7 +86,12 @@ RosAlloc::RosAlloc(void* base, size_t capacity, size_t max_capacity,
       bulk_free_lock_("rosalloc bulk free lock", kRosAllocBulkFreeLock),
       page_release_mode_(page_release_mode),
       page_release_size_threshold_(page_release_size_threshold),
-      is_running_on_memory_tool_(running_on_memory_tool) {
+      is_running_on_memory_tool_(running_on_memory_tool),
+      id_(gNextRosAllocId.fetch_add(1, std::memory_order_relaxed)),
+      use_magazines_(false),
+      magazine_allocs_(0),
+      magazine_flushes_(0),
+      bracket_lock_contentions_(0) {
   DCHECK_ALIGNED_PARAM(base, gPageSize);
   DCHECK_EQ(RoundUp(capacity, gPageSize), capacity);
   DCHECK_EQ(RoundUp(max_capacity, gPageSize), max_capacity);
@@ -539,9 +568,106 @@ size_t RosAlloc::FreeInternal(Thread* self, void* ptr) {
 
 size_t RosAlloc::Free(Thread* self, void* ptr) {
   ReaderMutexLock rmu(self, bulk_free_lock_);
+  if (use_magazines_) {
+    size_t freed_bytes = FreeToMagazine(self, ptr);
+    if (freed_bytes != 0) {
+      return freed_bytes;
+    }
+  }
   return FreeInternal(self, ptr);
 }
 
+RosAlloc::Run* RosAlloc::GetRunOfAllocatedSlot(void* ptr) {
+  DCHECK_LE(base_, ptr);
+  DCHECK_LT(ptr, base_ + footprint_);
+  size_t pm_idx = RoundDownToPageMapIndex(ptr);
+  uint8_t page_map_entry = page_map_[pm_idx];
+  if (page_map_entry == kPageMapLargeObject) {
+    return nullptr;
+  }
+  DCHECK(page_map_entry == kPageMapRun || page_map_entry == kPageMapRunPart)
+      << "Unreachable - page map type: " << static_cast<int>(page_map_entry);
+  // Find the beginning of the run.
+  while (page_map_[pm_idx] != kPageMapRun) {
+    --pm_idx;
+    DCHECK_LT(pm_idx, DivideByPageSize(capacity_));
+  }
+  Run* run = reinterpret_cast<Run*>(base_ + pm_idx * gPageSize);
+  DCHECK_EQ(run->magic_num_, kMagicNum);
+  return run;
+}
+
+RosAlloc::Magazines* RosAlloc::GetMagazines(Thread* self, bool create) {
+  Magazines* magazines = reinterpret_cast<Magazines*>(self->GetRosAllocMagazines());
+  if (magazines == nullptr) {
+    if (!create) {
+      return nullptr;
+    }
+    magazines = new Magazines();
+    magazines->owner_id = id_;
+    self->SetRosAllocMagazines(magazines);
+  }
+  // Another allocator's magazines are left for it to flush.
+  return magazines->owner_id == id_ ? magazines : nullptr;
+}
+
+void* RosAlloc::AllocFromMagazine(Thread* self, size_t idx) {
+  DCHECK_GE(idx, kNumThreadLocalSizeBrackets);
+  Magazines* magazines = GetMagazines(self, /*create=*/ false);
+  if (magazines == nullptr) {
+    return nullptr;
+  }
+  const size_t magazine_idx = idx - kNumThreadLocalSizeBrackets;
+  uint8_t& num_slots = magazines->num_slots[magazine_idx];
+  if (num_slots == 0) {
+    return nullptr;
+  }
+  void* slot_addr = magazines->slots[magazine_idx][--num_slots];
+  // The slot still holds the freed object, clear it like Run::FreeSlot() does.
+  memset(slot_addr, 0, bracketSizes[idx]);
+  magazine_allocs_.fetch_add(1, std::memory_order_relaxed);
+  return slot_addr;
+}
+
+size_t RosAlloc::FreeToMagazine(Thread* self, void* ptr) {
+  Run* run = GetRunOfAllocatedSlot(ptr);
+  if (run == nullptr) {
+    return 0;
+  }
+  const size_t idx = run->size_bracket_idx_;
+  if (idx < kNumThreadLocalSizeBrackets) {
+    return 0;
+  }
+  DCHECK(!run->IsThreadLocal());
+  Magazines* magazines = GetMagazines(self, /*create=*/ true);
+  if (magazines == nullptr) {
+    return 0;
+  }
+  const size_t magazine_idx = idx - kNumThreadLocalSizeBrackets;
+  if (magazines->num_slots[magazine_idx] == kMagazineSize) {
+    FlushMagazine(self, magazines, idx);
+  }
+  magazines->slots[magazine_idx][magazines->num_slots[magazine_idx]++] = ptr;
+  return bracketSizes[idx];
+}
+
+void RosAlloc::FlushMagazine(Thread* self, Magazines* magazines, size_t idx) {
+  const size_t magazine_idx = idx - kNumThreadLocalSizeBrackets;
+  const size_t num_slots = magazines->num_slots[magazine_idx];
+  if (num_slots == 0) {
+    return;
+  }
+  {
+    BracketMutexLock brackets_mu(self, *size_bracket_locks_[idx], &bracket_lock_contentions_);
+    for (size_t i = 0; i < num_slots; ++i) {
+      void* ptr = magazines->slots[magazine_idx][i];
+      FreeFromRunLocked(self, ptr, GetRunOfAllocatedSlot(ptr));
+    }
+  }
+  magazines->num_slots[magazine_idx] = 0;
+  magazine_flushes_.fetch_add(1, std::memory_order_relaxed);
+}
+
 RosAlloc::Run* RosAlloc::AllocRun(Thread* self, size_t idx) {
   RosAlloc::Run* new_run = nullptr;
   {
@@ -734,9 +860,13 @@ void* RosAlloc::AllocFromRun(Thread* self, size_t size, size_t* bytes_allocated,
     *bytes_allocated = bracket_size;
     *usable_size = bracket_size;
   } else {
-    // Use the (shared) current run.
-    MutexLock mu(self, *size_bracket_locks_[idx]);
-    slot_addr = AllocFromCurrentRunUnlocked(self, idx);
+    // Use a slot this thread freed, which was subtracted from the allocated bytes when freed, or
+    // the (shared) current run.
+    slot_addr = use_magazines_ ? AllocFromMagazine(self, idx) : nullptr;
+    if (slot_addr == nullptr) {
+      BracketMutexLock mu(self, *size_bracket_locks_[idx], &bracket_lock_contentions_);
+      slot_addr = AllocFromCurrentRunUnlocked(self, idx);
+    }
     if (kTraceRosAlloc) {
       LOG(INFO) << "RosAlloc::AllocFromRun() : 0x" << std::hex
                 << reinterpret_cast<intptr_t>(slot_addr)
@@ -754,13 +884,20 @@ void* RosAlloc::AllocFromRun(Thread* self, size_t size, size_t* bytes_allocated,
 }
 
 size_t RosAlloc::FreeFromRun(Thread* self, void* ptr, Run* run) {
+  DCHECK_EQ(run->magic_num_, kMagicNum);
+  BracketMutexLock brackets_mu(
+      self, *size_bracket_locks_[run->size_bracket_idx_], &bracket_lock_contentions_);
+  return FreeFromRunLocked(self, ptr, run);
+}
+
+size_t RosAlloc::FreeFromRunLocked(Thread* self, void* ptr, Run* run) {
   DCHECK_EQ(run->magic_num_, kMagicNum);
   DCHECK_LT(run, ptr);
   DCHECK_LT(ptr, run->End());
   const size_t idx = run->size_bracket_idx_;
   const size_t bracket_size = bracketSizes[idx];
   bool run_was_full = false;
-  MutexLock brackets_mu(self, *size_bracket_locks_[idx]);
+  size_bracket_locks_[idx]->AssertHeld(self);
   if (kIsDebugBuild) {
     run_was_full = run->IsFull();
   }
@@ -1502,6 +1639,16 @@ void RosAlloc::SetFootprintLimit(size_t new_capacity) {
 size_t RosAlloc::RevokeThreadLocalRuns(Thread* thread) {
   Thread* self = Thread::Current();
   size_t free_bytes = 0U;
+  Magazines* magazines = GetMagazines(thread, /*create=*/ false);
+  if (magazines != nullptr) {
+    // The cached slots were already counted as freed, so they do not add to free_bytes.
+    ReaderMutexLock rmu(self, bulk_free_lock_);
+    for (size_t idx = kNumThreadLocalSizeBrackets; idx < kNumOfSizeBrackets; ++idx) {
+      FlushMagazine(self, magazines, idx);
+    }
+    thread->SetRosAllocMagazines(nullptr);
+    delete magazines;
+  }
   for (size_t idx = 0; idx < kNumThreadLocalSizeBrackets; idx++) {
     MutexLock mu(self, *size_bracket_locks_[idx]);
     Run* thread_local_run = reinterpret_cast<Run*>(thread->GetRosAllocRun(idx));
@@ -1975,14 +2122,14 @@ void RosAlloc::Run::Verify(Thread* self, RosAlloc* rosalloc, bool running_on_mem
   }
 }
 
-size_t RosAlloc::ReleasePages() {
+size_t RosAlloc::ReleasePages(size_t max_bytes) {
   VLOG(heap) << "RosAlloc::ReleasePages()";
   DCHECK(!DoesReleaseAllPages());
   Thread* self = Thread::Current();
   size_t reclaimed_bytes = 0;
   size_t i = 0;
   // Check the page map size which might have changed due to grow/shrink.
-  while (i < page_map_size_) {
+  while (i < page_map_size_ && reclaimed_bytes < max_bytes) {
     // Reading the page map without a lock is racy but the race is benign since it should only
     // result in occasionally not releasing pages which we could release.
     uint8_t pm = page_map_[i];
@@ -2179,6 +2326,9 @@ void RosAlloc::DumpStats(std::ostream& os) {
   os << "Total #total_bytes=" << PrettySize(total_num_pages * gPageSize)
      << " #metadata_bytes=" << PrettySize(total_metadata_bytes)
      << " #used_bytes=" << PrettySize(total_allocated_bytes) << "\n";
+  os << "Magazine #allocations=" << GetMagazineAllocCount()
+     << " #flushes=" << GetMagazineFlushCount()
+     << " #contended_bracket_locks=" << GetBracketLockContentionCount() << "\n";
   os << "\n";
 }
 
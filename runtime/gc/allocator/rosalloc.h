@@ -20,6 +20,8 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <sys/mman.h>
+#include <atomic>
+#include <limits>
 #include <memory>
 #include <set>
 #include <string>
@@ -690,6 +692,10 @@ class RosAlloc {
   // Equal to Log2(kBracketQuantumSize).
   static constexpr size_t kBracketQuantumSizeShift = 4;
 
+  // The number of freed slots a thread caches for each size bracket that uses the shared current
+  // runs, before returning them to their runs in a batch.
+  static constexpr size_t kMagazineSize = 8;
+
  private:
   // The base address of the memory region that's managed by this allocator.
   uint8_t* base_;
@@ -769,6 +775,27 @@ class RosAlloc {
   // Whether this allocator is running on a memory tool.
   bool is_running_on_memory_tool_;
 
+  // Per-thread cache of freed slots of the size brackets that use the shared current runs.
+  // Allocations and frees of these sizes are served from it without the size bracket lock and
+  // full magazines are returned to their runs under a single acquisition of the lock.
+  struct Magazines {
+    // The id_ of the allocator the cached slots belong to.
+    uint32_t owner_id;
+    uint8_t num_slots[kNumOfSizeBrackets - kNumThreadLocalSizeBrackets];
+    void* slots[kNumOfSizeBrackets - kNumThreadLocalSizeBrackets][kMagazineSize];
+  };
+
+  // Unique id of this allocator. Tells the magazines of other allocators apart, including ones
+  // of allocators that no longer exist.
+  const uint32_t id_;
+  // Whether individual frees of slots of the shared size brackets go to the thread's magazine.
+  bool use_magazines_;
+  // Number of allocations served from magazines, of magazines returned to their runs, and of
+  // size bracket lock acquisitions that had to wait for another thread.
+  std::atomic<uint64_t> magazine_allocs_;
+  std::atomic<uint64_t> magazine_flushes_;
+  std::atomic<uint64_t> bracket_lock_contentions_;
+
   // The base address of the memory region that's managed by this allocator.
   uint8_t* Begin() { return base_; }
   // The end address of the memory region that's managed by this allocator.
@@ -796,6 +823,26 @@ class RosAlloc {
   // Returns the bracket size.
   size_t FreeFromRun(Thread* self, void* ptr, Run* run)
       REQUIRES(!lock_);
+  // FreeFromRun() with the size bracket lock of the run already held.
+  size_t FreeFromRunLocked(Thread* self, void* ptr, Run* run)
+      REQUIRES(!lock_);
+
+  // Returns the run of the given slot, or null if it is a large object. The page map entries of
+  // allocated memory do not change, so this can be called without the lock.
+  Run* GetRunOfAllocatedSlot(void* ptr);
+
+  // Returns the magazines of the thread if they belong to this allocator, creating them if
+  // requested and they do not exist.
+  Magazines* GetMagazines(Thread* self, bool create);
+  // Pop a slot of the size bracket from the thread's magazine. Returns null if it is empty.
+  void* AllocFromMagazine(Thread* self, size_t idx);
+  // Cache a slot of a shared size bracket in the thread's magazine. Returns the bracket size, or 0
+  // if the slot must be freed as usual.
+  size_t FreeToMagazine(Thread* self, void* ptr)
+      REQUIRES_SHARED(bulk_free_lock_) REQUIRES(!lock_);
+  // Return the cached slots of a size bracket to their runs.
+  void FlushMagazine(Thread* self, Magazines* magazines, size_t idx)
+      REQUIRES_SHARED(bulk_free_lock_) REQUIRES(!lock_);
 
   // Used to allocate a new thread local run for a size bracket.
   Run* AllocRun(Thread* self, size_t idx) REQUIRES(!lock_);
@@ -887,8 +934,9 @@ class RosAlloc {
                   void* arg)
       REQUIRES(!lock_);
 
-  // Release empty pages.
-  size_t ReleasePages() REQUIRES(!lock_);
+  // Release empty pages, from the start of the space, until about `max_bytes` are released.
+  // Returns the number of bytes released.
+  size_t ReleasePages(size_t max_bytes = std::numeric_limits<size_t>::max()) REQUIRES(!lock_);
   // Returns the current footprint.
   size_t Footprint() REQUIRES(!lock_);
   // Returns the current capacity, maximum footprint.
@@ -896,7 +944,8 @@ class RosAlloc {
   // Update the current capacity.
   void SetFootprintLimit(size_t bytes) REQUIRES(!lock_);
 
-  // Releases the thread-local runs assigned to the given thread back to the common set of runs.
+  // Releases the thread-local runs assigned to the given thread back to the common set of runs,
+  // and returns the slots in its magazines to their runs.
   // Returns the total bytes of free slots in the revoked thread local runs. This is to be
   // subtracted from Heap::num_bytes_allocated_ to cancel out the ahead-of-time counting.
   size_t RevokeThreadLocalRuns(Thread* thread) REQUIRES(!lock_, !bulk_free_lock_);
@@ -904,6 +953,20 @@ class RosAlloc {
   // Returns the total bytes of free slots in the revoked thread local runs. This is to be
   // subtracted from Heap::num_bytes_allocated_ to cancel out the ahead-of-time counting.
   size_t RevokeAllThreadLocalRuns() REQUIRES(!Locks::thread_list_lock_, !lock_, !bulk_free_lock_);
+  // Enable the per-thread magazines. Only to be used for allocators whose thread-local runs are
+  // revoked for all threads before they are deleted or exit.
+  void EnableMagazines() {
+    use_magazines_ = !is_running_on_memory_tool_;
+  }
+  uint64_t GetMagazineAllocCount() const {
+    return magazine_allocs_.load(std::memory_order_relaxed);
+  }
+  uint64_t GetMagazineFlushCount() const {
+    return magazine_flushes_.load(std::memory_order_relaxed);
+  }
+  uint64_t GetBracketLockContentionCount() const {
+    return bracket_lock_contentions_.load(std::memory_order_relaxed);
+  }
   // Assert the thread local runs of a thread are revoked.
   void AssertThreadLocalRunsAreRevoked(Thread* thread) REQUIRES(!bulk_free_lock_);
   // Assert all the thread local runs are revoked.
@@ -203,6 +203,8 @@ inline mirror::Object* ConcurrentCopying::MarkFromReadBarrier(mirror::Object* fr
   if (from_ref == nullptr || !self->GetIsGcMarking()) {
     return from_ref;
   }
+  // A plain thread-local increment, cheap enough to keep on in production.
+  self->IncrementReadBarrierSlowPathCount();
   // TODO: Consider removing this check when we are done investigating slow paths. b/30162165
   if (UNLIKELY(mark_from_read_barrier_measurements_)) {
     ret = MarkFromReadBarrierWithMeasurements(self, from_ref);
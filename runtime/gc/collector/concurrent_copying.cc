@@ -102,6 +102,7 @@ ConcurrentCopying::ConcurrentCopying(Heap* heap,
       gc_count_(0),
       reclaimed_bytes_ratio_sum_(0.f),
       cumulative_bytes_moved_(0),
+      cumulative_evacuation_freed_bytes_(0),
       skipped_blocks_lock_("concurrent copying bytes blocks lock", kMarkSweepMarkStackLock),
       measure_read_barrier_slow_path_(measure_read_barrier_slow_path),
       mark_from_read_barrier_measurements_(false),
@@ -112,6 +113,7 @@ ConcurrentCopying::ConcurrentCopying(Heap* heap,
       rb_slow_path_time_histogram_("Mutator time in read barrier slow path", 500, 32),
       rb_slow_path_count_total_(0),
       rb_slow_path_count_gc_total_(0),
+      rb_slow_path_count_mutators_total_(0),
       rb_table_(heap_->GetReadBarrierTable()),
       force_evacuate_all_(false),
       gc_grays_immune_objects_(false),
@@ -130,14 +132,11 @@ ConcurrentCopying::ConcurrentCopying(Heap* heap,
     // (class_linker_lock_ and heap_bitmap_lock_).
     heap_mark_bitmap_ = heap->GetMarkBitmap();
   }
-  {
-    MutexLock mu(self, mark_stack_lock_);
-    for (size_t i = 0; i < kMarkStackPoolSize; ++i) {
-      accounting::AtomicStack<mirror::Object>* mark_stack =
-          accounting::AtomicStack<mirror::Object>::Create(
-              "thread local mark stack", GetMarkStackSize(), GetMarkStackSize());
-      pooled_mark_stacks_.push_back(mark_stack);
-    }
+  for (size_t i = 0; i < kMarkStackPoolSize; ++i) {
+    accounting::AtomicStack<mirror::Object>* mark_stack =
+        accounting::AtomicStack<mirror::Object>::Create(
+            "thread local mark stack", GetMarkStackSize(), GetMarkStackSize());
+    pooled_mark_stacks_.Push(mark_stack);
   }
   if (use_generational_cc_) {
     // Allocate sweep array free buffer.
@@ -219,7 +218,7 @@ void ConcurrentCopying::MarkHeapReference(mirror::HeapReference<mirror::Object>*
 }
 
 ConcurrentCopying::~ConcurrentCopying() {
-  STLDeleteElements(&pooled_mark_stacks_);
+  pooled_mark_stacks_.PopAll([](accounting::ObjectStack* mark_stack) { delete mark_stack; });
 }
 
 void ConcurrentCopying::RunPhases() {
@@ -480,6 +479,7 @@ class ConcurrentCopying::ThreadFlipVisitor : public Closure, public RootVisitor
   }
 
   void Run(Thread* thread) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    ScopedTrace trace("Thread flip");
     // We are either running this in the target thread, or the target thread will wait for us
     // before switching back to runnable.
     Thread* self = Thread::Current();
@@ -990,7 +990,7 @@ class ConcurrentCopying::RevokeThreadLocalMarkStackCheckpoint : public Closure {
       MutexLock mu(self, concurrent_copying_->mark_stack_lock_);
       accounting::AtomicStack<mirror::Object>* tl_mark_stack = thread->GetThreadLocalMarkStack();
       if (tl_mark_stack != nullptr) {
-        concurrent_copying_->revoked_mark_stacks_.push_back(tl_mark_stack);
+        concurrent_copying_->revoked_mark_stacks_.Push(tl_mark_stack);
         thread->SetThreadLocalMarkStack(nullptr);
       }
     }
@@ -1025,8 +1025,11 @@ class ConcurrentCopying::CaptureThreadRootsForMarkingAndCheckpoint :
     CaptureRootsForMarkingVisitor</*kAtomicTestAndSet*/ true> visitor(concurrent_copying_, self);
     thread->VisitRoots(&visitor, kVisitRootFlagAllRoots);
     // If thread_running_gc_ performed the root visit then its thread-local
-    // mark-stack should be null as we directly push to gc_mark_stack_.
-    CHECK(self == thread || self->GetThreadLocalMarkStack() == nullptr);
+    // mark-stack should be null as we directly push to gc_mark_stack_. A heap
+    // thread pool worker visiting the roots of a suspended thread pushes to its
+    // own thread-local mark-stack, which is revoked like the mutators' ones.
+    CHECK(self == thread || self != concurrent_copying_->thread_running_gc_ ||
+          self->GetThreadLocalMarkStack() == nullptr);
     // Barrier handling is done in the base class' Run() below.
     RevokeThreadLocalMarkStackCheckpoint::Run(thread);
   }
@@ -1042,7 +1045,10 @@ void ConcurrentCopying::CaptureThreadRootsForMarking() {
   CaptureThreadRootsForMarkingAndCheckpoint check_point(this);
   ThreadList* thread_list = Runtime::Current()->GetThreadList();
   gc_barrier_->Init(self, 0);
-  size_t barrier_count = thread_list->RunCheckpoint(&check_point, /* callback */ nullptr);
+  size_t barrier_count = thread_list->RunCheckpoint(&check_point,
+                                                    /* callback= */ nullptr,
+                                                    /* allow_lock_checking= */ true,
+                                                    heap_->GetThreadPool());
   // If there are no threads to wait which implys that all the checkpoint functions are finished,
   // then no need to release the mutator lock.
   if (barrier_count == 0) {
@@ -1283,8 +1289,8 @@ void ConcurrentCopying::ProcessMarkStackForMarkingAndComputeLiveBytes() {
                                });
   {
     MutexLock mu(thread_running_gc_, mark_stack_lock_);
-    CHECK(revoked_mark_stacks_.empty());
-    CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
+    CHECK(revoked_mark_stacks_.IsEmpty());
+    CHECK_EQ(pooled_mark_stacks_.Size(), kMarkStackPoolSize);
   }
 
   while (!gc_mark_stack_->IsEmpty()) {
@@ -1848,14 +1854,10 @@ void ConcurrentCopying::PushOntoMarkStack(Thread* const self, mirror::Object* to
       // Otherwise, use a thread-local mark stack.
       accounting::AtomicStack<mirror::Object>* tl_mark_stack = self->GetThreadLocalMarkStack();
       if (UNLIKELY(tl_mark_stack == nullptr || tl_mark_stack->IsFull())) {
-        MutexLock mu(self, mark_stack_lock_);
-        // Get a new thread local mark stack.
-        accounting::AtomicStack<mirror::Object>* new_tl_mark_stack;
-        if (!pooled_mark_stacks_.empty()) {
-          // Use a pooled mark stack.
-          new_tl_mark_stack = pooled_mark_stacks_.back();
-          pooled_mark_stacks_.pop_back();
-        } else {
+        // Get a new thread local mark stack. Only checkpoints, which do not run concurrently
+        // with this, revoke the stack of a runnable thread, so no lock is needed.
+        accounting::AtomicStack<mirror::Object>* new_tl_mark_stack = pooled_mark_stacks_.Pop();
+        if (new_tl_mark_stack == nullptr) {
           // None pooled. Create a new one.
           new_tl_mark_stack =
               accounting::AtomicStack<mirror::Object>::Create(
@@ -1866,8 +1868,8 @@ void ConcurrentCopying::PushOntoMarkStack(Thread* const self, mirror::Object* to
         new_tl_mark_stack->PushBack(to_ref);
         self->SetThreadLocalMarkStack(new_tl_mark_stack);
         if (tl_mark_stack != nullptr) {
-          // Store the old full stack into a vector.
-          revoked_mark_stacks_.push_back(tl_mark_stack);
+          // Hand the old full stack to the GC thread.
+          revoked_mark_stacks_.Push(tl_mark_stack);
         }
       } else {
         tl_mark_stack->PushBack(to_ref);
@@ -2112,7 +2114,7 @@ void ConcurrentCopying::RevokeThreadLocalMarkStack(Thread* thread) {
   accounting::AtomicStack<mirror::Object>* tl_mark_stack = thread->GetThreadLocalMarkStack();
   if (tl_mark_stack != nullptr) {
     CHECK(is_marking_);
-    revoked_mark_stacks_.push_back(tl_mark_stack);
+    revoked_mark_stacks_.Push(tl_mark_stack);
     thread->SetThreadLocalMarkStack(nullptr);
   }
 }
@@ -2161,8 +2163,8 @@ bool ConcurrentCopying::ProcessMarkStackOnce() {
     // Process the shared GC mark stack with a lock.
     {
       MutexLock mu(thread_running_gc_, mark_stack_lock_);
-      CHECK(revoked_mark_stacks_.empty());
-      CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
+      CHECK(revoked_mark_stacks_.IsEmpty());
+      CHECK_EQ(pooled_mark_stacks_.Size(), kMarkStackPoolSize);
     }
     while (true) {
       std::vector<mirror::Object*> refs;
@@ -2188,8 +2190,8 @@ bool ConcurrentCopying::ProcessMarkStackOnce() {
              static_cast<uint32_t>(kMarkStackModeGcExclusive));
     {
       MutexLock mu(thread_running_gc_, mark_stack_lock_);
-      CHECK(revoked_mark_stacks_.empty());
-      CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
+      CHECK(revoked_mark_stacks_.IsEmpty());
+      CHECK_EQ(pooled_mark_stacks_.Size(), kMarkStackPoolSize);
     }
     // Process the GC mark stack in the exclusive mode. No need to take the lock.
     while (!gc_mark_stack_->IsEmpty()) {
@@ -2215,35 +2217,24 @@ size_t ConcurrentCopying::ProcessThreadLocalMarkStacks(bool disable_weak_ref_acc
              static_cast<uint32_t>(kMarkStackModeShared));
   }
   size_t count = 0;
-  std::vector<accounting::AtomicStack<mirror::Object>*> mark_stacks;
-  {
-    MutexLock mu(thread_running_gc_, mark_stack_lock_);
-    // Make a copy of the mark stack vector.
-    mark_stacks = revoked_mark_stacks_;
-    revoked_mark_stacks_.clear();
-  }
-  for (accounting::AtomicStack<mirror::Object>* mark_stack : mark_stacks) {
+  revoked_mark_stacks_.PopAll([&](accounting::AtomicStack<mirror::Object>* mark_stack) {
     for (StackReference<mirror::Object>* p = mark_stack->Begin(); p != mark_stack->End(); ++p) {
       mirror::Object* to_ref = p->AsMirrorPtr();
       processor(to_ref);
       ++count;
     }
-    {
-      MutexLock mu(thread_running_gc_, mark_stack_lock_);
-      if (pooled_mark_stacks_.size() >= kMarkStackPoolSize) {
-        // The pool has enough. Delete it.
-        delete mark_stack;
-      } else {
-        // Otherwise, put it into the pool for later reuse.
-        mark_stack->Reset();
-        pooled_mark_stacks_.push_back(mark_stack);
-      }
+    if (pooled_mark_stacks_.Size() >= kMarkStackPoolSize) {
+      // The pool has enough. Delete it.
+      delete mark_stack;
+    } else {
+      // Otherwise, put it into the pool for later reuse.
+      mark_stack->Reset();
+      pooled_mark_stacks_.Push(mark_stack);
     }
-  }
+  });
   if (disable_weak_ref_access) {
-    MutexLock mu(thread_running_gc_, mark_stack_lock_);
-    CHECK(revoked_mark_stacks_.empty());
-    CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
+    CHECK(revoked_mark_stacks_.IsEmpty());
+    CHECK_EQ(pooled_mark_stacks_.Size(), kMarkStackPoolSize);
   }
   return count;
 }
@@ -2460,9 +2451,9 @@ void ConcurrentCopying::CheckEmptyMarkStack() {
   if (mark_stack_mode == kMarkStackModeThreadLocal) {
     // Thread-local mark stack mode.
     RevokeThreadLocalMarkStacks(false, nullptr);
-    MutexLock mu(thread_running_gc_, mark_stack_lock_);
-    if (!revoked_mark_stacks_.empty()) {
-      for (accounting::AtomicStack<mirror::Object>* mark_stack : revoked_mark_stacks_) {
+    if (!revoked_mark_stacks_.IsEmpty()) {
+      revoked_mark_stacks_.PopAll([&](accounting::AtomicStack<mirror::Object>* mark_stack)
+                                      REQUIRES_SHARED(Locks::mutator_lock_) {
         while (!mark_stack->IsEmpty()) {
           mirror::Object* obj = mark_stack->PopBack();
           if (kUseBakerReadBarrier) {
@@ -2474,15 +2465,15 @@ void ConcurrentCopying::CheckEmptyMarkStack() {
                       << " is_marked=" << IsMarked(obj);
           }
         }
-      }
+      });
       LOG(FATAL) << "mark stack is not empty";
     }
   } else {
     // Shared, GC-exclusive, or off.
     MutexLock mu(thread_running_gc_, mark_stack_lock_);
     CHECK(gc_mark_stack_->IsEmpty());
-    CHECK(revoked_mark_stacks_.empty());
-    CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
+    CHECK(revoked_mark_stacks_.IsEmpty());
+    CHECK_EQ(pooled_mark_stacks_.Size(), kMarkStackPoolSize);
   }
 }
 
@@ -2771,6 +2762,7 @@ void ConcurrentCopying::ReclaimPhase() {
     const uint64_t unevac_from_bytes = region_space_->GetBytesAllocatedInUnevacFromSpace();
     uint64_t to_bytes = bytes_moved_.load(std::memory_order_relaxed) + bytes_moved_gc_thread_;
     cumulative_bytes_moved_ += to_bytes;
+    GetCurrentIteration()->SetCopiedBytes(to_bytes);
     uint64_t to_objects = objects_moved_.load(std::memory_order_relaxed) + objects_moved_gc_thread_;
     if (kEnableFromSpaceAccountingCheck) {
       CHECK_EQ(from_space_num_bytes_at_first_pause_, from_bytes + unevac_from_bytes);
@@ -2781,6 +2773,12 @@ void ConcurrentCopying::ReclaimPhase() {
       copied_live_bytes_ratio_sum_ += static_cast<float>(to_bytes) / from_bytes;
       gc_count_++;
     }
+    // The bytes copied out of the evacuated regions, versus the bytes of these regions freed.
+    const uint64_t evacuation_freed_bytes = from_bytes - std::min(to_bytes, from_bytes);
+    cumulative_evacuation_freed_bytes_ += evacuation_freed_bytes;
+    metrics::ArtMetrics* metrics = GetMetrics();
+    metrics->GcEvacuatedBytes()->Add(to_bytes);
+    metrics->GcEvacuationFreedBytes()->Add(evacuation_freed_bytes);
 
     // Cleared bytes and objects, populated by the call to RegionSpace::ClearFromSpace below.
     uint64_t cleared_bytes;
@@ -2791,7 +2789,8 @@ void ConcurrentCopying::ReclaimPhase() {
       region_space_->ClearFromSpace(&cleared_bytes,
                                     &cleared_objects,
                                     /*clear_bitmap*/ !young_gen_,
-                                    should_eagerly_release_memory);
+                                    should_eagerly_release_memory,
+                                    GetCurrentIteration()->GetObjectAges());
       // `cleared_bytes` may be greater than the from space equivalents since
       // RegionSpace::ClearFromSpace may clear empty unevac regions.
       CHECK_GE(cleared_bytes, from_bytes);
@@ -3590,6 +3589,8 @@ mirror::Object* ConcurrentCopying::Copy(Thread* const self,
         bytes_moved_.fetch_add(bytes_allocated, std::memory_order_relaxed);
       }
 
+      region_space_->AddEvacuatedBytes(from_ref, region_space_alloc_size);
+
       if (LIKELY(!fall_back_to_non_moving)) {
         DCHECK(region_space_->IsInToSpace(to_ref));
       } else {
@@ -3759,8 +3760,8 @@ void ConcurrentCopying::FinishPhase() {
   Thread* const self = Thread::Current();
   {
     MutexLock mu(self, mark_stack_lock_);
-    CHECK(revoked_mark_stacks_.empty());
-    CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
+    CHECK(revoked_mark_stacks_.IsEmpty());
+    CHECK_EQ(pooled_mark_stacks_.Size(), kMarkStackPoolSize);
   }
   bool should_eagerly_release_memory = ShouldEagerlyReleaseMemoryToOS();
   // kVerifyNoMissingCardMarks relies on the region space cards not being cleared to avoid false
@@ -3817,6 +3818,32 @@ void ConcurrentCopying::FinishPhase() {
     rb_slow_path_count_total_ += rb_slow_path_count_.load(std::memory_order_relaxed);
     rb_slow_path_count_gc_total_ += rb_slow_path_count_gc_.load(std::memory_order_relaxed);
   }
+  ReportReadBarrierSlowPathCounts(self);
+}
+
+void ConcurrentCopying::ReportReadBarrierSlowPathCounts(Thread* self) {
+  // Marking has been disabled on all threads, so the per-thread counters are no longer updated.
+  uint64_t mutator_count = 0u;
+  size_t max_thread_count = 0u;
+  pid_t max_thread_tid = 0;
+  {
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    for (Thread* thread : Runtime::Current()->GetThreadList()->GetList()) {
+      size_t count = thread->GetAndResetReadBarrierSlowPathCount();
+      if (thread == thread_running_gc_) {
+        continue;
+      }
+      mutator_count += count;
+      if (count > max_thread_count) {
+        max_thread_count = count;
+        max_thread_tid = thread->GetTid();
+      }
+    }
+  }
+  rb_slow_path_count_mutators_total_ += mutator_count;
+  GetMetrics()->ReadBarrierSlowPathCount()->Add(mutator_count);
+  VLOG(heap) << "Mutator read barrier slow paths: " << mutator_count
+             << ", most on tid " << max_thread_tid << ": " << max_thread_count;
 }
 
 bool ConcurrentCopying::IsNullOrMarkedHeapReference(mirror::HeapReference<mirror::Object>* field,
@@ -3898,6 +3925,9 @@ void ConcurrentCopying::DumpPerformanceInfo(std::ostream& os) {
   if (rb_slow_path_count_gc_total_ > 0) {
     os << "GC slow path count " << rb_slow_path_count_gc_total_ << "\n";
   }
+  if (rb_slow_path_count_mutators_total_ > 0) {
+    os << "Mutator read barrier slow path count " << rb_slow_path_count_mutators_total_ << "\n";
+  }
 
   os << "Average " << (young_gen_ ? "minor" : "major") << " GC reclaim bytes ratio "
      << (reclaimed_bytes_ratio_sum_ / num_gc_cycles) << " over " << num_gc_cycles
@@ -3908,6 +3938,7 @@ void ConcurrentCopying::DumpPerformanceInfo(std::ostream& os) {
      << " " << (young_gen_ ? "minor" : "major") << " GCs\n";
 
   os << "Cumulative bytes moved " << cumulative_bytes_moved_ << "\n";
+  os << "Cumulative bytes freed by evacuation " << cumulative_evacuation_freed_bytes_ << "\n";
 
   os << "Peak regions allocated "
      << region_space_->GetMaxPeakNumNonFreeRegions() << " ("
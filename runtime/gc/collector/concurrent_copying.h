@@ -90,6 +90,8 @@ class ConcurrentCopying : public GarbageCollector {
   void FinishPhase() REQUIRES(!mark_stack_lock_,
                               !rb_slow_path_histogram_lock_,
                               !skipped_blocks_lock_);
+  // Sums and resets the per-thread read-barrier slow-path counters of the cycle that just ended.
+  void ReportReadBarrierSlowPathCounts(Thread* self) REQUIRES(!Locks::thread_list_lock_);
 
   void CaptureRssAtPeak() REQUIRES(!mark_stack_lock_);
   void BindBitmaps() REQUIRES_SHARED(Locks::mutator_lock_)
@@ -367,20 +369,20 @@ class ConcurrentCopying : public GarbageCollector {
   // (see use case in ConcurrentCopying::MarkFromReadBarrier).
   bool rb_mark_bit_stack_full_;
 
-  // Guards access to pooled_mark_stacks_ and revoked_mark_stacks_ vectors.
-  // Also guards destruction and revocations of thread-local mark-stacks.
+  // Guards destruction and revocations of thread-local mark-stacks.
   // Clearing thread-local mark-stack (by other threads or during destruction)
-  // should be guarded by it.
+  // should be guarded by it. Mutators replace their full thread-local mark
+  // stacks without it, through the lock-free lists below.
   Mutex mark_stack_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
-  std::vector<accounting::ObjectStack*> revoked_mark_stacks_
-      GUARDED_BY(mark_stack_lock_);
+  // Full or revoked thread-local mark stacks, to be processed by the GC thread.
+  accounting::AtomicStackChunkList<mirror::Object> revoked_mark_stacks_;
   // Size of thread local mark stack.
   static size_t GetMarkStackSize() {
     return gPageSize;
   }
   static constexpr size_t kMarkStackPoolSize = 256;
-  std::vector<accounting::ObjectStack*> pooled_mark_stacks_
-      GUARDED_BY(mark_stack_lock_);
+  // Empty thread-local mark stacks.
+  accounting::AtomicStackChunkList<mirror::Object> pooled_mark_stacks_;
   Thread* thread_running_gc_;
   bool is_marking_;                       // True while marking is ongoing.
   // True while we might dispatch on the read barrier entrypoints.
@@ -445,6 +447,8 @@ class ConcurrentCopying : public GarbageCollector {
   size_t objects_moved_gc_thread_;
   uint64_t bytes_scanned_;
   uint64_t cumulative_bytes_moved_;
+  // The bytes of evacuated regions that were not copied out of them.
+  uint64_t cumulative_evacuation_freed_bytes_;
 
   // The skipped blocks are memory blocks/chucks that were copies of
   // objects that were unused due to lost races (cas failures) at
@@ -471,6 +475,9 @@ class ConcurrentCopying : public GarbageCollector {
   Histogram<uint64_t> rb_slow_path_time_histogram_ GUARDED_BY(rb_slow_path_histogram_lock_);
   uint64_t rb_slow_path_count_total_ GUARDED_BY(rb_slow_path_histogram_lock_);
   uint64_t rb_slow_path_count_gc_total_ GUARDED_BY(rb_slow_path_histogram_lock_);
+  // Read-barrier slow paths taken by mutators, counted per thread on every cycle regardless of
+  // measure_read_barrier_slow_path_. Only accessed by the GC thread.
+  uint64_t rb_slow_path_count_mutators_total_;
 
   accounting::ReadBarrierTable* rb_table_;
   bool force_evacuate_all_;  // True if all regions are evacuated.
@@ -96,11 +96,13 @@ void Iteration::Reset(GcCause gc_cause, bool clear_soft_references) {
   pause_times_.clear();
   duration_ns_ = 0;
   bytes_scanned_ = 0;
+  bytes_copied_ = 0;
   clear_soft_references_ = clear_soft_references;
   gc_cause_ = gc_cause;
   freed_ = ObjectBytePair();
   freed_los_ = ObjectBytePair();
   freed_bytes_revoke_ = 0;
+  object_ages_ = ObjectAges();
 }
 
 uint64_t Iteration::GetEstimatedThroughput() const {
@@ -213,6 +215,7 @@ void GarbageCollector::Run(GcCause gc_cause, bool clear_soft_references) {
   int64_t freed_bytes = current_iteration->GetFreedBytes() +
       current_iteration->GetFreedLargeObjectBytes();
   total_freed_bytes_ += freed_bytes;
+  total_object_ages_.Add(current_iteration->GetObjectAges());
   // Rounding negative freed bytes to 0 as we are not interested in such corner cases.
   freed_bytes_histogram_.AddValue(std::max<int64_t>(freed_bytes / KB, 0));
   uint64_t end_time = NanoTime();
@@ -244,6 +247,16 @@ void GarbageCollector::Run(GcCause gc_cause, bool clear_soft_references) {
   // Report total collection time of all GCs put together.
   metrics->TotalGcCollectionTime()->Add(NsToMs(duration_ns));
   metrics->TotalGcCollectionTimeDelta()->Add(NsToMs(duration_ns));
+  // Report the survival rates of the bytes allocated since the last GC, and of the older ones.
+  const ObjectAges& object_ages = current_iteration->GetObjectAges();
+  const int64_t new_survival_percent = object_ages.GetSurvivalPercent(0, 1);
+  if (new_survival_percent >= 0) {
+    metrics->GcNewObjectSurvivalRate()->Add(new_survival_percent);
+  }
+  const int64_t old_survival_percent = object_ages.GetSurvivalPercent(1, ObjectAges::kNumAges);
+  if (old_survival_percent >= 0) {
+    metrics->GcOldObjectSurvivalRate()->Add(old_survival_percent);
+  }
   if (are_metrics_initialized_) {
     metrics_gc_count_->Add(1);
     metrics_gc_count_delta_->Add(1);
@@ -274,6 +287,8 @@ void GarbageCollector::Run(GcCause gc_cause, bool clear_soft_references) {
   TraceGCMetric("freed_normal_object_bytes", current_iteration->GetFreedBytes());
   TraceGCMetric("freed_large_object_bytes", current_iteration->GetFreedLargeObjectBytes());
   TraceGCMetric("freed_bytes", freed_bytes);
+  TraceGCMetric("scanned_bytes", current_iteration->GetScannedBytes());
+  TraceGCMetric("copied_bytes", current_iteration->GetCopiedBytes());
 
   is_transaction_active_ = false;
 }
@@ -318,6 +333,7 @@ void GarbageCollector::ResetMeasurements() {
   total_freed_objects_ = 0u;
   total_freed_bytes_ = 0;
   total_scanned_bytes_ = 0u;
+  total_object_ages_ = ObjectAges();
 }
 
 GarbageCollector::ScopedPause::ScopedPause(GarbageCollector* collector, bool with_reporting)
@@ -434,6 +450,18 @@ void GarbageCollector::DumpPerformanceInfo(std::ostream& os) {
      << PrettySize(scanned_bytes / seconds) << "/s "
      << " per cpu-time: "
      << PrettySize(scanned_bytes / cpu_seconds) << "/s\n";
+  if (total_object_ages_.GetSurvivalPercent(0, ObjectAges::kNumAges) >= 0) {
+    os << GetName() << " survival rate by age:";
+    for (size_t age = 0; age < ObjectAges::kNumAges; ++age) {
+      if (total_object_ages_.bytes[age] == 0) {
+        continue;
+      }
+      os << " " << age << (age + 1 == ObjectAges::kNumAges ? "+" : "") << ": "
+         << total_object_ages_.GetSurvivalPercent(age, age + 1) << "% of "
+         << PrettySize(total_object_ages_.bytes[age]);
+    }
+    os << "\n";
+  }
 }
 
 }  // namespace collector
@@ -180,6 +180,7 @@ class GarbageCollector : public RootVisitor, public IsMarkedVisitor, public Mark
   uint64_t total_freed_objects_;
   int64_t total_freed_bytes_;
   uint64_t total_scanned_bytes_;
+  ObjectAges total_object_ages_;
   CumulativeLogger cumulative_timings_;
   mutable Mutex pause_histogram_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   bool is_transaction_active_;
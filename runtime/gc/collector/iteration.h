@@ -24,6 +24,7 @@
 #include "base/macros.h"
 #include "base/timing_logger.h"
 #include "gc/gc_cause.h"
+#include "object_ages.h"
 #include "object_byte_pair.h"
 
 namespace art HIDDEN {
@@ -67,6 +68,13 @@ class Iteration {
   void SetScannedBytes(uint64_t bytes) {
       bytes_scanned_ = bytes;
   }
+  // Bytes of live objects the collector moved, for moving collectors.
+  uint64_t GetCopiedBytes() const {
+    return bytes_copied_;
+  }
+  void SetCopiedBytes(uint64_t bytes) {
+    bytes_copied_ = bytes;
+  }
   void SetFreedRevoke(uint64_t freed) {
     freed_bytes_revoke_ = freed;
   }
@@ -82,6 +90,13 @@ class Iteration {
   GcCause GetGcCause() const {
     return gc_cause_;
   }
+  // Returns the ages of the bytes the collector recorded, if it tracks them.
+  ObjectAges* GetObjectAges() {
+    return &object_ages_;
+  }
+  const ObjectAges& GetObjectAges() const {
+    return object_ages_;
+  }
 
  private:
   void SetDurationNs(uint64_t duration) {
@@ -92,11 +107,13 @@ class Iteration {
   bool clear_soft_references_;
   uint64_t duration_ns_;
   uint64_t bytes_scanned_;
+  uint64_t bytes_copied_;
   TimingLogger timings_;
   ObjectBytePair freed_;
   ObjectBytePair freed_los_;
   uint64_t freed_bytes_revoke_;  // see Heap::num_bytes_freed_revoke_.
   std::vector<uint64_t> pause_times_;
+  ObjectAges object_ages_;
 
   friend class GarbageCollector;
   DISALLOW_COPY_AND_ASSIGN(Iteration);
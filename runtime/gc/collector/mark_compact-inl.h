@@ -20,52 +20,66 @@
 #include "gc/space/bump_pointer_space.h"
 #include "mark_compact.h"
 #include "mirror/object-inl.h"
+#include "thread-current-inl.h"
 
 namespace art HIDDEN {
 namespace gc {
 namespace collector {
 
+template <bool kParallel>
 inline void MarkCompact::UpdateClassAfterObjectMap(mirror::Object* obj) {
   mirror::Class* klass = obj->GetClass<kVerifyNone, kWithoutReadBarrier>();
   // Track a class if it needs walking super-classes for visiting references or
   // if it's higher in address order than its objects and is in moving space.
   if (UNLIKELY(
           (std::less<mirror::Object*>{}(obj, klass) && HasAddress(klass)) ||
-          (klass->GetReferenceInstanceOffsets<kVerifyNone>() == mirror::Class::kClassWalkSuper &&
-           walk_super_class_cache_ != klass))) {
-    // Since this function gets invoked in the compaction pause as well, it is
-    // preferable to store such super class separately rather than updating key
-    // as the latter would require traversing the hierarchy for every object of 'klass'.
-    auto ret1 = class_after_obj_hash_map_.try_emplace(ObjReference::FromMirrorPtr(klass),
-                                                      ObjReference::FromMirrorPtr(obj));
-    if (ret1.second) {
-      if (klass->GetReferenceInstanceOffsets<kVerifyNone>() == mirror::Class::kClassWalkSuper) {
-        // In this case we require traversing through the super class hierarchy
-        // and find the super class at the highest address order.
-        mirror::Class* highest_klass = HasAddress(klass) ? klass : nullptr;
-        for (ObjPtr<mirror::Class> k = klass->GetSuperClass<kVerifyNone, kWithoutReadBarrier>();
-             k != nullptr;
-             k = k->GetSuperClass<kVerifyNone, kWithoutReadBarrier>()) {
-          // TODO: Can we break once we encounter a super class outside the moving space?
-          if (HasAddress(k.Ptr())) {
-            highest_klass = std::max(highest_klass, k.Ptr(), std::less<mirror::Class*>());
-          }
-        }
-        if (highest_klass != nullptr && highest_klass != klass) {
-          auto ret2 = super_class_after_class_hash_map_.try_emplace(
-              ObjReference::FromMirrorPtr(klass), ObjReference::FromMirrorPtr(highest_klass));
-          DCHECK(ret2.second);
-        } else {
-          walk_super_class_cache_ = klass;
+          klass->GetReferenceInstanceOffsets<kVerifyNone>() == mirror::Class::kClassWalkSuper)) {
+    if (kParallel) {
+      MutexLock mu(Thread::Current(), class_after_obj_lock_);
+      AddClassAfterObjectMapEntry(obj, klass);
+    } else {
+      AddClassAfterObjectMapEntry(obj, klass);
+    }
+  }
+}
+
+inline void MarkCompact::AddClassAfterObjectMapEntry(mirror::Object* obj, mirror::Class* klass) {
+  if (walk_super_class_cache_ == klass &&
+      !(std::less<mirror::Object*>{}(obj, klass) && HasAddress(klass))) {
+    return;
+  }
+  // Since this function gets invoked in the compaction pause as well, it is
+  // preferable to store such super class separately rather than updating key
+  // as the latter would require traversing the hierarchy for every object of 'klass'.
+  auto ret1 = class_after_obj_hash_map_.try_emplace(ObjReference::FromMirrorPtr(klass),
+                                                    ObjReference::FromMirrorPtr(obj));
+  if (ret1.second) {
+    if (klass->GetReferenceInstanceOffsets<kVerifyNone>() == mirror::Class::kClassWalkSuper) {
+      // In this case we require traversing through the super class hierarchy
+      // and find the super class at the highest address order.
+      mirror::Class* highest_klass = HasAddress(klass) ? klass : nullptr;
+      for (ObjPtr<mirror::Class> k = klass->GetSuperClass<kVerifyNone, kWithoutReadBarrier>();
+           k != nullptr;
+           k = k->GetSuperClass<kVerifyNone, kWithoutReadBarrier>()) {
+        // TODO: Can we break once we encounter a super class outside the moving space?
+        if (HasAddress(k.Ptr())) {
+          highest_klass = std::max(highest_klass, k.Ptr(), std::less<mirror::Class*>());
         }
       }
-    } else if (std::less<mirror::Object*>{}(obj, ret1.first->second.AsMirrorPtr())) {
-      ret1.first->second = ObjReference::FromMirrorPtr(obj);
+      if (highest_klass != nullptr && highest_klass != klass) {
+        auto ret2 = super_class_after_class_hash_map_.try_emplace(
+            ObjReference::FromMirrorPtr(klass), ObjReference::FromMirrorPtr(highest_klass));
+        DCHECK(ret2.second);
+      } else {
+        walk_super_class_cache_ = klass;
+      }
     }
+  } else if (std::less<mirror::Object*>{}(obj, ret1.first->second.AsMirrorPtr())) {
+    ret1.first->second = ObjReference::FromMirrorPtr(obj);
   }
 }
 
-template <size_t kAlignment>
+template <size_t kAlignment> template <bool kParallel>
 inline uintptr_t MarkCompact::LiveWordsBitmap<kAlignment>::SetLiveWords(uintptr_t begin,
                                                                         size_t size) {
   const uintptr_t begin_bit_idx = MemRangeBitmap::BitIndexFromAddr(begin);
@@ -80,7 +94,12 @@ inline uintptr_t MarkCompact::LiveWordsBitmap<kAlignment>::SetLiveWords(uintptr_
   // Bits that needs to be set in the first word, if it's not also the last word
   mask = ~(mask - 1);
   if (diff > 0) {
-    *begin_bm_address |= mask;
+    if (kParallel) {
+      reinterpret_cast<Atomic<uintptr_t>*>(begin_bm_address)->fetch_or(mask,
+                                                                       std::memory_order_relaxed);
+    } else {
+      *begin_bm_address |= mask;
+    }
     mask = ~0;
     // Even though memset can handle the (diff == 1) case but we should avoid the
     // overhead of a function call for this, highly likely (as most of the objects
@@ -91,7 +110,14 @@ inline uintptr_t MarkCompact::LiveWordsBitmap<kAlignment>::SetLiveWords(uintptr_
     }
   }
   uintptr_t end_mask = Bitmap::BitIndexToMask(end_bit_idx);
-  *end_bm_address |= mask & (end_mask | (end_mask - 1));
+  if (kParallel) {
+    // Intermediate words are covered entirely by this object, so they can't
+    // be shared with another thread. Only the first and last words can be.
+    reinterpret_cast<Atomic<uintptr_t>*>(end_bm_address)->fetch_or(
+        mask & (end_mask | (end_mask - 1)), std::memory_order_relaxed);
+  } else {
+    *end_bm_address |= mask & (end_mask | (end_mask - 1));
+  }
   return begin_bit_idx;
 }
 
@@ -177,6 +203,16 @@ inline void MarkCompact::LiveWordsBitmap<kAlignment>::VisitLiveStrides(uintptr_t
       num_heap_words = std::min(stride_size, num_heap_words);
       break;
     }
+    if (stride_size == 0) {
+      // Outside of a stride, skip the runs of dead words before the end word a block at a time.
+      constexpr size_t kWordsPerBlock = kZeroBlockSize / sizeof(uintptr_t);
+      while (IsAligned<kWordsPerBlock>(begin_word_idx) &&
+             begin_word_idx + kWordsPerBlock <= end_word_idx &&
+             IsZeroBlock(&Bitmap::Begin()[begin_word_idx])) {
+        begin_word_idx += kWordsPerBlock;
+        begin_bit_idx += kWordsPerBlock * Bitmap::kBitsPerBitmapWord;
+      }
+    }
     word = Bitmap::Begin()[begin_word_idx];
   } while (true);
 
@@ -43,6 +43,7 @@
 #include "base/memfd.h"
 #include "base/quasi_atomic.h"
 #include "base/systrace.h"
+#include "base/time_utils.h"
 #include "base/utils.h"
 #include "gc/accounting/mod_union_table-inl.h"
 #include "gc/collector_type.h"
@@ -331,6 +332,8 @@ static constexpr bool kCheckLocks = kDebugLocking;
 static constexpr bool kVerifyRootsMarked = kIsDebugBuild;
 // Two threads should suffice on devices.
 static constexpr size_t kMaxNumUffdWorkers = 2;
+// Minimum number of entries in the mark stack for marking it in parallel.
+static constexpr size_t kMinimumParallelMarkStackSize = 128;
 // Number of compaction buffers reserved for mutator threads in SIGBUS feature
 // case. It's extremely unlikely that we will ever have more than these number
 // of mutator threads trying to access the moving-space during one compaction
@@ -460,17 +463,30 @@ MarkCompact::MarkCompact(Heap* heap)
     : GarbageCollector(heap, "concurrent mark compact"),
       gc_barrier_(0),
       lock_("mark compact lock", kGenericBottomLock),
+      class_after_obj_lock_("mark compact class-after-object lock", kGenericBottomLock),
       bump_pointer_space_(heap->GetBumpPointerSpace()),
       moving_space_bitmap_(bump_pointer_space_->GetMarkBitmap()),
       moving_space_begin_(bump_pointer_space_->Begin()),
       moving_space_end_(bump_pointer_space_->Limit()),
+      old_gen_end_(moving_space_begin_),
+      next_old_gen_end_(nullptr),
+      age_begin_(),
       moving_to_space_fd_(kFdUnused),
       moving_from_space_fd_(kFdUnused),
       uffd_(kFdUnused),
       sigbus_in_progress_count_(kSigbusCounterCompactionDoneMask),
       compaction_in_progress_count_(0),
+      compaction_gc_frontier_idx_(0),
+      compaction_worker_idx_(0),
       thread_pool_counter_(0),
       compacting_(false),
+      use_generational_(heap->GetUseGenerationalCMC()),
+      young_gen_requested_(false),
+      young_gen_(false),
+      gc_start_time_ns_(0),
+      full_gc_freed_bytes_(0),
+      full_gc_duration_ns_(0),
+      full_gc_count_(0),
       uffd_initialized_(false),
       uffd_minor_fault_supported_(false),
       use_uffd_sigbus_(IsSigbusFeatureAvailable()),
@@ -585,24 +601,50 @@ MarkCompact::MarkCompact(Heap* heap)
   CHECK(ret == 0 || errno == EINVAL);
 
   // Initialize GC metrics.
-  metrics::ArtMetrics* metrics = GetMetrics();
-  // The mark-compact collector supports only full-heap collections at the moment.
-  gc_time_histogram_ = metrics->FullGcCollectionTime();
-  metrics_gc_count_ = metrics->FullGcCount();
-  metrics_gc_count_delta_ = metrics->FullGcCountDelta();
-  gc_throughput_histogram_ = metrics->FullGcThroughput();
-  gc_tracing_throughput_hist_ = metrics->FullGcTracingThroughput();
-  gc_throughput_avg_ = metrics->FullGcThroughputAvg();
-  gc_tracing_throughput_avg_ = metrics->FullGcTracingThroughputAvg();
-  gc_scanned_bytes_ = metrics->FullGcScannedBytes();
-  gc_scanned_bytes_delta_ = metrics->FullGcScannedBytesDelta();
-  gc_freed_bytes_ = metrics->FullGcFreedBytes();
-  gc_freed_bytes_delta_ = metrics->FullGcFreedBytesDelta();
-  gc_duration_ = metrics->FullGcDuration();
-  gc_duration_delta_ = metrics->FullGcDurationDelta();
+  UpdateGcTypeMetrics();
   are_metrics_initialized_ = true;
 }
 
+void MarkCompact::UpdateGcTypeMetrics() {
+  // Return type of these functions are different. And even though the base class
+  // is same, using ternary operator complains.
+  metrics::ArtMetrics* metrics = GetMetrics();
+  if (young_gen_) {
+    gc_time_histogram_ = metrics->YoungGcCollectionTime();
+    metrics_gc_count_ = metrics->YoungGcCount();
+    metrics_gc_count_delta_ = metrics->YoungGcCountDelta();
+    gc_throughput_histogram_ = metrics->YoungGcThroughput();
+    gc_tracing_throughput_hist_ = metrics->YoungGcTracingThroughput();
+    gc_throughput_avg_ = metrics->YoungGcThroughputAvg();
+    gc_tracing_throughput_avg_ = metrics->YoungGcTracingThroughputAvg();
+    gc_scanned_bytes_ = metrics->YoungGcScannedBytes();
+    gc_scanned_bytes_delta_ = metrics->YoungGcScannedBytesDelta();
+    gc_freed_bytes_ = metrics->YoungGcFreedBytes();
+    gc_freed_bytes_delta_ = metrics->YoungGcFreedBytesDelta();
+    gc_duration_ = metrics->YoungGcDuration();
+    gc_duration_delta_ = metrics->YoungGcDurationDelta();
+  } else {
+    gc_time_histogram_ = metrics->FullGcCollectionTime();
+    metrics_gc_count_ = metrics->FullGcCount();
+    metrics_gc_count_delta_ = metrics->FullGcCountDelta();
+    gc_throughput_histogram_ = metrics->FullGcThroughput();
+    gc_tracing_throughput_hist_ = metrics->FullGcTracingThroughput();
+    gc_throughput_avg_ = metrics->FullGcThroughputAvg();
+    gc_tracing_throughput_avg_ = metrics->FullGcTracingThroughputAvg();
+    gc_scanned_bytes_ = metrics->FullGcScannedBytes();
+    gc_scanned_bytes_delta_ = metrics->FullGcScannedBytesDelta();
+    gc_freed_bytes_ = metrics->FullGcFreedBytes();
+    gc_freed_bytes_delta_ = metrics->FullGcFreedBytesDelta();
+    gc_duration_ = metrics->FullGcDuration();
+    gc_duration_delta_ = metrics->FullGcDurationDelta();
+  }
+}
+
+uint64_t MarkCompact::GetEstimatedFullGcThroughput() const {
+  // Add 1ms to prevent possible division by 0.
+  return (full_gc_freed_bytes_ * 1000) / (NsToMs(full_gc_duration_ns_) + 1);
+}
+
 void MarkCompact::AddLinearAllocSpaceData(uint8_t* begin, size_t len) {
   DCHECK_ALIGNED_PARAM(begin, gPageSize);
   DCHECK_ALIGNED_PARAM(len, gPageSize);
@@ -727,11 +769,25 @@ void MarkCompact::PrepareCardTableForMarking(bool clear_alloc_space_cards) {
     } else if (clear_alloc_space_cards) {
       CHECK(!space->IsZygoteSpace());
       CHECK(!space->IsImageSpace());
-      // The card-table corresponding to bump-pointer and non-moving space can
-      // be cleared, because we are going to traverse all the reachable objects
-      // in these spaces. This card-table will eventually be used to track
-      // mutations while concurrent marking is going on.
-      card_table->ClearCardRange(space->Begin(), space->Limit());
+      if (young_gen_) {
+        // In a young-generation cycle the old objects are not traversed. So
+        // keep the dirty cards, as aged, to find old-to-young references.
+        card_table->ModifyCardsAtomic(
+            space->Begin(),
+            space->End(),
+            [](uint8_t card) {
+              return (card == gc::accounting::CardTable::kCardDirty) ?
+                         gc::accounting::CardTable::kCardAged :
+                         gc::accounting::CardTable::kCardClean;
+            },
+            /* card modified visitor */ VoidFunctor());
+      } else {
+        // The card-table corresponding to bump-pointer and non-moving space can
+        // be cleared, because we are going to traverse all the reachable objects
+        // in these spaces. This card-table will eventually be used to track
+        // mutations while concurrent marking is going on.
+        card_table->ClearCardRange(space->Begin(), space->Limit());
+      }
       if (space != bump_pointer_space_) {
         CHECK_EQ(space, heap_->GetNonMovingSpace());
         non_moving_space_ = space;
@@ -793,6 +849,20 @@ void MarkCompact::InitializePhase() {
   // TODO: Would it suffice to read it once in the constructor, which is called
   // in zygote process?
   pointer_size_ = Runtime::Current()->GetClassLinker()->GetImagePointerSize();
+  gc_start_time_ns_ = NanoTime();
+  // The thread-pool is used for parallel marking and, if not using SIGBUS
+  // feature, for concurrent compaction. For zygote it's created right before
+  // compaction, and deleted after it (see PrepareForCompaction()).
+  if (heap_->GetThreadPool() == nullptr && !Runtime::Current()->IsZygote()) {
+    heap_->CreateThreadPool();
+  }
+  // A young-generation cycle is possible only if the previous cycle left a
+  // valid old generation behind, which is still within the space's bounds.
+  young_gen_ = use_generational_ && young_gen_requested_ && next_old_gen_end_ != nullptr &&
+               next_old_gen_end_ <= bump_pointer_space_->End();
+  old_gen_end_ = young_gen_ ? next_old_gen_end_ : moving_space_begin_;
+  next_old_gen_end_ = nullptr;
+  UpdateGcTypeMetrics();
 }
 
 class MarkCompact::ThreadFlipVisitor : public Closure {
@@ -800,6 +870,7 @@ class MarkCompact::ThreadFlipVisitor : public Closure {
   explicit ThreadFlipVisitor(MarkCompact* collector) : collector_(collector) {}
 
   void Run(Thread* thread) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    ScopedTrace trace("Thread flip");
     // Note: self is not necessarily equal to thread since thread may be suspended.
     Thread* self = Thread::Current();
     CHECK(thread == self || thread->GetState() != ThreadState::kRunnable)
@@ -1038,6 +1109,7 @@ class MarkCompact::ConcurrentCompactionGcTask : public SelfDeletingTask {
       : collector_(collector), index_(idx) {}
 
   void Run([[maybe_unused]] Thread* self) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    ScopedTrace trace("Concurrent compaction worker");
     if (collector_->CanCompactMovingSpaceWithMinorFault()) {
       collector_->ConcurrentCompaction<MarkCompact::kMinorFaultMode>(/*buf=*/nullptr);
     } else {
@@ -1054,6 +1126,46 @@ class MarkCompact::ConcurrentCompactionGcTask : public SelfDeletingTask {
   size_t index_;
 };
 
+class MarkCompact::CompactionWorkerTask : public SelfDeletingTask {
+ public:
+  explicit CompactionWorkerTask(MarkCompact* collector) : collector_(collector) {}
+
+  void Run([[maybe_unused]] Thread* self) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    ScopedTrace trace("Compaction worker");
+    collector_->CompactMovingSpaceAhead();
+  }
+
+ private:
+  MarkCompact* const collector_;
+};
+
+void MarkCompact::UpdateObjectAges(size_t vector_len, uint32_t total) {
+  uint8_t* const space_begin = bump_pointer_space_->Begin();
+  auto live_bytes_before = [&](uint8_t* addr) -> uint32_t {
+    size_t idx = (addr - space_begin) / kOffsetChunkSize;
+    return idx < vector_len ? chunk_info_vec_[idx] : total;
+  };
+  ObjectAges* object_ages = GetCurrentIteration()->GetObjectAges();
+  // The survivors of each age move to the next one, with the black allocations becoming the
+  // youngest objects.
+  uint8_t* new_age_begin[ObjectAges::kNumAges - 1];
+  new_age_begin[0] = post_compact_end_;
+  uint8_t* end = black_allocations_begin_;
+  for (size_t age = 0; age < ObjectAges::kNumAges; ++age) {
+    // The boundaries are stale if the moving space was reset since the last cycle.
+    uint8_t* begin = age + 1 < ObjectAges::kNumAges
+        ? std::clamp(age_begin_[age], space_begin, end)
+        : space_begin;
+    const uint32_t live_bytes = live_bytes_before(end) - live_bytes_before(begin);
+    object_ages->Add(age, end - begin, std::min<uint64_t>(live_bytes, end - begin));
+    if (age + 2 < ObjectAges::kNumAges) {
+      new_age_begin[age + 1] = space_begin + live_bytes_before(begin);
+    }
+    end = begin;
+  }
+  std::copy(std::begin(new_age_begin), std::end(new_age_begin), age_begin_);
+}
+
 void MarkCompact::PrepareForCompaction() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
   uint8_t* space_begin = bump_pointer_space_->Begin();
@@ -1107,7 +1219,17 @@ void MarkCompact::PrepareForCompaction() {
     DCHECK_EQ(chunk_info_vec_[i], 0u);
   }
   post_compact_end_ = AlignUp(space_begin + total, gPageSize);
+  // Every live byte of the moving space gets slid into place by compaction.
+  GetCurrentIteration()->SetCopiedBytes(total);
   CHECK_EQ(post_compact_end_, space_begin + moving_first_objs_count_ * gPageSize);
+  if (use_generational_) {
+    // All the objects marked in this cycle end up densely packed in
+    // [space_begin, space_begin + total), which becomes the old generation
+    // for the next young-generation cycle.
+    DCHECK_LE(old_gen_end_, space_begin + total);
+    next_old_gen_end_ = space_begin + total;
+  }
+  UpdateObjectAges(vector_len, total);
   black_objs_slide_diff_ = black_allocations_begin_ - post_compact_end_;
   // We shouldn't be consuming more space after compaction than pre-compaction.
   CHECK_GE(black_objs_slide_diff_, 0);
@@ -1155,7 +1277,10 @@ void MarkCompact::PrepareForCompaction() {
         heap_->CreateThreadPool(std::min(heap_->GetParallelGCThreadCount(), kMaxNumUffdWorkers));
         pool = heap_->GetThreadPool();
       }
-      size_t num_threads = pool->GetThreadCount();
+      // The pool may have more workers than compaction buffers if it was
+      // created for parallel marking.
+      size_t num_threads = std::min(
+          pool->GetThreadCount(), std::min(heap_->GetParallelGCThreadCount(), kMaxNumUffdWorkers));
       thread_pool_counter_ = num_threads;
       for (size_t i = 0; i < num_threads; i++) {
         pool->AddTask(thread_running_gc_, new ConcurrentCompactionGcTask(this, i + 1));
@@ -2472,6 +2597,7 @@ void MarkCompact::CompactMovingSpace(uint8_t* page) {
   mirror::Object* next_page_first_obj = nullptr;
   while (idx > moving_first_objs_count_) {
     idx--;
+    compaction_gc_frontier_idx_.store(idx, std::memory_order_relaxed);
     pre_compact_page -= gPageSize;
     to_space_end -= gPageSize;
     if (kMode == kMinorFaultMode) {
@@ -2509,6 +2635,7 @@ void MarkCompact::CompactMovingSpace(uint8_t* page) {
   size_t end_idx_for_mapping = idx;
   while (idx > 0) {
     idx--;
+    compaction_gc_frontier_idx_.store(idx, std::memory_order_relaxed);
     to_space_end -= gPageSize;
     if (kMode == kMinorFaultMode) {
       shadow_space_end -= gPageSize;
@@ -3045,7 +3172,7 @@ class MarkCompact::LinearAllocPageUpdater {
         {
           LengthPrefixedArray<ArtMethod>* array = static_cast<LengthPrefixedArray<ArtMethod>*>(obj);
           // Old methods are clobbered in debug builds. Check size to confirm if the array
-          // has any GC roots to visit. See ClassLinker::LinkMethodsHelper::ClobberOldMethods()
+          // has any GC roots to visit. See ClassLinker::LinkMethodsHelper::ReleaseOldMethods()
           if (array->size() > 0) {
             if (collector_->pointer_size_ == PointerSize::k64) {
               ArtMethod::VisitArrayRoots<PointerSize::k64>(
@@ -3151,6 +3278,10 @@ void MarkCompact::CompactionPause() {
     // Start updating roots and system weaks now.
     heap_->GetReferenceProcessor()->UpdateRoots(this);
   }
+  if (use_generational_) {
+    WriterMutexLock wmu(thread_running_gc_, *Locks::heap_bitmap_lock_);
+    UpdateMovingSpaceCardsForCompaction();
+  }
   {
     // TODO: Immune space updation has to happen either before or after
     // remapping pre-compact pages to from-space. And depending on when it's
@@ -3534,6 +3665,8 @@ bool MarkCompact::SigbusHandler(siginfo_t* info) {
     return false;
   }
 
+  // Mutator-assisted compaction shows up on the faulting thread's track.
+  ScopedTrace trace("MarkCompact SigbusHandler");
   ScopedInProgressCount spc(this);
   uint8_t* fault_page = AlignDown(reinterpret_cast<uint8_t*>(info->si_addr), gPageSize);
   if (!spc.IsCompactionDone()) {
@@ -3578,6 +3711,96 @@ bool MarkCompact::SigbusHandler(siginfo_t* info) {
   }
 }
 
+template <int kMode>
+void MarkCompact::ProcessAndMapMovingPage(size_t page_idx,
+                                          uint8_t* to_space_page,
+                                          mirror::Object* first_obj,
+                                          uint8_t* buf) {
+  if (to_space_page < post_compact_end_) {
+    // The page has to be compacted.
+    CompactPage(
+        first_obj, pre_compact_offset_moving_space_[page_idx], buf, kMode == kCopyMode);
+  } else {
+    DCHECK_NE(first_obj, nullptr);
+    DCHECK_GT(pre_compact_offset_moving_space_[page_idx], 0u);
+    uint8_t* pre_compact_page = black_allocations_begin_ + (to_space_page - post_compact_end_);
+    uint32_t first_chunk_size = black_alloc_pages_first_chunk_size_[page_idx];
+    mirror::Object* next_page_first_obj = nullptr;
+    if (page_idx + 1 < moving_first_objs_count_ + black_page_count_) {
+      next_page_first_obj = first_objs_moving_space_[page_idx + 1].AsMirrorPtr();
+    }
+    DCHECK(IsAlignedParam(pre_compact_page, gPageSize));
+    SlideBlackPage(first_obj,
+                   next_page_first_obj,
+                   first_chunk_size,
+                   pre_compact_page,
+                   buf,
+                   kMode == kCopyMode);
+  }
+  // Nobody else would simultaneously modify this page's state so an
+  // atomic store is sufficient. Use 'release' order to guarantee that
+  // loads/stores to the page are finished before this store. Since the
+  // calling thread used its own buffer for the processing, there is no reason
+  // to put its index in the status of the page. Also, the page is going to be
+  // mapped immediately, so that info is not needed.
+  moving_pages_status_[page_idx].store(static_cast<uint8_t>(PageState::kProcessedAndMapping),
+                                       std::memory_order_release);
+  if (kMode == kCopyMode) {
+    CopyIoctl(to_space_page, buf, gPageSize, /*return_on_contention=*/false);
+    // Store is sufficient as no other thread modifies the status at this stage.
+    moving_pages_status_[page_idx].store(static_cast<uint8_t>(PageState::kProcessedAndMapped),
+                                         std::memory_order_release);
+  } else {
+    // We don't support minor-fault feature anymore.
+    UNREACHABLE();
+  }
+}
+
+void MarkCompact::CompactMovingSpaceAhead() {
+  DCHECK(use_uffd_sigbus_);
+  Thread* self = Thread::Current();
+  uint8_t* buf = self->GetThreadLocalGcBuffer();
+  uint8_t* to_space_begin = bump_pointer_space_->Begin();
+  while (true) {
+    size_t idx = compaction_worker_idx_.fetch_add(1, std::memory_order_relaxed);
+    // Leave the pages close to the gc-thread to it, as it will get to them
+    // anyways and we would only contend on the page's state.
+    if (idx + 1 >= compaction_gc_frontier_idx_.load(std::memory_order_relaxed)) {
+      break;
+    }
+    mirror::Object* first_obj = first_objs_moving_space_[idx].AsMirrorPtr();
+    if (first_obj == nullptr) {
+      // Nothing to compact. The page will be zero-mapped by whichever thread
+      // accesses it first.
+      continue;
+    }
+    if (GetPageStateFromWord(moving_pages_status_[idx].load(std::memory_order_relaxed)) !=
+        PageState::kUnprocessed) {
+      continue;
+    }
+    // Increment the in-progress count before claiming the page so that the
+    // gc-thread doesn't unregister the moving space while we are working on
+    // it. See ConcurrentlyProcessMovingPage().
+    compaction_in_progress_count_.fetch_add(1, std::memory_order_relaxed);
+    uint32_t expected_state = static_cast<uint8_t>(PageState::kUnprocessed);
+    if (moving_pages_status_[idx].compare_exchange_strong(
+            expected_state,
+            static_cast<uint8_t>(PageState::kMutatorProcessing),
+            std::memory_order_acq_rel)) {
+      if (UNLIKELY(buf == nullptr)) {
+        uint16_t buf_idx = compaction_buffer_counter_.fetch_add(1, std::memory_order_relaxed);
+        // The buffer-map is one page bigger as the first buffer is used by GC-thread.
+        CHECK_LE(buf_idx, kMutatorCompactionBufferCount);
+        buf = compaction_buffers_map_.Begin() + buf_idx * gPageSize;
+        DCHECK(compaction_buffers_map_.HasAddress(buf));
+        self->SetThreadLocalGcBuffer(buf);
+      }
+      ProcessAndMapMovingPage<kCopyMode>(idx, to_space_begin + idx * gPageSize, first_obj, buf);
+    }
+    compaction_in_progress_count_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
 template <int kMode>
 void MarkCompact::ConcurrentlyProcessMovingPage(uint8_t* fault_page,
                                                 uint8_t* buf,
@@ -3687,45 +3910,8 @@ void MarkCompact::ConcurrentlyProcessMovingPage(uint8_t* fault_page,
           self->SetThreadLocalGcBuffer(buf);
         }
 
-        if (fault_page < post_compact_end_) {
-          // The page has to be compacted.
-          CompactPage(
-              first_obj, pre_compact_offset_moving_space_[page_idx], buf, kMode == kCopyMode);
-        } else {
-          DCHECK_NE(first_obj, nullptr);
-          DCHECK_GT(pre_compact_offset_moving_space_[page_idx], 0u);
-          uint8_t* pre_compact_page = black_allocations_begin_ + (fault_page - post_compact_end_);
-          uint32_t first_chunk_size = black_alloc_pages_first_chunk_size_[page_idx];
-          mirror::Object* next_page_first_obj = nullptr;
-          if (page_idx + 1 < moving_first_objs_count_ + black_page_count_) {
-            next_page_first_obj = first_objs_moving_space_[page_idx + 1].AsMirrorPtr();
-          }
-          DCHECK(IsAlignedParam(pre_compact_page, gPageSize));
-          SlideBlackPage(first_obj,
-                         next_page_first_obj,
-                         first_chunk_size,
-                         pre_compact_page,
-                         buf,
-                         kMode == kCopyMode);
-        }
-        // Nobody else would simultaneously modify this page's state so an
-        // atomic store is sufficient. Use 'release' order to guarantee that
-        // loads/stores to the page are finished before this store. Since the
-        // mutator used its own buffer for the processing, there is no reason to
-        // put its index in the status of the page. Also, the mutator is going
-        // to immediately map the page, so that info is not needed.
-        moving_pages_status_[page_idx].store(static_cast<uint8_t>(PageState::kProcessedAndMapping),
-                                             std::memory_order_release);
-        if (kMode == kCopyMode) {
-          CopyIoctl(fault_page, buf, gPageSize, /*return_on_contention=*/false);
-          // Store is sufficient as no other thread modifies the status at this stage.
-          moving_pages_status_[page_idx].store(static_cast<uint8_t>(PageState::kProcessedAndMapped),
-                                               std::memory_order_release);
-          break;
-        } else {
-          // We don't support minor-fault feature anymore.
-          UNREACHABLE();
-        }
+        ProcessAndMapMovingPage<kMode>(page_idx, fault_page, first_obj, buf);
+        break;
       }
       state = GetPageStateFromWord(raw_state);
       if (state == PageState::kProcessed) {
@@ -4171,7 +4357,29 @@ void MarkCompact::CompactionPhase() {
   if (CanCompactMovingSpaceWithMinorFault()) {
     CompactMovingSpace<kMinorFaultMode>(/*page=*/nullptr);
   } else {
+    // In SIGBUS mode the thread-pool is otherwise idle during compaction. Use
+    // it to compact pages from the beginning of the moving space, while this
+    // thread works from the end, so that mutators are less likely to take a
+    // fault on pages that haven't been processed yet.
+    ThreadPool* pool = use_uffd_sigbus_ ? heap_->GetThreadPool() : nullptr;
+    size_t num_workers = 0;
+    if (pool != nullptr) {
+      num_workers = std::min(pool->GetThreadCount(), heap_->GetConcGCThreadCount());
+      compaction_worker_idx_.store(0, std::memory_order_relaxed);
+      compaction_gc_frontier_idx_.store(moving_first_objs_count_ + black_page_count_,
+                                        std::memory_order_relaxed);
+      for (size_t i = 0; i < num_workers; i++) {
+        pool->AddTask(thread_running_gc_, new CompactionWorkerTask(this));
+      }
+      pool->SetMaxActiveWorkers(num_workers);
+      pool->StartWorkers(thread_running_gc_);
+    }
     CompactMovingSpace<kCopyMode>(compaction_buffers_map_.Begin());
+    if (num_workers > 0) {
+      pool->Wait(thread_running_gc_, /*do_work=*/true, /*may_hold_locks=*/true);
+      pool->StopWorkers(thread_running_gc_);
+      pool->SetMaxActiveWorkers(pool->GetThreadCount());
+    }
   }
 
   ProcessLinearAlloc();
@@ -4376,7 +4584,10 @@ void MarkCompact::MarkRootsCheckpoint(Thread* self, Runtime* runtime) {
   gc_barrier_.Init(self, 0);
   // Request the check point is run on all threads returning a count of the threads that must
   // run through the barrier including self.
-  size_t barrier_count = thread_list->RunCheckpoint(&check_point);
+  size_t barrier_count = thread_list->RunCheckpoint(&check_point,
+                                                    /*callback=*/nullptr,
+                                                    /*allow_lock_checking=*/true,
+                                                    heap_->GetThreadPool());
   // Release locks then wait for all mutator threads to pass the barrier.
   // If there are no threads to wait which implys that all the checkpoint functions are finished,
   // then no need to release locks.
@@ -4450,8 +4661,70 @@ void MarkCompact::UpdateAndMarkModUnion() {
   }
 }
 
+void MarkCompact::MarkOldGeneration() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  DCHECK(young_gen_);
+  // The old generation is densely packed as it was compacted in the previous
+  // cycle. So, walk it linearly.
+  uint8_t* addr = moving_space_begin_;
+  while (addr < old_gen_end_) {
+    mirror::Object* obj = reinterpret_cast<mirror::Object*>(addr);
+    size_t obj_size = obj->SizeOf<kDefaultVerifyFlags>();
+    moving_space_bitmap_->Set(obj);
+    UpdateLivenessInfo(obj, obj_size);
+    addr += RoundUp(obj_size, kAlignment);
+  }
+  DCHECK_EQ(addr, old_gen_end_);
+  // Everything that survived the previous GC in the non-moving and
+  // large-object spaces is considered old.
+  if (non_moving_space_ != nullptr) {
+    non_moving_space_bitmap_->CopyFrom(non_moving_space_->GetLiveBitmap());
+  }
+  space::LargeObjectSpace* const los = heap_->GetLargeObjectsSpace();
+  if (los != nullptr) {
+    los->CopyLiveToMarked();
+  }
+}
+
+void MarkCompact::UpdateMovingSpaceCardsForCompaction() {
+  TimingLogger::ScopedTiming t("(Paused)UpdateMovingSpaceCards", GetTimings());
+  // Objects in [moving_space_begin_, old_gen_end_) don't move, and so their
+  // cards remain valid. Everything else which was marked is going to slide.
+  // All the references from these objects have been traced in this cycle, so
+  // only the ones which are still dirty can refer to the next young
+  // generation. Transfer those cards to the post-compact addresses of the
+  // corresponding objects, and clean the rest.
+  accounting::CardTable* const card_table = heap_->GetCardTable();
+  uint8_t* const scan_begin = AlignDown(old_gen_end_, accounting::CardTable::kCardSize);
+  uint8_t* const clear_begin = AlignUp(old_gen_end_, accounting::CardTable::kCardSize);
+  if (scan_begin >= black_allocations_begin_) {
+    return;
+  }
+  std::vector<mirror::Object*> dirty_objs;
+  card_table->Scan</*kClearCard*/ false>(
+      moving_space_bitmap_,
+      scan_begin,
+      black_allocations_begin_,
+      [this, &dirty_objs](mirror::Object* obj) {
+        if (reinterpret_cast<uint8_t*>(obj) >= old_gen_end_) {
+          dirty_objs.push_back(obj);
+        }
+      },
+      accounting::CardTable::kCardDirty);
+  DCHECK_LE(clear_begin, post_compact_end_);
+  card_table->ClearCardRange(clear_begin, post_compact_end_);
+  for (mirror::Object* obj : dirty_objs) {
+    card_table->MarkCard(PostCompactOldObjAddr(obj));
+  }
+}
+
 void MarkCompact::MarkReachableObjects() {
   UpdateAndMarkModUnion();
+  if (young_gen_) {
+    // Old objects are already marked but not scanned. Scan the ones on aged
+    // cards to find references into the young generation.
+    ScanDirtyObjects(/*paused*/ false, accounting::CardTable::kCardAged);
+  }
   // Recursively mark all the non-image bits set in the mark bitmap.
   ProcessMarkStack();
 }
@@ -4523,6 +4796,9 @@ void MarkCompact::MarkingPhase() {
   WriterMutexLock mu(thread_running_gc_, *Locks::heap_bitmap_lock_);
   MaybeClampGcStructures();
   PrepareCardTableForMarking(/*clear_alloc_space_cards*/ true);
+  if (young_gen_) {
+    MarkOldGeneration();
+  }
   MarkZygoteLargeObjects();
   MarkRoots(
         static_cast<VisitRootFlags>(kVisitRootFlagAllRoots | kVisitRootFlagStartLoggingNewRoots));
@@ -4593,26 +4869,39 @@ size_t MarkCompact::LiveWordsBitmap<kAlignment>::LiveBytesInBitmapWord(size_t ch
   return words * kAlignment;
 }
 
+template <bool kParallel>
 void MarkCompact::UpdateLivenessInfo(mirror::Object* obj, size_t obj_size) {
   DCHECK(obj != nullptr);
   DCHECK_EQ(obj_size, obj->SizeOf<kDefaultVerifyFlags>());
   uintptr_t obj_begin = reinterpret_cast<uintptr_t>(obj);
-  UpdateClassAfterObjectMap(obj);
+  UpdateClassAfterObjectMap<kParallel>(obj);
   size_t size = RoundUp(obj_size, kAlignment);
-  uintptr_t bit_index = live_words_bitmap_->SetLiveWords(obj_begin, size);
+  uintptr_t bit_index = live_words_bitmap_->SetLiveWords<kParallel>(obj_begin, size);
   size_t chunk_idx = (obj_begin - live_words_bitmap_->Begin()) / kOffsetChunkSize;
   // Compute the bit-index within the chunk-info vector word.
   bit_index %= kBitsPerVectorWord;
   size_t first_chunk_portion = std::min(size, (kBitsPerVectorWord - bit_index) * kAlignment);
 
-  chunk_info_vec_[chunk_idx++] += first_chunk_portion;
+  // The first and last chunks may be shared with other objects, which in the
+  // parallel case could be getting marked by other threads simultaneously.
+  auto add_to_chunk = [this](size_t idx, uint32_t bytes) {
+    if (kParallel) {
+      reinterpret_cast<Atomic<uint32_t>*>(chunk_info_vec_ + idx)->fetch_add(
+          bytes, std::memory_order_relaxed);
+    } else {
+      chunk_info_vec_[idx] += bytes;
+    }
+  };
+  add_to_chunk(chunk_idx++, first_chunk_portion);
   DCHECK_LE(first_chunk_portion, size);
   for (size -= first_chunk_portion; size > kOffsetChunkSize; size -= kOffsetChunkSize) {
     DCHECK_EQ(chunk_info_vec_[chunk_idx], 0u);
     chunk_info_vec_[chunk_idx++] = kOffsetChunkSize;
   }
-  chunk_info_vec_[chunk_idx] += size;
-  freed_objects_--;
+  add_to_chunk(chunk_idx, size);
+  if (!kParallel) {
+    freed_objects_--;
+  }
 }
 
 template <bool kUpdateLiveWords>
@@ -4631,9 +4920,173 @@ void MarkCompact::ScanObject(mirror::Object* obj) {
   obj->VisitReferences(visitor, visitor);
 }
 
+class MarkCompact::MarkStackTask : public Task {
+ public:
+  MarkStackTask(ThreadPool* thread_pool,
+                MarkCompact* collector,
+                size_t mark_stack_size,
+                StackReference<mirror::Object>* mark_stack)
+      : collector_(collector),
+        thread_pool_(thread_pool),
+        mark_stack_pos_(mark_stack_size),
+        bytes_scanned_(0),
+        objects_marked_(0) {
+    // We may have to copy part of an existing mark stack when another mark stack overflows.
+    if (mark_stack_size != 0) {
+      DCHECK(mark_stack != nullptr);
+      std::copy(mark_stack, mark_stack + mark_stack_size, mark_stack_);
+    }
+  }
+
+  static constexpr size_t kMaxSize = 1 * KB;
+
+  // Scans all of the objects reachable from the task's mark stack.
+  // No thread safety analysis as the worker threads run on behalf of the
+  // GC-thread, which holds the required locks.
+  void Run([[maybe_unused]] Thread* self) override NO_THREAD_SAFETY_ANALYSIS {
+    ScopedTrace trace("Parallel marking worker");
+    ParallelRefFieldsVisitor visitor(this);
+    while (mark_stack_pos_ != 0) {
+      mirror::Object* obj = mark_stack_[--mark_stack_pos_].AsMirrorPtr();
+      DCHECK(obj != nullptr);
+      size_t obj_size = obj->SizeOf<kDefaultVerifyFlags>();
+      bytes_scanned_ += obj_size;
+      DCHECK(collector_->IsMarked(obj)) << "Scanning unmarked object " << obj;
+      if (collector_->HasAddress(obj)) {
+        collector_->UpdateLivenessInfo</*kParallel*/ true>(obj, obj_size);
+        objects_marked_++;
+      }
+      obj->VisitReferences(visitor, visitor);
+    }
+    collector_->parallel_bytes_scanned_.fetch_add(bytes_scanned_, std::memory_order_relaxed);
+    collector_->parallel_objects_marked_.fetch_add(objects_marked_, std::memory_order_relaxed);
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  class ParallelRefFieldsVisitor {
+   public:
+    ALWAYS_INLINE explicit ParallelRefFieldsVisitor(MarkStackTask* task) : task_(task) {}
+
+    ALWAYS_INLINE void operator()(mirror::Object* obj,
+                                  MemberOffset offset,
+                                  [[maybe_unused]] bool is_static) const
+        NO_THREAD_SAFETY_ANALYSIS {
+      Mark(obj->GetFieldObject<mirror::Object>(offset), obj, offset);
+    }
+
+    void operator()(ObjPtr<mirror::Class> klass, ObjPtr<mirror::Reference> ref) const
+        ALWAYS_INLINE NO_THREAD_SAFETY_ANALYSIS {
+      task_->collector_->DelayReferenceReferent(klass, ref);
+    }
+
+    void VisitRootIfNonNull(mirror::CompressedReference<mirror::Object>* root) const
+        ALWAYS_INLINE NO_THREAD_SAFETY_ANALYSIS {
+      if (!root->IsNull()) {
+        VisitRoot(root);
+      }
+    }
+
+    void VisitRoot(mirror::CompressedReference<mirror::Object>* root) const
+        NO_THREAD_SAFETY_ANALYSIS {
+      Mark(root->AsMirrorPtr(), /*holder=*/nullptr, MemberOffset(0));
+    }
+
+   private:
+    ALWAYS_INLINE void Mark(mirror::Object* ref, mirror::Object* holder, MemberOffset offset) const
+        NO_THREAD_SAFETY_ANALYSIS {
+      if (ref != nullptr &&
+          task_->collector_->MarkObjectNonNullNoPush</*kParallel*/ true>(ref, holder, offset)) {
+        task_->MarkStackPush(ref);
+      }
+    }
+
+    MarkStackTask* const task_;
+  };
+
+  ~MarkStackTask() {
+    // Make sure that we have cleared our mark stack.
+    DCHECK_EQ(mark_stack_pos_, 0U);
+  }
+
+  ALWAYS_INLINE void MarkStackPush(mirror::Object* obj) {
+    if (UNLIKELY(mark_stack_pos_ == kMaxSize)) {
+      // Mark stack overflow, give 1/2 the stack to the thread pool as a new
+      // work task, which an idle worker can pick up.
+      mark_stack_pos_ /= 2;
+      auto* task = new MarkStackTask(thread_pool_,
+                                     collector_,
+                                     kMaxSize - mark_stack_pos_,
+                                     mark_stack_ + mark_stack_pos_);
+      thread_pool_->AddTask(Thread::Current(), task);
+    }
+    DCHECK(obj != nullptr);
+    DCHECK_LT(mark_stack_pos_, kMaxSize);
+    mark_stack_[mark_stack_pos_++].Assign(obj);
+  }
+
+  MarkCompact* const collector_;
+  ThreadPool* const thread_pool_;
+  // Thread local mark stack for this task.
+  StackReference<mirror::Object> mark_stack_[kMaxSize];
+  // Mark stack position.
+  size_t mark_stack_pos_;
+  uint64_t bytes_scanned_;
+  int32_t objects_marked_;
+};
+
+size_t MarkCompact::GetMarkingThreadCount(bool paused) const {
+  // Use less threads if we are in a background state (non jank perceptible) since we want to leave
+  // more CPU time for the foreground apps.
+  // Transactions require reference-processing to mark referents on the
+  // GC-thread's mark-stack, so don't mark in parallel in that case.
+  ThreadPool* pool = heap_->GetThreadPool();
+  if (pool == nullptr || IsTransactionActive() ||
+      !Runtime::Current()->InJankPerceptibleProcessState()) {
+    return 1;
+  }
+  size_t count = paused ? heap_->GetParallelGCThreadCount() : heap_->GetConcGCThreadCount();
+  return std::min(count, pool->GetThreadCount()) + 1;
+}
+
+void MarkCompact::ProcessMarkStackParallel(size_t thread_count) {
+  Thread* self = Thread::Current();
+  ThreadPool* thread_pool = heap_->GetThreadPool();
+  parallel_bytes_scanned_.store(0, std::memory_order_relaxed);
+  parallel_objects_marked_.store(0, std::memory_order_relaxed);
+  const size_t chunk_size = std::min(mark_stack_->Size() / thread_count + 1,
+                                     MarkStackTask::kMaxSize);
+  CHECK_GT(chunk_size, 0U);
+  // Split the current mark stack up into work tasks.
+  for (auto* it = mark_stack_->Begin(), *end = mark_stack_->End(); it < end; ) {
+    const size_t delta = std::min(static_cast<size_t>(end - it), chunk_size);
+    thread_pool->AddTask(self, new MarkStackTask(thread_pool, this, delta, it));
+    it += delta;
+  }
+  mark_stack_->Reset();
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ true);
+  thread_pool->StopWorkers(self);
+  // Compaction relies on all the workers being available.
+  thread_pool->SetMaxActiveWorkers(thread_pool->GetThreadCount());
+  bytes_scanned_ += parallel_bytes_scanned_.load(std::memory_order_relaxed);
+  freed_objects_ -= parallel_objects_marked_.load(std::memory_order_relaxed);
+}
+
 // Scan anything that's on the mark stack.
 void MarkCompact::ProcessMarkStack() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  size_t thread_count =
+      GetMarkingThreadCount(Locks::mutator_lock_->IsExclusiveHeld(Thread::Current()));
+  if (thread_count > 1 && mark_stack_->Size() >= kMinimumParallelMarkStackSize) {
+    ProcessMarkStackParallel(thread_count);
+    DCHECK(mark_stack_->IsEmpty());
+    return;
+  }
   // TODO: try prefetch like in CMS
   while (!mark_stack_->IsEmpty()) {
     mirror::Object* obj = mark_stack_->PopBack();
@@ -4816,6 +5269,13 @@ void MarkCompact::DelayReferenceReferent(ObjPtr<mirror::Class> klass,
 
 void MarkCompact::FinishPhase() {
   GetCurrentIteration()->SetScannedBytes(bytes_scanned_);
+  if (!young_gen_) {
+    Iteration* const iteration = GetCurrentIteration();
+    int64_t freed_bytes = iteration->GetFreedBytes() + iteration->GetFreedLargeObjectBytes();
+    full_gc_freed_bytes_ += std::max<int64_t>(freed_bytes, 0);
+    full_gc_duration_ns_ += NanoTime() - gc_start_time_ns_;
+    full_gc_count_++;
+  }
   bool is_zygote = Runtime::Current()->IsZygote();
   compacting_ = false;
   minor_fault_initialized_ = !is_zygote && uffd_minor_fault_supported_;
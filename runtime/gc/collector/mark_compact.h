@@ -89,9 +89,22 @@ class MarkCompact final : public GarbageCollector {
   bool SigbusHandler(siginfo_t* info) REQUIRES(!lock_) NO_THREAD_SAFETY_ANALYSIS;
 
   GcType GetGcType() const override {
-    return kGcTypeFull;
+    return young_gen_ ? kGcTypeSticky : kGcTypeFull;
   }
 
+  // Request a young-generation (true) or full-heap (false) cycle for the next
+  // invocation of RunPhases(). A young cycle is only performed in generational
+  // mode and when the old-generation boundary recorded by the previous cycle
+  // is valid. Otherwise, a full-heap cycle is performed.
+  void SetYoungGen(bool young_gen) { young_gen_requested_ = young_gen; }
+  // Forget the old generation, forcing the next cycle to be full-heap. Used
+  // when the moving space is emptied outside of this collector.
+  void ResetGenerations() { next_old_gen_end_ = nullptr; }
+  // Throughput (bytes freed per second) and count of only the full-heap
+  // cycles. Used by the heap to decide between young and full cycles.
+  uint64_t GetEstimatedFullGcThroughput() const;
+  size_t NumberOfFullIterations() const { return full_gc_count_; }
+
   CollectorType GetCollectorType() const override {
     return kCollectorTypeCMC;
   }
@@ -209,6 +222,10 @@ class MarkCompact final : public GarbageCollector {
     uint32_t FindNthLiveWordOffset(size_t chunk_idx, uint32_t n) const;
     // Sets all bits in the bitmap corresponding to the given range. Also
     // returns the bit-index of the first word.
+    // If kParallel is true, then the boundary words of the range are updated
+    // atomically as they may be shared with other objects being marked
+    // concurrently by other threads.
+    template <bool kParallel = false>
     ALWAYS_INLINE uintptr_t SetLiveWords(uintptr_t begin, size_t size);
     // Count number of live words upto the given bit-index. This is to be used
     // to compute the post-compact address of an old reference.
@@ -269,6 +286,9 @@ class MarkCompact final : public GarbageCollector {
   // mirror::Class.
   bool IsValidObject(mirror::Object* obj) const REQUIRES_SHARED(Locks::mutator_lock_);
   void InitializePhase();
+  // Switch the GC metrics between young and full collections depending on
+  // young_gen_.
+  void UpdateGcTypeMetrics();
   void FinishPhase() REQUIRES(!Locks::mutator_lock_, !Locks::heap_bitmap_lock_, !lock_);
   void MarkingPhase() REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Locks::heap_bitmap_lock_);
   void CompactionPhase() REQUIRES_SHARED(Locks::mutator_lock_);
@@ -335,6 +355,10 @@ class MarkCompact final : public GarbageCollector {
   // Compute offsets (in chunk_info_vec_) and other data structures required
   // during concurrent compaction.
   void PrepareForCompaction() REQUIRES_SHARED(Locks::mutator_lock_);
+  // Record the ages of the moving space's bytes and how many of them survive, and find where
+  // each age ends up after compaction. Requires chunk_info_vec_ to hold the live bytes before
+  // each chunk, `vector_len` of them, and `total` the number of live bytes.
+  void UpdateObjectAges(size_t vector_len, uint32_t total);
 
   // Copy gPageSize live bytes starting from 'offset' (within the moving space),
   // which must be within 'obj', into the gPageSize sized memory pointed by 'addr'.
@@ -418,6 +442,19 @@ class MarkCompact final : public GarbageCollector {
   // Traverse through the reachable objects and mark them.
   void MarkReachableObjects() REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::heap_bitmap_lock_);
+  // In a young-generation cycle, mark every object in the old generation of
+  // the moving space, along with all the objects which were live in the
+  // non-moving and large-object spaces at the end of the previous GC. Objects
+  // of the moving space get their liveness info updated but aren't pushed on
+  // the mark-stack. Their references into the young generation are found by
+  // scanning dirty cards instead.
+  void MarkOldGeneration() REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_);
+  // In generational mode, update the moving-space card table during the
+  // compaction pause so that dirty cards of objects that are going to be
+  // compacted are transferred to their post-compact addresses.
+  void UpdateMovingSpaceCardsForCompaction() REQUIRES(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_);
   // Scan (only) immune spaces looking for references into the garbage collected
   // spaces.
   void UpdateAndMarkModUnion() REQUIRES_SHARED(Locks::mutator_lock_)
@@ -435,6 +472,13 @@ class MarkCompact final : public GarbageCollector {
   // Go through all the objects in the mark-stack until it's empty.
   void ProcessMarkStack() override REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::heap_bitmap_lock_);
+  // Drain the mark-stack using 'thread_count' threads (including the calling
+  // one) of the heap's thread-pool. Each thread works on a private mark-stack
+  // and shares half of it with idle threads when it overflows.
+  void ProcessMarkStackParallel(size_t thread_count) REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_);
+  // Number of threads, including the GC-thread, to be used for marking.
+  size_t GetMarkingThreadCount(bool paused) const;
   void ExpandMarkStack() REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::heap_bitmap_lock_);
 
@@ -450,7 +494,9 @@ class MarkCompact final : public GarbageCollector {
 
   // Update the live-words bitmap as well as add the object size to the
   // chunk-info vector. Both are required for computation of post-compact addresses.
-  // Also updates freed_objects_ counter.
+  // Also updates freed_objects_ counter, unless kParallel is true, in which
+  // case the caller is responsible for it.
+  template <bool kParallel = false>
   void UpdateLivenessInfo(mirror::Object* obj, size_t obj_size)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -505,6 +551,18 @@ class MarkCompact final : public GarbageCollector {
                                      uint8_t* buf,
                                      size_t nr_moving_space_used_pages)
       REQUIRES_SHARED(Locks::mutator_lock_);
+  // Compact (or slide) the moving-space page at 'page_idx' into 'buf' and
+  // copy it into 'to_space_page'. The caller must have already claimed the
+  // page by setting its state to kMutatorProcessing.
+  template <int kMode>
+  void ProcessAndMapMovingPage(size_t page_idx,
+                               uint8_t* to_space_page,
+                               mirror::Object* first_obj,
+                               uint8_t* buf) REQUIRES_SHARED(Locks::mutator_lock_);
+  // Called by compaction workers, only in SIGBUS mode, to compact the
+  // moving-space pages in ascending order, while the gc-thread compacts in
+  // descending order. Returns when the claim cursor meets the gc-thread.
+  void CompactMovingSpaceAhead() REQUIRES_SHARED(Locks::mutator_lock_);
   // Called by thread-pool workers to process and copy/map the fault page in
   // linear-alloc.
   template <int kMode>
@@ -563,9 +621,13 @@ class MarkCompact final : public GarbageCollector {
   }
 
   // Add/update <class, obj> pair if class > obj and obj is the lowest address
-  // object of class.
+  // object of class. If kParallel is true, then the maps are updated while
+  // holding class_after_obj_lock_.
+  template <bool kParallel = false>
   ALWAYS_INLINE void UpdateClassAfterObjectMap(mirror::Object* obj)
       REQUIRES_SHARED(Locks::mutator_lock_);
+  ALWAYS_INLINE void AddClassAfterObjectMapEntry(mirror::Object* obj, mirror::Class* klass)
+      REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Updates 'class_after_obj_map_' map by updating the keys (class) with its
   // highest-address super-class (obtained from 'super_class_after_class_map_'),
@@ -625,6 +687,9 @@ class MarkCompact final : public GarbageCollector {
   // when collecting thread-stack roots using checkpoint. Otherwise, we use it
   // to synchronize on updated_roots_ in debug-builds.
   Mutex lock_;
+  // Guards class_after_obj_hash_map_, super_class_after_class_hash_map_ and
+  // walk_super_class_cache_ during parallel marking.
+  Mutex class_after_obj_lock_;
   accounting::ObjectStack* mark_stack_;
   // Special bitmap wherein all the bits corresponding to an object are set.
   // TODO: make LiveWordsBitmap encapsulated in this class rather than a
@@ -765,6 +830,11 @@ class MarkCompact final : public GarbageCollector {
   size_t live_stack_freeze_size_;
 
   uint64_t bytes_scanned_;
+  // Bytes scanned and moving-space objects marked by the MarkStackTasks of a
+  // ProcessMarkStackParallel() invocation. They are added to bytes_scanned_
+  // and freed_objects_ once all the tasks are finished.
+  std::atomic<uint64_t> parallel_bytes_scanned_;
+  std::atomic<int32_t> parallel_objects_marked_;
 
   // For every page in the to-space (post-compact heap) we need to know the
   // first object from which we must compact and/or update references. This is
@@ -810,6 +880,19 @@ class MarkCompact final : public GarbageCollector {
   // End of compacted space. Use for computing post-compact addr of black
   // allocated objects. Aligned up to page size.
   uint8_t* post_compact_end_;
+  // End of the old generation in moving space for this GC cycle. Everything in
+  // [moving_space_begin_, old_gen_end_) is densely packed and treated as live
+  // without being traced. Equals moving_space_begin_ in a full-heap cycle.
+  uint8_t* old_gen_end_;
+  // Post-compact end of the objects which were marked in this GC cycle. The
+  // next young-generation cycle uses it as its old_gen_end_. Null if there
+  // isn't any valid old generation, in which case the next cycle is full-heap.
+  uint8_t* next_old_gen_end_;
+  // Start of the objects of each age in the moving space. Compaction slides objects without
+  // reordering them, so the objects that survived `age` collections are in
+  // [age_begin_[age], age_begin_[age - 1]), or up to black_allocations_begin_ for age 0. The
+  // oldest ones start at moving_space_begin_. Tracked at kOffsetChunkSize granularity.
+  uint8_t* age_begin_[ObjectAges::kNumAges - 1];
   // Cache (black_allocations_begin_ - post_compact_end_) for post-compact
   // address computations.
   ptrdiff_t black_objs_slide_diff_;
@@ -850,10 +933,28 @@ class MarkCompact final : public GarbageCollector {
   // When using SIGBUS feature, this counter is used by mutators to claim a page
   // out of compaction buffers to be used for the entire compaction cycle.
   std::atomic<uint16_t> compaction_buffer_counter_;
+  // Index of the moving-space page the gc-thread is currently compacting in
+  // CompactMovingSpace(). Compaction workers don't claim pages at or above it.
+  std::atomic<size_t> compaction_gc_frontier_idx_;
+  // Cursor used by compaction workers to claim moving-space pages from the
+  // beginning of the space.
+  std::atomic<size_t> compaction_worker_idx_;
   // Used to exit from compaction loop at the end of concurrent compaction
   uint8_t thread_pool_counter_;
   // True while compacting.
   bool compacting_;
+  // True if young-generation cycles are enabled (-Xgc:generational_cmc).
+  const bool use_generational_;
+  // Set by the heap (via SetYoungGen()) before starting a GC cycle.
+  bool young_gen_requested_;
+  // True if the current (or last) GC cycle is a young-generation one.
+  bool young_gen_;
+  // Start time of the current GC cycle, and the cumulative bytes freed and
+  // time spent by full-heap cycles. Used for GetEstimatedFullGcThroughput().
+  uint64_t gc_start_time_ns_;
+  uint64_t full_gc_freed_bytes_;
+  uint64_t full_gc_duration_ns_;
+  size_t full_gc_count_;
   // Flag indicating whether one-time uffd initialization has been done. It will
   // be false on the first GC for non-zygote processes, and always for zygote.
   // Its purpose is to minimize the userfaultfd overhead to the minimal in
@@ -893,6 +994,8 @@ class MarkCompact final : public GarbageCollector {
   class LinearAllocPageUpdater;
   class ImmuneSpaceUpdateObjVisitor;
   class ConcurrentCompactionGcTask;
+  class CompactionWorkerTask;
+  class MarkStackTask;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(MarkCompact);
 };
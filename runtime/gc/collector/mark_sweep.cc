@@ -856,6 +856,7 @@ class MarkSweep::CardScanTask : public MarkStackTask<false> {
   }
 
   void Run(Thread* self) override NO_THREAD_SAFETY_ANALYSIS {
+    ScopedTrace trace("Parallel card scan worker");
     ScanObjectParallelVisitor visitor(this);
     accounting::CardTable* card_table = mark_sweep_->GetHeap()->GetCardTable();
     size_t cards_scanned = clear_card_
@@ -1011,6 +1012,7 @@ class MarkSweep::RecursiveMarkTask : public MarkStackTask<false> {
 
   // Scans all of the objects
   void Run(Thread* self) override NO_THREAD_SAFETY_ANALYSIS {
+    ScopedTrace trace("Parallel recursive mark worker");
     ScanObjectParallelVisitor visitor(this);
     bitmap_->VisitMarkedRange(begin_, end_, visitor);
     // Finish by emptying our local mark stack.
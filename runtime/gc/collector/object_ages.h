@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_COLLECTOR_OBJECT_AGES_H_
+#define ART_RUNTIME_GC_COLLECTOR_OBJECT_AGES_H_
+
+#include <inttypes.h>
+
+#include <algorithm>
+
+#include "base/macros.h"
+
+namespace art HIDDEN {
+namespace gc {
+namespace collector {
+
+// Bytes seen by a collection, by age, and how many of them survived it. The age of bytes is the
+// number of collections they survived before. The ages are tracked per region or per page, so
+// they are approximate.
+struct ObjectAges {
+  // The last age also counts all the older bytes.
+  static constexpr size_t kNumAges = 8;
+
+  void Add(size_t age, uint64_t num_bytes, uint64_t num_surviving_bytes) {
+    age = std::min(age, kNumAges - 1);
+    bytes[age] += num_bytes;
+    surviving_bytes[age] += num_surviving_bytes;
+  }
+  void Add(const ObjectAges& other) {
+    for (size_t age = 0; age < kNumAges; ++age) {
+      Add(age, other.bytes[age], other.surviving_bytes[age]);
+    }
+  }
+  // Bytes surviving the collection, in percent of the bytes of ages in [begin_age, end_age).
+  // Returns -1 if there are no such bytes.
+  int64_t GetSurvivalPercent(size_t begin_age, size_t end_age) const {
+    uint64_t total = 0;
+    uint64_t surviving = 0;
+    for (size_t age = begin_age; age < end_age; ++age) {
+      total += bytes[age];
+      surviving += surviving_bytes[age];
+    }
+    return total == 0 ? -1 : static_cast<int64_t>(surviving * 100 / total);
+  }
+
+  uint64_t bytes[kNumAges] = {};
+  uint64_t surviving_bytes[kNumAges] = {};
+};
+
+}  // namespace collector
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_COLLECTOR_OBJECT_AGES_H_
@@ -32,6 +32,7 @@
 #include "gc/space/region_space-inl.h"
 #include "gc/space/rosalloc_space-inl.h"
 #include "handle_scope-inl.h"
+#include "javaheapprof/allocation_site_profiler.h"
 #include "obj_ptr-inl.h"
 #include "runtime.h"
 #include "thread-inl.h"
@@ -190,6 +191,11 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self,
       }
       no_suspend_pre_fence_visitor(obj, usable_size);
       QuasiAtomic::ThreadFenceForConstructor();
+      // A sample taken for a new TLAB can only be attributed now that the class is set.
+      AllocationSiteTable* site_table = self->GetAllocationSiteTable();
+      if (UNLIKELY(site_table != nullptr) && UNLIKELY(site_table->HasPendingSample())) {
+        allocation_site_profiler_->RecordPendingSample(self, obj);
+      }
     }
     if (bytes_tl_bulk_allocated > 0) {
       starting_gc_num = GetCurrentGcNum();
@@ -19,6 +19,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <limits>
 #include <memory>
 #include <random>
@@ -99,6 +100,7 @@
 #endif
 #include "reflection.h"
 #include "runtime.h"
+#include "javaheapprof/allocation_site_profiler.h"
 #include "javaheapprof/javaheapsampler.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-inl.h"
@@ -152,8 +154,8 @@ static constexpr size_t kMaxConcurrentRemainingBytes = 512 * KB;
 // Sticky GC throughput adjustment, divided by 4. Increasing this causes sticky GC to occur more
 // relative to partial/full GC. This may be desirable since sticky GCs interfere less with mutator
 // threads (lower pauses, use less memory bandwidth).
-static double GetStickyGcThroughputAdjustment(bool use_generational_cc) {
-  return use_generational_cc ? 0.5 : 1.0;
+static double GetStickyGcThroughputAdjustment(bool use_generational) {
+  return use_generational ? 0.5 : 1.0;
 }
 // Whether or not we compact the zygote in PreZygoteFork.
 static constexpr bool kCompactZygote = kMovingCollector;
@@ -271,6 +273,12 @@ static void VerifyBootImagesContiguity(const std::vector<gc::space::ImageSpace*>
   }
 }
 
+static void AdviseHugePages(MemMap* mem_map) {
+  if (mem_map->MadviseHugePage() != 0) {
+    PLOG(WARNING) << "Failed to back " << mem_map->GetName() << " with huge pages";
+  }
+}
+
 Heap::Heap(size_t initial_size,
            size_t growth_limit,
            size_t min_free,
@@ -297,6 +305,7 @@ Heap::Heap(size_t initial_size,
            bool low_memory_mode,
            size_t long_pause_log_threshold,
            size_t long_gc_log_threshold,
+           uint64_t pause_target,
            bool ignore_target_footprint,
            bool always_log_explicit_gcs,
            bool use_tlab,
@@ -310,6 +319,9 @@ Heap::Heap(size_t initial_size,
            bool measure_gc_performance,
            bool use_homogeneous_space_compaction_for_oom,
            bool use_generational_cc,
+           bool use_generational_cmc,
+           bool use_numa_aware_regions,
+           bool use_huge_pages,
            uint64_t min_interval_homogeneous_space_compaction_by_oom,
            bool dump_region_info_before_gc,
            bool dump_region_info_after_gc)
@@ -327,6 +339,12 @@ Heap::Heap(size_t initial_size,
       low_memory_mode_(low_memory_mode),
       long_pause_log_threshold_(long_pause_log_threshold),
       long_gc_log_threshold_(long_gc_log_threshold),
+      pause_target_(pause_target),
+      pause_target_reserve_scale_(1),
+      allocation_rate_average_(0.0),
+      concurrent_gc_duration_average_ns_(0),
+      last_grow_time_ns_(0),
+      last_grow_bytes_allocated_ever_(0),
       process_cpu_start_time_ns_(ProcessCpuNanoTime()),
       pre_gc_last_process_cpu_time_ns_(process_cpu_start_time_ns_),
       post_gc_last_process_cpu_time_ns_(process_cpu_start_time_ns_),
@@ -359,6 +377,8 @@ Heap::Heap(size_t initial_size,
       num_bytes_allocated_(0),
       native_bytes_registered_(0),
       old_native_bytes_allocated_(0),
+      sampled_malloc_bytes_(0),
+      malloc_bytes_sample_time_ns_(0),
       native_objects_notified_(0),
       num_bytes_freed_revoke_(0),
       num_bytes_alive_after_gc_(0),
@@ -409,8 +429,12 @@ Heap::Heap(size_t initial_size,
       max_gc_requested_(0u),
       pending_collector_transition_(nullptr),
       pending_heap_trim_(nullptr),
+      pending_heap_trim_step_(nullptr),
       use_homogeneous_space_compaction_for_oom_(use_homogeneous_space_compaction_for_oom),
       use_generational_cc_(use_generational_cc),
+      use_generational_cmc_(use_generational_cmc),
+      use_numa_aware_regions_(use_numa_aware_regions),
+      use_huge_pages_(use_huge_pages),
       running_collection_is_blocking_(false),
       blocking_gc_count_(0U),
       blocking_gc_time_(0U),
@@ -649,15 +673,25 @@ Heap::Heap(size_t initial_size,
     CHECK(separate_non_moving_space);
     // Reserve twice the capacity, to allow evacuating every region for explicit GCs.
     MemMap region_space_mem_map =
-        space::RegionSpace::CreateMemMap(kRegionSpaceName, capacity_ * 2, request_begin);
+        space::RegionSpace::CreateMemMap(
+            kRegionSpaceName, capacity_ * 2, request_begin, use_huge_pages_);
     CHECK(region_space_mem_map.IsValid()) << "No region space mem map";
     region_space_ = space::RegionSpace::Create(
-        kRegionSpaceName, std::move(region_space_mem_map), use_generational_cc_);
+        kRegionSpaceName,
+        std::move(region_space_mem_map),
+        use_generational_cc_,
+        use_numa_aware_regions_);
     AddSpace(region_space_);
   } else if (IsMovingGc(foreground_collector_type_)) {
     // Create bump pointer spaces.
     // We only to create the bump pointer if the foreground collector is a compacting GC.
     // TODO: Place bump-pointer spaces somewhere to minimize size of card table.
+    // Mark-compact relies on normal pages being mapped in its moving space, so only advise huge
+    // pages for the semi-space collector's spaces.
+    const bool use_huge_pages = use_huge_pages_ && foreground_collector_type_ != kCollectorTypeCMC;
+    if (use_huge_pages) {
+      AdviseHugePages(&main_mem_map_1);
+    }
     bump_pointer_space_ = space::BumpPointerSpace::CreateFromMemMap("Bump pointer space 1",
                                                                     std::move(main_mem_map_1));
     CHECK(bump_pointer_space_ != nullptr) << "Failed to create bump pointer space";
@@ -665,6 +699,9 @@ Heap::Heap(size_t initial_size,
     // For Concurrent Mark-compact GC we don't need the temp space to be in
     // lower 4GB. So its temp space will be created by the GC itself.
     if (foreground_collector_type_ != kCollectorTypeCMC) {
+      if (use_huge_pages) {
+        AdviseHugePages(&main_mem_map_2);
+      }
       temp_space_ = space::BumpPointerSpace::CreateFromMemMap("Bump pointer space 2",
                                                               std::move(main_mem_map_2));
       CHECK(temp_space_ != nullptr) << "Failed to create bump pointer space";
@@ -701,6 +738,10 @@ Heap::Heap(size_t initial_size,
   } else if (large_object_space_type == space::LargeObjectSpaceType::kMap) {
     large_object_space_ = space::LargeObjectMapSpace::Create("mem map large object space");
     CHECK(large_object_space_ != nullptr) << "Failed to create large object space";
+  } else if (large_object_space_type == space::LargeObjectSpaceType::kSegregatedFreeList) {
+    large_object_space_ = space::SegregatedFreeListSpace::Create(
+        "segregated free list large object space", capacity_);
+    CHECK(large_object_space_ != nullptr) << "Failed to create large object space";
   } else {
     // Disable the large object space by making the cutoff excessively large.
     large_object_threshold_ = std::numeric_limits<size_t>::max();
@@ -729,7 +770,8 @@ Heap::Heap(size_t initial_size,
   // reserved by the kernel.
   static constexpr size_t kMinHeapAddress = 4 * KB;
   card_table_.reset(accounting::CardTable::Create(reinterpret_cast<uint8_t*>(kMinHeapAddress),
-                                                  4 * GB - kMinHeapAddress));
+                                                  4 * GB - kMinHeapAddress,
+                                                  use_huge_pages_));
   CHECK(card_table_.get() != nullptr) << "Failed to create card table";
   if (foreground_collector_type_ == kCollectorTypeCC && kUseTableLookupReadBarrier) {
     rb_table_.reset(new accounting::ReadBarrierTable());
@@ -856,6 +898,11 @@ Heap::Heap(size_t initial_size,
     // Disable the Java Heap Profiler.
     GetHeapSampler().DisableHeapSampler();
   }
+  if (runtime->GetAllocationSiteProfilingInterval() != 0) {
+    allocation_site_profiler_.reset(
+        new AllocationSiteProfiler(runtime->GetAllocationSiteProfilingInterval()));
+    GetHeapSampler().EnableAllocationSiteProfiler(allocation_site_profiler_.get());
+  }
 
   instrumentation::Instrumentation* const instrumentation = runtime->GetInstrumentation();
   if (gc_stress_mode_) {
@@ -1204,6 +1251,9 @@ void Heap::SetSpaceAsDefault(space::ContinuousSpace* continuous_space) {
     dlmalloc_space_ = continuous_space->AsDlMallocSpace();
   } else if (continuous_space->IsRosAllocSpace()) {
     rosalloc_space_ = continuous_space->AsRosAllocSpace();
+    // Threads revoke their buffers of the default space when they exit, which also flushes the
+    // magazines.
+    rosalloc_space_->GetRosAlloc()->EnableMagazines();
   }
 }
 
@@ -1325,12 +1375,23 @@ void Heap::DumpGcPerformanceInfo(std::ostream& os) {
   if (kDumpRosAllocStatsOnSigQuit && rosalloc_space_ != nullptr) {
     rosalloc_space_->DumpStats(os);
   }
+  for (const space::ContinuousSpace* space : continuous_spaces_) {
+    if (space->GetTrimmedBytes() != 0) {
+      os << "Bytes trimmed from " << space->GetName() << ": "
+         << PrettySize(space->GetTrimmedBytes()) << "\n";
+    }
+  }
+  if (large_object_space_ != nullptr && large_object_space_->GetTrimmedBytes() != 0) {
+    os << "Bytes trimmed from " << large_object_space_->GetName() << ": "
+       << PrettySize(large_object_space_->GetTrimmedBytes()) << "\n";
+  }
 
   os << "Native bytes total: " << GetNativeBytes()
      << " registered: " << native_bytes_registered_.load(std::memory_order_relaxed) << "\n";
 
   os << "Total native bytes at last GC: "
      << old_native_bytes_allocated_.load(std::memory_order_relaxed) << "\n";
+  reference_processor_->DumpClearedReferenceStats(os);
 
   BaseMutex::DumpAll(os);
 }
@@ -1698,6 +1759,15 @@ void Heap::TrimSpaces(Thread* self) {
   StartGC(self, kGcCauseTrim, kCollectorTypeHeapTrim);
   ScopedTrace trace(__PRETTY_FUNCTION__);
   const uint64_t start_ns = NanoTime();
+  const size_t max_bytes_per_space =
+      CareAboutPauseTimes() ? kHeapTrimStepBytes : std::numeric_limits<size_t>::max();
+  // Whether a space released a whole step, and may have more to release.
+  bool pages_remain = false;
+  auto record_trim = [&](space::Space* space, size_t reclaimed) {
+    space->trimmed_bytes_.fetch_add(reclaimed, std::memory_order_relaxed);
+    pages_remain = pages_remain || reclaimed >= max_bytes_per_space;
+    return reclaimed;
+  };
   // Trim the managed spaces.
   uint64_t total_alloc_space_allocated = 0;
   uint64_t total_alloc_space_size = 0;
@@ -1710,12 +1780,18 @@ void Heap::TrimSpaces(Thread* self) {
         if (malloc_space->IsRosAllocSpace() || !CareAboutPauseTimes()) {
           // Don't trim dlmalloc spaces if we care about pauses since this can hold the space lock
           // for a long period of time.
-          managed_reclaimed += malloc_space->Trim();
+          managed_reclaimed +=
+              record_trim(malloc_space, malloc_space->Trim(max_bytes_per_space));
         }
         total_alloc_space_size += malloc_space->Size();
       }
     }
   }
+  if (large_object_space_ != nullptr) {
+    // Release the pages of the free large object runs kept for reuse.
+    managed_reclaimed +=
+        record_trim(large_object_space_, large_object_space_->Trim(max_bytes_per_space));
+  }
   total_alloc_space_allocated = GetBytesAllocated();
   if (large_object_space_ != nullptr) {
     total_alloc_space_allocated -= large_object_space_->GetBytesAllocated();
@@ -1735,6 +1811,9 @@ void Heap::TrimSpaces(Thread* self) {
   VLOG(heap) << "Heap trim of managed (duration=" << PrettyDuration(gc_heap_end_ns - start_ns)
       << ", advised=" << PrettySize(managed_reclaimed) << ") heap. Managed heap utilization of "
       << static_cast<int>(100 * managed_utilization) << "%.";
+  if (pages_remain) {
+    RequestTrimStep(self);
+  }
 }
 
 bool Heap::IsValidObjectAddress(const void* addr) const {
@@ -2312,6 +2391,9 @@ void Heap::ChangeCollector(CollectorType collector_type) {
         break;
       }
       case kCollectorTypeCMC: {
+        if (use_generational_cmc_) {
+          gc_plan_.push_back(collector::kGcTypeSticky);
+        }
         gc_plan_.push_back(collector::kGcTypeFull);
         if (use_tlab_) {
           ChangeAllocator(kAllocatorTypeTLAB);
@@ -2485,7 +2567,7 @@ void Heap::PreZygoteFork() {
     CollectGarbageInternal(collector::kGcTypeFull, kGcCauseBackground, false, GC_NUM_ANY);
     // Trim the pages at the end of the non moving space. Trim while not holding zygote lock since
     // the trim process may require locking the mutator lock.
-    non_moving_space_->Trim();
+    non_moving_space_->Trim(std::numeric_limits<size_t>::max());
   }
   // We need to close userfaultfd fd for app/webview zygotes to avoid getattr
   // (stat) on the fd during fork.
@@ -2553,6 +2635,11 @@ void Heap::PreZygoteFork() {
         region_space_->GetMarkBitmap()->Clear();
       } else {
         bump_pointer_space_->GetMemMap()->Protect(PROT_READ | PROT_WRITE);
+        if (collector_type_ == kCollectorTypeCMC) {
+          // Everything was evacuated out of the moving space, so the old
+          // generation recorded by the previous cycle no longer exists.
+          mark_compact_->ResetGenerations();
+        }
       }
     }
     if (temp_space_ != nullptr) {
@@ -2738,6 +2825,8 @@ size_t Heap::GetNativeBytes() {
   // disable GC triggering based on malloc().
   malloc_bytes = 1000;
 #endif
+  sampled_malloc_bytes_.store(malloc_bytes, std::memory_order_relaxed);
+  malloc_bytes_sample_time_ns_.store(NanoTime(), std::memory_order_relaxed);
   return malloc_bytes + native_bytes_registered_.load(std::memory_order_relaxed);
   // An alternative would be to get RSS from /proc/self/statm. Empirically, that's no
   // more expensive, and it would allow us to count memory allocated by means other than malloc.
@@ -2745,6 +2834,22 @@ size_t Heap::GetNativeBytes() {
   // other things. It seems risky to trigger GCs as a result of such changes.
 }
 
+// mallinfo() walks allocator state and gets slow with large native heaps, while
+// CheckGCForNative() may run every kNotifyNativeInterval allocations on each thread. Checks that
+// come less than this long after a sample reuse it.
+static constexpr uint64_t kMallocBytesSampleIntervalNs = MsToNs(2);
+
+size_t Heap::GetSampledNativeBytes(/*out*/ bool* fresh) {
+  uint64_t sample_time_ns = malloc_bytes_sample_time_ns_.load(std::memory_order_relaxed);
+  if (NanoTime() - sample_time_ns >= kMallocBytesSampleIntervalNs) {
+    *fresh = true;
+    return GetNativeBytes();
+  }
+  *fresh = false;
+  return sampled_malloc_bytes_.load(std::memory_order_relaxed) +
+         native_bytes_registered_.load(std::memory_order_relaxed);
+}
+
 static inline bool GCNumberLt(uint32_t gc_num1, uint32_t gc_num2) {
   // unsigned comparison, assuming a non-huge difference, but dealing correctly with wrapping.
   uint32_t difference = gc_num2 - gc_num1;
@@ -2840,6 +2945,9 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
           collector = semi_space_collector_;
           break;
         case kCollectorTypeCMC:
+          // With generational CMC the same collector instance runs both young
+          // (sticky) and full cycles.
+          mark_compact_->SetYoungGen(use_generational_cmc_ && gc_type == collector::kGcTypeSticky);
           collector = mark_compact_;
           break;
         case kCollectorTypeCC:
@@ -2887,6 +2995,7 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
     RequestTrim(self);
     // Collect cleared references.
     clear = reference_processor_->CollectClearedReferences(self);
+    UpdatePauseTargetState(gc_cause);
     // Grow the heap so that we know when to perform the next GC.
     GrowForUtilization(collector, bytes_allocated_before_gc);
     old_native_bytes_allocated_.store(GetNativeBytes());
@@ -2910,6 +3019,27 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
   return gc_type;
 }
 
+void Heap::UpdatePauseTargetState(GcCause gc_cause) {
+  if (pause_target_ == 0) {
+    return;
+  }
+  // GC for alloc pauses the allocating thread, so consider it as a pause.
+  bool missed = gc_cause == kGcCauseForAlloc &&
+      GetCurrentGcIteration()->GetDurationNs() > pause_target_;
+  for (uint64_t pause : GetCurrentGcIteration()->GetPauseTimes()) {
+    missed = missed || pause > pause_target_;
+  }
+  if (missed) {
+    Runtime::Current()->GetMetrics()->GcPauseTargetMissCount()->AddOne();
+    pause_target_reserve_scale_ =
+        std::min(pause_target_reserve_scale_ * 2, kMaxPauseTargetReserveScale);
+    VLOG(heap) << "GC missed pause target of " << PrettyDuration(pause_target_)
+               << ", concurrent reserve scale now " << pause_target_reserve_scale_;
+  } else if (pause_target_reserve_scale_ > 1) {
+    --pause_target_reserve_scale_;
+  }
+}
+
 void Heap::LogGC(GcCause gc_cause, collector::GarbageCollector* collector) {
   const size_t duration = GetCurrentGcIteration()->GetDurationNs();
   const std::vector<uint64_t>& pause_times = GetCurrentGcIteration()->GetPauseTimes();
@@ -2970,6 +3100,11 @@ void Heap::FinishGC(Thread* self, collector::GcType gc_type) {
       ++blocking_gc_count_;
       blocking_gc_time_ += GetCurrentGcIteration()->GetDurationNs();
       ++blocking_gc_count_last_window_;
+      if (last_gc_cause_ == kGcCauseForAlloc) {
+        metrics::ArtMetrics* metrics = Runtime::Current()->GetMetrics();
+        metrics->GcForAllocBlockingCount()->AddOne();
+        metrics->GcForAllocBlockingTime()->Add(NsToMs(GetCurrentGcIteration()->GetDurationNs()));
+      }
     }
     // Update the gc count rate histograms if due.
     UpdateGcCountRateHistograms();
@@ -3708,6 +3843,9 @@ void Heap::DumpForSigQuit(std::ostream& os) {
     }
   }
   DumpGcPerformanceInfo(os);
+  if (allocation_site_profiler_ != nullptr) {
+    allocation_site_profiler_->Dump(os);
+  }
 }
 
 size_t Heap::GetPercentFree() {
@@ -3735,6 +3873,22 @@ bool Heap::IsMovableObject(ObjPtr<mirror::Object> obj) const {
   return false;
 }
 
+bool Heap::TryPinObject(ObjPtr<mirror::Object> obj) {
+  // Only the concurrent copying collector supports pinning, by not evacuating the region.
+  // TODO: Pin pages for the concurrent mark-compact collector.
+  if (!gUseReadBarrier || region_space_ == nullptr || !region_space_->HasAddress(obj.Ptr())) {
+    return false;
+  }
+  return region_space_->TryPinObject(obj.Ptr());
+}
+
+bool Heap::UnpinObject(ObjPtr<mirror::Object> obj) {
+  if (!gUseReadBarrier || region_space_ == nullptr || !region_space_->HasAddress(obj.Ptr())) {
+    return false;
+  }
+  return region_space_->UnpinObject(obj.Ptr());
+}
+
 collector::GarbageCollector* Heap::FindCollectorByGcType(collector::GcType gc_type) {
   for (auto* collector : garbage_collectors_) {
     if (collector->GetCollectorType() == collector_type_ &&
@@ -3789,7 +3943,19 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
       }
       CHECK(non_sticky_collector != nullptr);
     }
-    double sticky_gc_throughput_adjustment = GetStickyGcThroughputAdjustment(use_generational_cc_);
+    uint64_t non_sticky_gc_throughput;
+    size_t non_sticky_gc_iterations;
+    if (use_generational_cmc_ && collector_type_ == kCollectorTypeCMC) {
+      // Young and full CMC cycles are run by the same collector instance, so
+      // compare against the throughput of its full cycles only.
+      non_sticky_gc_throughput = mark_compact_->GetEstimatedFullGcThroughput();
+      non_sticky_gc_iterations = mark_compact_->NumberOfFullIterations();
+    } else {
+      non_sticky_gc_throughput = non_sticky_collector->GetEstimatedMeanThroughput();
+      non_sticky_gc_iterations = non_sticky_collector->NumberOfIterations();
+    }
+    double sticky_gc_throughput_adjustment =
+        GetStickyGcThroughputAdjustment(use_generational_cc_ || use_generational_cmc_);
 
     // If the throughput of the current sticky GC >= throughput of the non sticky collector, then
     // do another sticky collection next.
@@ -3799,8 +3965,8 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
     // if the sticky GC throughput always remained >= the full/partial throughput.
     size_t target_footprint = target_footprint_.load(std::memory_order_relaxed);
     if (current_gc_iteration_.GetEstimatedThroughput() * sticky_gc_throughput_adjustment >=
-        non_sticky_collector->GetEstimatedMeanThroughput() &&
-        non_sticky_collector->NumberOfIterations() > 0 &&
+        non_sticky_gc_throughput &&
+        non_sticky_gc_iterations > 0 &&
         bytes_allocated <= (IsGcConcurrent() ? concurrent_start_bytes_ : target_footprint)) {
       next_gc_type_ = collector::kGcTypeSticky;
     } else {
@@ -3847,10 +4013,19 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
       const size_t bytes_allocated_during_gc =
           UnsignedDifference(bytes_allocated + freed_bytes, bytes_allocated_before_gc);
       // Calculate when to perform the next ConcurrentGC.
-      // Estimate how many remaining bytes we will have when we need to start the next GC.
+      // Estimate how many remaining bytes we will have when we need to start the next GC: the
+      // bytes allocated during a concurrent GC at the recent allocation rate, or, until that is
+      // known, the bytes allocated during this GC.
       size_t remaining_bytes = bytes_allocated_during_gc;
+      const uint64_t predicted_bytes = PredictBytesAllocatedDuringConcurrentGc();
+      if (predicted_bytes != 0) {
+        remaining_bytes = std::min<uint64_t>(predicted_bytes, std::numeric_limits<size_t>::max());
+      }
       remaining_bytes = std::min(remaining_bytes, kMaxConcurrentRemainingBytes);
       remaining_bytes = std::max(remaining_bytes, kMinConcurrentRemainingBytes);
+      // If recent GCs missed the pause target, start the next one earlier so that it is less
+      // likely to end in a blocking GC for alloc.
+      remaining_bytes *= pause_target_reserve_scale_;
       size_t target_footprint = target_footprint_.load(std::memory_order_relaxed);
       if (UNLIKELY(remaining_bytes > target_footprint)) {
         // A never going to happen situation that from the estimated allocation rate we will exceed
@@ -3873,6 +4048,40 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
   }
 }
 
+uint64_t Heap::PredictBytesAllocatedDuringConcurrentGc() {
+  constexpr double kNsPerSecond = MsToNs(1000);
+  auto update_average = [](double average, double sample) {
+    return average == 0.0
+        ? sample
+        : average * (1.0 - kGcPredictionSampleWeight) + sample * kGcPredictionSampleWeight;
+  };
+  // Only GCs that ran concurrently with the allocating threads tell how long they take to run.
+  const GcCause gc_cause = GetCurrentGcIteration()->GetGcCause();
+  if (gc_cause != kGcCauseForAlloc && gc_cause != kGcCauseExplicit) {
+    concurrent_gc_duration_average_ns_ = static_cast<uint64_t>(update_average(
+        concurrent_gc_duration_average_ns_, GetCurrentGcIteration()->GetDurationNs()));
+  }
+  // The allocation rate since the end of the previous GC, including during this GC.
+  const uint64_t now_ns = NanoTime();
+  const uint64_t bytes_allocated_ever = GetBytesAllocatedEver();
+  double allocation_rate = 0.0;
+  if (last_grow_time_ns_ != 0 &&
+      now_ns > last_grow_time_ns_ &&
+      bytes_allocated_ever > last_grow_bytes_allocated_ever_) {
+    allocation_rate = static_cast<double>(bytes_allocated_ever - last_grow_bytes_allocated_ever_) *
+        kNsPerSecond / (now_ns - last_grow_time_ns_);
+    allocation_rate_average_ = update_average(allocation_rate_average_, allocation_rate);
+  }
+  last_grow_time_ns_ = now_ns;
+  last_grow_bytes_allocated_ever_ = bytes_allocated_ever;
+  if (allocation_rate_average_ == 0.0 || concurrent_gc_duration_average_ns_ == 0) {
+    return 0;
+  }
+  // Follow bursts right away rather than at the pace of the average.
+  const double rate = std::max(allocation_rate_average_, allocation_rate);
+  return static_cast<uint64_t>(rate * concurrent_gc_duration_average_ns_ / kNsPerSecond);
+}
+
 void Heap::ClampGrowthLimit() {
   // Use heap bitmap lock to guard against races with BindLiveToMarkBitmap.
   ScopedObjectAccess soa(Thread::Current());
@@ -4090,6 +4299,38 @@ void Heap::ClearPendingTrim(Thread* self) {
   pending_heap_trim_ = nullptr;
 }
 
+// Continues the trim of the spaces by a HeapTrimTask, without the other trimming work.
+class Heap::HeapTrimStepTask : public HeapTask {
+ public:
+  explicit HeapTrimStepTask(uint64_t delta_time) : HeapTask(NanoTime() + delta_time) { }
+  void Run(Thread* self) override {
+    gc::Heap* heap = Runtime::Current()->GetHeap();
+    heap->ClearPendingTrimStep(self);
+    heap->TrimSpaces(self);
+  }
+};
+
+void Heap::ClearPendingTrimStep(Thread* self) {
+  MutexLock mu(self, *pending_task_lock_);
+  pending_heap_trim_step_ = nullptr;
+}
+
+void Heap::RequestTrimStep(Thread* self) {
+  if (!CanAddHeapTask(self)) {
+    return;
+  }
+  HeapTrimStepTask* added_task = nullptr;
+  {
+    MutexLock mu(self, *pending_task_lock_);
+    if (pending_heap_trim_step_ != nullptr) {
+      return;
+    }
+    added_task = new HeapTrimStepTask(kHeapTrimStepWait);
+    pending_heap_trim_step_ = added_task;
+  }
+  task_processor_->AddTask(self, added_task);
+}
+
 void Heap::RequestTrim(Thread* self) {
   if (!CanAddHeapTask(self)) {
     return;
@@ -4216,8 +4457,14 @@ inline float Heap::NativeMemoryOverTarget(size_t current_native_bytes, bool is_g
 inline void Heap::CheckGCForNative(Thread* self) {
   bool is_gc_concurrent = IsGcConcurrent();
   uint32_t starting_gc_num = GetCurrentGcNum();
-  size_t current_native_bytes = GetNativeBytes();
+  bool fresh;
+  size_t current_native_bytes = GetSampledNativeBytes(&fresh);
   float gc_urgency = NativeMemoryOverTarget(current_native_bytes, is_gc_concurrent);
+  if (UNLIKELY(gc_urgency >= 1.0) && !fresh) {
+    // Only the common under-target check may use a sample; decide to collect on current data.
+    current_native_bytes = GetNativeBytes();
+    gc_urgency = NativeMemoryOverTarget(current_native_bytes, is_gc_concurrent);
+  }
   if (UNLIKELY(gc_urgency >= 1.0)) {
     if (is_gc_concurrent) {
       bool requested =
@@ -4441,6 +4688,37 @@ void Heap::JHPCheckNonTlabSampleAllocation(Thread* self, mirror::Object* obj, si
   VLOG(heap) << "JHP:NonTlab Non-moving or Large Allocation or RegisterNativeAllocation";
 }
 
+size_t Heap::GetAdaptiveTlabSize(Thread* self, size_t default_size) {
+  if (!kUseAdaptiveTlabSizing) {
+    return default_size;
+  }
+  uint32_t gc_num = GetCurrentGcNum();
+  if (self->GetTlabSizingGcNum() != gc_num) {
+    // At least one GC happened since the last adjustment. Move half way
+    // towards the size that matches the allocation rate of the last interval,
+    // so that a single burst (or idle period) doesn't swing the size too much.
+    size_t old_size = self->GetTlabTargetSize() == 0 ? default_size : self->GetTlabTargetSize();
+    size_t rate_size = self->GetTlabBytesSinceGc() / kTargetTlabRefillsPerGc;
+    size_t new_size = std::clamp(RoundUp((old_size + rate_size) / 2, kObjectAlignment),
+                                 kMinAdaptiveTlabSize,
+                                 kMaxAdaptiveTlabSize);
+    self->SetTlabTargetSize(new_size, gc_num);
+  }
+  size_t target_size = self->GetTlabTargetSize();
+  return target_size == 0 ? default_size : target_size;
+}
+
+void Heap::RecordTlabRefill(Thread* self, size_t bytes) {
+  self->AddTlabBytesSinceGc(bytes);
+  Runtime::Current()->GetMetrics()->TlabRefillCount()->AddOne();
+}
+
+void Heap::RecordTlabWaste(size_t bytes) {
+  if (bytes > 0) {
+    Runtime::Current()->GetMetrics()->TlabWastedBytes()->Add(bytes);
+  }
+}
+
 size_t Heap::JHPCalculateNextTlabSize(Thread* self,
                                       size_t jhp_def_tlab_size,
                                       size_t alloc_size,
@@ -4554,10 +4832,11 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
     // There is enough space if we grow the TLAB. Lets do that. This increases the
     // TLAB bytes.
     const size_t min_expand_size = alloc_size - self->TlabSize();
+    size_t partial_tlab_size = GetAdaptiveTlabSize(self, kPartialTlabSize);
     size_t next_tlab_size =
         jhp_enabled ? JHPCalculateNextTlabSize(
-                          self, kPartialTlabSize, alloc_size, &take_sample, &bytes_until_sample) :
-                      kPartialTlabSize;
+                          self, partial_tlab_size, alloc_size, &take_sample, &bytes_until_sample) :
+                      partial_tlab_size;
     const size_t expand_bytes = std::max(
         min_expand_size,
         std::min(self->TlabRemainingCapacity() - self->TlabSize(), next_tlab_size));
@@ -4573,7 +4852,8 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
     // TODO: for large allocations, which are rare, maybe we should allocate
     // that object and return. There is no need to revoke the current TLAB,
     // particularly if it's mostly unutilized.
-    size_t next_tlab_size = RoundDown(alloc_size + kDefaultTLABSize, gPageSize) - alloc_size;
+    size_t default_tlab_size = std::max(GetAdaptiveTlabSize(self, kDefaultTLABSize), gPageSize);
+    size_t next_tlab_size = RoundDown(alloc_size + default_tlab_size, gPageSize) - alloc_size;
     if (jhp_enabled) {
       next_tlab_size = JHPCalculateNextTlabSize(
           self, next_tlab_size, alloc_size, &take_sample, &bytes_until_sample);
@@ -4598,8 +4878,10 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
       if (LIKELY(!IsOutOfMemoryOnAllocation(allocator_type,
                                             space::RegionSpace::kRegionSize,
                                             grow))) {
-        size_t next_pr_tlab_size =
-            kUsePartialTlabs ? kPartialTlabSize : gc::space::RegionSpace::kRegionSize;
+        size_t next_pr_tlab_size = kUsePartialTlabs
+            ? std::min(GetAdaptiveTlabSize(self, kPartialTlabSize),
+                       gc::space::RegionSpace::kRegionSize)
+            : gc::space::RegionSpace::kRegionSize;
         if (jhp_enabled) {
           next_pr_tlab_size = JHPCalculateNextTlabSize(
               self, next_pr_tlab_size, alloc_size, &take_sample, &bytes_until_sample);
@@ -4650,6 +4932,7 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
       return nullptr;
     }
   }
+  RecordTlabRefill(self, *bytes_tl_bulk_allocated);
   // Refilled TLAB, return.
   ret = self->AllocTlab(alloc_size);
   DCHECK(ret != nullptr);
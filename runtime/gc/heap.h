@@ -51,6 +51,7 @@
 
 namespace art HIDDEN {
 
+class AllocationSiteProfiler;
 class ConditionVariable;
 enum class InstructionSet;
 class IsMarkedVisitor;
@@ -137,12 +138,25 @@ class Heap {
   static constexpr size_t kPartialTlabSize = 16 * KB;
   static constexpr bool kUsePartialTlabs = true;
 
+  // If true, scale each thread's TLAB size with its allocation rate between GCs.
+  static constexpr bool kUseAdaptiveTlabSizing = true;
+  // Number of TLAB refills per GC cycle adaptive TLAB sizing aims for.
+  static constexpr size_t kTargetTlabRefillsPerGc = 64;
+  // Bounds of the TLAB sizes chosen by adaptive TLAB sizing.
+  static constexpr size_t kMinAdaptiveTlabSize = 4 * KB;
+  static constexpr size_t kMaxAdaptiveTlabSize = 256 * KB;
+
   static constexpr size_t kDefaultInitialSize = 2 * MB;
   static constexpr size_t kDefaultMaximumSize = 256 * MB;
   static constexpr size_t kDefaultNonMovingSpaceCapacity = 64 * MB;
   static constexpr size_t kDefaultMaxFree = 32 * MB;
   static constexpr size_t kDefaultMinFree = kDefaultMaxFree / 4;
   static constexpr size_t kDefaultLongPauseLogThreshold = MsToNs(5);
+  // Upper bound for pause_target_reserve_scale_.
+  static constexpr size_t kMaxPauseTargetReserveScale = 8;
+  // Weight of the latest sample in the moving averages of the allocation rate and of the
+  // concurrent GC duration.
+  static constexpr double kGcPredictionSampleWeight = 0.25;
   static constexpr size_t kDefaultLongPauseLogThresholdGcStress = MsToNs(50);
   static constexpr size_t kDefaultLongGCLogThreshold = MsToNs(100);
   static constexpr size_t kDefaultLongGCLogThresholdGcStress = MsToNs(1000);
@@ -186,6 +200,11 @@ class Heap {
 
   // How often we allow heap trimming to happen (nanoseconds).
   static constexpr uint64_t kHeapTrimWait = MsToNs(5000);
+  // In jank perceptible process states, heap trims release at most about this many bytes of each
+  // space at a time, and wait this long before releasing more, so that the page faults of the
+  // reused pages do not come in a burst.
+  static constexpr size_t kHeapTrimStepBytes = 4 * MB;
+  static constexpr uint64_t kHeapTrimStepWait = MsToNs(100);
 
   // Starting size of DlMalloc/RosAlloc spaces.
   static size_t GetDefaultStartingSize() {
@@ -225,6 +244,7 @@ class Heap {
        bool low_memory_mode,
        size_t long_pause_threshold,
        size_t long_gc_threshold,
+       uint64_t pause_target,
        bool ignore_target_footprint,
        bool always_log_explicit_gcs,
        bool use_tlab,
@@ -238,6 +258,9 @@ class Heap {
        bool measure_gc_performance,
        bool use_homogeneous_space_compaction,
        bool use_generational_cc,
+       bool use_generational_cmc,
+       bool use_numa_aware_regions,
+       bool use_huge_pages,
        uint64_t min_interval_homogeneous_space_compaction_by_oom,
        bool dump_region_info_before_gc,
        bool dump_region_info_after_gc);
@@ -390,6 +413,13 @@ class Heap {
   EXPORT void IncrementDisableMovingGC(Thread* self) REQUIRES(!*gc_complete_lock_);
   EXPORT void DecrementDisableMovingGC(Thread* self) REQUIRES(!*gc_complete_lock_);
 
+  // Pin `obj` for a JNI critical section so that the concurrent copying collector does not
+  // move it, without blocking the thread flip. Returns false if the object cannot be pinned,
+  // in which case the caller must disable the thread flip (or moving GC) instead.
+  bool TryPinObject(ObjPtr<mirror::Object> obj) REQUIRES_SHARED(Locks::mutator_lock_);
+  // Release a pin taken by `TryPinObject()`. Returns false if `obj` is not pinned.
+  bool UnpinObject(ObjPtr<mirror::Object> obj) REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Temporarily disable thread flip for JNI critical calls.
   void IncrementDisableThreadFlip(Thread* self) REQUIRES(!*thread_flip_lock_);
   void DecrementDisableThreadFlip(Thread* self) REQUIRES(!*thread_flip_lock_);
@@ -573,6 +603,10 @@ class Heap {
     return use_generational_cc_;
   }
 
+  bool GetUseGenerationalCMC() const {
+    return use_generational_cmc_;
+  }
+
   // Returns the number of objects currently allocated.
   size_t GetObjectsAllocated() const
       REQUIRES(!Locks::heap_bitmap_lock_);
@@ -657,7 +691,7 @@ class Heap {
       REQUIRES(!*gc_complete_lock_, !*pending_task_lock_, !process_state_update_lock_);
 
   // Deflate monitors, ... and trim the spaces.
-  EXPORT void Trim(Thread* self) REQUIRES(!*gc_complete_lock_);
+  EXPORT void Trim(Thread* self) REQUIRES(!*gc_complete_lock_, !*pending_task_lock_);
 
   void RevokeThreadLocalBuffers(Thread* thread);
   void RevokeRosAllocThreadLocalBuffers(Thread* thread);
@@ -913,6 +947,11 @@ class Heap {
     return heap_sampler_;
   }
 
+  // Returns the allocation site profiler, or null if it is not enabled.
+  AllocationSiteProfiler* GetAllocationSiteProfiler() const {
+    return allocation_site_profiler_.get();
+  }
+
   void InitPerfettoJavaHeapProf();
   // In NonTlab case: Check whether we should report a sample allocation and if so report it.
   // Also update state (bytes_until_sample).
@@ -929,6 +968,16 @@ class Heap {
   // Reduce the number of bytes to the next sample position by this adjustment.
   void AdjustSampleOffset(size_t adjustment);
 
+  // Return the size `self` should use for its next TLAB (or partial TLAB
+  // expansion) instead of `default_size`. Once per GC cycle the size is moved
+  // towards what the thread's TLAB allocations since the previous adjustment
+  // would have needed to take about kTargetTlabRefillsPerGc refills.
+  EXPORT size_t GetAdaptiveTlabSize(Thread* self, size_t default_size);
+  // Record that `self` took `bytes` for a new or expanded TLAB.
+  void RecordTlabRefill(Thread* self, size_t bytes);
+  // Record `bytes` left unused in a TLAB which is being revoked.
+  void RecordTlabWaste(size_t bytes);
+
   // Allocation tracking support
   // Callers to this function use double-checked locking to ensure safety on allocation_records_
   bool IsAllocTrackingEnabled() const {
@@ -1030,6 +1079,7 @@ class Heap {
   class ConcurrentGCTask;
   class CollectorTransitionTask;
   class HeapTrimTask;
+  class HeapTrimStepTask;
   class TriggerPostForkCCGcTask;
   class ReduceTargetFootprintTask;
 
@@ -1040,6 +1090,9 @@ class Heap {
       REQUIRES(Locks::mutator_lock_);
 
   void LogGC(GcCause gc_cause, collector::GarbageCollector* collector);
+  // Compare the pauses of the GC that just finished against the pause target (if any) and adjust
+  // how early the next concurrent GC is started.
+  void UpdatePauseTargetState(GcCause gc_cause);
   void StartGC(Thread* self, GcCause cause, CollectorType collector_type)
       REQUIRES(!*gc_complete_lock_);
   void StartGCRunnable(Thread* self, GcCause cause, CollectorType collector_type)
@@ -1224,6 +1277,11 @@ class Heap {
                                                   const char* name,
                                                   bool can_move_objects);
 
+  // Update the moving averages of the allocation rate and of the concurrent GC duration after a
+  // concurrent GC, and return the bytes expected to be allocated during the next one, or 0 if
+  // they are not known yet. Called by GrowForUtilization().
+  uint64_t PredictBytesAllocatedDuringConcurrentGc();
+
   // Given the current contents of the alloc space, increase the allowed heap footprint to match
   // the target utilization ratio.  This should only be called immediately after a full garbage
   // collection. bytes_allocated_before_gc is used to measure bytes / second for the period which
@@ -1262,6 +1320,9 @@ class Heap {
           REQUIRES(!*gc_complete_lock_, !*pending_task_lock_, !process_state_update_lock_);
 
   void ClearPendingTrim(Thread* self) REQUIRES(!*pending_task_lock_);
+  void ClearPendingTrimStep(Thread* self) REQUIRES(!*pending_task_lock_);
+  // Request a trim of the spaces after `kHeapTrimStepWait`, for the pages TrimSpaces() left.
+  void RequestTrimStep(Thread* self) REQUIRES(!*pending_task_lock_);
   void ClearPendingCollectorTransition(Thread* self) REQUIRES(!*pending_task_lock_);
 
   // What kind of concurrency behavior is the runtime after?
@@ -1273,8 +1334,10 @@ class Heap {
         collector_type_ == kCollectorTypeCMCBackground;
   }
 
-  // Trim the managed and native spaces by releasing unused memory back to the OS.
-  void TrimSpaces(Thread* self) REQUIRES(!*gc_complete_lock_);
+  // Trim the managed and native spaces by releasing unused memory back to the OS. In jank
+  // perceptible process states, only release a step of `kHeapTrimStepBytes` per space and
+  // request another trim step if some space may have more.
+  void TrimSpaces(Thread* self) REQUIRES(!*gc_complete_lock_, !*pending_task_lock_);
 
   // Trim 0 pages at the end of reference tables.
   void TrimIndirectReferenceTables(Thread* self);
@@ -1325,9 +1388,15 @@ class Heap {
 
   // Return our best approximation of the number of bytes of native memory that
   // are currently in use, and could possibly be reclaimed as an indirect result
-  // of a garbage collection.
+  // of a garbage collection. Also refreshes the sample used by GetSampledNativeBytes().
   size_t GetNativeBytes();
 
+  // Like GetNativeBytes(), but reuses the malloc statistics sampled by a recent call instead of
+  // querying the allocator again, if they are less than kMallocBytesSampleIntervalNs old.
+  // Registered native bytes are always current. Sets `*fresh` to whether the allocator was
+  // queried.
+  size_t GetSampledNativeBytes(/*out*/ bool* fresh);
+
   // Set concurrent_start_bytes_ to a reasonable guess, given target_footprint_ .
   void SetDefaultConcurrentStartBytes() REQUIRES(!*gc_complete_lock_);
   // This version assumes no concurrent updaters.
@@ -1400,6 +1469,24 @@ class Heap {
   // If we get a GC longer than long GC log threshold, then we print out the GC after it finishes.
   const size_t long_gc_log_threshold_;
 
+  // Soft upper bound for GC pauses in ns; 0 if no pause target was requested.
+  const uint64_t pause_target_;
+
+  // Multiplier applied to the bytes reserved for allocation during a concurrent GC. Grows when a
+  // GC misses the pause target so that the next concurrent GC starts earlier, and decays back to
+  // 1 while pauses stay within the target. Only accessed by the thread running the GC.
+  size_t pause_target_reserve_scale_;
+
+  // Moving averages of the allocation rate, in bytes per second, and of the duration of
+  // concurrent GCs, used to start concurrent GCs so that they finish just before the soft limit.
+  // 0 until measured. Only accessed by the thread running the GC.
+  double allocation_rate_average_;
+  uint64_t concurrent_gc_duration_average_ns_;
+  // The time and GetBytesAllocatedEver() at the end of the last GrowForUtilization(), from which
+  // the allocation rate is measured.
+  uint64_t last_grow_time_ns_;
+  uint64_t last_grow_bytes_allocated_ever_;
+
   // Starting time of the new process; meant to be used for measuring total process CPU time.
   uint64_t process_cpu_start_time_ns_;
 
@@ -1517,6 +1604,11 @@ class Heap {
   // Approximately the smallest value of GetNativeBytes() we've seen since the last GC.
   Atomic<size_t> old_native_bytes_allocated_;
 
+  // The malloc part of the last GetNativeBytes() and when it was taken, for
+  // GetSampledNativeBytes().
+  Atomic<size_t> sampled_malloc_bytes_;
+  Atomic<uint64_t> malloc_bytes_sample_time_ns_;
+
   // Total number of native objects of which we were notified since the beginning of time, mod 2^32.
   // Allows us to check for GC only roughly every kNotifyNativeInterval allocations.
   Atomic<uint32_t> native_objects_notified_;
@@ -1682,6 +1774,7 @@ class Heap {
   // Active tasks which we can modify (change target time, desired collector type, etc..).
   CollectorTransitionTask* pending_collector_transition_ GUARDED_BY(pending_task_lock_);
   HeapTrimTask* pending_heap_trim_ GUARDED_BY(pending_task_lock_);
+  HeapTrimStepTask* pending_heap_trim_step_ GUARDED_BY(pending_task_lock_);
 
   // Whether or not we use homogeneous space compaction to avoid OOM errors.
   bool use_homogeneous_space_compaction_for_oom_;
@@ -1691,6 +1784,23 @@ class Heap {
   // for major collections. Set in Heap constructor.
   const bool use_generational_cc_;
 
+  // If true, enable generational collection when using the userfaultfd-based
+  // Mark-Compact (CMC) collector, i.e. use young-generation CMC cycles for
+  // minor collections and full CMC for major collections. Set in Heap
+  // constructor.
+  const bool use_generational_cmc_;
+
+  // If true, the region space (CC collector) binds its regions to NUMA nodes
+  // and prefers regions local to the allocating thread. Set in Heap
+  // constructor.
+  const bool use_numa_aware_regions_;
+
+  // If true, the region space, the bump pointer spaces of the semi-space
+  // collector and the card table are backed by transparent huge pages. The
+  // moving space of the CMC collector is not, see MarkCompact::MarkCompact().
+  // Set in Heap constructor.
+  const bool use_huge_pages_;
+
   // True if the currently running collection has made some thread wait.
   bool running_collection_is_blocking_ GUARDED_BY(gc_complete_lock_);
   // The number of blocking GC runs.
@@ -1723,6 +1833,9 @@ class Heap {
   // Perfetto Java Heap Profiler support.
   HeapSampler heap_sampler_;
 
+  // Aggregates the samples of heap_sampler_ by allocation site, if enabled.
+  std::unique_ptr<AllocationSiteProfiler> allocation_site_profiler_;
+
   // GC stress related data structures.
   Mutex* backtrace_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   // Debugging variables, seen backtraces vs unique backtraces.
@@ -258,6 +258,34 @@ TEST_F(HeapTest, GCMetrics) {
   }
 }
 
+TEST_F(HeapTest, AdaptiveTlabSize) {
+  if (!Heap::kUseAdaptiveTlabSizing) {
+    GTEST_SKIP() << "Adaptive TLAB sizing is disabled";
+  }
+  Thread* self = Thread::Current();
+  Heap* heap = Runtime::Current()->GetHeap();
+  constexpr size_t kDefaultSize = Heap::kDefaultTLABSize;
+  uint32_t gc_num = heap->GetCurrentGcNum();
+
+  // Without a GC since the last adjustment, the size is left alone.
+  self->SetTlabTargetSize(0u, gc_num);
+  self->AddTlabBytesSinceGc(Heap::kTargetTlabRefillsPerGc * Heap::kMaxAdaptiveTlabSize);
+  EXPECT_EQ(kDefaultSize, heap->GetAdaptiveTlabSize(self, kDefaultSize));
+
+  // A thread which allocated a lot since the last GC gets a bigger TLAB.
+  self->SetTlabTargetSize(0u, gc_num - 1);
+  self->AddTlabBytesSinceGc(Heap::kTargetTlabRefillsPerGc * Heap::kMaxAdaptiveTlabSize);
+  EXPECT_GT(heap->GetAdaptiveTlabSize(self, kDefaultSize), kDefaultSize);
+  EXPECT_LE(heap->GetAdaptiveTlabSize(self, kDefaultSize), Heap::kMaxAdaptiveTlabSize);
+
+  // An idle thread gets a smaller one.
+  self->SetTlabTargetSize(kDefaultSize, gc_num - 1);
+  EXPECT_LT(heap->GetAdaptiveTlabSize(self, kDefaultSize), kDefaultSize);
+  EXPECT_GE(heap->GetAdaptiveTlabSize(self, kDefaultSize), Heap::kMinAdaptiveTlabSize);
+
+  self->SetTlabTargetSize(0u, heap->GetCurrentGcNum());
+}
+
 class ZygoteHeapTest : public CommonRuntimeTest {
  public:
   ZygoteHeapTest() {
@@ -16,13 +16,19 @@
 
 #include "reference_processor.h"
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "art_field-inl.h"
+#include "base/histogram-inl.h"
 #include "base/mutex.h"
 #include "base/time_utils.h"
 #include "base/utils.h"
 #include "base/systrace.h"
 #include "class_root-inl.h"
 #include "collector/garbage_collector.h"
+#include "heap.h"
 #include "jni/java_vm_ext.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
@@ -41,6 +47,51 @@ namespace gc {
 
 static constexpr bool kAsyncReferenceQueueAdd = false;
 
+// Minimum number of references each thread-pool task clears in ClearWhiteReferences(). Shorter
+// queues are processed by the GC thread alone.
+static constexpr size_t kMinReferencesPerTask = 1024;
+
+// Maximum number of cleared references handed to ReferenceQueue.add() at a time. Each call
+// wakes up the Java reference queue daemon, which can then start enqueuing and finalizing the
+// first batch while the following ones are still being handed over.
+static constexpr size_t kClearedReferenceBatchSize = 4096;
+
+class ReferenceProcessor::ClearWhiteReferencesTask : public Task {
+ public:
+  // References are passed as raw pointers as an ObjPtr must not be used across threads.
+  ClearWhiteReferencesTask(ReferenceQueue* queue,
+                           collector::GarbageCollector* collector,
+                           mirror::Reference* const* begin,
+                           mirror::Reference* const* end,
+                           bool report_cleared)
+      : queue_(queue),
+        collector_(collector),
+        begin_(begin),
+        end_(end),
+        report_cleared_(report_cleared),
+        cleared_references_(Locks::reference_queue_cleared_references_lock_) {}
+
+  // Runs while the GC thread holds the mutator lock on our behalf.
+  void Run([[maybe_unused]] Thread* self) override NO_THREAD_SAFETY_ANALYSIS {
+    for (mirror::Reference* const* it = begin_; it != end_; ++it) {
+      queue_->ClearWhiteReferent(*it, &cleared_references_, collector_, report_cleared_);
+    }
+  }
+
+  ReferenceQueue* GetClearedReferences() {
+    return &cleared_references_;
+  }
+
+ private:
+  ReferenceQueue* const queue_;
+  collector::GarbageCollector* const collector_;
+  mirror::Reference* const* const begin_;
+  mirror::Reference* const* const end_;
+  const bool report_cleared_;
+  // Not shared with other threads, so never locked.
+  ReferenceQueue cleared_references_;
+};
+
 ReferenceProcessor::ReferenceProcessor()
     : collector_(nullptr),
       condition_("reference processor condition", *Locks::reference_processor_lock_) ,
@@ -48,7 +99,10 @@ ReferenceProcessor::ReferenceProcessor()
       weak_reference_queue_(Locks::reference_queue_weak_references_lock_),
       finalizer_reference_queue_(Locks::reference_queue_finalizer_references_lock_),
       phantom_reference_queue_(Locks::reference_queue_phantom_references_lock_),
-      cleared_references_(Locks::reference_queue_cleared_references_lock_) {
+      cleared_references_(Locks::reference_queue_cleared_references_lock_),
+      cleared_reference_stats_lock_("cleared reference stats lock", kGenericBottomLock),
+      cleared_reference_batch_histogram_("Cleared reference batch enqueue", 100, 32),
+      cleared_references_enqueued_(0u) {
 }
 
 static inline MemberOffset GetSlowPathFlagOffset(ObjPtr<mirror::Class> reference_class)
@@ -197,6 +251,57 @@ void ReferenceProcessor::Setup(Thread* self,
   clear_soft_references_ = clear_soft_references;
 }
 
+size_t ReferenceProcessor::GetReferenceProcessingThreadCount(Thread* self) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  ThreadPool* pool = heap->GetThreadPool();
+  // Transactions record every cleared referent and are not thread safe. The pool may also be
+  // reserved for tasks of the collector (e.g. mark-compact's uffd workers).
+  if (pool == nullptr || Runtime::Current()->IsActiveTransaction() ||
+      pool->GetTaskCount(self) != 0) {
+    return 1;
+  }
+  size_t count = concurrent_ ? heap->GetConcGCThreadCount() : heap->GetParallelGCThreadCount();
+  return std::min(count, pool->GetThreadCount()) + 1;
+}
+
+void ReferenceProcessor::ClearWhiteReferences(Thread* self,
+                                              ReferenceQueue* queue,
+                                              bool report_cleared) {
+  size_t thread_count = GetReferenceProcessingThreadCount(self);
+  if (thread_count <= 1) {
+    queue->ClearWhiteReferences(&cleared_references_, collector_, report_cleared);
+    return;
+  }
+  std::vector<mirror::Reference*> refs;
+  while (!queue->IsEmpty()) {
+    refs.push_back(queue->DequeuePendingReference().Ptr());
+  }
+  size_t num_tasks = std::min(thread_count, refs.size() / kMinReferencesPerTask);
+  if (num_tasks <= 1) {
+    for (mirror::Reference* ref : refs) {
+      queue->ClearWhiteReferent(ref, &cleared_references_, collector_, report_cleared);
+    }
+    return;
+  }
+  ThreadPool* pool = Runtime::Current()->GetHeap()->GetThreadPool();
+  std::vector<std::unique_ptr<ClearWhiteReferencesTask>> tasks;
+  size_t refs_per_task = RoundUp(refs.size(), num_tasks) / num_tasks;
+  for (size_t begin = 0; begin < refs.size(); begin += refs_per_task) {
+    size_t end = std::min(begin + refs_per_task, refs.size());
+    tasks.emplace_back(new ClearWhiteReferencesTask(
+        queue, collector_, refs.data() + begin, refs.data() + end, report_cleared));
+    pool->AddTask(self, tasks.back().get());
+  }
+  pool->SetMaxActiveWorkers(tasks.size() - 1);
+  pool->StartWorkers(self);
+  pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ true);
+  pool->StopWorkers(self);
+  pool->SetMaxActiveWorkers(pool->GetThreadCount());
+  for (std::unique_ptr<ClearWhiteReferencesTask>& task : tasks) {
+    cleared_references_.Splice(task->GetClearedReferences());
+  }
+}
+
 // Process reference class instances and schedule finalizations.
 // We advance rp_state_ to signal partial completion for the benefit of GetReferent.
 void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings) {
@@ -230,8 +335,16 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
   }
   // Clear all remaining soft and weak references with white referents.
   // This misses references only reachable through finalizers.
-  soft_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_);
-  weak_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_);
+  {
+    TimingLogger::ScopedTiming t2(
+        concurrent_ ? "ClearWhiteSoftReferences" : "(Paused)ClearWhiteSoftReferences", timings);
+    ClearWhiteReferences(self, &soft_reference_queue_, /*report_cleared=*/ false);
+  }
+  {
+    TimingLogger::ScopedTiming t2(
+        concurrent_ ? "ClearWhiteWeakReferences" : "(Paused)ClearWhiteWeakReferences", timings);
+    ClearWhiteReferences(self, &weak_reference_queue_, /*report_cleared=*/ false);
+  }
   // Defer PhantomReference processing until we've finished marking through finalizers.
   {
     // TODO: Capture mark state of some system weaks here. If the referent was marked here,
@@ -285,13 +398,21 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
   // finalized object containing pointers to native objects that have already been deallocated.
   // But it can be argued that this is just an instance of the broader rule that it is not safe
   // for finalizers to access otherwise inaccessible finalizable objects.
-  soft_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_,
-                                             /*report_cleared=*/ true);
-  weak_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_,
-                                             /*report_cleared=*/ true);
+  {
+    TimingLogger::ScopedTiming t2(concurrent_ ? "ClearWhiteFinalizerReachableReferences" :
+                                                "(Paused)ClearWhiteFinalizerReachableReferences",
+                                  timings);
+    ClearWhiteReferences(self, &soft_reference_queue_, /*report_cleared=*/ true);
+    ClearWhiteReferences(self, &weak_reference_queue_, /*report_cleared=*/ true);
+  }
 
   // Clear all phantom references with white referents. It's fine to do this just once here.
-  phantom_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_);
+  {
+    TimingLogger::ScopedTiming t2(
+        concurrent_ ? "ClearWhitePhantomReferences" : "(Paused)ClearWhitePhantomReferences",
+        timings);
+    ClearWhiteReferences(self, &phantom_reference_queue_, /*report_cleared=*/ false);
+  }
 
   // At this point all reference queues other than the cleared references should be empty.
   DCHECK(soft_reference_queue_.IsEmpty());
@@ -358,20 +479,45 @@ void ReferenceProcessor::UpdateRoots(IsMarkedVisitor* visitor) {
 
 class ClearedReferenceTask : public HeapTask {
  public:
-  explicit ClearedReferenceTask(jobject cleared_references)
-      : HeapTask(NanoTime()), cleared_references_(cleared_references) {
+  // Each batch is a global reference to a circular list of cleared references and its length.
+  explicit ClearedReferenceTask(std::vector<std::pair<jobject, size_t>>&& batches)
+      : HeapTask(NanoTime()), batches_(std::move(batches)) {
   }
   void Run(Thread* thread) override {
     ScopedObjectAccess soa(thread);
-    WellKnownClasses::java_lang_ref_ReferenceQueue_add->InvokeStatic<'V', 'L'>(
-        thread, soa.Decode<mirror::Object>(cleared_references_));
-    soa.Env()->DeleteGlobalRef(cleared_references_);
+    ReferenceProcessor* reference_processor =
+        Runtime::Current()->GetHeap()->GetReferenceProcessor();
+    for (const auto& [batch, length] : batches_) {
+      uint64_t start_ns = NanoTime();
+      WellKnownClasses::java_lang_ref_ReferenceQueue_add->InvokeStatic<'V', 'L'>(
+          thread, soa.Decode<mirror::Object>(batch));
+      soa.Env()->DeleteGlobalRef(batch);
+      reference_processor->RecordClearedReferenceBatch(length, NanoTime() - start_ns);
+    }
   }
 
  private:
-  const jobject cleared_references_;
+  const std::vector<std::pair<jobject, size_t>> batches_;
 };
 
+void ReferenceProcessor::RecordClearedReferenceBatch(size_t length, uint64_t duration_ns) {
+  MutexLock mu(Thread::Current(), cleared_reference_stats_lock_);
+  cleared_reference_batch_histogram_.AdjustAndAddValue(duration_ns);
+  cleared_references_enqueued_ += length;
+}
+
+void ReferenceProcessor::DumpClearedReferenceStats(std::ostream& os) {
+  MutexLock mu(Thread::Current(), cleared_reference_stats_lock_);
+  if (cleared_reference_batch_histogram_.SampleSize() == 0u) {
+    return;
+  }
+  os << "Cleared references enqueued: " << cleared_references_enqueued_ << " in "
+     << cleared_reference_batch_histogram_.SampleSize() << " batches\n";
+  Histogram<uint64_t>::CumulativeData cumulative_data;
+  cleared_reference_batch_histogram_.CreateHistogram(&cumulative_data);
+  cleared_reference_batch_histogram_.PrintConfidenceIntervals(os, 0.99, cumulative_data);
+}
+
 SelfDeletingTask* ReferenceProcessor::CollectClearedReferences(Thread* self) {
   Locks::mutator_lock_->AssertNotHeld(self);
   // By default we don't actually need to do anything. Just return this no-op task to avoid having
@@ -380,19 +526,28 @@ SelfDeletingTask* ReferenceProcessor::CollectClearedReferences(Thread* self) {
   // When a runtime isn't started there are no reference queues to care about so ignore.
   if (!cleared_references_.IsEmpty()) {
     if (LIKELY(Runtime::Current()->IsStarted())) {
-      jobject cleared_references;
+      std::vector<std::pair<jobject, size_t>> batches;
       {
         ReaderMutexLock mu(self, *Locks::mutator_lock_);
-        cleared_references = self->GetJniEnv()->GetVm()->AddGlobalRef(
-            self, cleared_references_.GetList());
+        JavaVMExt* vm = self->GetJniEnv()->GetVm();
+        size_t length = cleared_references_.GetLength();
+        while (length > kClearedReferenceBatchSize) {
+          ReferenceQueue batch(Locks::reference_queue_cleared_references_lock_);
+          for (size_t i = 0; i != kClearedReferenceBatchSize; ++i) {
+            batch.EnqueueReference(cleared_references_.DequeuePendingReference());
+          }
+          batches.emplace_back(vm->AddGlobalRef(self, batch.GetList()), kClearedReferenceBatchSize);
+          length -= kClearedReferenceBatchSize;
+        }
+        batches.emplace_back(vm->AddGlobalRef(self, cleared_references_.GetList()), length);
       }
       if (kAsyncReferenceQueueAdd) {
         // TODO: This can cause RunFinalization to terminate before newly freed objects are
         // finalized since they may not be enqueued by the time RunFinalization starts.
         Runtime::Current()->GetHeap()->GetTaskProcessor()->AddTask(
-            self, new ClearedReferenceTask(cleared_references));
+            self, new ClearedReferenceTask(std::move(batches)));
       } else {
-        result.reset(new ClearedReferenceTask(cleared_references));
+        result.reset(new ClearedReferenceTask(std::move(batches)));
       }
     }
     cleared_references_.Clear();
@@ -17,8 +17,12 @@
 #ifndef ART_RUNTIME_GC_REFERENCE_PROCESSOR_H_
 #define ART_RUNTIME_GC_REFERENCE_PROCESSOR_H_
 
+#include <iosfwd>
+
+#include "base/histogram.h"
 #include "base/macros.h"
 #include "base/locks.h"
+#include "base/mutex.h"
 #include "jni.h"
 #include "reference_queue.h"
 #include "runtime_globals.h"
@@ -73,8 +77,13 @@ class ReferenceProcessor {
   ObjPtr<mirror::Object> GetReferent(Thread* self, ObjPtr<mirror::Reference> reference)
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Locks::reference_processor_lock_);
   // Collects the cleared references and returns a task, to be executed after FinishGC, that will
-  // enqueue all of them.
+  // enqueue all of them. Long lists are handed to Java in batches of bounded length.
   SelfDeletingTask* CollectClearedReferences(Thread* self) REQUIRES(!Locks::mutator_lock_);
+  // Records that a batch of `length` cleared references took `duration_ns` to enqueue.
+  void RecordClearedReferenceBatch(size_t length, uint64_t duration_ns)
+      REQUIRES(!cleared_reference_stats_lock_);
+  // Dumps the number of cleared reference batches and the distribution of their enqueue times.
+  void DumpClearedReferenceStats(std::ostream& os) REQUIRES(!cleared_reference_stats_lock_);
   void DelayReferenceReferent(ObjPtr<mirror::Class> klass,
                               ObjPtr<mirror::Reference> ref,
                               collector::GarbageCollector* collector)
@@ -93,6 +102,15 @@ class ReferenceProcessor {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
  private:
+  class ClearWhiteReferencesTask;
+
+  // Clear the references of `queue` with white referents into cleared_references_. Long queues
+  // are split across the heap thread pool, with each task collecting its cleared references in
+  // a queue of its own which is merged into cleared_references_ at the end.
+  void ClearWhiteReferences(Thread* self, ReferenceQueue* queue, bool report_cleared)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  // Return the number of threads, including the calling one, to clear references with.
+  size_t GetReferenceProcessingThreadCount(Thread* self);
   bool SlowPathEnabled() REQUIRES_SHARED(Locks::mutator_lock_);
   // Called by ProcessReferences.
   void DisableSlowPath(Thread* self) REQUIRES(Locks::reference_processor_lock_)
@@ -124,6 +142,10 @@ class ReferenceProcessor {
   ReferenceQueue phantom_reference_queue_;
   ReferenceQueue cleared_references_;
 
+  Mutex cleared_reference_stats_lock_ BOTTOM_MUTEX_ACQUIRED_AFTER;
+  Histogram<uint64_t> cleared_reference_batch_histogram_ GUARDED_BY(cleared_reference_stats_lock_);
+  uint64_t cleared_references_enqueued_ GUARDED_BY(cleared_reference_stats_lock_);
+
   DISALLOW_COPY_AND_ASSIGN(ReferenceProcessor);
 };
 
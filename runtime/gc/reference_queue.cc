@@ -131,36 +131,60 @@ size_t ReferenceQueue::GetLength() const {
   return count;
 }
 
+void ReferenceQueue::Splice(ReferenceQueue* other) {
+  if (other->IsEmpty()) {
+    return;
+  }
+  if (IsEmpty()) {
+    list_ = other->list_;
+  } else {
+    // Swapping the successors of one element of each cycle joins the two cycles into one.
+    ObjPtr<mirror::Reference> head = list_->GetPendingNext<kWithoutReadBarrier>();
+    ObjPtr<mirror::Reference> other_head = other->list_->GetPendingNext<kWithoutReadBarrier>();
+    DCHECK(head != nullptr);
+    DCHECK(other_head != nullptr);
+    list_->SetPendingNext(other_head);
+    other->list_->SetPendingNext(head);
+  }
+  other->Clear();
+}
+
 void ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
                                           collector::GarbageCollector* collector,
                                           bool report_cleared) {
   while (!IsEmpty()) {
     ObjPtr<mirror::Reference> ref = DequeuePendingReference();
-    mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
-    // do_atomic_update is false because this happens during the reference processing phase where
-    // Reference.clear() would block.
-    if (!collector->IsNullOrMarkedHeapReference(referent_addr, /*do_atomic_update=*/false)) {
-      // Referent is white, clear it.
-      if (Runtime::Current()->IsActiveTransaction()) {
-        ref->ClearReferent<true>();
-      } else {
-        ref->ClearReferent<false>();
-      }
-      cleared_references->EnqueueReference(ref);
-      if (report_cleared) {
-        static bool already_reported = false;
-        if (!already_reported) {
-          // TODO: Maybe do this only if the queue is non-null?
-          LOG(WARNING)
-              << "Cleared Reference was only reachable from finalizer (only reported once)";
-          already_reported = true;
-        }
+    ClearWhiteReferent(ref, cleared_references, collector, report_cleared);
+  }
+}
+
+void ReferenceQueue::ClearWhiteReferent(ObjPtr<mirror::Reference> ref,
+                                        ReferenceQueue* cleared_references,
+                                        collector::GarbageCollector* collector,
+                                        bool report_cleared) {
+  mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
+  // do_atomic_update is false because this happens during the reference processing phase where
+  // Reference.clear() would block.
+  if (!collector->IsNullOrMarkedHeapReference(referent_addr, /*do_atomic_update=*/false)) {
+    // Referent is white, clear it.
+    if (Runtime::Current()->IsActiveTransaction()) {
+      ref->ClearReferent<true>();
+    } else {
+      ref->ClearReferent<false>();
+    }
+    cleared_references->EnqueueReference(ref);
+    if (report_cleared) {
+      static std::atomic<bool> already_reported(false);
+      if (!already_reported.exchange(true, std::memory_order_relaxed)) {
+        // TODO: Maybe do this only if the queue is non-null?
+        LOG(WARNING)
+            << "Cleared Reference was only reachable from finalizer (only reported once)";
       }
     }
-    // Delay disabling the read barrier until here so that the ClearReferent call above in
-    // transaction mode will trigger the read barrier.
-    DisableReadBarrierForReference(ref, std::memory_order_relaxed);
   }
+  // Delay disabling the read barrier until here so that the ClearReferent call above in
+  // transaction mode will trigger the read barrier.
+  DisableReadBarrierForReference(ref, std::memory_order_relaxed);
 }
 
 FinalizerStats ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
@@ -109,6 +109,18 @@ class ReferenceQueue {
                             bool report_cleared = false)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Clear the referent of `ref`, which must have been dequeued from this queue, if it is white and
+  // enqueue `ref` on `cleared_references`. Also disables the read barrier for `ref`. May be called
+  // from multiple threads for distinct references and distinct `cleared_references` queues.
+  void ClearWhiteReferent(ObjPtr<mirror::Reference> ref,
+                          ReferenceQueue* cleared_references,
+                          collector::GarbageCollector* collector,
+                          bool report_cleared)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Move all the references of `other` to this queue, leaving `other` empty. Not thread safe.
+  void Splice(ReferenceQueue* other) REQUIRES_SHARED(Locks::mutator_lock_);
+
   void Dump(std::ostream& os) const REQUIRES_SHARED(Locks::mutator_lock_);
   size_t GetLength() const REQUIRES_SHARED(Locks::mutator_lock_);
 
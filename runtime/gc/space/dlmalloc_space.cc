@@ -330,7 +330,8 @@ size_t DlMallocSpace::FreeList(Thread* self, size_t num_ptrs, mirror::Object** p
   }
 }
 
-size_t DlMallocSpace::Trim() {
+size_t DlMallocSpace::Trim([[maybe_unused]] size_t max_bytes) {
+  // The inspection of the mspace cannot be resumed, so release all the holes at once.
   MutexLock mu(Thread::Current(), lock_);
   // Trim to release memory at the end of the space.
   mspace_trim(mspace_, 0);
@@ -109,7 +109,7 @@ class DlMallocSpace : public MallocSpace {
     return mspace_;
   }
 
-  size_t Trim() override;
+  size_t Trim(size_t max_bytes) override;
 
   // Perform a mspace_inspect_all which calls back for each allocation chunk. The chunk may not be
   // in use, indicated by num_bytes equaling zero.
@@ -2676,7 +2676,10 @@ class ImageSpace::BootImageLoader {
       }
     }
 
-    for (const std::unique_ptr<ImageSpace>& space : spaces) {
+    // The last pass only tests `patched_objects` and each object is patched in place, so the
+    // spaces can be patched in parallel. All classes were patched above.
+    auto patch_objects = [&](const std::unique_ptr<ImageSpace>& space)
+        REQUIRES_SHARED(Locks::mutator_lock_) {
       const ImageHeader& image_header = space->GetImageHeader();
 
       static_assert(IsAligned<kObjectAlignment>(sizeof(ImageHeader)), "Header alignment check");
@@ -2709,6 +2712,30 @@ class ImageSpace::BootImageLoader {
         }
         pos += RoundUp(object->SizeOf<kVerifyNone>(), kObjectAlignment);
       }
+    };
+    Thread* const self = Thread::Current();
+    std::optional<Runtime::ScopedThreadPoolUsage> stpu(std::nullopt);
+    if (self != nullptr && Runtime::Current() != nullptr && spaces.size() >= 2u) {
+      stpu.emplace();
+    }
+    ThreadPool* const pool = stpu.has_value() ? stpu->GetThreadPool() : nullptr;
+    if (pool != nullptr) {
+      ScopedTrace trace("Relocate image objects in parallel");
+      for (const std::unique_ptr<ImageSpace>& space : spaces) {
+        // Nothing else can access the boot image objects while they are being relocated,
+        // so the tasks do not need to take the mutator lock.
+        auto function = [&patch_objects, &space](Thread*) NO_THREAD_SAFETY_ANALYSIS {
+          patch_objects(space);
+        };
+        pool->AddTask(self, new FunctionTask(std::move(function)));
+      }
+      // Go to native since we don't want to suspend while holding the mutator lock.
+      ScopedThreadSuspension sts(self, ThreadState::kNative);
+      pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ false);
+    } else {
+      for (const std::unique_ptr<ImageSpace>& space : spaces) {
+        patch_objects(space);
+      }
     }
     if (kIsDebugBuild && !kExtension) {
       // We used just Test() instead of Set() above but we need to use Set()
@@ -3756,15 +3783,75 @@ void ImageSpace::DumpSections(std::ostream& os) const {
   }
 }
 
-void ImageSpace::ReleaseMetadata() {
+std::optional<size_t> ImageSpace::CollectDirtyClasses(std::set<std::string>* descriptors,
+                                                     std::string* error_msg) const {
+  // See Documentation/admin-guide/mm/pagemap.rst in the kernel sources.
+  static constexpr uint64_t kPagePresent = UINT64_C(1) << 63;
+  static constexpr uint64_t kPageFileOrSharedAnon = UINT64_C(1) << 61;
+  static constexpr uint64_t kPageExclusivelyMapped = UINT64_C(1) << 56;
+
+  const ImageSection& objects = GetImageHeader().GetObjectsSection();
+  uint8_t* const objects_begin = Begin() + objects.Offset();
+  uint8_t* const objects_end = Begin() + objects.End();
+  uint8_t* const page_begin = AlignDown(objects_begin, gPageSize);
+  const size_t num_pages = RoundUp(objects_end - page_begin, gPageSize) / gPageSize;
+
+  std::unique_ptr<File> pagemap(OS::OpenFileForReading("/proc/self/pagemap"));
+  if (pagemap == nullptr) {
+    *error_msg = StringPrintf("Failed to open /proc/self/pagemap: %s", strerror(errno));
+    return std::nullopt;
+  }
+  std::vector<uint64_t> entries(num_pages);
+  const size_t first_page_index = reinterpret_cast<uintptr_t>(page_begin) / gPageSize;
+  if (!pagemap->PreadFully(entries.data(),
+                           entries.size() * sizeof(uint64_t),
+                           first_page_index * sizeof(uint64_t))) {
+    *error_msg = StringPrintf("Failed to read /proc/self/pagemap: %s", strerror(errno));
+    return std::nullopt;
+  }
+
+  // A page is dirty in this process when it is no longer backed by the image
+  // file, or shared with the zygote, but a private copy owned by this process.
+  std::vector<bool> dirty_pages(num_pages);
+  for (size_t i = 0; i != num_pages; ++i) {
+    dirty_pages[i] = (entries[i] & kPagePresent) != 0u &&
+                     (entries[i] & kPageFileOrSharedAnon) == 0u &&
+                     (entries[i] & kPageExclusivelyMapped) != 0u;
+  }
+
+  size_t num_dirty_objects = 0u;
+  auto visitor = [&](mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+    uint8_t* obj_begin = reinterpret_cast<uint8_t*>(obj);
+    uint8_t* obj_end = obj_begin + obj->SizeOf<kVerifyNone>();
+    size_t first = (obj_begin - page_begin) / gPageSize;
+    size_t last = std::min(num_pages, RoundUp(obj_end - page_begin, gPageSize) / gPageSize);
+    if (std::find(dirty_pages.begin() + first, dirty_pages.begin() + last, true) ==
+            dirty_pages.begin() + last) {
+      return;
+    }
+    ++num_dirty_objects;
+    if (obj->IsClass<kVerifyNone>()) {
+      std::string temp;
+      descriptors->insert(obj->AsClass<kVerifyNone>()->GetDescriptor(&temp));
+    }
+  };
+  GetLiveBitmap()->VisitMarkedRange(reinterpret_cast<uintptr_t>(objects_begin),
+                                    reinterpret_cast<uintptr_t>(objects_end),
+                                    visitor);
+  return num_dirty_objects;
+}
+
+size_t ImageSpace::ReleaseMetadata() {
   const ImageSection& metadata = GetImageHeader().GetMetadataSection();
   VLOG(image) << "Releasing " << metadata.Size() << " image metadata bytes";
   // Avoid using ZeroAndReleasePages since the zero fill might not be word atomic.
   uint8_t* const page_begin = AlignUp(Begin() + metadata.Offset(), gPageSize);
   uint8_t* const page_end = AlignDown(Begin() + metadata.End(), gPageSize);
-  if (page_begin < page_end) {
-    CHECK_NE(madvise(page_begin, page_end - page_begin, MADV_DONTNEED), -1) << "madvise failed";
+  if (page_begin >= page_end) {
+    return 0u;
   }
+  CHECK_NE(madvise(page_begin, page_end - page_begin, MADV_DONTNEED), -1) << "madvise failed";
+  return page_end - page_begin;
 }
 
 }  // namespace space
@@ -17,6 +17,10 @@
 #ifndef ART_RUNTIME_GC_SPACE_IMAGE_SPACE_H_
 #define ART_RUNTIME_GC_SPACE_IMAGE_SPACE_H_
 
+#include <optional>
+#include <set>
+#include <string>
+
 #include "android-base/unique_fd.h"
 #include "base/array_ref.h"
 #include "gc/accounting/space_bitmap.h"
@@ -300,10 +304,20 @@ class ImageSpace : public MemMapSpace {
 
   void DumpSections(std::ostream& os) const;
 
+  // Collect the descriptors of classes whose objects lie on pages of the objects
+  // section that this process has dirtied, based on /proc/self/pagemap. The
+  // descriptors are valid entries for dex2oat's --dirty-image-objects.
+  // Returns the number of dirty objects, including non-class objects, or
+  // std::nullopt if the page map cannot be read.
+  std::optional<size_t> CollectDirtyClasses(/*inout*/ std::set<std::string>* descriptors,
+                                            /*out*/ std::string* error_msg) const
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // De-initialize the image-space by undoing the effects in Init().
   virtual ~ImageSpace();
 
-  void ReleaseMetadata() REQUIRES_SHARED(Locks::mutator_lock_);
+  // Release the pages of the metadata section and return the number of bytes released.
+  size_t ReleaseMetadata() REQUIRES_SHARED(Locks::mutator_lock_);
 
   static void AppendImageChecksum(uint32_t component_count,
                                   uint32_t checksum,
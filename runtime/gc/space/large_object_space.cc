@@ -18,6 +18,7 @@
 
 #include <sys/mman.h>
 
+#include <algorithm>
 #include <memory>
 
 #include <android-base/logging.h>
@@ -640,6 +641,365 @@ void FreeListSpace::SetAllLargeObjectsAsZygoteObjects(Thread* self, bool set_mar
   }
 }
 
+// State of a run of slots of a SegregatedFreeListSpace. Only valid for the first slot of each run.
+class SegregatedFreeListSpace::RunInfo {
+ public:
+  // Returns the length of the run in slots.
+  size_t GetSlots() const {
+    return state_.load(std::memory_order_acquire) & kSlotsMask;
+  }
+  bool IsFree() const {
+    return (state_.load(std::memory_order_acquire) & kFlagFree) != 0;
+  }
+  bool IsZygoteObject() const {
+    return (state_.load(std::memory_order_relaxed) & kFlagZygote) != 0;
+  }
+  // Return true if the pages of the free run have been handed back to the kernel since it was
+  // freed.
+  bool IsReleased() const {
+    return (state_.load(std::memory_order_relaxed) & kFlagReleased) != 0;
+  }
+  // Start a new run, clearing the flags of the previous one.
+  void SetRun(size_t slots, bool free) {
+    DCHECK_NE(slots, 0u);
+    DCHECK_EQ(slots & ~kSlotsMask, 0u);
+    state_.store(static_cast<uint32_t>(slots) | (free ? kFlagFree : 0u),
+                 std::memory_order_release);
+  }
+  void SetZygoteObject() {
+    state_.fetch_or(kFlagZygote, std::memory_order_relaxed);
+  }
+  void SetReleased() {
+    state_.fetch_or(kFlagReleased, std::memory_order_relaxed);
+  }
+  // The next run of the free list the run is in, if it is free.
+  uint32_t GetNextFree() const {
+    return next_free_.load(std::memory_order_relaxed);
+  }
+  void SetNextFree(uint32_t run) {
+    next_free_.store(run, std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr uint32_t kFlagFree = 0x80000000;  // If the run is free.
+  static constexpr uint32_t kFlagZygote = 0x40000000;  // If the large object is a zygote object.
+  static constexpr uint32_t kFlagReleased = 0x20000000;  // If the free run's pages were released.
+  static constexpr uint32_t kSlotsMask = ~(kFlagFree | kFlagZygote | kFlagReleased);
+  std::atomic<uint32_t> state_;
+  std::atomic<uint32_t> next_free_;
+};
+
+SegregatedFreeListSpace* SegregatedFreeListSpace::Create(const std::string& name,
+                                                         size_t capacity) {
+  CHECK_ALIGNED_PARAM(capacity, ObjectAlignment());
+  DCHECK_LE(gPageSize, ObjectAlignment())
+      << "MapAnonymousAligned() should be used if the large-object alignment is larger than the "
+         "runtime page size";
+  std::string error_msg;
+  MemMap mem_map = MemMap::MapAnonymous(name.c_str(),
+                                        capacity,
+                                        PROT_READ | PROT_WRITE,
+                                        /*low_4gb=*/true,
+                                        &error_msg);
+  CHECK(mem_map.IsValid()) << "Failed to allocate large object space mem map: " << error_msg;
+  MemMap run_info_map =
+      MemMap::MapAnonymous("large object segregated free list space run info map",
+                           sizeof(RunInfo) * (capacity / ObjectAlignment()),
+                           PROT_READ | PROT_WRITE,
+                           /*low_4gb=*/ false,
+                           &error_msg);
+  CHECK(run_info_map.IsValid()) << "Failed to allocate run info map" << error_msg;
+  return new SegregatedFreeListSpace(name, std::move(mem_map), std::move(run_info_map));
+}
+
+SegregatedFreeListSpace::SegregatedFreeListSpace(const std::string& name,
+                                                 MemMap&& mem_map,
+                                                 MemMap&& run_info_map)
+    : LargeObjectSpace(name, mem_map.Begin(), mem_map.End(), "segregated free list space lock"),
+      mem_map_(std::move(mem_map)),
+      run_info_map_(std::move(run_info_map)),
+      run_infos_(reinterpret_cast<RunInfo*>(run_info_map_.Begin())),
+      frontier_(0),
+      num_slots_(mem_map_.Size() / ObjectAlignment()),
+      bytes_allocated_(0),
+      objects_allocated_(0) {
+  // Sizes 1 to kSizeClassesPerDoubling slots, then kSizeClassesPerDoubling evenly spaced sizes
+  // up to each next power of two.
+  for (size_t slots = 1; slots <= kSizeClassesPerDoubling && slots <= num_slots_; ++slots) {
+    size_class_slots_.push_back(slots);
+  }
+  for (size_t base = kSizeClassesPerDoubling; base < num_slots_; base *= 2) {
+    for (size_t i = 1; i <= kSizeClassesPerDoubling && base + i * base / kSizeClassesPerDoubling <=
+             num_slots_; ++i) {
+      size_class_slots_.push_back(base + i * base / kSizeClassesPerDoubling);
+    }
+  }
+  free_run_heads_.reset(new std::atomic<uint64_t>[size_class_slots_.size()]);
+  for (size_t i = 0; i < size_class_slots_.size(); ++i) {
+    free_run_heads_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+SegregatedFreeListSpace::~SegregatedFreeListSpace() {}
+
+size_t SegregatedFreeListSpace::GetSizeClassAtLeast(size_t slots) const {
+  return std::lower_bound(size_class_slots_.begin(), size_class_slots_.end(), slots) -
+         size_class_slots_.begin();
+}
+
+size_t SegregatedFreeListSpace::GetSizeClassAtMost(size_t slots) const {
+  DCHECK_GE(slots, 1u);
+  return std::upper_bound(size_class_slots_.begin(), size_class_slots_.end(), slots) -
+         size_class_slots_.begin() - 1;
+}
+
+void SegregatedFreeListSpace::PushFreeRuns(size_t size_class, uint32_t first_run,
+                                           uint32_t last_run) {
+  DCHECK_NE(first_run, kNoRun);
+  std::atomic<uint64_t>& head = free_run_heads_[size_class];
+  uint64_t old_head = head.load(std::memory_order_relaxed);
+  uint64_t new_head;
+  do {
+    run_infos_[last_run - 1].SetNextFree(static_cast<uint32_t>(old_head));
+    new_head = (((old_head >> 32) + 1) << 32) | first_run;
+  } while (!head.compare_exchange_weak(
+      old_head, new_head, std::memory_order_release, std::memory_order_relaxed));
+}
+
+uint32_t SegregatedFreeListSpace::PopFreeRun(size_t size_class) {
+  std::atomic<uint64_t>& head = free_run_heads_[size_class];
+  uint64_t old_head = head.load(std::memory_order_acquire);
+  while (true) {
+    const uint32_t run = static_cast<uint32_t>(old_head);
+    if (run == kNoRun) {
+      return kNoRun;
+    }
+    // The run may be popped and reused concurrently, making its next run stale. The counter in
+    // the head then makes the exchange below fail.
+    const uint64_t new_head = (((old_head >> 32) + 1) << 32) | run_infos_[run - 1].GetNextFree();
+    if (head.compare_exchange_weak(
+            old_head, new_head, std::memory_order_acquire, std::memory_order_acquire)) {
+      return run;
+    }
+  }
+}
+
+uint32_t SegregatedFreeListSpace::PopAllFreeRuns(size_t size_class) {
+  std::atomic<uint64_t>& head = free_run_heads_[size_class];
+  uint64_t old_head = head.load(std::memory_order_acquire);
+  while (!head.compare_exchange_weak(old_head,
+                                     ((old_head >> 32) + 1) << 32,
+                                     std::memory_order_acquire,
+                                     std::memory_order_acquire)) {
+  }
+  return static_cast<uint32_t>(old_head);
+}
+
+uint32_t SegregatedFreeListSpace::AllocFromFrontier(Thread* self, size_t slots) {
+  MutexLock mu(self, lock_);
+  if (num_slots_ - frontier_ < slots) {
+    return kNoRun;
+  }
+  const size_t slot = frontier_;
+  run_infos_[slot].SetRun(slots, /*free=*/ false);
+  frontier_ += slots;
+  return static_cast<uint32_t>(slot + 1);
+}
+
+mirror::Object* SegregatedFreeListSpace::Alloc(Thread* self, size_t num_bytes,
+                                               size_t* bytes_allocated, size_t* usable_size,
+                                               size_t* bytes_tl_bulk_allocated) {
+  size_t slots = RoundUp(num_bytes, ObjectAlignment()) / ObjectAlignment();
+  const size_t num_size_classes = size_class_slots_.size();
+  const size_t size_class = GetSizeClassAtLeast(slots);
+  if (size_class < num_size_classes && slots * ObjectAlignment() <= kMaxRoundedAllocationSize) {
+    slots = size_class_slots_[size_class];
+  }
+  // Prefer a free run of our size class, then the untouched end of the space, and only then split
+  // a free run of a larger size class. All free runs of our size class and up are large enough.
+  uint32_t run = size_class < num_size_classes ? PopFreeRun(size_class) : kNoRun;
+  if (run == kNoRun) {
+    run = AllocFromFrontier(self, slots);
+    for (size_t i = size_class + 1; run == kNoRun && i < num_size_classes; ++i) {
+      run = PopFreeRun(i);
+    }
+    if (run == kNoRun) {
+      return nullptr;
+    }
+  }
+  const size_t slot = run - 1;
+  RunInfo* info = &run_infos_[slot];
+  if (info->IsFree()) {
+    const size_t run_slots = info->GetSlots();
+    DCHECK_GE(run_slots, slots);
+    if (run_slots > slots) {
+      // Give back the tail of the run. Set it up before shrinking our run, so that walking the
+      // runs never reaches an uninitialized RunInfo.
+      RunInfo* tail_info = &run_infos_[slot + slots];
+      tail_info->SetRun(run_slots - slots, /*free=*/ true);
+      info->SetRun(slots, /*free=*/ false);
+      const uint32_t tail = static_cast<uint32_t>(slot + slots + 1);
+      PushFreeRuns(GetSizeClassAtMost(run_slots - slots), tail, tail);
+    } else {
+      info->SetRun(slots, /*free=*/ false);
+    }
+    // The memory still holds the dead object unless the kernel reclaimed it after Trim(). Clear
+    // it like a fresh mapping.
+    memset(GetAddressForSlot(slot), 0, slots * ObjectAlignment());
+  }
+  const size_t allocation_size = slots * ObjectAlignment();
+  DCHECK(bytes_allocated != nullptr);
+  *bytes_allocated = allocation_size;
+  if (usable_size != nullptr) {
+    *usable_size = allocation_size;
+  }
+  DCHECK(bytes_tl_bulk_allocated != nullptr);
+  *bytes_tl_bulk_allocated = allocation_size;
+  bytes_allocated_.fetch_add(allocation_size, std::memory_order_relaxed);
+  objects_allocated_.fetch_add(1, std::memory_order_relaxed);
+  return reinterpret_cast<mirror::Object*>(GetAddressForSlot(slot));
+}
+
+size_t SegregatedFreeListSpace::Free([[maybe_unused]] Thread* self, mirror::Object* obj) {
+  DCHECK(Contains(obj)) << reinterpret_cast<void*>(Begin()) << " " << obj << " "
+                        << reinterpret_cast<void*>(End());
+  DCHECK_ALIGNED_PARAM(obj, ObjectAlignment());
+  const size_t slot = GetSlotForAddress(reinterpret_cast<uintptr_t>(obj));
+  RunInfo* info = &run_infos_[slot];
+  DCHECK(!info->IsFree());
+  const size_t slots = info->GetSlots();
+  const size_t allocation_size = slots * ObjectAlignment();
+  // Keep the pages, they are likely to be reused soon. Trim() releases them otherwise.
+  info->SetRun(slots, /*free=*/ true);
+  const uint32_t run = static_cast<uint32_t>(slot + 1);
+  PushFreeRuns(GetSizeClassAtMost(slots), run, run);
+  DCHECK_LE(allocation_size, bytes_allocated_.load(std::memory_order_relaxed));
+  bytes_allocated_.fetch_sub(allocation_size, std::memory_order_relaxed);
+  objects_allocated_.fetch_sub(1, std::memory_order_relaxed);
+  return allocation_size;
+}
+
+// Let the kernel reclaim the pages of a free run when it needs memory, with MADV_FREE if it is
+// supported. The contents stay valid until then, so reusing the run does not fault.
+static void ReleaseFreeRunPages(uint8_t* begin, size_t size) {
+#ifdef MADV_FREE
+  if (madvise(begin, size, MADV_FREE) == 0) {
+    return;
+  }
+#endif
+  CheckedCall(madvise, __FUNCTION__, begin, size, MADV_DONTNEED);
+}
+
+size_t SegregatedFreeListSpace::Trim(size_t max_bytes) {
+  size_t released_bytes = 0;
+  for (size_t i = 0; i < size_class_slots_.size() && released_bytes < max_bytes; ++i) {
+    // Take the whole list so that none of its runs is reused while we release it. Allocations of
+    // this size class get their memory elsewhere in the meantime.
+    const uint32_t first_run = PopAllFreeRuns(i);
+    uint32_t last_run = kNoRun;
+    for (uint32_t run = first_run; run != kNoRun; run = run_infos_[run - 1].GetNextFree()) {
+      RunInfo* info = &run_infos_[run - 1];
+      DCHECK(info->IsFree());
+      if (!info->IsReleased() && released_bytes < max_bytes) {
+        const size_t size = info->GetSlots() * ObjectAlignment();
+        ReleaseFreeRunPages(GetAddressForSlot(run - 1), size);
+        info->SetReleased();
+        released_bytes += size;
+      }
+      last_run = run;
+    }
+    if (first_run != kNoRun) {
+      PushFreeRuns(i, first_run, last_run);
+    }
+  }
+  return released_bytes;
+}
+
+size_t SegregatedFreeListSpace::AllocationSize(mirror::Object* obj, size_t* usable_size) {
+  DCHECK(Contains(obj));
+  const RunInfo& info = run_infos_[GetSlotForAddress(reinterpret_cast<uintptr_t>(obj))];
+  DCHECK(!info.IsFree());
+  size_t alloc_size = info.GetSlots() * ObjectAlignment();
+  if (usable_size != nullptr) {
+    *usable_size = alloc_size;
+  }
+  return alloc_size;
+}
+
+void SegregatedFreeListSpace::Walk(DlMallocSpace::WalkCallback callback, void* arg) {
+  MutexLock mu(Thread::Current(), lock_);
+  for (size_t slot = 0; slot < frontier_; slot += run_infos_[slot].GetSlots()) {
+    const RunInfo& info = run_infos_[slot];
+    if (!info.IsFree()) {
+      const size_t alloc_size = info.GetSlots() * ObjectAlignment();
+      uint8_t* byte_start = GetAddressForSlot(slot);
+      callback(byte_start, byte_start + alloc_size, alloc_size, arg);
+      callback(nullptr, nullptr, 0, arg);
+    }
+  }
+}
+
+void SegregatedFreeListSpace::Dump(std::ostream& os) const {
+  MutexLock mu(Thread::Current(), lock_);
+  os << GetName() << " -"
+     << " begin: " << reinterpret_cast<void*>(Begin())
+     << " end: " << reinterpret_cast<void*>(End())
+     << " size classes: " << size_class_slots_.size() << "\n";
+  for (size_t slot = 0; slot < frontier_; slot += run_infos_[slot].GetSlots()) {
+    const RunInfo& info = run_infos_[slot];
+    const size_t size = info.GetSlots() * ObjectAlignment();
+    if (info.IsFree()) {
+      os << "Free run at address: " << reinterpret_cast<const void*>(GetAddressForSlot(slot))
+         << " of length " << size << " bytes" << (info.IsReleased() ? " (released)" : "") << "\n";
+    } else {
+      os << "Large object at address: " << reinterpret_cast<const void*>(GetAddressForSlot(slot))
+         << " of length " << size << " bytes\n";
+    }
+  }
+  if (frontier_ < num_slots_) {
+    os << "Free block at address: " << reinterpret_cast<const void*>(GetAddressForSlot(frontier_))
+       << " of length " << (num_slots_ - frontier_) * ObjectAlignment() << " bytes\n";
+  }
+}
+
+void SegregatedFreeListSpace::ForEachMemMap(std::function<void(const MemMap&)> func) const {
+  MutexLock mu(Thread::Current(), lock_);
+  func(run_info_map_);
+  func(mem_map_);
+}
+
+void SegregatedFreeListSpace::ClampGrowthLimit(size_t new_capacity) {
+  MutexLock mu(Thread::Current(), lock_);
+  // Runs never extend beyond the frontier, so that is as far as we can shrink.
+  const size_t new_slots =
+      std::max(RoundUp(new_capacity, ObjectAlignment()) / ObjectAlignment(), frontier_);
+  CHECK_LE(new_slots, num_slots_);
+  run_info_map_.SetSize(sizeof(RunInfo) * new_slots);
+  mem_map_.SetSize(new_slots * ObjectAlignment());
+  num_slots_ = new_slots;
+  end_ = Begin() + new_slots * ObjectAlignment();
+}
+
+bool SegregatedFreeListSpace::IsZygoteLargeObject([[maybe_unused]] Thread* self,
+                                                  mirror::Object* obj) const {
+  return run_infos_[GetSlotForAddress(reinterpret_cast<uintptr_t>(obj))].IsZygoteObject();
+}
+
+void SegregatedFreeListSpace::SetAllLargeObjectsAsZygoteObjects(Thread* self, bool set_mark_bit) {
+  MutexLock mu(self, lock_);
+  for (size_t slot = 0; slot < frontier_; slot += run_infos_[slot].GetSlots()) {
+    RunInfo* info = &run_infos_[slot];
+    if (!info->IsFree()) {
+      info->SetZygoteObject();
+      if (set_mark_bit) {
+        ObjPtr<mirror::Object> obj = reinterpret_cast<mirror::Object*>(GetAddressForSlot(slot));
+        bool success = obj->AtomicSetMarkBit(0, 1);
+        CHECK(success);
+      }
+    }
+  }
+}
+
 void LargeObjectSpace::SweepCallback(size_t num_ptrs, mirror::Object** ptrs, void* arg) {
   SweepCallbackContext* context = static_cast<SweepCallbackContext*>(arg);
   space::LargeObjectSpace* space = context->space->AsLargeObjectSpace();
@@ -692,6 +1052,11 @@ std::pair<uint8_t*, uint8_t*> FreeListSpace::GetBeginEndAtomic() const {
   return std::make_pair(Begin(), End());
 }
 
+std::pair<uint8_t*, uint8_t*> SegregatedFreeListSpace::GetBeginEndAtomic() const {
+  MutexLock mu(Thread::Current(), lock_);
+  return std::make_pair(Begin(), End());
+}
+
 }  // namespace space
 }  // namespace gc
 }  // namespace art
@@ -24,6 +24,8 @@
 #include "space.h"
 #include "thread-current-inl.h"
 
+#include <atomic>
+#include <memory>
 #include <set>
 #include <vector>
 
@@ -37,6 +39,7 @@ enum class LargeObjectSpaceType {
   kDisabled,
   kMap,
   kFreeList,
+  kSegregatedFreeList,
 };
 
 // Abstraction implemented by all large object spaces.
@@ -117,6 +120,11 @@ class LargeObjectSpace : public DiscontinuousSpace, public AllocSpace {
   virtual std::pair<uint8_t*, uint8_t*> GetBeginEndAtomic() const = 0;
   // Clamp the space size to the given capacity.
   virtual void ClampGrowthLimit(size_t capacity) = 0;
+  // Return the pages of freed objects that are kept around for reuse to the kernel, stopping
+  // once about `max_bytes` are released. Returns the number of bytes released.
+  virtual size_t Trim([[maybe_unused]] size_t max_bytes) {
+    return 0;
+  }
 
   // The way large object spaces are implemented, the object alignment has to be
   // the same as the *runtime* OS page size. However, in the future this may
@@ -254,6 +262,90 @@ class FreeListSpace final : public LargeObjectSpace {
   FreeBlocks free_blocks_ GUARDED_BY(lock_);
 };
 
+// A continuous large object space which rounds allocations up to size classes and keeps a
+// lock-free list of free runs per size class, so that objects of recurring sizes reuse the memory
+// of dead ones without mmap/munmap calls or a search under a lock. Freed runs keep their pages
+// until Trim() hands them back to the kernel. Free runs are not coalesced; a run is split when a
+// smaller allocation has to take it.
+class SegregatedFreeListSpace final : public LargeObjectSpace {
+ public:
+  // Allocations up to this size are rounded up to their size class, so that freed runs can be
+  // reused as they are. Larger allocations are only rounded up to the object alignment.
+  static constexpr size_t kMaxRoundedAllocationSize = 1 * MB;
+  // Number of size classes for each doubling of the allocation size. Bounds the internal
+  // fragmentation of rounded allocations to 25%.
+  static constexpr size_t kSizeClassesPerDoubling = 4;
+
+  virtual ~SegregatedFreeListSpace();
+  static SegregatedFreeListSpace* Create(const std::string& name, size_t capacity);
+  uint64_t GetBytesAllocated() override {
+    return bytes_allocated_.load(std::memory_order_relaxed);
+  }
+  uint64_t GetObjectsAllocated() override {
+    return objects_allocated_.load(std::memory_order_relaxed);
+  }
+  size_t AllocationSize(mirror::Object* obj, size_t* usable_size) override;
+  mirror::Object* Alloc(Thread* self, size_t num_bytes, size_t* bytes_allocated,
+                        size_t* usable_size, size_t* bytes_tl_bulk_allocated)
+      override REQUIRES(!lock_);
+  size_t Free(Thread* self, mirror::Object* obj) override;
+  size_t Trim(size_t max_bytes) override;
+  void Walk(DlMallocSpace::WalkCallback callback, void* arg) override REQUIRES(!lock_);
+  void Dump(std::ostream& os) const override REQUIRES(!lock_);
+  void ForEachMemMap(std::function<void(const MemMap&)> func) const override REQUIRES(!lock_);
+  std::pair<uint8_t*, uint8_t*> GetBeginEndAtomic() const override REQUIRES(!lock_);
+  void ClampGrowthLimit(size_t capacity) override REQUIRES(!lock_);
+
+ protected:
+  bool IsZygoteLargeObject(Thread* self, mirror::Object* obj) const override;
+  void SetAllLargeObjectsAsZygoteObjects(Thread* self, bool set_mark_bit) override
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+ private:
+  class RunInfo;
+
+  static constexpr uint32_t kNoRun = 0;
+
+  SegregatedFreeListSpace(const std::string& name, MemMap&& mem_map, MemMap&& run_info_map);
+
+  size_t GetSlotForAddress(uintptr_t address) const {
+    DCHECK(Contains(reinterpret_cast<mirror::Object*>(address)));
+    return (address - reinterpret_cast<uintptr_t>(Begin())) / ObjectAlignment();
+  }
+  uint8_t* GetAddressForSlot(size_t slot) const {
+    return Begin() + slot * ObjectAlignment();
+  }
+  // Index of the smallest size class of at least `slots` slots.
+  size_t GetSizeClassAtLeast(size_t slots) const;
+  // Index of the largest size class of at most `slots` slots. Free runs of `slots` slots are kept
+  // in its list.
+  size_t GetSizeClassAtMost(size_t slots) const;
+  // Lock-free push and pop of free runs. Runs are identified by their first slot plus one, so
+  // that kNoRun can denote the empty list.
+  void PushFreeRuns(size_t size_class, uint32_t first_run, uint32_t last_run);
+  uint32_t PopFreeRun(size_t size_class);
+  uint32_t PopAllFreeRuns(size_t size_class);
+  // Carve a run of `slots` slots out of the untouched end of the space.
+  uint32_t AllocFromFrontier(Thread* self, size_t slots) REQUIRES(!lock_);
+
+  MemMap mem_map_;
+  // Side table with one RunInfo per slot, of which only the ones of the first slot of each run are
+  // valid.
+  MemMap run_info_map_;
+  RunInfo* const run_infos_;
+  // Size in slots of each size class, ascending.
+  std::vector<uint32_t> size_class_slots_;
+  // Head of the free list of each size class. The low 32 bits hold the first run, the high 32
+  // bits a counter bumped on every update to avoid ABA problems.
+  std::unique_ptr<std::atomic<uint64_t>[]> free_run_heads_;
+  // Number of slots handed out from the start of the space, and the capacity in slots.
+  size_t frontier_ GUARDED_BY(lock_);
+  size_t num_slots_ GUARDED_BY(lock_);
+  std::atomic<uint64_t> bytes_allocated_;
+  std::atomic<uint64_t> objects_allocated_;
+};
+
 }  // namespace space
 }  // namespace gc
 }  // namespace art
@@ -26,6 +26,7 @@ namespace space {
 class LargeObjectSpaceTest : public SpaceTest<CommonRuntimeTest> {
  public:
   void LargeObjectTest();
+  void SegregatedFreeListReuseTest();
 
   static constexpr size_t kNumThreads = 10;
   static constexpr size_t kNumIterations = 1000;
@@ -36,13 +37,15 @@ class LargeObjectSpaceTest : public SpaceTest<CommonRuntimeTest> {
 void LargeObjectSpaceTest::LargeObjectTest() {
   size_t rand_seed = 0;
   Thread* const self = Thread::Current();
-  for (size_t i = 0; i < 2; ++i) {
+  for (size_t i = 0; i < 3; ++i) {
     LargeObjectSpace* los = nullptr;
     const size_t capacity = 128 * MB;
     if (i == 0) {
       los = space::LargeObjectMapSpace::Create("large object space");
-    } else {
+    } else if (i == 1) {
       los = space::FreeListSpace::Create("large object space", capacity);
+    } else {
+      los = space::SegregatedFreeListSpace::Create("large object space", capacity);
     }
 
     // Make sure the bitmap is not empty and actually covers at least how much we expect.
@@ -110,12 +113,14 @@ void LargeObjectSpaceTest::LargeObjectTest() {
     los->Dump(oss);
     LOG(INFO) << oss.str();
 
-    size_t bytes_allocated = 0, bytes_tl_bulk_allocated;
-    // Checks that the coalescing works.
-    mirror::Object* obj = los->Alloc(self, 100 * MB, &bytes_allocated, nullptr,
-                                     &bytes_tl_bulk_allocated);
-    EXPECT_TRUE(obj != nullptr);
-    los->Free(Thread::Current(), obj);
+    if (i != 2) {
+      size_t bytes_allocated = 0, bytes_tl_bulk_allocated;
+      // Checks that the coalescing works. The segregated free list space does not coalesce.
+      mirror::Object* obj = los->Alloc(self, 100 * MB, &bytes_allocated, nullptr,
+                                       &bytes_tl_bulk_allocated);
+      EXPECT_TRUE(obj != nullptr);
+      los->Free(Thread::Current(), obj);
+    }
 
     EXPECT_EQ(0U, los->GetBytesAllocated());
     EXPECT_EQ(0U, los->GetObjectsAllocated());
@@ -123,6 +128,47 @@ void LargeObjectSpaceTest::LargeObjectTest() {
   }
 }
 
+void LargeObjectSpaceTest::SegregatedFreeListReuseTest() {
+  Thread* const self = Thread::Current();
+  std::unique_ptr<LargeObjectSpace> los(
+      space::SegregatedFreeListSpace::Create("large object space", 16 * MB));
+  size_t bytes_allocated = 0, bytes_tl_bulk_allocated;
+  mirror::Object* obj = los->Alloc(self, 100 * KB, &bytes_allocated, nullptr,
+                                   &bytes_tl_bulk_allocated);
+  ASSERT_TRUE(obj != nullptr);
+  memset(obj, 0xFF, 100 * KB);
+  ASSERT_EQ(bytes_allocated, los->Free(self, obj));
+
+  // An allocation of the same size class reuses the freed run, cleared.
+  mirror::Object* obj2 = los->Alloc(self, 100 * KB - 1, &bytes_allocated, nullptr,
+                                    &bytes_tl_bulk_allocated);
+  ASSERT_EQ(obj, obj2);
+  for (size_t k = 0; k < 100 * KB - 1; ++k) {
+    ASSERT_EQ(reinterpret_cast<const uint8_t*>(obj2)[k], 0u);
+  }
+
+  // A smaller allocation splits a larger free run once the frontier is exhausted.
+  mirror::Object* big = los->Alloc(self, 15 * MB, &bytes_allocated, nullptr,
+                                   &bytes_tl_bulk_allocated);
+  ASSERT_TRUE(big != nullptr);
+  const uint8_t* frontier = reinterpret_cast<const uint8_t*>(big) + bytes_allocated;
+  while (frontier < los->End()) {
+    mirror::Object* filler = los->Alloc(self, LargeObjectSpace::ObjectAlignment(),
+                                        &bytes_allocated, nullptr, &bytes_tl_bulk_allocated);
+    ASSERT_TRUE(filler != nullptr);
+    frontier += bytes_allocated;
+  }
+  size_t big_size = los->Free(self, big);
+  mirror::Object* small = los->Alloc(self, MB, &bytes_allocated, nullptr,
+                                     &bytes_tl_bulk_allocated);
+  EXPECT_EQ(big, small);
+  EXPECT_EQ(MB, bytes_allocated);
+
+  // Only free runs get released, and only once.
+  EXPECT_EQ(big_size - MB, los->Trim(std::numeric_limits<size_t>::max()));
+  EXPECT_EQ(0u, los->Trim(std::numeric_limits<size_t>::max()));
+}
+
 class AllocRaceTask : public Task {
  public:
   AllocRaceTask(size_t id, size_t iterations, size_t size, LargeObjectSpace* los) :
@@ -152,12 +198,14 @@ class AllocRaceTask : public Task {
 };
 
 void LargeObjectSpaceTest::RaceTest() {
-  for (size_t los_type = 0; los_type < 2; ++los_type) {
+  for (size_t los_type = 0; los_type < 3; ++los_type) {
     LargeObjectSpace* los = nullptr;
     if (los_type == 0) {
       los = space::LargeObjectMapSpace::Create("large object space");
-    } else {
+    } else if (los_type == 1) {
       los = space::FreeListSpace::Create("large object space", 128 * MB);
+    } else {
+      los = space::SegregatedFreeListSpace::Create("large object space", 128 * MB);
     }
 
     Thread* self = Thread::Current();
@@ -179,6 +227,10 @@ TEST_F(LargeObjectSpaceTest, LargeObjectTest) {
   LargeObjectTest();
 }
 
+TEST_F(LargeObjectSpaceTest, SegregatedFreeListReuseTest) {
+  SegregatedFreeListReuseTest();
+}
+
 TEST_F(LargeObjectSpaceTest, RaceTest) {
   RaceTest();
 }
@@ -72,8 +72,9 @@ class MallocSpace : public ContinuousMemMapAllocSpace {
 
   void* MoreCore(intptr_t increment);
 
-  // Hands unused pages back to the system.
-  virtual size_t Trim() = 0;
+  // Hands unused pages back to the system. Implementations that can release pages piecemeal
+  // stop once about `max_bytes` are released. Returns the number of bytes released.
+  virtual size_t Trim(size_t max_bytes) = 0;
 
   // Perform a mspace_inspect_all which calls back for each allocation chunk. The chunk may not be
   // in use, indicated by num_bytes equaling zero.
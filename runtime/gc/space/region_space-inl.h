@@ -54,20 +54,15 @@ inline mirror::Object* RegionSpace::AllocNonvirtual(size_t num_bytes,
   mirror::Object* obj;
   if (LIKELY(num_bytes <= kRegionSize)) {
     // Non-large object.
-    obj = (kForEvac ? evac_region_ : current_region_)->Alloc(num_bytes,
-                                                             bytes_allocated,
-                                                             usable_size,
-                                                             bytes_tl_bulk_allocated);
+    Region** region_slot = kForEvac ? GetEvacRegionSlot() : &current_region_;
+    obj = (*region_slot)->Alloc(num_bytes, bytes_allocated, usable_size, bytes_tl_bulk_allocated);
     if (LIKELY(obj != nullptr)) {
       return obj;
     }
     MutexLock mu(Thread::Current(), region_lock_);
     // Retry with current region since another thread may have updated
-    // current_region_ or evac_region_.  TODO: fix race.
-    obj = (kForEvac ? evac_region_ : current_region_)->Alloc(num_bytes,
-                                                             bytes_allocated,
-                                                             usable_size,
-                                                             bytes_tl_bulk_allocated);
+    // current_region_ or the evacuation region.  TODO: fix race.
+    obj = (*region_slot)->Alloc(num_bytes, bytes_allocated, usable_size, bytes_tl_bulk_allocated);
     if (LIKELY(obj != nullptr)) {
       return obj;
     }
@@ -77,11 +72,7 @@ inline mirror::Object* RegionSpace::AllocNonvirtual(size_t num_bytes,
       CHECK(obj != nullptr);
       // Do our allocation before setting the region, this makes sure no threads race ahead
       // and fill in the region before we allocate the object. b/63153464
-      if (kForEvac) {
-        evac_region_ = r;
-      } else {
-        current_region_ = r;
-      }
+      *region_slot = r;
       return obj;
     }
   } else {
@@ -407,7 +398,7 @@ inline mirror::Object* RegionSpace::AllocLargeInRange(size_t begin,
       DCHECK_EQ(left + num_regs_in_large_region, right);
       Region* first_reg = &regions_[left];
       DCHECK(first_reg->IsFree());
-      first_reg->UnfreeLarge(this, time_);
+      first_reg->UnfreeLarge(this, GetAllocTime(kForEvac));
       if (kForEvac) {
         ++num_evac_regions_;
       } else {
@@ -424,7 +415,7 @@ inline mirror::Object* RegionSpace::AllocLargeInRange(size_t begin,
       for (size_t p = left + 1; p < right; ++p) {
         DCHECK_LT(p, num_regions_);
         DCHECK(regions_[p].IsFree());
-        regions_[p].UnfreeLargeTail(this, time_);
+        regions_[p].UnfreeLargeTail(this, GetAllocTime(kForEvac));
         if (kForEvac) {
           ++num_evac_regions_;
         } else {
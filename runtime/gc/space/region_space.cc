@@ -15,11 +15,22 @@
  */
 #include <deque>
 
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
+#include "android-base/file.h"
+#include "android-base/parseint.h"
+#include "android-base/stringprintf.h"
+#include "android-base/strings.h"
+
 #include "bump_pointer_space-inl.h"
 #include "bump_pointer_space.h"
 #include "base/dumpable.h"
 #include "base/logging.h"
 #include "gc/accounting/read_barrier_table.h"
+#include "gc/collector/object_ages.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 #include "thread_list.h"
@@ -47,18 +58,31 @@ static constexpr uint32_t kPoisonDeadObject = 0xBADDB01D;  // "BADDROID"
 // Whether we check a region's live bytes count against the region bitmap.
 static constexpr bool kCheckLiveBytesAgainstRegionBitmap = kIsDebugBuild;
 
+// Memory policy passed to mbind(2) for NUMA-aware region allocation. We only
+// express a preference so that a node running out of memory falls back to
+// the others instead of failing the page fault.
+static constexpr int kMpolPreferred = 1;
+
 MemMap RegionSpace::CreateMemMap(const std::string& name,
                                  size_t capacity,
-                                 uint8_t* requested_begin) {
+                                 uint8_t* requested_begin,
+                                 bool use_huge_pages) {
   CHECK_ALIGNED(capacity, kRegionSize);
   std::string error_msg;
-  // Ask for the capacity of an additional kRegionSize so that we can align the map by kRegionSize
-  // even if we get unaligned base address. This is necessary for the ReadBarrierTable to work.
+  // Align to huge pages if requested so that no huge page straddles the ends of the space.
+  const size_t alignment =
+      use_huge_pages && IsAlignedParam(capacity, MemMap::GetHugePageSize())
+          ? MemMap::GetHugePageSize()
+          : kRegionSize;
+  DCHECK_ALIGNED_PARAM(alignment, kRegionSize);
+  // Ask for the capacity of an additional alignment so that we can align the map by it even if we
+  // get unaligned base address. Alignment by kRegionSize is necessary for the ReadBarrierTable to
+  // work.
   MemMap mem_map;
   while (true) {
     mem_map = MemMap::MapAnonymous(name.c_str(),
                                    requested_begin,
-                                   capacity + kRegionSize,
+                                   capacity + alignment,
                                    PROT_READ | PROT_WRITE,
                                    /*low_4gb=*/ true,
                                    /*reuse=*/ false,
@@ -77,29 +101,37 @@ MemMap RegionSpace::CreateMemMap(const std::string& name,
     MemMap::DumpMaps(LOG_STREAM(ERROR));
     return MemMap::Invalid();
   }
-  CHECK_EQ(mem_map.Size(), capacity + kRegionSize);
+  CHECK_EQ(mem_map.Size(), capacity + alignment);
   CHECK_EQ(mem_map.Begin(), mem_map.BaseBegin());
   CHECK_EQ(mem_map.Size(), mem_map.BaseSize());
-  if (IsAlignedParam(mem_map.Begin(), kRegionSize)) {
-    // Got an aligned map. Since we requested a map that's kRegionSize larger. Shrink by
-    // kRegionSize at the end.
+  if (IsAlignedParam(mem_map.Begin(), alignment)) {
+    // Got an aligned map. Since we requested a map that's alignment larger. Shrink by
+    // alignment at the end.
     mem_map.SetSize(capacity);
   } else {
     // Got an unaligned map. Align the both ends.
-    mem_map.AlignBy(kRegionSize);
+    mem_map.AlignBy(alignment);
   }
-  CHECK_ALIGNED(mem_map.Begin(), kRegionSize);
-  CHECK_ALIGNED(mem_map.End(), kRegionSize);
+  CHECK_ALIGNED_PARAM(mem_map.Begin(), alignment);
+  CHECK_ALIGNED_PARAM(mem_map.End(), alignment);
   CHECK_EQ(mem_map.Size(), capacity);
+  if (use_huge_pages && mem_map.MadviseHugePage() != 0) {
+    PLOG(WARNING) << "Failed to back " << name << " with huge pages";
+  }
   return mem_map;
 }
 
-RegionSpace* RegionSpace::Create(
-    const std::string& name, MemMap&& mem_map, bool use_generational_cc) {
-  return new RegionSpace(name, std::move(mem_map), use_generational_cc);
+RegionSpace* RegionSpace::Create(const std::string& name,
+                                 MemMap&& mem_map,
+                                 bool use_generational_cc,
+                                 bool use_numa_aware_regions) {
+  return new RegionSpace(name, std::move(mem_map), use_generational_cc, use_numa_aware_regions);
 }
 
-RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_generational_cc)
+RegionSpace::RegionSpace(const std::string& name,
+                         MemMap&& mem_map,
+                         bool use_generational_cc,
+                         bool use_numa_aware_regions)
     : ContinuousMemMapAllocSpace(name,
                                  std::move(mem_map),
                                  mem_map.Begin(),
@@ -116,8 +148,9 @@ RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_gen
       max_peak_num_non_free_regions_(0U),
       non_free_region_index_limit_(0U),
       current_region_(&full_region_),
-      evac_region_(nullptr),
-      cyclic_alloc_region_index_(0U) {
+      cyclic_alloc_region_index_(0U),
+      num_numa_nodes_(1U),
+      regions_per_numa_node_(num_regions_) {
   CHECK_ALIGNED(mem_map_.Size(), kRegionSize);
   CHECK_ALIGNED(mem_map_.Begin(), kRegionSize);
   DCHECK_GT(num_regions_, 0U);
@@ -143,10 +176,97 @@ RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_gen
   DCHECK(full_region_.IsAllocated());
   size_t ignored;
   DCHECK(full_region_.Alloc(kAlignment, &ignored, nullptr, &ignored) == nullptr);
+  SetEvacRegions(nullptr);
+  if (use_numa_aware_regions) {
+    InitNumaNodes();
+  }
   // Protect the whole region space from the start.
   Protect();
 }
 
+// Parse a sysfs CPU/node list such as "0-3,8-11" and call `fn` on every entry.
+template <typename Fn>
+static bool ParseSysfsList(const std::string& list, Fn fn) {
+  for (const std::string& range : android::base::Split(android::base::Trim(list), ",")) {
+    std::vector<std::string> bounds = android::base::Split(range, "-");
+    size_t first;
+    if (bounds.empty() || bounds.size() > 2 || !android::base::ParseUint(bounds[0], &first)) {
+      return false;
+    }
+    size_t last = first;
+    if (bounds.size() == 2 && !android::base::ParseUint(bounds[1], &last)) {
+      return false;
+    }
+    for (size_t i = first; i <= last; ++i) {
+      fn(i);
+    }
+  }
+  return true;
+}
+
+void RegionSpace::InitNumaNodes() {
+#if defined(__linux__) && defined(__NR_mbind)
+  std::string nodes;
+  size_t num_nodes = 0;
+  if (!android::base::ReadFileToString("/sys/devices/system/node/online", &nodes) ||
+      !ParseSysfsList(nodes, [&](size_t node) { num_nodes = std::max(num_nodes, node + 1); })) {
+    VLOG(heap) << "Couldn't read NUMA nodes, disabling NUMA-aware region allocation";
+    return;
+  }
+  num_nodes = std::min(num_nodes, kMaxNumaNodes);
+  if (num_nodes <= 1 || num_regions_ < num_nodes) {
+    return;
+  }
+  std::vector<uint8_t> cpu_to_node;
+  for (size_t node = 0; node < num_nodes; ++node) {
+    std::string cpus;
+    std::string path = android::base::StringPrintf("/sys/devices/system/node/node%zu/cpulist", node);
+    if (!android::base::ReadFileToString(path, &cpus) ||
+        !ParseSysfsList(cpus, [&](size_t cpu) {
+          if (cpu >= cpu_to_node.size()) {
+            cpu_to_node.resize(cpu + 1, 0u);
+          }
+          cpu_to_node[cpu] = static_cast<uint8_t>(node);
+        })) {
+      VLOG(heap) << "Couldn't read CPUs of NUMA node " << node;
+      return;
+    }
+  }
+  size_t regions_per_node = RoundUp(num_regions_, num_nodes) / num_nodes;
+  for (size_t node = 0; node < num_nodes; ++node) {
+    size_t first_region = node * regions_per_node;
+    size_t num_node_regions = std::min(regions_per_node, num_regions_ - first_region);
+    unsigned long node_mask = 1UL << node;  // NOLINT(runtime/int)
+    if (syscall(__NR_mbind,
+                regions_[first_region].Begin(),
+                num_node_regions * kRegionSize,
+                kMpolPreferred,
+                &node_mask,
+                sizeof(node_mask) * kBitsPerByte,
+                /*flags=*/0) != 0) {
+      PLOG(WARNING) << "mbind failed for NUMA node " << node
+                    << ", disabling NUMA-aware region allocation";
+      return;
+    }
+  }
+  cpu_to_numa_node_ = std::move(cpu_to_node);
+  regions_per_numa_node_ = regions_per_node;
+  num_numa_nodes_ = num_nodes;
+  VLOG(heap) << "Region space bound to " << num_nodes << " NUMA nodes, " << regions_per_node
+             << " regions each";
+#endif
+}
+
+size_t RegionSpace::GetCurrentNumaNode() const {
+#if defined(__linux__)
+  int cpu = sched_getcpu();
+  if (LIKELY(cpu >= 0 && static_cast<size_t>(cpu) < cpu_to_numa_node_.size())) {
+    return cpu_to_numa_node_[cpu];
+  }
+#endif
+  return 0;
+}
+
 size_t RegionSpace::FromSpaceSize() {
   uint64_t num_regions = 0;
   MutexLock mu(Thread::Current(), region_lock_);
@@ -225,7 +345,8 @@ inline bool RegionSpace::Region::ShouldBeEvacuated(EvacMode evac_mode) {
   // The region should be evacuated if:
   // - the evacuation is forced (!large && `evac_mode == kEvacModeForceAll`); or
   // - the region was allocated after the start of the previous GC (newly allocated region); or
-  // - !large and the live ratio is below threshold (`kEvacuateLivePercentThreshold`).
+  // - !large and the live ratio is below threshold (`kEvacuateLivePercentThreshold`). Of these
+  //   regions, SetFromSpace() only evacuates the ones SelectRegionsToEvacuate() picks.
   if (IsLarge()) {
     // It makes no sense to evacuate in the large case, since the region only contains zero or
     // one object. If the regions is completely empty, we'll reclaim it anyhow. If its one object
@@ -306,6 +427,47 @@ void RegionSpace::ZeroLiveBytesForLargeObject(mirror::Object* obj) {
   }
 }
 
+std::vector<bool> RegionSpace::SelectRegionsToEvacuate(size_t limit) {
+  struct Candidate {
+    size_t index;
+    double score;
+  };
+  std::vector<Candidate> candidates;
+  // The copied bytes must fit in the free regions, which the newly allocated regions, that are
+  // always evacuated, use first.
+  uint64_t copy_budget = (num_regions_ - num_non_free_regions_) * kRegionSize;
+  for (size_t i = 0; i < limit; ++i) {
+    Region* r = &regions_[i];
+    if (!r->IsAllocated()) {
+      continue;
+    }
+    if (r->is_newly_allocated_) {
+      copy_budget -= std::min<uint64_t>(copy_budget, r->BytesAllocated());
+    } else if (r->pin_count_.load(std::memory_order_relaxed) == 0u &&
+               r->ShouldBeEvacuated(kEvacModeLivePercentNewlyAllocated)) {
+      // The cost-benefit ratio of log-structured file system cleaners: the freed bytes, aged,
+      // over the cost of reading the region and copying its live bytes. Old sparse regions are
+      // unlikely to get sparser by themselves.
+      const double allocated = RoundUp(r->BytesAllocated(), kRegionSize);
+      const double live = r->LiveBytes();
+      const double age = time_ - r->alloc_time_;
+      candidates.push_back({i, (allocated - live) * age / (allocated + live)});
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs) {
+    return lhs.score > rhs.score;
+  });
+  std::vector<bool> selected(limit, false);
+  for (const Candidate& candidate : candidates) {
+    const size_t live_bytes = regions_[candidate.index].LiveBytes();
+    if (live_bytes <= copy_budget) {
+      selected[candidate.index] = true;
+      copy_budget -= live_bytes;
+    }
+  }
+  return selected;
+}
+
 // Determine which regions to evacuate and mark them as
 // from-space. Mark the rest as unevacuated from-space.
 void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
@@ -332,6 +494,9 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
   const size_t iter_limit = kUseTableLookupReadBarrier
       ? num_regions_
       : std::min(num_regions_, non_free_region_index_limit_);
+  const std::vector<bool> selected_regions = evac_mode == kEvacModeLivePercentNewlyAllocated
+      ? SelectRegionsToEvacuate(iter_limit)
+      : std::vector<bool>();
   for (size_t i = 0; i < iter_limit; ++i) {
     Region* r = &regions_[i];
     RegionState state = r->State();
@@ -342,8 +507,16 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
         DCHECK((state == RegionState::kRegionStateAllocated ||
                 state == RegionState::kRegionStateLarge) &&
                type == RegionType::kRegionTypeToSpace);
-        bool should_evacuate = r->ShouldBeEvacuated(evac_mode);
         bool is_newly_allocated = r->IsNewlyAllocated();
+        bool should_evacuate = r->ShouldBeEvacuated(evac_mode);
+        if (should_evacuate && !is_newly_allocated && !selected_regions.empty()) {
+          should_evacuate = selected_regions[i];
+        }
+        if (should_evacuate && r->pin_count_.load(std::memory_order_relaxed) != 0u) {
+          // Pinned by a JNI critical section, see `TryPinObject()`.
+          DCHECK(!is_newly_allocated);
+          should_evacuate = false;
+        }
         if (should_evacuate) {
           r->SetAsFromSpace();
           DCHECK(r->IsInFromSpace());
@@ -390,7 +563,7 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
   }
   DCHECK_EQ(num_expected_large_tails, 0U);
   current_region_ = &full_region_;
-  evac_region_ = &full_region_;
+  SetEvacRegions(&full_region_);
 }
 
 static void ZeroAndProtectRegion(uint8_t* begin, uint8_t* end, bool release_eagerly) {
@@ -416,7 +589,8 @@ void RegionSpace::ReleaseFreeRegions() {
 void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
                                  /* out */ uint64_t* cleared_objects,
                                  const bool clear_bitmap,
-                                 const bool release_eagerly) {
+                                 const bool release_eagerly,
+                                 /* out */ collector::ObjectAges* object_ages) {
   DCHECK(cleared_bytes != nullptr);
   DCHECK(cleared_objects != nullptr);
   *cleared_bytes = 0;
@@ -464,6 +638,17 @@ void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
       if (kCheckLiveBytesAgainstRegionBitmap) {
         CheckLiveBytesAgainstRegionBitmap(r);
       }
+      if (object_ages != nullptr &&
+          (r->IsInFromSpace() || r->IsInUnevacFromSpace()) &&
+          !r->IsLargeTail()) {
+        // The bytes of large regions, including their tails, are accounted for in the first one.
+        DCHECK_LT(r->alloc_time_, time_);
+        const size_t bytes = r->BytesAllocated();
+        const size_t surviving_bytes = r->IsInFromSpace()
+            ? r->evacuated_bytes_.load(std::memory_order_relaxed)
+            : r->LiveBytes();
+        object_ages->Add(time_ - r->alloc_time_ - 1, bytes, std::min(surviving_bytes, bytes));
+      }
       if (r->IsInFromSpace()) {
         expand_madvise_range(r);
       } else if (r->IsInUnevacFromSpace()) {
@@ -626,7 +811,7 @@ void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
   }
   // Update non_free_region_index_limit_.
   SetNonFreeRegionLimit(new_non_free_region_index_limit);
-  evac_region_ = nullptr;
+  SetEvacRegions(nullptr);
   num_non_free_regions_ += num_evac_regions_;
   num_evac_regions_ = 0;
 }
@@ -786,7 +971,7 @@ void RegionSpace::Clear() {
   SetNonFreeRegionLimit(0);
   DCHECK_EQ(num_non_free_regions_, 0u);
   current_region_ = &full_region_;
-  evac_region_ = &full_region_;
+  SetEvacRegions(&full_region_);
 }
 
 void RegionSpace::Protect() {
@@ -922,6 +1107,8 @@ void RegionSpace::RevokeThreadLocalBuffersLocked(Thread* thread, bool reuse) {
     size_t remaining_bytes = r->End() - thread->GetTlabPos();
     if (reuse && remaining_bytes >= gc::Heap::kPartialTlabSize) {
       partial_tlabs_.insert(std::make_pair(remaining_bytes, r));
+    } else {
+      Runtime::Current()->GetHeap()->RecordTlabWaste(thread->TlabSize());
     }
   }
   thread->ResetTlab();
@@ -1019,10 +1206,12 @@ size_t RegionSpace::AllocationSizeNonvirtual(mirror::Object* obj, size_t* usable
 }
 
 void RegionSpace::Region::Clear(bool zero_and_release_pages) {
+  DCHECK_EQ(pin_count_.load(std::memory_order_relaxed), 0u);
   top_.store(begin_, std::memory_order_relaxed);
   state_ = RegionState::kRegionStateFree;
   type_ = RegionType::kRegionTypeNone;
   objects_allocated_.store(0, std::memory_order_relaxed);
+  evacuated_bytes_.store(0, std::memory_order_relaxed);
   alloc_time_ = 0;
   live_bytes_ = static_cast<size_t>(-1);
   if (zero_and_release_pages) {
@@ -1042,6 +1231,18 @@ RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac) {
   if (!for_evac && (num_non_free_regions_ + 1) * 2 > num_regions_) {
     return nullptr;
   }
+  if (num_numa_nodes_ > 1) {
+    // Prefer a region bound to the NUMA node of the allocating (or, for
+    // evacuation, copying) thread. Fall back to any free region below.
+    size_t begin = GetCurrentNumaNode() * regions_per_numa_node_;
+    size_t end = std::min(begin + regions_per_numa_node_, num_regions_);
+    for (size_t region_index = begin; region_index < end; ++region_index) {
+      Region* r = &regions_[region_index];
+      if (r->IsFree()) {
+        return ClaimFreeRegion(r, for_evac);
+      }
+    }
+  }
   for (size_t i = 0; i < num_regions_; ++i) {
     // When using the cyclic region allocation strategy, try to
     // allocate a region starting from the last cyclic allocated
@@ -1052,30 +1253,35 @@ RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac) {
         : i;
     Region* r = &regions_[region_index];
     if (r->IsFree()) {
-      r->Unfree(this, time_);
-      if (use_generational_cc_) {
-        // TODO: Add an explanation for this assertion.
-        DCHECK_IMPLIES(for_evac, !r->is_newly_allocated_);
-      }
-      if (for_evac) {
-        ++num_evac_regions_;
-        TraceHeapSize();
-        // Evac doesn't count as newly allocated.
-      } else {
-        r->SetNewlyAllocated();
-        ++num_non_free_regions_;
-      }
       if (kCyclicRegionAllocation) {
         // Move the cyclic allocation region marker to the region
         // following the one that was just allocated.
         cyclic_alloc_region_index_ = (region_index + 1) % num_regions_;
       }
-      return r;
+      return ClaimFreeRegion(r, for_evac);
     }
   }
   return nullptr;
 }
 
+RegionSpace::Region* RegionSpace::ClaimFreeRegion(Region* r, bool for_evac) {
+  DCHECK(r->IsFree());
+  r->Unfree(this, GetAllocTime(for_evac));
+  if (use_generational_cc_) {
+    // TODO: Add an explanation for this assertion.
+    DCHECK_IMPLIES(for_evac, !r->is_newly_allocated_);
+  }
+  if (for_evac) {
+    ++num_evac_regions_;
+    TraceHeapSize();
+    // Evac doesn't count as newly allocated.
+  } else {
+    r->SetNewlyAllocated();
+    ++num_non_free_regions_;
+  }
+  return r;
+}
+
 void RegionSpace::Region::MarkAsAllocated(RegionSpace* region_space, uint32_t alloc_time) {
   DCHECK(IsFree());
   alloc_time_ = alloc_time;
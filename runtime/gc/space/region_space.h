@@ -22,8 +22,10 @@
 #include "space.h"
 #include "thread.h"
 
+#include <algorithm>
 #include <functional>
 #include <map>
+#include <vector>
 
 namespace art HIDDEN {
 namespace gc {
@@ -32,6 +34,10 @@ namespace accounting {
 class ReadBarrierTable;
 }  // namespace accounting
 
+namespace collector {
+struct ObjectAges;
+}  // namespace collector
+
 namespace space {
 
 // Cyclic region allocation strategy. If `true`, region allocation
@@ -43,6 +49,10 @@ namespace space {
 // only enable it in debug mode.
 static constexpr bool kCyclicRegionAllocation = kIsDebugBuild;
 
+// Maximum number of NUMA nodes the region space distributes its regions over
+// when NUMA-aware region allocation (-Xgc:numa_regions) is enabled.
+static constexpr size_t kMaxNumaNodes = 8;
+
 // A space that consists of equal-sized regions.
 class RegionSpace final : public ContinuousMemMapAllocSpace {
  public:
@@ -61,8 +71,17 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // Create a region space mem map with the requested sizes. The requested base address is not
   // guaranteed to be granted, if it is required, the caller should call Begin on the returned
   // space to confirm the request was granted.
-  static MemMap CreateMemMap(const std::string& name, size_t capacity, uint8_t* requested_begin);
-  static RegionSpace* Create(const std::string& name, MemMap&& mem_map, bool use_generational_cc);
+  // If use_huge_pages is true, the map is aligned to the huge page size (if the capacity is a
+  // multiple of it) and backed by transparent huge pages where possible. Releasing a region then
+  // splits the huge page covering it.
+  static MemMap CreateMemMap(const std::string& name,
+                             size_t capacity,
+                             uint8_t* requested_begin,
+                             bool use_huge_pages = false);
+  static RegionSpace* Create(const std::string& name,
+                             MemMap&& mem_map,
+                             bool use_generational_cc,
+                             bool use_numa_aware_regions);
 
   // Allocate `num_bytes`, returns null if the space is full.
   mirror::Object* Alloc(Thread* self,
@@ -264,6 +283,41 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     return false;
   }
 
+  // Pin the region holding `ref` so that the next flips do not evacuate it, until the
+  // matching `UnpinObject()`. Objects in newly allocated regions cannot be pinned, as those
+  // regions are always evacuated; returns false in that case. Large objects are never moved
+  // and are always considered pinned. Must be called while runnable, so that pinning can
+  // not race with `SetFromSpace()`.
+  bool TryPinObject(mirror::Object* ref) REQUIRES_SHARED(Locks::mutator_lock_) {
+    DCHECK(HasAddress(ref));
+    Region* r = RefToRegionUnlocked(ref);
+    DCHECK(!r->IsFree());
+    DCHECK(!r->IsInFromSpace());
+    if (r->IsLarge()) {
+      return true;
+    }
+    if (r->IsNewlyAllocated()) {
+      return false;
+    }
+    r->pin_count_.fetch_add(1u, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Undo a successful `TryPinObject()`. Returns false if the region holding `ref` is not
+  // pinned, i.e. the earlier `TryPinObject()` for `ref` failed.
+  bool UnpinObject(mirror::Object* ref) REQUIRES_SHARED(Locks::mutator_lock_) {
+    DCHECK(HasAddress(ref));
+    Region* r = RefToRegionUnlocked(ref);
+    if (r->IsLarge()) {
+      return true;
+    }
+    if (r->pin_count_.load(std::memory_order_relaxed) == 0u) {
+      return false;
+    }
+    r->pin_count_.fetch_sub(1u, std::memory_order_relaxed);
+    return true;
+  }
+
   bool IsLargeObject(mirror::Object* ref) {
     if (HasAddress(ref)) {
       Region* r = RefToRegionUnlocked(ref);
@@ -311,10 +365,13 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   size_t FromSpaceSize() REQUIRES(!region_lock_);
   size_t UnevacFromSpaceSize() REQUIRES(!region_lock_);
   size_t ToSpaceSize() REQUIRES(!region_lock_);
+  // Also records in `object_ages` the ages of the bytes of the from-space regions, and how many
+  // of them survived, if it is not null.
   void ClearFromSpace(/* out */ uint64_t* cleared_bytes,
                       /* out */ uint64_t* cleared_objects,
                       const bool clear_bitmap,
-                      const bool release_eagerly)
+                      const bool release_eagerly,
+                      /* out */ collector::ObjectAges* object_ages = nullptr)
       REQUIRES(!region_lock_);
 
   void AddLiveBytes(mirror::Object* ref, size_t alloc_size) {
@@ -322,6 +379,13 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     reg->AddLiveBytes(alloc_size);
   }
 
+  // Record that `alloc_size` bytes of the evacuated object `ref` were copied out of its region.
+  void AddEvacuatedBytes(mirror::Object* ref, size_t alloc_size) {
+    Region* reg = RefToRegionUnlocked(ref);
+    DCHECK(reg->IsInFromSpace());
+    reg->evacuated_bytes_.fetch_add(alloc_size, std::memory_order_relaxed);
+  }
+
   void AssertAllRegionLiveBytesZeroOrCleared() REQUIRES(!region_lock_) {
     if (kIsDebugBuild) {
       MutexLock mu(Thread::Current(), region_lock_);
@@ -400,6 +464,8 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
           top_(nullptr),
           end_(nullptr),
           objects_allocated_(0),
+          evacuated_bytes_(0),
+          pin_count_(0),
           alloc_time_(0),
           is_newly_allocated_(false),
           is_a_tlab_(false),
@@ -414,6 +480,8 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       state_ = RegionState::kRegionStateFree;
       type_ = RegionType::kRegionTypeNone;
       objects_allocated_.store(0, std::memory_order_relaxed);
+      evacuated_bytes_.store(0, std::memory_order_relaxed);
+      pin_count_.store(0, std::memory_order_relaxed);
       alloc_time_ = 0;
       live_bytes_ = static_cast<size_t>(-1);
       is_newly_allocated_ = false;
@@ -541,6 +609,7 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       // evacuation decision (possibly based on the percentage of live
       // bytes).
       live_bytes_ = static_cast<size_t>(-1);
+      evacuated_bytes_.store(0, std::memory_order_relaxed);
     }
 
     // Set this region as unevacuated from-space. At the end of the
@@ -634,7 +703,16 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     // objects_allocated_ is accessed using memory_order_relaxed. Treat as approximate when there
     // are concurrent updates.
     Atomic<size_t> objects_allocated_;  // The number of objects allocated.
-    uint32_t alloc_time_;               // The allocation time of the region.
+    // The bytes copied out of the region, while it is in the evacuated from-space.
+    Atomic<size_t> evacuated_bytes_;
+    // The number of JNI critical sections holding an object in this region. A pinned region
+    // is never evacuated. Only changed by runnable threads, and read during the flip pause.
+    Atomic<uint32_t> pin_count_;
+    // The allocation time of the region. Regions allocated for evacuation get the time of the
+    // previous collection (see RegionSpace::GetAllocTime()), as their objects already survived
+    // the current one. The age of the objects of a region at a collection is thus
+    // `time_ - alloc_time_ - 1`.
+    uint32_t alloc_time_;
     // Note that newly allocated and evacuated regions use -1 as
     // special value for `live_bytes_`.
     bool is_newly_allocated_;           // True if it's allocated after the last collection.
@@ -716,6 +794,35 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   }
 
   EXPORT Region* AllocateRegion(bool for_evac) REQUIRES(region_lock_);
+  // Take the free region `r` out of the free list for allocation or evacuation.
+  Region* ClaimFreeRegion(Region* r, bool for_evac) REQUIRES(region_lock_);
+
+  // The allocation time of a new region, see Region::alloc_time_.
+  uint32_t GetAllocTime(bool for_evac) const {
+    return for_evac ? time_ - 1 : time_;
+  }
+
+  // For `kEvacModeLivePercentNewlyAllocated`, select which of the regions below `limit` that
+  // are not newly allocated but sparse enough to be evacuated are worth evacuating. The regions
+  // are ranked by the bytes they free per byte copied, weighted by their age, and selected
+  // until the live bytes to copy exceed what the free regions can hold. Returns whether each
+  // region is selected.
+  std::vector<bool> SelectRegionsToEvacuate(size_t limit) REQUIRES(region_lock_);
+
+  // Find the NUMA nodes of the machine and bind an equal, contiguous share of
+  // the regions to each of them. Leaves `num_numa_nodes_` at 1 if the machine
+  // has a single node or binding fails.
+  void InitNumaNodes();
+  // Return the NUMA node of the CPU the calling thread is running on.
+  size_t GetCurrentNumaNode() const;
+  // Return the evacuation region slot to be used by the calling thread.
+  Region** GetEvacRegionSlot() {
+    return &evac_regions_[num_numa_nodes_ > 1 ? GetCurrentNumaNode() : 0];
+  }
+  // Set the evacuation region of every NUMA node to `r`.
+  void SetEvacRegions(Region* r) {
+    std::fill_n(evac_regions_, kMaxNumaNodes, r);
+  }
   void RevokeThreadLocalBuffersLocked(Thread* thread, bool reuse) REQUIRES(region_lock_);
 
   // Scan region range [`begin`, `end`) in increasing order to try to
@@ -777,7 +884,9 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   size_t non_free_region_index_limit_ GUARDED_BY(region_lock_);
 
   Region* current_region_;         // The region currently used for allocation.
-  Region* evac_region_;            // The region currently used for evacuation.
+  // The regions currently used for evacuation, one per NUMA node. Only the
+  // first one is used when NUMA-aware region allocation is disabled.
+  Region* evac_regions_[kMaxNumaNodes];
   Region full_region_;             // The fake/sentinel region that looks full.
 
   // Index into the region array pointing to the starting region when
@@ -785,6 +894,14 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // `kCyclicRegionAllocation` is true.
   size_t cyclic_alloc_region_index_ GUARDED_BY(region_lock_);
 
+  // Number of NUMA nodes the regions are distributed over. Node `n` owns the
+  // regions [n * regions_per_numa_node_, (n + 1) * regions_per_numa_node_).
+  // It is 1 unless NUMA-aware region allocation is enabled and supported.
+  size_t num_numa_nodes_;
+  size_t regions_per_numa_node_;
+  // Map from CPU number to its NUMA node.
+  std::vector<uint8_t> cpu_to_numa_node_;
+
   // Mark bitmap used by the GC.
   accounting::ContinuousSpaceBitmap mark_bitmap_;
 
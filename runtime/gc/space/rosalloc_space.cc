@@ -310,7 +310,7 @@ size_t RosAllocSpace::FreeList(Thread* self, size_t num_ptrs, mirror::Object** p
   return bytes_freed;
 }
 
-size_t RosAllocSpace::Trim() {
+size_t RosAllocSpace::Trim(size_t max_bytes) {
   VLOG(heap) << "RosAllocSpace::Trim() ";
   {
     Thread* const self = Thread::Current();
@@ -322,7 +322,7 @@ size_t RosAllocSpace::Trim() {
   }
   // Attempt to release pages if it does not release all empty pages.
   if (!rosalloc_->DoesReleaseAllPages()) {
-    return rosalloc_->ReleasePages();
+    return rosalloc_->ReleasePages(max_bytes);
   }
   return 0;
 }
@@ -110,7 +110,7 @@ class RosAllocSpace : public MallocSpace {
     return rosalloc_;
   }
 
-  size_t Trim() override;
+  size_t Trim(size_t max_bytes) override;
   void Walk(WalkCallback callback, void* arg) override REQUIRES(!lock_);
   size_t GetFootprint() override;
   size_t GetFootprintLimit() override;
@@ -167,6 +167,11 @@ class EXPORT Space {
   // Returns true if objects in the space are movable.
   virtual bool CanMoveObjects() const = 0;
 
+  // The bytes that heap trims released to the kernel from this space so far.
+  uint64_t GetTrimmedBytes() const {
+    return trimmed_bytes_.load(std::memory_order_relaxed);
+  }
+
   virtual ~Space() {}
 
  protected:
@@ -185,6 +190,9 @@ class EXPORT Space {
   GcRetentionPolicy gc_retention_policy_;
 
  private:
+  // Updated by Heap::TrimSpaces().
+  Atomic<uint64_t> trimmed_bytes_{0};
+
   friend class art::gc::Heap;
   DISALLOW_IMPLICIT_CONSTRUCTORS(Space);
 };
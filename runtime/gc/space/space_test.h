@@ -239,7 +239,7 @@ void SpaceTest<Super>::SizeFootPrintGrowthLimitAndTrimBody(MallocSpace* space,
     {
       ScopedThreadStateChange tsc(self, ThreadState::kNative);
       // Give the space a haircut.
-      space->Trim();
+      space->Trim(std::numeric_limits<size_t>::max());
     }
 
     // Bounds consistency check.
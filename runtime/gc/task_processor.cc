@@ -130,6 +130,11 @@ bool TaskProcessor::IsRunningThread(Thread* t, bool wait) {
   return running_thread_ == t;
 }
 
+pid_t TaskProcessor::GetRunningThreadTid(Thread* self) {
+  MutexLock mu(self, lock_);
+  return running_thread_ != nullptr ? running_thread_->GetTid() : 0;
+}
+
 void TaskProcessor::Stop(Thread* self) {
   MutexLock mu(self, lock_);
   is_running_ = false;
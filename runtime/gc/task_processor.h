@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_GC_TASK_PROCESSOR_H_
 #define ART_RUNTIME_GC_TASK_PROCESSOR_H_
 
+#include <sys/types.h>
+
 #include <memory>
 #include <set>
 
@@ -70,6 +72,9 @@ class TaskProcessor {
   // wait for one to be registered. If we time out, we return true.
   bool IsRunningThread(Thread* t, bool wait = false) REQUIRES(!lock_);
 
+  // Returns the tid of the task processor thread, or 0 if it is not running.
+  pid_t GetRunningThreadTid(Thread* self) REQUIRES(!lock_);
+
  private:
   // Wait briefly for running_thread_ to become non-null. Return false on timeout.
   bool WaitForThread(Thread* self) REQUIRES(lock_);
@@ -30,6 +30,7 @@
 #include <string.h>
 #include <sys/time.h>
 #include <sys/uio.h>
+#include <sys/wait.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -37,10 +38,12 @@
 
 #include <android-base/logging.h>
 #include <android-base/stringprintf.h>
+#include <lz4frame.h>
 
 #include "art_field-inl.h"
 #include "art_method-inl.h"
 #include "base/array_ref.h"
+#include "base/fast_exit.h"
 #include "base/file_utils.h"
 #include "base/logging.h"
 #include "base/macros.h"
@@ -408,6 +411,71 @@ class FileEndianOutput final : public EndianOutputBuffered {
   bool errors_;
 };
 
+// Compresses the output into an LZ4 frame as it is written, so that large dumps need neither a
+// large buffer nor a lot of storage. `lz4 -d` turns the file back into a regular HPROF file.
+class Lz4FileEndianOutput final : public EndianOutputBuffered {
+ public:
+  Lz4FileEndianOutput(File* fp, size_t reserved_size)
+      : EndianOutputBuffered(reserved_size), fp_(fp), context_(nullptr), errors_(false) {
+    DCHECK(fp != nullptr);
+    preferences_ = LZ4F_INIT_PREFERENCES;
+    preferences_.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+    compressed_.resize(LZ4F_compressBound(kInputChunkSize, &preferences_));
+    errors_ = LZ4F_isError(LZ4F_createCompressionContext(&context_, LZ4F_VERSION));
+    if (!errors_) {
+      DCHECK_GE(compressed_.size(), static_cast<size_t>(LZ4F_HEADER_SIZE_MAX));
+      Write(LZ4F_compressBegin(context_, compressed_.data(), compressed_.size(), &preferences_));
+    }
+  }
+  ~Lz4FileEndianOutput() {
+    LZ4F_freeCompressionContext(context_);
+  }
+
+  // Write the end of the frame. Must be called after the last record.
+  bool Finish() {
+    if (!errors_) {
+      Write(LZ4F_compressEnd(context_, compressed_.data(), compressed_.size(), nullptr));
+    }
+    return !errors_;
+  }
+
+  bool Errors() {
+    return errors_;
+  }
+
+ protected:
+  void HandleFlush(const uint8_t* buffer, size_t length) override {
+    // Compress in chunks, so that `compressed_` is always large enough.
+    while (!errors_ && length != 0) {
+      size_t chunk_size = std::min(length, kInputChunkSize);
+      Write(LZ4F_compressUpdate(
+          context_, compressed_.data(), compressed_.size(), buffer, chunk_size, nullptr));
+      buffer += chunk_size;
+      length -= chunk_size;
+    }
+  }
+
+ private:
+  static constexpr size_t kInputChunkSize = 256 * KB;
+
+  // Write the first `result` bytes of `compressed_`, where `result` is the return value of an
+  // LZ4F compression function.
+  void Write(size_t result) {
+    if (LZ4F_isError(result)) {
+      LOG(ERROR) << "hprof: LZ4 compression failed: " << LZ4F_getErrorName(result);
+      errors_ = true;
+    } else if (result != 0) {
+      errors_ = !fp_->WriteFully(compressed_.data(), result);
+    }
+  }
+
+  File* fp_;
+  LZ4F_preferences_t preferences_;
+  LZ4F_cctx* context_;
+  std::vector<uint8_t> compressed_;
+  bool errors_;
+};
+
 class VectorEndianOuputput final : public EndianOutputBuffered {
  public:
   VectorEndianOuputput(std::vector<uint8_t>& data, size_t reserved_size)
@@ -429,14 +497,22 @@ class VectorEndianOuputput final : public EndianOutputBuffered {
 
 class Hprof : public SingleRootVisitor {
  public:
-  Hprof(const char* output_filename, int fd, bool direct_to_ddms)
+  Hprof(const char* output_filename,
+        int fd,
+        bool direct_to_ddms,
+        bool compress = false,
+        bool in_forked_child = false)
       : filename_(output_filename),
         fd_(fd),
-        direct_to_ddms_(direct_to_ddms) {
+        direct_to_ddms_(direct_to_ddms),
+        compress_(compress),
+        in_forked_child_(in_forked_child) {
+    DCHECK(!compress || !direct_to_ddms);
     LOG(INFO) << "hprof: heap dump \"" << filename_ << "\" starting...";
   }
 
-  void Dump()
+  // Returns whether the dump was written.
+  bool Dump()
     REQUIRES(Locks::mutator_lock_)
     REQUIRES(!Locks::heap_bitmap_lock_, !Locks::alloc_tracker_lock_) {
     {
@@ -477,6 +553,7 @@ class Hprof : public SingleRootVisitor {
                 << " objects " << total_objects_
                 << " objects with stack traces " << total_objects_with_stack_trace_;
     }
+    return okay;
   }
 
  private:
@@ -758,21 +835,29 @@ class Hprof : public SingleRootVisitor {
     if (fd_ >= 0) {
       out_fd = DupCloexec(fd_);
       if (out_fd < 0) {
-        ThrowRuntimeException("Couldn't dump heap; dup(%d) failed: %s", fd_, strerror(errno));
+        ReportError(android::base::StringPrintf(
+            "Couldn't dump heap; dup(%d) failed: %s", fd_, strerror(errno)));
         return false;
       }
     } else {
       out_fd = open(filename_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
       if (out_fd < 0) {
-        ThrowRuntimeException("Couldn't dump heap; open(\"%s\") failed: %s", filename_.c_str(),
-                              strerror(errno));
+        ReportError(android::base::StringPrintf(
+            "Couldn't dump heap; open(\"%s\") failed: %s", filename_.c_str(), strerror(errno)));
         return false;
       }
     }
 
     std::unique_ptr<File> file(new File(out_fd, filename_, true));
     bool okay;
-    {
+    if (compress_) {
+      Lz4FileEndianOutput file_output(file.get(), max_length);
+      output_ = &file_output;
+      ProcessHeap(true);
+      okay = file_output.Finish();
+      DCHECK_IMPLIES(okay, file_output.SumLength() <= overall_size);
+      output_ = nullptr;
+    } else {
       FileEndianOutput file_output(file.get(), max_length);
       output_ = &file_output;
       ProcessHeap(true);
@@ -795,13 +880,23 @@ class Hprof : public SingleRootVisitor {
       std::string msg(android::base::StringPrintf("Couldn't dump heap; writing \"%s\" failed: %s",
                                                   filename_.c_str(),
                                                   strerror(errno)));
-      ThrowRuntimeException("%s", msg.c_str());
+      ReportError(msg);
       LOG(ERROR) << msg;
     }
 
     return okay;
   }
 
+  void ReportError(const std::string& msg) REQUIRES(Locks::mutator_lock_) {
+    if (in_forked_child_) {
+      // Allocating an exception could wait for threads which do not exist in the child. The
+      // parent reports the failure instead.
+      LOG(ERROR) << msg;
+    } else {
+      ThrowRuntimeException("%s", msg.c_str());
+    }
+  }
+
   bool DumpToDdmsDirect(size_t overall_size, size_t max_length, uint32_t chunk_type)
       REQUIRES(Locks::mutator_lock_) {
     CHECK(direct_to_ddms_);
@@ -871,6 +966,10 @@ class Hprof : public SingleRootVisitor {
   std::string filename_;
   int fd_;
   bool direct_to_ddms_;
+  // Whether to write an LZ4-compressed file.
+  bool compress_;
+  // Whether the dump is taken by a child forked by DumpHeapCompressed().
+  bool in_forked_child_;
 
   uint64_t start_ns_ = NanoTime();
 
@@ -1606,5 +1705,47 @@ void DumpHeap(const char* filename, int fd, bool direct_to_ddms) {
   hprof.Dump();
 }
 
+void DumpHeapCompressed(const char* filename, int fd) {
+  CHECK(filename != nullptr);
+  Thread* self = Thread::Current();
+  pid_t pid;
+  {
+    // Fork while all threads are suspended outside of any GC, so that the child gets a
+    // consistent copy of the heap. See DumpHeap().
+    gc::ScopedGCCriticalSection gcs(self,
+                                    gc::kGcCauseHprof,
+                                    gc::kCollectorTypeHprof);
+    ScopedSuspendAll ssa(__FUNCTION__, true /* long suspend */);
+    pid = fork();
+    if (pid == 0) {
+      // The child is left with just this thread, which holds the mutator lock exclusively.
+      Hprof hprof(filename, fd, /*direct_to_ddms=*/ false, /*compress=*/ true,
+                  /*in_forked_child=*/ true);
+      // Do not run the exit handlers of the parent.
+      FastExit(hprof.Dump() ? 0 : 1);
+    }
+  }
+  // The other threads run again while the child writes the dump from its copy-on-write
+  // snapshot of the heap.
+  std::string error;
+  if (pid == -1) {
+    error = android::base::StringPrintf("Couldn't dump heap; fork failed: %s", strerror(errno));
+  } else {
+    int status;
+    if (TEMP_FAILURE_RETRY(waitpid(pid, &status, 0)) == -1) {
+      // Someone else reaped the child, e.g. a SIGCHLD handler, so its status is unknown.
+      PLOG(WARNING) << "hprof: waitpid(" << pid << ") failed";
+    } else if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      error = android::base::StringPrintf(
+          "Couldn't dump heap; dumping process %d failed with status %d", pid, status);
+    }
+  }
+  if (!error.empty()) {
+    LOG(ERROR) << error;
+    ScopedObjectAccess soa(self);
+    ThrowRuntimeException("%s", error.c_str());
+  }
+}
+
 }  // namespace hprof
 }  // namespace art
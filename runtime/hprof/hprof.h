@@ -25,6 +25,11 @@ namespace hprof {
 
 void DumpHeap(const char* filename, int fd, bool direct_to_ddms);
 
+// Like DumpHeap() to a file, but the dump is compressed with LZ4 (`lz4 -d` restores the HPROF
+// file) and written by a forked child process. The other threads are only suspended for the
+// fork, and the calling thread waits for the child to be done.
+void DumpHeapCompressed(const char* filename, int fd);
+
 }  // namespace hprof
 
 }  // namespace art
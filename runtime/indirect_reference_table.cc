@@ -85,7 +85,8 @@ IndirectReferenceTable::IndirectReferenceTable(IndirectRefKind kind)
       kind_(kind),
       top_index_(0u),
       max_entries_(0u),
-      current_num_holes_(0) {
+      current_num_holes_(0),
+      num_hole_hints_(0u) {
   CHECK_NE(kind, kJniTransition);
   CHECK_NE(kind, kLocal);
 }
@@ -203,15 +204,27 @@ IndirectRef IndirectReferenceTable::Add(ObjPtr<mirror::Object> obj, std::string*
   size_t index;
   if (current_num_holes_ > 0) {
     DCHECK_GT(top_index_, 1U);
-    // Find the first hole; likely to be near the end of the list.
-    IrtEntry* p_scan = &table_[top_index_ - 1];
-    DCHECK(!p_scan->GetReference()->IsNull());
-    --p_scan;
-    while (!p_scan->GetReference()->IsNull()) {
-      DCHECK_GT(p_scan, table_);
+    // Try the recently created holes first. A hint may be stale if the hole was already
+    // filled by the scan below or collapsed away by removing the top entry.
+    index = top_index_;
+    while (num_hole_hints_ != 0u) {
+      uint32_t hint = hole_hints_[--num_hole_hints_];
+      if (hint < top_index_ && table_[hint].GetReference()->IsNull()) {
+        index = hint;
+        break;
+      }
+    }
+    if (index == top_index_) {
+      // Find the first hole; likely to be near the end of the list.
+      IrtEntry* p_scan = &table_[top_index_ - 1];
+      DCHECK(!p_scan->GetReference()->IsNull());
       --p_scan;
+      while (!p_scan->GetReference()->IsNull()) {
+        DCHECK_GT(p_scan, table_);
+        --p_scan;
+      }
+      index = p_scan - table_;
     }
-    index = p_scan - table_;
     current_num_holes_--;
   } else {
     // Add to the end.
@@ -301,6 +314,9 @@ bool IndirectReferenceTable::Remove(IndirectRef iref) {
 
     *table_[idx].GetReference() = GcRoot<mirror::Object>(nullptr);
     current_num_holes_++;
+    if (num_hole_hints_ != kMaxHoleHints) {
+      hole_hints_[num_hole_hints_++] = idx;
+    }
     CheckHoleCount(table_, current_num_holes_, top_index_);
     if (kDebugIRT) {
       LOG(INFO) << "+++ left hole at " << idx << ", holes=" << current_num_holes_;
@@ -325,8 +325,14 @@ class IndirectReferenceTable {
 
   // Some values to retain old behavior with holes.
   // Description of the algorithm is in the .cc file.
-  // TODO: Consider other data structures for compact tables, e.g., free lists.
   size_t current_num_holes_;  // Number of holes in the current / top segment.
+
+  // Indexes of recently created holes, used by `Add()` to avoid scanning the table for a hole.
+  // Entries are only hints; they are validated before use as the hole may have been filled or
+  // dropped above `top_index_` since. When the stack is empty, `Add()` falls back to the scan.
+  static constexpr size_t kMaxHoleHints = 16u;
+  uint32_t hole_hints_[kMaxHoleHints];
+  size_t num_hole_hints_;
 };
 
 }  // namespace art
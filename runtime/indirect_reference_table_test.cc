@@ -265,4 +265,54 @@ TEST_F(IndirectReferenceTableTest, BasicTest) {
   CheckDump(&irt, 0, 0);
 }
 
+TEST_F(IndirectReferenceTableTest, HoleReuse) {
+  ScopedObjectAccess soa(Thread::Current());
+  static const size_t kTableMax = 64;
+  IndirectReferenceTable irt(kGlobal);
+  std::string error_msg;
+  bool success = irt.Initialize(kTableMax, &error_msg);
+  ASSERT_TRUE(success) << error_msg;
+
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::Class> c =
+      hs.NewHandle(class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;"));
+  ASSERT_TRUE(c != nullptr);
+
+  static const size_t kNumRefs = kTableMax / 2;
+  IndirectRef refs[kNumRefs];
+  for (size_t i = 0; i < kNumRefs; i++) {
+    refs[i] = irt.Add(c.Get(), &error_msg);
+    ASSERT_TRUE(refs[i] != nullptr) << "Failed adding " << i;
+  }
+
+  // Leave more holes than the table remembers, then collapse some of them from the top.
+  for (size_t i = 0; i < kNumRefs - 2; i++) {
+    ASSERT_TRUE(irt.Remove(refs[i])) << "failed removing " << i;
+  }
+  ASSERT_EQ(kNumRefs, irt.Capacity());
+  ASSERT_TRUE(irt.Remove(refs[kNumRefs - 1]));
+  ASSERT_TRUE(irt.Remove(refs[kNumRefs - 2]));
+  ASSERT_EQ(0u, irt.Capacity());
+
+  // The remembered holes are gone now; adding must not pick up any stale ones.
+  for (size_t i = 0; i < kNumRefs; i++) {
+    refs[i] = irt.Add(c.Get(), &error_msg);
+    ASSERT_TRUE(refs[i] != nullptr) << "Failed adding " << i;
+  }
+  for (size_t i = 0; i < kNumRefs - 1; i++) {
+    ASSERT_TRUE(irt.Remove(refs[i])) << "failed removing " << i;
+  }
+  ASSERT_EQ(kNumRefs, irt.Capacity());
+  for (size_t i = 0; i < kNumRefs - 1; i++) {
+    refs[i] = irt.Add(c.Get(), &error_msg);
+    ASSERT_TRUE(refs[i] != nullptr) << "Failed adding " << i;
+    ASSERT_EQ(kNumRefs, irt.Capacity()) << "hole not reused at " << i;
+    EXPECT_EQ(c.Get(), irt.Get(refs[i]));
+  }
+  for (size_t i = 0; i < kNumRefs; i++) {
+    ASSERT_TRUE(irt.Remove(refs[i])) << "failed removing " << i;
+  }
+  ASSERT_EQ(0u, irt.Capacity());
+}
+
 }  // namespace art
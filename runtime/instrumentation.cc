@@ -362,7 +362,7 @@ void Instrumentation::InitializeMethodsCode(ArtMethod* method, const void* aot_c
   }
 
   // Use instrumentation entrypoints if instrumentation is installed.
-  if (UNLIKELY(EntryExitStubsInstalled() || IsForcedInterpretOnly() || IsDeoptimized(method))) {
+  if (UNLIKELY(NeedsEntryExitHooks(method) || IsForcedInterpretOnly() || IsDeoptimized(method))) {
     UpdateEntryPoints(
         method, method->IsNative() ? GetQuickGenericJniStub() : GetQuickToInterpreterBridge());
     return;
@@ -429,7 +429,7 @@ void Instrumentation::InstallStubsForMethod(ArtMethod* method) {
     return;
   }
 
-  if (EntryExitStubsInstalled()) {
+  if (NeedsEntryExitHooks(method)) {
     // Install interpreter bridge / GenericJni stub if the existing code doesn't support
     // entry / exit hooks.
     if (!CodeSupportsEntryExitHooks(method->GetEntryPointFromQuickCompiledCode(), method)) {
@@ -486,9 +486,17 @@ bool Instrumentation::MethodSupportsExitEvents(ArtMethod* method,
 // methods when necessary. Shadow frames are updated if dex pc event
 // notification has changed. When force_deopt is true then DeoptimizationFlag is
 // updated to force a deoptimization.
+//
+// The stack of `thread` must not change during the walk. That is guaranteed either by holding the
+// mutator lock exclusively, or by running in a checkpoint of `thread`, i.e., on `thread` itself or
+// on a thread that found it suspended. Holding the mutator lock, even shared, also ensures that
+// the instrumentation state cannot change, since it is only updated with all threads suspended.
 void InstrumentationInstallStack(Thread* thread, bool deopt_all_frames)
-    REQUIRES(Locks::mutator_lock_) {
-  Locks::mutator_lock_->AssertExclusiveHeld(Thread::Current());
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  Thread* self = Thread::Current();
+  if (thread != self && !thread->IsSuspended()) {
+    Locks::mutator_lock_->AssertExclusiveHeld(self);
+  }
   struct InstallStackVisitor final : public StackVisitor {
     InstallStackVisitor(Thread* thread_in,
                         Context* context,
@@ -1178,7 +1186,7 @@ std::string Instrumentation::EntryPointString(const void* code) {
 }
 
 void Instrumentation::UpdateMethodsCodeImpl(ArtMethod* method, const void* new_code) {
-  if (!EntryExitStubsInstalled()) {
+  if (!NeedsEntryExitHooks(method)) {
     // Fast path: no instrumentation.
     DCHECK(!IsDeoptimized(method));
     UpdateEntryPoints(method, new_code);
@@ -1199,7 +1207,7 @@ void Instrumentation::UpdateMethodsCodeImpl(ArtMethod* method, const void* new_c
     return;
   }
 
-  if (EntryExitStubsInstalled() && !CodeSupportsEntryExitHooks(new_code, method)) {
+  if (!CodeSupportsEntryExitHooks(new_code, method)) {
     DCHECK(CodeSupportsEntryExitHooks(method->GetEntryPointFromQuickCompiledCode(), method))
         << EntryPointString(method->GetEntryPointFromQuickCompiledCode()) << " "
         << method->PrettyMethod();
@@ -1215,7 +1223,7 @@ void Instrumentation::UpdateNativeMethodsCodeToJitCode(ArtMethod* method, const
   // We don't do any read barrier on `method`'s declaring class in this code, as the JIT might
   // enter here on a soon-to-be deleted ArtMethod. Updating the entrypoint is OK though, as
   // the ArtMethod is still in memory.
-  if (EntryExitStubsInstalled() && !CodeSupportsEntryExitHooks(new_code, method)) {
+  if (NeedsEntryExitHooks(method) && !CodeSupportsEntryExitHooks(new_code, method)) {
     // If the new code doesn't support entry exit hooks but we need them don't update with the new
     // code.
     return;
@@ -1322,6 +1330,52 @@ void Instrumentation::Undeoptimize(ArtMethod* method) {
   }
 }
 
+void Instrumentation::EnableMethodEntryExitHooks(ArtMethod* method) {
+  CHECK(!method->IsNative());
+  CHECK(!method->IsProxyMethod());
+  CHECK(method->IsInvokable());
+  Locks::mutator_lock_->AssertExclusiveHeld(Thread::Current());
+
+  if (method_entry_exit_hooks_[method]++ != 0) {
+    // Already requested.
+    return;
+  }
+  if (method->IsObsolete()) {
+    DCHECK_EQ(method->GetEntryPointFromQuickCompiledCode(), GetInvokeObsoleteMethodStub());
+    return;
+  }
+  // Only this method needs to change. Frames of the method that are already on the stack keep
+  // running their current code, so they report neither entry nor exit.
+  if (!CodeSupportsEntryExitHooks(method->GetEntryPointFromQuickCompiledCode(), method)) {
+    UpdateEntryPoints(method, GetQuickToInterpreterBridge());
+  }
+}
+
+void Instrumentation::DisableMethodEntryExitHooks(ArtMethod* method) {
+  CHECK(!method->IsNative());
+  CHECK(!method->IsProxyMethod());
+  CHECK(method->IsInvokable());
+  Locks::mutator_lock_->AssertExclusiveHeld(Thread::Current());
+
+  auto it = method_entry_exit_hooks_.find(method);
+  CHECK(it != method_entry_exit_hooks_.end())
+      << "Method " << ArtMethod::PrettyMethod(method) << " has no entry / exit hooks";
+  if (--it->second != 0) {
+    return;
+  }
+  method_entry_exit_hooks_.erase(it);
+
+  // Nothing to restore if the method still needs the interpreter or hooks for all methods.
+  if (method->IsObsolete() || InterpretOnly(method) || EntryExitStubsInstalled()) {
+    return;
+  }
+  if (method->StillNeedsClinitCheck()) {
+    UpdateEntryPoints(method, GetQuickResolutionStub());
+  } else {
+    UpdateEntryPoints(method, GetOptimizedCodeFor(method));
+  }
+}
+
 bool Instrumentation::IsDeoptimizedMethodsEmpty() const {
   return deoptimized_methods_.empty();
 }
@@ -1441,7 +1495,7 @@ const void* Instrumentation::GetMaybeInstrumentedCodeForInvoke(ArtMethod* method
   // This is called by resolution trampolines and that should never be getting proxy methods.
   DCHECK(!method->IsProxyMethod()) << method->PrettyMethod();
   const void* code = GetCodeForInvoke(method);
-  if (EntryExitStubsInstalled() && !CodeSupportsEntryExitHooks(code, method)) {
+  if (NeedsEntryExitHooks(method) && !CodeSupportsEntryExitHooks(code, method)) {
     return method->IsNative() ? GetQuickGenericJniStub() : GetQuickToInterpreterBridge();
   }
   return code;
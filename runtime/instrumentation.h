@@ -24,6 +24,7 @@
 #include <memory>
 #include <optional>
 #include <queue>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "arch/instruction_set.h"
@@ -295,6 +296,27 @@ class Instrumentation {
   // determine if a deoptimization is required.
   bool IsDeoptimizedMethodsEmpty() const REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Routes a single method through code that reports method entry / exit events, without
+  // installing entry / exit stubs for all methods. Compiled code of other methods stays in place,
+  // so registered entry / exit listeners only see events from this method and from methods that
+  // already run in the interpreter; listeners interested in a subset of methods must still filter.
+  // Requests are counted, the method is restored once every request has been removed.
+  EXPORT void EnableMethodEntryExitHooks(ArtMethod* method)
+      REQUIRES(Locks::mutator_lock_, !Locks::thread_list_lock_);
+  EXPORT void DisableMethodEntryExitHooks(ArtMethod* method)
+      REQUIRES(Locks::mutator_lock_, !Locks::thread_list_lock_);
+
+  // Indicates whether entry / exit hooks were requested for this method only.
+  bool HasMethodEntryExitHooks(ArtMethod* method) const REQUIRES_SHARED(Locks::mutator_lock_) {
+    return !method_entry_exit_hooks_.empty() && method_entry_exit_hooks_.count(method) != 0;
+  }
+
+  // Indicates whether the code of the method must support entry / exit hooks, either because they
+  // are installed for all methods or because they were requested for this method.
+  bool NeedsEntryExitHooks(ArtMethod* method) const REQUIRES_SHARED(Locks::mutator_lock_) {
+    return EntryExitStubsInstalled() || HasMethodEntryExitHooks(method);
+  }
+
   // Enable method tracing by installing instrumentation entry/exit stubs or interpreter.
   EXPORT void EnableMethodTracing(
       const char* key,
@@ -566,8 +588,11 @@ class Instrumentation {
   //  - to call method entry / exit hooks for tracing. For this we instrument
   //    the stack frame to run entry / exit hooks but we don't need to deoptimize.
   // force_deopt indicates whether the frames need to deoptimize or not.
+  // The caller must either hold the mutator lock exclusively, or run in a checkpoint of `thread`
+  // (on `thread` itself or on a thread that found it suspended), which avoids a SuspendAll when
+  // only one thread is involved.
   EXPORT void InstrumentThreadStack(Thread* thread, bool force_deopt)
-      REQUIRES(Locks::mutator_lock_);
+      REQUIRES_SHARED(Locks::mutator_lock_);
   void InstrumentAllThreadStacks(bool force_deopt) REQUIRES(Locks::mutator_lock_)
       REQUIRES(!Locks::thread_list_lock_);
 
@@ -763,6 +788,10 @@ class Instrumentation {
   // only.
   std::unordered_set<ArtMethod*> deoptimized_methods_ GUARDED_BY(Locks::mutator_lock_);
 
+  // Methods with entry / exit hooks requested through EnableMethodEntryExitHooks, with the number
+  // of outstanding requests.
+  std::unordered_map<ArtMethod*, size_t> method_entry_exit_hooks_ GUARDED_BY(Locks::mutator_lock_);
+
   // Current interpreter handler table. This is updated each time the thread state flags are
   // modified.
 
@@ -290,6 +290,22 @@ class InstrumentationTest : public CommonRuntimeTest {
     }
   }
 
+  void SetMethodEntryExitHooks(Thread* self, ArtMethod* method, bool enable)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    Runtime* runtime = Runtime::Current();
+    instrumentation::Instrumentation* instrumentation = runtime->GetInstrumentation();
+    ScopedThreadSuspension sts(self, ThreadState::kSuspended);
+    gc::ScopedGCCriticalSection gcs(self,
+                                    gc::kGcCauseInstrumentation,
+                                    gc::kCollectorTypeInstrumentation);
+    ScopedSuspendAll ssa("Single method entry / exit hooks");
+    if (enable) {
+      instrumentation->EnableMethodEntryExitHooks(method);
+    } else {
+      instrumentation->DisableMethodEntryExitHooks(method);
+    }
+  }
+
   void DeoptimizeEverything(Thread* self, const char* key)
         REQUIRES_SHARED(Locks::mutator_lock_) {
     Runtime* runtime = Runtime::Current();
@@ -640,6 +656,41 @@ TEST_F(InstrumentationTest, DeoptimizeDirectMethod) {
   EXPECT_FALSE(instr->IsDeoptimized(method_to_deoptimize));
 }
 
+TEST_F(InstrumentationTest, MethodEntryExitHooks) {
+  ScopedObjectAccess soa(Thread::Current());
+  jobject class_loader = LoadDex("Instrumentation");
+  Runtime* const runtime = Runtime::Current();
+  instrumentation::Instrumentation* instr = runtime->GetInstrumentation();
+  ClassLinker* class_linker = runtime->GetClassLinker();
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::ClassLoader> loader(hs.NewHandle(soa.Decode<mirror::ClassLoader>(class_loader)));
+  ObjPtr<mirror::Class> klass = class_linker->FindClass(soa.Self(), "LInstrumentation;", loader);
+  ASSERT_TRUE(klass != nullptr);
+  ArtMethod* method = klass->FindClassMethod("instanceMethod", "()V", kRuntimePointerSize);
+  ASSERT_TRUE(method != nullptr);
+  ArtMethod* other_method = klass->FindClassMethod("<init>", "()V", kRuntimePointerSize);
+  ASSERT_TRUE(other_method != nullptr);
+
+  EXPECT_FALSE(instr->HasMethodEntryExitHooks(method));
+
+  // Requests are counted.
+  SetMethodEntryExitHooks(soa.Self(), method, /*enable=*/ true);
+  SetMethodEntryExitHooks(soa.Self(), method, /*enable=*/ true);
+
+  // Only the requested method is affected.
+  EXPECT_FALSE(instr->EntryExitStubsInstalled());
+  EXPECT_TRUE(instr->HasMethodEntryExitHooks(method));
+  EXPECT_TRUE(instr->NeedsEntryExitHooks(method));
+  EXPECT_FALSE(instr->NeedsEntryExitHooks(other_method));
+
+  SetMethodEntryExitHooks(soa.Self(), method, /*enable=*/ false);
+  EXPECT_TRUE(instr->HasMethodEntryExitHooks(method));
+
+  SetMethodEntryExitHooks(soa.Self(), method, /*enable=*/ false);
+  EXPECT_FALSE(instr->HasMethodEntryExitHooks(method));
+  EXPECT_FALSE(instr->NeedsEntryExitHooks(method));
+}
+
 TEST_F(InstrumentationTest, FullDeoptimization) {
   ScopedObjectAccess soa(Thread::Current());
   Runtime* const runtime = Runtime::Current();
@@ -100,6 +100,18 @@ inline void InternTable::AddImageStringsToTable(gc::space::ImageSpace* image_spa
   }
 }
 
+template <typename Key>
+ALWAYS_INLINE
+inline ObjPtr<mirror::String> InternTable::LookupBootImageIntern(const Key& key, uint32_t hash) {
+  for (UnorderedSet& set : boot_image_interns_) {
+    auto it = set.FindWithHash(key, hash);
+    if (it != set.end()) {
+      return it->Read();
+    }
+  }
+  return nullptr;
+}
+
 template <typename Visitor>
 inline size_t InternTable::AddTableFromMemory(const uint8_t* ptr,
                                               const Visitor& visitor,
@@ -110,9 +122,19 @@ inline size_t InternTable::AddTableFromMemory(const uint8_t* ptr,
     // Hold the lock while calling the visitor to prevent possible race
     // conditions with another thread adding intern strings.
     MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
+    const size_t num_read_strings = set.size();
     // Visit the unordered set, may remove elements.
     visitor(set);
     if (!set.empty()) {
+      // Keep a lock-free view of the boot image tables that are added first and unchanged by
+      // the visitor. The view reads the same memory as the table added below.
+      if (is_boot_image &&
+          set.size() == num_read_strings &&
+          boot_image_interns_.size() + 1u == strong_interns_.tables_.size()) {
+        size_t view_read_count = 0;
+        boot_image_interns_.emplace_back(ptr, /*make copy*/false, &view_read_count);
+        DCHECK_EQ(view_read_count, read_count);
+      }
       strong_interns_.AddInternStrings(std::move(set), is_boot_image);
     }
   }
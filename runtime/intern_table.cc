@@ -115,16 +115,25 @@ ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self, ObjPtr<mirror::St
   DCHECK(s != nullptr);
   // `String::GetHashCode()` ensures that the stored hash is calculated.
   uint32_t hash = static_cast<uint32_t>(s->GetHashCode());
+  ObjPtr<mirror::String> image_string = LookupBootImageIntern(GcRoot<mirror::String>(s), hash);
+  if (image_string != nullptr) {
+    return image_string;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
-  return strong_interns_.Find(s, hash);
+  return strong_interns_.Find(s, hash, boot_image_interns_.size());
 }
 
 ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self,
                                                  uint32_t utf16_length,
                                                  const char* utf8_data) {
   uint32_t hash = Utf8String::Hash(utf16_length, utf8_data);
+  Utf8String string(utf16_length, utf8_data);
+  ObjPtr<mirror::String> image_string = LookupBootImageIntern(string, hash);
+  if (image_string != nullptr) {
+    return image_string;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
-  return strong_interns_.Find(Utf8String(utf16_length, utf8_data), hash);
+  return strong_interns_.Find(string, hash, boot_image_interns_.size());
 }
 
 ObjPtr<mirror::String> InternTable::LookupWeakLocked(ObjPtr<mirror::String> s) {
@@ -206,6 +215,13 @@ ObjPtr<mirror::String> InternTable::Insert(ObjPtr<mirror::String> s,
   DCHECK(s != nullptr);
   DCHECK_EQ(hash, static_cast<uint32_t>(s->GetStoredHashCode()));
   DCHECK_IMPLIES(hash == 0u, s->ComputeHashCode() == 0);
+  if (num_searched_strong_frozen_tables < boot_image_interns_.size()) {
+    ObjPtr<mirror::String> image_string = LookupBootImageIntern(GcRoot<mirror::String>(s), hash);
+    if (image_string != nullptr) {
+      return image_string;
+    }
+    num_searched_strong_frozen_tables = boot_image_interns_.size();
+  }
   Thread* const self = Thread::Current();
   MutexLock mu(self, *Locks::intern_table_lock_);
   if (kDebugLocking) {
@@ -254,14 +270,19 @@ ObjPtr<mirror::String> InternTable::InternStrong(uint32_t utf16_length, const ch
   DCHECK(utf8_data != nullptr);
   uint32_t hash = Utf8String::Hash(utf16_length, utf8_data);
   Thread* self = Thread::Current();
-  ObjPtr<mirror::String> s;
+  Utf8String string(utf16_length, utf8_data);
+  // Most strings resolved by apps are in the boot image, look there first without the lock.
+  ObjPtr<mirror::String> s = LookupBootImageIntern(string, hash);
+  if (s != nullptr) {
+    return s;
+  }
   size_t num_searched_strong_frozen_tables;
   {
     // Try to avoid allocation. If we need to allocate, release the mutex before the allocation.
     MutexLock mu(self, *Locks::intern_table_lock_);
     DCHECK(!strong_interns_.tables_.empty());
     num_searched_strong_frozen_tables = strong_interns_.tables_.size() - 1u;
-    s = strong_interns_.Find(Utf8String(utf16_length, utf8_data), hash);
+    s = strong_interns_.Find(string, hash, boot_image_interns_.size());
   }
   if (s != nullptr) {
     return s;
@@ -353,11 +374,14 @@ ObjPtr<mirror::String> InternTable::Table::Find(ObjPtr<mirror::String> s,
 }
 
 FLATTEN
-ObjPtr<mirror::String> InternTable::Table::Find(const Utf8String& string, uint32_t hash) {
+ObjPtr<mirror::String> InternTable::Table::Find(const Utf8String& string,
+                                                uint32_t hash,
+                                                size_t num_searched_frozen_tables) {
   Locks::intern_table_lock_->AssertHeld(Thread::Current());
+  auto mid = tables_.begin() + num_searched_frozen_tables;
   // Search from the last table, assuming that apps shall search for their own
   // strings more often than for boot image strings.
-  for (InternalTable& table : ReverseRange(tables_)) {
+  for (InternalTable& table : ReverseRange(MakeIterationRange(mid, tables_.end()))) {
     auto it = table.set_.FindWithHash(string, hash);
     if (it != table.set_.end()) {
       return it->Read();
@@ -241,7 +241,9 @@ class InternTable {
                                 uint32_t hash,
                                 size_t num_searched_frozen_tables = 0u)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-    ObjPtr<mirror::String> Find(const Utf8String& string, uint32_t hash)
+    ObjPtr<mirror::String> Find(const Utf8String& string,
+                                uint32_t hash,
+                                size_t num_searched_frozen_tables = 0u)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
     void Insert(ObjPtr<mirror::String> s, uint32_t hash)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
@@ -279,6 +281,11 @@ class InternTable {
     ART_FRIEND_TEST(InternTableTest, CrossHash);
   };
 
+  // Lookup a string in the boot image tables, without holding the intern table lock.
+  template <typename Key>
+  ObjPtr<mirror::String> LookupBootImageIntern(const Key& key, uint32_t hash)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Insert if non null, otherwise return null. Must be called holding the mutator lock.
   ObjPtr<mirror::String> Insert(ObjPtr<mirror::String> s,
                                 uint32_t hash,
@@ -324,6 +331,10 @@ class InternTable {
   Table weak_interns_ GUARDED_BY(Locks::intern_table_lock_);
   // Weak root state, used for concurrent system weak processing and more.
   gc::WeakRootState weak_root_state_ GUARDED_BY(Locks::intern_table_lock_);
+  // Views of the boot image tables, which are also the first tables of `strong_interns_`.
+  // These tables are never modified and are only added during runtime initialization, before
+  // other threads can intern strings, so they can be searched without the lock.
+  dchecked_vector<UnorderedSet> boot_image_interns_;
 
   friend class gc::space::ImageSpace;
   friend class linker::ImageWriter;
@@ -125,9 +125,13 @@ inline void UpdateHotness(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock
   method->UpdateCounter(increase_hotness_for_ui ? 0x6ff : 0xf);
 }
 
+// Called after a miss in the thread-local interpreter cache. The resolution that precedes it only
+// goes through the dex cache, which is shared by all threads, so refilling the thread-local
+// cache is cheap. The refill count tracks how often big methods or new threads miss.
 template<typename T>
 inline void UpdateCache(Thread* self, const uint16_t* dex_pc_ptr, T value) {
   self->GetInterpreterCache()->Set(self, dex_pc_ptr, value);
+  Runtime::Current()->GetMetrics()->NterpCacheRefillCount()->AddOne();
 }
 
 template<typename T>
@@ -713,7 +717,8 @@ extern "C" jit::OsrData* NterpHotMethod(ArtMethod* method, uint16_t* dex_pc_ptr,
         return osr_data;
       }
     }
-    jit->MaybeEnqueueCompilation(method, Thread::Current());
+    jit->MaybeEnqueueCompilation(
+        method, Thread::Current(), /*at_back_edge=*/ dex_pc_ptr != nullptr);
   }
   return nullptr;
 }
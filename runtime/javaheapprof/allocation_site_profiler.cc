@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "javaheapprof/allocation_site_profiler.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "art_method-inl.h"
+#include "base/utils.h"
+#include "mirror/class-inl.h"
+#include "mirror/object-inl.h"
+#include "runtime.h"
+#include "thread-current-inl.h"
+#include "thread_list.h"
+
+namespace art HIDDEN {
+
+// The number of sites, by estimated allocated bytes, that Dump() prints.
+static constexpr size_t kMaxDumpedSites = 32;
+
+AllocationSiteTable::Site* AllocationSiteTable::FindOrAddSite(ObjPtr<mirror::Class> klass,
+                                                             ArtMethod* method,
+                                                             uint32_t dex_pc) {
+  size_t hash = reinterpret_cast<uintptr_t>(klass.Ptr()) ^
+                (reinterpret_cast<uintptr_t>(method) * 31u) ^ dex_pc;
+  hash ^= hash >> 16;
+  for (size_t i = 0; i < kNumSites; ++i) {
+    Site* site = &sites_[(hash + i) & (kNumSites - 1)];
+    if (!site->published.load(std::memory_order_relaxed)) {
+      site->klass = klass.Ptr();
+      site->method = method;
+      site->dex_pc = dex_pc;
+      std::string name = klass->PrettyDescriptor();
+      if (method != nullptr) {
+        name += " from " + method->PrettyMethod() + " at dex pc " + std::to_string(dex_pc);
+      } else {
+        name += " from native code";
+      }
+      site->name.reset(new std::string(std::move(name)));
+      site->published.store(true, std::memory_order_release);
+      return site;
+    }
+    if (site->klass == klass.Ptr() && site->method == method && site->dex_pc == dex_pc) {
+      return site;
+    }
+  }
+  return nullptr;
+}
+
+void AllocationSiteTable::MergeInto(std::map<std::string, AllocationSiteTotals>* sites) const {
+  for (const Site& site : sites_) {
+    if (site.published.load(std::memory_order_acquire)) {
+      AllocationSiteTotals& totals = (*sites)[*site.name];
+      totals.num_samples += site.num_samples.load(std::memory_order_relaxed);
+      totals.estimated_bytes += site.estimated_bytes.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+// Samples are reported from the allocation paths, which hold the mutator lock, except for
+// native allocations which have no object and are skipped.
+void AllocationSiteProfiler::ReportSample(Thread* self,
+                                          mirror::Object* obj,
+                                          size_t alloc_size,
+                                          size_t sampling_interval) NO_THREAD_SAFETY_ANALYSIS {
+  if (obj == nullptr) {
+    return;
+  }
+  AllocationSiteTable* table = self->GetAllocationSiteTable();
+  if (table == nullptr) {
+    table = new AllocationSiteTable();
+    self->SetAllocationSiteTable(table);
+  }
+  // Each sample stands for one sampling interval of allocations on average, and an allocation
+  // larger than that is always sampled.
+  const size_t weight = std::max(alloc_size, sampling_interval);
+  ObjPtr<mirror::Class> klass = obj->GetClass<kVerifyNone, kWithoutReadBarrier>();
+  if (klass == nullptr) {
+    // The sample was taken while allocating a TLAB. Heap::AllocObjectWithAllocator() records it
+    // once the class is set.
+    table->pending_sample_bytes_ = weight;
+    return;
+  }
+  RecordSample(self, table, klass, weight);
+}
+
+void AllocationSiteProfiler::RecordPendingSample(Thread* self, ObjPtr<mirror::Object> obj) {
+  AllocationSiteTable* table = self->GetAllocationSiteTable();
+  DCHECK(table != nullptr);
+  DCHECK(table->HasPendingSample());
+  const size_t weight = table->pending_sample_bytes_;
+  table->pending_sample_bytes_ = 0;
+  RecordSample(self, table, obj->GetClass(), weight);
+}
+
+void AllocationSiteProfiler::RecordSample(Thread* self,
+                                          AllocationSiteTable* table,
+                                          ObjPtr<mirror::Class> klass,
+                                          size_t weight) {
+  uint32_t dex_pc = 0;
+  ArtMethod* method =
+      self->GetCurrentMethod(&dex_pc, /*check_suspended=*/ false, /*abort_on_error=*/ false);
+  AllocationSiteTable::Site* site = table->FindOrAddSite(klass, method, dex_pc);
+  if (site == nullptr) {
+    num_dropped_samples_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  // Only this thread updates the site, readers just need untorn values.
+  site->num_samples.store(site->num_samples.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+  site->estimated_bytes.store(site->estimated_bytes.load(std::memory_order_relaxed) + weight,
+                              std::memory_order_relaxed);
+}
+
+void AllocationSiteProfiler::RetireThread(Thread* thread) {
+  AllocationSiteTable* table = thread->GetAllocationSiteTable();
+  if (table == nullptr) {
+    return;
+  }
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    table->MergeInto(&retired_sites_);
+  }
+  thread->SetAllocationSiteTable(nullptr);
+  delete table;
+}
+
+void AllocationSiteProfiler::Dump(std::ostream& os) {
+  Thread* self = Thread::Current();
+  std::map<std::string, AllocationSiteTotals> sites;
+  {
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    for (Thread* thread : Runtime::Current()->GetThreadList()->GetList()) {
+      const AllocationSiteTable* table = thread->GetAllocationSiteTable();
+      if (table != nullptr) {
+        table->MergeInto(&sites);
+      }
+    }
+    MutexLock mu2(self, lock_);
+    for (const auto& [name, totals] : retired_sites_) {
+      AllocationSiteTotals& merged = sites[name];
+      merged.num_samples += totals.num_samples;
+      merged.estimated_bytes += totals.estimated_bytes;
+    }
+  }
+  std::vector<std::pair<std::string, AllocationSiteTotals>> sorted(sites.begin(), sites.end());
+  std::sort(sorted.begin(), sorted.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.second.estimated_bytes > rhs.second.estimated_bytes;
+  });
+  os << "Allocation sites (sampling interval " << PrettySize(sampling_interval_) << ", "
+     << sorted.size() << " sites, "
+     << num_dropped_samples_.load(std::memory_order_relaxed) << " dropped samples):\n";
+  for (size_t i = 0; i < std::min(sorted.size(), kMaxDumpedSites); ++i) {
+    os << "  " << PrettySize(sorted[i].second.estimated_bytes) << " in "
+       << sorted[i].second.num_samples << " samples: " << sorted[i].first << "\n";
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JAVAHEAPPROF_ALLOCATION_SITE_PROFILER_H_
+#define ART_RUNTIME_JAVAHEAPPROF_ALLOCATION_SITE_PROFILER_H_
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "base/locks.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "obj_ptr.h"
+
+namespace art HIDDEN {
+
+class ArtMethod;
+class Thread;
+
+namespace mirror {
+class Class;
+class Object;
+}  // namespace mirror
+
+// Sampled allocations of one allocation site, aggregated.
+struct AllocationSiteTotals {
+  uint64_t num_samples = 0;
+  // Allocated bytes extrapolated from the samples.
+  uint64_t estimated_bytes = 0;
+};
+
+// Per-thread table of sampled allocation sites, keyed by (class, allocating method, dex pc).
+// Only the owning thread adds samples, without locking. Other threads may read the published
+// sites while holding the thread list lock.
+class AllocationSiteTable {
+ public:
+  // Must be a power of two.
+  static constexpr size_t kNumSites = 128;
+
+  AllocationSiteTable() {}
+
+  bool HasPendingSample() const {
+    return pending_sample_bytes_ != 0;
+  }
+
+  // Add the sites of the table to `sites`, keyed by the name of the site.
+  void MergeInto(std::map<std::string, AllocationSiteTotals>* sites) const;
+
+ private:
+  struct Site {
+    // Set once the key and the name are valid.
+    std::atomic<bool> published{false};
+    // The key. The pointers are only compared, never dereferenced, as the class or method may
+    // be unloaded.
+    const mirror::Class* klass = nullptr;
+    const ArtMethod* method = nullptr;
+    uint32_t dex_pc = 0;
+    std::unique_ptr<const std::string> name;
+    std::atomic<uint64_t> num_samples{0};
+    std::atomic<uint64_t> estimated_bytes{0};
+  };
+
+  // Return the site for the key, adding it if it is new. Returns null if the table is full.
+  Site* FindOrAddSite(ObjPtr<mirror::Class> klass, ArtMethod* method, uint32_t dex_pc)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  Site sites_[kNumSites];
+  // The weight of a sample taken before the class of the sampled object was set, or 0.
+  size_t pending_sample_bytes_ = 0;
+
+  friend class AllocationSiteProfiler;
+
+  DISALLOW_COPY_AND_ASSIGN(AllocationSiteTable);
+};
+
+// Always-on allocation site profiler built on the HeapSampler. The sampled allocations are
+// attributed to their class and to the method and dex pc of the allocating Java frame, and
+// dumped on SIGQUIT.
+class AllocationSiteProfiler {
+ public:
+  explicit AllocationSiteProfiler(size_t sampling_interval)
+      : sampling_interval_(sampling_interval),
+        lock_("allocation site profiler lock", LockLevel::kGenericBottomLock) {}
+
+  size_t GetSamplingInterval() const {
+    return sampling_interval_;
+  }
+
+  // Record a sample of `obj`, which stands for `sampling_interval` allocated bytes on average.
+  // If the class of the object is not set yet, the sample is left pending for
+  // RecordPendingSample(). Called by HeapSampler::ReportSample().
+  void ReportSample(Thread* self, mirror::Object* obj, size_t alloc_size, size_t sampling_interval);
+
+  // Record the pending sample of `self`, taken when allocating `obj`.
+  void RecordPendingSample(Thread* self, ObjPtr<mirror::Object> obj)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Keep the samples of a thread that is going away.
+  void RetireThread(Thread* thread) REQUIRES(!lock_);
+
+  void Dump(std::ostream& os) REQUIRES(!Locks::thread_list_lock_, !lock_);
+
+ private:
+  void RecordSample(Thread* self,
+                    AllocationSiteTable* table,
+                    ObjPtr<mirror::Class> klass,
+                    size_t weight) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  const size_t sampling_interval_;
+  // Samples dropped because the table of their thread was full.
+  std::atomic<uint64_t> num_dropped_samples_{0};
+  Mutex lock_ BOTTOM_MUTEX_ACQUIRED_AFTER;
+  // The sites of threads that have exited.
+  std::map<std::string, AllocationSiteTotals> retired_sites_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(AllocationSiteProfiler);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_JAVAHEAPPROF_ALLOCATION_SITE_PROFILER_H_
@@ -17,6 +17,7 @@
 #include "base/atomic.h"
 #include "base/locks.h"
 #include "gc/heap.h"
+#include "javaheapprof/allocation_site_profiler.h"
 #include "javaheapprof/javaheapsampler.h"
 #ifdef ART_TARGET_ANDROID
 #include "perfetto/heap_profile.h"
@@ -56,6 +57,25 @@ size_t HeapSampler::PickAndAdjustNextSample(size_t sample_adjust_bytes) {
   return bytes_until_sample;
 }
 
+void HeapSampler::DisableHeapSampler() {
+  perfetto_enabled_.store(false, std::memory_order_release);
+  AllocationSiteProfiler* profiler = site_profiler_.load(std::memory_order_acquire);
+  if (profiler != nullptr) {
+    // Keep sampling at the rate of the allocation site profiler.
+    SetSamplingInterval(profiler->GetSamplingInterval());
+  } else {
+    enabled_.store(false, std::memory_order_release);
+  }
+}
+
+void HeapSampler::EnableAllocationSiteProfiler(AllocationSiteProfiler* profiler) {
+  site_profiler_.store(profiler, std::memory_order_release);
+  if (!perfetto_enabled_.load(std::memory_order_acquire)) {
+    SetSamplingInterval(profiler->GetSamplingInterval());
+  }
+  enabled_.store(true, std::memory_order_release);
+}
+
 // Report to Perfetto an allocation sample.
 // Samples can only be reported after the allocation is done.
 // Also bytes_until_sample can only be updated after the allocation and reporting is done.
@@ -66,8 +86,14 @@ void HeapSampler::ReportSample(art::mirror::Object* obj, size_t allocation_size)
   uint64_t perf_alloc_id = reinterpret_cast<uint64_t>(obj);
   VLOG(heap) << "JHP:***Report Perfetto Allocation: obj: " << perf_alloc_id;
 #ifdef ART_TARGET_ANDROID
-  AHeapProfile_reportSample(perfetto_heap_id_, perf_alloc_id, allocation_size);
+  if (perfetto_enabled_.load(std::memory_order_acquire)) {
+    AHeapProfile_reportSample(perfetto_heap_id_, perf_alloc_id, allocation_size);
+  }
 #endif
+  AllocationSiteProfiler* profiler = site_profiler_.load(std::memory_order_acquire);
+  if (profiler != nullptr) {
+    profiler->ReportSample(art::Thread::Current(), obj, allocation_size, GetSamplingInterval());
+  }
 }
 
 // Check whether we should take a sample or not at this allocation and calculate the sample
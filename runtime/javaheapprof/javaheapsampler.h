@@ -24,6 +24,8 @@
 
 namespace art HIDDEN {
 
+class AllocationSiteProfiler;
+
 class HeapSampler {
  public:
   HeapSampler() : rng_(/*seed=*/std::minstd_rand::default_seed),
@@ -45,13 +47,17 @@ class HeapSampler {
   void SetHeapID(uint32_t heap_id) {
     perfetto_heap_id_ = heap_id;
   }
+  // Enable or disable sampling for Perfetto.
   void EnableHeapSampler() {
+    perfetto_enabled_.store(true, std::memory_order_release);
     enabled_.store(true, std::memory_order_release);
   }
-  void DisableHeapSampler() {
-    enabled_.store(false, std::memory_order_release);
-  }
-  // Report a sample to Perfetto.
+  void DisableHeapSampler() REQUIRES(!geo_dist_rng_lock_);
+  // Also sample for the allocation site profiler, from now on. When Perfetto is sampling too,
+  // its sampling interval is used.
+  void EnableAllocationSiteProfiler(AllocationSiteProfiler* profiler)
+      REQUIRES(!geo_dist_rng_lock_);
+  // Report a sample to Perfetto and the allocation site profiler.
   void ReportSample(art::mirror::Object* obj, size_t allocation_size);
   // Check whether we should take a sample or not at this allocation, and return the
   // number of bytes from current pos to the next sample to use in the expand Tlab
@@ -80,7 +86,10 @@ class HeapSampler {
   // possibly decreasing sample intervals by sample_adj_bytes.
   size_t PickAndAdjustNextSample(size_t sample_adj_bytes = 0) REQUIRES(!geo_dist_rng_lock_);
 
+  // Whether anyone is sampling, and whether Perfetto is.
   std::atomic<bool> enabled_{false};
+  std::atomic<bool> perfetto_enabled_{false};
+  std::atomic<AllocationSiteProfiler*> site_profiler_{nullptr};
   // Default sampling interval is 4kb.
   // Writes guarded by geo_dist_rng_lock_.
   std::atomic<int> p_sampling_interval_{4 * 1024};
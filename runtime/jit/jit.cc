@@ -24,13 +24,18 @@
 #include "base/logging.h"  // For VLOG.
 #include "base/memfd.h"
 #include "base/memory_tool.h"
+#include "base/os.h"
 #include "base/pointer_size.h"
 #include "base/runtime_debug.h"
 #include "base/scoped_flock.h"
 #include "base/utils.h"
+#include "base/stl_util.h"
+#include "class_linker-inl.h"
+#include "class_loader_utils.h"
 #include "class_root-inl.h"
 #include "compilation_kind.h"
 #include "debugger.h"
+#include "dex/dex_instruction-inl.h"
 #include "dex/type_lookup_table.h"
 #include "entrypoints/entrypoint_utils-inl.h"
 #include "entrypoints/runtime_asm_entrypoints.h"
@@ -92,7 +97,8 @@ Jit::Jit(JitCodeCache* code_cache, JitOptions* options)
       lock_("JIT memory use lock"),
       zygote_mapping_methods_(),
       fd_methods_(-1),
-      fd_methods_size_(0) {}
+      fd_methods_size_(0),
+      last_hotness_decay_ns_(NanoTime()) {}
 
 std::unique_ptr<Jit> Jit::Create(JitCodeCache* code_cache, JitOptions* options) {
   jit_compiler_ = jit_create();
@@ -151,6 +157,23 @@ bool Jit::TryPatternMatch(ArtMethod* method_to_compile, CompilationKind compilat
   return false;
 }
 
+bool Jit::TryBootJniStub(ArtMethod* method_to_compile) {
+  if (!method_to_compile->IsNative() ||
+      Runtime::Current()->IsJavaDebuggable() ||
+      method_to_compile->StillNeedsClinitCheck()) {
+    return false;
+  }
+  const void* boot_jni_stub =
+      Runtime::Current()->GetClassLinker()->FindBootJniStub(method_to_compile);
+  if (boot_jni_stub == nullptr) {
+    return false;
+  }
+  VLOG(jit) << "Using boot image JNI stub for " << method_to_compile->PrettyMethod();
+  Runtime::Current()->GetInstrumentation()->UpdateMethodsCode(method_to_compile, boot_jni_stub);
+  Runtime::Current()->GetMetrics()->JitBootJniStubReuseCount()->AddOne();
+  return true;
+}
+
 bool Jit::CompileMethodInternal(ArtMethod* method,
                                 Thread* self,
                                 CompilationKind compilation_kind,
@@ -218,6 +241,10 @@ bool Jit::CompileMethodInternal(ArtMethod* method,
     return true;
   }
 
+  if (TryBootJniStub(method_to_compile)) {
+    return true;
+  }
+
   if (!code_cache_->NotifyCompilationOf(method_to_compile, self, compilation_kind, prejit)) {
     return false;
   }
@@ -283,6 +310,13 @@ void Jit::StartProfileSaver(const std::string& profile_filename,
                         code_paths,
                         ref_profile_filename);
   }
+  Runtime* runtime = Runtime::Current();
+  if (options_->PrecompileAppProfile() &&
+      UseJitCompilation() &&
+      !runtime->IsJavaDebuggable() &&
+      !runtime->IsSystemServer()) {
+    thread_pool_->AddTask(Thread::Current(), new JitAppProfileTask(profile_filename, code_paths));
+  }
 }
 
 void Jit::StopProfileSaver() {
@@ -655,10 +689,12 @@ class JitCompileTask final : public Task {
 
   JitCompileTask(ArtMethod* method,
                  TaskKind task_kind,
-                 CompilationKind compilation_kind)
+                 CompilationKind compilation_kind,
+                 uint64_t enqueue_time_ns = 0)
       : method_(method),
         kind_(task_kind),
-        compilation_kind_(compilation_kind) {
+        compilation_kind_(compilation_kind),
+        enqueue_time_ns_(enqueue_time_ns) {
   }
 
   void Run(Thread* self) override {
@@ -667,11 +703,14 @@ class JitCompileTask final : public Task {
       switch (kind_) {
         case TaskKind::kCompile:
         case TaskKind::kPreCompile: {
-          Runtime::Current()->GetJit()->CompileMethodInternal(
+          bool success = Runtime::Current()->GetJit()->CompileMethodInternal(
               method_,
               self,
               compilation_kind_,
               /* prejit= */ (kind_ == TaskKind::kPreCompile));
+          if (success && enqueue_time_ns_ != 0) {
+            ReportQueueLatency();
+          }
           break;
         }
       }
@@ -696,9 +735,28 @@ class JitCompileTask final : public Task {
   }
 
  private:
+  // Report the time from the compilation request to the installation of the code.
+  void ReportQueueLatency() {
+    int64_t latency_ms = static_cast<int64_t>(NsToMs(NanoTime() - enqueue_time_ns_));
+    metrics::ArtMetrics* metrics = Runtime::Current()->GetMetrics();
+    switch (compilation_kind_) {
+      case CompilationKind::kOsr:
+        metrics->JitOsrQueueLatency()->Add(latency_ms);
+        break;
+      case CompilationKind::kBaseline:
+        metrics->JitBaselineQueueLatency()->Add(latency_ms);
+        break;
+      case CompilationKind::kOptimized:
+        metrics->JitOptimizedQueueLatency()->Add(latency_ms);
+        break;
+    }
+  }
+
   ArtMethod* const method_;
   const TaskKind kind_;
   const CompilationKind compilation_kind_;
+  // When the method was enqueued, or 0 if the task did not come from a compilation queue.
+  const uint64_t enqueue_time_ns_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(JitCompileTask);
 };
@@ -785,6 +843,19 @@ class JitZygoteDoneCompilingTask final : public SelfDeletingTask {
   DISALLOW_COPY_AND_ASSIGN(JitZygoteDoneCompilingTask);
 };
 
+class JitHotnessDecayTask final : public SelfDeletingTask {
+ public:
+  JitHotnessDecayTask() {}
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    Runtime::Current()->GetJit()->DecayHotnessCounters();
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(JitHotnessDecayTask);
+};
+
 /**
  * A JIT task to run Java verification of boot classpath classes that were not
  * verified at compile-time.
@@ -947,6 +1018,28 @@ class JitProfileTask final : public Task {
   DISALLOW_COPY_AND_ASSIGN(JitProfileTask);
 };
 
+// Compiles the hot methods recorded in the profile of the app by its previous runs, so that
+// each launch does not have to warm up the JIT again.
+class JitAppProfileTask final : public Task {
+ public:
+  JitAppProfileTask(const std::string& profile_path, const std::vector<std::string>& code_paths)
+      : profile_path_(profile_path), code_paths_(code_paths) {}
+
+  void Run(Thread* self) override {
+    Runtime::Current()->GetJit()->CompileMethodsFromAppProfile(self, profile_path_, code_paths_);
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  const std::string profile_path_;
+  const std::vector<std::string> code_paths_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitAppProfileTask);
+};
+
 static void CopyIfDifferent(void* s1, const void* s2, size_t n) {
   if (memcmp(s1, s2, n) != 0) {
     memcpy(s1, s2, n);
@@ -1082,13 +1175,69 @@ bool Jit::InZygoteUsingJit() {
   return runtime->IsZygote() && runtime->HasImageWithProfile() && runtime->UseJitCompilation();
 }
 
+void Jit::CreateZygoteTypeLookupTables() {
+  std::vector<const DexFile*> dex_files;
+  std::vector<TypeLookupTable> tables;
+  size_t total_size = 0u;
+  for (const DexFile* dex_file : Runtime::Current()->GetClassLinker()->GetBootClassPath()) {
+    if (dex_file->GetOatDexFile() == nullptr) {
+      TypeLookupTable table = TypeLookupTable::Create(*dex_file);
+      if (table.Valid()) {
+        total_size += table.RawDataLength();
+      }
+      dex_files.push_back(dex_file);
+      tables.push_back(std::move(table));
+    }
+  }
+  if (dex_files.empty()) {
+    return;
+  }
+
+  // Copy the tables to a dedicated read-only mapping. Unlike malloc'ed memory,
+  // which shares pages with data that forked processes write to, the pages of
+  // this mapping stay shared between the zygote and all its children.
+  std::string error_msg;
+  if (total_size != 0u) {
+    type_lookup_tables_map_ = MemMap::MapAnonymous("zygote type lookup tables",
+                                                   total_size,
+                                                   PROT_READ | PROT_WRITE,
+                                                   /*low_4gb=*/ false,
+                                                   &error_msg);
+    if (!type_lookup_tables_map_.IsValid()) {
+      LOG(WARNING) << "Could not map zygote type lookup tables: " << error_msg;
+    }
+  }
+  uint8_t* data = type_lookup_tables_map_.IsValid() ? type_lookup_tables_map_.Begin() : nullptr;
+  for (size_t i = 0; i != dex_files.size(); ++i) {
+    const DexFile* dex_file = dex_files[i];
+    TypeLookupTable table = std::move(tables[i]);
+    if (data != nullptr && table.Valid()) {
+      DCHECK_ALIGNED(data, 4u);
+      const size_t size = table.RawDataLength();
+      memcpy(data, table.RawData(), size);
+      table = TypeLookupTable::Open(dex_file->DataBegin(), data, dex_file->NumClassDefs());
+      data += size;
+    }
+    type_lookup_tables_.push_back(std::make_unique<art::OatDexFile>(std::move(table)));
+    dex_file->SetOatDexFile(type_lookup_tables_.back().get());
+  }
+  if (data != nullptr) {
+    DCHECK_EQ(data, type_lookup_tables_map_.End());
+    if (!type_lookup_tables_map_.Protect(PROT_READ)) {
+      PLOG(WARNING) << "Could not make zygote type lookup tables read-only";
+    }
+  }
+}
+
 void Jit::CreateThreadPool() {
   // There is a DCHECK in the 'AddSamples' method to ensure the tread pool
   // is not null when we instrument.
 
-  thread_pool_.reset(JitThreadPool::Create("Jit thread pool", 1));
-
   Runtime* runtime = Runtime::Current();
+  // The zygote compiles in the background, don't take more cores for it.
+  size_t num_threads = runtime->IsZygote() ? 1u : options_->GetThreadPoolSize();
+  thread_pool_.reset(JitThreadPool::Create("Jit thread pool", num_threads));
+
   thread_pool_->SetPthreadPriority(
       runtime->IsZygote()
           ? options_->GetZygoteThreadPoolPthreadPriority()
@@ -1098,14 +1247,7 @@ void Jit::CreateThreadPool() {
   if (runtime->IsZygote()) {
     // To speed up class lookups, generate a type lookup table for
     // dex files not backed by oat file.
-    for (const DexFile* dex_file : runtime->GetClassLinker()->GetBootClassPath()) {
-      if (dex_file->GetOatDexFile() == nullptr) {
-        TypeLookupTable type_lookup_table = TypeLookupTable::Create(*dex_file);
-        type_lookup_tables_.push_back(
-            std::make_unique<art::OatDexFile>(std::move(type_lookup_table)));
-        dex_file->SetOatDexFile(type_lookup_tables_.back().get());
-      }
-    }
+    CreateZygoteTypeLookupTables();
 
     // Add a task that will verify boot classpath jars that were not
     // pre-compiled.
@@ -1219,6 +1361,41 @@ void Jit::AddCompileTask(Thread* self,
   thread_pool_->AddTask(self, method, compilation_kind);
 }
 
+// Resolve the strings and types referenced by the code of a boot class path method, so that
+// the zygote compiles it with direct references to them, and so that the dex cache entries
+// are populated before fork and shared with all apps.
+static void PreResolveConstants(Thread* self, ClassLinker* class_linker, ArtMethod* method)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  for (const DexInstructionPcPair& inst : method->DexInstructions()) {
+    switch (inst->Opcode()) {
+      case Instruction::CONST_STRING:
+      case Instruction::CONST_STRING_JUMBO: {
+        dex::StringIndex string_index((inst->Opcode() == Instruction::CONST_STRING)
+            ? inst->VRegB_21c()
+            : inst->VRegB_31c());
+        if (class_linker->ResolveString(string_index, method) == nullptr) {
+          self->ClearException();
+        }
+        break;
+      }
+      case Instruction::CONST_CLASS:
+      case Instruction::NEW_INSTANCE:
+      case Instruction::CHECK_CAST:
+      case Instruction::INSTANCE_OF: {
+        dex::TypeIndex type_index((inst->Opcode() == Instruction::INSTANCE_OF)
+            ? inst->VRegC_22c()
+            : inst->VRegB_21c());
+        if (class_linker->ResolveType(type_index, method) == nullptr) {
+          self->ClearException();
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+}
+
 bool Jit::CompileMethodFromProfile(Thread* self,
                                    ClassLinker* class_linker,
                                    uint32_t method_idx,
@@ -1250,6 +1427,9 @@ bool Jit::CompileMethodFromProfile(Thread* self,
       (entry_point == GetQuickResolutionStub())) {
     VLOG(jit) << "JIT Zygote processing method " << ArtMethod::PrettyMethod(method)
               << " from profile";
+    if (Runtime::Current()->IsZygote() && class_loader.IsNull()) {
+      PreResolveConstants(self, class_linker, method);
+    }
     method->SetPreCompiled();
     if (!add_to_queue) {
       CompileMethodInternal(method, self, compilation_kind, /* prejit= */ true);
@@ -1373,6 +1553,75 @@ uint32_t Jit::CompileMethodsFromProfile(
   return added_to_queue;
 }
 
+uint32_t Jit::CompileMethodsFromAppProfile(Thread* self,
+                                           const std::string& profile_path,
+                                           const std::vector<std::string>& code_paths) {
+  if (!OS::FileExists(profile_path.c_str())) {
+    // First run of the app, or the profile was cleared after being compiled.
+    return 0u;
+  }
+  // The profile saver may write the profile concurrently, so this loads it with the file lock.
+  ProfileCompilationInfo profile_info;
+  if (!profile_info.Load(profile_path, /*clear_if_invalid=*/ false)) {
+    return 0u;
+  }
+
+  ScopedObjectAccess soa(self);
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  // Find the loaded dex files of the code paths, and the class loaders that loaded them.
+  VariableSizedHandleScope class_loaders(self);
+  std::vector<std::pair<const DexFile*, Handle<mirror::ClassLoader>>> dex_files;
+  auto collect_dex_files = [&](ObjPtr<mirror::ClassLoader> loader)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    Handle<mirror::ClassLoader> h_loader = class_loaders.NewHandle(loader);
+    if (!IsInstanceOfBaseDexClassLoader(h_loader)) {
+      return;
+    }
+    VisitClassLoaderDexFiles(self, h_loader, [&](const DexFile* dex_file) {
+      if (ContainsElement(code_paths, DexFileLoader::GetBaseLocation(dex_file->GetLocation()))) {
+        dex_files.emplace_back(dex_file, h_loader);
+      }
+      return true;
+    });
+  };
+  ClassLoaderFuncVisitor<decltype(collect_dex_files)> visitor(collect_dex_files);
+  {
+    ReaderMutexLock mu(self, *Locks::classlinker_classes_lock_);
+    class_linker->VisitClassLoaders(&visitor);
+  }
+
+  StackHandleScope<1> hs(self);
+  MutableHandle<mirror::DexCache> dex_cache = hs.NewHandle<mirror::DexCache>(nullptr);
+  uint32_t added_to_queue = 0u;
+  for (const auto& [dex_file, class_loader] : dex_files) {
+    std::set<dex::TypeIndex> class_types;
+    std::set<uint16_t> hot_methods;
+    std::set<uint16_t> other_methods;
+    if (!profile_info.GetClassesAndMethods(*dex_file,
+                                           &class_types,
+                                           &hot_methods,
+                                           &other_methods,
+                                           &other_methods)) {
+      continue;
+    }
+    dex_cache.Assign(class_linker->FindDexCache(self, *dex_file));
+    CHECK(dex_cache != nullptr) << "Could not find dex cache for " << dex_file->GetLocation();
+    for (uint16_t method_idx : hot_methods) {
+      if (CompileMethodFromProfile(self,
+                                   class_linker,
+                                   method_idx,
+                                   dex_cache,
+                                   class_loader,
+                                   /*add_to_queue=*/ true,
+                                   /*compile_after_boot=*/ false)) {
+        ++added_to_queue;
+      }
+    }
+  }
+  VLOG(jit) << "Added " << added_to_queue << " methods of " << profile_path << " to the JIT queue";
+  return added_to_queue;
+}
+
 bool Jit::IgnoreSamplesForMethod(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
   if (method->IsClassInitializer() || !method->IsCompilable()) {
     // We do not want to compile such methods.
@@ -1668,7 +1917,44 @@ bool Jit::CanAssumeInitialized(ObjPtr<mirror::Class> cls, bool is_for_shared_reg
   }
 }
 
-void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self) {
+void Jit::MaybeScheduleHotnessDecay(Thread* self) {
+  uint32_t period_ms = options_->GetHotnessDecayPeriodMs();
+  // Decaying a counter back to the warmup threshold would drop the method from the coverage.
+  if (period_ms == 0u || !Runtime::Current()->GetMethodCoverageFile().empty()) {
+    return;
+  }
+  uint64_t now_ns = NanoTime();
+  uint64_t last_ns = last_hotness_decay_ns_.load(std::memory_order_relaxed);
+  if (now_ns - last_ns < MsToNs(period_ms)) {
+    return;
+  }
+  // Only the thread that updates the time schedules the decay.
+  if (last_hotness_decay_ns_.compare_exchange_strong(last_ns, now_ns, std::memory_order_relaxed)) {
+    thread_pool_->AddTask(self, new JitHotnessDecayTask());
+  }
+}
+
+void Jit::DecayHotnessCounters() {
+  struct DecayCountersVisitor : public ClassVisitor {
+    explicit DecayCountersVisitor(uint16_t threshold) : threshold_(threshold) {}
+
+    bool operator()(ObjPtr<mirror::Class> klass) override REQUIRES_SHARED(Locks::mutator_lock_) {
+      for (ArtMethod& method : klass->GetDeclaredMethods(kRuntimePointerSize)) {
+        if (!method.IsAbstract()) {
+          method.DecayCounter(threshold_);
+        }
+      }
+      return true;
+    }
+
+    const uint16_t threshold_;
+  };
+
+  DecayCountersVisitor visitor(options_->GetWarmupThreshold());
+  Runtime::Current()->GetClassLinker()->VisitClasses(&visitor);
+}
+
+void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self, bool at_back_edge) {
   if (thread_pool_ == nullptr) {
     return;
   }
@@ -1682,6 +1968,10 @@ void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self) {
     return;
   }
 
+  // Methods only get hot through this path, so it is a cheap place to check whether it's
+  // time to forget old samples.
+  MaybeScheduleHotnessDecay(self);
+
   if (IgnoreSamplesForMethod(method)) {
     return;
   }
@@ -1722,7 +2012,12 @@ void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self) {
     }
   }
 
-  if (!method->IsNative() && GetCodeCache()->CanAllocateProfilingInfo()) {
+  if (at_back_edge && options_->OsrAtFirstCompile() && !method->IsNative()) {
+    // The time is spent in a loop rather than in invocations. A single osr compile lets the
+    // interpreter frame enter compiled code at the next hot back edge, and later invocations
+    // use the same code, see JitCodeCache::Commit().
+    AddCompileTask(self, method, CompilationKind::kOsr);
+  } else if (!method->IsNative() && GetCodeCache()->CanAllocateProfilingInfo()) {
     AddCompileTask(self, method, CompilationKind::kBaseline);
   } else {
     AddCompileTask(self, method, CompilationKind::kOptimized);
@@ -1799,27 +2094,54 @@ void JitThreadPool::AddTask(Thread* self, ArtMethod* method, CompilationKind kin
   }
   switch (kind) {
     case CompilationKind::kOsr:
-      if (ContainsElement(osr_enqueued_methods_, method)) {
-        return;
-      }
-      osr_enqueued_methods_.insert(method);
-      osr_queue_.push_back(method);
+      Enqueue(self, osr_queue_, method, kind);
       break;
     case CompilationKind::kBaseline:
-      if (ContainsElement(baseline_enqueued_methods_, method)) {
-        return;
-      }
-      baseline_enqueued_methods_.insert(method);
-      baseline_queue_.push_back(method);
+      Enqueue(self, baseline_queue_, method, kind);
       break;
     case CompilationKind::kOptimized:
-      if (ContainsElement(optimized_enqueued_methods_, method)) {
-        return;
-      }
-      optimized_enqueued_methods_.insert(method);
-      optimized_queue_.push_back(method);
+      Enqueue(self, optimized_queue_, method, kind);
       break;
   }
+}
+
+bool JitThreadPool::IsBeingCompiled(ArtMethod* method) {
+  // There are at most as many compilations as workers.
+  for (JitCompileTask* task : current_compilations_) {
+    if (task->GetArtMethod() == method) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::set<ArtMethod*>& JitThreadPool::GetEnqueuedMethods(CompilationKind kind) {
+  switch (kind) {
+    case CompilationKind::kOsr:
+      return osr_enqueued_methods_;
+    case CompilationKind::kBaseline:
+      return baseline_enqueued_methods_;
+    case CompilationKind::kOptimized:
+      return optimized_enqueued_methods_;
+  }
+  UNREACHABLE();
+}
+
+void JitThreadPool::Enqueue(Thread* self,
+                            MethodQueue& methods,
+                            ArtMethod* method,
+                            CompilationKind kind) {
+  std::set<ArtMethod*>& enqueued_methods = GetEnqueuedMethods(kind);
+  if (ContainsElement(enqueued_methods, method)) {
+    // Bump the priority if the method is still waiting, it is being compiled otherwise.
+    auto it = methods.find(method);
+    if (it != methods.end()) {
+      ++it->second.num_requests;
+    }
+    return;
+  }
+  enqueued_methods.insert(method);
+  methods.emplace(method, QueuedMethod{NanoTime(), /* num_requests= */ 1u});
   // If we have any waiters, signal one.
   if (waiting_count_ != 0) {
     task_queue_condition_.Signal(self);
@@ -1838,6 +2160,9 @@ Task* JitThreadPool::TryGetTaskLocked() {
     return task;
   }
 
+  Runtime::Current()->GetMetrics()->JitMethodCompileQueueDepth()->Add(
+      static_cast<int64_t>(osr_queue_.size() + baseline_queue_.size() + optimized_queue_.size()));
+
   // OSR requests second, then baseline and finally optimized.
   Task* task = FetchFrom(osr_queue_, CompilationKind::kOsr);
   if (task == nullptr) {
@@ -1849,15 +2174,41 @@ Task* JitThreadPool::TryGetTaskLocked() {
   return task;
 }
 
-Task* JitThreadPool::FetchFrom(std::deque<ArtMethod*>& methods, CompilationKind kind) {
-  if (!methods.empty()) {
-    ArtMethod* method = methods.front();
-    methods.pop_front();
-    JitCompileTask* task = new JitCompileTask(method, JitCompileTask::TaskKind::kCompile, kind);
-    current_compilations_.insert(task);
-    return task;
+Task* JitThreadPool::FetchFrom(MethodQueue& methods, CompilationKind kind) {
+  // The queues are short, and compiling a method takes much longer than scanning them.
+  uint64_t now_ns = NanoTime();
+  std::set<ArtMethod*>& enqueued_methods = GetEnqueuedMethods(kind);
+  auto best = methods.end();
+  uint64_t best_priority = 0;
+  for (auto it = methods.begin(); it != methods.end(); ) {
+    const QueuedMethod& queued = it->second;
+    if (IsBeingCompiled(it->first)) {
+      // Leave it to the next fetch, so that workers do not compile the same method at once.
+      ++it;
+      continue;
+    }
+    uint64_t waiting_ns = now_ns - queued.enqueue_time_ns;
+    if (queued.num_requests == 1u && waiting_ns > kStaleQueuedMethodNs) {
+      enqueued_methods.erase(it->first);
+      it = methods.erase(it);
+      Runtime::Current()->GetMetrics()->JitStaleQueuedMethodCount()->AddOne();
+      continue;
+    }
+    uint64_t priority = waiting_ns + queued.num_requests * kRequestWeightNs;
+    if (best == methods.end() || priority > best_priority) {
+      best = it;
+      best_priority = priority;
+    }
+    ++it;
   }
-  return nullptr;
+  if (best == methods.end()) {
+    return nullptr;
+  }
+  JitCompileTask* task = new JitCompileTask(
+      best->first, JitCompileTask::TaskKind::kCompile, kind, best->second.enqueue_time_ns);
+  methods.erase(best);
+  current_compilations_.insert(task);
+  return task;
 }
 
 void JitThreadPool::Remove(JitCompileTask* task) {
@@ -1900,9 +2251,11 @@ void JitThreadPool::VisitRoots(RootVisitor* visitor) {
     // - Generic tasks like `ZygoteVerificationTask` which don't hold any root.
     // - `JitCompileTask` for precompiled methods, which we know are live, being
     //   part of the boot classpath or system server classpath.
-    methods.insert(methods.end(), osr_queue_.begin(), osr_queue_.end());
-    methods.insert(methods.end(), baseline_queue_.begin(), baseline_queue_.end());
-    methods.insert(methods.end(), optimized_queue_.begin(), optimized_queue_.end());
+    for (const MethodQueue* queue : {&osr_queue_, &baseline_queue_, &optimized_queue_}) {
+      for (const auto& entry : *queue) {
+        methods.push_back(entry.first);
+      }
+    }
     for (JitCompileTask* task : current_compilations_) {
       methods.push_back(task->GetArtMethod());
     }
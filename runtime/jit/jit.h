@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_JIT_JIT_H_
 #define ART_RUNTIME_JIT_JIT_H_
 
+#include <atomic>
+#include <unordered_map>
 #include <unordered_set>
 
 #include <android-base/unique_fd.h>
@@ -155,16 +157,41 @@ class JitThreadPool : public AbstractThreadPool {
       // We need peers as we may report the JIT thread, e.g., in the debugger.
       : AbstractThreadPool(name, num_threads, /* create_peers= */ true, worker_stack_size) {}
 
-  // Try to fetch an entry from `methods`. Return null if `methods` is empty.
-  Task* FetchFrom(std::deque<ArtMethod*>& methods, CompilationKind kind) REQUIRES(task_queue_lock_);
+  // A method waiting in one of the compilation queues.
+  struct QueuedMethod {
+    uint64_t enqueue_time_ns;
+    // Compilation requests for the method since it was enqueued, including the first one. Each
+    // request means the method went hot again while waiting.
+    uint32_t num_requests;
+  };
+  using MethodQueue = std::unordered_map<ArtMethod*, QueuedMethod>;
+
+  // A request counts as much as having waited that long, so that methods that keep getting hot
+  // overtake lukewarm ones, and lukewarm ones are still compiled eventually.
+  static constexpr uint64_t kRequestWeightNs = MsToNs(100);
+  // Methods requested only once and waiting longer than this are dropped. They are enqueued
+  // again if they get hot again.
+  static constexpr uint64_t kStaleQueuedMethodNs = MsToNs(10'000);
+
+  // Try to fetch the highest priority entry from `methods`. Return null if `methods` is empty.
+  Task* FetchFrom(MethodQueue& methods, CompilationKind kind) REQUIRES(task_queue_lock_);
+
+  // Add `method` to `methods`, or count one more request if it is already enqueued for `kind`.
+  void Enqueue(Thread* self, MethodQueue& methods, ArtMethod* method, CompilationKind kind)
+      REQUIRES(task_queue_lock_);
+
+  std::set<ArtMethod*>& GetEnqueuedMethods(CompilationKind kind) REQUIRES(task_queue_lock_);
+
+  // Whether a worker is compiling `method`, for any compilation kind.
+  bool IsBeingCompiled(ArtMethod* method) REQUIRES(task_queue_lock_);
 
   std::deque<Task*> generic_queue_ GUARDED_BY(task_queue_lock_);
 
-  std::deque<ArtMethod*> osr_queue_ GUARDED_BY(task_queue_lock_);
-  std::deque<ArtMethod*> baseline_queue_ GUARDED_BY(task_queue_lock_);
-  std::deque<ArtMethod*> optimized_queue_ GUARDED_BY(task_queue_lock_);
+  MethodQueue osr_queue_ GUARDED_BY(task_queue_lock_);
+  MethodQueue baseline_queue_ GUARDED_BY(task_queue_lock_);
+  MethodQueue optimized_queue_ GUARDED_BY(task_queue_lock_);
 
-  // We track the methods that are currently enqueued to avoid
+  // We track the methods that are currently enqueued or being compiled to avoid
   // adding them to the queue multiple times, which could bloat the
   // queues.
   std::set<ArtMethod*> osr_enqueued_methods_ GUARDED_BY(task_queue_lock_);
@@ -362,6 +389,14 @@ class Jit {
                                          Handle<mirror::ClassLoader> class_loader,
                                          bool add_to_queue);
 
+  // Compile the hot methods that the given app profile (.prof extension) recorded for the
+  // dex files of `code_paths`, which must already be loaded. The methods are added to the
+  // JIT queue.
+  // Return the number of methods added to the queue.
+  uint32_t CompileMethodsFromAppProfile(Thread* self,
+                                        const std::string& profile_path,
+                                        const std::vector<std::string>& code_paths);
+
   // Register the dex files to the JIT. This is to perform any compilation/optimization
   // at the point of loading the dex files.
   void RegisterDexFiles(const std::vector<std::unique_ptr<const DexFile>>& dex_files,
@@ -387,15 +422,27 @@ class Jit {
 
   EXPORT void EnqueueOptimizedCompilation(ArtMethod* method, Thread* self);
 
-  EXPORT void MaybeEnqueueCompilation(ArtMethod* method, Thread* self)
+  // `at_back_edge` tells whether the method got hot at a loop back edge of the interpreter.
+  EXPORT void MaybeEnqueueCompilation(ArtMethod* method, Thread* self, bool at_back_edge = false)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   EXPORT static bool TryPatternMatch(ArtMethod* method, CompilationKind compilation_kind)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Try to use a JNI stub from the boot image for a native method instead of compiling
+  // a new one in the code cache. Returns whether the method's entrypoint was updated.
+  static bool TryBootJniStub(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Decay the hotness counters of all methods, so that methods which were only hot for a
+  // while, e.g. during startup, need new samples before they get compiled.
+  void DecayHotnessCounters() REQUIRES_SHARED(Locks::mutator_lock_);
+
  private:
   Jit(JitCodeCache* code_cache, JitOptions* options);
 
+  // Create type lookup tables for boot class path dex files not backed by an oat file.
+  void CreateZygoteTypeLookupTables();
+
   // Whether we should not add hotness counts for the given method.
   bool IgnoreSamplesForMethod(ArtMethod* method)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -417,6 +464,9 @@ class Jit {
                       ArtMethod* method,
                       CompilationKind compilation_kind);
 
+  // Schedule a DecayHotnessCounters() task if the decay period has elapsed.
+  void MaybeScheduleHotnessDecay(Thread* self);
+
   bool CompileMethodInternal(ArtMethod* method,
                              Thread* self,
                              CompilationKind compilation_kind,
@@ -431,6 +481,8 @@ class Jit {
   const JitOptions* const options_;
 
   std::unique_ptr<JitThreadPool> thread_pool_;
+  // Read-only backing storage of `type_lookup_tables_`, shared with children of the zygote.
+  MemMap type_lookup_tables_map_;
   std::vector<std::unique_ptr<OatDexFile>> type_lookup_tables_;
 
   Mutex boot_completed_lock_;
@@ -466,6 +518,9 @@ class Jit {
   // between the zygote and apps.
   std::map<ArtMethod*, uint16_t> shared_method_counters_;
 
+  // The time in nanoseconds at which the hotness counters were last decayed.
+  std::atomic<uint64_t> last_hotness_decay_ns_;
+
   friend class art::jit::JitCompileTask;
 
   DISALLOW_COPY_AND_ASSIGN(Jit);
@@ -113,6 +113,13 @@ class JitCodeCache::JniStubKey {
   const bool is_synchronized_;
 };
 
+// Returns whether `ptr` was allocated by one of `allocs`.
+static bool ContainedInAnyUnsafe(ArrayRef<const LinearAlloc* const> allocs, void* ptr) {
+  return std::any_of(allocs.begin(), allocs.end(), [ptr](const LinearAlloc* alloc) {
+    return alloc->ContainsUnsafe(ptr);
+  });
+}
+
 class JitCodeCache::JniStubData {
  public:
   JniStubData() : code_(nullptr), methods_() {}
@@ -163,11 +170,12 @@ class JitCodeCache::JniStubData {
     return methods_;
   }
 
-  void RemoveMethodsIn(const LinearAlloc& alloc) REQUIRES_SHARED(Locks::mutator_lock_) {
+  void RemoveMethodsIn(ArrayRef<const LinearAlloc* const> allocs)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
     auto kept_end = std::partition(
         methods_.begin(),
         methods_.end(),
-        [&alloc](ArtMethod* method) { return !alloc.ContainsUnsafe(method); });
+        [allocs](ArtMethod* method) { return !ContainedInAnyUnsafe(allocs, method); });
     for (auto it = kept_end; it != methods_.end(); it++) {
       VLOG(jit) << "JIT removed (JNI) " << (*it)->PrettyMethod() << ": " << code_;
     }
@@ -259,6 +267,8 @@ JitCodeCache::JitCodeCache()
     : is_weak_access_enabled_(true),
       inline_cache_cond_("Jit inline cache condition variable", *Locks::jit_lock_),
       reserved_capacity_(GetInitialCapacity() * kReservedCapacityMultiplier),
+      code_index_(nullptr),
+      num_unindexed_methods_(0u),
       zygote_map_(&shared_region_),
       lock_cond_("Jit code cache condition variable", *Locks::jit_lock_),
       collection_in_progress_(false),
@@ -267,12 +277,14 @@ JitCodeCache::JitCodeCache()
       number_of_optimized_compilations_(0),
       number_of_osr_compilations_(0),
       number_of_collections_(0),
+      number_of_osr_recompilations_(0),
       histogram_stack_map_memory_use_("Memory used for stack maps", 16),
       histogram_code_memory_use_("Memory used for compiled code", 16),
       histogram_profiling_info_memory_use_("Memory used for profiling info", 16) {
 }
 
 JitCodeCache::~JitCodeCache() {
+  delete code_index_.load(std::memory_order_relaxed);
   if (private_region_.HasCodeMapping()) {
     const MemMap* exec_pages = private_region_.GetExecPages();
     Runtime::Current()->RemoveGeneratedCodeRange(exec_pages->Begin(), exec_pages->Size());
@@ -457,6 +469,10 @@ void JitCodeCache::SweepRootTables(IsMarkedVisitor* visitor) {
           mirror::Class* new_klass = down_cast<mirror::Class*>(visitor->IsMarked(klass));
           if (new_klass != klass) {
             cache->classes_[j] = GcRoot<mirror::Class>(new_klass);
+            if (new_klass == nullptr) {
+              // The entry may be reused for another class.
+              cache->counts_[j] = 0u;
+            }
           }
         }
       }
@@ -526,7 +542,7 @@ void JitCodeCache::FreeAllMethodHeaders(
   }
 }
 
-void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
+void JitCodeCache::RemoveMethodsIn(Thread* self, ArrayRef<const LinearAlloc* const> allocs) {
   ScopedTrace trace(__PRETTY_FUNCTION__);
   ScopedDebugDisallowReadBarriers sddrb(self);
   // We use a set to first collect all method_headers whose code need to be
@@ -540,7 +556,7 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
   // lead to a deadlock.
   {
     for (auto it = jni_stubs_map_.begin(); it != jni_stubs_map_.end();) {
-      it->second.RemoveMethodsIn(alloc);
+      it->second.RemoveMethodsIn(allocs);
       if (it->second.GetMethods().empty()) {
         method_headers.insert(OatQuickMethodHeader::FromCodePointer(it->second.GetCode()));
         it = jni_stubs_map_.erase(it);
@@ -550,21 +566,21 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
       }
     }
     for (auto it = zombie_jni_code_.begin(); it != zombie_jni_code_.end();) {
-      if (alloc.ContainsUnsafe(*it)) {
+      if (ContainedInAnyUnsafe(allocs, *it)) {
         it = zombie_jni_code_.erase(it);
       } else {
         ++it;
       }
     }
     for (auto it = processed_zombie_jni_code_.begin(); it != processed_zombie_jni_code_.end();) {
-      if (alloc.ContainsUnsafe(*it)) {
+      if (ContainedInAnyUnsafe(allocs, *it)) {
         it = processed_zombie_jni_code_.erase(it);
       } else {
         ++it;
       }
     }
     for (auto it = method_code_map_.begin(); it != method_code_map_.end();) {
-      if (alloc.ContainsUnsafe(it->second)) {
+      if (ContainedInAnyUnsafe(allocs, it->second)) {
         method_headers.insert(OatQuickMethodHeader::FromCodePointer(it->first));
         VLOG(jit) << "JIT removed " << it->second->PrettyMethod() << ": " << it->first;
         zombie_code_.erase(it->first);
@@ -577,7 +593,7 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
   }
   for (auto it = osr_code_map_.begin(); it != osr_code_map_.end();) {
     DCHECK(!ContainsElement(zombie_code_, it->second));
-    if (alloc.ContainsUnsafe(it->first)) {
+    if (ContainedInAnyUnsafe(allocs, it->first)) {
       // Note that the code has already been pushed to method_headers in the loop
       // above and is going to be removed in FreeCode() below.
       it = osr_code_map_.erase(it);
@@ -587,13 +603,21 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
   }
   for (auto it = profiling_infos_.begin(); it != profiling_infos_.end();) {
     ProfilingInfo* info = it->second;
-    if (alloc.ContainsUnsafe(info->GetMethod())) {
+    if (ContainedInAnyUnsafe(allocs, info->GetMethod())) {
       private_region_.FreeWritableData(reinterpret_cast<uint8_t*>(info));
       it = profiling_infos_.erase(it);
     } else {
       ++it;
     }
   }
+  for (auto it = collected_osr_methods_.begin(); it != collected_osr_methods_.end();) {
+    if (ContainedInAnyUnsafe(allocs, *it)) {
+      it = collected_osr_methods_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  UpdateCodeIndexLocked();
   FreeAllMethodHeaders(method_headers);
 }
 
@@ -633,17 +657,21 @@ void JitCodeCache::DisallowInlineCacheAccess() {
 
 void JitCodeCache::CopyInlineCacheInto(
     const InlineCache& ic,
-    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
+    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+    /*out*/std::array<uint32_t, InlineCache::kIndividualCacheSize>* counts) {
   static_assert(arraysize(ic.classes_) == InlineCache::kIndividualCacheSize);
   DCHECK_EQ(classes->Capacity(), InlineCache::kIndividualCacheSize);
   DCHECK_EQ(classes->Size(), 0u);
   WaitUntilInlineCacheAccessible(Thread::Current());
   // Note that we don't need to lock `lock_` here, the compiler calling
   // this method has already ensured the inline cache will not be deleted.
-  for (const GcRoot<mirror::Class>& root : ic.classes_) {
-    mirror::Class* object = root.Read();
+  for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
+    mirror::Class* object = ic.classes_[i].Read();
     if (object != nullptr) {
       DCHECK_LT(classes->Size(), classes->Capacity());
+      if (counts != nullptr) {
+        (*counts)[classes->Size()] = ic.counts_[i];
+      }
       classes->NewHandle(object);
     }
   }
@@ -690,6 +718,10 @@ bool JitCodeCache::Commit(Thread* self,
     switch (compilation_kind) {
       case CompilationKind::kOsr:
         number_of_osr_compilations_++;
+        if (collected_osr_methods_.erase(method) != 0u) {
+          number_of_osr_recompilations_++;
+          Runtime::Current()->GetMetrics()->JitOsrRecompileCount()->AddOne();
+        }
         break;
       case CompilationKind::kBaseline:
         number_of_baseline_compilations_++;
@@ -755,10 +787,22 @@ bool JitCodeCache::Commit(Thread* self,
       } else {
         ScopedDebugDisallowReadBarriers sddrb(self);
         method_code_map_.Put(code_ptr, method);
+        AddToCodeIndexLocked();
       }
       if (compilation_kind == CompilationKind::kOsr) {
         ScopedDebugDisallowReadBarriers sddrb(self);
         osr_code_map_.Put(method, code_ptr);
+        // Osr code is complete code for the method. If the osr compile was the first compile of
+        // the method, also enter the method through it.
+        ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+        const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+        if (Runtime::Current()->GetJITOptions()->OsrAtFirstCompile() &&
+            !method->StillNeedsClinitCheck() &&
+            (class_linker->IsNterpEntryPoint(entry_point) ||
+             class_linker->IsQuickToInterpreterBridge(entry_point))) {
+          Runtime::Current()->GetInstrumentation()->UpdateMethodsCode(
+              method, method_header->GetEntryPoint());
+        }
       } else if (method->StillNeedsClinitCheck()) {
         ScopedDebugDisallowReadBarriers sddrb(self);
         // This situation currently only occurs in the jit-zygote mode.
@@ -847,23 +891,31 @@ bool JitCodeCache::RemoveMethodLocked(ArtMethod* method, bool release_memory) {
       }
     }
   } else {
+    std::vector<const void*> removed_code;
     for (auto it = method_code_map_.begin(); it != method_code_map_.end();) {
       if (it->second == method) {
         in_cache = true;
-        if (release_memory) {
-          FreeCodeAndData(it->first);
-        }
+        removed_code.push_back(it->first);
         VLOG(jit) << "JIT removed " << it->second->PrettyMethod() << ": " << it->first;
         it = method_code_map_.erase(it);
       } else {
         ++it;
       }
     }
+    if (in_cache) {
+      UpdateCodeIndexLocked();
+      if (release_memory) {
+        for (const void* code_ptr : removed_code) {
+          FreeCodeAndData(code_ptr);
+        }
+      }
+    }
 
     auto osr_it = osr_code_map_.find(method);
     if (osr_it != osr_code_map_.end()) {
       osr_code_map_.erase(osr_it);
     }
+    collected_osr_methods_.erase(method);
   }
 
   return in_cache;
@@ -903,12 +955,16 @@ void JitCodeCache::MoveObsoleteMethod(ArtMethod* old_method, ArtMethod* new_meth
       it.second = new_method;
     }
   }
+  UpdateCodeIndexLocked();
   // Update osr_code_map_ to point to the new method.
   auto code_map = osr_code_map_.find(old_method);
   if (code_map != osr_code_map_.end()) {
     osr_code_map_.Put(new_method, code_map->second);
     osr_code_map_.erase(old_method);
   }
+  if (collected_osr_methods_.erase(old_method) != 0u) {
+    collected_osr_methods_.insert(new_method);
+  }
 }
 
 void JitCodeCache::TransitionToDebuggable() {
@@ -1144,6 +1200,7 @@ void JitCodeCache::RemoveUnmarkedCode(Thread* self) {
       ++it;
     }
   }
+  UpdateCodeIndexLocked();
   FreeAllMethodHeaders(method_headers);
 }
 
@@ -1234,9 +1291,40 @@ void JitCodeCache::MaybeUpdateInlineCache(ArtMethod* method,
   info->AddInvokeInfo(dex_pc, cls.Ptr());
 }
 
+bool JitCodeCache::HasOptimizedEntryPoint(ArtMethod* method) {
+  const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+  return ContainsPc(entry_point) &&
+         !CodeInfo::IsBaseline(
+             OatQuickMethodHeader::FromEntryPoint(entry_point)->GetOptimizedCodeInfoPtr());
+}
+
+void JitCodeCache::UpdateCodeIndexLocked() {
+  std::vector<JitCodeIndex::Entry> entries(method_code_map_.begin(), method_code_map_.end());
+  const JitCodeIndex* old_index = code_index_.exchange(new JitCodeIndex(std::move(entries)),
+                                                       std::memory_order_release);
+  if (old_index != nullptr) {
+    retired_code_indexes_.emplace_back(old_index);
+  }
+  num_unindexed_methods_ = 0u;
+}
+
+void JitCodeCache::AddToCodeIndexLocked() {
+  // Code missing from the index is found in `method_code_map_` under the lock, so the index
+  // is only rebuilt once the missing code is a sizable fraction of the index. This bounds the
+  // memory of retired indexes to a small multiple of the size of the index.
+  static constexpr size_t kMinUnindexedMethods = 16;
+  ++num_unindexed_methods_;
+  const JitCodeIndex* index = code_index_.load(std::memory_order_relaxed);
+  size_t num_indexed_methods = (index == nullptr) ? 0u : index->Size();
+  if (num_unindexed_methods_ >= kMinUnindexedMethods + num_indexed_methods / 4) {
+    UpdateCodeIndexLocked();
+  }
+}
+
 void JitCodeCache::DoCollection(Thread* self) {
   ScopedTrace trace(__FUNCTION__);
 
+  std::vector<std::unique_ptr<const JitCodeIndex>> retired_code_indexes;
   {
     ScopedDebugDisallowReadBarriers sddrb(self);
     MutexLock mu(self, *Locks::jit_lock_);
@@ -1247,6 +1335,7 @@ void JitCodeCache::DoCollection(Thread* self) {
     }
     collection_in_progress_ = true;
     number_of_collections_++;
+    retired_code_indexes.swap(retired_code_indexes_);
     live_bitmap_.reset(CodeCacheBitmap::Create(
           "code-cache-bitmap",
           reinterpret_cast<uintptr_t>(private_region_.GetExecPages()->Begin()),
@@ -1256,14 +1345,30 @@ void JitCodeCache::DoCollection(Thread* self) {
     zombie_code_.clear();
     processed_zombie_jni_code_.insert(zombie_jni_code_.begin(), zombie_jni_code_.end());
     zombie_jni_code_.clear();
-    // Empty osr method map, as osr compiled code will be deleted (except the ones
-    // on thread stacks).
-    for (auto it = osr_code_map_.begin(); it != osr_code_map_.end(); ++it) {
+    // Remove osr compiled code from the osr method map, as it will be deleted (except the ones
+    // on thread stacks). Most collections keep the code of methods that have no optimized code
+    // to enter instead, as they would likely need osr compiling again soon. Every
+    // `kFullCollectionInterval`-th collection removes all osr compiled code.
+    static constexpr size_t kFullCollectionInterval = 8;
+    bool full_collection = (number_of_collections_ % kFullCollectionInterval) == 0u;
+    for (auto it = osr_code_map_.begin(); it != osr_code_map_.end();) {
+      if (it->first->GetEntryPointFromQuickCompiledCode() ==
+              OatQuickMethodHeader::FromCodePointer(it->second)->GetEntryPoint()) {
+        // The osr code is also the code of the method, see Commit().
+        ++it;
+        continue;
+      }
+      if (!full_collection && !HasOptimizedEntryPoint(it->first)) {
+        ++it;
+        continue;
+      }
       processed_zombie_code_.insert(it->second);
+      collected_osr_methods_.insert(it->first);
+      it = osr_code_map_.erase(it);
     }
-    osr_code_map_.clear();
   }
   TimingLogger logger("JIT code cache timing logger", true, VLOG_IS_ON(jit));
+  uint64_t start_time_ns = NanoTime();
   {
     TimingLogger::ScopedTiming st("Code cache collection", &logger);
 
@@ -1271,6 +1376,8 @@ void JitCodeCache::DoCollection(Thread* self) {
       ScopedObjectAccess soa(self);
       // Run a checkpoint on all threads to mark the JIT compiled code they are running.
       MarkCompiledCodeOnThreadStacks(self);
+      // No thread can still be looking up code in the indexes retired before the checkpoint.
+      retired_code_indexes.clear();
 
       // Remove zombie code which hasn't been marked.
       RemoveUnmarkedCode(self);
@@ -1280,6 +1387,8 @@ void JitCodeCache::DoCollection(Thread* self) {
     live_bitmap_.reset(nullptr);
     NotifyCollectionDone(self);
   }
+  Runtime::Current()->GetMetrics()->JitCodeCacheCollectionTimeUs()->Add(
+      NsToUs(NanoTime() - start_time_ns));
 
   Runtime::Current()->GetJit()->AddTimingLogger(logger);
 }
@@ -1304,6 +1413,23 @@ OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod*
 
   Thread* self = Thread::Current();
   ScopedDebugDisallowReadBarriers sddrb(self);
+  if (method != nullptr &&
+      !method->IsNative() &&
+      PrivateRegionContainsPc(pc_ptr) &&
+      self->GetState() == ThreadState::kRunnable) {
+    // Retired indexes are deleted only after a checkpoint, which a runnable thread does not run
+    // before returning from here. Code is removed from the index before it is freed, so an entry
+    // that matches `method` and contains `pc` is the live code. Otherwise, look in
+    // `method_code_map_` which may have code that is not indexed yet.
+    const JitCodeIndex* index = code_index_.load(std::memory_order_acquire);
+    const JitCodeIndex::Entry* entry = (index != nullptr) ? index->Find(pc) : nullptr;
+    if (entry != nullptr && entry->second == method) {
+      OatQuickMethodHeader* header = OatQuickMethodHeader::FromCodePointer(entry->first);
+      if (header->Contains(pc)) {
+        return header;
+      }
+    }
+  }
   MutexLock mu(self, *Locks::jit_lock_);
   OatQuickMethodHeader* method_header = nullptr;
   ArtMethod* found_method = nullptr;  // Only for DCHECK(), not for JNI stubs.
@@ -1665,6 +1791,16 @@ void JitCodeCache::DoneCompiling(ArtMethod* method, Thread* self) {
   }
 }
 
+// Marks a method whose compiled code got invalidated as hot, so that its first invocation in the
+// interpreter requests a new compilation instead of waiting for the warmup threshold again. The
+// new code is compiled for the current runtime state, which includes the instrumentation support
+// debuggable runtimes need.
+static void MarkHotAfterInvalidation(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (!method->IsAbstract() && !method->IsMemorySharedMethod()) {
+    method->SetHotCounter();
+  }
+}
+
 void JitCodeCache::InvalidateAllCompiledCode() {
   Thread* self = Thread::Current();
   ScopedDebugDisallowReadBarriers sddrb(self);
@@ -1685,6 +1821,7 @@ void JitCodeCache::InvalidateAllCompiledCode() {
     for (ArtMethod* method : data.GetMethods()) {
       if (method->GetEntryPointFromQuickCompiledCode() == method_header->GetEntryPoint()) {
         instr->InitializeMethodsCode(method, /*aot_code=*/ nullptr);
+        MarkHotAfterInvalidation(method);
       }
     }
   }
@@ -1694,6 +1831,7 @@ void JitCodeCache::InvalidateAllCompiledCode() {
       linker->SetEntryPointsForObsoleteMethod(meth);
     } else {
       instr->InitializeMethodsCode(meth, /*aot_code=*/ nullptr);
+      MarkHotAfterInvalidation(meth);
     }
   }
 
@@ -1739,6 +1877,37 @@ void JitCodeCache::InvalidateCompiledCodeFor(ArtMethod* method,
   }
 }
 
+void JitCodeCache::InvalidateCompiledCodeFor(
+    ArrayRef<const std::pair<ArtMethod*, OatQuickMethodHeader*>> methods_and_code) {
+  // Update the entry points first, like the single method version does outside the JIT lock.
+  std::vector<std::pair<ArtMethod*, const OatQuickMethodHeader*>> osr_candidates;
+  for (const auto& [method, header] : methods_and_code) {
+    DCHECK(!method->IsNative());
+    if (method->GetEntryPointFromQuickCompiledCode() == header->GetEntryPoint()) {
+      Runtime::Current()->GetInstrumentation()->InitializeMethodsCode(method,
+                                                                      /*aot_code=*/ nullptr);
+    } else {
+      osr_candidates.emplace_back(method, header);
+    }
+    if (method->IsPreCompiled()) {
+      method->ClearPreCompiled();
+    }
+  }
+  if (osr_candidates.empty()) {
+    return;
+  }
+  Thread* self = Thread::Current();
+  ScopedDebugDisallowReadBarriers sddrb(self);
+  MutexLock mu(self, *Locks::jit_lock_);
+  for (const auto& [method, header] : osr_candidates) {
+    auto it = osr_code_map_.find(method);
+    if (it != osr_code_map_.end() && OatQuickMethodHeader::FromCodePointer(it->second) == header) {
+      // Remove the OSR method, to avoid using it again.
+      osr_code_map_.erase(it);
+    }
+  }
+}
+
 void JitCodeCache::Dump(std::ostream& os) {
   MutexLock mu(Thread::Current(), *Locks::jit_lock_);
   os << "Current JIT code cache size (used / resident): "
@@ -1763,6 +1932,8 @@ void JitCodeCache::Dump(std::ostream& os) {
      << "Total number of JIT optimized compilations: " << number_of_optimized_compilations_ << "\n"
      << "Total number of JIT compilations for on stack replacement: "
         << number_of_osr_compilations_ << "\n"
+     << "Total number of JIT recompilations for on stack replacement: "
+        << number_of_osr_recompilations_ << "\n"
      << "Total number of JIT code cache collections: " << number_of_collections_ << std::endl;
   histogram_stack_map_memory_use_.PrintMemoryUse(os);
   histogram_code_memory_use_.PrintMemoryUse(os);
@@ -17,12 +17,15 @@
 #ifndef ART_RUNTIME_JIT_JIT_CODE_CACHE_H_
 #define ART_RUNTIME_JIT_JIT_CODE_CACHE_H_
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <iosfwd>
 #include <memory>
 #include <set>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "base/arena_containers.h"
@@ -179,6 +182,37 @@ class ZygoteMap {
   DISALLOW_COPY_AND_ASSIGN(ZygoteMap);
 };
 
+// Immutable sorted copy of JitCodeCache.method_code_map_, used to find the code containing a pc
+// without taking the JIT lock. The code cache publishes a new index whenever it removes code,
+// and once enough code was added since the current index was built.
+class JitCodeIndex {
+ public:
+  using Entry = std::pair<const void*, ArtMethod*>;
+
+  explicit JitCodeIndex(std::vector<Entry>&& entries) : entries_(std::move(entries)) {
+    DCHECK(std::is_sorted(entries_.begin(), entries_.end()));
+  }
+
+  // Return the entry with the highest code pointer not above `pc`, or null if there is none.
+  const Entry* Find(uintptr_t pc) const {
+    const void* pc_ptr = reinterpret_cast<const void*>(pc);
+    auto it = std::upper_bound(entries_.begin(),
+                               entries_.end(),
+                               pc_ptr,
+                               [](const void* lhs, const Entry& rhs) { return lhs < rhs.first; });
+    return (it == entries_.begin()) ? nullptr : &*(it - 1);
+  }
+
+  size_t Size() const {
+    return entries_.size();
+  }
+
+ private:
+  const std::vector<Entry> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitCodeIndex);
+};
+
 class JitCodeCache {
  public:
   static constexpr size_t kMaxCapacity = 64 * MB;
@@ -309,13 +343,18 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES(Locks::mutator_lock_);
 
-  // Remove all methods in our cache that were allocated by 'alloc'.
-  void RemoveMethodsIn(Thread* self, const LinearAlloc& alloc)
+  // Remove all methods in our cache that were allocated by any of 'allocs'. Removing the methods
+  // of several allocators at once walks the cache maps and CHA dependencies only once.
+  void RemoveMethodsIn(Thread* self, ArrayRef<const LinearAlloc* const> allocs)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  void CopyInlineCacheInto(const InlineCache& ic,
-                           /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes)
+  // Copy the classes of the inline cache into `classes`. If `counts` is not null, the counts of
+  // the classes are copied into it, at the same indexes.
+  void CopyInlineCacheInto(
+      const InlineCache& ic,
+      /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+      /*out*/std::array<uint32_t, InlineCache::kIndividualCacheSize>* counts = nullptr)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -349,6 +388,12 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Same as above for several methods and their code, taking the JIT lock at most once.
+  void InvalidateCompiledCodeFor(
+      ArrayRef<const std::pair<ArtMethod*, OatQuickMethodHeader*>> methods_and_code)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   void Dump(std::ostream& os) REQUIRES(!Locks::jit_lock_);
   void DumpAllCompiledMethods(std::ostream& os)
       REQUIRES(!Locks::jit_lock_)
@@ -487,6 +532,16 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Whether the entry point of `method` is optimized JIT compiled code.
+  bool HasOptimizedEntryPoint(ArtMethod* method) REQUIRES(Locks::jit_lock_);
+
+  // Publish a new `code_index_` built from `method_code_map_`. Must be called in the same
+  // critical section as removals from `method_code_map_`, before the code is freed.
+  void UpdateCodeIndexLocked() REQUIRES(Locks::jit_lock_);
+
+  // Called when code is added to `method_code_map_`.
+  void AddToCodeIndexLocked() REQUIRES(Locks::jit_lock_);
+
   void MarkCompiledCodeOnThreadStacks(Thread* self)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -549,6 +604,18 @@ class JitCodeCache {
   // Holds compiled code associated to the ArtMethod.
   SafeMap<const void*, ArtMethod*> method_code_map_ GUARDED_BY(Locks::jit_lock_);
 
+  // Lock-free snapshot of `method_code_map_` for LookupMethodHeader(). It may miss code
+  // added recently, which the lookup then finds in `method_code_map_`.
+  Atomic<const JitCodeIndex*> code_index_;
+
+  // Indexes replaced since the last code cache collection. Runnable threads may still be
+  // reading them, so they are deleted after the collection has run a checkpoint.
+  std::vector<std::unique_ptr<const JitCodeIndex>> retired_code_indexes_
+      GUARDED_BY(Locks::jit_lock_);
+
+  // The number of entries added to `method_code_map_` after `code_index_` was built.
+  size_t num_unindexed_methods_ GUARDED_BY(Locks::jit_lock_);
+
   // Holds compiled code associated to the ArtMethod. Used when pre-jitting
   // methods whose entrypoints have the resolution stub.
   SafeMap<ArtMethod*, const void*> saved_compiled_methods_map_ GUARDED_BY(Locks::jit_lock_);
@@ -556,6 +623,10 @@ class JitCodeCache {
   // Holds osr compiled code associated to the ArtMethod.
   SafeMap<ArtMethod*, const void*> osr_code_map_ GUARDED_BY(Locks::jit_lock_);
 
+  // Methods whose osr compiled code was removed from `osr_code_map_` by a collection, to
+  // count the methods that need osr compiling again.
+  std::set<ArtMethod*> collected_osr_methods_ GUARDED_BY(Locks::jit_lock_);
+
   // ProfilingInfo objects we have allocated.
   SafeMap<ArtMethod*, ProfilingInfo*> profiling_infos_ GUARDED_BY(Locks::jit_lock_);
 
@@ -601,6 +672,9 @@ class JitCodeCache {
   // Number of code cache collections done throughout the lifetime of the JIT.
   size_t number_of_collections_ GUARDED_BY(Locks::jit_lock_);
 
+  // Number of osr compilations of methods whose osr compiled code a collection removed.
+  size_t number_of_osr_recompilations_ GUARDED_BY(Locks::jit_lock_);
+
   // Histograms for keeping track of stack map size statistics.
   Histogram<uint64_t> histogram_stack_map_memory_use_ GUARDED_BY(Locks::jit_lock_);
 
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit/jit_code_cache.h"
+
+#include <gtest/gtest.h>
+
+namespace art HIDDEN {
+namespace jit {
+
+TEST(JitCodeIndexTest, Find) {
+  uint8_t code[64];
+  ArtMethod* method1 = reinterpret_cast<ArtMethod*>(0x1000);
+  ArtMethod* method2 = reinterpret_cast<ArtMethod*>(0x2000);
+  JitCodeIndex index({{&code[8], method1}, {&code[32], method2}});
+  ASSERT_EQ(index.Size(), 2u);
+
+  auto find = [&](size_t offset) { return index.Find(reinterpret_cast<uintptr_t>(&code[offset])); };
+  EXPECT_EQ(find(0), nullptr);
+  EXPECT_EQ(find(7), nullptr);
+  ASSERT_NE(find(8), nullptr);
+  EXPECT_EQ(find(8)->second, method1);
+  EXPECT_EQ(find(31)->second, method1);
+  EXPECT_EQ(find(32)->second, method2);
+  EXPECT_EQ(find(63)->second, method2);
+}
+
+TEST(JitCodeIndexTest, Empty) {
+  JitCodeIndex index({});
+  EXPECT_EQ(index.Size(), 0u);
+  EXPECT_EQ(index.Find(reinterpret_cast<uintptr_t>(&index)), nullptr);
+}
+
+}  // namespace jit
+}  // namespace art
@@ -48,6 +48,10 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
   jit_options->use_jit_compilation_ = options.GetOrDefault(RuntimeArgumentMap::UseJitCompilation);
   jit_options->use_profiled_jit_compilation_ =
       options.GetOrDefault(RuntimeArgumentMap::UseProfiledJitCompilation);
+  jit_options->precompile_app_profile_ =
+      options.GetOrDefault(RuntimeArgumentMap::JitPrecompileAppProfile);
+  jit_options->osr_at_first_compile_ =
+      options.GetOrDefault(RuntimeArgumentMap::JitOsrAtFirstCompile);
 
   jit_options->code_cache_initial_capacity_ =
       options.GetOrDefault(RuntimeArgumentMap::JITCodeCacheInitialCapacity);
@@ -61,6 +65,10 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
       options.GetOrDefault(RuntimeArgumentMap::JITPoolThreadPthreadPriority);
   jit_options->zygote_thread_pool_pthread_priority_ =
       options.GetOrDefault(RuntimeArgumentMap::JITZygotePoolThreadPthreadPriority);
+  jit_options->thread_pool_size_ =
+      std::max(options.GetOrDefault(RuntimeArgumentMap::JITThreadPoolSize), 1u);
+  jit_options->hotness_decay_period_ms_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITHotnessDecayPeriodMs);
 
   // Set default optimize threshold to aid with checking defaults.
   jit_options->optimize_threshold_ = kIsDebugBuild
@@ -82,6 +90,14 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
   }
   DCHECK_LE(jit_options->warmup_threshold_, kJitMaxThreshold);
 
+  jit_options->mid_tier_min_code_units_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITMidTierMinCodeUnits);
+  jit_options->mid_tier_optimize_threshold_ =
+      options.Exists(RuntimeArgumentMap::JITMidTierOptimizeThreshold)
+          ? *options.Get(RuntimeArgumentMap::JITMidTierOptimizeThreshold)
+          : jit_options->optimize_threshold_;
+  DCHECK_LE(jit_options->mid_tier_optimize_threshold_, kJitMaxThreshold);
+
   if (options.Exists(RuntimeArgumentMap::JITPriorityThreadWeight)) {
     jit_options->priority_thread_weight_ =
         *options.Get(RuntimeArgumentMap::JITPriorityThreadWeight);
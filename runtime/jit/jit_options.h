@@ -34,6 +34,11 @@ static constexpr int kJitPoolThreadPthreadDefaultPriority = 9;
 // 19 is the lowest background priority on device.
 // See android/os/Process.java.
 static constexpr int kJitZygotePoolThreadPthreadDefaultPriority = 19;
+// How many threads compile methods, outside of the zygote which always uses one.
+static constexpr unsigned int kJitDefaultThreadPoolSize = 1;
+// Methods with at least that many code units get a mid tier compile between the baseline and
+// the optimized compiles. 0 disables the mid tier.
+static constexpr unsigned int kJitDefaultMidTierMinCodeUnits = 1000;
 
 class JitOptions {
  public:
@@ -49,6 +54,15 @@ class JitOptions {
     return warmup_threshold_;
   }
 
+  uint32_t GetMidTierMinCodeUnits() const {
+    return mid_tier_min_code_units_;
+  }
+
+  // The hotness count of mid tier code before it requests an optimized compile.
+  uint16_t GetMidTierOptimizeThreshold() const {
+    return mid_tier_optimize_threshold_;
+  }
+
   uint16_t GetPriorityThreadWeight() const {
     return priority_thread_weight_;
   }
@@ -57,6 +71,12 @@ class JitOptions {
     return invoke_transition_weight_;
   }
 
+  // The period, in milliseconds, at which the hotness counters of interpreted methods decay
+  // back towards the warmup threshold. 0 disables the decay.
+  uint32_t GetHotnessDecayPeriodMs() const {
+    return hotness_decay_period_ms_;
+  }
+
   size_t GetCodeCacheInitialCapacity() const {
     return code_cache_initial_capacity_;
   }
@@ -85,6 +105,10 @@ class JitOptions {
     return zygote_thread_pool_pthread_priority_;
   }
 
+  size_t GetThreadPoolSize() const {
+    return thread_pool_size_;
+  }
+
   bool UseJitCompilation() const {
     return use_jit_compilation_;
   }
@@ -93,6 +117,17 @@ class JitOptions {
     return use_profiled_jit_compilation_;
   }
 
+  // Whether to compile the hot methods of the app profile when the profile saver starts.
+  bool PrecompileAppProfile() const {
+    return precompile_app_profile_;
+  }
+
+  // Whether a method that gets hot at a loop back edge before having any compiled code is
+  // compiled with osr entries, and that code is also used to enter the method.
+  bool OsrAtFirstCompile() const {
+    return osr_at_first_compile_;
+  }
+
   void SetUseJitCompilation(bool b) {
     use_jit_compilation_ = b;
   }
@@ -108,6 +143,7 @@ class JitOptions {
   void SetJitAtFirstUse() {
     use_jit_compilation_ = true;
     optimize_threshold_ = 0;
+    mid_tier_min_code_units_ = 0;
   }
 
   void SetUseBaselineCompiler() {
@@ -125,31 +161,43 @@ class JitOptions {
 
   bool use_jit_compilation_;
   bool use_profiled_jit_compilation_;
+  bool precompile_app_profile_;
+  bool osr_at_first_compile_;
   bool use_baseline_compiler_;
   size_t code_cache_initial_capacity_;
   size_t code_cache_max_capacity_;
   uint32_t optimize_threshold_;
   uint32_t warmup_threshold_;
+  uint32_t mid_tier_min_code_units_;
+  uint32_t mid_tier_optimize_threshold_;
   uint16_t priority_thread_weight_;
   uint16_t invoke_transition_weight_;
+  uint32_t hotness_decay_period_ms_;
   bool dump_info_on_shutdown_;
   int thread_pool_pthread_priority_;
   int zygote_thread_pool_pthread_priority_;
+  size_t thread_pool_size_;
   ProfileSaverOptions profile_saver_options_;
 
   JitOptions()
       : use_jit_compilation_(false),
         use_profiled_jit_compilation_(false),
+        precompile_app_profile_(false),
+        osr_at_first_compile_(false),
         use_baseline_compiler_(false),
         code_cache_initial_capacity_(0),
         code_cache_max_capacity_(0),
         optimize_threshold_(0),
         warmup_threshold_(0),
+        mid_tier_min_code_units_(0),
+        mid_tier_optimize_threshold_(0),
         priority_thread_weight_(0),
         invoke_transition_weight_(0),
+        hotness_decay_period_ms_(0),
         dump_info_on_shutdown_(false),
         thread_pool_pthread_priority_(kJitPoolThreadPthreadDefaultPriority),
-        zygote_thread_pool_pthread_priority_(kJitZygotePoolThreadPthreadDefaultPriority) {}
+        zygote_thread_pool_pthread_priority_(kJitZygotePoolThreadPthreadDefaultPriority),
+        thread_pool_size_(kJitDefaultThreadPoolSize) {}
 
   DISALLOW_COPY_AND_ASSIGN(JitOptions);
 };
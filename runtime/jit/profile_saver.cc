@@ -37,11 +37,14 @@
 #include "dex_reference_collection.h"
 #include "gc/collector_type.h"
 #include "gc/gc_cause.h"
+#include "gc/scoped_gc_critical_section.h"
 #include "jit/jit.h"
 #include "jit/profiling_info.h"
 #include "oat/oat_file_manager.h"
 #include "profile/profile_compilation_info.h"
 #include "scoped_thread_state_change-inl.h"
+#include "stack.h"
+#include "thread_list.h"
 
 namespace art HIDDEN {
 
@@ -49,6 +52,7 @@ using Hotness = ProfileCompilationInfo::MethodHotness;
 
 ProfileSaver* ProfileSaver::instance_ = nullptr;
 pthread_t ProfileSaver::profiler_pthread_ = 0U;
+pthread_t ProfileSaver::sampling_pthread_ = 0U;
 
 static_assert(ProfileCompilationInfo::kIndividualInlineCacheSize ==
               InlineCache::kIndividualCacheSize,
@@ -69,6 +73,18 @@ static void SetProfileSaverThreadPriority(pthread_t thread, int priority) {
 #endif
 }
 
+void ProfileSaver::SetCpuAffinity(const cpu_set_t& cpus) {
+#if defined(ART_TARGET_ANDROID)
+  MutexLock mu(Thread::Current(), *Locks::profiler_lock_);
+  if (instance_ != nullptr &&
+      sched_setaffinity(pthread_gettid_np(profiler_pthread_), sizeof(cpus), &cpus) != 0) {
+    PLOG(WARNING) << "Failed to set the CPU affinity of the profile saver";
+  }
+#else
+  UNUSED(cpus);
+#endif
+}
+
 static int GetDefaultThreadPriority() {
 #if defined(ART_TARGET_ANDROID)
   pthread_attr_t attr;
@@ -92,6 +108,8 @@ ProfileSaver::ProfileSaver(const ProfileSaverOptions& options, jit::JitCodeCache
       total_number_of_writes_(0),
       total_number_of_code_cache_queries_(0),
       total_number_of_skipped_writes_(0),
+      total_number_of_skipped_loads_(0),
+      total_number_of_samples_(0),
       total_number_of_failed_writes_(0),
       total_ms_of_sleep_(0),
       total_ns_of_work_(0),
@@ -780,6 +798,16 @@ void ProfileSaver::FetchAndCacheResolvedClassesAndMethods(bool startup) {
                  << " sampled methods in " << PrettyDuration(NanoTime() - start_time);
 }
 
+std::optional<ProfileSaver::FileIdentity> ProfileSaver::GetFileIdentity(
+    const std::string& filename) {
+  struct stat st;
+  if (stat(filename.c_str(), &st) != 0) {
+    return std::nullopt;
+  }
+  int64_t mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1'000'000'000 + st.st_mtim.tv_nsec;
+  return FileIdentity{st.st_dev, st.st_ino, st.st_size, mtime_ns};
+}
+
 bool ProfileSaver::ProcessProfilingInfo(
         bool force_save,
         bool skip_class_and_method_fetching,
@@ -828,20 +856,43 @@ bool ProfileSaver::ProcessProfilingInfo(
       total_number_of_code_cache_queries_++;
     }
     {
-      ProfileCompilationInfo info(Runtime::Current()->GetArenaPool(),
-                                  /*for_boot_image=*/options_.GetProfileBootClassPath());
-      // Load the existing profile before saving.
+      // Reuse the data we last wrote to the file if nobody else modified it since. Otherwise,
+      // load the existing profile before saving.
       // If the file is updated between `Load` and `Save`, the update will be lost. This is
       // acceptable. The main reason is that the lost entries will eventually come back if the user
       // keeps using the same methods, or they won't be needed if the user doesn't use the same
       // methods again.
-      if (!info.Load(filename, /*clear_if_invalid=*/true)) {
-        LOG(WARNING) << "Could not forcefully load profile " << filename;
-        continue;
+      SavedProfile saved;
+      {
+        MutexLock mu(Thread::Current(), *Locks::profiler_lock_);
+        auto saved_it = saved_profiles_.find(filename);
+        if (saved_it != saved_profiles_.end()) {
+          // Take ownership, so that a concurrent `ProcessProfilingInfo()` loads the file.
+          saved = std::move(saved_it->second);
+          saved_profiles_.erase(saved_it);
+        }
+      }
+      // Get the identity before loading, so that a concurrent update is noticed next time.
+      std::optional<FileIdentity> file_identity = GetFileIdentity(filename);
+      std::unique_ptr<ProfileCompilationInfo> info;
+      uint64_t last_save_number_of_methods;
+      uint64_t last_save_number_of_classes;
+      if (saved.info != nullptr && file_identity == saved.file_identity) {
+        info = std::move(saved.info);
+        last_save_number_of_methods = saved.number_of_methods;
+        last_save_number_of_classes = saved.number_of_classes;
+        total_number_of_skipped_loads_++;
+      } else {
+        info = std::make_unique<ProfileCompilationInfo>(
+            Runtime::Current()->GetArenaPool(),
+            /*for_boot_image=*/options_.GetProfileBootClassPath());
+        if (!info->Load(filename, /*clear_if_invalid=*/true)) {
+          LOG(WARNING) << "Could not forcefully load profile " << filename;
+          continue;
+        }
+        last_save_number_of_methods = info->GetNumberOfMethods();
+        last_save_number_of_classes = info->GetNumberOfResolvedClasses();
       }
-
-      uint64_t last_save_number_of_methods = info.GetNumberOfMethods();
-      uint64_t last_save_number_of_classes = info.GetNumberOfResolvedClasses();
       VLOG(profiler) << "last_save_number_of_methods=" << last_save_number_of_methods
                      << " last_save_number_of_classes=" << last_save_number_of_classes
                      << " number of profiled methods=" << profile_methods.size();
@@ -849,13 +900,13 @@ bool ProfileSaver::ProcessProfilingInfo(
       // Try to add the method data. Note this may fail is the profile loaded from disk contains
       // outdated data (e.g. the previous profiled dex files might have been updated).
       // If this happens we clear the profile data and for the save to ensure the file is cleared.
-      if (!info.AddMethods(
+      if (!info->AddMethods(
               profile_methods,
               AnnotateSampleFlags(Hotness::kFlagHot | Hotness::kFlagPostStartup),
               GetProfileSampleAnnotation())) {
         LOG(WARNING) << "Could not add methods to the existing profiler. "
             << "Clearing the profile data.";
-        info.ClearData();
+        info->ClearData();
         force_save = true;
       }
 
@@ -863,9 +914,9 @@ bool ProfileSaver::ProcessProfilingInfo(
         MutexLock mu(Thread::Current(), *Locks::profiler_lock_);
         auto profile_cache_it = profile_cache_.find(filename);
         if (profile_cache_it != profile_cache_.end()) {
-          if (!info.MergeWith(*(profile_cache_it->second))) {
+          if (!info->MergeWith(*(profile_cache_it->second))) {
             LOG(WARNING) << "Could not merge the profile. Clearing the profile data.";
-            info.ClearData();
+            info->ClearData();
             force_save = true;
           }
         } else if (VLOG_IS_ON(profiler)) {
@@ -876,9 +927,9 @@ bool ProfileSaver::ProcessProfilingInfo(
         }
 
         int64_t delta_number_of_methods =
-            info.GetNumberOfMethods() - last_save_number_of_methods;
+            info->GetNumberOfMethods() - last_save_number_of_methods;
         int64_t delta_number_of_classes =
-            info.GetNumberOfResolvedClasses() - last_save_number_of_classes;
+            info->GetNumberOfResolvedClasses() - last_save_number_of_classes;
 
         if (!force_save &&
             delta_number_of_methods < options_.GetMinMethodsToSave() &&
@@ -887,6 +938,15 @@ bool ProfileSaver::ProcessProfilingInfo(
                         << " Number of methods: " << delta_number_of_methods
                         << " Number of classes: " << delta_number_of_classes;
           total_number_of_skipped_writes_++;
+          if (file_identity.has_value()) {
+            // Keep the data, including what was not written yet, for the next attempt.
+            saved_profiles_.erase(filename);
+            saved_profiles_.Put(filename,
+                                SavedProfile{std::move(info),
+                                             last_save_number_of_methods,
+                                             last_save_number_of_classes,
+                                             *file_identity});
+          }
           continue;
         }
 
@@ -898,13 +958,24 @@ bool ProfileSaver::ProcessProfilingInfo(
         uint64_t bytes_written;
         // Force the save. In case the profile data is corrupted or the profile
         // has the wrong version this will "fix" the file to the correct format.
-        if (info.Save(filename, &bytes_written)) {
+        if (info->Save(filename, &bytes_written)) {
           // We managed to save the profile. Clear the cache stored during startup.
           if (profile_cache_it != profile_cache_.end()) {
             ProfileCompilationInfo *cached_info = profile_cache_it->second;
             profile_cache_.erase(profile_cache_it);
             delete cached_info;
           }
+          file_identity = GetFileIdentity(filename);
+          if (file_identity.has_value()) {
+            uint64_t number_of_methods = info->GetNumberOfMethods();
+            uint64_t number_of_classes = info->GetNumberOfResolvedClasses();
+            saved_profiles_.erase(filename);
+            saved_profiles_.Put(filename,
+                                SavedProfile{std::move(info),
+                                             number_of_methods,
+                                             number_of_classes,
+                                             *file_identity});
+          }
           if (bytes_written > 0) {
             total_number_of_writes_++;
             total_bytes_written_ += bytes_written;
@@ -954,6 +1025,78 @@ void* ProfileSaver::RunProfileSaverThread(void* arg) {
   return nullptr;
 }
 
+void* ProfileSaver::RunSamplingThread(void* arg) {
+  Runtime* runtime = Runtime::Current();
+
+  bool attached = runtime->AttachCurrentThread("Profile Sampler",
+                                               /*as_daemon=*/true,
+                                               runtime->GetSystemThreadGroup(),
+                                               /*create_peer=*/true);
+  if (!attached) {
+    CHECK(runtime->IsShuttingDown(Thread::Current()));
+    return nullptr;
+  }
+
+  // The saver is deleted only after `Stop()` joins this thread.
+  ProfileSaver* saver = reinterpret_cast<ProfileSaver*>(arg);
+  Thread* self = Thread::Current();
+  const uint32_t interval_ms = saver->options_.GetSamplingIntervalMs();
+  while (!saver->ShuttingDown(self)) {
+    usleep(MsToUs(interval_ms));
+    if (saver->ShuttingDown(self)) {
+      break;
+    }
+    saver->SampleThreads(self);
+  }
+
+  runtime->DetachCurrentThread();
+  VLOG(profiler) << "Profile sampler shutdown";
+  return nullptr;
+}
+
+void ProfileSaver::SampleThreads(Thread* self) {
+  ScopedTrace trace(__FUNCTION__);
+  const bool profile_boot_class_path = options_.GetProfileBootClassPath();
+  size_t number_of_samples = 0u;
+  {
+    // Block GC while walking the stacks, like the sampling in `Trace`.
+    gc::ScopedGCCriticalSection gcs(self,
+                                    gc::kGcCauseInstrumentation,
+                                    gc::kCollectorTypeInstrumentation);
+    ScopedSuspendAll ssa(__FUNCTION__);
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    // The compiler gets confused on the thread annotations, so use NO_THREAD_SAFETY_ANALYSIS.
+    // Note that we hold the mutator lock exclusively at this point.
+    Locks::mutator_lock_->AssertExclusiveHeld(self);
+    Runtime::Current()->GetThreadList()->ForEach([&](Thread* thread) NO_THREAD_SAFETY_ANALYSIS {
+      // Threads that were running Java code are in `kSuspended` after `SuspendAll()`.
+      // Threads in native code, waiting or blocked are not using CPU for Java code.
+      if (thread == self || thread->GetState() != ThreadState::kSuspended) {
+        return;
+      }
+      StackVisitor::WalkStack(
+          [&](const StackVisitor* stack_visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
+            ArtMethod* method = stack_visitor->GetMethod();
+            if (method->IsRuntimeMethod()) {
+              return true;  // Continue to the innermost Java frame.
+            }
+            // Do not dirty boot image methods unless we profile the boot class path.
+            if (!method->IsNative() &&
+                (profile_boot_class_path ||
+                 !method->GetDeclaringClass()->IsBootStrapClassLoaded())) {
+              method->SetPreviouslyWarm();
+              ++number_of_samples;
+            }
+            return false;
+          },
+          thread,
+          /*context=*/ nullptr,
+          StackVisitor::StackWalkKind::kIncludeInlinedFrames);
+    });
+  }
+  total_number_of_samples_ += number_of_samples;
+}
+
 static bool ShouldProfileLocation(const std::string& location, bool profile_aot_code) {
   if (profile_aot_code) {
     // If we have to profile all the code, irrespective of its compilation state, return true
@@ -1055,17 +1198,27 @@ void  ProfileSaver::Start(const ProfileSaverOptions& options,
       "Profile saver thread");
 
   SetProfileSaverThreadPriority(profiler_pthread_, kProfileSaverPthreadPriority);
+
+  if (options.GetSamplingIntervalMs() != 0u) {
+    CHECK_PTHREAD_CALL(
+        pthread_create,
+        (&sampling_pthread_, nullptr, &RunSamplingThread, reinterpret_cast<void*>(instance_)),
+        "Profile sampling thread");
+    SetProfileSaverThreadPriority(sampling_pthread_, kProfileSaverPthreadPriority);
+  }
 }
 
 void ProfileSaver::Stop(bool dump_info) {
   ProfileSaver* profile_saver = nullptr;
   pthread_t profiler_pthread = 0U;
+  pthread_t sampling_pthread = 0U;
 
   {
     MutexLock profiler_mutex(Thread::Current(), *Locks::profiler_lock_);
     VLOG(profiler) << "Stopping profile saver thread";
     profile_saver = instance_;
     profiler_pthread = profiler_pthread_;
+    sampling_pthread = sampling_pthread_;
     if (instance_ == nullptr) {
       DCHECK(false) << "Tried to stop a profile saver which was not started";
       return;
@@ -1092,6 +1245,10 @@ void ProfileSaver::Stop(bool dump_info) {
 
   // Wait for the saver thread to stop.
   CHECK_PTHREAD_CALL(pthread_join, (profiler_pthread, nullptr), "profile saver thread shutdown");
+  if (sampling_pthread != 0U) {
+    CHECK_PTHREAD_CALL(
+        pthread_join, (sampling_pthread, nullptr), "profile sampling thread shutdown");
+  }
 
   {
     MutexLock profiler_mutex(Thread::Current(), *Locks::profiler_lock_);
@@ -1100,6 +1257,7 @@ void ProfileSaver::Stop(bool dump_info) {
     }
     instance_ = nullptr;
     profiler_pthread_ = 0U;
+    sampling_pthread_ = 0U;
   }
   delete profile_saver;
 }
@@ -1189,6 +1347,8 @@ void ProfileSaver::DumpInfo(std::ostream& os) {
      << "ProfileSaver total_number_of_code_cache_queries="
      << total_number_of_code_cache_queries_ << '\n'
      << "ProfileSaver total_number_of_skipped_writes=" << total_number_of_skipped_writes_ << '\n'
+     << "ProfileSaver total_number_of_skipped_loads=" << total_number_of_skipped_loads_ << '\n'
+     << "ProfileSaver total_number_of_samples=" << total_number_of_samples_ << '\n'
      << "ProfileSaver total_number_of_failed_writes=" << total_number_of_failed_writes_ << '\n'
      << "ProfileSaver total_ms_of_sleep=" << total_ms_of_sleep_ << '\n'
      << "ProfileSaver total_ms_of_work=" << NsToMs(total_ns_of_work_) << '\n'
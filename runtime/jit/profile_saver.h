@@ -17,6 +17,11 @@
 #ifndef ART_RUNTIME_JIT_PROFILE_SAVER_H_
 #define ART_RUNTIME_JIT_PROFILE_SAVER_H_
 
+#include <sched.h>
+#include <sys/types.h>
+
+#include <optional>
+
 #include "base/mutex.h"
 #include "base/safe_map.h"
 #include "dex/method_reference.h"
@@ -58,6 +63,9 @@ class ProfileSaver {
   // Notify that startup has completed.
   static void NotifyStartupCompleted() REQUIRES(!Locks::profiler_lock_, !instance_->wait_lock_);
 
+  // Sets the CPUs the profile saver thread may run on, if it is running.
+  static void SetCpuAffinity(const cpu_set_t& cpus) REQUIRES(!Locks::profiler_lock_);
+
  private:
   // Helper classes for collecting classes and methods.
   class GetClassesAndMethodsHelper;
@@ -69,6 +77,15 @@ class ProfileSaver {
   static void* RunProfileSaverThread(void* arg)
       REQUIRES(!Locks::profiler_lock_, !instance_->wait_lock_);
 
+  // Entry point of the sampling thread, see `SampleThreads()`.
+  static void* RunSamplingThread(void* arg) REQUIRES(!Locks::profiler_lock_);
+
+  // Mark the innermost Java method of each thread that is running Java code as warm, so that
+  // the next profile save records it as hot. This catches hot methods that do not update
+  // their hotness counter, for example AOT-compiled code.
+  void SampleThreads(Thread* self)
+      REQUIRES(!Locks::mutator_lock_, !Locks::thread_list_lock_, !Locks::profiler_lock_);
+
   // The run loop for the saver.
   void Run()
       REQUIRES(Locks::profiler_lock_, !wait_lock_)
@@ -122,6 +139,8 @@ class ProfileSaver {
   static ProfileSaver* instance_ GUARDED_BY(Locks::profiler_lock_);
   // Profile saver thread.
   static pthread_t profiler_pthread_ GUARDED_BY(Locks::profiler_lock_);
+  // Sampling thread, 0 if sampling is disabled.
+  static pthread_t sampling_pthread_ GUARDED_BY(Locks::profiler_lock_);
 
   jit::JitCodeCache* jit_code_cache_;
 
@@ -154,6 +173,31 @@ class ProfileSaver {
   // to just a few hundreds entries in the ProfileCompilationInfo objects.
   SafeMap<std::string, ProfileCompilationInfo*> profile_cache_ GUARDED_BY(Locks::profiler_lock_);
 
+  // The profile data as last written by this process to a tracked file, together with
+  // the identity of the file right after the write. If the file is unchanged at the next
+  // `ProcessProfilingInfo()`, the data is reused instead of loading the file again.
+  struct FileIdentity {
+    dev_t dev;
+    ino_t ino;
+    off_t size;
+    int64_t mtime_ns;
+
+    bool operator==(const FileIdentity& other) const {
+      return dev == other.dev && ino == other.ino && size == other.size &&
+             mtime_ns == other.mtime_ns;
+    }
+  };
+  struct SavedProfile {
+    std::unique_ptr<ProfileCompilationInfo> info;
+    uint64_t number_of_methods;  // Number of methods in the file.
+    uint64_t number_of_classes;  // Number of classes in the file.
+    FileIdentity file_identity;
+  };
+
+  // Get the identity of the file at `filename` for checking whether it was modified.
+  static std::optional<FileIdentity> GetFileIdentity(const std::string& filename);
+  SafeMap<std::string, SavedProfile> saved_profiles_ GUARDED_BY(Locks::profiler_lock_);
+
   // Whether or not this is the first ever profile save.
   // Note this is an approximation and is not 100% precise. It relies on checking
   // whether or not the profiles are empty which is not a precise indication
@@ -168,6 +212,8 @@ class ProfileSaver {
   uint64_t total_number_of_writes_;
   uint64_t total_number_of_code_cache_queries_;
   uint64_t total_number_of_skipped_writes_;
+  uint64_t total_number_of_skipped_loads_;
+  uint64_t total_number_of_samples_;
   uint64_t total_number_of_failed_writes_;
   uint64_t total_ms_of_sleep_;
   uint64_t total_ns_of_work_;
@@ -45,7 +45,8 @@ struct ProfileSaverOptions {
     profile_path_(""),
     profile_boot_class_path_(false),
     profile_aot_code_(false),
-    wait_for_jit_notifications_to_save_(true) {}
+    wait_for_jit_notifications_to_save_(true),
+    sampling_interval_ms_(0) {}
 
   ProfileSaverOptions(
       bool enabled,
@@ -73,7 +74,8 @@ struct ProfileSaverOptions {
     profile_path_(profile_path),
     profile_boot_class_path_(profile_boot_class_path),
     profile_aot_code_(profile_aot_code),
-    wait_for_jit_notifications_to_save_(wait_for_jit_notifications_to_save) {}
+    wait_for_jit_notifications_to_save_(wait_for_jit_notifications_to_save),
+    sampling_interval_ms_(0) {}
 
   bool IsEnabled() const {
     return enabled_;
@@ -121,6 +123,13 @@ struct ProfileSaverOptions {
   void SetWaitForJitNotificationsToSave(bool value) {
     wait_for_jit_notifications_to_save_ = value;
   }
+  // Interval between samples of the innermost Java frame of running threads, 0 if disabled.
+  uint32_t GetSamplingIntervalMs() const {
+    return sampling_interval_ms_;
+  }
+  void SetSamplingIntervalMs(uint32_t value) {
+    sampling_interval_ms_ = value;
+  }
 
   friend std::ostream & operator<<(std::ostream &os, const ProfileSaverOptions& pso) {
     os << "enabled_" << pso.enabled_
@@ -134,7 +143,8 @@ struct ProfileSaverOptions {
         << ", inline_cache_threshold_" << pso.inline_cache_threshold_
         << ", profile_boot_class_path_" << pso.profile_boot_class_path_
         << ", profile_aot_code_" << pso.profile_aot_code_
-        << ", wait_for_jit_notifications_to_save_" << pso.wait_for_jit_notifications_to_save_;
+        << ", wait_for_jit_notifications_to_save_" << pso.wait_for_jit_notifications_to_save_
+        << ", sampling_interval_ms_" << pso.sampling_interval_ms_;
     return os;
   }
 
@@ -151,6 +161,7 @@ struct ProfileSaverOptions {
   bool profile_boot_class_path_;
   bool profile_aot_code_;
   bool wait_for_jit_notifications_to_save_;
+  uint32_t sampling_interval_ms_;
 };
 
 }  // namespace art
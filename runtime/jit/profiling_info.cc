@@ -32,7 +32,8 @@ ProfilingInfo::ProfilingInfo(ArtMethod* method,
         method_(method),
         number_of_inline_caches_(inline_cache_entries.size()),
         number_of_branch_caches_(branch_cache_entries.size()),
-        current_inline_uses_(0) {
+        current_inline_uses_(0),
+        mid_tier_compiled_(false) {
   InlineCache* inline_caches = GetInlineCaches();
   memset(inline_caches, 0, number_of_inline_caches_ * sizeof(InlineCache));
   for (size_t i = 0; i < number_of_inline_caches_; ++i) {
@@ -121,7 +122,8 @@ void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
     mirror::Class* existing = cache->classes_[i].Read<kWithoutReadBarrier>();
     mirror::Class* marked = ReadBarrier::IsMarked(existing);
     if (marked == cls) {
-      // Receiver type is already in the cache, nothing else to do.
+      // Receiver type is already in the cache, just count the call.
+      ++cache->counts_[i];
       return;
     } else if (marked == nullptr) {
       // Cache entry is empty, try to put `cls` in it.
@@ -136,7 +138,8 @@ void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
         // entry in case the entry contains `cls`.
         --i;
       } else {
-        // We successfully set `cls`, just return.
+        // We successfully set `cls`, just count the call.
+        ++cache->counts_[i];
         return;
       }
     }
@@ -42,6 +42,10 @@ class Class;
 
 // Structure to store the classes seen at runtime for a specific instruction.
 // Once the classes_ array is full, we consider the INVOKE to be megamorphic.
+// The counts_ array holds the number of calls seen for each class. The last count of a
+// megamorphic cache is for all the classes that did not fit. The counts are updated without
+// synchronization, and baseline code only updates them on arm64 and x86-64, so they are only
+// a hint.
 class InlineCache {
  public:
   // This is hard coded in the assembly stub art_quick_update_inline_cache.
@@ -51,6 +55,10 @@ class InlineCache {
     return MemberOffset(OFFSETOF_MEMBER(InlineCache, classes_));
   }
 
+  static constexpr MemberOffset CountsOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(InlineCache, counts_));
+  }
+
   // Encode the list of `dex_pcs` to fit into an uint32_t.
   static uint32_t EncodeDexPc(ArtMethod* method,
                               const std::vector<uint32_t>& dex_pcs,
@@ -66,6 +74,7 @@ class InlineCache {
  private:
   uint32_t dex_pc_;
   GcRoot<mirror::Class> classes_[kIndividualCacheSize];
+  uint32_t counts_[kIndividualCacheSize];
 
   friend class jit::JitCodeCache;
   friend class ProfilingInfo;
@@ -175,6 +184,17 @@ class ProfilingInfo {
     return baseline_hotness_count_;
   }
 
+  bool IsMidTierCompiled() const {
+    return mid_tier_compiled_;
+  }
+
+  // Called once mid tier code is installed. That code counts hotness like baseline code,
+  // starting from `threshold`, and then requests the optimized compile.
+  void SetMidTierCompiled(uint16_t threshold) {
+    mid_tier_compiled_ = true;
+    baseline_hotness_count_ = threshold;
+  }
+
   static uint16_t GetOptimizeThreshold();
 
  private:
@@ -202,6 +222,10 @@ class ProfilingInfo {
   // it updates this counter so that the GC does not try to clear the inline caches.
   uint16_t current_inline_uses_;
 
+  // Whether the method has been compiled with the mid tier, see
+  // JitOptions::GetMidTierMinCodeUnits().
+  bool mid_tier_compiled_;
+
   // Memory following the object:
   // - Dynamically allocated array of `InlineCache` of size `number_of_inline_caches_`.
   // - Dynamically allocated array of `BranchCache of size `number_of_branch_caches_`.
@@ -20,6 +20,8 @@
 
 #include <cstdarg>
 #include <memory>
+#include <string_view>
+#include <unordered_map>
 #include <utility>
 
 #include "art_field-inl.h"
@@ -171,7 +173,17 @@ class NewStringUTFVisitor {
     ObjPtr<mirror::String> string = ObjPtr<mirror::String>::DownCast(obj);
     string->SetCount(count_);
     DCHECK_IMPLIES(string->IsCompressed(), mirror::kUseStringCompression);
-    if (string->IsCompressed()) {
+    if (!has_bad_char_ && utf8_length_ == static_cast<size_t>(string->GetLength())) {
+      // Without bad characters, only an all-ASCII input has one character per byte.
+      if (string->IsCompressed()) {
+        memcpy(string->GetValueCompressed(), utf_, utf8_length_);
+      } else {
+        uint16_t* value = string->GetValue();
+        for (size_t i = 0; i != utf8_length_; ++i) {
+          value[i] = static_cast<uint8_t>(utf_[i]);
+        }
+      }
+    } else if (string->IsCompressed()) {
       uint8_t* value_compressed = string->GetValueCompressed();
       auto good = [&](const char* ptr, size_t length) {
         uint16_t c = DecodeModifiedUtf8Character(ptr, length);
@@ -657,6 +669,35 @@ static ArtMethod* FindMethod(ObjPtr<mirror::Class> c,
   return nullptr;
 }
 
+// Methods of a class by name, built once per `RegisterNatives()` call with many methods to
+// avoid a linear `FindMethod()` search for each registered method.
+using MethodNameIndex = std::unordered_multimap<std::string_view, ArtMethod*>;
+
+// Finds the method in the index, preferring a native one like the `FindMethod<true>()` then
+// `FindMethod<false>()` sequence does.
+static ArtMethod* FindMethod(const MethodNameIndex& index,
+                             std::string_view name,
+                             std::string_view sig)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ArtMethod* non_native_method = nullptr;
+  auto range = index.equal_range(name);
+  for (auto it = range.first; it != range.second; ++it) {
+    ArtMethod* method = it->second;
+    if (method->GetSignature() == sig) {
+      if (method->IsNative()) {
+        return method;
+      }
+      if (non_native_method == nullptr) {
+        non_native_method = method;
+      }
+    }
+  }
+  return non_native_method;
+}
+
+// Minimum number of methods in a `RegisterNatives()` call to build a `MethodNameIndex`.
+static constexpr jint kMinRegisterNativesForIndex = 4;
+
 template <bool kEnableIndexIds>
 class JNI {
  public:
@@ -2000,33 +2041,40 @@ class JNI {
     size_t utf8_length = strlen(utf);
     bool compressible = mirror::kUseStringCompression;
     bool has_bad_char = false;
-    size_t utf16_length = VisitUtf8Chars(
-        utf,
-        utf8_length,
-        /*good=*/ [&compressible](const char* ptr, size_t length) {
-          if (mirror::kUseStringCompression) {
-            switch (length) {
-              case 1:
-                DCHECK(mirror::String::IsASCII(*ptr));
-                break;
-              case 2:
-              case 3:
-                if (!mirror::String::IsASCII(DecodeModifiedUtf8Character(ptr, length))) {
+    // Fast path for the common all-ASCII input: each byte is one character and there is
+    // nothing to validate.
+    size_t utf16_length;
+    if (IsAsciiUtf8(utf, utf8_length)) {
+      utf16_length = utf8_length;
+    } else {
+      utf16_length = VisitUtf8Chars(
+          utf,
+          utf8_length,
+          /*good=*/ [&compressible](const char* ptr, size_t length) {
+            if (mirror::kUseStringCompression) {
+              switch (length) {
+                case 1:
+                  DCHECK(mirror::String::IsASCII(*ptr));
+                  break;
+                case 2:
+                case 3:
+                  if (!mirror::String::IsASCII(DecodeModifiedUtf8Character(ptr, length))) {
+                    compressible = false;
+                  }
+                  break;
+                default:
+                  // 4-byte sequences lead to uncompressible surroate pairs.
+                  DCHECK_EQ(length, 4u);
                   compressible = false;
-                }
-                break;
-              default:
-                // 4-byte sequences lead to uncompressible surroate pairs.
-                DCHECK_EQ(length, 4u);
-                compressible = false;
-                break;
+                  break;
+              }
             }
-          }
-        },
-        /*bad=*/ [&has_bad_char]() {
-          static_assert(mirror::String::IsASCII(kBadUtf8ReplacementChar));  // Compressible.
-          has_bad_char = true;
-        });
+          },
+          /*bad=*/ [&has_bad_char]() {
+            static_assert(mirror::String::IsASCII(kBadUtf8ReplacementChar));  // Compressible.
+            has_bad_char = true;
+          });
+    }
     if (UNLIKELY(utf16_length > static_cast<uint32_t>(std::numeric_limits<int32_t>::max()))) {
       // Converting the utf16_length to int32_t would overflow. Explicitly throw an OOME.
       std::string error =
@@ -2232,10 +2280,8 @@ class JNI {
     char* bytes = new char[byte_count + 1];
     CHECK(bytes != nullptr);  // bionic aborts anyway.
     if (s->IsCompressed()) {
-      const uint8_t* src = s->GetValueCompressed();
-      for (size_t i = 0; i < byte_count; ++i) {
-        bytes[i] = src[i];
-      }
+      // Compressed strings hold ASCII characters 1-127 only, so they are valid UTF-8 as is.
+      memcpy(bytes, s->GetValueCompressed(), byte_count);
     } else {
       char* end = GetUncompressedStringUTFChars(s->GetValue(), length, bytes);
       DCHECK_EQ(byte_count, static_cast<size_t>(end - bytes));
@@ -2369,7 +2415,8 @@ class JNI {
       return nullptr;
     }
     gc::Heap* heap = Runtime::Current()->GetHeap();
-    if (heap->IsMovableObject(array)) {
+    // Prefer pinning the array, which lets the GC proceed around it.
+    if (heap->IsMovableObject(array) && !heap->TryPinObject(array)) {
       if (!gUseReadBarrier && !gUseUserfaultfd) {
         heap->IncrementDisableMovingGC(soa.Self());
       } else {
@@ -2582,6 +2629,14 @@ class JNI {
         IsClassLoaderNamespaceNativelyBridged(soa, c->GetClassLoader());
 
     CHECK_NON_NULL_ARGUMENT_FN_NAME("RegisterNatives", methods, JNI_ERR);
+    MethodNameIndex method_index;
+    if (method_count >= kMinRegisterNativesForIndex) {
+      PointerSize pointer_size = class_linker->GetImagePointerSize();
+      method_index.reserve(c->NumMethods());
+      for (ArtMethod& method : c->GetMethods(pointer_size)) {
+        method_index.emplace(method.GetNameView(), &method);
+      }
+    }
     for (jint i = 0; i < method_count; ++i) {
       const char* name = methods[i].name;
       const char* sig = methods[i].signature;
@@ -2639,16 +2694,23 @@ class JNI {
       for (ObjPtr<mirror::Class> current_class = c.Get();
            current_class != nullptr;
            current_class = current_class->GetSuperClass()) {
-        // Search first only comparing methods which are native.
-        m = FindMethod<true>(current_class, name, sig);
-        if (m != nullptr) {
-          break;
-        }
+        if (current_class == c.Get() && !method_index.empty()) {
+          m = FindMethod(method_index, name, sig);
+          if (m != nullptr) {
+            break;
+          }
+        } else {
+          // Search first only comparing methods which are native.
+          m = FindMethod<true>(current_class, name, sig);
+          if (m != nullptr) {
+            break;
+          }
 
-        // Search again comparing to all methods, to find non-native methods that match.
-        m = FindMethod<false>(current_class, name, sig);
-        if (m != nullptr) {
-          break;
+          // Search again comparing to all methods, to find non-native methods that match.
+          m = FindMethod<false>(current_class, name, sig);
+          if (m != nullptr) {
+            break;
+          }
         }
 
         if (warn_on_going_to_parent) {
@@ -3014,8 +3076,8 @@ class JNI {
     if (mode != JNI_COMMIT) {
       if (is_copy) {
         delete[] reinterpret_cast<uint64_t*>(elements);
-      } else if (heap->IsMovableObject(array)) {
-        // Non copy to a movable object must means that we had disabled the moving GC.
+      } else if (heap->IsMovableObject(array) && !heap->UnpinObject(array)) {
+        // Non copy to an unpinned movable object must means that we had disabled the moving GC.
         if (!gUseReadBarrier && !gUseUserfaultfd) {
           heap->DecrementDisableMovingGC(soa.Self());
         } else {
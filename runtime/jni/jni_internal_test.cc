@@ -1076,6 +1076,19 @@ TEST_F(JniInternalTest, RegisterAndUnregisterNatives) {
       EXPECT_EQ(env_->RegisterNatives(jlobject, methods, 1), JNI_ERR);
     }
     ExpectException(jlnsme);
+
+    // Same, in a batch large enough to look methods up by name.
+    {
+      JNINativeMethod methods[] = {
+          { "notify", "()V", native_function },
+          { "notifyAll", "()V", native_function },
+          { "internalClone", "()Ljava/lang/Object;", native_function },
+          { "equals", "(Ljava/lang/Object;)Z", native_function },
+      };
+      EXPECT_EQ(env_->RegisterNatives(jlobject, methods, arraysize(methods)), JNI_ERR);
+    }
+    ExpectException(jlnsme);
+    EXPECT_EQ(env_->UnregisterNatives(jlobject), JNI_OK);
   }
 
   // Check that registering native methods is successful.
@@ -1086,6 +1099,19 @@ TEST_F(JniInternalTest, RegisterAndUnregisterNatives) {
   EXPECT_FALSE(env_->ExceptionCheck());
   EXPECT_EQ(env_->UnregisterNatives(jlobject), JNI_OK);
 
+  // Check that registering a batch of native methods is successful.
+  {
+    JNINativeMethod methods[] = {
+        { "notify", "()V", native_function },
+        { "notifyAll", "()V", native_function },
+        { "wait", "(JI)V", native_function },
+        { "internalClone", "()Ljava/lang/Object;", native_function },
+    };
+    EXPECT_EQ(env_->RegisterNatives(jlobject, methods, arraysize(methods)), JNI_OK);
+  }
+  EXPECT_FALSE(env_->ExceptionCheck());
+  EXPECT_EQ(env_->UnregisterNatives(jlobject), JNI_OK);
+
   // Check that registering no methods isn't a failure.
   {
     JNINativeMethod methods[] = { };
@@ -65,32 +65,46 @@ inline size_t SmallLrtAllocator::GetIndex(size_t size) {
 
 LrtEntry* SmallLrtAllocator::Allocate(size_t size, std::string* error_msg) {
   size_t index = GetIndex(size);
-  MutexLock lock(Thread::Current(), lock_);
-  size_t fill_from = index;
-  while (fill_from != num_lrt_slots_ && free_lists_[fill_from] == nullptr) {
-    ++fill_from;
-  }
+  Thread* self = Thread::Current();
+  // Keep the critical section short: threads that create and grow their local reference tables
+  // concurrently all go through this lock. The page is mapped, and the result is cleared, without
+  // holding it.
+  MemMap new_map;
   void* result = nullptr;
-  if (fill_from != num_lrt_slots_) {
-    // We found a slot with enough memory.
-    result = free_lists_[fill_from];
-    free_lists_[fill_from] = *reinterpret_cast<void**>(result);
-  } else {
-    // We need to allocate a new page and split it into smaller pieces.
-    MemMap map = NewLRTMap(gPageSize, error_msg);
-    if (!map.IsValid()) {
+  while (true) {
+    {
+      MutexLock lock(self, lock_);
+      size_t fill_from = index;
+      while (fill_from != num_lrt_slots_ && free_lists_[fill_from] == nullptr) {
+        ++fill_from;
+      }
+      if (fill_from != num_lrt_slots_) {
+        // We found a slot with enough memory. If we have mapped a new page meanwhile, it is
+        // unmapped when `new_map` goes out of scope, after releasing the lock.
+        result = free_lists_[fill_from];
+        free_lists_[fill_from] = *reinterpret_cast<void**>(result);
+      } else if (new_map.IsValid()) {
+        // Use the new page and split it into smaller pieces.
+        result = new_map.Begin();
+        shared_lrt_maps_.emplace_back(std::move(new_map));
+      }
+      if (result != nullptr) {
+        while (fill_from != index) {
+          --fill_from;
+          // Store the second half of the current buffer in appropriate free list slot.
+          void* mid = reinterpret_cast<uint8_t*>(result) + (kInitialLrtBytes << fill_from);
+          DCHECK(free_lists_[fill_from] == nullptr);
+          *reinterpret_cast<void**>(mid) = nullptr;
+          free_lists_[fill_from] = mid;
+        }
+        break;
+      }
+    }
+    // We need a new page. Map it without holding the lock and retry.
+    new_map = NewLRTMap(gPageSize, error_msg);
+    if (!new_map.IsValid()) {
       return nullptr;
     }
-    result = map.Begin();
-    shared_lrt_maps_.emplace_back(std::move(map));
-  }
-  while (fill_from != index) {
-    --fill_from;
-    // Store the second half of the current buffer in appropriate free list slot.
-    void* mid = reinterpret_cast<uint8_t*>(result) + (kInitialLrtBytes << fill_from);
-    DCHECK(free_lists_[fill_from] == nullptr);
-    *reinterpret_cast<void**>(mid) = nullptr;
-    free_lists_[fill_from] = mid;
   }
   // Clear the memory we return to the caller.
   std::memset(result, 0, kInitialLrtBytes << index);
@@ -99,6 +113,8 @@ LrtEntry* SmallLrtAllocator::Allocate(size_t size, std::string* error_msg) {
 
 void SmallLrtAllocator::Deallocate(LrtEntry* unneeded, size_t size) {
   size_t index = GetIndex(size);
+  // A page that becomes entirely free is moved here and unmapped after releasing the lock.
+  MemMap unneeded_map;
   MutexLock lock(Thread::Current(), lock_);
   while (index < num_lrt_slots_) {
     // Check if we can merge this free block with another block with the same size.
@@ -130,6 +146,7 @@ void SmallLrtAllocator::Deallocate(LrtEntry* unneeded, size_t size) {
     auto match = [=](MemMap& map) { return unneeded == reinterpret_cast<LrtEntry*>(map.Begin()); };
     auto it = std::find_if(shared_lrt_maps_.begin(), shared_lrt_maps_.end(), match);
     DCHECK(it != shared_lrt_maps_.end());
+    unneeded_map = std::move(*it);
     shared_lrt_maps_.erase(it);
     DCHECK(!shared_lrt_maps_.empty());
     return;
@@ -64,6 +64,7 @@ inline void* LinearAlloc::Realloc(Thread* self,
                                   size_t new_size,
                                   LinearAllocKind kind) {
   MutexLock mu(self, lock_);
+  bytes_per_kind_[static_cast<size_t>(kind)] += new_size - old_size;
   if (track_allocations_) {
     if (ptr != nullptr) {
       // Realloc cannot be called on 16-byte aligned as Realloc doesn't guarantee
@@ -88,12 +89,27 @@ inline void* LinearAlloc::Realloc(Thread* self,
 
 inline void* LinearAlloc::Alloc(Thread* self, size_t size, LinearAllocKind kind) {
   MutexLock mu(self, lock_);
+  bytes_per_kind_[static_cast<size_t>(kind)] += size;
   if (track_allocations_) {
     size += sizeof(TrackingHeader);
+    if (UNLIKELY(free_list_bytes_ != 0u)) {
+      void* reused = AllocFromFreeList(RoundUp(size, kAlignment));
+      if (reused != nullptr) {
+        // The pages' first objects were recorded when the block was first allocated.
+        new (static_cast<TrackingHeader*>(reused) - 1) TrackingHeader(size, kind);
+        return reused;
+      }
+    }
     TrackingHeader* storage = new (allocator_.Alloc(size)) TrackingHeader(size, kind);
     SetFirstObject(storage, size);
     return storage + 1;
   } else {
+    if (UNLIKELY(free_list_bytes_ != 0u)) {
+      void* reused = AllocFromFreeList(RoundUp(size, kAlignment));
+      if (reused != nullptr) {
+        return reused;
+      }
+    }
     return allocator_.Alloc(size);
   }
 }
@@ -101,6 +117,7 @@ inline void* LinearAlloc::Alloc(Thread* self, size_t size, LinearAllocKind kind)
 inline void* LinearAlloc::AllocAlign16(Thread* self, size_t size, LinearAllocKind kind) {
   MutexLock mu(self, lock_);
   DCHECK_ALIGNED(size, 16);
+  bytes_per_kind_[static_cast<size_t>(kind)] += size;
   if (track_allocations_) {
     size_t mem_tool_bytes = ArenaAllocator::IsRunningOnMemoryTool()
                             ? ArenaAllocator::kMemoryToolRedZoneBytes : 0;
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "linear_alloc-inl.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include <ostream>
+
+#include "base/mem_map.h"
+#include "base/utils.h"
+#include "read_barrier_config.h"
+
+namespace art HIDDEN {
+
+void** LinearAlloc::GetFreeListHead(size_t block_size) {
+  DCHECK_ALIGNED(block_size, kAlignment);
+  if (block_size <= kMaxSmallFreeBlockSize) {
+    if (small_free_lists_ == nullptr) {
+      small_free_lists_.reset(new void*[kNumSmallFreeLists]());
+    }
+    return &small_free_lists_[block_size / kAlignment];
+  }
+  // Inserts a null head for a new size.
+  return &large_free_lists_[block_size];
+}
+
+void* LinearAlloc::AllocFromFreeList(size_t block_size) {
+  DCHECK_NE(free_list_bytes_, 0u);
+  void** head;
+  if (block_size <= kMaxSmallFreeBlockSize) {
+    head = GetFreeListHead(block_size);
+  } else {
+    auto it = large_free_lists_.find(block_size);
+    if (it == large_free_lists_.end()) {
+      return nullptr;
+    }
+    head = &it->second;
+  }
+  void* ptr = *head;
+  if (ptr == nullptr) {
+    return nullptr;
+  }
+  *head = *reinterpret_cast<void**>(ptr);
+  if (*head == nullptr && block_size > kMaxSmallFreeBlockSize) {
+    large_free_lists_.erase(block_size);
+  }
+  free_list_bytes_ -= block_size;
+  reused_bytes_ += block_size;
+  size_t header_size = track_allocations_ ? sizeof(TrackingHeader) : 0u;
+  memset(ptr, 0, block_size - header_size);
+  return ptr;
+}
+
+void LinearAlloc::Free(Thread* self, void* ptr, size_t size, LinearAllocKind kind) {
+  if (ptr == nullptr) {
+    return;
+  }
+  MutexLock mu(self, lock_);
+  size_t block_size = size;
+  if (track_allocations_) {
+    TrackingHeader* header = static_cast<TrackingHeader*>(ptr) - 1;
+    DCHECK(header->GetKind() == kind || header->GetKind() == LinearAllocKind::kNoGCRoots)
+        << header->GetKind() << " vs " << kind;
+    // 16-byte allocations are not supported yet.
+    DCHECK(!header->Is16Aligned());
+    block_size += sizeof(TrackingHeader);
+    DCHECK_EQ(header->GetSize(), block_size);
+    // The header stays in place so that the GC keeps hopping over the block, but the
+    // contents are no longer visited.
+    header->SetKind(LinearAllocKind::kNoGCRoots);
+  }
+  block_size = RoundUp(block_size, kAlignment);
+  freed_bytes_ += block_size;
+  // With a memory tool the arena allocator adds red zones that the free lists do not track.
+  if (ArenaAllocator::IsRunningOnMemoryTool() || size < sizeof(void*)) {
+    return;
+  }
+  void** head = GetFreeListHead(block_size);
+  *reinterpret_cast<void**>(ptr) = *head;
+  *head = ptr;
+  free_list_bytes_ += block_size;
+}
+
+size_t LinearAlloc::ReleaseColdFreePages(Thread* self) {
+  // States of a large free block, kept in the word after its free list link. Reusing the block
+  // zeroes it, which puts it back in `kFresh`.
+  enum BlockState : uintptr_t {
+    kFresh = 0u,     // Freed since the previous call.
+    kCold,           // Unused for a whole period, pages still resident.
+    kReleased,       // Pages released.
+  };
+  MutexLock mu(self, lock_);
+  size_t header_size = track_allocations_ ? sizeof(TrackingHeader) : 0u;
+  size_t released_bytes = 0u;
+  // Smaller blocks cannot contain a whole page after their first two words.
+  for (auto it = large_free_lists_.upper_bound(gPageSize); it != large_free_lists_.end(); ++it) {
+    size_t block_size = it->first;
+    for (void* block = it->second; block != nullptr; block = *reinterpret_cast<void**>(block)) {
+      uintptr_t* state = reinterpret_cast<uintptr_t*>(block) + 1;
+      if (*state == kFresh) {
+        *state = kCold;
+        continue;
+      }
+      if (*state == kReleased) {
+        continue;
+      }
+      *state = kReleased;
+      uint8_t* begin = AlignUp(reinterpret_cast<uint8_t*>(state + 1), gPageSize);
+      uint8_t* end = AlignDown(reinterpret_cast<uint8_t*>(block) + block_size - header_size,
+                               gPageSize);
+      if (begin >= end) {
+        continue;
+      }
+      // Like `TrackedArena::ReleasePages()`, the userfaultfd GC maps linear-alloc arenas shared
+      // and needs MADV_REMOVE to free them, while arenas from before the zygote fork are private.
+      if (!gUseUserfaultfd || (madvise(begin, end - begin, MADV_REMOVE) == -1 && errno == EINVAL)) {
+        ZeroAndReleaseMemory(begin, end - begin);
+      }
+      released_bytes += end - begin;
+    }
+  }
+  released_bytes_ += released_bytes;
+  return released_bytes;
+}
+
+void LinearAlloc::DumpStats(std::ostream& os) const {
+  MutexLock mu(Thread::Current(), lock_);
+  os << "used=" << PrettySize(allocator_.BytesUsed());
+  for (size_t i = 0; i != kNumKinds; ++i) {
+    if (bytes_per_kind_[i] != 0u) {
+      os << " " << static_cast<LinearAllocKind>(i) << "=" << PrettySize(bytes_per_kind_[i]);
+    }
+  }
+  os << " freed=" << PrettySize(freed_bytes_)
+     << " reused=" << PrettySize(reused_bytes_)
+     << " free-listed=" << PrettySize(free_list_bytes_)
+     << " released=" << PrettySize(released_bytes_) << "\n";
+}
+
+}  // namespace art
@@ -17,6 +17,11 @@
 #ifndef ART_RUNTIME_LINEAR_ALLOC_H_
 #define ART_RUNTIME_LINEAR_ALLOC_H_
 
+#include <array>
+#include <iosfwd>
+#include <map>
+#include <memory>
+
 #include "base/arena_allocator.h"
 #include "base/casts.h"
 #include "base/macros.h"
@@ -85,6 +90,11 @@ class LinearAlloc {
   void* Realloc(Thread* self, void* ptr, size_t old_size, size_t new_size, LinearAllocKind kind)
       REQUIRES(!lock_);
 
+  // Return a block obtained from Alloc() or Realloc() with the same `size` and `kind` so that a
+  // later Alloc() of the same rounded size can reuse it. The caller must guarantee that nothing,
+  // including a concurrently running GC, can still read the block.
+  void Free(Thread* self, void* ptr, size_t size, LinearAllocKind kind) REQUIRES(!lock_);
+
   // Allocate an array of structs of type T.
   template<class T>
   T* AllocArray(Thread* self, size_t elements, LinearAllocKind kind) REQUIRES(!lock_) {
@@ -102,6 +112,13 @@ class LinearAlloc {
   // skips it. Currently only used during class linking for ArtMethod array.
   void ConvertToNoGcRoots(void* ptr, LinearAllocKind orig_kind);
 
+  // Release the pages of large free-listed blocks that have stayed unused since the previous
+  // call, and return the number of bytes released. The caller must prevent a GC from running.
+  size_t ReleaseColdFreePages(Thread* self) REQUIRES(!lock_);
+
+  // Dump the bytes allocated per LinearAllocKind and the free-list usage.
+  void DumpStats(std::ostream& os) const REQUIRES(!lock_);
+
   // Return true if the linear alloc contains an address.
   bool Contains(void* ptr) const REQUIRES(!lock_);
 
@@ -116,10 +133,30 @@ class LinearAlloc {
   void SetFirstObject(void* begin, size_t bytes) const REQUIRES(lock_);
 
  private:
+  static constexpr size_t kNumKinds = static_cast<size_t>(LinearAllocKind::kArtMethod) + 1u;
+  // Freed blocks up to this size are kept in per-size lists indexed by `size / kAlignment`,
+  // larger ones in `large_free_lists_`.
+  static constexpr size_t kMaxSmallFreeBlockSize = 512u;
+  static constexpr size_t kNumSmallFreeLists = kMaxSmallFreeBlockSize / kAlignment + 1u;
+
+  // Pop a zeroed block of `block_size` bytes (header included, rounded up to kAlignment) from
+  // the free lists and return the pointer following its header, or null if there is none.
+  void* AllocFromFreeList(size_t block_size) REQUIRES(lock_);
+  void** GetFreeListHead(size_t block_size) REQUIRES(lock_);
+
   mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   ArenaAllocator allocator_ GUARDED_BY(lock_);
   const bool track_allocations_;
 
+  std::unique_ptr<void*[]> small_free_lists_ GUARDED_BY(lock_);
+  std::map<size_t, void*> large_free_lists_ GUARDED_BY(lock_);
+  // Bytes currently available in the free lists. Alloc() only looks at the lists if non-zero.
+  size_t free_list_bytes_ GUARDED_BY(lock_) = 0u;
+  size_t freed_bytes_ GUARDED_BY(lock_) = 0u;
+  size_t reused_bytes_ GUARDED_BY(lock_) = 0u;
+  size_t released_bytes_ GUARDED_BY(lock_) = 0u;
+  std::array<size_t, kNumKinds> bytes_per_kind_ GUARDED_BY(lock_) = {};
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(LinearAlloc);
 };
 
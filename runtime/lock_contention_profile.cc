@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "lock_contention_profile.h"
+
+#include <sched.h>
+
+#include <algorithm>
+#include <ostream>
+#include <vector>
+
+#include "art_method-inl.h"
+#include "base/time_utils.h"
+
+namespace art HIDDEN {
+
+LockContentionProfile::LockContentionProfile()
+    : entries_(new Entry[kNumEntries]), num_dropped_(0) {}
+
+LockContentionProfile::Entry* LockContentionProfile::FindOrAddEntry(ArtMethod* owner_method,
+                                                                    ArtMethod* waiter_method) {
+  uintptr_t hash = (reinterpret_cast<uintptr_t>(owner_method) >> 3) * 31u +
+                   (reinterpret_cast<uintptr_t>(waiter_method) >> 3);
+  for (size_t probe = 0; probe < kMaxProbes; ++probe) {
+    Entry* entry = &entries_[(hash + probe) % kNumEntries];
+    EntryState state = entry->state.load(std::memory_order_acquire);
+    if (state == EntryState::kEmpty) {
+      if (entry->state.compare_exchange_strong(state,
+                                               EntryState::kInitializing,
+                                               std::memory_order_acquire)) {
+        entry->owner_method = owner_method;
+        entry->waiter_method = waiter_method;
+        entry->owner_name = ArtMethod::PrettyMethod(owner_method);
+        entry->waiter_name = ArtMethod::PrettyMethod(waiter_method);
+        entry->state.store(EntryState::kReady, std::memory_order_release);
+        return entry;
+      }
+    }
+    // Another thread may be initializing this entry. This only happens the first time a pair is
+    // seen, so just wait for it to finish.
+    while (state == EntryState::kInitializing) {
+      sched_yield();
+      state = entry->state.load(std::memory_order_acquire);
+    }
+    DCHECK(state == EntryState::kReady);
+    if (entry->owner_method == owner_method && entry->waiter_method == waiter_method) {
+      return entry;
+    }
+  }
+  return nullptr;
+}
+
+void LockContentionProfile::Record(ArtMethod* owner_method,
+                                   ArtMethod* waiter_method,
+                                   uint64_t wait_ns) {
+  Entry* entry = FindOrAddEntry(owner_method, waiter_method);
+  if (entry == nullptr) {
+    num_dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  entry->count.fetch_add(1, std::memory_order_relaxed);
+  entry->total_wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+  uint64_t max_wait_ns = entry->max_wait_ns.load(std::memory_order_relaxed);
+  while (wait_ns > max_wait_ns &&
+         !entry->max_wait_ns.compare_exchange_weak(max_wait_ns,
+                                                   wait_ns,
+                                                   std::memory_order_relaxed)) {
+  }
+}
+
+void LockContentionProfile::Dump(std::ostream& os, size_t max_entries) const {
+  std::vector<const Entry*> ready_entries;
+  for (size_t i = 0; i < kNumEntries; ++i) {
+    if (entries_[i].state.load(std::memory_order_acquire) == EntryState::kReady) {
+      ready_entries.push_back(&entries_[i]);
+    }
+  }
+  auto total_wait = [](const Entry* entry) {
+    return entry->total_wait_ns.load(std::memory_order_relaxed);
+  };
+  std::sort(ready_entries.begin(),
+            ready_entries.end(),
+            [&](const Entry* lhs, const Entry* rhs) { return total_wait(lhs) > total_wait(rhs); });
+  size_t num_dumped = std::min(max_entries, ready_entries.size());
+  os << "Lock contention profile: top " << num_dumped << " of " << ready_entries.size()
+     << " (dropped " << num_dropped_.load(std::memory_order_relaxed) << ")\n";
+  for (size_t i = 0; i < num_dumped; ++i) {
+    const Entry* entry = ready_entries[i];
+    os << "  " << PrettyDuration(total_wait(entry)) << " in "
+       << entry->count.load(std::memory_order_relaxed) << " waits (max "
+       << PrettyDuration(entry->max_wait_ns.load(std::memory_order_relaxed)) << "): "
+       << entry->waiter_name << " waiting on " << entry->owner_name << "\n";
+  }
+}
+
+}  // namespace art
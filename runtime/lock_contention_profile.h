@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_LOCK_CONTENTION_PROFILE_H_
+#define ART_RUNTIME_LOCK_CONTENTION_PROFILE_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+#include "base/locks.h"
+#include "base/macros.h"
+
+namespace art HIDDEN {
+
+class ArtMethod;
+
+// Aggregates the time threads spend blocked on contended monitors, keyed by the method holding
+// the lock and the method waiting for it. Recording is lock-free: entries live in a fixed-size
+// open-addressing table whose slots are claimed with a compare-and-swap and never released, so
+// the hot path only does atomic adds. Once the table is full, new (owner, waiter) pairs are only
+// counted as dropped.
+class LockContentionProfile {
+ public:
+  static constexpr size_t kNumEntries = 512;
+  static constexpr size_t kMaxProbes = 16;
+  static constexpr size_t kDefaultDumpEntries = 10;
+
+  LockContentionProfile();
+
+  // Records that waiter_method waited wait_ns for a lock held by owner_method. Either method may
+  // be null if it is not known.
+  void Record(ArtMethod* owner_method, ArtMethod* waiter_method, uint64_t wait_ns)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Dumps the max_entries pairs with the highest total wait time.
+  void Dump(std::ostream& os, size_t max_entries = kDefaultDumpEntries) const;
+
+  void DumpForSigQuit(std::ostream& os) const {
+    Dump(os);
+  }
+
+ private:
+  enum class EntryState : uint32_t {
+    kEmpty,
+    kInitializing,
+    kReady,
+  };
+
+  struct Entry {
+    std::atomic<EntryState> state{EntryState::kEmpty};
+    // The keys and names are written once, before the entry becomes ready. The names are
+    // computed eagerly since the methods may be unloaded before the profile is dumped.
+    ArtMethod* owner_method = nullptr;
+    ArtMethod* waiter_method = nullptr;
+    std::string owner_name;
+    std::string waiter_name;
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> total_wait_ns{0};
+    std::atomic<uint64_t> max_wait_ns{0};
+  };
+
+  // Returns the ready entry for the given pair, claiming a new one if needed, or null if there is
+  // no free entry within kMaxProbes slots.
+  Entry* FindOrAddEntry(ArtMethod* owner_method, ArtMethod* waiter_method)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  std::unique_ptr<Entry[]> entries_;
+  std::atomic<uint64_t> num_dropped_;
+
+  DISALLOW_COPY_AND_ASSIGN(LockContentionProfile);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_LOCK_CONTENTION_PROFILE_H_
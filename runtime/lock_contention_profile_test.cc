@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "lock_contention_profile.h"
+
+#include <sstream>
+
+#include "art_method-inl.h"
+#include "base/time_utils.h"
+#include "class_linker.h"
+#include "common_runtime_test.h"
+#include "mirror/class-inl.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art HIDDEN {
+
+class LockContentionProfileTest : public CommonRuntimeTest {
+ protected:
+  LockContentionProfileTest() {
+    use_boot_image_ = true;  // Make the Runtime creation cheaper.
+  }
+};
+
+TEST_F(LockContentionProfileTest, AggregatesAndSortsByWaitTime) {
+  ScopedObjectAccess soa(Thread::Current());
+  ObjPtr<mirror::Class> object_class =
+      class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;");
+  ASSERT_TRUE(object_class != nullptr);
+  ArtMethod* to_string =
+      object_class->FindClassMethod("toString", "()Ljava/lang/String;", kRuntimePointerSize);
+  ArtMethod* hash_code = object_class->FindClassMethod("hashCode", "()I", kRuntimePointerSize);
+  ASSERT_TRUE(to_string != nullptr);
+  ASSERT_TRUE(hash_code != nullptr);
+
+  LockContentionProfile profile;
+  profile.Record(to_string, hash_code, MsToNs(1));
+  profile.Record(to_string, hash_code, MsToNs(2));
+  profile.Record(hash_code, to_string, MsToNs(10));
+  profile.Record(nullptr, to_string, MsToNs(4));
+
+  std::ostringstream oss;
+  profile.Dump(oss, /* max_entries= */ 2);
+  std::string dump = oss.str();
+  EXPECT_NE(dump.find("top 2 of 3 (dropped 0)"), std::string::npos) << dump;
+  // The pair with the highest total wait time comes first.
+  size_t first = dump.find(to_string->PrettyMethod() + " waiting on " + hash_code->PrettyMethod());
+  size_t second = dump.find(to_string->PrettyMethod() + " waiting on null");
+  ASSERT_NE(first, std::string::npos) << dump;
+  ASSERT_NE(second, std::string::npos) << dump;
+  EXPECT_LT(first, second);
+  // Only the top entries are dumped.
+  EXPECT_EQ(dump.find(hash_code->PrettyMethod() + " waiting on"), std::string::npos) << dump;
+  EXPECT_NE(dump.find("in 1 waits"), std::string::npos) << dump;
+}
+
+}  // namespace art
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "method_coverage.h"
+
+#include <fcntl.h>
+
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include "android-base/stringprintf.h"
+#include "art_method-inl.h"
+#include "base/unix_file/fd_file.h"
+#include "class_linker.h"
+#include "dex/dex_file.h"
+#include "jit/jit.h"
+#include "mirror/class-inl.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art HIDDEN {
+
+using android::base::StringAppendF;
+using android::base::StringPrintf;
+
+bool MethodCoverage::IsExecuted(ArtMethod* method) {
+  // `PreviouslyWarm()` returns true for intrinsics, whose flags overlap.
+  if (method->IsAbstract() || method->IsNative() || method->IsIntrinsic()) {
+    return false;
+  }
+  if (method->PreviouslyWarm()) {
+    return true;
+  }
+  return !method->IsMemorySharedMethod() &&
+         method->CounterHasChanged(Runtime::Current()->GetJITOptions()->GetWarmupThreshold());
+}
+
+std::string MethodCoverage::Collect() {
+  class CoverageVisitor : public ClassVisitor {
+   public:
+    bool operator()(ObjPtr<mirror::Class> klass) override REQUIRES_SHARED(Locks::mutator_lock_) {
+      if (klass->IsProxyClass() || klass->IsArrayClass() || klass->IsPrimitive()) {
+        return true;
+      }
+      std::vector<uint8_t>* bitmap = nullptr;
+      for (ArtMethod& method : klass->GetDeclaredMethods(kRuntimePointerSize)) {
+        if (!IsExecuted(&method)) {
+          continue;
+        }
+        if (bitmap == nullptr) {
+          const DexFile* dex_file = &klass->GetDexFile();
+          bitmap = &bitmaps_[dex_file];
+          bitmap->resize(RoundUp(dex_file->NumMethodIds(), kBitsPerByte) / kBitsPerByte, 0u);
+        }
+        uint32_t method_idx = method.GetDexMethodIndex();
+        (*bitmap)[method_idx / kBitsPerByte] |= 1u << (method_idx % kBitsPerByte);
+      }
+      return true;
+    }
+
+    std::map<const DexFile*, std::vector<uint8_t>> bitmaps_;
+  };
+
+  CoverageVisitor visitor;
+  Runtime::Current()->GetClassLinker()->VisitClasses(&visitor);
+
+  std::string result;
+  for (auto& [dex_file, bitmap] : visitor.bitmaps_) {
+    while (!bitmap.empty() && bitmap.back() == 0u) {
+      bitmap.pop_back();
+    }
+    StringAppendF(&result,
+                  "%s %08x %zu ",
+                  dex_file->GetLocation().c_str(),
+                  dex_file->GetLocationChecksum(),
+                  dex_file->NumMethodIds());
+    for (uint8_t byte : bitmap) {
+      StringAppendF(&result, "%02x", byte);
+    }
+    result += '\n';
+  }
+  return result;
+}
+
+bool MethodCoverage::Dump(const std::string& filename, std::string* error_msg) {
+  std::string coverage;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    coverage = Collect();
+  }
+  File file(filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, /*check_usage=*/ false);
+  if (!file.IsOpened()) {
+    *error_msg = StringPrintf("Could not open %s: %s", filename.c_str(), strerror(errno));
+    return false;
+  }
+  if (!file.WriteFully(coverage.data(), coverage.size())) {
+    *error_msg = StringPrintf("Could not write %s: %s", filename.c_str(), strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+}  // namespace art
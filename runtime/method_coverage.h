@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_METHOD_COVERAGE_H_
+#define ART_RUNTIME_METHOD_COVERAGE_H_
+
+#include <string>
+
+#include "base/locks.h"
+#include "base/macros.h"
+
+namespace art HIDDEN {
+
+class ArtMethod;
+
+// Reports which methods have been executed, for dead code analysis on production traffic.
+// No extra instrumentation is needed: a method counts as executed once nterp or JIT code has
+// decremented its hotness counter, or once it has been marked warm for the profile saver.
+// Methods shared between processes (boot image and zygote) do not update their counters and
+// are only reported when they have been sampled warm. Methods that only ever ran AOT-compiled
+// code are not reported either.
+class MethodCoverage {
+ public:
+  // Returns whether `method` has been executed since its class was linked.
+  static bool IsExecuted(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Returns one line per dex file with loaded classes, in the form
+  // "<location> <checksum> <number of method ids> <bitmap>". The bitmap is printed in
+  // hexadecimal, bit `i % 8` of byte `i / 8` being set if method id `i` was executed, and
+  // trailing zero bytes are dropped.
+  static std::string Collect() REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Writes the result of `Collect()` to `filename`.
+  static bool Dump(const std::string& filename, std::string* error_msg)
+      REQUIRES(!Locks::mutator_lock_);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_METHOD_COVERAGE_H_
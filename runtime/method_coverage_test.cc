@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "method_coverage.h"
+
+#include <string>
+
+#include "android-base/file.h"
+#include "android-base/stringprintf.h"
+#include "art_method-inl.h"
+#include "class_linker.h"
+#include "common_runtime_test.h"
+#include "dex/dex_file.h"
+#include "handle_scope-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/class_loader.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art HIDDEN {
+
+class MethodCoverageTest : public CommonRuntimeTest {};
+
+TEST_F(MethodCoverageTest, ReportsExecutedMethods) {
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::ClassLoader> class_loader(
+      hs.NewHandle(soa.Decode<mirror::ClassLoader>(LoadDex("XandY"))));
+  ObjPtr<mirror::Class> klass = class_linker_->FindClass(soa.Self(), "LX;", class_loader);
+  ASSERT_TRUE(klass != nullptr);
+  ArtMethod* constructor = klass->FindConstructor("()V", kRuntimePointerSize);
+  ASSERT_TRUE(constructor != nullptr);
+  const DexFile& dex_file = klass->GetDexFile();
+  std::string prefix = android::base::StringPrintf(
+      "%s %08x %zu ", dex_file.GetLocation().c_str(), dex_file.GetLocationChecksum(),
+      dex_file.NumMethodIds());
+
+  // Nothing in the dex file has run yet.
+  EXPECT_FALSE(MethodCoverage::IsExecuted(constructor));
+  EXPECT_EQ(MethodCoverage::Collect().find(prefix), std::string::npos);
+
+  // Interpreting the method decrements its hotness counter.
+  constructor->UpdateCounter(1);
+  EXPECT_TRUE(MethodCoverage::IsExecuted(constructor));
+  std::string coverage = MethodCoverage::Collect();
+  size_t start = coverage.find(prefix);
+  ASSERT_NE(start, std::string::npos) << coverage;
+  size_t end = coverage.find('\n', start);
+  ASSERT_NE(end, std::string::npos) << coverage;
+  std::string bitmap = coverage.substr(start + prefix.size(), end - start - prefix.size());
+
+  uint32_t method_idx = constructor->GetDexMethodIndex();
+  ASSERT_EQ(bitmap.size(), 2u * (method_idx / kBitsPerByte + 1u)) << bitmap;
+  uint32_t last_byte = std::stoul(bitmap.substr(bitmap.size() - 2u), nullptr, 16);
+  EXPECT_EQ(last_byte, 1u << (method_idx % kBitsPerByte)) << bitmap;
+}
+
+TEST_F(MethodCoverageTest, Dump) {
+  std::string location;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    StackHandleScope<1> hs(soa.Self());
+    Handle<mirror::ClassLoader> class_loader(
+        hs.NewHandle(soa.Decode<mirror::ClassLoader>(LoadDex("XandY"))));
+    ObjPtr<mirror::Class> klass = class_linker_->FindClass(soa.Self(), "LY;", class_loader);
+    ASSERT_TRUE(klass != nullptr);
+    ArtMethod* constructor = klass->FindConstructor("()V", kRuntimePointerSize);
+    ASSERT_TRUE(constructor != nullptr);
+    constructor->UpdateCounter(1);
+    location = klass->GetDexFile().GetLocation();
+  }
+
+  ScratchFile file;
+  std::string error_msg;
+  ASSERT_TRUE(MethodCoverage::Dump(file.GetFilename(), &error_msg)) << error_msg;
+
+  std::string contents;
+  ASSERT_TRUE(android::base::ReadFileToString(file.GetFilename(), &contents));
+  EXPECT_NE(contents.find(location + " "), std::string::npos) << contents;
+}
+
+}  // namespace art
@@ -195,6 +195,37 @@ constexpr std::optional<int32_t> EncodeDatumId(DatumId datum_id) {
     case DatumId::kTimeElapsedDelta:
       return std::make_optional(
           statsd::ART_DATUM_DELTA_REPORTED__KIND__ART_DATUM_DELTA_TIME_ELAPSED_MS);
+    case DatumId::kTlabRefillCount:
+    case DatumId::kTlabWastedBytes:
+    case DatumId::kGcPauseTargetMissCount:
+    case DatumId::kGcNewObjectSurvivalRate:
+    case DatumId::kGcOldObjectSurvivalRate:
+    case DatumId::kGcEvacuatedBytes:
+    case DatumId::kGcEvacuationFreedBytes:
+    case DatumId::kGcForAllocBlockingCount:
+    case DatumId::kGcForAllocBlockingTime:
+    case DatumId::kMonitorInflationCount:
+    case DatumId::kMonitorContentionCount:
+    case DatumId::kMonitorContentionTimeNs:
+    case DatumId::kJitOsrQueueLatency:
+    case DatumId::kJitBaselineQueueLatency:
+    case DatumId::kJitOptimizedQueueLatency:
+    case DatumId::kJitStaleQueuedMethodCount:
+    case DatumId::kJitMethodCompileQueueDepth:
+    case DatumId::kJitCodeCacheCollectionTimeUs:
+    case DatumId::kJitOsrRecompileCount:
+    case DatumId::kChaInvalidatedMethodCount:
+    case DatumId::kChaInvalidationCheckpointCount:
+    case DatumId::kNterpCacheRefillCount:
+    case DatumId::kDexCacheMissCount:
+    case DatumId::kReadBarrierSlowPathCount:
+    case DatumId::kDexFileOpenTimeUs:
+    case DatumId::kSuspendAllTimeUs:
+    case DatumId::kJitBootJniStubReuseCount:
+    case DatumId::kStartupReleasedBytes:
+    case DatumId::kColdMemoryReleasedBytes:
+      // Not reported to statsd yet.
+      return std::nullopt;
   }
 }
 
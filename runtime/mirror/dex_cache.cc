@@ -16,6 +16,10 @@
 
 #include "dex_cache-inl.h"
 
+#include <map>
+#include <ostream>
+#include <string>
+
 #include "art_method-inl.h"
 #include "class_linker.h"
 #include "gc/accounting/card_table-inl.h"
@@ -40,6 +44,17 @@ namespace mirror {
 // while debugging b/283632504.
 static constexpr bool kEnableFullArraysAtStartup = false;
 
+// Conflict counts of the hash-based caches of a dex file.
+struct DexCacheConflicts {
+  std::string location;
+  uint32_t counts[enum_cast<size_t>(DexCacheConflictKind::kLast) + 1u] = {};
+  uint32_t promoted_kinds = 0u;  // Bit mask of `DexCacheConflictKind`.
+};
+
+// Keyed by dex file rather than dex cache, as dex caches can move.
+static std::map<const DexFile*, DexCacheConflicts>* gDexCacheConflicts
+    GUARDED_BY(Locks::dex_cache_lock_) = nullptr;
+
 void DexCache::Initialize(const DexFile* dex_file, ObjPtr<ClassLoader> class_loader) {
   DCHECK(GetDexFile() == nullptr);
   DCHECK(GetStrings() == nullptr);
@@ -202,6 +217,54 @@ bool DexCache::ShouldAllocateFullArrayAtStartup() {
   return true;
 }
 
+bool DexCache::RecordConflict(DexCacheConflictKind kind, size_t cache_size) {
+  if (Runtime::Current()->IsAotCompiler()) {
+    // To save on memory in dex2oat, we keep the hash-based caches.
+    return false;
+  }
+  MutexLock mu(Thread::Current(), *Locks::dex_cache_lock_);
+  if (gDexCacheConflicts == nullptr) {
+    gDexCacheConflicts = new std::map<const DexFile*, DexCacheConflicts>();
+  }
+  const DexFile* dex_file = GetDexFile();
+  auto it = gDexCacheConflicts->find(dex_file);
+  if (it == gDexCacheConflicts->end()) {
+    it = gDexCacheConflicts->emplace(dex_file, DexCacheConflicts{dex_file->GetLocation()}).first;
+  }
+  DexCacheConflicts& conflicts = it->second;
+  size_t kind_index = enum_cast<size_t>(kind);
+  ++conflicts.counts[kind_index];
+  uint32_t kind_bit = 1u << kind_index;
+  if ((conflicts.promoted_kinds & kind_bit) != 0u ||
+      conflicts.counts[kind_index] < kDexCacheConflictPromotionFactor * cache_size) {
+    return false;
+  }
+  conflicts.promoted_kinds |= kind_bit;
+  return true;
+}
+
+void DexCache::DumpConflicts(std::ostream& os) {
+  static const char* const kKindNames[] = {
+      "strings", "types", "methods", "fields", "method types" };
+  static_assert(arraysize(kKindNames) == enum_cast<size_t>(DexCacheConflictKind::kLast) + 1u);
+  MutexLock mu(Thread::Current(), *Locks::dex_cache_lock_);
+  if (gDexCacheConflicts == nullptr) {
+    return;
+  }
+  os << "Dex cache conflicts:\n";
+  for (const auto& entry : *gDexCacheConflicts) {
+    const DexCacheConflicts& conflicts = entry.second;
+    os << "  " << conflicts.location << ":";
+    for (size_t i = 0; i != arraysize(kKindNames); ++i) {
+      os << " " << kKindNames[i] << "=" << conflicts.counts[i];
+      if ((conflicts.promoted_kinds & (1u << i)) != 0u) {
+        os << " (full array)";
+      }
+    }
+    os << "\n";
+  }
+}
+
 void DexCache::UnlinkStartupCaches() {
   if (GetDexFile() == nullptr) {
     // Unused dex cache.
@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_MIRROR_DEX_CACHE_H_
 #define ART_RUNTIME_MIRROR_DEX_CACHE_H_
 
+#include <iosfwd>
+
 #include "array.h"
 #include "base/array_ref.h"
 #include "base/atomic_pair.h"
@@ -141,6 +143,14 @@ template <typename T, size_t size> class NativeDexCachePairArray {
     SetNativePair(entries_, SlotIndex(index), value);
   }
 
+  // Returns whether the slot for `index` holds the entry of another index.
+  bool HasConflict(uint32_t index) REQUIRES_SHARED(Locks::mutator_lock_) {
+    uint32_t slot = SlotIndex(index);
+    size_t stored_index = GetNativePair(entries_, slot).index;
+    return stored_index != index &&
+           stored_index != NativeDexCachePair<T>::InvalidIndexForSlot(slot);
+  }
+
  private:
   NativeDexCachePair<T> GetNativePair(std::atomic<NativeDexCachePair<T>>* pair_array, size_t idx) {
     auto* array = reinterpret_cast<AtomicPair<uintptr_t>*>(pair_array);
@@ -186,6 +196,13 @@ template <typename T, size_t size> class DexCachePairArray {
     entries_[SlotIndex(index)].store(value, std::memory_order_release);
   }
 
+  // Returns whether the slot for `index` holds the entry of another index.
+  bool HasConflict(uint32_t index) {
+    uint32_t slot = SlotIndex(index);
+    uint32_t stored_index = entries_[slot].load(std::memory_order_relaxed).index;
+    return stored_index != index && stored_index != DexCachePair<T>::InvalidIndexForSlot(slot);
+  }
+
   void Clear(uint32_t index) {
     uint32_t slot = SlotIndex(index);
     // This is racy but should only be called from the transactional interpreter.
@@ -253,6 +270,16 @@ template <typename T> class NativeArray {
   Atomic<T*> entries_[0];
 };
 
+// The hash-based caches of a DexCache, for conflict accounting.
+enum class DexCacheConflictKind : uint8_t {
+  kStrings,
+  kResolvedTypes,
+  kResolvedMethods,
+  kResolvedFields,
+  kResolvedMethodTypes,
+  kLast = kResolvedMethodTypes,
+};
+
 // C++ mirror of java.lang.DexCache.
 class MANAGED DexCache final : public Object {
  public:
@@ -286,6 +313,10 @@ class MANAGED DexCache final : public Object {
   // Size of method type dex cache. Needs to be a power of 2 for entrypoint assumptions
   // to hold.
   static constexpr size_t kDexCacheMethodTypeCacheSize = 1024;
+
+  // Number of conflicting stores in a hash-based cache, relative to its size, after which
+  // the cache is replaced by a full array.
+  static constexpr size_t kDexCacheConflictPromotionFactor = 4;
   static_assert(IsPowerOfTwo(kDexCacheMethodTypeCacheSize),
                 "MethodType dex cache size is not a power of 2.");
 
@@ -386,6 +417,14 @@ class MANAGED DexCache final : public Object {
   // allocator.
   void UnlinkStartupCaches() REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Records a store into the hash-based cache `kind` that evicted the entry of another index.
+  // Returns whether the cache conflicted often enough to be replaced by a full array.
+  bool RecordConflict(DexCacheConflictKind kind, size_t cache_size)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Locks::dex_cache_lock_);
+
+  // Dumps the conflict counts of dex caches, for SIGQUIT.
+  static void DumpConflicts(std::ostream& os) REQUIRES(!Locks::dex_cache_lock_);
+
   // Returns whether we should allocate a full array given the number of elements.
   // Note: update the image version in image.cc if changing this method.
   static bool ShouldAllocateFullArray(size_t number_of_elements, size_t dex_cache_size) {
@@ -479,6 +518,10 @@ class MANAGED DexCache final : public Object {
           pairs = Allocate ##getter_setter(); \
           pairs->Set(index, resolved); \
         } \
+      } else if (UNLIKELY(pairs->HasConflict(index)) && \
+                 RecordConflict(DexCacheConflictKind::k ##getter_setter, pair_size)) { \
+        array = Allocate ##getter_setter ##Array(); \
+        array->Set(index, resolved); \
       } else { \
         pairs->Set(index, resolved); \
       } \
@@ -486,7 +529,9 @@ class MANAGED DexCache final : public Object {
   } \
   void Unlink ##getter_setter ##ArrayIfStartup() \
       REQUIRES_SHARED(Locks::mutator_lock_) { \
-    if (!ShouldAllocateFullArray(GetDexFile()->ids(), pair_size)) { \
+    /* A full array allocated next to the hash-based cache was promoted, not startup. */ \
+    if (!ShouldAllocateFullArray(GetDexFile()->ids(), pair_size) && \
+        Get ##getter_setter() == nullptr) { \
       Set ##getter_setter ##Array(nullptr) ; \
     } \
   }
@@ -152,6 +152,11 @@ size_t MethodType::NumberOfVRegs(RawMethodType method_type) {
 }
 
 bool MethodType::IsExactMatch(ObjPtr<MethodType> target) {
+  // Call sites resolve their MethodType through the DexCache, so a call site repeatedly invoking
+  // the same handle usually passes the very same object.
+  if (this == target.Ptr()) {
+    return true;
+  }
   const ObjPtr<ObjectArray<Class>> p_types = GetPTypes();
   const int32_t params_length = p_types->GetLength();
 
@@ -225,6 +230,9 @@ static bool IsParameterInPlaceConvertible(ObjPtr<Class> from, ObjPtr<Class> to)
 }
 
 bool MethodType::IsInPlaceConvertible(ObjPtr<MethodType> target) {
+  if (this == target.Ptr()) {
+    return true;
+  }
   const ObjPtr<ObjectArray<Class>> ptypes = GetPTypes();
   const ObjPtr<ObjectArray<Class>> target_ptypes = target->GetPTypes();
   const int32_t ptypes_length = ptypes->GetLength();
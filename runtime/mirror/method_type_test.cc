@@ -84,6 +84,7 @@ TEST_F(MethodTypeTest, IsExactMatch) {
     Handle<mirror::MethodType> mt1 = hs.NewHandle(CreateMethodType("String", { "Integer" }));
     Handle<mirror::MethodType> mt2 = hs.NewHandle(CreateMethodType("String", { "Integer" }));
     ASSERT_TRUE(mt1->IsExactMatch(mt2.Get()));
+    ASSERT_TRUE(mt1->IsExactMatch(mt1.Get()));
   }
 
   // Mismatched return type.
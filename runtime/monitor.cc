@@ -32,6 +32,7 @@
 #include "dex/dex_instruction-inl.h"
 #include "entrypoints/entrypoint_utils-inl.h"
 #include "gc/verification-inl.h"
+#include "lock_contention_profile.h"
 #include "lock_word-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
@@ -97,6 +98,7 @@ void Monitor::Init(uint32_t lock_profiling_threshold,
 Monitor::Monitor(Thread* self, Thread* owner, ObjPtr<mirror::Object> obj, int32_t hash_code)
     : monitor_lock_("a monitor lock", kMonitorLock),
       num_waiters_(0),
+      adaptive_spins_(kInitialAdaptiveSpins),
       owner_(owner),
       lock_count_(0),
       obj_(GcRoot<mirror::Object>(obj)),
@@ -131,6 +133,7 @@ Monitor::Monitor(Thread* self,
                  MonitorId id)
     : monitor_lock_("a monitor lock", kMonitorLock),
       num_waiters_(0),
+      adaptive_spins_(kInitialAdaptiveSpins),
       owner_(owner),
       lock_count_(0),
       obj_(GcRoot<mirror::Object>(obj)),
@@ -426,8 +429,14 @@ bool Monitor::TryLock(Thread* self, bool spin) {
     lock_count_++;
     CHECK_NE(lock_count_, 0u);  // Abort on overflow.
   } else {
-    bool success = spin ? monitor_lock_.ExclusiveTryLockWithSpinning(self)
-        : monitor_lock_.ExclusiveTryLock(self);
+    bool success = monitor_lock_.ExclusiveTryLock(self);
+    if (!success && spin) {
+      int spins = adaptive_spins_.load(std::memory_order_relaxed);
+      success = monitor_lock_.ExclusiveTryLockWithSpinning(self, spins);
+      spins = success ? std::min(spins * 2, kMaxAdaptiveSpins)
+                      : std::max(spins - 1, kMinAdaptiveSpins);
+      adaptive_spins_.store(spins, std::memory_order_relaxed);
+    }
     if (!success) {
       return false;
     }
@@ -455,7 +464,10 @@ void Monitor::Lock(Thread* self) {
     return;
   }
   // Contended; not reentrant. We hold no locks, so tread carefully.
+  const uint64_t contention_start_ns = NanoTime();
   const bool log_contention = (lock_profiling_threshold_ != 0);
+  LockContentionProfile* const contention_profile =
+      Runtime::Current()->GetLockContentionProfile();
   uint64_t wait_start_ms = log_contention ? MilliTime() : 0;
 
   Thread *orig_owner = nullptr;
@@ -464,6 +476,7 @@ void Monitor::Lock(Thread* self) {
 
   // Do this before releasing the mutator lock so that we don't get deflated.
   size_t num_waiters = num_waiters_.fetch_add(1, std::memory_order_relaxed);
+  Runtime::Current()->GetMetrics()->MonitorContentionCount()->AddOne();
 
   bool started_trace = false;
   if (ATraceEnabled() && owner_.load(std::memory_order_relaxed) != nullptr) {
@@ -498,7 +511,7 @@ void Monitor::Lock(Thread* self) {
       Locks::thread_list_lock_->ExclusiveUnlock(self);
     }
   }
-  if (log_contention) {
+  if (log_contention || contention_profile != nullptr) {
     // Request the current holder to set lock_owner_info.
     // Do this even if tracing is enabled, so we semi-consistently get the information
     // corresponding to MonitorExit.
@@ -636,6 +649,19 @@ void Monitor::Lock(Thread* self) {
   }
   self->SetMonitorEnterObject(nullptr);
   num_waiters_.fetch_sub(1, std::memory_order_relaxed);
+  const uint64_t contention_ns = NanoTime() - contention_start_ns;
+  Runtime::Current()->GetMetrics()->MonitorContentionTimeNs()->Add(
+      static_cast<int64_t>(contention_ns));
+  if (contention_profile != nullptr) {
+    // The owner filled in lock_owner_info when releasing the monitor, if it saw our request.
+    ArtMethod* owner_method = nullptr;
+    uint32_t owner_dex_pc;
+    if (orig_owner != nullptr) {
+      GetLockOwnerInfo(&owner_method, &owner_dex_pc, orig_owner);
+    }
+    uint32_t dex_pc;
+    contention_profile->Record(owner_method, self->GetCurrentMethod(&dex_pc), contention_ns);
+  }
   DCHECK(monitor_lock_.IsExclusiveHeld(self));
   // We need to pair this with a single contended locking call. NB we match the RI behavior and call
   // this even if MonitorEnter failed.
@@ -1050,6 +1076,7 @@ void Monitor::Inflate(Thread* self, Thread* owner, ObjPtr<mirror::Object> obj, i
           << " created monitor " << m << " for object " << obj;
     }
     Runtime::Current()->GetMonitorList()->Add(m);
+    Runtime::Current()->GetMetrics()->MonitorInflationCount()->AddOne();
     CHECK_EQ(obj->GetLockWord(true).GetState(), LockWord::kFatLocked);
   } else {
     MonitorPool::ReleaseMonitor(self, m);
@@ -1667,6 +1694,8 @@ void MonitorList::Add(Monitor* m) {
 
 void MonitorList::SweepMonitorList(IsMarkedVisitor* visitor) {
   Thread* self = Thread::Current();
+  // The dead monitors are released together once the list is swept.
+  Monitors dead_monitors;
   MutexLock mu(self, monitor_list_lock_);
   for (auto it = list_.begin(); it != list_.end(); ) {
     Monitor* m = *it;
@@ -1677,13 +1706,13 @@ void MonitorList::SweepMonitorList(IsMarkedVisitor* visitor) {
     if (new_obj == nullptr) {
       VLOG(monitor) << "freeing monitor " << m << " belonging to unmarked object "
                     << obj;
-      MonitorPool::ReleaseMonitor(self, m);
-      it = list_.erase(it);
+      dead_monitors.splice(dead_monitors.end(), list_, it++);
     } else {
       m->SetObject(new_obj);
       ++it;
     }
   }
+  MonitorPool::ReleaseMonitors(self, &dead_monitors);
 }
 
 size_t MonitorList::Size() {
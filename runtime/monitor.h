@@ -62,6 +62,12 @@ class Monitor {
   // a lock word. See Runtime::max_spins_before_thin_lock_inflation_.
   constexpr static size_t kDefaultMaxSpinsBeforeThinLockInflation = 50;
 
+  // Bounds of the number of spins on a contended monitor before blocking. The number is
+  // adapted per monitor, see Monitor::TryLock().
+  static constexpr int kMinAdaptiveSpins = 1;
+  static constexpr int kInitialAdaptiveSpins = Mutex::kDefaultMaxSpins;
+  static constexpr int kMaxAdaptiveSpins = 20;
+
   static constexpr int kDefaultMonitorTimeoutMs = 500;
 
   static constexpr int kMonitorTimeoutMinMs = 200;
@@ -332,6 +338,12 @@ class Monitor {
   // monitor acquisition. Prevents deflation.
   std::atomic<size_t> num_waiters_;
 
+  // Number of spins before blocking on a contended acquisition. Grows when spinning acquires
+  // the monitor, and shrinks when spinning fails, so that monitors held briefly avoid the futex
+  // wait, and monitors held for long do not waste CPU time spinning. Updates may race, which
+  // only loses an adjustment.
+  std::atomic<int> adaptive_spins_;
+
   // Which thread currently owns the lock? monitor_lock_ only keeps the tid.
   // Only set while holding monitor_lock_. Non-locking readers only use it to
   // compare to self or for debugging.
@@ -433,8 +445,9 @@ class Monitor {
   MonitorId monitor_id_;
 
 #ifdef __LP64__
-  // Free list for monitor pool.
-  Monitor* next_free_ GUARDED_BY(Locks::allocated_monitor_ids_lock_);
+  // Free list for monitor pool. Guarded by allocated_monitor_ids_lock_ while in the free list
+  // of the pool, and owned by the thread while in the monitor cache of a thread.
+  Monitor* next_free_;
 #endif
 
   friend class MonitorInfo;
@@ -110,6 +110,24 @@ Monitor* MonitorPool::CreateMonitorInPool(Thread* self,
                                           ObjPtr<mirror::Object> obj,
                                           int32_t hash_code)
     REQUIRES_SHARED(Locks::mutator_lock_) {
+  DCHECK_EQ(self, Thread::Current());
+  // Only `self` uses its monitor cache, so this does not need the lock.
+  Monitor* mon_uninitialized = self->GetMonitorCache();
+  if (mon_uninitialized == nullptr) {
+    mon_uninitialized = RefillThreadLocalMonitors(self);
+  }
+  self->SetMonitorCache(mon_uninitialized->next_free_);
+
+  // Pull out the id which was preinitialized.
+  MonitorId id = mon_uninitialized->monitor_id_;
+
+  // Initialize it.
+  Monitor* monitor = new(mon_uninitialized) Monitor(self, owner, obj, hash_code, id);
+
+  return monitor;
+}
+
+Monitor* MonitorPool::RefillThreadLocalMonitors(Thread* self) {
   // We are gonna allocate, so acquire the writer lock.
   MutexLock mu(self, *Locks::allocated_monitor_ids_lock_);
 
@@ -119,16 +137,20 @@ Monitor* MonitorPool::CreateMonitorInPool(Thread* self,
     AllocateChunk();
   }
 
-  Monitor* mon_uninitialized = first_free_;
-  first_free_ = first_free_->next_free_;
-
-  // Pull out the id which was preinitialized.
-  MonitorId id = mon_uninitialized->monitor_id_;
-
-  // Initialize it.
-  Monitor* monitor = new(mon_uninitialized) Monitor(self, owner, obj, hash_code, id);
+  Monitor* first = first_free_;
+  Monitor* last = first;
+  for (size_t i = 1; i < kThreadMonitorCacheSize && last->next_free_ != nullptr; ++i) {
+    last = last->next_free_;
+  }
+  first_free_ = last->next_free_;
+  last->next_free_ = nullptr;
+  return first;
+}
 
-  return monitor;
+void MonitorPool::AddMonitorsToFreeList(Thread* self, Monitor* first, Monitor* last) {
+  MutexLock mu(self, *Locks::allocated_monitor_ids_lock_);
+  last->next_free_ = first_free_;
+  first_free_ = first;
 }
 
 void MonitorPool::ReleaseMonitorToPool(Thread* self, Monitor* monitor) {
@@ -151,9 +173,33 @@ void MonitorPool::ReleaseMonitorToPool(Thread* self, Monitor* monitor) {
 }
 
 void MonitorPool::ReleaseMonitorsToPool(Thread* self, MonitorList::Monitors* monitors) {
+  if (monitors->empty()) {
+    return;
+  }
+  // The monitors are no longer reachable, so they can be destroyed and linked without the lock.
+  Monitor* first = nullptr;
+  Monitor* last = monitors->front();
   for (Monitor* mon : *monitors) {
-    ReleaseMonitorToPool(self, mon);
+    MonitorId id = mon->monitor_id_;
+    mon->~Monitor();
+    mon->next_free_ = first;
+    mon->monitor_id_ = id;
+    first = mon;
+  }
+  AddMonitorsToFreeList(self, first, last);
+}
+
+void MonitorPool::RevokeThreadLocalMonitorsInPool(Thread* self, Thread* thread) {
+  Monitor* first = thread->GetMonitorCache();
+  if (first == nullptr) {
+    return;
+  }
+  thread->SetMonitorCache(nullptr);
+  Monitor* last = first;
+  while (last->next_free_ != nullptr) {
+    last = last->next_free_;
   }
+  AddMonitorsToFreeList(self, first, last);
 }
 
 }  // namespace art
@@ -66,6 +66,7 @@ class MonitorPool {
 #endif
   }
 
+  // Release all the monitors in the list, taking the pool lock once.
   static void ReleaseMonitors(Thread* self, MonitorList::Monitors* monitors) {
 #ifndef __LP64__
     UNUSED(self);
@@ -75,6 +76,15 @@ class MonitorPool {
 #endif
   }
 
+  // Return the free monitors cached by `thread` to the pool. Called when the thread goes away.
+  static void RevokeThreadLocalMonitors(Thread* self, Thread* thread) {
+#ifndef __LP64__
+    UNUSED(self, thread);
+#else
+    GetMonitorPool()->RevokeThreadLocalMonitorsInPool(self, thread);
+#endif
+  }
+
   static Monitor* MonitorFromMonitorId(MonitorId mon_id) {
 #ifndef __LP64__
     return reinterpret_cast<Monitor*>(mon_id << LockWord::kMonitorIdAlignmentShift);
@@ -132,8 +142,17 @@ class MonitorPool {
                                int32_t hash_code)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Move up to kThreadMonitorCacheSize free monitors from the pool to the monitor cache of
+  // `self`. Returns the first one.
+  Monitor* RefillThreadLocalMonitors(Thread* self) REQUIRES(!Locks::allocated_monitor_ids_lock_);
+
+  // Add the free monitors from `first` to `last`, linked through next_free_, to the pool.
+  void AddMonitorsToFreeList(Thread* self, Monitor* first, Monitor* last)
+      REQUIRES(!Locks::allocated_monitor_ids_lock_);
+
   void ReleaseMonitorToPool(Thread* self, Monitor* monitor);
   void ReleaseMonitorsToPool(Thread* self, MonitorList::Monitors* monitors);
+  void RevokeThreadLocalMonitorsInPool(Thread* self, Thread* thread);
 
   // Note: This is safe as we do not ever move chunks.  All needed entries in the monitor_chunks_
   // data structure are read-only once we get here.  Updates happen-before this call because
@@ -196,6 +215,9 @@ class MonitorPool {
   static constexpr size_t kChunkSize = 4096;
   static_assert(IsPowerOfTwo(kChunkSize), "kChunkSize must be power of 2");
   static constexpr size_t kChunkCapacity = kChunkSize / kAlignedMonitorSize;
+  // The number of free monitors a thread takes from the pool at a time, so that inflating
+  // monitors only takes the pool lock once every so many monitors.
+  static constexpr size_t kThreadMonitorCacheSize = 16;
   // The number of chunks of storage that can be referenced by the initial chunk list.
   // The total number of usable monitor chunks is typically 255 times this number, so it
   // should be large enough that we don't run out. We run out of address bits if it's > 512.
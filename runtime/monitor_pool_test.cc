@@ -124,4 +124,24 @@ TEST_F(MonitorPoolTest, MonitorPoolTest) {
   }
 }
 
+TEST_F(MonitorPoolTest, ReleaseMonitors) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+
+  // Use enough monitors to span several refills of the monitor cache of the thread.
+  const size_t kNumMonitors = 100;
+  for (size_t round = 0; round < 3; ++round) {
+    MonitorList::Monitors monitors;
+    for (size_t i = 0; i < kNumMonitors; ++i) {
+      Monitor* mon = MonitorPool::CreateMonitor(self, self, nullptr, static_cast<int32_t>(i));
+      VerifyMonitor(mon, self);
+      monitors.push_back(mon);
+    }
+    MonitorPool::ReleaseMonitors(self, &monitors);
+    // The released monitors and the ones still cached by the thread go back to the pool.
+    MonitorPool::RevokeThreadLocalMonitors(self, self);
+    EXPECT_EQ(self->GetMonitorCache(), nullptr);
+  }
+}
+
 }  // namespace art
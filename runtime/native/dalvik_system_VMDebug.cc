@@ -236,7 +236,11 @@ static void VMDebug_dumpHprofData(JNIEnv* env, jclass, jstring javaFilename, jin
 
   int fd = javaFd;
 
-  hprof::DumpHeap(filename.c_str(), fd, false);
+  if (filename.ends_with(".lz4")) {
+    hprof::DumpHeapCompressed(filename.c_str(), fd);
+  } else {
+    hprof::DumpHeap(filename.c_str(), fd, false);
+  }
 }
 
 static void VMDebug_dumpHprofDataDdms(JNIEnv*, jclass) {
@@ -40,6 +40,7 @@ extern "C" void android_set_application_target_sdk_version(uint32_t version);
 #include "debugger.h"
 #include "dex/class_accessor-inl.h"
 #include "dex/dex_file-inl.h"
+#include "dex/dex_file_loader.h"
 #include "dex/dex_file_types.h"
 #include "gc/accounting/card_table-inl.h"
 #include "gc/allocator/art-dlmalloc.h"
@@ -453,6 +454,10 @@ static void VMRuntime_setProcessPackageName(JNIEnv* env,
 static void VMRuntime_setProcessDataDirectory(JNIEnv* env, jclass, jstring java_data_dir) {
   ScopedUtfChars data_dir(env, java_data_dir);
   Runtime::Current()->SetProcessDataDirectory(data_dir.c_str());
+  // Extract compressed dex files of the app to its code cache, which is
+  // private to the app's user and cleared when the app is updated.
+  DexFileLoader::SetExtractionCacheDirectory(
+      data_dir.c_str() == nullptr ? std::string() : std::string(data_dir.c_str()) + "/code_cache");
 }
 
 static void VMRuntime_bootCompleted([[maybe_unused]] JNIEnv* env, [[maybe_unused]] jclass klass) {
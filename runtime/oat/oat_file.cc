@@ -703,6 +703,23 @@ bool OatFileBase::Setup(int zip_fd,
 
   std::string_view primary_location;
   std::string_view primary_location_replacement;
+  // Canonicalizing a location calls realpath(), which stats every path component.
+  // All dex files of a multidex container share the base location, so only
+  // canonicalize it once per container.
+  std::string last_base_location;
+  std::string last_canonical_base_location;
+  auto get_canonical_location = [&](const std::string& location) {
+    std::string base_location = DexFileLoader::GetBaseLocation(location);
+    if (base_location.find(DexFileLoader::kMultiDexSeparator) != std::string::npos) {
+      // The base location is ambiguous on its own, canonicalize the full location.
+      return DexFileLoader::GetDexCanonicalLocation(location.c_str());
+    }
+    if (base_location != last_base_location) {
+      last_canonical_base_location = DexFileLoader::GetDexCanonicalLocation(base_location.c_str());
+      last_base_location = std::move(base_location);
+    }
+    return last_canonical_base_location + location.substr(last_base_location.size());
+  };
   File no_file;
   File* dex_file = &no_file;
   size_t dex_filenames_pos = 0u;
@@ -1017,7 +1034,7 @@ bool OatFileBase::Setup(int zip_fd,
     OatDexFile* oat_dex_file =
         new OatDexFile(this,
                        dex_file_location,
-                       DexFileLoader::GetDexCanonicalLocation(dex_file_name.c_str()),
+                       get_canonical_location(dex_file_name),
                        dex_file_magic,
                        dex_file_checksum,
                        dex_file_sha1,
@@ -19,6 +19,7 @@
 #include <stdlib.h>
 #include <sys/stat.h>
 
+#include <atomic>
 #include <memory>
 #include <queue>
 #include <vector>
@@ -34,6 +35,7 @@
 #include "base/sdk_version.h"
 #include "base/stl_util.h"
 #include "base/systrace.h"
+#include "base/time_utils.h"
 #include "class_linker.h"
 #include "class_loader_context.h"
 #include "dex/art_dex_file_loader.h"
@@ -469,6 +471,7 @@ std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
     std::string error_msg;
     static constexpr bool kVerifyChecksum = true;
     ArtDexFileLoader dex_file_loader(dex_location);
+    uint64_t open_start_ns = NanoTime();
     if (!dex_file_loader.Open(Runtime::Current()->IsVerificationEnabled(),
                               kVerifyChecksum,
                               /*out*/ &error_msg,
@@ -478,6 +481,7 @@ std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
       error_msgs->push_back("Failed to open dex files from " + std::string(dex_location)
                             + " because: " + error_msg);
     }
+    Runtime::Current()->GetMetrics()->DexFileOpenTimeUs()->Add(NsToUs(NanoTime() - open_start_ns));
   }
 
   if (Runtime::Current()->GetJit() != nullptr) {
@@ -689,13 +693,20 @@ static bool UnlinkLeastRecentlyUsedVdexIfNeeded(const std::string& vdex_path_to_
   return true;
 }
 
-class BackgroundVerificationTask final : public Task {
+// State shared by the tasks verifying the same dex files in parallel. Each task claims classes
+// from a shared counter and records into its own `VerifierDeps`; the last task to finish merges
+// them and writes the vdex file.
+class BackgroundVerificationJob {
  public:
-  BackgroundVerificationTask(const std::vector<const DexFile*>& dex_files,
-                             jobject class_loader,
-                             const std::string& vdex_path)
+  BackgroundVerificationJob(const std::vector<const DexFile*>& dex_files,
+                            jobject class_loader,
+                            const std::string& vdex_path,
+                            size_t num_tasks)
       : dex_files_(dex_files),
-        vdex_path_(vdex_path) {
+        vdex_path_(vdex_path),
+        next_class_(0u),
+        remaining_tasks_(num_tasks),
+        task_deps_(num_tasks) {
     Thread* const self = Thread::Current();
     ScopedObjectAccess soa(self);
     // Create a global ref for `class_loader` because it will be accessed from a different thread.
@@ -703,61 +714,47 @@ class BackgroundVerificationTask final : public Task {
     CHECK(class_loader_ != nullptr);
   }
 
-  ~BackgroundVerificationTask() {
+  ~BackgroundVerificationJob() {
     Thread* const self = Thread::Current();
     ScopedObjectAccess soa(self);
     soa.Vm()->DeleteGlobalRef(self, class_loader_);
   }
 
-  void Run(Thread* self) override {
-    std::string error_msg;
-    ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
-    verifier::VerifierDeps verifier_deps(dex_files_);
-
-    // Iterate over all classes and verify them.
-    for (const DexFile* dex_file : dex_files_) {
-      for (uint32_t cdef_idx = 0; cdef_idx < dex_file->NumClassDefs(); cdef_idx++) {
-        const dex::ClassDef& class_def = dex_file->GetClassDef(cdef_idx);
-
-        // Take handles inside the loop. The background verification is low priority
-        // and we want to minimize the risk of blocking anyone else.
-        ScopedObjectAccess soa(self);
-        StackHandleScope<2> hs(self);
-        Handle<mirror::ClassLoader> h_loader(hs.NewHandle(
-            soa.Decode<mirror::ClassLoader>(class_loader_)));
-        Handle<mirror::Class> h_class(hs.NewHandle<mirror::Class>(class_linker->FindClass(
-            self,
-            dex_file->GetClassDescriptor(class_def),
-            h_loader)));
-
-        if (h_class == nullptr) {
-          DCHECK(self->IsExceptionPending());
-          self->ClearException();
-          continue;
-        }
-
-        if (&h_class->GetDexFile() != dex_file) {
-          // There is a different class in the class path or a parent class loader
-          // with the same descriptor. This `h_class` is not resolvable, skip it.
-          continue;
-        }
-
-        DCHECK(h_class->IsResolved()) << h_class->PrettyDescriptor();
-        class_linker->VerifyClass(self, &verifier_deps, h_class);
-        if (self->IsExceptionPending()) {
-          // ClassLinker::VerifyClass can throw, but the exception isn't useful here.
-          self->ClearException();
-        }
+  const std::vector<const DexFile*>& GetDexFiles() const {
+    return dex_files_;
+  }
 
-        DCHECK(h_class->IsVerified() || h_class->IsErroneous())
-            << h_class->PrettyDescriptor() << ": state=" << h_class->GetStatus();
+  jobject GetClassLoader() const {
+    return class_loader_;
+  }
 
-        if (h_class->IsVerified()) {
-          verifier_deps.RecordClassVerified(*dex_file, class_def);
-        }
+  // Claim the next class to verify. Returns false once all classes have been claimed.
+  bool ClaimClass(/*out*/ const DexFile** dex_file, /*out*/ uint32_t* class_def_idx) {
+    size_t index = next_class_.fetch_add(1u, std::memory_order_relaxed);
+    for (const DexFile* candidate : dex_files_) {
+      if (index < candidate->NumClassDefs()) {
+        *dex_file = candidate;
+        *class_def_idx = static_cast<uint32_t>(index);
+        return true;
       }
+      index -= candidate->NumClassDefs();
     }
+    return false;
+  }
 
+  void FinishTask(size_t task_index, std::unique_ptr<verifier::VerifierDeps> deps) {
+    DCHECK(task_deps_[task_index] == nullptr);
+    task_deps_[task_index] = std::move(deps);
+    // Acquire-release ordering makes the `VerifierDeps` of all tasks visible to the last one.
+    if (remaining_tasks_.fetch_sub(1u, std::memory_order_acq_rel) != 1u) {
+      return;
+    }
+    std::unique_ptr<verifier::VerifierDeps> verifier_deps = std::move(task_deps_[0]);
+    for (size_t i = 1; i != task_deps_.size(); ++i) {
+      verifier_deps->MergeWith(std::move(task_deps_[i]), dex_files_);
+    }
+
+    std::string error_msg;
     // Delete old vdex files if there are too many in the folder.
     if (!UnlinkLeastRecentlyUsedVdexIfNeeded(vdex_path_, &error_msg)) {
       LOG(ERROR) << "Could not unlink old vdex files " << vdex_path_ << ": " << error_msg;
@@ -767,21 +764,90 @@ class BackgroundVerificationTask final : public Task {
     // Construct a vdex file and write `verifier_deps` into it.
     if (!VdexFile::WriteToDisk(vdex_path_,
                                dex_files_,
-                               verifier_deps,
+                               *verifier_deps,
                                &error_msg)) {
       LOG(ERROR) << "Could not write anonymous vdex " << vdex_path_ << ": " << error_msg;
       return;
     }
   }
 
+ private:
+  const std::vector<const DexFile*> dex_files_;
+  jobject class_loader_;
+  const std::string vdex_path_;
+  std::atomic<size_t> next_class_;
+  std::atomic<size_t> remaining_tasks_;
+  std::vector<std::unique_ptr<verifier::VerifierDeps>> task_deps_;
+
+  DISALLOW_COPY_AND_ASSIGN(BackgroundVerificationJob);
+};
+
+class BackgroundVerificationTask final : public Task {
+ public:
+  BackgroundVerificationTask(const std::shared_ptr<BackgroundVerificationJob>& job,
+                             size_t task_index)
+      : job_(job),
+        task_index_(task_index) {}
+
+  void Run(Thread* self) override {
+    ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
+    auto verifier_deps = std::make_unique<verifier::VerifierDeps>(job_->GetDexFiles());
+
+    // Iterate over all classes and verify them.
+    const DexFile* dex_file = nullptr;
+    uint32_t cdef_idx = 0u;
+    while (job_->ClaimClass(&dex_file, &cdef_idx)) {
+      const dex::ClassDef& class_def = dex_file->GetClassDef(cdef_idx);
+
+      // Take handles inside the loop. The background verification is low priority
+      // and we want to minimize the risk of blocking anyone else.
+      ScopedObjectAccess soa(self);
+      StackHandleScope<2> hs(self);
+      Handle<mirror::ClassLoader> h_loader(hs.NewHandle(
+          soa.Decode<mirror::ClassLoader>(job_->GetClassLoader())));
+      Handle<mirror::Class> h_class(hs.NewHandle<mirror::Class>(class_linker->FindClass(
+          self,
+          dex_file->GetClassDescriptor(class_def),
+          h_loader)));
+
+      if (h_class == nullptr) {
+        DCHECK(self->IsExceptionPending());
+        self->ClearException();
+        continue;
+      }
+
+      if (&h_class->GetDexFile() != dex_file) {
+        // There is a different class in the class path or a parent class loader
+        // with the same descriptor. This `h_class` is not resolvable, skip it.
+        continue;
+      }
+
+      DCHECK(h_class->IsResolved()) << h_class->PrettyDescriptor();
+      class_linker->VerifyClass(self, verifier_deps.get(), h_class);
+      if (self->IsExceptionPending()) {
+        // ClassLinker::VerifyClass can throw, but the exception isn't useful here.
+        self->ClearException();
+      }
+
+      DCHECK(h_class->IsVerified() || h_class->IsErroneous())
+          << h_class->PrettyDescriptor() << ": state=" << h_class->GetStatus();
+
+      if (h_class->IsVerified()) {
+        verifier_deps->RecordClassVerified(*dex_file, class_def);
+      }
+    }
+
+    job_->FinishTask(task_index_, std::move(verifier_deps));
+  }
+
   void Finalize() override {
     delete this;
   }
 
  private:
-  const std::vector<const DexFile*> dex_files_;
-  jobject class_loader_;
-  const std::string vdex_path_;
+  // The job is destroyed with the last task that references it.
+  const std::shared_ptr<BackgroundVerificationJob> job_;
+  const size_t task_index_;
 
   DISALLOW_COPY_AND_ASSIGN(BackgroundVerificationTask);
 };
@@ -851,18 +917,21 @@ void OatFileManager::RunBackgroundVerification(const std::vector<const DexFile*>
     return;
   }
 
+  const size_t num_threads = runtime->GetBackgroundVerificationThreads();
   {
     WriterMutexLock mu(self, *Locks::oat_file_manager_lock_);
     if (verification_thread_pool_ == nullptr) {
       verification_thread_pool_.reset(
-          ThreadPool::Create("Verification thread pool", /* num_threads= */ 1));
+          ThreadPool::Create("Verification thread pool", num_threads));
       verification_thread_pool_->StartWorkers(self);
     }
   }
-  verification_thread_pool_->AddTask(self, new BackgroundVerificationTask(
-      dex_files,
-      class_loader,
-      GetVdexFilename(odex_filename)));
+  // Split the classes of the dex files between one task per worker.
+  auto job = std::make_shared<BackgroundVerificationJob>(
+      dex_files, class_loader, GetVdexFilename(odex_filename), num_threads);
+  for (size_t i = 0; i != num_threads; ++i) {
+    verification_thread_pool_->AddTask(self, new BackgroundVerificationTask(job, i));
+  }
 }
 
 void OatFileManager::WaitForWorkersToBeCreated() {
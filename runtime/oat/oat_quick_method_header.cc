@@ -45,7 +45,7 @@ uint32_t OatQuickMethodHeader::ToDexPc(ArtMethod** frame,
     return NterpGetDexPC(frame);
   } else {
     DCHECK(IsOptimized());
-    CodeInfo code_info = CodeInfo::DecodeInlineInfoOnly(this);
+    CodeInfo code_info = CodeInfo::DecodeStackMapsOnly(this);
     StackMap stack_map = code_info.GetStackMapForNativePcOffset(sought_offset);
     if (stack_map.IsValid()) {
       return stack_map.GetDexPc();
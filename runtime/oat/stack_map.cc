@@ -80,14 +80,38 @@ CodeInfo CodeInfo::DecodeInlineInfoOnly(const OatQuickMethodHeader* header) {
   return copy;
 }
 
+CodeInfo CodeInfo::DecodeStackMapsOnly(const OatQuickMethodHeader* header) {
+  CodeInfo code_info;
+  BitMemoryReader reader(header->GetOptimizedCodeInfoPtr());
+  std::array<uint32_t, kNumHeaders> header_fields = reader.ReadInterleavedVarints<kNumHeaders>();
+  ForEachHeaderField([&code_info, &header_fields](size_t i, auto member_pointer) ALWAYS_INLINE {
+    code_info.*member_pointer = header_fields[i];
+  });
+  // The stack maps are the first bit table, so there is no need to skip the others.
+  static constexpr size_t kStackMapsIndex = 0u;
+  if (LIKELY(code_info.HasBitTable(kStackMapsIndex))) {
+    if (UNLIKELY(code_info.IsBitTableDeduped(kStackMapsIndex))) {
+      ssize_t bit_offset = reader.NumberOfReadBits() - reader.ReadVarint();
+      BitMemoryReader reader2(reader.data(), bit_offset);  // The offset is negative.
+      code_info.stack_maps_.Decode(reader2);
+    } else {
+      code_info.stack_maps_.Decode(reader);
+    }
+  }
+  return code_info;
+}
+
 StackMap CodeInfo::GetStackMapForNativePcOffset(uintptr_t pc, InstructionSet isa) const {
   uint32_t packed_pc = StackMap::PackNativePc(pc, isa);
+  static_assert(StackMap::kPackedNativePc == StackMap::kKind + 1);
   // Binary search.  All catch stack maps are stored separately at the end.
+  // Both tested columns are adjacent, so load them together for each probe.
   auto it = std::partition_point(
       stack_maps_.begin(),
       stack_maps_.end(),
-      [packed_pc](const StackMap& sm) {
-        return sm.GetPackedNativePc() < packed_pc && sm.GetKind() != StackMap::Kind::Catch;
+      [this, packed_pc](const StackMap& sm) {
+        auto [kind, sm_packed_pc] = stack_maps_.GetPair(sm.Row(), StackMap::kKind);
+        return sm_packed_pc < packed_pc && kind != StackMap::Kind::Catch;
       });
   // Start at the lower bound and iterate over all stack maps with the given native pc.
   for (; it != stack_maps_.end() && (*it).GetNativePcOffset(isa) == pc; ++it) {
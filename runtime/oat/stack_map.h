@@ -294,6 +294,9 @@ class CodeInfo {
   // The following methods decode only part of the data.
   static CodeInfo DecodeGcMasksOnly(const OatQuickMethodHeader* header);
   static CodeInfo DecodeInlineInfoOnly(const OatQuickMethodHeader* header);
+  // Decodes the header and the stack maps, which are the first bit table, and stops there.
+  // Enough to map a native pc to a dex pc of the outer method.
+  static CodeInfo DecodeStackMapsOnly(const OatQuickMethodHeader* header);
 
   ALWAYS_INLINE static uint32_t DecodeCodeSize(const uint8_t* code_info_data) {
     return DecodeHeaderOnly(code_info_data).code_size_;
@@ -224,6 +224,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:LongGCLogThreshold=_")  // in ms
           .WithType<MillisecondsToNanoseconds>()  // store as ns
           .IntoKey(M::LongGCLogThreshold)
+      .Define("-XX:GcPauseTargetMs=_")  // in ms
+          .WithType<MillisecondsToNanoseconds>()  // store as ns
+          .IntoKey(M::GcPauseTarget)
       .Define("-XX:DumpGCPerformanceOnShutdown")
           .IntoKey(M::DumpGCPerformanceOnShutdown)
       .Define("-XX:DumpRegionInfoBeforeGC")
@@ -271,6 +274,14 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
           .IntoKey(M::UseProfiledJitCompilation)
+      .Define("-Xjitprecompileappprofile:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::JitPrecompileAppProfile)
+      .Define("-Xjitosratfirstcompile:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::JitOsrAtFirstCompile)
       .Define("-Xjitinitialsize:_")
           .WithType<MemoryKiB>()
           .IntoKey(M::JITCodeCacheInitialCapacity)
@@ -280,18 +291,30 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xjitwarmupthreshold:_")
           .WithType<unsigned int>()
           .IntoKey(M::JITWarmupThreshold)
+      .Define("-Xjitmidtierminsize:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITMidTierMinCodeUnits)
+      .Define("-Xjitmidtierthreshold:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITMidTierOptimizeThreshold)
       .Define("-Xjitprithreadweight:_")
           .WithType<unsigned int>()
           .IntoKey(M::JITPriorityThreadWeight)
       .Define("-Xjittransitionweight:_")
           .WithType<unsigned int>()
           .IntoKey(M::JITInvokeTransitionWeight)
+      .Define("-Xjithotnessdecayperiod:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITHotnessDecayPeriodMs)
       .Define("-Xjitpthreadpriority:_")
           .WithType<int>()
           .IntoKey(M::JITPoolThreadPthreadPriority)
       .Define("-Xjitzygotepthreadpriority:_")
           .WithType<int>()
           .IntoKey(M::JITZygotePoolThreadPthreadPriority)
+      .Define("-Xjitthreads:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITThreadPoolSize)
       .Define("-Xjitsaveprofilinginfo")
           .WithType<ProfileSaverOptions>()
           .AppendValues()
@@ -314,6 +337,7 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
                "-Xps-min-notification-before-wake:_",
                "-Xps-max-notification-before-wake:_",
                "-Xps-inline-cache-threshold:_",
+               "-Xps-sampling-interval-ms:_",
                "-Xps-profile-path:_"})
           .WithHelp("profile-saver options -Xps-<key>:<value>")
           .WithType<ProfileSaverOptions>()
@@ -330,9 +354,10 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .IntoKey(M::ImageDex2Oat)
       .Define("-XX:LargeObjectSpace=_")
           .WithType<gc::space::LargeObjectSpaceType>()
-          .WithValueMap({{"disabled", gc::space::LargeObjectSpaceType::kDisabled},
-                         {"freelist", gc::space::LargeObjectSpaceType::kFreeList},
-                         {"map",      gc::space::LargeObjectSpaceType::kMap}})
+          .WithValueMap({{"disabled",   gc::space::LargeObjectSpaceType::kDisabled},
+                         {"freelist",   gc::space::LargeObjectSpaceType::kFreeList},
+                         {"map",        gc::space::LargeObjectSpaceType::kMap},
+                         {"segregated", gc::space::LargeObjectSpaceType::kSegregatedFreeList}})
           .IntoKey(M::LargeObjectSpace)
       .Define("-XX:LargeObjectThreshold=_")
           .WithType<Memory<1>>()
@@ -350,6 +375,8 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xstackdumplockprofthreshold:_")
           .WithType<unsigned int>()
           .IntoKey(M::StackDumpLockProfThreshold)
+      .Define("-Xlockcontentionprofile")
+          .IntoKey(M::LockContentionProfile)
       .Define("-Xmethod-trace")
           .IntoKey(M::MethodTrace)
       .Define("-Xmethod-trace-file:_")
@@ -360,6 +387,8 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .IntoKey(M::MethodTraceFileSize)
       .Define("-Xmethod-trace-stream")
           .IntoKey(M::MethodTraceStreaming)
+      .Define("-Xmethod-trace-flight-recorder")
+          .IntoKey(M::MethodTraceFlightRecorder)
       .Define("-Xmethod-trace-clock:_")
           .WithType<TraceClockSource>()
           .WithValueMap({{"threadcpuclock", TraceClockSource::kThreadCpu},
@@ -445,6 +474,29 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xverifier-logging-threshold=_")
           .WithType<unsigned int>()
           .IntoKey(M::VerifierLoggingThreshold)
+      .Define("-Xbackground-verification-threads=_")
+          .WithType<unsigned int>()
+          .IntoKey(M::BackgroundVerificationThreads)
+      .Define("-Xdirty-image-objects-sample-file:_")
+          .WithType<std::string>()
+          .IntoKey(M::DirtyImageObjectsSampleFile)
+      .Define("-Xstartup-timeline-file:_")
+          .WithType<std::string>()
+          .IntoKey(M::StartupTimelineFile)
+      .Define("-Xmethod-coverage-file:_")
+          .WithType<std::string>()
+          .IntoKey(M::MethodCoverageFile)
+      .Define("-Xcold-memory-release-period-ms:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::ColdMemoryReleasePeriodMs)
+      .Define("-Xjvmti-light-attach")
+          .IntoKey(M::JvmtiLightAttach)
+      .Define("-Xbackground-thread-affinity:_")
+          .WithType<std::string>()
+          .IntoKey(M::BackgroundThreadAffinity)
+      .Define("-Xfast-native-methods-file:_")
+          .WithType<std::string>()
+          .IntoKey(M::FastNativeMethodsFile)
       .Define("-XX:FastClassNotFoundException=_")
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
@@ -478,7 +530,10 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:PerfettoJavaHeapStackProf=_")
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
-          .IntoKey(M::PerfettoJavaHeapStackProf);
+          .IntoKey(M::PerfettoJavaHeapStackProf)
+      .Define("-XX:AllocationSiteProfilingInterval=_")
+          .WithType<Memory<1>>()
+          .IntoKey(M::AllocationSiteProfilingInterval);
   // clang-format on
 
   FlagBase::AddFlagsToCmdlineParser(parser_builder.get());
@@ -152,6 +152,77 @@ TEST_F(ParsedOptionsTest, ParsedOptionsGenerationalCC) {
   ASSERT_TRUE(xgc.generational_cc);
 }
 
+TEST_F(ParsedOptionsTest, ParsedOptionsGenerationalCMC) {
+  RuntimeOptions options;
+  options.push_back(std::make_pair("-Xgc:generational_cmc", nullptr));
+
+  RuntimeArgumentMap map;
+  bool parsed = ParsedOptions::Parse(options, false, &map);
+  ASSERT_TRUE(parsed);
+  ASSERT_NE(0u, map.Size());
+
+  using Opt = RuntimeArgumentMap;
+
+  EXPECT_TRUE(map.Exists(Opt::GcOption));
+
+  XGcOption xgc = map.GetOrDefault(Opt::GcOption);
+  ASSERT_TRUE(xgc.generational_cmc);
+}
+
+TEST_F(ParsedOptionsTest, ParsedOptionsNumaRegions) {
+  RuntimeOptions options;
+  options.push_back(std::make_pair("-Xgc:numa_regions", nullptr));
+
+  RuntimeArgumentMap map;
+  bool parsed = ParsedOptions::Parse(options, false, &map);
+  ASSERT_TRUE(parsed);
+
+  using Opt = RuntimeArgumentMap;
+
+  XGcOption xgc = map.GetOrDefault(Opt::GcOption);
+  ASSERT_TRUE(xgc.numa_regions);
+}
+
+TEST_F(ParsedOptionsTest, ParsedOptionsHugePages) {
+  RuntimeOptions options;
+  options.push_back(std::make_pair("-Xgc:hugepages", nullptr));
+
+  RuntimeArgumentMap map;
+  bool parsed = ParsedOptions::Parse(options, false, &map);
+  ASSERT_TRUE(parsed);
+
+  using Opt = RuntimeArgumentMap;
+
+  XGcOption xgc = map.GetOrDefault(Opt::GcOption);
+  ASSERT_TRUE(xgc.huge_pages);
+}
+
+TEST_F(ParsedOptionsTest, ParsedOptionsGcPauseTarget) {
+  RuntimeOptions options;
+  options.push_back(std::make_pair("-XX:GcPauseTargetMs=3", nullptr));
+
+  RuntimeArgumentMap map;
+  bool parsed = ParsedOptions::Parse(options, false, &map);
+  ASSERT_TRUE(parsed);
+
+  using Opt = RuntimeArgumentMap;
+
+  EXPECT_EQ(MsToNs(3), map.GetOrDefault(Opt::GcPauseTarget).GetNanoseconds());
+}
+
+TEST_F(ParsedOptionsTest, ParsedOptionsAllocationSiteProfilingInterval) {
+  RuntimeOptions options;
+  options.push_back(std::make_pair("-XX:AllocationSiteProfilingInterval=64k", nullptr));
+
+  RuntimeArgumentMap map;
+  bool parsed = ParsedOptions::Parse(options, false, &map);
+  ASSERT_TRUE(parsed);
+
+  using Opt = RuntimeArgumentMap;
+
+  EXPECT_EQ(64 * KB, map.GetOrDefault(Opt::AllocationSiteProfilingInterval).Value());
+}
+
 TEST_F(ParsedOptionsTest, ParsedOptionsInstructionSet) {
   using Opt = RuntimeArgumentMap;
 
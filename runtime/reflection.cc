@@ -227,7 +227,9 @@ class ArgArray {
                                     ArtMethod* m,
                                     Thread* self)
       REQUIRES_SHARED(Locks::mutator_lock_) {
-    const dex::TypeList* classes = m->GetParameterTypeList();
+    // Only looked up when an argument needs a type check, primitive and null reference arguments
+    // are checked against the shorty alone.
+    const dex::TypeList* classes = nullptr;
     // Set receiver if non-null (method is not static)
     if (receiver != nullptr) {
       Append(receiver);
@@ -240,6 +242,9 @@ class ArgArray {
       arg.Assign(args->Get(args_offset));
       if (((shorty_[i] == 'L') && (arg != nullptr)) ||
           ((arg == nullptr && shorty_[i] != 'L'))) {
+        if (classes == nullptr) {
+          classes = m->GetParameterTypeList();
+        }
         // TODO: The method's parameter's type must have been previously resolved, yet
         // we've seen cases where it's not b/34440020.
         ObjPtr<mirror::Class> dst_class(
@@ -459,11 +464,11 @@ void InvokeWithArgArray(const ScopedObjectAccessAlreadyRunnable& soa,
 }
 
 ALWAYS_INLINE
-bool CheckArgsForInvokeMethod(ArtMethod* np_method,
+bool CheckArgsForInvokeMethod(uint32_t shorty_len,
                               ObjPtr<mirror::ObjectArray<mirror::Object>> objects)
     REQUIRES_SHARED(Locks::mutator_lock_) {
-  const dex::TypeList* classes = np_method->GetParameterTypeList();
-  uint32_t classes_size = (classes == nullptr) ? 0 : classes->Size();
+  // The shorty has the return type followed by one character per parameter.
+  uint32_t classes_size = shorty_len - 1u;
   uint32_t arg_count = (objects == nullptr) ? 0 : objects->GetLength();
   if (UNLIKELY(arg_count != classes_size)) {
     ThrowIllegalArgumentException(StringPrintf("Wrong number of arguments; expected %d, got %d",
@@ -479,18 +484,17 @@ bool InvokeMethodImpl(const ScopedObjectAccessAlreadyRunnable& soa,
                       ArtMethod* np_method,
                       ObjPtr<mirror::Object> receiver,
                       ObjPtr<mirror::ObjectArray<mirror::Object>> objects,
-                      const char** shorty,
+                      const char* shorty,
+                      uint32_t shorty_len,
                       JValue* result) REQUIRES_SHARED(Locks::mutator_lock_) {
   // Invoke the method.
-  uint32_t shorty_len = 0;
-  *shorty = np_method->GetShorty(&shorty_len);
-  ArgArray arg_array(*shorty, shorty_len);
+  ArgArray arg_array(shorty, shorty_len);
   if (!arg_array.BuildArgArrayFromObjectArray(receiver, objects, np_method, soa.Self())) {
     CHECK(soa.Self()->IsExceptionPending());
     return false;
   }
 
-  InvokeWithArgArray(soa, m, &arg_array, result, *shorty);
+  InvokeWithArgArray(soa, m, &arg_array, result, shorty);
 
   // Wrap any exception with "Ljava/lang/reflect/InvocationTargetException;" and return early.
   if (soa.Self()->IsExceptionPending()) {
@@ -745,7 +749,9 @@ jobject InvokeMethod(const ScopedObjectAccessAlreadyRunnable& soa, jobject javaM
   ObjPtr<mirror::ObjectArray<mirror::Object>> objects =
       soa.Decode<mirror::ObjectArray<mirror::Object>>(javaArgs);
   auto* np_method = m->GetInterfaceMethodIfProxy(kPointerSize);
-  if (!CheckArgsForInvokeMethod(np_method, objects)) {
+  uint32_t shorty_len = 0;
+  const char* shorty = np_method->GetShorty(&shorty_len);
+  if (!CheckArgsForInvokeMethod(shorty_len, objects)) {
     return nullptr;
   }
 
@@ -769,8 +775,7 @@ jobject InvokeMethod(const ScopedObjectAccessAlreadyRunnable& soa, jobject javaM
 
   // Invoke the method.
   JValue result;
-  const char* shorty;
-  if (!InvokeMethodImpl(soa, m, np_method, receiver, objects, &shorty, &result)) {
+  if (!InvokeMethodImpl(soa, m, np_method, receiver, objects, shorty, shorty_len, &result)) {
     return nullptr;
   }
   return soa.AddLocalReference<jobject>(BoxPrimitive(Primitive::GetType(shorty[0]), result));
@@ -822,14 +827,15 @@ void InvokeConstructor(const ScopedObjectAccessAlreadyRunnable& soa,
   ObjPtr<mirror::ObjectArray<mirror::Object>> objects =
       soa.Decode<mirror::ObjectArray<mirror::Object>>(javaArgs);
   ArtMethod* np_method = constructor->GetInterfaceMethodIfProxy(kRuntimePointerSize);
-  if (!CheckArgsForInvokeMethod(np_method, objects)) {
+  uint32_t shorty_len = 0;
+  const char* shorty = np_method->GetShorty(&shorty_len);
+  if (!CheckArgsForInvokeMethod(shorty_len, objects)) {
     return;
   }
 
   // Invoke the constructor.
   JValue result;
-  const char* shorty;
-  InvokeMethodImpl(soa, constructor, np_method, receiver, objects, &shorty, &result);
+  InvokeMethodImpl(soa, constructor, np_method, receiver, objects, shorty, shorty_len, &result);
 }
 
 ObjPtr<mirror::Object> BoxPrimitive(Primitive::Type src_class, const JValue& value) {
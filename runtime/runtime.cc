@@ -32,6 +32,7 @@
 #include <crt_externs.h>  // for _NSGetEnviron
 #endif
 
+#include <android-base/file.h>
 #include <android-base/properties.h>
 #include <android-base/strings.h>
 #include <string.h>
@@ -52,6 +53,7 @@
 #include "art_field-inl.h"
 #include "art_method-inl.h"
 #include "asm_support.h"
+#include "background_thread_affinity.h"
 #include "base/aborting.h"
 #include "base/arena_allocator.h"
 #include "base/atomic.h"
@@ -100,6 +102,7 @@
 #include "jni/jni_id_manager.h"
 #include "jni_id_type.h"
 #include "linear_alloc.h"
+#include "lock_contention_profile.h"
 #include "memory_representation.h"
 #include "metrics/statsd.h"
 #include "mirror/array.h"
@@ -174,6 +177,7 @@
 #include "sigchain.h"
 #include "signal_catcher.h"
 #include "signal_set.h"
+#include "startup_timeline.h"
 #include "thread.h"
 #include "thread_list.h"
 #include "ti/agent.h"
@@ -220,6 +224,7 @@ struct TraceConfig {
   std::string trace_file;
   size_t trace_file_size;
   TraceClockSource clock_source;
+  bool flight_recorder;
 };
 
 namespace {
@@ -323,6 +328,7 @@ Runtime::Runtime()
       verifier_missing_kthrow_fatal_(false),
       perfetto_hprof_enabled_(false),
       perfetto_javaheapprof_enabled_(false),
+      allocation_site_profiling_interval_(0),
       out_of_memory_error_hook_(nullptr) {
   static_assert(Runtime::kCalleeSaveSize ==
                     static_cast<uint32_t>(CalleeSaveType::kLastCalleeSaveType), "Unexpected size");
@@ -1036,6 +1042,7 @@ void Runtime::RunRootClinits(Thread* self) {
 
 bool Runtime::Start() {
   VLOG(startup) << "Runtime::Start entering";
+  const uint64_t start_us = MicroTime();
 
   CHECK(!no_sig_chain_) << "A started runtime should have sig chain enabled";
 
@@ -1065,7 +1072,7 @@ bool Runtime::Start() {
   // InitNativeMethods needs to be after started_ so that the classes
   // it touches will have methods linked to the oat file if necessary.
   {
-    ScopedTrace trace2("InitNativeMethods");
+    StartupTimeline::ScopedPhase phase("InitNativeMethods");
     InitNativeMethods();
   }
 
@@ -1086,6 +1093,7 @@ bool Runtime::Start() {
   // recoding profiles. Maybe we should consider changing the name to be more clear it's
   // not only about compiling. b/28295073.
   if (jit_options_->UseJitCompilation() || jit_options_->GetSaveProfilingInfo()) {
+    StartupTimeline::ScopedPhase phase("CreateJit");
     CreateJit();
 #ifdef ADDRESS_SANITIZER
     // (b/238730394): In older implementations of sanitizer + glibc there is a race between
@@ -1112,7 +1120,10 @@ bool Runtime::Start() {
     callbacks_->NextRuntimePhase(RuntimePhaseCallback::RuntimePhase::kStart);
   }
 
-  system_class_loader_ = CreateSystemClassLoader(this);
+  {
+    StartupTimeline::ScopedPhase phase("CreateSystemClassLoader");
+    system_class_loader_ = CreateSystemClassLoader(this);
+  }
 
   if (!is_zygote_) {
     if (is_native_bridge_loaded_) {
@@ -1130,7 +1141,10 @@ bool Runtime::Start() {
 
   {
     ScopedObjectAccess soa(self);
-    StartDaemonThreads();
+    {
+      StartupTimeline::ScopedPhase phase("StartDaemonThreads");
+      StartDaemonThreads();
+    }
     self->GetJniEnv()->AssertLocalsEmpty();
 
     // Send the initialized phase event. Send it after starting the Daemon threads so that agents
@@ -1155,6 +1169,9 @@ bool Runtime::Start() {
     } else {
       LOG(ERROR) << "Unexpected clock source";
     }
+    if (trace_config_->flight_recorder) {
+      flags |= Trace::TraceFlag::kTraceFlightRecorder;
+    }
     Trace::Start(trace_config_->trace_file.c_str(),
                  static_cast<int>(trace_config_->trace_file_size),
                  flags,
@@ -1187,6 +1204,14 @@ bool Runtime::Start() {
         kVMRuntimePrimaryApk);
   }
 
+  StartupTimeline::Record("Runtime::Start", start_us, MicroTime());
+  if (!startup_timeline_file_.empty()) {
+    std::string error_msg;
+    if (!StartupTimeline::Dump(startup_timeline_file_, &error_msg)) {
+      LOG(WARNING) << "Could not dump startup timeline: " << error_msg;
+    }
+  }
+
   return true;
 }
 
@@ -1531,7 +1556,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   using Opt = RuntimeArgumentMap;
   Opt runtime_options(std::move(runtime_options_in));
-  ScopedTrace trace(__FUNCTION__);
+  StartupTimeline::ScopedPhase phase("Runtime::Init");
   CHECK_EQ(static_cast<size_t>(sysconf(_SC_PAGE_SIZE)), gPageSize);
 
   // Reload all the flags value (from system properties and device configs).
@@ -1554,6 +1579,8 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   force_java_zygote_fork_loop_ = runtime_options.GetOrDefault(Opt::ForceJavaZygoteForkLoop);
   perfetto_hprof_enabled_ = runtime_options.GetOrDefault(Opt::PerfettoHprof);
   perfetto_javaheapprof_enabled_ = runtime_options.GetOrDefault(Opt::PerfettoJavaHeapStackProf);
+  allocation_site_profiling_interval_ =
+      runtime_options.GetOrDefault(Opt::AllocationSiteProfilingInterval).Value();
 
   // Try to reserve a dedicated fault page. This is allocated for clobbered registers and sentinels.
   // If we cannot reserve it, log a warning.
@@ -1591,6 +1618,19 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   Thread::SetSensitiveThreadHook(runtime_options.GetOrDefault(Opt::HookIsSensitiveThread));
   Monitor::Init(runtime_options.GetOrDefault(Opt::LockProfThreshold),
                 runtime_options.GetOrDefault(Opt::StackDumpLockProfThreshold));
+  if (runtime_options.Exists(Opt::LockContentionProfile)) {
+    lock_contention_profile_.reset(new LockContentionProfile());
+  }
+  {
+    uint32_t kinds;
+    std::string error_msg;
+    if (BackgroundThreadAffinity::ParseThreadKinds(
+            runtime_options.GetOrDefault(Opt::BackgroundThreadAffinity), &kinds, &error_msg)) {
+      background_thread_affinity_.reset(BackgroundThreadAffinity::Create(kinds));
+    } else {
+      LOG(WARNING) << "Ignoring -Xbackground-thread-affinity: " << error_msg;
+    }
+  }
 
   image_locations_ = runtime_options.ReleaseOrDefault(Opt::Image);
 
@@ -1746,6 +1786,8 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   // Generational CC collection is currently only compatible with Baker read barriers.
   bool use_generational_cc = kUseBakerReadBarrier && xgc_option.generational_cc;
+  // Generational CMC collection is only meaningful with the userfaultfd GC.
+  bool use_generational_cmc = gUseUserfaultfd && xgc_option.generational_cmc;
 
   // Cache the apex versions.
   InitializeApexVersions();
@@ -1755,6 +1797,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                         (gUseUserfaultfd ? BackgroundGcOption(gc::kCollectorTypeCMCBackground) :
                                            runtime_options.GetOrDefault(Opt::BackgroundGc));
 
+  const uint64_t heap_start_us = MicroTime();
   heap_ = new gc::Heap(runtime_options.GetOrDefault(Opt::MemoryInitialSize),
                        runtime_options.GetOrDefault(Opt::HeapGrowthLimit),
                        runtime_options.GetOrDefault(Opt::HeapMinFree),
@@ -1782,6 +1825,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                        runtime_options.Exists(Opt::LowMemoryMode),
                        runtime_options.GetOrDefault(Opt::LongPauseLogThreshold),
                        runtime_options.GetOrDefault(Opt::LongGCLogThreshold),
+                       runtime_options.GetOrDefault(Opt::GcPauseTarget),
                        runtime_options.Exists(Opt::IgnoreMaxFootprint),
                        runtime_options.GetOrDefault(Opt::AlwaysLogExplicitGcs),
                        runtime_options.GetOrDefault(Opt::UseTLAB),
@@ -1795,9 +1839,13 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                        xgc_option.measure_,
                        runtime_options.GetOrDefault(Opt::EnableHSpaceCompactForOOM),
                        use_generational_cc,
+                       use_generational_cmc,
+                       xgc_option.numa_regions,
+                       xgc_option.huge_pages,
                        runtime_options.GetOrDefault(Opt::HSpaceCompactForOOMMinIntervalsMs),
                        runtime_options.Exists(Opt::DumpRegionInfoBeforeGC),
                        runtime_options.Exists(Opt::DumpRegionInfoAfterGC));
+  StartupTimeline::Record("CreateHeap", heap_start_us, MicroTime());
 
   dump_gc_performance_on_shutdown_ = runtime_options.Exists(Opt::DumpGCPerformanceOnShutdown);
 
@@ -1924,9 +1972,36 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   }
 
   verifier_logging_threshold_ms_ = runtime_options.GetOrDefault(Opt::VerifierLoggingThreshold);
+  background_verification_threads_ =
+      std::max(1u, runtime_options.GetOrDefault(Opt::BackgroundVerificationThreads));
+  dirty_image_objects_sample_file_ =
+      runtime_options.GetOrDefault(Opt::DirtyImageObjectsSampleFile);
+  startup_timeline_file_ = runtime_options.GetOrDefault(Opt::StartupTimelineFile);
+  method_coverage_file_ = runtime_options.GetOrDefault(Opt::MethodCoverageFile);
+  cold_memory_release_period_ms_ = runtime_options.GetOrDefault(Opt::ColdMemoryReleasePeriodMs);
+  jvmti_light_attach_ = runtime_options.Exists(Opt::JvmtiLightAttach);
+  if (runtime_options.Exists(Opt::FastNativeMethodsFile)) {
+    const std::string& file = runtime_options.GetOrDefault(Opt::FastNativeMethodsFile);
+    std::string content;
+    if (!android::base::ReadFileToString(file, &content)) {
+      PLOG(WARNING) << "Failed to read fast native methods file " << file;
+    } else {
+      for (const std::string& line : android::base::Split(content, "\n")) {
+        std::string method = android::base::Trim(line);
+        if (!method.empty() && method[0] != '#') {
+          fast_native_methods_.insert(std::move(method));
+        }
+      }
+      VLOG(startup) << "Loaded " << fast_native_methods_.size() << " fast native methods from "
+                    << file;
+    }
+  }
 
   std::string error_msg;
-  java_vm_ = JavaVMExt::Create(this, runtime_options, &error_msg);
+  {
+    StartupTimeline::ScopedPhase vm_phase("CreateJavaVM");
+    java_vm_ = JavaVMExt::Create(this, runtime_options, &error_msg);
+  }
   if (java_vm_.get() == nullptr) {
     LOG(ERROR) << "Could not initialize JavaVMExt: " << error_msg;
     return false;
@@ -1955,6 +2030,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   CHECK_GE(GetHeap()->GetContinuousSpaces().size(), 1U);
 
+  const uint64_t class_linker_start_us = MicroTime();
   if (UNLIKELY(IsAotCompiler())) {
     class_linker_ = new AotClassLinker(intern_table_);
   } else {
@@ -2041,6 +2117,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                                                                                 bcp_dex_files);
 
   CHECK(class_linker_ != nullptr);
+  StartupTimeline::Record("InitClassLinker", class_linker_start_us, MicroTime());
 
   if (runtime_options.Exists(Opt::MethodTrace)) {
     trace_config_.reset(new TraceConfig());
@@ -2051,6 +2128,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                                            TraceOutputMode::kStreaming :
                                            TraceOutputMode::kFile;
     trace_config_->clock_source = runtime_options.GetOrDefault(Opt::MethodTraceClock);
+    trace_config_->flight_recorder = runtime_options.Exists(Opt::MethodTraceFlightRecorder);
   }
 
   // TODO: Remove this in a follow up CL. This isn't used anywhere.
@@ -2122,6 +2200,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   // Load all plugins
   {
     // The init method of plugins expect the state of the thread to be non runnable.
+    StartupTimeline::ScopedPhase plugins_phase("LoadPlugins");
     ScopedThreadSuspension sts(self, ThreadState::kNative);
     for (auto& plugin : plugins_) {
       std::string err;
@@ -2165,6 +2244,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   // Startup agents
   // TODO Maybe we should start a new thread to run these on. Investigate RI behavior more.
+  const uint64_t agents_start_us = MicroTime();
   for (auto& agent_spec : agent_specs_) {
     // TODO Check err
     int res = 0;
@@ -2192,6 +2272,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
     LOG(FATAL) << "Unreachable";
     UNREACHABLE();
   }
+  StartupTimeline::Record("LoadAgents", agents_start_us, MicroTime());
   {
     ScopedObjectAccess soa(self);
     callbacks_->NextRuntimePhase(RuntimePhaseCallback::RuntimePhase::kInitialAgents);
@@ -2468,6 +2549,9 @@ void Runtime::DumpForSigQuit(std::ostream& os) {
   DumpDeoptimizations(os);
   TrackedAllocators::Dump(os);
   GetMetrics()->DumpForSigQuit(os);
+  if (lock_contention_profile_ != nullptr) {
+    lock_contention_profile_->DumpForSigQuit(os);
+  }
   os << "\n";
 
   BaseMutex::DumpAll(os);
@@ -3051,6 +3135,20 @@ bool Runtime::IsVerificationSoftFail() const {
   return verify_ == verifier::VerifyMode::kSoftFail;
 }
 
+uint32_t Runtime::GetFastNativeMethodAccessFlags(const DexFile& dex_file,
+                                                 uint32_t method_idx,
+                                                 uint32_t access_flags) const {
+  DCHECK_NE(access_flags & kAccNative, 0u);
+  if (fast_native_methods_.empty() || (access_flags & kAccSynchronized) != 0u) {
+    return 0u;
+  }
+  const dex::MethodId& method_id = dex_file.GetMethodId(method_idx);
+  std::string method = std::string(dex_file.GetMethodDeclaringClassDescriptorView(method_id)) +
+                       "->" + std::string(dex_file.GetMethodNameView(method_id)) +
+                       dex_file.GetMethodSignature(method_id).ToString();
+  return fast_native_methods_.find(method) != fast_native_methods_.end() ? kAccFastNative : 0u;
+}
+
 bool Runtime::IsAsyncDeoptimizeable(ArtMethod* method, uintptr_t code) const {
   if (OatQuickMethodHeader::NterpMethodHeader != nullptr) {
     if (OatQuickMethodHeader::NterpMethodHeader->Contains(code)) {
@@ -3131,6 +3229,14 @@ void Runtime::UpdateProcessState(ProcessState process_state) {
   ProcessState old_process_state = process_state_;
   process_state_ = process_state;
   GetHeap()->UpdateProcessState(old_process_state, process_state);
+  UpdateBackgroundThreadAffinity();
+}
+
+void Runtime::UpdateBackgroundThreadAffinity() {
+  if (background_thread_affinity_ != nullptr) {
+    // Background threads help the app start quickly, and must not slow down a foreground app.
+    background_thread_affinity_->Apply(!InJankPerceptibleProcessState() && GetStartupCompleted());
+  }
 }
 
 void Runtime::RegisterSensitiveThread() const {
@@ -3310,6 +3416,7 @@ bool Runtime::NotifyStartupCompleted() {
   VLOG(startup) << app_info_;
 
   ProfileSaver::NotifyStartupCompleted();
+  UpdateBackgroundThreadAffinity();
 
   if (metrics_reporter_ != nullptr) {
     metrics_reporter_->NotifyStartupCompleted();
@@ -25,6 +25,7 @@
 #include <optional>
 #include <set>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -93,6 +94,7 @@ enum class VerifyMode : int8_t;
 }  // namespace verifier
 class ArenaPool;
 class ArtMethod;
+class BackgroundThreadAffinity;
 enum class CalleeSaveType: uint32_t;
 class ClassLinker;
 class CompilerCallbacks;
@@ -103,6 +105,7 @@ class InternTable;
 class IsMarkedVisitor;
 class JavaVMExt;
 class LinearAlloc;
+class LockContentionProfile;
 class MonitorList;
 class MonitorPool;
 class NullPointerHandler;
@@ -387,6 +390,11 @@ class Runtime {
     return jni_id_manager_.get();
   }
 
+  // Returns the monitor contention profile, or null if -Xlockcontentionprofile was not passed.
+  LockContentionProfile* GetLockContentionProfile() const {
+    return lock_contention_profile_.get();
+  }
+
   size_t GetDefaultStackSize() const {
     return default_stack_size_;
   }
@@ -890,6 +898,10 @@ class Runtime {
 
   EXPORT void UpdateProcessState(ProcessState process_state);
 
+  // Restrict the background threads selected with -Xbackground-thread-affinity to efficiency
+  // cores once startup has completed, while the process is not jank-perceptible.
+  void UpdateBackgroundThreadAffinity();
+
   // Returns true if we currently care about long mutator pause.
   bool InJankPerceptibleProcessState() const {
     return process_state_ == kProcessStateJankPerceptible;
@@ -994,6 +1006,46 @@ class Runtime {
     return verifier_logging_threshold_ms_;
   }
 
+  // Number of threads verifying secondary dex files loaded without a vdex in the background.
+  uint32_t GetBackgroundVerificationThreads() const {
+    return background_verification_threads_;
+  }
+
+  // File to which the boot image classes dirtied during startup are appended, if not empty.
+  const std::string& GetDirtyImageObjectsSampleFile() const {
+    return dirty_image_objects_sample_file_;
+  }
+
+  // File to which the startup timeline is written at the end of `Start()`, if not empty.
+  const std::string& GetStartupTimelineFile() const {
+    return startup_timeline_file_;
+  }
+
+  // File to which executed methods are written on SIGUSR1, if not empty. See `MethodCoverage`.
+  const std::string& GetMethodCoverageFile() const {
+    return method_coverage_file_;
+  }
+
+  // Period after startup completion with which memory left unused is released, 0 if disabled.
+  uint32_t GetColdMemoryReleasePeriodMs() const {
+    return cold_memory_release_period_ms_;
+  }
+
+  // Whether a JVMTI agent attached to a running non-debuggable runtime keeps the compiled code
+  // until it first needs deoptimization, instead of switching to debuggable on attach.
+  bool IsJvmtiLightAttach() const {
+    return jvmti_light_attach_;
+  }
+
+  // Returns `kAccFastNative` if the native method `method_idx` is listed in the file passed
+  // with -Xfast-native-methods-file and is not synchronized, 0 otherwise. The list lets leaf
+  // natives that cannot be annotated use the @FastNative transitions. dex2oat must be given
+  // the same list (as a runtime argument) as the runtime that uses its output, so that the
+  // compiled JNI stubs agree with the access flags set by the class linker.
+  uint32_t GetFastNativeMethodAccessFlags(const DexFile& dex_file,
+                                          uint32_t method_idx,
+                                          uint32_t access_flags) const;
+
   // Atomically delete the thread pool if the reference count is 0.
   bool DeleteThreadPool() REQUIRES(!Locks::runtime_thread_pool_lock_);
 
@@ -1059,6 +1111,11 @@ class Runtime {
     return perfetto_javaheapprof_enabled_;
   }
 
+  // Returns the sampling interval of the allocation site profiler, or 0 if it is disabled.
+  size_t GetAllocationSiteProfilingInterval() const {
+    return allocation_site_profiling_interval_;
+  }
+
   bool IsMonitorTimeoutEnabled() const {
     return monitor_timeout_enable_;
   }
@@ -1280,6 +1337,10 @@ class Runtime {
 
   std::unique_ptr<jni::JniIdManager> jni_id_manager_;
 
+  std::unique_ptr<LockContentionProfile> lock_contention_profile_;
+
+  std::unique_ptr<BackgroundThreadAffinity> background_thread_affinity_;
+
   std::unique_ptr<JavaVMExt> java_vm_;
 
   std::unique_ptr<jit::Jit> jit_;
@@ -1525,6 +1586,21 @@ class Runtime {
 
   uint32_t verifier_logging_threshold_ms_;
 
+  uint32_t background_verification_threads_ = 1u;
+
+  std::string dirty_image_objects_sample_file_;
+
+  std::string startup_timeline_file_;
+
+  std::string method_coverage_file_;
+
+  uint32_t cold_memory_release_period_ms_ = 0u;
+
+  bool jvmti_light_attach_ = false;
+
+  // Native methods promoted to @FastNative, in the "Lpkg/Cls;->name(sig)" profile format.
+  std::unordered_set<std::string> fast_native_methods_;
+
   bool load_app_image_startup_cache_ = false;
 
   // If startup has completed, must happen at most once.
@@ -1534,6 +1610,7 @@ class Runtime {
   bool force_java_zygote_fork_loop_;
   bool perfetto_hprof_enabled_;
   bool perfetto_javaheapprof_enabled_;
+  size_t allocation_site_profiling_interval_;
 
   // Called on out of memory error
   void (*out_of_memory_error_hook_)();
@@ -17,6 +17,7 @@
 #include "runtime_image.h"
 
 #include <lz4.h>
+#include <sys/resource.h>
 #include <unistd.h>
 
 #include "android-base/file.h"
@@ -1867,6 +1868,35 @@ static bool EnsureDirectoryExists(const std::string& directory, std::string* err
   return true;
 }
 
+// Nice value used while compressing and writing the image. The image is only
+// an optimization for the next run of the app, so it should not compete with
+// the app threads that are still finishing startup.
+static constexpr int kRuntimeImageWriterNiceValue = 10;
+
+// Lowers the priority of the current thread for the duration of the scope.
+class ScopedBackgroundPriority {
+ public:
+  ScopedBackgroundPriority() {
+    errno = 0;
+    old_priority_ = getpriority(PRIO_PROCESS, /* this thread */ 0);
+    changed_ = (errno == 0) &&
+        (old_priority_ < kRuntimeImageWriterNiceValue) &&
+        (setpriority(PRIO_PROCESS, /* this thread */ 0, kRuntimeImageWriterNiceValue) == 0);
+  }
+
+  ~ScopedBackgroundPriority() {
+    if (changed_ && setpriority(PRIO_PROCESS, /* this thread */ 0, old_priority_) != 0) {
+      PLOG(WARNING) << "Failed to restore thread priority to " << old_priority_;
+    }
+  }
+
+ private:
+  int old_priority_;
+  bool changed_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedBackgroundPriority);
+};
+
 bool RuntimeImage::WriteImageToDisk(std::string* error_msg) {
   gc::Heap* heap = Runtime::Current()->GetHeap();
   if (!heap->HasBootImageSpace()) {
@@ -1885,6 +1915,9 @@ bool RuntimeImage::WriteImageToDisk(std::string* error_msg) {
   }
 
   ScopedTrace write_image_trace("Writing runtime image to disk");
+  // Compression and I/O do not need the mutator lock and dominate the cost of
+  // writing the image, so do them at background priority.
+  ScopedBackgroundPriority background_priority;
 
   const std::string path = GetRuntimeImagePath(image->GetDexLocation());
   if (!EnsureDirectoryExists(android::base::Dirname(path), error_msg)) {
@@ -39,6 +39,7 @@
 #include "class_linker.h"
 #include "gc/heap.h"
 #include "jit/profile_saver.h"
+#include "method_coverage.h"
 #include "palette/palette.h"
 #include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
@@ -155,6 +156,15 @@ void SignalCatcher::HandleSigUsr1() {
   LOG(INFO) << "SIGUSR1 forcing GC (no HPROF) and profile save";
   Runtime::Current()->GetHeap()->CollectGarbage(/* clear_soft_references= */ false);
   ProfileSaver::ForceProcessProfiles();
+  const std::string& coverage_file = Runtime::Current()->GetMethodCoverageFile();
+  if (!coverage_file.empty()) {
+    std::string error_msg;
+    if (MethodCoverage::Dump(coverage_file, &error_msg)) {
+      LOG(INFO) << "Wrote method coverage to " << coverage_file;
+    } else {
+      LOG(WARNING) << "Could not dump method coverage: " << error_msg;
+    }
+  }
 }
 
 int SignalCatcher::WaitForSignal(Thread* self, SignalSet& signals) {
@@ -73,7 +73,8 @@ StackVisitor::StackVisitor(Thread* thread,
       cur_oat_quick_method_header_(nullptr),
       num_frames_(num_frames),
       cur_depth_(0),
-      cur_inline_info_(nullptr, CodeInfo()),
+      cached_inline_infos_(),
+      cur_inline_info_index_(0u),
       cur_stack_map_(0, StackMap()),
       context_(context),
       check_suspended_(check_suspended) {
@@ -85,10 +86,18 @@ StackVisitor::StackVisitor(Thread* thread,
 CodeInfo* StackVisitor::GetCurrentInlineInfo() const {
   DCHECK(!(*cur_quick_frame_)->IsNative());
   const OatQuickMethodHeader* header = GetCurrentOatQuickMethodHeader();
-  if (cur_inline_info_.first != header) {
-    cur_inline_info_ = std::make_pair(header, CodeInfo::DecodeInlineInfoOnly(header));
+  if (cached_inline_infos_[cur_inline_info_index_].first != header) {
+    static_assert(kNumCachedInlineInfos == 2u);
+    size_t other_index = cur_inline_info_index_ ^ 1u;
+    if (cached_inline_infos_[other_index].first != header) {
+      // Replace the least recently used entry. The cached stack map may refer to it.
+      cached_inline_infos_[other_index] =
+          std::make_pair(header, CodeInfo::DecodeInlineInfoOnly(header));
+      cur_stack_map_.first = 0u;
+    }
+    cur_inline_info_index_ = other_index;
   }
-  return &cur_inline_info_.second;
+  return &cached_inline_infos_[cur_inline_info_index_].second;
 }
 
 StackMap* StackVisitor::GetCurrentStackMap() const {
@@ -19,6 +19,7 @@
 
 #include <stdint.h>
 
+#include <array>
 #include <optional>
 #include <string>
 
@@ -398,10 +399,16 @@ class StackVisitor {
   // We keep poping frames from the end as we visit the frames.
   BitTableRange<InlineInfo> current_inline_frames_;
 
-  // Cache the most recently decoded inline info data.
+  // Cache the most recently decoded inline info data, for the last few method headers so that
+  // mutually recursive methods do not decode their code info again for every frame. Entries
+  // are replaced least recently used first. The cache only lives for one walk, as compiled
+  // code can be freed between walks.
   // The 'current_inline_frames_' refers to this data, so we need to keep it alive anyway.
   // Marked mutable since the cache fields are updated from const getters.
-  mutable std::pair<const OatQuickMethodHeader*, CodeInfo> cur_inline_info_;
+  static constexpr size_t kNumCachedInlineInfos = 2u;
+  mutable std::array<std::pair<const OatQuickMethodHeader*, CodeInfo>, kNumCachedInlineInfos>
+      cached_inline_infos_;
+  mutable size_t cur_inline_info_index_;
   mutable std::pair<uintptr_t, StackMap> cur_stack_map_;
 
   uint8_t* GetShouldDeoptimizeFlagAddr() const REQUIRES_SHARED(Locks::mutator_lock_);
@@ -16,7 +16,19 @@
 
 #include "startup_completed_task.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <optional>
+#include <set>
+#include <string>
+
+#include "android-base/stringprintf.h"
+
 #include "base/systrace.h"
+#include "base/time_utils.h"
+#include "base/unix_file/fd_file.h"
+#include "base/utils.h"
 #include "class_linker.h"
 #include "gc/heap.h"
 #include "gc/scoped_gc_critical_section.h"
@@ -27,6 +39,7 @@
 #include "mirror/dex_cache.h"
 #include "mirror/object-inl.h"
 #include "obj_ptr.h"
+#include "runtime.h"
 #include "runtime_image.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread.h"
@@ -34,6 +47,8 @@
 
 namespace art HIDDEN {
 
+using android::base::StringPrintf;
+
 class UnlinkStartupDexCacheVisitor : public DexCacheVisitor {
  public:
   UnlinkStartupDexCacheVisitor() {}
@@ -44,9 +59,49 @@ class UnlinkStartupDexCacheVisitor : public DexCacheVisitor {
   }
 };
 
+// Append the boot image classes dirtied by this process during startup to the
+// sample file, in the format of dex2oat's --dirty-image-objects. Merging the
+// samples of many processes gives the frequency with which each class is dirty.
+static void SampleDirtyImageObjects(Thread* self, const std::string& sample_file) {
+  ScopedTrace trace("Sample dirty image objects");
+  std::set<std::string> descriptors;
+  size_t num_dirty_objects = 0u;
+  {
+    ScopedObjectAccess soa(self);
+    for (gc::space::ImageSpace* space : Runtime::Current()->GetHeap()->GetBootImageSpaces()) {
+      std::string error_msg;
+      std::optional<size_t> num_space_dirty_objects =
+          space->CollectDirtyClasses(&descriptors, &error_msg);
+      if (!num_space_dirty_objects.has_value()) {
+        LOG(WARNING) << "Could not sample dirty image objects: " << error_msg;
+        return;
+      }
+      num_dirty_objects += num_space_dirty_objects.value();
+    }
+  }
+
+  std::string contents = StringPrintf("# %s (pid %d): %zu dirty objects, %zu dirty classes\n",
+                                      Runtime::Current()->GetProcessPackageName().c_str(),
+                                      getpid(),
+                                      num_dirty_objects,
+                                      descriptors.size());
+  for (const std::string& descriptor : descriptors) {
+    contents += descriptor;
+    contents += '\n';
+  }
+  File file(sample_file, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, /*check_usage=*/ false);
+  if (!file.IsOpened() || !file.WriteFully(contents.data(), contents.size())) {
+    PLOG(WARNING) << "Could not write dirty image objects to " << sample_file;
+  }
+}
+
 void StartupCompletedTask::Run(Thread* self) {
   Runtime* const runtime = Runtime::Current();
   if (runtime->NotifyStartupCompleted()) {
+    if (!runtime->GetDirtyImageObjectsSampleFile().empty()) {
+      SampleDirtyImageObjects(self, runtime->GetDirtyImageObjectsSampleFile());
+    }
+
     // Maybe generate a runtime app image. If the runtime is debuggable, boot
     // classpath classes can be dynamically changed, so don't bother generating an
     // image.
@@ -66,8 +121,11 @@ void StartupCompletedTask::Run(Thread* self) {
       }
     }
 
-    ScopedObjectAccess soa(self);
-    DeleteStartupDexCaches(self, /* called_by_gc= */ false);
+    {
+      ScopedObjectAccess soa(self);
+      DeleteStartupDexCaches(self, /* called_by_gc= */ false);
+    }
+    ColdMemoryReleaseTask::Schedule();
   }
 
   // Delete the thread pool used for app image loading since startup is assumed to be completed.
@@ -128,21 +186,52 @@ void StartupCompletedTask::DeleteStartupDexCaches(Thread* self, bool called_by_g
 
   // At this point, we know no other thread can see the arrays, nor the GC. So
   // we can safely release them.
+  size_t released_bytes = 0u;
   for (gc::space::ContinuousSpace* space : runtime->GetHeap()->GetContinuousSpaces()) {
     if (space->IsImageSpace()) {
       gc::space::ImageSpace* image_space = space->AsImageSpace();
       if (image_space->GetImageHeader().IsAppImage()) {
-        image_space->ReleaseMetadata();
+        released_bytes += image_space->ReleaseMetadata();
       }
     }
   }
 
   if (startup_linear_alloc != nullptr) {
     ScopedTrace trace2("Delete startup linear alloc");
+    released_bytes += startup_linear_alloc->GetUsedMemory();
     ArenaPool* arena_pool = startup_linear_alloc->GetArenaPool();
     startup_linear_alloc.reset();
     arena_pool->TrimMaps();
   }
+  VLOG(startup) << "Released " << PrettySize(released_bytes) << " of startup memory";
+  runtime->GetMetrics()->StartupReleasedBytes()->Add(released_bytes);
+}
+
+void ColdMemoryReleaseTask::Run(Thread* self) {
+  size_t released_bytes;
+  {
+    ScopedTrace trace("Release cold memory");
+    ScopedObjectAccess soa(self);
+    released_bytes = Runtime::Current()->GetClassLinker()->ReleaseColdLinearAllocPages(self);
+  }
+  if (released_bytes != 0u) {
+    VLOG(startup) << "Released " << PrettySize(released_bytes) << " of cold memory";
+    Runtime::Current()->GetMetrics()->ColdMemoryReleasedBytes()->Add(released_bytes);
+  }
+  Schedule();
+}
+
+void ColdMemoryReleaseTask::Schedule() {
+  Runtime* const runtime = Runtime::Current();
+  uint32_t period_ms = runtime->GetColdMemoryReleasePeriodMs();
+  if (period_ms == 0u) {
+    return;
+  }
+  ColdMemoryReleaseTask* task = new ColdMemoryReleaseTask(NanoTime() + MsToNs(period_ms));
+  if (!runtime->GetHeap()->AddHeapTask(task)) {
+    // The runtime is shutting down.
+    delete task;
+  }
 }
 
 }  // namespace art
@@ -33,6 +33,18 @@ class StartupCompletedTask : public gc::HeapTask {
       REQUIRES_SHARED(Locks::mutator_lock_);
 };
 
+// Releases, every -Xcold-memory-release-period-ms once startup has completed, the memory that
+// stayed unused for a whole period. Only free-listed LinearAlloc blocks are tracked for now.
+class ColdMemoryReleaseTask : public gc::HeapTask {
+ public:
+  explicit ColdMemoryReleaseTask(uint64_t target_run_time) : gc::HeapTask(target_run_time) {}
+
+  void Run(Thread* self) override;
+
+  // Schedule the next release if the period is not zero.
+  static void Schedule();
+};
+
 }  // namespace art
 
 #endif  // ART_RUNTIME_STARTUP_COMPLETED_TASK_H_
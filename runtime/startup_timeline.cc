@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "startup_timeline.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+
+#include "android-base/stringprintf.h"
+#include "base/time_utils.h"
+#include "base/unix_file/fd_file.h"
+#include "base/utils.h"
+
+namespace art HIDDEN {
+
+using android::base::StringPrintf;
+
+std::atomic<size_t> StartupTimeline::num_phases_(0u);
+StartupTimeline::Phase StartupTimeline::phases_[StartupTimeline::kMaxPhases];
+
+StartupTimeline::ScopedPhase::ScopedPhase(const char* name)
+    : trace_(name), name_(name), start_us_(MicroTime()) {}
+
+StartupTimeline::ScopedPhase::~ScopedPhase() {
+  Record(name_, start_us_, MicroTime());
+}
+
+void StartupTimeline::Record(const char* name, uint64_t start_us, uint64_t end_us) {
+  size_t index = num_phases_.fetch_add(1u, std::memory_order_relaxed);
+  if (index >= kMaxPhases) {
+    return;
+  }
+  phases_[index] = Phase{name, static_cast<pid_t>(GetTid()), start_us, end_us};
+}
+
+std::string StartupTimeline::ToJson() {
+  size_t num_phases = std::min(num_phases_.load(std::memory_order_relaxed), kMaxPhases);
+  pid_t pid = getpid();
+  std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (size_t i = 0; i != num_phases; ++i) {
+    const Phase& phase = phases_[i];
+    json += StringPrintf("%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,"
+                         "\"ts\":%" PRIu64 ",\"dur\":%" PRIu64 "}",
+                         (i == 0u) ? "" : ",",
+                         phase.name,
+                         pid,
+                         phase.tid,
+                         phase.start_us,
+                         phase.end_us - phase.start_us);
+  }
+  json += "\n]}\n";
+  return json;
+}
+
+void StartupTimeline::ResetForTesting() {
+  num_phases_.store(0u, std::memory_order_relaxed);
+}
+
+bool StartupTimeline::Dump(const std::string& filename, std::string* error_msg) {
+  std::string json = ToJson();
+  File file(filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, /*check_usage=*/ false);
+  if (!file.IsOpened()) {
+    *error_msg = StringPrintf("Could not open %s: %s", filename.c_str(), strerror(errno));
+    return false;
+  }
+  if (!file.WriteFully(json.data(), json.size())) {
+    *error_msg = StringPrintf("Could not write %s: %s", filename.c_str(), strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+}  // namespace art
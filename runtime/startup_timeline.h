@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_STARTUP_TIMELINE_H_
+#define ART_RUNTIME_STARTUP_TIMELINE_H_
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "base/macros.h"
+#include "base/systrace.h"
+
+namespace art HIDDEN {
+
+// Records the start and end time of the main phases of runtime initialization, so that
+// they can be dumped as a timeline once the runtime has started. Unlike systrace sections,
+// the phases are always recorded and do not need a tracing session to be active.
+class StartupTimeline {
+ public:
+  // Records a phase for the lifetime of the object, and emits the matching systrace section.
+  class ScopedPhase {
+   public:
+    explicit ScopedPhase(const char* name);
+    ~ScopedPhase();
+
+   private:
+    ScopedTrace trace_;
+    const char* const name_;
+    const uint64_t start_us_;
+
+    DISALLOW_COPY_AND_ASSIGN(ScopedPhase);
+  };
+
+  // Records a phase of the current thread. `name` must have static storage duration.
+  // Phases past the capacity of the timeline are dropped.
+  static void Record(const char* name, uint64_t start_us, uint64_t end_us);
+
+  // Writes the recorded phases to `filename` in the JSON trace event format, which
+  // Perfetto and chrome://tracing can load.
+  static bool Dump(const std::string& filename, std::string* error_msg);
+
+  // Returns the recorded phases in the JSON trace event format.
+  static std::string ToJson();
+
+  // Drops all recorded phases.
+  static void ResetForTesting();
+
+ private:
+  struct Phase {
+    const char* name;
+    pid_t tid;
+    uint64_t start_us;
+    uint64_t end_us;
+  };
+
+  static constexpr size_t kMaxPhases = 128u;
+
+  static std::atomic<size_t> num_phases_;
+  static Phase phases_[kMaxPhases];
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_STARTUP_TIMELINE_H_
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "startup_timeline.h"
+
+#include <string>
+
+#include "android-base/file.h"
+#include "common_runtime_test.h"
+
+namespace art HIDDEN {
+
+class StartupTimelineTest : public CommonRuntimeTest {
+ protected:
+  void SetUp() override {
+    // Runtimes created by earlier tests in the same process may have filled the timeline.
+    StartupTimeline::ResetForTesting();
+    CommonRuntimeTest::SetUp();
+  }
+};
+
+TEST_F(StartupTimelineTest, RecordsRuntimePhases) {
+  // Creating the runtime for the test goes through `Runtime::Init()`.
+  std::string json = StartupTimeline::ToJson();
+  EXPECT_NE(json.find("\"name\":\"Runtime::Init\""), std::string::npos) << json;
+  EXPECT_NE(json.find("\"name\":\"CreateHeap\""), std::string::npos) << json;
+  EXPECT_NE(json.find("\"name\":\"InitClassLinker\""), std::string::npos) << json;
+}
+
+TEST_F(StartupTimelineTest, Dump) {
+  StartupTimeline::ResetForTesting();
+  StartupTimeline::Record("StartupTimelineTestPhase", 1000u, 1500u);
+
+  ScratchFile file;
+  std::string error_msg;
+  ASSERT_TRUE(StartupTimeline::Dump(file.GetFilename(), &error_msg)) << error_msg;
+
+  std::string contents;
+  ASSERT_TRUE(android::base::ReadFileToString(file.GetFilename(), &contents));
+  EXPECT_EQ(contents.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0u), 0u) << contents;
+  EXPECT_NE(contents.find("\"name\":\"StartupTimelineTestPhase\",\"ph\":\"X\""), std::string::npos)
+      << contents;
+  EXPECT_NE(contents.find("\"ts\":1000,\"dur\":500}"), std::string::npos) << contents;
+}
+
+}  // namespace art
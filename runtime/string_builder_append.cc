@@ -77,6 +77,12 @@ class StringBuilderAppend::Builder {
                                 CharType* data,
                                 ObjPtr<mirror::String> str) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  template <typename CharType>
+  static CharType* AppendCharArray(ObjPtr<mirror::String> new_string,
+                                   CharType* data,
+                                   ObjPtr<mirror::CharArray> array)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   template <typename CharType>
   static CharType* AppendInt64(ObjPtr<mirror::String> new_string,
                                CharType* data,
@@ -210,6 +216,21 @@ inline CharType* StringBuilderAppend::Builder::AppendString(ObjPtr<mirror::Strin
   return data + length;
 }
 
+template <typename CharType>
+inline CharType* StringBuilderAppend::Builder::AppendCharArray(ObjPtr<mirror::String> new_string,
+                                                               CharType* data,
+                                                               ObjPtr<mirror::CharArray> array) {
+  size_t length = dchecked_integral_cast<size_t>(array->GetLength());
+  DCHECK_LE(length, RemainingSpace(new_string, data));
+  // Like `String(char[])`, a concurrent modification of the array between the compression
+  // check and this copy can produce truncated chars but never writes out of bounds.
+  const uint16_t* value = array->GetData();
+  for (size_t i = 0; i != length; ++i) {
+    data[i] = static_cast<CharType>(value[i]);
+  }
+  return data + length;
+}
+
 template <typename CharType>
 inline CharType* StringBuilderAppend::Builder::AppendInt64(ObjPtr<mirror::String> new_string,
                                                            CharType* data,
@@ -244,6 +265,7 @@ int32_t StringBuilderAppend::Builder::ConvertFpArgs() {
     ObjPtr<mirror::Object> converter;
     switch (static_cast<Argument>(f & kArgMask)) {
       case Argument::kString:
+      case Argument::kCharArray:
       case Argument::kBoolean:
       case Argument::kChar:
       case Argument::kInt:
@@ -271,7 +293,6 @@ int32_t StringBuilderAppend::Builder::ConvertFpArgs() {
         break;
       }
       case Argument::kStringBuilder:
-      case Argument::kCharArray:
       case Argument::kObject:
         LOG(FATAL) << "Unimplemented arg format: 0x" << std::hex
             << (f & kArgMask) << " full format: 0x" << std::hex << format_;
@@ -354,6 +375,16 @@ inline int32_t StringBuilderAppend::Builder::CalculateLengthWithFlag() {
         }
         break;
       }
+      case Argument::kCharArray: {
+        // The compiler fuses `append(char[])` only for arguments known to be non-null.
+        Handle<mirror::CharArray> array =
+            hs_.NewHandle(reinterpret_cast32<mirror::CharArray*>(*current_arg));
+        DCHECK(array != nullptr);
+        length += array->GetLength();
+        compressible = compressible &&
+            mirror::String::AllASCII(array->GetData(), array->GetLength());
+        break;
+      }
       case Argument::kBoolean: {
         length += (*current_arg != 0u) ? kTrueLength : kFalseLength;
         break;
@@ -385,7 +416,6 @@ inline int32_t StringBuilderAppend::Builder::CalculateLengthWithFlag() {
         break;
 
       case Argument::kStringBuilder:
-      case Argument::kCharArray:
       case Argument::kObject:
         LOG(FATAL) << "Unimplemented arg format: 0x" << std::hex
             << (f & kArgMask) << " full format: 0x" << std::hex << format_;
@@ -440,6 +470,14 @@ inline void StringBuilderAppend::Builder::StoreData(ObjPtr<mirror::String> new_s
         }
         break;
       }
+      case Argument::kCharArray: {
+        DCHECK_LT(handle_index, hs_.Size());
+        ObjPtr<mirror::CharArray> array =
+            ObjPtr<mirror::CharArray>::DownCast(hs_.GetReference(handle_index));
+        ++handle_index;
+        data = AppendCharArray(new_string, data, array);
+        break;
+      }
       case Argument::kBoolean: {
         if (*current_arg != 0u) {
           data = AppendLiteral(new_string, data, kTrue);
@@ -475,7 +513,7 @@ inline void StringBuilderAppend::Builder::StoreData(ObjPtr<mirror::String> new_s
       }
 
       case Argument::kStringBuilder:
-      case Argument::kCharArray:
+      case Argument::kObject:
         LOG(FATAL) << "Unimplemented arg format: 0x" << std::hex
             << (f & kArgMask) << " full format: 0x" << std::hex << format_;
         UNREACHABLE();
@@ -76,6 +76,7 @@
 #include "interpreter/interpreter.h"
 #include "interpreter/shadow_frame-inl.h"
 #include "java_frame_root_info.h"
+#include "javaheapprof/allocation_site_profiler.h"
 #include "jni/java_vm_ext.h"
 #include "jni/jni_internal.h"
 #include "mirror/class-alloc-inl.h"
@@ -86,6 +87,7 @@
 #include "mirror/stack_trace_element.h"
 #include "monitor.h"
 #include "monitor_objects_stack_visitor.h"
+#include "monitor_pool.h"
 #include "native_stack_dump.h"
 #include "nativehelper/scoped_local_ref.h"
 #include "nativehelper/scoped_utf_chars.h"
@@ -1496,6 +1498,7 @@ bool Thread::PassActiveSuspendBarriers() {
   std::vector<AtomicInteger*> pass_barriers{};
   {
     MutexLock mu(this, *Locks::thread_suspend_count_lock_);
+    AtomicInteger* suspendall_barrier = tlsPtr_.active_suspendall_barrier;
     if (!ReadFlag(ThreadFlag::kActiveSuspendBarrier)) {
       // Quick exit test: The barriers have already been claimed - this is possible as there may
       // be a race to claim and it doesn't matter who wins.  All of the callers of this function
@@ -1522,6 +1525,11 @@ bool Thread::PassActiveSuspendBarriers() {
     // remove and deallocate suspend barriers while holding suspend_count_lock_ .
     // There will typically only be a single barrier to pass here.
     for (AtomicInteger*& barrier : pass_barriers) {
+      if (barrier == suspendall_barrier) {
+        // Note ourselves before decrementing so that the SuspendAll thread sees it once it observes
+        // the barrier reaching zero.
+        Runtime::Current()->GetThreadList()->SetLastSuspendedThread(GetTid());
+      }
       int32_t old_val = barrier->fetch_sub(1, std::memory_order_release);
       CHECK_GT(old_val, 0) << "Unexpected value for PassActiveSuspendBarriers(): " << old_val;
       if (old_val != 1) {
@@ -2695,6 +2703,15 @@ Thread::~Thread() {
   SetCachedThreadName(nullptr);  // Deallocate name.
   delete tlsPtr_.deps_or_stack_trace_sample.stack_trace_sample;
 
+  if (tlsPtr_.allocation_site_table != nullptr) {
+    // The thread is no longer in the thread list, so dumps cannot be reading its table.
+    Runtime::Current()->GetHeap()->GetAllocationSiteProfiler()->RetireThread(this);
+  }
+
+  if (tlsPtr_.monitor_cache != nullptr) {
+    MonitorPool::RevokeThreadLocalMonitors(Thread::Current(), this);
+  }
+
   CHECK_EQ(tlsPtr_.method_trace_buffer, nullptr);
 
   Runtime::Current()->GetHeap()->AssertThreadLocalBuffersAreRevoked(this);
@@ -2908,7 +2925,7 @@ using ArtMethodDexPcPair = std::pair<ArtMethod*, uint32_t>;
 class FetchStackTraceVisitor : public StackVisitor {
  public:
   explicit FetchStackTraceVisitor(Thread* thread,
-                                  ArtMethodDexPcPair* saved_frames = nullptr,
+                                  std::vector<ArtMethodDexPcPair>* saved_frames = nullptr,
                                   size_t max_saved_frames = 0)
       REQUIRES_SHARED(Locks::mutator_lock_)
       : StackVisitor(thread, nullptr, StackVisitor::StackWalkKind::kIncludeInlinedFrames),
@@ -2927,8 +2944,8 @@ class FetchStackTraceVisitor : public StackVisitor {
     if (!skipping_) {
       if (!m->IsRuntimeMethod()) {  // Ignore runtime frames (in particular callee save).
         if (depth_ < max_saved_frames_) {
-          saved_frames_[depth_].first = m;
-          saved_frames_[depth_].second = m->IsProxyMethod() ? dex::kDexNoIndex : GetDexPc();
+          DCHECK_EQ(saved_frames_->size(), depth_);
+          saved_frames_->emplace_back(m, m->IsProxyMethod() ? dex::kDexNoIndex : GetDexPc());
         }
         ++depth_;
       }
@@ -2950,7 +2967,7 @@ class FetchStackTraceVisitor : public StackVisitor {
   uint32_t depth_ = 0;
   uint32_t skip_depth_ = 0;
   bool skipping_ = true;
-  ArtMethodDexPcPair* saved_frames_;
+  std::vector<ArtMethodDexPcPair>* saved_frames_;
   const size_t max_saved_frames_;
 
   DISALLOW_COPY_AND_ASSIGN(FetchStackTraceVisitor);
@@ -3072,10 +3089,14 @@ class BuildInternalStackTraceVisitor : public StackVisitor {
 
 jobject Thread::CreateInternalStackTrace(const ScopedObjectAccessAlreadyRunnable& soa) const {
   // Compute depth of stack, save frames if possible to avoid needing to recompute many.
-  constexpr size_t kMaxSavedFrames = 256;
-  std::unique_ptr<ArtMethodDexPcPair[]> saved_frames(new ArtMethodDexPcPair[kMaxSavedFrames]);
+  // The saved frames grow as needed, so that deep stacks (common with frameworks) are walked
+  // only once, up to a bound that keeps the memory used for very deep recursions in check.
+  constexpr size_t kInitialSavedFrames = 256;
+  constexpr size_t kMaxSavedFrames = 16 * KB;
+  std::vector<ArtMethodDexPcPair> saved_frames;
+  saved_frames.reserve(kInitialSavedFrames);
   FetchStackTraceVisitor count_visitor(const_cast<Thread*>(this),
-                                       &saved_frames[0],
+                                       &saved_frames,
                                        kMaxSavedFrames);
   count_visitor.WalkStack();
   const uint32_t depth = count_visitor.GetDepth();
@@ -3089,7 +3110,8 @@ jobject Thread::CreateInternalStackTrace(const ScopedObjectAccessAlreadyRunnable
   }
   // If we saved all of the frames we don't even need to do the actual stack walk. This is faster
   // than doing the stack walk twice.
-  if (depth < kMaxSavedFrames) {
+  if (depth <= kMaxSavedFrames) {
+    DCHECK_EQ(saved_frames.size(), depth);
     for (size_t i = 0; i < depth; ++i) {
       build_trace_visitor.AddFrame(saved_frames[i].first, saved_frames[i].second);
     }
@@ -4558,6 +4580,17 @@ void Thread::SweepInterpreterCache(IsMarkedVisitor* visitor) {
   for (InterpreterCache::Entry& entry : GetInterpreterCache()->GetArray()) {
     SweepCacheEntry(visitor, reinterpret_cast<const Instruction*>(entry.first), &entry.second);
   }
+  for (CatchHandlerCache::Entry& entry : GetCatchHandlerCache()->GetArray()) {
+    if (entry.dex_instruction == nullptr) {
+      continue;
+    }
+    mirror::Object* new_class = visitor->IsMarked(entry.exception_class);
+    if (new_class == nullptr) {
+      entry.dex_instruction = nullptr;
+    } else {
+      entry.exception_class = down_cast<mirror::Class*>(new_class);
+    }
+  }
 }
 
 // FIXME: clang-r433403 reports the below function exceeds frame size limit.
@@ -4812,6 +4845,7 @@ void Thread::ClearAllInterpreterCaches() {
   static struct ClearInterpreterCacheClosure : Closure {
     void Run(Thread* thread) override {
       thread->GetInterpreterCache()->Clear(thread);
+      thread->GetCatchHandlerCache()->Clear();
     }
   } closure;
   Runtime::Current()->GetThreadList()->RunCheckpoint(&closure);
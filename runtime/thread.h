@@ -33,6 +33,7 @@
 #include "base/pointer_size.h"
 #include "base/safe_map.h"
 #include "base/value_object.h"
+#include "catch_handler_cache.h"
 #include "entrypoints/jni/jni_entrypoints.h"
 #include "entrypoints/quick/quick_entrypoints.h"
 #include "handle.h"
@@ -86,6 +87,7 @@ namespace verifier {
 class VerifierDeps;
 }  // namespace verifier
 
+class AllocationSiteTable;
 class ArtMethod;
 class BaseMutex;
 class ClassLinker;
@@ -1428,6 +1430,26 @@ class EXPORT Thread {
   // to adjust to post-compact addresses.
   void AdjustTlab(size_t slide_bytes);
 
+  // Adaptive TLAB sizing state, see Heap::GetAdaptiveTlabSize(). Only accessed
+  // by the thread itself.
+  size_t GetTlabTargetSize() const {
+    return tlab_target_size_;
+  }
+  uint32_t GetTlabSizingGcNum() const {
+    return tlab_sizing_gc_num_;
+  }
+  size_t GetTlabBytesSinceGc() const {
+    return tlab_bytes_since_gc_;
+  }
+  void AddTlabBytesSinceGc(size_t bytes) {
+    tlab_bytes_since_gc_ += bytes;
+  }
+  void SetTlabTargetSize(size_t size, uint32_t gc_num) {
+    tlab_target_size_ = size;
+    tlab_sizing_gc_num_ = gc_num;
+    tlab_bytes_since_gc_ = 0;
+  }
+
   // Doesn't check that there is room.
   mirror::Object* AllocTlab(size_t bytes);
   void SetTlab(uint8_t* start, uint8_t* end, uint8_t* limit);
@@ -1484,6 +1506,41 @@ class EXPORT Thread {
     tlsPtr_.rosalloc_runs[index] = run;
   }
 
+  void* GetRosAllocMagazines() const {
+    return tlsPtr_.rosalloc_magazines;
+  }
+
+  void SetRosAllocMagazines(void* magazines) {
+    tlsPtr_.rosalloc_magazines = magazines;
+  }
+
+  AllocationSiteTable* GetAllocationSiteTable() const {
+    return tlsPtr_.allocation_site_table;
+  }
+
+  void SetAllocationSiteTable(AllocationSiteTable* table) {
+    tlsPtr_.allocation_site_table = table;
+  }
+
+  Monitor* GetMonitorCache() const {
+    return tlsPtr_.monitor_cache;
+  }
+
+  void SetMonitorCache(Monitor* monitors) {
+    tlsPtr_.monitor_cache = monitors;
+  }
+
+  // Only updated by the owning thread while the concurrent copying collector is marking.
+  void IncrementReadBarrierSlowPathCount() {
+    ++tlsPtr_.read_barrier_slow_path_count;
+  }
+
+  size_t GetAndResetReadBarrierSlowPathCount() {
+    size_t count = tlsPtr_.read_barrier_slow_path_count;
+    tlsPtr_.read_barrier_slow_path_count = 0u;
+    return count;
+  }
+
   bool ProtectStack(bool fatal_on_error = true);
   bool UnprotectStack();
 
@@ -1572,7 +1629,12 @@ class EXPORT Thread {
     return &interpreter_cache_;
   }
 
-  // Clear all thread-local interpreter caches.
+  CatchHandlerCache* GetCatchHandlerCache() {
+    return &catch_handler_cache_;
+  }
+
+  // Clear all thread-local interpreter caches, and the catch handler caches which are also
+  // keyed by dex instruction pointer.
   //
   // Since the caches are keyed by memory pointer to dex instructions, this must be
   // called when any dex code is unloaded (before different code gets loaded at the
@@ -2148,7 +2210,11 @@ class EXPORT Thread {
                                top_reflective_handle_scope(nullptr),
                                method_trace_buffer(nullptr),
                                method_trace_buffer_index(0),
-                               thread_exit_flags(nullptr) {
+                               thread_exit_flags(nullptr),
+                               rosalloc_magazines(nullptr),
+                               allocation_site_table(nullptr),
+                               monitor_cache(nullptr),
+                               read_barrier_slow_path_count(0u) {
       std::fill(held_mutexes, held_mutexes + kLockLevelCount, nullptr);
     }
 
@@ -2328,6 +2394,18 @@ class EXPORT Thread {
 
     // Pointer to the first node of an intrusively doubly-linked list of ThreadExitFlags.
     ThreadExitFlag* thread_exit_flags GUARDED_BY(Locks::thread_list_lock_);
+
+    // Per-thread caches of freed RosAlloc slots of the size brackets without thread-local runs.
+    void* rosalloc_magazines;
+
+    // Allocation sites sampled by the allocation site profiler on this thread.
+    AllocationSiteTable* allocation_site_table;
+
+    // Free monitors taken from the monitor pool, linked through Monitor::next_free_.
+    Monitor* monitor_cache;
+
+    // Number of read-barrier mark slow paths taken during the current GC cycle.
+    size_t read_barrier_slow_path_count;
   } tlsPtr_;
 
   // Small thread-local cache to be used from the interpreter.
@@ -2338,6 +2416,9 @@ class EXPORT Thread {
   // All fields below this line should not be accessed by native code. This means these fields can
   // be modified, rearranged, added or removed without having to modify asm_support.h
 
+  // Small thread-local cache of catch handler lookups, see `ArtMethod::FindCatchBlock()`.
+  CatchHandlerCache catch_handler_cache_;
+
   // Guards the 'wait_monitor_' members.
   Mutex* wait_mutex_ DEFAULT_MUTEX_ACQUIRED_AFTER;
 
@@ -2383,6 +2464,13 @@ class EXPORT Thread {
   // the caller is allowed to access all fields and methods in the Core Platform API.
   uint32_t core_platform_api_cookie_ = 0;
 
+  // TLAB size chosen by adaptive TLAB sizing, or 0 to use the heap's default.
+  size_t tlab_target_size_ = 0;
+  // Bytes taken for TLABs by this thread since `tlab_target_size_` was last adjusted.
+  size_t tlab_bytes_since_gc_ = 0;
+  // Value of Heap::GetCurrentGcNum() when `tlab_target_size_` was last adjusted.
+  uint32_t tlab_sizing_gc_num_ = 0;
+
   friend class gc::collector::SemiSpace;  // For getting stack traces.
   friend class Runtime;  // For CreatePeer.
   friend class QuickExceptionHandler;  // For dumping the stack.
@@ -23,6 +23,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <map>
 #include <sstream>
 #include <tuple>
@@ -30,6 +31,7 @@
 
 #include "android-base/stringprintf.h"
 #include "art_field-inl.h"
+#include "art_method-inl.h"
 #include "base/aborting.h"
 #include "base/histogram-inl.h"
 #include "base/mutex-inl.h"
@@ -50,6 +52,7 @@
 #include "obj_ptr-inl.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread.h"
+#include "thread_pool.h"
 #include "trace.h"
 #include "unwindstack/AndroidUnwinder.h"
 #include "well_known_classes.h"
@@ -73,6 +76,8 @@ ThreadList::ThreadList(uint64_t thread_suspend_timeout_ns)
     : suspend_all_count_(0),
       unregistering_count_(0),
       suspend_all_histogram_("suspend all histogram", 16, 64),
+      last_suspended_tid_(0),
+      slow_suspend_all_count_(0),
       long_suspend_(false),
       shut_down_(false),
       thread_suspend_timeout_ns_(thread_suspend_timeout_ns),
@@ -138,6 +143,19 @@ void ThreadList::DumpForSigQuit(std::ostream& os) {
       suspend_all_histogram_.CreateHistogram(&data);
       suspend_all_histogram_.PrintConfidenceIntervals(os, 0.99, data);  // Dump time to suspend.
     }
+    if (slow_suspend_all_count_ > 0) {
+      size_t count = std::min(slow_suspend_all_count_, kSlowSuspendAllRecordCount);
+      os << "Recent slow suspend-alls (" << count << " of " << slow_suspend_all_count_ << "):\n";
+      for (size_t i = slow_suspend_all_count_ - count; i != slow_suspend_all_count_; ++i) {
+        const SlowSuspendAll& record = slow_suspend_alls_[i % kSlowSuspendAllRecordCount];
+        os << "  " << record.cause << ": " << PrettyDuration(record.duration_ns);
+        if (record.last_suspended_tid != 0) {
+          os << ", last suspended thread: \"" << record.last_suspended_thread_name
+             << "\" tid=" << record.last_suspended_tid << " in " << record.method;
+        }
+        os << "\n";
+      }
+    }
   }
   bool dump_native_stack = Runtime::Current()->GetDumpNativeStackOnSigQuit();
   Dump(os, dump_native_stack);
@@ -303,9 +321,65 @@ NO_RETURN static void UnsafeLogFatalForThreadSuspendAllTimeout() {
 }
 #endif
 
+// Minimum number of suspended threads whose roots a thread pool worker should visit. Below that,
+// waking up the worker costs more than visiting the roots on the calling thread.
+static constexpr size_t kMinThreadsPerRootVisitWorker = 16;
+
+// Returns the number of workers of `pool` that should help visiting the roots of `num_threads`
+// suspended threads, or 0 if there is no pool, the pool is in use, or there is too little work.
+static size_t GetNumRootVisitWorkers(Thread* self, ThreadPool* pool, size_t num_threads) {
+  if (pool == nullptr || pool->HasStarted(self) || pool->GetTaskCount(self) != 0) {
+    return 0;
+  }
+  return std::min(pool->GetThreadCount(), num_threads / kMinThreadsPerRootVisitWorker);
+}
+
+static bool IsThreadPoolWorker(ThreadPool* pool, Thread* thread) {
+  const std::vector<ThreadPoolWorker*>& workers = pool->GetWorkers();
+  return std::any_of(workers.begin(), workers.end(), [thread](ThreadPoolWorker* worker) {
+    return worker->GetThread() == thread;
+  });
+}
+
+// Calls visit(thread, i) for every i in [0, count), either on self or on one of num_workers
+// workers of pool. The caller must hold the mutator lock shared; the workers acquire it shared as
+// well so that visit may access the Java heap. Does not return before all calls finished.
+template <typename Visitor>
+static void VisitInParallel(Thread* self,
+                            ThreadPool* pool,
+                            size_t num_workers,
+                            size_t count,
+                            const Visitor& visit) {
+  DCHECK_GT(num_workers, 0u);
+  std::atomic<size_t> next_index(0);
+  auto work = [&](Thread* thread) {
+    for (size_t i = next_index.fetch_add(1, std::memory_order_relaxed);
+         i < count;
+         i = next_index.fetch_add(1, std::memory_order_relaxed)) {
+      visit(thread, i);
+    }
+  };
+  for (size_t i = 0; i < num_workers; ++i) {
+    pool->AddTask(self, new FunctionTask([&work](Thread* worker) {
+      // Workers are not runnable, so they get the mutator lock like the GC thread does. This does
+      // not block as long as the caller holds the mutator lock.
+      ReaderMutexLock mu(worker, *Locks::mutator_lock_);
+      work(worker);
+    }));
+  }
+  pool->SetMaxActiveWorkers(num_workers);
+  pool->StartWorkers(self);
+  work(self);
+  // All indices have been claimed; any task still queued finds nothing left to do.
+  pool->Wait(self, /*do_work=*/ false, /*may_hold_locks=*/ true);
+  pool->StopWorkers(self);
+  pool->SetMaxActiveWorkers(pool->GetThreadCount());
+}
+
 size_t ThreadList::RunCheckpoint(Closure* checkpoint_function,
                                  Closure* callback,
-                                 bool allow_lock_checking) {
+                                 bool allow_lock_checking,
+                                 ThreadPool* pool) {
   Thread* self = Thread::Current();
   Locks::mutator_lock_->AssertNotExclusiveHeld(self);
   Locks::thread_list_lock_->AssertNotHeld(self);
@@ -371,6 +445,13 @@ size_t ThreadList::RunCheckpoint(Closure* checkpoint_function,
   checkpoint_function->Run(self);
 
   bool mutator_lock_held = Locks::mutator_lock_->IsSharedHeld(self);
+  // Share running the checkpoint on behalf of suspended threads with the pool's workers. That is
+  // only possible if we hold the mutator lock, which keeps the workers' shared acquisition of it
+  // from blocking.
+  const size_t num_workers = mutator_lock_held
+      ? GetNumRootVisitWorkers(self, pool, suspended_count_modified_threads.size())
+      : 0;
+  std::vector<Thread*> parallel_threads;
   bool repeat = true;
   // Run the checkpoint on the suspended threads.
   while (repeat) {
@@ -392,8 +473,11 @@ size_t ThreadList::RunCheckpoint(Closure* checkpoint_function,
           }
         }  // O.w. the checkpoint will not access Java data structures, and doesn't care whether
            // the flip function has been called.
-        checkpoint_function->Run(thread);
-        {
+        if (num_workers != 0 && !IsThreadPoolWorker(pool, thread)) {
+          parallel_threads.push_back(thread);
+        } else {
+          // Pool workers are handled here, before the pool starts running tasks on them.
+          checkpoint_function->Run(thread);
           MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
           thread->DecrementSuspendCount(self);
         }
@@ -402,6 +486,21 @@ size_t ThreadList::RunCheckpoint(Closure* checkpoint_function,
         thread = nullptr;
       }
     }
+    if (!parallel_threads.empty()) {
+      VisitInParallel(self,
+                      pool,
+                      num_workers,
+                      parallel_threads.size(),
+                      [&]([[maybe_unused]] Thread* worker, size_t i) {
+                        DCHECK(parallel_threads[i]->IsSuspended());
+                        checkpoint_function->Run(parallel_threads[i]);
+                      });
+      MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
+      for (Thread* thread : parallel_threads) {
+        thread->DecrementSuspendCount(self);
+      }
+      parallel_threads.clear();
+    }
   }
   DCHECK(std::all_of(suspended_count_modified_threads.cbegin(),
                      suspended_count_modified_threads.cend(),
@@ -634,15 +733,40 @@ void ThreadList::FlipThreadRoots(Closure* thread_flip_visitor,
 
   collector->GetHeap()->ThreadFlipEnd(self);
 
-  for (int i = 0; i < thread_count; ++i) {
+  auto start_flip = [&](Thread* runner, int i) {
     bool finished;
     Thread::EnsureFlipFunctionStarted(
-        self, flipping_threads[i], Thread::StateAndFlags(0), &exit_flags[i], &finished);
+        runner, flipping_threads[i], Thread::StateAndFlags(0), &exit_flags[i], &finished);
     if (finished) {
-      MutexLock mu2(self, *Locks::thread_list_lock_);
+      MutexLock mu2(runner, *Locks::thread_list_lock_);
       flipping_threads[i]->UnregisterThreadExitFlag(&exit_flags[i]);
       flipping_threads[i] = nullptr;
     }
+  };
+  ThreadPool* pool = collector->GetHeap()->GetThreadPool();
+  const size_t num_workers = GetNumRootVisitWorkers(self, pool, static_cast<size_t>(thread_count));
+  if (num_workers != 0) {
+    // Flip ourselves and the pool workers first, so that their flip functions do not run
+    // concurrently with the tasks below. Share the remaining threads with the workers.
+    std::vector<int> parallel_indices;
+    for (int i = 0; i < thread_count; ++i) {
+      if (i == 0 || IsThreadPoolWorker(pool, flipping_threads[i])) {
+        start_flip(self, i);
+      } else {
+        parallel_indices.push_back(i);
+      }
+    }
+    VisitInParallel(self,
+                    pool,
+                    num_workers,
+                    parallel_indices.size(),
+                    [&](Thread* worker, size_t i) {
+                      start_flip(worker, parallel_indices[i]);
+                    });
+  } else {
+    for (int i = 0; i < thread_count; ++i) {
+      start_flip(self, i);
+    }
   }
   // Make sure all flips complete before we return.
   for (int i = 0; i < thread_count; ++i) {
@@ -803,8 +927,9 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
     const uint64_t end_time = NanoTime();
     const uint64_t suspend_time = end_time - start_time;
     suspend_all_histogram_.AdjustAndAddValue(suspend_time);
+    Runtime::Current()->GetMetrics()->SuspendAllTimeUs()->Add(NsToUs(suspend_time));
     if (suspend_time > kLongThreadSuspendThreshold) {
-      LOG(WARNING) << "Suspending all threads took: " << PrettyDuration(suspend_time);
+      RecordSlowSuspendAll(self, cause, suspend_time);
     }
 
     if (kDebugLocking) {
@@ -826,6 +951,38 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
   }
 }
 
+void ThreadList::RecordSlowSuspendAll(Thread* self, const char* cause, uint64_t duration_ns) {
+  SlowSuspendAll& record = slow_suspend_alls_[slow_suspend_all_count_ % kSlowSuspendAllRecordCount];
+  ++slow_suspend_all_count_;
+  record.cause = cause;
+  record.duration_ns = duration_ns;
+  record.last_suspended_tid = last_suspended_tid_.load(std::memory_order_relaxed);
+  record.last_suspended_thread_name.clear();
+  record.method = "<unknown>";
+  if (record.last_suspended_tid != 0) {
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    Thread* thread = FindThreadByTid(record.last_suspended_tid);
+    if (thread != nullptr) {
+      thread->GetThreadName(record.last_suspended_thread_name);
+      // The thread was runnable until it passed the barrier, so its top frame is where it noticed
+      // the suspend request.
+      ArtMethod* method = thread->GetCurrentMethod(
+          /*dex_pc=*/nullptr, /*check_suspended=*/false, /*abort_on_error=*/false);
+      if (method != nullptr) {
+        record.method = method->PrettyMethod();
+      }
+    }
+  }
+
+  if (record.last_suspended_tid != 0) {
+    LOG(WARNING) << "Suspending all threads took: " << PrettyDuration(duration_ns)
+                 << ", last suspended thread: \"" << record.last_suspended_thread_name
+                 << "\" tid=" << record.last_suspended_tid << " in " << record.method;
+  } else {
+    LOG(WARNING) << "Suspending all threads took: " << PrettyDuration(duration_ns);
+  }
+}
+
 // Ensures all threads running Java suspend and that those not running Java don't start.
 void ThreadList::SuspendAllInternal(Thread* self, SuspendReason reason) {
   // self can be nullptr if this is an unregistered thread.
@@ -858,6 +1015,7 @@ void ThreadList::SuspendAllInternal(Thread* self, SuspendReason reason) {
         bool found_myself = false;
         // Update global suspend all state for attaching threads.
         ++suspend_all_count_;
+        last_suspended_tid_.store(0, std::memory_order_relaxed);
         pending_threads.store(list_.size() - (self == nullptr ? 0 : 1), std::memory_order_relaxed);
         // Increment everybody else's suspend count.
         for (const auto& thread : list_) {
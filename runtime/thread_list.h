@@ -17,8 +17,11 @@
 #ifndef ART_RUNTIME_THREAD_LIST_H_
 #define ART_RUNTIME_THREAD_LIST_H_
 
+#include <array>
+#include <atomic>
 #include <bitset>
 #include <list>
+#include <string>
 #include <vector>
 
 #include "barrier.h"
@@ -42,6 +45,7 @@ class Closure;
 class IsMarkedVisitor;
 class RootVisitor;
 class Thread;
+class ThreadPool;
 class TimingLogger;
 enum VisitRootFlags : uint8_t;
 
@@ -64,6 +68,12 @@ class ThreadList {
 
   void DumpForSigQuit(std::ostream& os)
       REQUIRES(!Locks::thread_list_lock_, !Locks::mutator_lock_);
+
+  // Called by each thread that passes the suspend barrier of an ongoing SuspendAll, right before
+  // it does so. The last caller is the thread that SuspendAll waited for the longest.
+  void SetLastSuspendedThread(pid_t tid) {
+    last_suspended_tid_.store(tid, std::memory_order_relaxed);
+  }
   // For thread suspend timeout dumps.
   EXPORT void Dump(std::ostream& os, bool dump_native_stack = true)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
@@ -124,9 +134,13 @@ class ThreadList {
   // lock (see mutator_gc_coord.md) then, since the checkpoint code may not acquire or release the
   // mutator lock, the checkpoint will have no way to access Java data.
   // TODO: Is it possible to just require the mutator lock here?
+  // If pool is non-null, the caller holds the mutator lock and many threads are suspended, the
+  // checkpoint function is run on behalf of the suspended threads by the idle workers of pool as
+  // well, so it must be safe to run concurrently from any thread.
   EXPORT size_t RunCheckpoint(Closure* checkpoint_function,
                        Closure* callback = nullptr,
-                       bool allow_lock_checking = true)
+                       bool allow_lock_checking = true,
+                       ThreadPool* pool = nullptr)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
   // Convenience version of the above to disable lock checking inside Run function. Hopefully this
@@ -150,7 +164,8 @@ class ThreadList {
   // Briefly suspends all threads to atomically install a checkpoint-like thread_flip_visitor
   // function to be run on each thread. Run flip_callback while threads are suspended.
   // Thread_flip_visitors are run by each thread before it becomes runnable, or by us. We do not
-  // return until all thread_flip_visitors have been run.
+  // return until all thread_flip_visitors have been run. If many threads stay suspended, we share
+  // running their thread_flip_visitors with the idle workers of the heap thread pool.
   void FlipThreadRoots(Closure* thread_flip_visitor,
                        Closure* flip_callback,
                        gc::collector::GarbageCollector* collector,
@@ -283,6 +298,31 @@ class ThreadList {
   // by mutator lock ensures no thread can read when another thread is modifying it.
   Histogram<uint64_t> suspend_all_histogram_ GUARDED_BY(Locks::mutator_lock_);
 
+  // A SuspendAll that took longer than kLongThreadSuspendThreshold, and the thread that took the
+  // longest to suspend, if any. `method` is where that thread was running when it suspended.
+  struct SlowSuspendAll {
+    std::string cause;
+    uint64_t duration_ns = 0;
+    pid_t last_suspended_tid = 0;
+    std::string last_suspended_thread_name;
+    std::string method;
+  };
+
+  void RecordSlowSuspendAll(Thread* self, const char* cause, uint64_t duration_ns)
+      REQUIRES(Locks::mutator_lock_, !Locks::thread_list_lock_);
+
+  // The tid of the thread that last passed the suspend barrier of the ongoing SuspendAll, or 0 if
+  // all threads were already suspended when SuspendAll was requested. Concurrent passers may race,
+  // so this is a best-effort answer.
+  std::atomic<pid_t> last_suspended_tid_;
+
+  // The most recent slow SuspendAlls, dumped on SIGQUIT. Only modified when all the threads are
+  // suspended, like `suspend_all_histogram_`.
+  static constexpr size_t kSlowSuspendAllRecordCount = 16;
+  std::array<SlowSuspendAll, kSlowSuspendAllRecordCount> slow_suspend_alls_
+      GUARDED_BY(Locks::mutator_lock_);
+  size_t slow_suspend_all_count_ GUARDED_BY(Locks::mutator_lock_);
+
   // Whether or not the current thread suspension is long.
   bool long_suspend_;
 
@@ -23,6 +23,9 @@
 
 #include <pthread.h>
 
+#include <algorithm>
+#include <atomic>
+
 #include <android-base/logging.h>
 #include <android-base/stringprintf.h>
 
@@ -341,6 +344,40 @@ void AbstractThreadPool::Wait(Thread* self, bool do_work, bool may_hold_locks) {
   }
 }
 
+void AbstractThreadPool::ParallelFor(Thread* self,
+                                     size_t begin,
+                                     size_t end,
+                                     size_t chunk_size,
+                                     const std::function<void(size_t)>& func) {
+  CHECK(HasStarted(self));
+  DCHECK_GT(chunk_size, 0u);
+  if (begin >= end) {
+    return;
+  }
+  std::atomic<size_t> next_index(begin);
+  auto run_chunks = [&](Thread*) {
+    while (true) {
+      size_t index = next_index.fetch_add(chunk_size, std::memory_order_relaxed);
+      if (index >= end) {
+        break;
+      }
+      size_t chunk_end = index + std::min(chunk_size, end - index);
+      for (; index != chunk_end; ++index) {
+        func(index);
+      }
+    }
+  };
+
+  size_t num_chunks = (end - begin - 1) / chunk_size + 1;
+  size_t num_tasks = std::min(GetThreadCount(), num_chunks - 1);
+  for (size_t i = 0; i != num_tasks; ++i) {
+    AddTask(self, new FunctionTask(run_chunks));
+  }
+  run_chunks(self);
+  // The tasks reference `next_index` and `func`, so they must all be done before we return.
+  Wait(self, /*do_work=*/false, /*may_hold_locks=*/false);
+}
+
 size_t ThreadPool::GetTaskCount(Thread* self) {
   MutexLock mu(self, task_queue_lock_);
   return tasks_.size();
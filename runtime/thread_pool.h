@@ -147,6 +147,18 @@ class AbstractThreadPool {
   // When the pool was created with peers for workers, do_work must not be true (see ThreadPool()).
   EXPORT void Wait(Thread* self, bool do_work, bool may_hold_locks) REQUIRES(!task_queue_lock_);
 
+  // Runs `func(i)` for every `i` in [begin, end) on the workers and the calling thread, and waits
+  // for all tasks on the queue to complete, like `Wait`. Rather than one task per index, this adds
+  // at most one task per worker and every participant claims `chunk_size` indices at a time from a
+  // shared counter. Fine-grained work then costs one atomic increment per chunk instead of a
+  // `task_queue_lock_` round trip per item, and threads that finish early take over the indices
+  // that slower ones have not claimed yet. The pool must have been started.
+  EXPORT void ParallelFor(Thread* self,
+                          size_t begin,
+                          size_t end,
+                          size_t chunk_size,
+                          const std::function<void(size_t)>& func) REQUIRES(!task_queue_lock_);
+
   // Returns the total amount of workers waited for tasks.
   uint64_t GetWaitTime() const {
     return total_wait_time_;
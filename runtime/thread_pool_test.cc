@@ -17,8 +17,10 @@
 #include "thread_pool.h"
 
 #include <string>
+#include <vector>
 
 #include "base/atomic.h"
+#include "base/time_utils.h"
 #include "common_runtime_test.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-inl.h"
@@ -164,6 +166,53 @@ TEST_F(ThreadPoolTest, RecursiveTest) {
   EXPECT_EQ((1 << depth) - 1, count.load(std::memory_order_seq_cst));
 }
 
+// Check that ParallelFor visits every index exactly once, including ranges that don't divide into
+// whole chunks and ranges with fewer chunks than workers.
+TEST_F(ThreadPoolTest, ParallelFor) {
+  Thread* self = Thread::Current();
+  std::unique_ptr<ThreadPool> thread_pool(
+      ThreadPool::Create("Thread pool test thread pool", num_threads));
+  thread_pool->StartWorkers(self);
+  for (size_t size : {0u, 1u, 7u, 100u, 10007u}) {
+    for (size_t chunk_size : {1u, 16u, 1000u}) {
+      std::vector<AtomicInteger> visits(size);
+      thread_pool->ParallelFor(self, 0, size, chunk_size, [&](size_t i) { ++visits[i]; });
+      for (size_t i = 0; i != size; ++i) {
+        ASSERT_EQ(visits[i].load(std::memory_order_relaxed), 1)
+            << "size=" << size << ", chunk_size=" << chunk_size << ", i=" << i;
+      }
+    }
+  }
+}
+
+// Compare adding one task per item with ParallelFor for fine-grained work. This only logs the
+// timings, since they depend on the host.
+TEST_F(ThreadPoolTest, ParallelForBenchmark) {
+  Thread* self = Thread::Current();
+  std::unique_ptr<ThreadPool> thread_pool(
+      ThreadPool::Create("Thread pool test thread pool", num_threads));
+  thread_pool->StartWorkers(self);
+  static constexpr size_t kItems = 100000;
+  AtomicInteger count(0);
+
+  uint64_t start_ns = NanoTime();
+  for (size_t i = 0; i != kItems; ++i) {
+    thread_pool->AddTask(self, new FunctionTask([&](Thread*) { ++count; }));
+  }
+  thread_pool->Wait(self, /*do_work=*/true, /*may_hold_locks=*/false);
+  uint64_t tasks_ns = NanoTime() - start_ns;
+  EXPECT_EQ(count.load(std::memory_order_relaxed), static_cast<int32_t>(kItems));
+
+  count.store(0, std::memory_order_relaxed);
+  start_ns = NanoTime();
+  thread_pool->ParallelFor(self, 0, kItems, /*chunk_size=*/64, [&](size_t) { ++count; });
+  uint64_t parallel_for_ns = NanoTime() - start_ns;
+  EXPECT_EQ(count.load(std::memory_order_relaxed), static_cast<int32_t>(kItems));
+
+  LOG(INFO) << kItems << " items on " << num_threads << " workers: one task per item took "
+            << PrettyDuration(tasks_ns) << ", ParallelFor took " << PrettyDuration(parallel_for_ns);
+}
+
 class PeerTask : public Task {
  public:
   PeerTask() {}
@@ -19,9 +19,12 @@
 #include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
+
 #include "android-base/macros.h"
 #include "android-base/stringprintf.h"
 #include "art_method-inl.h"
+#include "barrier.h"
 #include "base/casts.h"
 #include "base/leb128.h"
 #include "base/os.h"
@@ -106,7 +109,6 @@ TraceClockSource Trace::default_clock_source_ = kDefaultTraceClockSource;
 
 Trace* volatile Trace::the_trace_ = nullptr;
 pthread_t Trace::sampling_pthread_ = 0U;
-std::unique_ptr<std::vector<ArtMethod*>> Trace::temp_stack_trace_;
 
 // The key identifying the tracer to update instrumentation.
 static constexpr const char* kTracerInstrumentationKey = "Tracer";
@@ -353,16 +355,6 @@ class MethodInfoWriterTask final : public TraceWriterTask {
   }
 };
 
-std::vector<ArtMethod*>* Trace::AllocStackTrace() {
-  return (temp_stack_trace_.get() != nullptr)  ? temp_stack_trace_.release() :
-      new std::vector<ArtMethod*>();
-}
-
-void Trace::FreeStackTrace(std::vector<ArtMethod*>* stack_trace) {
-  stack_trace->clear();
-  temp_stack_trace_.reset(stack_trace);
-}
-
 void Trace::SetDefaultClockSource(TraceClockSource clock_source) {
 #if defined(__linux__)
   default_clock_source_ = clock_source;
@@ -473,8 +465,13 @@ static void Append8LE(uint8_t* buf, uint64_t val) {
   *buf++ = static_cast<uint8_t>(val >> 56);
 }
 
-static void GetSample(Thread* thread, void* arg) REQUIRES_SHARED(Locks::mutator_lock_) {
-  std::vector<ArtMethod*>* const stack_trace = Trace::AllocStackTrace();
+static void GetSample(Thread* thread, Trace* the_trace) REQUIRES_SHARED(Locks::mutator_lock_) {
+  // Samples are taken concurrently by different threads, so each sample gets its own vector.
+  std::vector<ArtMethod*>* const stack_trace = new std::vector<ArtMethod*>();
+  std::vector<ArtMethod*>* const old_stack_trace = thread->GetStackTraceSample();
+  if (old_stack_trace != nullptr) {
+    stack_trace->reserve(old_stack_trace->size());
+  }
   StackVisitor::WalkStack(
       [&](const art::StackVisitor* stack_visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
         ArtMethod* m = stack_visitor->GetMethod();
@@ -487,10 +484,26 @@ static void GetSample(Thread* thread, void* arg) REQUIRES_SHARED(Locks::mutator_
       thread,
       /* context= */ nullptr,
       art::StackVisitor::StackWalkKind::kIncludeInlinedFrames);
-  Trace* the_trace = reinterpret_cast<Trace*>(arg);
   the_trace->CompareAndUpdateStackTrace(thread, stack_trace);
 }
 
+// Checkpoint used by the sampling thread to take a sample of every thread. Runnable threads sample
+// their own stack at the next suspend point and suspended threads are sampled on their behalf, so
+// taking a sample never requires suspending all the threads.
+class SampleCheckpoint final : public Closure {
+ public:
+  SampleCheckpoint(Trace* trace, Barrier* barrier) : trace_(trace), barrier_(barrier) {}
+
+  void Run(Thread* thread) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    GetSample(thread, trace_);
+    barrier_->Pass(Thread::Current());
+  }
+
+ private:
+  Trace* const trace_;
+  Barrier* const barrier_;
+};
+
 static void ClearThreadStackTraceAndClockBase(Thread* thread, [[maybe_unused]] void* arg) {
   thread->SetTraceClockBase(0);
   std::vector<ArtMethod*>* stack_trace = thread->GetStackTraceSample();
@@ -500,7 +513,8 @@ static void ClearThreadStackTraceAndClockBase(Thread* thread, [[maybe_unused]] v
 
 void Trace::CompareAndUpdateStackTrace(Thread* thread,
                                        std::vector<ArtMethod*>* stack_trace) {
-  CHECK_EQ(pthread_self(), sampling_pthread_);
+  // This is called either by the thread itself or on its behalf while it is suspended, so the
+  // per-thread sample and trace buffer are not accessed concurrently.
   std::vector<ArtMethod*>* old_stack_trace = thread->GetStackTraceSample();
   // Update the thread's stack trace sample.
   thread->SetStackTraceSample(stack_trace);
@@ -532,7 +546,7 @@ void Trace::CompareAndUpdateStackTrace(Thread* thread,
     for (; rit != stack_trace->rend(); ++rit) {
       LogMethodTraceEvent(thread, *rit, kTraceMethodEnter, thread_clock_diff, timestamp_counter);
     }
-    FreeStackTrace(old_stack_trace);
+    delete old_stack_trace;
   }
 }
 
@@ -562,9 +576,15 @@ void* Trace::RunSamplingThread(void* arg) {
       gc::ScopedGCCriticalSection gcs(self,
                                       art::gc::kGcCauseInstrumentation,
                                       art::gc::kCollectorTypeInstrumentation);
-      ScopedSuspendAll ssa(__FUNCTION__);
-      MutexLock mu(self, *Locks::thread_list_lock_);
-      runtime->GetThreadList()->ForEach(GetSample, the_trace);
+      ScopedObjectAccess soa(self);
+      Barrier barrier(0);
+      SampleCheckpoint checkpoint(the_trace, &barrier);
+      size_t threads_running_checkpoint = runtime->GetThreadList()->RunCheckpoint(&checkpoint);
+      // Wait for the threads to take their samples so the trace outlives the checkpoints.
+      ScopedThreadSuspension sts(self, ThreadState::kWaitingForCheckPointsToRun);
+      if (threads_running_checkpoint != 0) {
+        barrier.Increment(self, threads_running_checkpoint);
+      }
     }
   }
 
@@ -1033,7 +1053,8 @@ TraceWriter::TraceWriter(File* trace_file,
                          size_t buffer_size,
                          int num_trace_buffers,
                          int trace_format_version,
-                         uint32_t clock_overhead_ns)
+                         uint32_t clock_overhead_ns,
+                         bool flight_recorder)
     : trace_file_(trace_file),
       trace_output_mode_(output_mode),
       clock_source_(clock_source),
@@ -1049,6 +1070,7 @@ TraceWriter::TraceWriter(File* trace_file,
       buffer_available_("buffer available condition", buffer_pool_lock_),
       num_waiters_zero_cond_("Num waiters zero", buffer_pool_lock_),
       num_waiters_for_buffer_(0),
+      flight_recorder_(flight_recorder),
       trace_writer_lock_("trace writer lock", LockLevel::kTracingStreamingLock) {
   // We initialize the start_time_ from the timestamp counter. This may not match
   // with the monotonic timer but we only use this time to calculate the elapsed
@@ -1133,7 +1155,8 @@ Trace::Trace(File* trace_file,
                                       buf_size,
                                       kNumTracePoolBuffers,
                                       trace_format_version,
-                                      GetClockOverheadNanoSeconds()));
+                                      GetClockOverheadNanoSeconds(),
+                                      (flags & kTraceFlightRecorder) != 0));
 }
 
 void TraceWriter::FinishTracing(int flags, bool flush_entries) {
@@ -1476,6 +1499,17 @@ void TraceWriter::FlushAllThreadBuffers() {
 }
 
 uintptr_t* TraceWriter::PrepareBufferForNewEntries(Thread* thread) {
+  if (flight_recorder_) {
+    // Don't flush anything, just start overwriting the oldest entries. The wrapped buffer is
+    // reordered when it is eventually flushed.
+    {
+      MutexLock mu(Thread::Current(), buffer_pool_lock_);
+      wrapped_tids_.insert(thread->GetTid());
+    }
+    *thread->GetMethodTraceIndexPtr() = kPerThreadBufSize;
+    return thread->GetMethodTraceBuffer();
+  }
+
   if (trace_output_mode_ == TraceOutputMode::kStreaming) {
     // In streaming mode, just flush the per-thread buffer and reuse the
     // existing buffer for new entries.
@@ -1618,12 +1652,37 @@ int TraceWriter::GetMethodTraceIndex(uintptr_t* current_buffer) {
   return (current_buffer - trace_buffer_.get()) / kPerThreadBufSize;
 }
 
+bool TraceWriter::ClearWrappedBuffer(size_t tid) {
+  MutexLock mu(Thread::Current(), buffer_pool_lock_);
+  return wrapped_tids_.erase(tid) != 0;
+}
+
+void TraceWriter::LinearizeWrappedBuffer(uintptr_t* method_trace_entries,
+                                         size_t* current_offset) {
+  // Entries are recorded from the top of the buffer downwards, so in each lap older entries are
+  // at higher indices. The previous lap ended at the lowest record aligned from the top and the
+  // current lap overwrote everything from the top down to current_offset. Rotating the two parts
+  // puts the surviving entries of the previous lap above the entries of the current lap.
+  size_t num_entries = GetNumEntries(clock_source_);
+  size_t end_offset = kPerThreadBufSize % num_entries;
+  DCHECK_GE(*current_offset, end_offset);
+  DCHECK_EQ((kPerThreadBufSize - *current_offset) % num_entries, 0u);
+  std::rotate(method_trace_entries + end_offset,
+              method_trace_entries + *current_offset,
+              method_trace_entries + kPerThreadBufSize);
+  *current_offset = end_offset;
+}
+
 void TraceWriter::FlushBuffer(Thread* thread, bool is_sync, bool release) {
   uintptr_t* method_trace_entries = thread->GetMethodTraceBuffer();
   size_t* current_offset = thread->GetMethodTraceIndexPtr();
   size_t tid = thread->GetTid();
   DCHECK(method_trace_entries != nullptr);
 
+  if (flight_recorder_ && ClearWrappedBuffer(tid)) {
+    LinearizeWrappedBuffer(method_trace_entries, current_offset);
+  }
+
   if (is_sync || thread_pool_ == nullptr) {
     std::unordered_map<ArtMethod*, std::string> method_infos;
     if (trace_format_version_ == Trace::kFormatV1) {
@@ -24,6 +24,7 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "base/atomic.h"
@@ -150,7 +151,8 @@ class TraceWriter {
               size_t buffer_size,
               int num_trace_buffers,
               int trace_format_version,
-              uint32_t clock_overhead_ns);
+              uint32_t clock_overhead_ns,
+              bool flight_recorder);
 
   // This encodes all the events in the per-thread trace buffer and writes it to the trace file /
   // buffer. This acquires streaming lock to prevent any other threads writing concurrently. It is
@@ -169,6 +171,9 @@ class TraceWriter {
   // in the centralized buffer before recording new entries. We just flush these buffers
   // synchronously and reuse the existing buffer. Since this mode is mostly deprecated we want to
   // keep the implementation simple here.
+  // In flight recorder mode, nothing is flushed. The buffer is marked as wrapped and new entries
+  // overwrite the oldest ones, so each thread keeps only its most recent events until tracing
+  // stops or the thread exits.
   uintptr_t* PrepareBufferForNewEntries(Thread* thread) REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!trace_writer_lock_);
 
@@ -312,6 +317,15 @@ class TraceWriter {
   // Flush tracing buffers from all the threads.
   void FlushAllThreadBuffers() REQUIRES(!Locks::thread_list_lock_) REQUIRES(!trace_writer_lock_);
 
+  // Returns true and clears the wrapped state if the per-thread buffer of the thread with the
+  // given tid has wrapped around in flight recorder mode.
+  bool ClearWrappedBuffer(size_t tid) REQUIRES(!buffer_pool_lock_);
+
+  // Reorders the entries of a wrapped per-thread buffer so the oldest surviving entry is at the
+  // top of the buffer, as if the buffer had been filled once. This updates current_offset to
+  // point to the newest entry.
+  void LinearizeWrappedBuffer(uintptr_t* method_trace_entries, size_t* current_offset);
+
 
   // Methods to output traced methods and threads.
   void DumpMethodList(std::ostream& os) REQUIRES_SHARED(Locks::mutator_lock_)
@@ -378,6 +392,14 @@ class TraceWriter {
   std::atomic<size_t> num_waiters_for_buffer_;
   std::atomic<bool> finish_tracing_ = false;
 
+  // Whether per-thread buffers are used as ring buffers that overwrite the oldest entries on wrap
+  // instead of being flushed when full.
+  const bool flight_recorder_;
+
+  // Tids of threads whose per-thread buffer wrapped around in flight recorder mode. This is only
+  // updated once per wrap, so recording entries never takes a lock.
+  std::unordered_set<size_t> wrapped_tids_ GUARDED_BY(buffer_pool_lock_);
+
   // Lock to protect common data structures accessed from multiple threads like
   // art_method_id_map_, thread_id_map_.
   Mutex trace_writer_lock_;
@@ -395,6 +417,8 @@ class Trace final : public instrumentation::InstrumentationListener, public Clas
     kTraceCountAllocs = 0x001,
     kTraceClockSourceWallClock = 0x010,
     kTraceClockSourceThreadCpu = 0x100,
+    // Keep only the most recent events of each thread and write them out when tracing stops.
+    kTraceFlightRecorder = 0x1000,
   };
 
   static const int kFormatV1 = 0;
@@ -512,11 +536,6 @@ class Trace final : public instrumentation::InstrumentationListener, public Clas
 
   TraceClockSource GetClockSource() { return clock_source_; }
 
-  // Reuse an old stack trace if it exists, otherwise allocate a new one.
-  static std::vector<ArtMethod*>* AllocStackTrace();
-  // Clear and store an old stack trace for later use.
-  static void FreeStackTrace(std::vector<ArtMethod*>* stack_trace);
-
   static TraceOutputMode GetOutputMode() REQUIRES(!Locks::trace_lock_);
   static TraceMode GetMode() REQUIRES(!Locks::trace_lock_);
   static size_t GetBufferSize() REQUIRES(!Locks::trace_lock_);
@@ -566,9 +585,6 @@ class Trace final : public instrumentation::InstrumentationListener, public Clas
   // Sampling thread, non-zero when sampling.
   static pthread_t sampling_pthread_;
 
-  // Used to remember an unused stack trace to avoid re-allocation during sampling.
-  static std::unique_ptr<std::vector<ArtMethod*>> temp_stack_trace_;
-
   // Flags enabling extra tracing of things such as alloc counts.
   const int flags_;
 
@@ -58,6 +58,8 @@ Transaction::Transaction(bool strict,
       strict_(strict),
       root_(root),
       last_allocated_object_(nullptr),
+      last_logged_object_(nullptr),
+      last_object_log_(nullptr),
       assert_no_new_records_reason_(nullptr) {
   DCHECK(Runtime::Current()->IsAotCompiler());
   DCHECK_NE(arena_stack != nullptr, arena_pool != nullptr);
@@ -170,6 +172,7 @@ void Transaction::RecordNewObject(ObjPtr<mirror::Object> obj) {
   ObjectLog log(&allocator_);
   log.MarkAsNewObject();
   object_logs_.Put(obj.Ptr(), std::move(log));
+  last_logged_object_ = nullptr;
 }
 
 void Transaction::RecordNewArray(ObjPtr<mirror::Array> array) {
@@ -202,7 +205,13 @@ bool Transaction::ArrayNeedsTransactionRecords(ObjPtr<mirror::Array> array) {
 }
 
 inline Transaction::ObjectLog& Transaction::GetOrCreateObjectLog(mirror::Object* obj) {
-  return object_logs_.GetOrCreate(obj, [&]() { return ObjectLog(&allocator_); });
+  // Interpreted code, e.g. a class initializer setting the static fields of its class, often
+  // writes the same object repeatedly. Avoid the map lookup for these writes.
+  if (obj != last_logged_object_) {
+    last_object_log_ = &object_logs_.GetOrCreate(obj, [&]() { return ObjectLog(&allocator_); });
+    last_logged_object_ = obj;
+  }
+  return *last_object_log_;
 }
 
 void Transaction::RecordWriteFieldBoolean(mirror::Object* obj,
@@ -365,6 +374,7 @@ void Transaction::UndoObjectModifications() {
     it.second.Undo(it.first);
   }
   object_logs_.clear();
+  last_logged_object_ = nullptr;
 }
 
 void Transaction::UndoArrayModifications() {
@@ -452,6 +462,7 @@ void Transaction::VisitObjectLogs(RootVisitor* visitor, ArenaStack* arena_stack)
 
   // Update object logs with moving roots.
   UpdateKeys(moving_roots, object_logs_);
+  last_logged_object_ = nullptr;
 }
 
 void Transaction::VisitArrayLogs(RootVisitor* visitor, ArenaStack* arena_stack) {
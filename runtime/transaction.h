@@ -380,6 +380,9 @@ class Transaction final {
   std::string abort_message_;
   mirror::Class* root_;
   mirror::Object* last_allocated_object_;
+  // Cache of the last `object_logs_` entry returned by `GetOrCreateObjectLog()`.
+  mirror::Object* last_logged_object_;
+  ObjectLog* last_object_log_;
   const char* assert_no_new_records_reason_;
 
   friend class ScopedAssertNoNewTransactionRecords;
@@ -424,7 +424,22 @@ bool FindLockAliasedRegister(uint32_t src,
 bool RegisterLine::MergeRegisters(MethodVerifier* verifier, const RegisterLine* incoming_line) {
   bool changed = false;
   DCHECK(incoming_line != nullptr);
-  for (size_t idx = 0; idx < num_regs_; idx++) {
+  // Most registers agree between the lines being merged, especially in huge methods where many
+  // registers hold values that are not touched by the code between the branches. Compare four
+  // registers at a time and only merge register by register where the lines differ.
+  static constexpr size_t kRegsPerWord = sizeof(uint64_t) / sizeof(uint16_t);
+  size_t idx = 0;
+  while (idx < num_regs_) {
+    if (idx + kRegsPerWord <= num_regs_) {
+      uint64_t cur_word;
+      uint64_t incoming_word;
+      memcpy(&cur_word, &line_[idx], sizeof(uint64_t));
+      memcpy(&incoming_word, &incoming_line->line_[idx], sizeof(uint64_t));
+      if (cur_word == incoming_word) {
+        idx += kRegsPerWord;
+        continue;
+      }
+    }
     if (line_[idx] != incoming_line->line_[idx]) {
       const RegType& incoming_reg_type = incoming_line->GetRegisterType(verifier, idx);
       const RegType& cur_type = GetRegisterType(verifier, idx);
@@ -433,6 +448,7 @@ bool RegisterLine::MergeRegisters(MethodVerifier* verifier, const RegisterLine*
       changed = changed || !cur_type.Equals(new_type);
       line_[idx] = new_type.GetId();
     }
+    ++idx;
   }
   if (monitors_.size() > 0 || incoming_line->monitors_.size() > 0) {
     if (monitors_.size() != incoming_line->monitors_.size()) {
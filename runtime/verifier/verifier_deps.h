@@ -68,9 +68,12 @@ class VerifierDeps {
   // this marker as its offset entry in the encoded data.
   static uint32_t constexpr kNotVerifiedMarker = std::numeric_limits<uint32_t>::max();
 
-  // Fill dependencies from stored data. Returns true on success, false on failure.
+  // Fill dependencies from stored data. If `dex_files_to_parse` is not null, only fill the
+  // dependencies of the dex files it marks, the other dex files are left without any recorded
+  // dependencies. Returns true on success, false on failure.
   EXPORT bool ParseStoredData(const std::vector<const DexFile*>& dex_files,
-                              ArrayRef<const uint8_t> data);
+                              ArrayRef<const uint8_t> data,
+                              const std::vector<bool>* dex_files_to_parse = nullptr);
 
   // Merge `other` into this `VerifierDeps`'. `other` and `this` must be for the
   // same set of dex files.
@@ -143,6 +146,11 @@ class VerifierDeps {
     return GetDexFileDeps(dex_file) != nullptr;
   }
 
+  // Whether the dependencies of `dex_file` were filled from stored data.
+  bool HasStoredData(const DexFile& dex_file) const {
+    return GetDexFileDeps(dex_file)->has_stored_data_;
+  }
+
   // Parses raw VerifierDeps data to extract bitvectors of which class def indices
   // were verified or not. The given `dex_files` must match the order and count of
   // dex files used to create the VerifierDeps.
@@ -182,6 +190,9 @@ class VerifierDeps {
     // class was successfully verified.
     std::vector<bool> verified_classes_;
 
+    // Whether the dependencies were filled from stored data.
+    bool has_stored_data_ = false;
+
     bool Equals(const DexFileDeps& rhs) const;
   };
 
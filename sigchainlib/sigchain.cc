@@ -265,9 +265,19 @@ class ScopedHandlingSignal {
   bool original_value_;
 };
 
+// Returns the signals 1-64 of a signal set as a bit mask, as the kernel represents them.
+template <typename SigsetType>
+static uint64_t KernelSigsetBits(const SigsetType& set) {
+  static_assert(sizeof(SigsetType) >= sizeof(uint64_t));
+  static_assert(_NSIG - 1 <= 64);
+  uint64_t bits;
+  memcpy(&bits, &set, sizeof(bits));
+  return bits;
+}
+
 class SignalChain {
  public:
-  SignalChain() : claimed_(false) {
+  SignalChain() : claimed_(false), entry_mask_handler_(nullptr), entry_mask_bits_(0u) {
   }
 
   bool IsClaimed() {
@@ -295,6 +305,26 @@ class SignalChain {
     handler_action.sa_flags = SA_RESTART | SA_SIGINFO | SA_ONSTACK |
                               SA_UNSUPPORTED | SA_EXPOSE_TAGBITS;
 
+    // Let the kernel install the first special handler's mask on entry, so that `Handler()` does
+    // not need a `sigprocmask()` call before running it. This is the hot path for faults taken by
+    // ART's implicit checks. Everything past the special handlers blocks all signals explicitly.
+    entry_mask_handler_ = nullptr;
+    if (special_handlers_[0].sc_sigaction != nullptr) {
+      const SigchainAction& special = special_handlers_[0];
+#if defined(__BIONIC__)
+      sigemptyset64(&handler_action.sa_mask);
+      memcpy(&handler_action.sa_mask, &special.sc_mask,
+             std::min(sizeof(special.sc_mask), sizeof(handler_action.sa_mask)));
+#else
+      handler_action.sa_mask = special.sc_mask;
+#endif
+      if (!sigismember(&special.sc_mask, signo)) {
+        handler_action.sa_flags |= SA_NODEFER;
+      }
+      entry_mask_handler_ = special.sc_sigaction;
+      entry_mask_bits_ = KernelSigsetBits(handler_action.sa_mask);
+    }
+
 #if defined(__BIONIC__)
     linked_sigaction64(signo, &handler_action, &action_);
     linked_sigaction64(signo, nullptr, &handler_action);
@@ -374,6 +404,40 @@ class SignalChain {
     action_.sa_flags &= kernel_supported_flags_;
   }
 
+  // Returns whether the kernel has already installed the given special handler's mask for the
+  // signal delivered with `ucontext_raw`. The kernel blocks the union of the interrupted mask and
+  // the registered mask, which is exactly the handler's mask if the interrupted code did not
+  // block any other signal.
+  bool HasEntryMask(const SigchainAction& handler, void* ucontext_raw) const {
+    if (handler.sc_sigaction != entry_mask_handler_) {
+      return false;
+    }
+    const ucontext_t* ucontext = static_cast<const ucontext_t*>(ucontext_raw);
+#if defined(__BIONIC__)
+    uint64_t interrupted_bits = KernelSigsetBits(ucontext->uc_sigmask64);
+#else
+    uint64_t interrupted_bits = KernelSigsetBits(ucontext->uc_sigmask);
+#endif
+    return (interrupted_bits & ~entry_mask_bits_) == 0u;
+  }
+
+  // Blocks all signals if `Register()` asked the kernel for less than that on entry, which is
+  // what the code after the special handlers expects.
+  void BlockAllSignalsAfterEntryMask() const {
+    if (entry_mask_handler_ == nullptr) {
+      return;
+    }
+#if defined(__BIONIC__)
+    sigset64_t all;
+    sigfillset64(&all);
+    linked_sigprocmask64(SIG_SETMASK, &all, nullptr);
+#else
+    sigset_t all;
+    sigfillset(&all);
+    linked_sigprocmask(SIG_SETMASK, &all, nullptr);
+#endif
+  }
+
   void AddSpecialHandler(SigchainAction* sa) {
     for (SigchainAction& slot : special_handlers_) {
       if (slot.sc_sigaction == nullptr) {
@@ -406,6 +470,9 @@ class SignalChain {
 
  private:
   bool claimed_;
+  // The special handler whose mask the kernel installs on entry, see `Register()`.
+  bool (*entry_mask_handler_)(int, siginfo_t*, void*);
+  uint64_t entry_mask_bits_;
   int kernel_supported_flags_;
 #if defined(__BIONIC__)
   struct sigaction64 action_;
@@ -440,8 +507,11 @@ void SignalChain::Handler(int signo, siginfo_t* siginfo, void* ucontext_raw) {
       // Avoid setting the thread local flag in this case, since we'll never
       // get a chance to restore it.
       bool handler_noreturn = (handler.sc_flags & SIGCHAIN_ALLOW_NORETURN);
+      bool set_mask = !chains[signo].HasEntryMask(handler, ucontext_raw);
       sigset_t previous_mask;
-      linked_sigprocmask(SIG_SETMASK, &handler.sc_mask, &previous_mask);
+      if (set_mask) {
+        linked_sigprocmask(SIG_SETMASK, &handler.sc_mask, &previous_mask);
+      }
 
       ScopedHandlingSignal restorer(signo, !handler_noreturn);
 
@@ -449,7 +519,9 @@ void SignalChain::Handler(int signo, siginfo_t* siginfo, void* ucontext_raw) {
         return;
       }
 
-      linked_sigprocmask(SIG_SETMASK, &previous_mask, nullptr);
+      if (set_mask) {
+        linked_sigprocmask(SIG_SETMASK, &previous_mask, nullptr);
+      }
     }
   } else {
 #if defined(__aarch64__)
@@ -470,6 +542,7 @@ void SignalChain::Handler(int signo, siginfo_t* siginfo, void* ucontext_raw) {
     }
 #endif
   }
+  chains[signo].BlockAllSignalsAfterEntryMask();
 
   // In Android 14, there's a special feature called "recoverable" GWP-ASan. GWP-ASan is a tool that
   // finds heap-buffer-overflow and heap-use-after-free on native heap allocations (e.g. malloc()
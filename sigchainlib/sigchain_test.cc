@@ -50,6 +50,10 @@ static int sigemptyset64(sigset64_t* set) {
   return sigemptyset(set);
 }
 
+static int sigaddset64(sigset64_t* set, int member) {
+  return sigaddset(set, member);
+}
+
 static int sigismember64(sigset64_t* set, int member) {
   return sigismember(set, member);
 }
@@ -60,6 +64,9 @@ static int RealSigprocmask(int how, const sigset64_t* new_sigset, sigset64_t* ol
   return syscall(__NR_rt_sigprocmask, how, new_sigset, old_sigset, NSIG/8);
 }
 
+// The signal mask observed by the special handler the last time it ran.
+static sigset64_t special_handler_mask;
+
 class SigchainTest : public ::testing::Test {
   void SetUp() final {
     art::AddSpecialSignalHandlerFn(SIGSEGV, &action);
@@ -71,6 +78,7 @@ class SigchainTest : public ::testing::Test {
 
   art::SigchainAction action = {
       .sc_sigaction = [](int, siginfo_t* info, void*) -> bool {
+        RealSigprocmask(SIG_SETMASK, nullptr, &special_handler_mask);
         return info->si_value.sival_ptr;
       },
       .sc_mask = {},
@@ -211,6 +219,30 @@ TEST_F(SigchainTest, sigsetmask) {
 #endif
 
 // Make sure that we properly put ourselves back in front if we get circumvented.
+TEST_F(SigchainTest, SpecialHandlerMask) {
+  // The special handler runs with its own (empty) mask, whether or not the kernel could install
+  // it on entry.
+  sigset64_t mask;
+  sigemptyset64(&mask);
+  ASSERT_EQ(0, RealSigprocmask(SIG_SETMASK, &mask, nullptr)) << strerror(errno);
+  RaiseHandled();
+  EXPECT_FALSE(sigismember64(&special_handler_mask, SIGSEGV));
+  EXPECT_FALSE(sigismember64(&special_handler_mask, SIGUSR1));
+
+  sigaddset64(&mask, SIGUSR1);
+  ASSERT_EQ(0, RealSigprocmask(SIG_SETMASK, &mask, nullptr)) << strerror(errno);
+  RaiseHandled();
+  EXPECT_FALSE(sigismember64(&special_handler_mask, SIGSEGV));
+  EXPECT_FALSE(sigismember64(&special_handler_mask, SIGUSR1));
+
+  // The interrupted mask is restored on return.
+  ASSERT_EQ(0, RealSigprocmask(SIG_SETMASK, nullptr, &mask));
+  EXPECT_TRUE(sigismember64(&mask, SIGUSR1));
+  EXPECT_FALSE(sigismember64(&mask, SIGSEGV));
+  sigemptyset64(&mask);
+  ASSERT_EQ(0, RealSigprocmask(SIG_SETMASK, &mask, nullptr)) << strerror(errno);
+}
+
 TEST_F(SigchainTest, EnsureFrontOfChain) {
 #if defined(__BIONIC__)
   constexpr char kLibcSoName[] = "libc.so";
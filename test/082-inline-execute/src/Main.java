@@ -312,6 +312,38 @@ public class Main {
     testStringIndexOfChars(searchData);
 
     testSurrogateIndexOf();
+    testLongIndexOf();
+  }
+
+  private static void testLongIndexOf() {
+    // Long enough strings to go through the vectorized loops of the runtime stubs.
+    StringBuilder sb = new StringBuilder();
+    for (int i = 0; i < 100; ++i) {
+      sb.append((char) ('a' + (i % 26)));
+    }
+    String compressible = sb.toString();
+    String uncompressible = compressible + '\u0100';
+    for (String s : new String[] { compressible, uncompressible }) {
+      for (char c = 'a'; c <= 'z'; ++c) {
+        for (int start = 0; start < s.length(); start += 7) {
+          Assert.assertEquals(s.indexOf(c, start), naiveIndexOf(s, c, start));
+        }
+      }
+      // The low byte of this char matches 'a'.
+      Assert.assertEquals(s.indexOf('\u0161'), -1);
+      Assert.assertEquals(s.indexOf('A'), -1);
+    }
+    Assert.assertEquals(uncompressible.indexOf('\u0100'), 100);
+    Assert.assertEquals(uncompressible.indexOf('\u0100', 97), 100);
+  }
+
+  private static int naiveIndexOf(String s, char c, int start) {
+    for (int i = start; i < s.length(); ++i) {
+      if (s.charAt(i) == c) {
+        return i;
+      }
+    }
+    return -1;
   }
 
   private static void testStringIndexOfChars(int[][] searchData) {
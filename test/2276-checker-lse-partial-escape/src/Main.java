@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class Point {
+  int x;
+  int y;
+}
+
+public class Main {
+  public static void main(String[] args) {
+    assertEquals(3, $noinline$sumOrThrow(1, 2));
+    try {
+      $noinline$sumOrThrow(-1, 2);
+      throw new Error("Unreachable");
+    } catch (IllegalArgumentException expected) {
+      assertEquals("(-1, 2)", expected.getMessage());
+    }
+    assertEquals(3, $noinline$sumOrThrowAfterUpdate(1, 2));
+    try {
+      $noinline$sumOrThrowAfterUpdate(-1, 2);
+      throw new Error("Unreachable");
+    } catch (IllegalArgumentException expected) {
+      assertEquals("(-1, 7)", expected.getMessage());
+    }
+    assertEquals(3, $noinline$sumAfterEscape(1, 2));
+    assertEquals(42, $noinline$sumAfterEscape(-1, 2));
+  }
+
+  /// CHECK-START: int Main.$noinline$sumOrThrow(int, int) load_store_elimination (before)
+  /// CHECK:     NewInstance
+  /// CHECK:     InstanceFieldGet
+  /// CHECK:     InstanceFieldGet
+
+  // The point only escapes on the throwing path, where a copy of it is allocated, so the loads
+  // on the other path are replaced.
+  /// CHECK-START: int Main.$noinline$sumOrThrow(int, int) load_store_elimination (after)
+  /// CHECK-NOT: InstanceFieldGet
+  //
+  /// CHECK-START: int Main.$noinline$sumOrThrow(int, int) load_store_elimination (after)
+  /// CHECK-DAG: <<Cls:l\d+>>    LoadClass class_name:Point
+  /// CHECK-DAG: <<Obj:l\d+>>    NewInstance [<<Cls>>]
+  /// CHECK-DAG:                 InvokeStaticOrDirect [<<Obj>>{{(,[ij]\d+)?}}] method_name:Main.$noinline$describe
+  /// CHECK-DAG:                 Throw
+  /// CHECK-DAG: <<Add:i\d+>>    Add
+  /// CHECK-DAG:                 Return [<<Add>>]
+  static int $noinline$sumOrThrow(int x, int y) {
+    Point p = new Point();
+    p.x = x;
+    p.y = y;
+    if (x < 0) {
+      throw new IllegalArgumentException($noinline$describe(p));
+    }
+    return p.x + p.y;
+  }
+
+  /// CHECK-START: int Main.$noinline$sumOrThrowAfterUpdate(int, int) load_store_elimination (after)
+  /// CHECK-NOT: InstanceFieldGet
+  static int $noinline$sumOrThrowAfterUpdate(int x, int y) {
+    Point p = new Point();
+    p.x = x;
+    p.y = y;
+    if (x < 0) {
+      // The update happens after the materialization.
+      p.y = 7;
+      throw new IllegalArgumentException($noinline$describe(p));
+    }
+    return p.x + p.y;
+  }
+
+  // The escape merges back into the rest of the method, so the allocation is kept.
+  /// CHECK-START: int Main.$noinline$sumAfterEscape(int, int) load_store_elimination (after)
+  /// CHECK:     NewInstance
+  /// CHECK:     InstanceFieldGet
+  /// CHECK:     InstanceFieldGet
+  static int $noinline$sumAfterEscape(int x, int y) {
+    Point p = new Point();
+    p.x = x;
+    p.y = y;
+    if (x < 0) {
+      $noinline$update(p);
+    }
+    return p.x + p.y;
+  }
+
+  static String $noinline$describe(Point p) {
+    return "(" + p.x + ", " + p.y + ")";
+  }
+
+  static void $noinline$update(Point p) {
+    p.x = 40;
+  }
+
+  static void assertEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  static void assertEquals(String expected, String result) {
+    if (!expected.equals(result)) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  static int sLast;
+
+  public static void main(String[] args) {
+    assertEquals(45, $noinline$unswitch(10, true));
+    assertEquals(9, sLast);
+    sLast = 0;
+    assertEquals(1, $noinline$unswitch(10, false));
+    assertEquals(0, sLast);
+    assertEquals(0, $noinline$unswitch(0, true));
+    assertEquals(0, sLast);
+    assertEquals(45, $noinline$unswitchVariant(10));
+  }
+
+  /// CHECK-START-ARM64: int Main.$noinline$unswitch(int, boolean) loop_optimization (before)
+  /// CHECK-DAG: <<Flag:z\d+>>   ParameterValue
+  /// CHECK-DAG:                 If [<<Flag>>] loop:<<Loop:B\d+>> outer_loop:none
+
+  // The loop is versioned on the flag, which is constant in both versions.
+  /// CHECK-START-ARM64: int Main.$noinline$unswitch(int, boolean) loop_optimization (after)
+  /// CHECK:     <<Flag:z\d+>>   ParameterValue
+  /// CHECK:                     If [<<Flag>>] loop:none
+  /// CHECK-NOT:                 If [<<Flag>>]
+
+  /// CHECK-START-ARM64: int Main.$noinline$unswitch(int, boolean) dead_code_elimination$after_loop_opt (after)
+  /// CHECK-DAG:                 StaticFieldSet loop:<<Loop1:B\d+>> outer_loop:none
+  /// CHECK-DAG:                 Xor            loop:<<Loop2:B\d+>> outer_loop:none
+  /// CHECK-EVAL: "<<Loop1>>" != "<<Loop2>>"
+  static int $noinline$unswitch(int n, boolean flag) {
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+      if (flag) {
+        sum += i;
+        sLast = i;
+      } else {
+        sum ^= i;
+      }
+    }
+    return sum;
+  }
+
+  // The condition is not loop-invariant.
+  /// CHECK-START-ARM64: int Main.$noinline$unswitchVariant(int) loop_optimization (after)
+  /// CHECK-DAG:                 If [{{z\d+}}] loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG:                 If [{{z\d+}}] loop:<<Loop>>      outer_loop:none
+  static int $noinline$unswitchVariant(int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+      if (i < sLast) {
+        sum ^= i;
+        sLast = i;
+      } else {
+        sum += i;
+      }
+    }
+    return sum;
+  }
+
+  static void assertEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.nio.ByteBuffer;
+import java.util.Random;
+import java.util.zip.CRC32C;
+
+/**
+ * The ART compiler can use intrinsics for the java.util.zip.CRC32C methods:
+ *   private static int updateBytes(int crc, byte[] b, int off, int end)
+ *   private static int updateDirectByteBuffer(int crc, long address, int off, int end)
+ *
+ * As the methods are private the tests check the checksums against a bitwise implementation.
+ */
+public class Main {
+  public static void main(String[] args) {
+    assertEquals(0xE3069283L, $noinline$crc32c("123456789".getBytes(), 0, 9));
+    assertEquals(0L, $noinline$crc32c(new byte[0], 0, 0));
+
+    Random random = new Random(42);
+    byte[] bytes = new byte[70 * 1024];
+    random.nextBytes(bytes);
+    // Cover all the alignments and tails of the intrinsic, and lengths above the threshold
+    // which go to the slow path.
+    for (int off = 0; off < 16; ++off) {
+      for (int len = 0; len < 64; ++len) {
+        assertEquals(referenceCrc32c(bytes, off, len), $noinline$crc32c(bytes, off, len));
+      }
+    }
+    for (int len : new int[] { 1000, 64 * 1024 - 1, 64 * 1024, 64 * 1024 + 1, 70 * 1024 - 3 }) {
+      assertEquals(referenceCrc32c(bytes, 3, len), $noinline$crc32c(bytes, 3, len));
+    }
+
+    // Updates in several steps.
+    CRC32C crc32c = new CRC32C();
+    crc32c.update(bytes, 0, 5);
+    crc32c.update(bytes[5]);
+    crc32c.update(bytes, 6, 1000);
+    assertEquals(referenceCrc32c(bytes, 0, 1006), crc32c.getValue());
+
+    ByteBuffer direct = ByteBuffer.allocateDirect(4096);
+    direct.put(bytes, 0, 4096);
+    for (int off = 0; off < 16; ++off) {
+      for (int len : new int[] { 0, 1, 7, 8, 9, 100, 4096 - 16 }) {
+        direct.limit(off + len);
+        direct.position(off);
+        crc32c.reset();
+        crc32c.update(direct);
+        assertEquals(referenceCrc32c(bytes, off, len), crc32c.getValue());
+      }
+    }
+  }
+
+  private static long $noinline$crc32c(byte[] bytes, int off, int len) {
+    CRC32C crc32c = new CRC32C();
+    crc32c.update(bytes, off, len);
+    return crc32c.getValue();
+  }
+
+  private static long referenceCrc32c(byte[] bytes, int off, int len) {
+    int crc = 0xFFFFFFFF;
+    for (int i = off; i < off + len; ++i) {
+      crc ^= bytes[i] & 0xFF;
+      for (int bit = 0; bit < 8; ++bit) {
+        crc = (crc >>> 1) ^ (0x82F63B78 & -(crc & 1));
+      }
+    }
+    return ~crc & 0xFFFFFFFFL;
+  }
+
+  private static void assertEquals(long expected, long actual) {
+    if (expected != actual) {
+      throw new Error("Expected: " + expected + ", found: " + actual);
+    }
+  }
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  /// CHECK-START: void Main.$noinline$stride2(int[]) BCE (before)
+  /// CHECK-DAG: BoundsCheck loop:<<Loop:B\d+>>
+  //
+  /// CHECK-START: void Main.$noinline$stride2(int[]) BCE (after)
+  /// CHECK-DAG: Deoptimize loop:none
+  /// CHECK-NOT: BoundsCheck
+  static void $noinline$stride2(int[] a) {
+    for (int i = 0; i < a.length; i += 2) {
+      a[i] = i;
+    }
+  }
+
+  /// CHECK-START: void Main.$noinline$stride4OtherLength(int[], int[]) BCE (before)
+  /// CHECK-DAG: BoundsCheck loop:<<Loop:B\d+>>
+  /// CHECK-DAG: BoundsCheck loop:<<Loop>>
+  //
+  /// CHECK-START: void Main.$noinline$stride4OtherLength(int[], int[]) BCE (after)
+  /// CHECK-DAG: Deoptimize loop:none
+  /// CHECK-NOT: BoundsCheck
+  static void $noinline$stride4OtherLength(int[] a, int[] b) {
+    for (int i = 0; i < b.length; i += 4) {
+      a[i] = b[i];
+    }
+  }
+
+  /// CHECK-START: int Main.$noinline$rowsWithStride(int[][], int) BCE (before)
+  /// CHECK-DAG: BoundsCheck loop:<<Outer:B\d+>> outer_loop:none
+  /// CHECK-DAG: BoundsCheck loop:<<Inner:B\d+>> outer_loop:<<Outer>>
+  //
+  /// CHECK-START: int Main.$noinline$rowsWithStride(int[][], int) BCE (after)
+  /// CHECK-NOT: BoundsCheck
+  static int $noinline$rowsWithStride(int[][] m, int n) {
+    int sum = 0;
+    for (int i = 0; i < m.length; i++) {
+      int[] row = m[i];
+      for (int j = 1; j < n; j += 3) {
+        sum += row[j];
+      }
+    }
+    return sum;
+  }
+
+  /// CHECK-START: void Main.$noinline$stride3Unknown(int[], int) BCE (after)
+  /// CHECK-DAG: Deoptimize loop:none
+  /// CHECK-NOT: BoundsCheck
+  static void $noinline$stride3Unknown(int[] a, int n) {
+    for (int i = 0; i <= n; i += 3) {
+      a[i] = 1;
+    }
+  }
+
+  public static void main(String[] args) {
+    int[] a = new int[9];
+    $noinline$stride2(a);
+    expectEquals("[0, 0, 2, 0, 4, 0, 6, 0, 8]", java.util.Arrays.toString(a));
+
+    int[] b = { 1, 2, 3, 4, 5, 6 };
+    a = new int[5];
+    $noinline$stride4OtherLength(a, b);
+    expectEquals("[1, 0, 0, 0, 5]", java.util.Arrays.toString(a));
+    // The loop deoptimizes and throws, after the first store.
+    a = new int[4];
+    try {
+      $noinline$stride4OtherLength(a, b);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+      expectEquals("[1, 0, 0, 0]", java.util.Arrays.toString(a));
+    }
+
+    int[][] m = { { 1, 2, 3, 4, 5 }, { 6, 7, 8, 9, 10 } };
+    expectEquals(2 + 5 + 7 + 10, $noinline$rowsWithStride(m, 5));
+    expectEquals(0, $noinline$rowsWithStride(m, 0));
+    try {
+      $noinline$rowsWithStride(m, 8);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+
+    a = new int[7];
+    $noinline$stride3Unknown(a, 6);
+    expectEquals("[1, 0, 0, 1, 0, 0, 1]", java.util.Arrays.toString(a));
+    $noinline$stride3Unknown(a, -5);
+    try {
+      $noinline$stride3Unknown(a, 7);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+    // The induction wraps around, the loop does not terminate before going out of bounds.
+    try {
+      $noinline$stride3Unknown(a, Integer.MAX_VALUE);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(String expected, String result) {
+    if (!expected.equals(result)) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -386,6 +386,51 @@ class TestNonEscaping {
   }
 }
 
+class TestOptimizeAcrossDiamond implements Test {
+  // Prevent constant folding.
+  static boolean test;
+
+  static Object external;
+  static Object external3;
+
+  /// CHECK-START: void TestOptimizeAcrossDiamond.exercise() constructor_fence_redundancy_elimination (before)
+  /// CHECK: <<NewInstance:l\d+>>     NewInstance
+  /// CHECK:                          ConstructorFence [<<NewInstance>>]
+  /// CHECK: <<NewInstance2:l\d+>>    NewInstance
+  /// CHECK-DAG:                      ConstructorFence [<<NewInstance2>>]
+  /// CHECK-NOT:                      ConstructorFence
+  /// CHECK-DAG:                      StaticFieldSet [<<External:l\d+>>,<<NewInstance>>]
+  /// CHECK-DAG:                      StaticFieldSet [<<External2:l\d+>>,<<NewInstance2>>]
+
+  /// CHECK-START: void TestOptimizeAcrossDiamond.exercise() constructor_fence_redundancy_elimination (after)
+  /// CHECK: <<NewInstance:l\d+>>     NewInstance
+  /// CHECK: <<NewInstance2:l\d+>>    NewInstance
+  /// CHECK-DAG:                      ConstructorFence [<<NewInstance2>>,<<NewInstance>>]
+  /// CHECK-NOT:                      ConstructorFence
+  /// CHECK-DAG:                      StaticFieldSet [<<External:l\d+>>,<<NewInstance>>]
+  /// CHECK-DAG:                      StaticFieldSet [<<External2:l\d+>>,<<NewInstance2>>]
+  @Override
+  public void exercise() {
+    Base b = new Base();
+
+    // Move the constructor fence across this block, as 'b' is not published in it.
+    if (test) {
+      external = null;
+    }
+
+    Base b2 = new Base();
+    external = b2;
+    external3 = b;
+  }
+
+  @Override
+  public void check() {
+    Assert.stringEquals("false", test);
+    Assert.stringEquals("Base(w0: 0, w1: 0, w2: 0, w3: 0)", external);
+    Assert.stringEquals("Base(w0: 0, w1: 0, w2: 0, w3: 0)", external3);
+  }
+}
+
 class TestDontOptimizeAcrossBlocks implements Test {
   // Prevent constant folding.
   static boolean test;
@@ -414,9 +459,9 @@ class TestDontOptimizeAcrossBlocks implements Test {
   public void exercise() {
     Base b = new Base();
 
-    // Do not move constructor fence across this block, even though 'b' is not published yet.
+    // Do not move constructor fence across this block, as 'b' may be published in it.
     if (test) {
-      external = null;
+      external3 = b;
     }
 
     Base b2 = new Base();
@@ -800,6 +845,7 @@ public class Main {
       TestThreeFinalTwice.class,
       TestNonEscaping.Invoke.class,
       TestNonEscaping.Store.class,
+      TestOptimizeAcrossDiamond.class,
       TestDontOptimizeAcrossBlocks.class,
       TestDontOptimizeAcrossEscape.Invoke.class,
       TestDontOptimizeAcrossEscape.StoreIput.class,
@@ -551,6 +551,95 @@ public class Main {
     return sum;
   }
 
+  //
+  // Min/max reductions.
+  //
+
+  /// CHECK-START: int Main.reductionMinInt(int[]) loop_optimization (before)
+  /// CHECK-DAG: <<Cons0:i\d+>>  IntConstant 0                 loop:none
+  /// CHECK-DAG: <<Cons1:i\d+>>  IntConstant 1                 loop:none
+  /// CHECK-DAG: <<Phi1:i\d+>>   Phi [<<Cons0>>,{{i\d+}}]      loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: <<Phi2:i\d+>>   Phi [{{i\d+}},{{i\d+}}]      loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG: <<Get:i\d+>>    ArrayGet [{{l\d+}},<<Phi1>>]  loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                 Min [<<Phi2>>,<<Get>>]        loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                 Add [<<Phi1>>,<<Cons1>>]      loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                 Return [<<Phi2>>]             loop:none
+  //
+  /// CHECK-START-ARM64: int Main.reductionMinInt(int[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("sve") and os.environ.get('ART_FORCE_TRY_PREDICATED_SIMD') == 'true'
+  //
+  ///     CHECK-DAG: <<Rep:d\d+>>    VecReplicateScalar [{{i\d+}},{{j\d+}}]  loop:none
+  ///     CHECK-DAG: <<Phi:d\d+>>    Phi [<<Rep>>,{{d\d+}}]                  loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<LoopP:j\d+>>  VecPredWhile                            loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Load:d\d+>>   VecLoad [{{l\d+}},<<I:i\d+>>,<<LoopP>>] loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 VecMin [<<Phi>>,<<Load>>,<<LoopP>>]     loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 Add [<<I>>,{{i\d+}}]                    loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Red:d\d+>>    VecReduce [<<Phi>>,{{j\d+}}]            loop:none
+  ///     CHECK-DAG: <<Extr:i\d+>>   VecExtractScalar [<<Red>>,{{j\d+}}]     loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Cons:i\d+>>   IntConstant 4                      loop:none
+  ///     CHECK-DAG: <<Rep:d\d+>>    VecReplicateScalar [{{i\d+}}]      loop:none
+  ///     CHECK-DAG: <<Phi:d\d+>>    Phi [<<Rep>>,{{d\d+}}]             loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Load:d\d+>>   VecLoad [{{l\d+}},<<I:i\d+>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 VecMin [<<Phi>>,<<Load>>]          loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 Add [<<I>>,<<Cons>>]               loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Red:d\d+>>    VecReduce [<<Phi>>]                loop:none
+  ///     CHECK-DAG: <<Extr:i\d+>>   VecExtractScalar [<<Red>>]         loop:none
+  //
+  /// CHECK-FI:
+  private static int reductionMinInt(int[] x) {
+    int min = Integer.MAX_VALUE;
+    for (int i = 0; i < x.length; i++) {
+      min = Math.min(min, x[i]);
+    }
+    return min;
+  }
+
+  /// CHECK-START: int Main.reductionMaxInt(int[]) loop_optimization (before)
+  /// CHECK-DAG: <<Cons0:i\d+>>  IntConstant 0                 loop:none
+  /// CHECK-DAG: <<Cons1:i\d+>>  IntConstant 1                 loop:none
+  /// CHECK-DAG: <<Phi1:i\d+>>   Phi [<<Cons0>>,{{i\d+}}]      loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: <<Phi2:i\d+>>   Phi [{{i\d+}},{{i\d+}}]      loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG: <<Get:i\d+>>    ArrayGet [{{l\d+}},<<Phi1>>]  loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                 Max [<<Get>>,<<Phi2>>]        loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                 Add [<<Phi1>>,<<Cons1>>]      loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                 Return [<<Phi2>>]             loop:none
+  //
+  /// CHECK-START-ARM64: int Main.reductionMaxInt(int[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("sve") and os.environ.get('ART_FORCE_TRY_PREDICATED_SIMD') == 'true'
+  //
+  ///     CHECK-DAG: <<Rep:d\d+>>    VecReplicateScalar [{{i\d+}},{{j\d+}}]  loop:none
+  ///     CHECK-DAG: <<Phi:d\d+>>    Phi [<<Rep>>,{{d\d+}}]                  loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<LoopP:j\d+>>  VecPredWhile                            loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Load:d\d+>>   VecLoad [{{l\d+}},<<I:i\d+>>,<<LoopP>>] loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 VecMax [<<Phi>>,<<Load>>,<<LoopP>>]     loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 Add [<<I>>,{{i\d+}}]                    loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Red:d\d+>>    VecReduce [<<Phi>>,{{j\d+}}]            loop:none
+  ///     CHECK-DAG: <<Extr:i\d+>>   VecExtractScalar [<<Red>>,{{j\d+}}]     loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Cons:i\d+>>   IntConstant 4                      loop:none
+  ///     CHECK-DAG: <<Rep:d\d+>>    VecReplicateScalar [{{i\d+}}]      loop:none
+  ///     CHECK-DAG: <<Phi:d\d+>>    Phi [<<Rep>>,{{d\d+}}]             loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Load:d\d+>>   VecLoad [{{l\d+}},<<I:i\d+>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 VecMax [<<Phi>>,<<Load>>]          loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 Add [<<I>>,<<Cons>>]               loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Red:d\d+>>    VecReduce [<<Phi>>]                loop:none
+  ///     CHECK-DAG: <<Extr:i\d+>>   VecExtractScalar [<<Red>>]         loop:none
+  //
+  /// CHECK-FI:
+  private static int reductionMaxInt(int[] x) {
+    int max = Integer.MIN_VALUE;
+    for (int i = 0; i < x.length; i++) {
+      // The phi is the second operand here.
+      max = Math.max(x[i], max);
+    }
+    return max;
+  }
+
   //
   // A few special cases.
   //
@@ -653,6 +742,10 @@ public class Main {
     expectEquals(27466, reductionMinusChar(xc));
     expectEquals(-365750, reductionMinusInt(xi));
     expectEquals(-365750L, reductionMinusLong(xl));
+    expectEquals(-17, reductionMinInt(xi));
+    expectEquals(1480, reductionMaxInt(xi));
+    expectEquals(Integer.MAX_VALUE, reductionMinInt(new int[0]));
+    expectEquals(-4, reductionMaxInt(xni));
 
     // Test special cases.
     expectEquals(13, reductionInt10(xi));
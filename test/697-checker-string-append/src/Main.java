@@ -22,6 +22,7 @@ public class Main {
         testAppendStringAndDouble();
         testAppendDoubleAndFloat();
         testAppendStringAndString();
+        testAppendStringAndCharArray();
         testMiscelaneous();
         testNoArgs();
         testInline();
@@ -357,6 +358,34 @@ public class Main {
         assertEquals("\u0131test\u0131", $noinline$appendStringAndString("\u0131", "test\u0131"));
     }
 
+    /// CHECK-START: java.lang.String Main.$noinline$appendStringAndNewCharArray(java.lang.String, char, char) instruction_simplifier (after)
+    /// CHECK:                  StringBuilderAppend
+    public static String $noinline$appendStringAndNewCharArray(String s, char c1, char c2) {
+        char[] chars = { c1, c2 };
+        return new StringBuilder().append(s).append(chars).toString();
+    }
+
+    /// CHECK-START: java.lang.String Main.$noinline$appendStringAndCharArray(java.lang.String, char[]) instruction_simplifier (after)
+    /// CHECK-NOT:              StringBuilderAppend
+    public static String $noinline$appendStringAndCharArray(String s, char[] chars) {
+        // The array may be null, so the fused append is not used.
+        return new StringBuilder().append(s).append(chars).toString();
+    }
+
+    public static void testAppendStringAndCharArray() {
+        assertEquals("abcde", $noinline$appendStringAndNewCharArray("abc", 'd', 'e'));
+        assertEquals("nullde", $noinline$appendStringAndNewCharArray(null, 'd', 'e'));
+        // Test with a non-ASCII character.
+        assertEquals("abc\u0131e", $noinline$appendStringAndNewCharArray("abc", '\u0131', 'e'));
+        assertEquals("\u0131de", $noinline$appendStringAndNewCharArray("\u0131", 'd', 'e'));
+        assertEquals("abcde", $noinline$appendStringAndCharArray("abc", new char[] { 'd', 'e' }));
+        try {
+            $noinline$appendStringAndCharArray("abc", null);
+            throw new Error("Expected NullPointerException");
+        } catch (NullPointerException expected) {
+        }
+    }
+
     /// CHECK-START: java.lang.String Main.$noinline$appendSLILC(java.lang.String, long, int, long, char) instruction_simplifier (before)
     /// CHECK-NOT:              StringBuilderAppend
 
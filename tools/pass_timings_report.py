@@ -0,0 +1,128 @@
+#!/usr/bin/python3
+#
+# Copyright (C) 2026 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Aggregates the per-method records written by `dex2oat --dump-pass-timings-json=<file>`.
+
+Prints, per optimization pass, the total time, its share of the compile time and the
+distribution of its per-method cost, followed by totals for code generation, arena memory
+and code size. With --baseline, compares against the records of a previous run on the same
+corpus and exits with status 1 if the total time of any pass or of code generation regressed
+by more than --threshold percent.
+
+Example:
+  dex2oat --dump-pass-timings-json=/tmp/new.json ...
+  tools/pass_timings_report.py /tmp/new.json --baseline /tmp/old.json --top 10
+"""
+
+import argparse
+import collections
+import json
+import sys
+
+CODEGEN = 'code_generation'
+
+
+def read_records(paths):
+  records = []
+  for path in paths:
+    with open(path) as f:
+      records.extend(json.loads(line) for line in f if line.strip())
+  return records
+
+
+def percentile(sorted_values, p):
+  if not sorted_values:
+    return 0
+  return sorted_values[min(len(sorted_values) - 1, len(sorted_values) * p // 100)]
+
+
+def per_pass_times(records):
+  times = collections.defaultdict(list)
+  for record in records:
+    # A pass can run more than once per method; count it once with its summed time.
+    method_times = collections.Counter()
+    for name, ns in record['passes']:
+      method_times[name] += ns
+    if record['compiled']:
+      method_times[CODEGEN] += record['code_generation_ns']
+    for name, ns in method_times.items():
+      times[name].append(ns)
+  for values in times.values():
+    values.sort()
+  return times
+
+
+def print_report(records, top):
+  times = per_pass_times(records)
+  total_ns = sum(r['total_ns'] for r in records) or 1
+  compiled = [r for r in records if r['compiled']]
+  print('methods: %d, compiled: %d, total: %.1f ms' %
+        (len(records), len(compiled), total_ns / 1e6))
+  print('%-48s %10s %6s %8s %8s %8s %8s' %
+        ('pass', 'total ms', '%', 'p50 us', 'p90 us', 'p99 us', 'max us'))
+  for name, values in sorted(times.items(), key=lambda item: -sum(item[1])):
+    print('%-48s %10.1f %6.1f %8.1f %8.1f %8.1f %8.1f' %
+          (name, sum(values) / 1e6, 100.0 * sum(values) / total_ns,
+           percentile(values, 50) / 1e3, percentile(values, 90) / 1e3,
+           percentile(values, 99) / 1e3, values[-1] / 1e3))
+  peaks = sorted(r['arena_bytes'] + r['arena_stack_peak_bytes'] for r in records)
+  print('arena bytes per method: p50 %d, p99 %d, max %d' %
+        (percentile(peaks, 50), percentile(peaks, 99), peaks[-1] if peaks else 0))
+  print('code size: %d bytes' % sum(r['code_size'] for r in compiled))
+  if top:
+    print('slowest methods:')
+    for record in sorted(records, key=lambda r: -r['total_ns'])[:top]:
+      print('  %10.1f us  %s' % (record['total_ns'] / 1e3, record['method']))
+
+
+def compare(records, baseline_records, threshold):
+  times = per_pass_times(records)
+  baseline_times = per_pass_times(baseline_records)
+  regressed = False
+  print('%-48s %10s %10s %8s' % ('pass', 'base ms', 'new ms', 'change'))
+  for name in sorted(set(times) | set(baseline_times)):
+    new_ns = sum(times.get(name, []))
+    base_ns = sum(baseline_times.get(name, []))
+    change = 100.0 * (new_ns - base_ns) / base_ns if base_ns else float('inf')
+    marker = ''
+    if change > threshold:
+      marker = '  REGRESSION'
+      regressed = True
+    print('%-48s %10.1f %10.1f %+7.1f%%%s' % (name, base_ns / 1e6, new_ns / 1e6, change, marker))
+  return regressed
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__,
+                                   formatter_class=argparse.RawDescriptionHelpFormatter)
+  parser.add_argument('files', nargs='+', help='files written by --dump-pass-timings-json')
+  parser.add_argument('--baseline', action='append', default=[],
+                      help='records of the baseline run; may be repeated')
+  parser.add_argument('--threshold', type=float, default=5.0,
+                      help='regression threshold in percent (default: %(default)s)')
+  parser.add_argument('--top', type=int, default=0, help='list the N slowest methods')
+  args = parser.parse_args()
+
+  records = read_records(args.files)
+  print_report(records, args.top)
+  if args.baseline:
+    print()
+    if compare(records, read_records(args.baseline), args.threshold):
+      sys.exit(1)
+
+
+if __name__ == '__main__':
+  main()